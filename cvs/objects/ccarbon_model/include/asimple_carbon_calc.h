@@ -44,6 +44,7 @@
  * \brief The ASimpleCarbonCalc class header file.
  * \author James Blackwood
  */
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include "util/base/include/time_vector.h"
 #include "util/base/include/value.h"
@@ -155,30 +156,89 @@ protected:
     //! expensive operations during calc.
     std::vector<double> precalc_sigmoid_diff;
     
+    //! The cumulative fraction of a soil carbon change which has occurred by
+    //! year offset, starting with zero at offset zero.  This only depends on
+    //! the soil time scale so it gets precomputed when that is set to avoid
+    //! evaluating exponentials for every year of every change during calc.
+    std::vector<double> precalc_soil_cum_response;
+    
+    //! The fraction of a pending soil carbon change which remains pending after
+    //! a year, exp( -lambda ).  Also precomputed with the soil time scale.
+    double mSoilDecayFactor;
+    
     //! Flag to ensure historical emissions are only calculated a single time
     //! since they can not be reset.
     bool mHasCalculatedHistoricEmiss;
 
-    template<typename DoubleType>
+    //! The storage of the year vectors in mStoredEmissionsAbove and
+    //! mStoredEmissionsBelow for each period, which holds the two vectors
+    //! next to each other since they are always accessed together.  Null for
+    //! period zero and for periods which are not in memory.
+    objects::PeriodVector<Value*> mStoredEmissionsData;
+
+    //! The offset in the HistorySpillFile of the stored emissions of each
+    //! period, or HistorySpillFile::NOT_WRITTEN if they never have been.
+    objects::PeriodVector<size_t> mStoredEmissionsOffset;
+
+    static int getStoredEmissionsStartYear( const int aPeriod );
+
+    void allocateStoredEmissions( const int aPeriod );
+
+    void releaseStoredEmissions( const int aPeriod );
+
+    void spillStoredEmissions( const int aPeriod );
+
+    void restoreStoredEmissions( const int aPeriod );
+
+    template<typename EmissVectorType>
     void calcAboveGroundCarbonEmission(const double aPrevCarbonStock,
                                        const double aPrevLandArea,
                                        const double aCurrLandArea,
                                        const double aPrevCarbonDensity,
                                        const int aYear,
                                        const int aEndYear,
-                                       objects::YearVector<DoubleType>& aEmissVector);
+                                       EmissVectorType& aEmissVector);
 
-    template<typename DoubleType>
+    template<typename EmissVectorType>
     void calcBelowGroundCarbonEmission( const double aCarbonDiff,
                                         const int aYear,
                                         const int aEndYear,
-                                        objects::YearVector<DoubleType>& aEmissVector);
+                                        EmissVectorType& aEmissVector);
 private:
-    template<typename DoubleType>
+    /*!
+     * \brief A contiguous array of doubles indexed by year.
+     * \details Unlike a YearVector the index operator is not virtual and does
+     *          no bounds checking so that the emissions kernels may be
+     *          vectorized by the compiler when accumulating into it.
+     */
+    class YearArray {
+    public:
+        YearArray( double* aData, const int aStartYear ):mData( aData ), mStartYear( aStartYear ) {}
+        double& operator[]( const int aYear ) {
+            return mData[ aYear - mStartYear ];
+        }
+    private:
+        //! The first element of the data.
+        double* mData;
+
+        //! The year which corresponds to the first element.
+        const int mStartYear;
+    };
+
+    void precalcSoilResponse();
+
+    template<typename EmissVectorType>
+    void convolveBelowGroundCarbonEmission( const double* aCarbonDiffs,
+                                            const int aNumDiffs,
+                                            const int aYear,
+                                            const int aEndYear,
+                                            EmissVectorType& aEmissVector );
+
+    template<typename EmissVectorType>
     void calcSigmoidCurve( const double aCarbonDiff,
                            const int aYear,
                            const int aEndYear,
-                           objects::YearVector<DoubleType>& aEmissVector);
+                           EmissVectorType& aEmissVector);
 };
 
 /*!
@@ -192,14 +252,14 @@ private:
  * \param aEndYear The last future year to calculate to.
  * \param aEmissVector A vector to accumulate emissions into.
  */
-template<typename DoubleType>
+template<typename EmissVectorType>
 void ASimpleCarbonCalc::calcAboveGroundCarbonEmission( const double aPrevCarbonStock,
                                                        const double aPrevLandArea,
                                                        const double aCurrLandArea,
                                                        const double aPrevCarbonDensity,
                                                        const int aYear,
                                                        const int aEndYear,
-                                                       objects::YearVector<DoubleType>& aEmissVector)
+                                                       EmissVectorType& aEmissVector)
 {
     double carbonDiff = aPrevCarbonDensity * ( aPrevLandArea  - aCurrLandArea );
     // If no emissions or sequestration occurred, then exit.
@@ -258,11 +318,11 @@ void ASimpleCarbonCalc::calcAboveGroundCarbonEmission( const double aPrevCarbonS
  * \param aEndYear The last future year to calculate to.
  * \param aEmissVector A vector to accumulate emissions into.
  */
-template<typename DoubleType>
+template<typename EmissVectorType>
 void ASimpleCarbonCalc::calcBelowGroundCarbonEmission( const double aCarbonDiff,
                                                        const int aYear,
                                                        const int aEndYear,
-                                                       objects::YearVector<DoubleType>& aEmissVector )
+                                                       EmissVectorType& aEmissVector )
 {
     // If no emissions or sequestration occurred, then exit.
     if( util::isEqual( aCarbonDiff, 0.0 ) ){
@@ -274,18 +334,50 @@ void ASimpleCarbonCalc::calcBelowGroundCarbonEmission( const double aCarbonDiff,
     // have occured, at twice the half-life 75% would have occurred, etc.
     // Note also that the aCarbonDiff is passed here as previous carbon minus current carbon
     // so a positive difference means that emissions will occur and a negative means uptake.
-    
-    const double halfLife = mSoilTimeScale / 10.0;
-    const double log2 = log( 2.0 );
-    const double lambda = log2 / halfLife;
-    int yearCounter = 0;
-    double cumStockDiff_t1, cumStockDiff_t2;
-    cumStockDiff_t1 = 0.0;
+    // The cumulative response has already been precomputed so that each
+    // year is independent of the others.
+    const double* cumResponse = &precalc_soil_cum_response[ 0 ];
     for( int currYear = aYear; currYear <= aEndYear; ++currYear ) {
-        yearCounter += 1;
-        cumStockDiff_t2 = aCarbonDiff * ( 1.0 - exp( -1.0 * lambda * yearCounter ) );
-        aEmissVector[ currYear ] += cumStockDiff_t2 - cumStockDiff_t1;
-        cumStockDiff_t1 = cumStockDiff_t2;
+        const int offsetYear = currYear - aYear;
+        aEmissVector[ currYear ] += aCarbonDiff * cumResponse[ offsetYear + 1 ] - aCarbonDiff * cumResponse[ offsetYear ];
+    }
+}
+
+/*!
+ * \brief Calculate the emission from a series of consecutive annual below
+ *        ground carbon changes.
+ * \details Gives the same result as calling calcBelowGroundCarbonEmission for
+ *          each change however since the soil response is exponential the
+ *          convolution of the changes with it can be computed recursively, in
+ *          a single pass over the years, by decaying the carbon change which
+ *          is still pending each year.  The emission in a year is then the
+ *          first year response of that pending change.
+ * \param aCarbonDiffs The below ground carbon change for each year starting
+ *                     with aYear, as previous carbon minus current carbon.
+ * \param aNumDiffs The number of annual changes.
+ * \param aYear The year of the first change.
+ * \param aEndYear The last future year to calculate to.
+ * \param aEmissVector A vector to accumulate emissions into.
+ */
+template<typename EmissVectorType>
+void ASimpleCarbonCalc::convolveBelowGroundCarbonEmission( const double* aCarbonDiffs,
+                                                           const int aNumDiffs,
+                                                           const int aYear,
+                                                           const int aEndYear,
+                                                           EmissVectorType& aEmissVector )
+{
+    const double firstYearResponse = precalc_soil_cum_response[ 1 ];
+    const int lastDiffYear = std::min( aYear + aNumDiffs - 1, aEndYear );
+    double pendingDiff = 0.0;
+    int currYear = aYear;
+    for( ; currYear <= lastDiffYear; ++currYear ) {
+        pendingDiff = pendingDiff * mSoilDecayFactor + aCarbonDiffs[ currYear - aYear ];
+        aEmissVector[ currYear ] += firstYearResponse * pendingDiff;
+    }
+    // No new changes occur after the last one so just let what is pending decay.
+    for( ; currYear <= aEndYear && pendingDiff != 0.0; ++currYear ) {
+        pendingDiff *= mSoilDecayFactor;
+        aEmissVector[ currYear ] += firstYearResponse * pendingDiff;
     }
 }
 
@@ -297,11 +389,11 @@ void ASimpleCarbonCalc::calcBelowGroundCarbonEmission( const double aCarbonDiff,
  * \param    aEndYear The last future year to calculate to.
  * \param    aEmissVector A vector to accumulate emissions into.
  */
-template<typename DoubleType>
+template<typename EmissVectorType>
 void ASimpleCarbonCalc::calcSigmoidCurve( const double aCarbonDiff,
                                           const int aYear,
                                           const int aEndYear,
-                                          objects::YearVector<DoubleType>& aEmissVector )
+                                          EmissVectorType& aEmissVector )
 {
     /*!
      * \pre This calculation will not be correct for a mature age of a single
@@ -309,10 +401,11 @@ void ASimpleCarbonCalc::calcSigmoidCurve( const double aCarbonDiff,
      */
     assert( getMatureAge() > 1 );
     
+    // To avoid expensive calculations the difference in the sigmoid curve
+    // has already been precomputed.
+    const double* sigmoidDiff = &precalc_sigmoid_diff[ 0 ];
     for( int currYear = aYear; currYear <= aEndYear; ++currYear ){
-        // To avoid expensive calculations the difference in the sigmoid curve
-        // has already been precomputed.
-        aEmissVector[ currYear ] += precalc_sigmoid_diff[ currYear - aYear ] * aCarbonDiff;
+        aEmissVector[ currYear ] += sigmoidDiff[ currYear - aYear ] * aCarbonDiff;
     }
 }
 
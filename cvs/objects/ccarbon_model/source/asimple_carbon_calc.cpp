@@ -48,6 +48,7 @@
 #include "land_allocator/include/land_use_history.h"
 #include "land_allocator/include/land_leaf.h"
 #include "util/logger/include/ilogger.h"
+#include "util/base/include/history_spill_file.h"
 
 using namespace std;
 using namespace xercesc;
@@ -59,14 +60,16 @@ ASimpleCarbonCalc::ASimpleCarbonCalc():
 mTotalEmissions( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear() ),
 mTotalEmissionsAbove( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear() ),
 mTotalEmissionsBelow( CarbonModelUtils::getStartYear(), CarbonModelUtils::getEndYear() ),
-mCarbonStock( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEndYear() )
+mCarbonStock( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEndYear() ),
+mStoredEmissionsData( 0 ),
+mStoredEmissionsOffset( HistorySpillFile::NOT_WRITTEN )
 {
-    int endYear = CarbonModelUtils::getEndYear();
     const Modeltime* modeltime = scenario->getModeltime();
     
     mLandUseHistory = 0;
     mLandLeaf = 0;
     mSoilTimeScale = CarbonModelUtils::getSoilTimeScale();
+    precalcSoilResponse();
     mHasCalculatedHistoricEmiss = false;
 
     // Note we are not allocating space for period zero since that is historical
@@ -74,19 +77,95 @@ mCarbonStock( scenario->getModeltime()->getStartYear(), CarbonModelUtils::getEnd
     mStoredEmissionsAbove[0] = 0;
     mStoredEmissionsBelow[0] = 0;
     
-    for( int period = 1; period < mStoredEmissionsAbove.size(); ++period ){
-        int currYear = modeltime->getper_to_yr( period ) - modeltime->gettimestep( period ) + 1;
-        mStoredEmissionsAbove[period] = new YearVector<Value>( currYear, endYear );
-        mStoredEmissionsBelow[period] = new YearVector<Value>( currYear, endYear );
+    // When solved periods are moved out of memory the stored emissions are
+    // not allocated until a period is initialized.
+    if( !HistorySpillFile::getInstance().isEnabled() ) {
+        for( int period = 1; period < modeltime->getmaxper(); ++period ){
+            allocateStoredEmissions( period );
+        }
     }
 }
 
 //! Default destructor
 ASimpleCarbonCalc::~ASimpleCarbonCalc() {
-    for( int period = 0; period < mStoredEmissionsAbove.size(); ++period ){
-        // Both of these arrays have the same size.
-        delete mStoredEmissionsAbove[period];
-        delete mStoredEmissionsBelow[period];
+    for( size_t period = 1; period < mStoredEmissionsAbove.size(); ++period ){
+        releaseStoredEmissions( period );
+    }
+}
+
+/*!
+ * \brief The first year of the stored emissions of a period.
+ * \param aPeriod Model period.
+ * \return The first year of the time step of the period.
+ */
+int ASimpleCarbonCalc::getStoredEmissionsStartYear( const int aPeriod ) {
+    const Modeltime* modeltime = scenario->getModeltime();
+    return modeltime->getper_to_yr( aPeriod ) - modeltime->gettimestep( aPeriod ) + 1;
+}
+
+/*!
+ * \brief Allocate the stored emissions of a period initialized to zero.
+ * \param aPeriod Model period, greater than zero.
+ */
+void ASimpleCarbonCalc::allocateStoredEmissions( const int aPeriod ) {
+    const int endYear = CarbonModelUtils::getEndYear();
+    const int startYear = getStoredEmissionsStartYear( aPeriod );
+    const int numYears = endYear - startYear + 1;
+    mStoredEmissionsData[ aPeriod ] = static_cast<Value*>( ::operator new( 2 * numYears * sizeof( Value ) ) );
+    mStoredEmissionsAbove[ aPeriod ] = new YearVector<Value>( startYear, endYear, mStoredEmissionsData[ aPeriod ] );
+    mStoredEmissionsBelow[ aPeriod ] = new YearVector<Value>( startYear, endYear, mStoredEmissionsData[ aPeriod ] + numYears );
+}
+
+/*!
+ * \brief Free the stored emissions of a period if they are in memory.
+ * \param aPeriod Model period, greater than zero.
+ */
+void ASimpleCarbonCalc::releaseStoredEmissions( const int aPeriod ) {
+    delete mStoredEmissionsAbove[ aPeriod ];
+    delete mStoredEmissionsBelow[ aPeriod ];
+    ::operator delete( mStoredEmissionsData[ aPeriod ] );
+    mStoredEmissionsAbove[ aPeriod ] = 0;
+    mStoredEmissionsBelow[ aPeriod ] = 0;
+    mStoredEmissionsData[ aPeriod ] = 0;
+}
+
+/*!
+ * \brief Move the stored emissions of a period to the HistorySpillFile.
+ * \details Nothing is done if they are not in memory or could not be written.
+ * \param aPeriod Model period, greater than zero.
+ */
+void ASimpleCarbonCalc::spillStoredEmissions( const int aPeriod ) {
+    if( !mStoredEmissionsData[ aPeriod ] ) {
+        return;
+    }
+    const size_t numValues = mStoredEmissionsAbove[ aPeriod ]->size() + mStoredEmissionsBelow[ aPeriod ]->size();
+    vector<double> buffer( numValues );
+    for( size_t i = 0; i < numValues; ++i ) {
+        buffer[ i ] = mStoredEmissionsData[ aPeriod ][ i ];
+    }
+    if( HistorySpillFile::getInstance().write( &buffer[ 0 ], numValues, mStoredEmissionsOffset[ aPeriod ] ) ) {
+        releaseStoredEmissions( aPeriod );
+    }
+}
+
+/*!
+ * \brief Bring the stored emissions of a period into memory.
+ * \details They are read back from the HistorySpillFile if they were moved
+ *          there, or are otherwise allocated for the first time.
+ * \param aPeriod Model period, greater than zero.
+ */
+void ASimpleCarbonCalc::restoreStoredEmissions( const int aPeriod ) {
+    if( mStoredEmissionsData[ aPeriod ] ) {
+        return;
+    }
+    allocateStoredEmissions( aPeriod );
+    if( mStoredEmissionsOffset[ aPeriod ] != HistorySpillFile::NOT_WRITTEN ) {
+        const size_t numValues = mStoredEmissionsAbove[ aPeriod ]->size() + mStoredEmissionsBelow[ aPeriod ]->size();
+        vector<double> buffer( numValues );
+        HistorySpillFile::getInstance().read( mStoredEmissionsOffset[ aPeriod ], &buffer[ 0 ], numValues );
+        for( size_t i = 0; i < numValues; ++i ) {
+            mStoredEmissionsData[ aPeriod ][ i ] = buffer[ i ];
+        }
     }
 }
 
@@ -98,6 +177,15 @@ void ASimpleCarbonCalc::setLandUseObjects( const LandUseHistory* aHistory, const
 
 void ASimpleCarbonCalc::initCalc( const int aPeriod ) {
     if( aPeriod > 0 ) {
+        HistorySpillFile& spillFile = HistorySpillFile::getInstance();
+        if( spillFile.isEnabled() ) {
+            // The periods before this one are solved and their stored
+            // emissions are only needed again if they are recalculated.
+            for( int period = 1; period < aPeriod; ++period ) {
+                spillStoredEmissions( period );
+            }
+            restoreStoredEmissions( aPeriod );
+        }
         const Modeltime* modeltime = scenario->getModeltime();
         const int prevModelYear = modeltime->getper_to_yr(aPeriod-1);
         int year = prevModelYear + 1;
@@ -152,11 +240,19 @@ double ASimpleCarbonCalc::calc( const int aPeriod, const int aEndYear, const boo
         YearVector<Value>& currEmissionsAbove = *mStoredEmissionsAbove[ aPeriod ];
         YearVector<Value>& currEmissionsBelow = *mStoredEmissionsBelow[ aPeriod ];
         
-        // clear the previously calculated emissions first
-        for( ; year <= aEndYear; ++year ) {
-            currEmissionsAbove[ year ] = 0.0;
-            currEmissionsBelow[ year ] = 0.0;
-        }
+        // Accumulate the emissions for this period into contiguous scratch
+        // arrays which the emissions kernels can be vectorized over and only
+        // copy them into the stored emissions once at the end.  The arrays
+        // are reused by every leaf calculated on this thread.
+        const int numYears = aEndYear - prevModelYear;
+        static thread_local vector<double> scratchAbove;
+        static thread_local vector<double> scratchBelow;
+        scratchAbove.assign( numYears, 0.0 );
+        scratchBelow.assign( numYears, 0.0 );
+        YearArray emissionsAbove( &scratchAbove[ 0 ], prevModelYear + 1 );
+        YearArray emissionsBelow( &scratchBelow[ 0 ], prevModelYear + 1 );
+        static thread_local vector<double> soilCarbonDiffs;
+        soilCarbonDiffs.resize( modelYear - prevModelYear );
         
         year = prevModelYear;
         double currLand = aPeriod == 1 ? mLandUseHistory->getAllocation( prevModelYear ) : mLandLeaf->getLandAllocation( mLandLeaf->getName(), aPeriod - 1 );
@@ -167,13 +263,24 @@ double ASimpleCarbonCalc::calc( const int aPeriod, const int aEndYear, const boo
             double prevLand = currLand;
             currLand += avgAnnualChangeInLand;
             double currCarbonBelow = currLand * getActualBelowGroundCarbonDensity( year);
-            calcAboveGroundCarbonEmission( mCarbonStock[ year - 1 ], prevLand, currLand, getActualAboveGroundCarbonDensity( year ), year, aEndYear, currEmissionsAbove );
-            calcBelowGroundCarbonEmission( prevCarbonBelow - currCarbonBelow, year, aEndYear, currEmissionsBelow );
+            calcAboveGroundCarbonEmission( mCarbonStock[ year - 1 ], prevLand, currLand, getActualAboveGroundCarbonDensity( year ), year, aEndYear, emissionsAbove );
+            soilCarbonDiffs[ year - prevModelYear - 1 ] = prevCarbonBelow - currCarbonBelow;
 
-            mCarbonStock[ year ] = mCarbonStock[ year - 1 ] - ( mTotalEmissionsAbove[ year ] + currEmissionsAbove[ year ] );
+            mCarbonStock[ year ] = mCarbonStock[ year - 1 ] - ( mTotalEmissionsAbove[ year ] + emissionsAbove[ year ] );
             prevCarbonBelow = currCarbonBelow;
         }
         
+        // The soil carbon changes only feed back into the emissions so they
+        // can be spread out over the future years all at once.
+        convolveBelowGroundCarbonEmission( &soilCarbonDiffs[ 0 ], soilCarbonDiffs.size(),
+                                           prevModelYear + 1, aEndYear, emissionsBelow );
+        
+        // replace the previously calculated emissions
+        for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
+            currEmissionsAbove[ year ] = emissionsAbove[ year ];
+            currEmissionsBelow[ year ] = emissionsBelow[ year ];
+        }
+        
         if( aStoreFullEmiss ) {
             // add current emissions to the total
             for( year = prevModelYear + 1; year <= aEndYear; ++year ) {
@@ -262,6 +369,26 @@ double ASimpleCarbonCalc::getAboveGroundCarbonSubsidyDiscountFactor( ){
 
 void ASimpleCarbonCalc::setSoilTimeScale( const int aTimeScale ) {
     mSoilTimeScale = aTimeScale;
+    precalcSoilResponse();
+}
+
+/*!
+ * \brief Precompute the cumulative soil carbon response by year offset.
+ * \details The response only depends on the soil time scale so it is computed
+ *          once here rather than for every year of every carbon change during
+ *          calcBelowGroundCarbonEmission.
+ */
+void ASimpleCarbonCalc::precalcSoilResponse() {
+    const int numYears = CarbonModelUtils::getEndYear() - CarbonModelUtils::getStartYear() + 1;
+    const double halfLife = mSoilTimeScale / 10.0;
+    const double log2 = log( 2.0 );
+    const double lambda = log2 / halfLife;
+    precalc_soil_cum_response.resize( numYears + 1 );
+    precalc_soil_cum_response[ 0 ] = 0.0;
+    for( int yearCounter = 1; yearCounter <= numYears; ++yearCounter ) {
+        precalc_soil_cum_response[ yearCounter ] = 1.0 - exp( -1.0 * lambda * yearCounter );
+    }
+    mSoilDecayFactor = exp( -1.0 * lambda );
 }
 
 double ASimpleCarbonCalc::getAboveGroundCarbonStock( const int aYear ) const {
@@ -169,13 +169,14 @@ double CarbonModelUtils::interpYearHelper( const objects::PeriodVector<double>&
     
     // Find the period containing aYear. This cannot be zero because the year
     // was already checked against the start year.
-    int currPeriod = modeltime->getyr_to_per( aYear );
+    const Modeltime::YearPeriodTable yearPeriodTable = modeltime->getYearPeriodTable();
+    int currPeriod = yearPeriodTable.getPeriod( aYear );
 
     // Find the last year of the current period.
-    int lastYear = modeltime->getper_to_yr( currPeriod );
+    int lastYear = yearPeriodTable.getYear( currPeriod );
 
     // Find the first year of the current period.
-    int firstYear = modeltime->getper_to_yr( currPeriod - 1 );
+    int firstYear = yearPeriodTable.getYear( currPeriod - 1 );
 
     // Interpolate the result.
     return util::linearInterpolateY( aYear, firstYear, lastYear,
@@ -44,6 +44,7 @@
 // iTp is used extensively in array declarations, so it's special
 #define iTp 740
 
+#include <iosfwd>
 #include "climate/include/MAGICC_array.h"
 
 //#define DEBUG_MAGICC++
@@ -392,10 +393,11 @@ float GETCARBONRESULTS(int, int);
 void SETPARAMETERVALUES(int, float);
 void overrideParameters( NEWPARAMS_block* NEWPARAMS, CAR_block* CAR, METH1_block* METH1, BCOC_block* BCOC );
 void SET_GAS_EMK( const std::string& GAS_EMK_DATA );
+void SET_MAGICC_FILE_OUTPUT( const bool aWriteFiles );
 
 // Internal helper methods
 
-void openfile_read( std::ifstream* infile, const std::string& f, bool echo );
+void openfile_read( std::istringstream* infile, const std::string& f, bool echo );
 void skipline( std::istream* infile, bool echo );
 float read_csv_value( std::istream* infile, bool echo );
 float read_and_discard( std::istream* infile, bool echo );
@@ -0,0 +1,170 @@
+#ifndef _CLIMATE_EMULATOR_H_
+#define _CLIMATE_EMULATOR_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file climate_emulator.h
+* \ingroup Objects
+* \brief The ClimateEmulator header file.
+*/
+
+#include <string>
+#include <vector>
+#include "climate/include/iclimate_model.h"
+
+class IVisitor;
+
+/*! 
+* \ingroup Objects
+* \brief A linearized impulse response surrogate for a full climate model.
+* \details The ClimateEmulator wraps the scenario's climate model and, once
+*          calibrated, estimates the temperature, total forcing, RCP forcing,
+*          CO2 forcing and CO2 concentration without running the wrapped model.
+*          Calibration runs the wrapped model for the current emissions
+*          trajectory to get a reference response and then again with a one
+*          year pulse of net land use change CO2 to get the impulse response
+*          of each quantity. The emulated value in a year is then the reference
+*          value plus the convolution of that impulse response with the change
+*          in total CO2 emissions from the reference trajectory.
+*
+*          Emissions are still passed to the wrapped model, from which the
+*          emulator reads them, so that the wrapped model may be run at any
+*          point to validate the emulated path. Calls for any other quantity
+*          and for years outside of the calibrated range are delegated to the
+*          wrapped model and so reflect its last full run.
+*
+*          The emulator is only accurate near the trajectory it was calibrated
+*          around so callers should validate the final result with the wrapped
+*          model and recalibrate if it is off.
+* \sa PolicyTargetRunner
+*/
+class ClimateEmulator: public IClimateModel {
+public:
+    ClimateEmulator();
+    virtual ~ClimateEmulator();
+
+    bool calibrate( IClimateModel* aClimateModel );
+
+    bool isCalibrated() const;
+
+    static const std::string& getXMLNameStatic();
+    virtual const std::string& getXMLName() const { return getXMLNameStatic(); }
+    virtual void XMLParse( const xercesc::DOMNode* node );
+    virtual void toInputXML( std::ostream& out, Tabs* tabs ) const;
+    virtual void toDebugXML( const int period, std::ostream& out, Tabs* tabs ) const;
+
+    virtual void completeInit( const std::string& aScenarioName );
+
+    virtual bool setEmissions( const std::string& aGasName,
+                               const int aPeriod,
+                               const double aEmission );
+
+    virtual bool setLUCEmissions( const std::string& aGasName,
+                                  const int aYear,
+                                  const double aEmission );
+
+    virtual double getEmissions( const std::string& aGasName,
+                                 const int aYear ) const;
+
+    virtual enum runModelStatus runModel();
+
+    virtual enum runModelStatus runModel( const int aYear );
+
+    virtual double getConcentration( const std::string& aGasName,
+                                     const int aYear ) const;
+
+    virtual double getTemperature( const int aYear ) const;
+
+    virtual double getForcing( const std::string& aGasName,
+                               const int aYear ) const;
+
+    virtual double getTotalForcing( const int aYear ) const;
+
+    virtual double getNetTerrestrialUptake( const int aYear ) const;
+
+    virtual double getNetOceanUptake( const int aYear ) const;
+
+    virtual int getCarbonModelStartYear() const;
+
+    virtual void printFileOutput() const;
+    virtual void printDBOutput() const;
+    virtual void accept( IVisitor* aVisitor, const int aPeriod ) const;
+
+private:
+    //! The quantities which are emulated.
+    enum Quantity {
+        TEMPERATURE,
+        TOTAL_FORCING,
+        RCP_FORCING,
+        CO2_FORCING,
+        CO2_CONCENTRATION,
+        NUM_QUANTITIES
+    };
+
+    double getModelValue( const Quantity aQuantity, const int aYear ) const;
+
+    double getEmulatedValue( const Quantity aQuantity, const int aYear ) const;
+
+    double getTotalCO2Emissions( const int aYear ) const;
+
+    //! The wrapped climate model, this object does not own it.
+    IClimateModel* mClimateModel;
+
+    //! The first emulated year, which is the year of the calibration pulse.
+    int mFirstYear;
+
+    //! The last emulated year.
+    int mLastYear;
+
+    //! Total CO2 emissions by year from mFirstYear of the reference trajectory.
+    std::vector<double> mReferenceEmissions;
+
+    //! The value of each quantity by year from mFirstYear of the reference
+    //! trajectory.
+    std::vector<std::vector<double> > mReference;
+
+    //! The response of each quantity to a unit pulse of CO2 in mFirstYear
+    //! indexed by the number of years since the pulse.
+    std::vector<std::vector<double> > mImpulseResponse;
+
+    //! The emulated value of each quantity by year from mFirstYear as of the
+    //! last call to runModel.
+    std::vector<std::vector<double> > mEmulated;
+};
+
+#endif // _CLIMATE_EMULATOR_H_
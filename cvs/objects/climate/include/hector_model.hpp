@@ -98,6 +98,7 @@ public:
     virtual double getEmissions( const std::string& aGasName, const int aYear ) const;
     virtual runModelStatus runModel();
     virtual runModelStatus runModel( const int aPeriod );
+    virtual runModelStatus runEnsemble( const std::string& aParameterFile );
     virtual double getConcentration( const std::string& aGasName, const int aYear ) const;
     virtual double getTemperature( const int aYear ) const;
     virtual double getForcing( const std::string& aGasName, const int aYear ) const;
@@ -188,11 +189,24 @@ private:
     //! Hector core object
     std::auto_ptr<Hector::Core> mHcore;
 
+    //! The first year the Hector core has already run past for which the
+    //! emissions have since changed, or the max int if there is none.  The
+    //! outputs stored for years before this are still valid.
+    int mFirstChangedYear;
+
     //! file handle for the outputstream visitor
     std::auto_ptr<std::ofstream> mOfile;
 
     //! output stream visitor
     std::auto_ptr<Hector::CSVOutputStreamVisitor> mHosv;
+
+    //! Whether this is a member of an ensemble run by runEnsemble, in which
+    //! case the Hector output stream is not written.
+    bool mIsEnsembleMember;
+
+    //! Hector parameters by component and variable name which override those
+    //! of the ini file.
+    std::map<std::string, std::map<std::string, std::string> > mParameterOverrides;
     
     // private functions
     
@@ -202,11 +216,17 @@ private:
     //! worker routine for setting emissions
     bool setEmissionsByYear( const std::string& aGasName, const int aYear, double aEmissions );
 
+    void recordEmissionsChange( const double aOldEmissions, const double aNewEmissions,
+                                const int aFirstAffectedYear );
+
     //! subroutines for getting data from Hector and storing it in the tables
     void storeConc( const int aYear, const bool aHadError );
     void storeRF( const int aYear, const bool aHadError );
     void storeGlobals( const int aYear, const bool aHadError );
 
+    //! set up the gas name and unit tables
+    void setupTables();
+
     //! set up the tables used by the functions in the previous block
     void setupConcTbl();
     void setupRFTbl();
@@ -189,6 +189,17 @@ public:
      *           necessary reset.
      */
     virtual enum runModelStatus runModel( const int aYear ) { return NOT_IMPLEMENTED; }
+
+    /*! \brief Run an ensemble of the climate model with perturbed parameters.
+     *  \details The ensemble members are run with the emissions of the last
+     *           run of this model and parameter values read from the given
+     *           file, and a summary of their spread is written out.  The results
+     *           of this model are not changed.  Optional, since not all models
+     *           are able to run ensembles.
+     *  \param aParameterFile The file containing the parameter samples.
+     *  \return Status code for the ensemble run.
+     */
+    virtual enum runModelStatus runEnsemble( const std::string& aParameterFile ) { return NOT_IMPLEMENTED; }
     
     /*! \brief Returns the concentrations for a given gas in a given period from
     *          the climate model.
@@ -42,19 +42,35 @@
 #include <iostream>
 #include <string>
 #include <fstream>
+#include <sstream>
+#include <map>
 
 using namespace std;
 
+// Whether the MAGICC diagnostic output files should be written.
+bool G_MAGICC_FILE_OUTPUT = false;
+
 // Small helper functions related to file I/O
 
-void openfile_read( ifstream* infile, const string& f, bool echo )
+void openfile_read( istringstream* infile, const string& f, bool echo )
 {
-    (*infile).open( f.c_str(), ios::in );
-    if ( !infile ) {
-        cerr << "Unable to open file " << f << " for read\n";
-        exit( 1 ); 
+    // The input files do not change during a run so each is only read from
+    // disk the first time and then kept in memory for the following runs.
+    static map<string, string> fileContents;
+    map<string, string>::const_iterator cached = fileContents.find( f );
+    if( cached == fileContents.end() ) {
+        ifstream file( f.c_str(), ios::in );
+        if ( !file ) {
+            cerr << "Unable to open file " << f << " for read\n";
+            exit( 1 ); 
+        }
+        ostringstream contents;
+        contents << file.rdbuf();
+        cached = fileContents.insert( make_pair( f, contents.str() ) ).first;
+        if ( echo ) cout << "Opened file " << f << " for read OK\n";
     }
-    if ( echo ) cout << "Opened file " << f << " for read OK\n";
+    (*infile).clear();
+    (*infile).str( cached->second );
 }
 
 void skipline( istream* infile, bool echo )
@@ -91,6 +107,11 @@ float read_and_discard( istream* infile, bool echo )
 
 void openfile_write( ofstream* outfile, const string& f, bool echo )
 {
+    // The stream is left closed if file output is off, in which case writes
+    // to it are discarded.
+    if ( !G_MAGICC_FILE_OUTPUT ) {
+        return;
+    }
     (*outfile).open( f.c_str(), ios::out );
     if ( !outfile ) {
         cerr << "Unable to open file " << f << " for write\n";
@@ -99,4 +120,8 @@ void openfile_write( ofstream* outfile, const string& f, bool echo )
     if ( echo ) cout << "Opened file " << f << " for write OK\n";
 }
 
+void SET_MAGICC_FILE_OUTPUT( const bool aWriteFiles )
+{
+    G_MAGICC_FILE_OUTPUT = aWriteFiles;
+}
 
@@ -477,7 +477,7 @@ void CLIMAT()
     //F 254 !
     //F 255       lun = 42   ! spare logical unit no.
     //F 256       open(unit=lun,file='./magicc_files/CO2HIST.IN',status='OLD')
-    ifstream infile;
+    istringstream infile;
     openfile_read( &infile, BASE_INPUT_DIR + "/co2hist_c.in", DEBUG_IO );
     //F 257       DO ICO2=0,JSTART
     for( int ICO2=0; ICO2<=JSTART.JSTART; ICO2++ ) {
@@ -486,7 +486,7 @@ void CLIMAT()
         //F 259       END DO
     }
     //F 260       CLOSE(lun)
-    infile.close();
+    infile.clear();
     //F 261 !
     //F 262 !  READ PARAMETERS FROM MAGUSER.CFG.
     //F 263 !
@@ -522,7 +522,7 @@ void CLIMAT()
     const int NONOFF = 0;
     //F 280 !
     //F 281       close(lun)
-    infile.close();
+    infile.clear();
     //F 282 !
     //F 283       LASTMAX=1764+iTp
     const int LASTMAX = 1764 + iTp;
@@ -549,7 +549,7 @@ void CLIMAT()
     const float ASEN = read_and_discard( &infile, false );
     //F 298 !
     //F 299       CLOSE(lun)
-    infile.close();
+    infile.clear();
     //F 300 !
     //F 301 !  ********************************************************************
     //F 302 !
@@ -635,7 +635,7 @@ void CLIMAT()
     METH3.ICH4FEED = read_and_discard( &infile, false );
     //F 344 !
     //F 345       close(lun)
-    infile.close();
+    infile.clear();
     //F 346 
     //! Initiailize internal BC-OC vars
     //aBCUnitForcing = 0
@@ -774,7 +774,7 @@ void CLIMAT()
     }
     //F 427 !
     //F 428       close(lun)
-    infile.close();
+    infile.clear();
     //F 429 !
     //F 430 !   Call overrite subroutine after each file that may have parameters to overwrite
     //F 431       call overrideParameters( )	! sjs
@@ -1091,7 +1091,7 @@ void CLIMAT()
     /* //UNUSED const float D2400 = */ read_and_discard( &infile, false );
     //F 603 !
     //F 604       close(lun)
-    infile.close();
+    infile.clear();
     //F 605 !
     //F 606 !  ********************************************************************
     //F 607 !
@@ -1161,7 +1161,7 @@ void CLIMAT()
     const int IYRQALL = 1990;
     //F 642 !
     //F 643       close(lun)
-    infile.close();
+    infile.clear();
     //F 644 !
     //F 645 !   Call overrite subroutine after each file that may have parameters to overwrite
     //F 646       call overrideParameters( ) !sjs
@@ -1330,7 +1330,7 @@ void CLIMAT()
     }
     //F 747 !
     //F 748       CLOSE(lun)
-    infile.close();
+    infile.clear();
     //F 749 !
     //F 750 !  TAU FOR CH4 SOIL SINK CHANGED TO ACCORD WITH IPCC94 (160 yr).
     //F 751 !  SPECIFICATION OF TauSoil MOVED TO MAGEXTRA.CFG ON 1/10/97.
@@ -1433,7 +1433,7 @@ void CLIMAT()
             //F 815         ENDIF
         }
         //F 816         close(lun)
-        infile.close();
+        infile.clear();
         //F 817       ENDIF
     }
     //F 818 !
@@ -1551,7 +1551,7 @@ void CLIMAT()
             //F 882         ENDIF
         }
         //F 883         close(lun)
-        infile.close();
+        infile.clear();
         //F 884       ELSE
     } else {
         //F 885         JQLAST=2100-1764
@@ -1656,7 +1656,7 @@ void CLIMAT()
         }
         //F 950         
         //F 951         close(lun)
-        infile.close();
+        infile.clear();
         //F 952         
         //F 953         ! Flag to use QExtra forcing
         //F 954         IQREAD = 1
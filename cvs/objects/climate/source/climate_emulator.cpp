@@ -0,0 +1,333 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file climate_emulator.cpp
+* \ingroup Objects
+* \brief This file contains the source for the ClimateEmulator class.
+*/
+#include "util/base/include/definitions.h"
+#include <cassert>
+
+#include "climate/include/climate_emulator.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/model_time.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+extern Scenario* scenario;
+
+//! Constructor
+ClimateEmulator::ClimateEmulator():
+mClimateModel( 0 ),
+mFirstYear( 0 ),
+mLastYear( -1 )
+{
+}
+
+//! Destructor
+ClimateEmulator::~ClimateEmulator(){
+}
+
+const string& ClimateEmulator::getXMLNameStatic(){
+    static const string XML_NAME = "climate-emulator";
+    return XML_NAME;
+}
+
+/*!
+ * \brief Calibrate the emulator around the current emissions trajectory.
+ * \details Runs the given climate model three times: once for the reference
+ *          response, once with a pulse of net land use change CO2 in the first
+ *          emulated year to determine the impulse response, and once more
+ *          after removing the pulse so that the climate model is left
+ *          consistent with the current emissions.
+ * \param aClimateModel The climate model to emulate, which must have the
+ *        current emissions set.  The emulator does not take ownership.
+ * \return Whether the calibration was successful, if not the emulator will
+ *         delegate all calls to the climate model.
+ */
+bool ClimateEmulator::calibrate( IClimateModel* aClimateModel ) {
+    assert( aClimateModel );
+    mClimateModel = aClimateModel;
+    mImpulseResponse.clear();
+
+    // Emissions in the calibration periods do not change with policy so only
+    // years after them need to be emulated.
+    const Modeltime* modeltime = scenario->getModeltime();
+    mFirstYear = modeltime->getper_to_yr( modeltime->getFinalCalibrationPeriod() ) + 1;
+    mLastYear = modeltime->getEndYear();
+    const int numYears = mLastYear - mFirstYear + 1;
+
+    // The size of the calibration pulse in the units the climate model uses for
+    // CO2 emissions.
+    const double pulseSize = 1.0;
+
+    bool success = mClimateModel->runModel() == SUCCESS;
+    mReferenceEmissions.resize( numYears );
+    mReference.assign( NUM_QUANTITIES, vector<double>( numYears ) );
+    for( int i = 0; i < numYears; ++i ) {
+        mReferenceEmissions[ i ] = getTotalCO2Emissions( mFirstYear + i );
+        for( int quantity = 0; quantity < NUM_QUANTITIES; ++quantity ) {
+            mReference[ quantity ][ i ] = getModelValue( static_cast<Quantity>( quantity ),
+                                                         mFirstYear + i );
+        }
+    }
+    mEmulated = mReference;
+
+    const double referenceLUC = mClimateModel->getEmissions( "CO2NetLandUse", mFirstYear );
+    success = success && mClimateModel->setLUCEmissions( "CO2NetLandUse", mFirstYear,
+                                                         referenceLUC + pulseSize );
+    success = success && mClimateModel->runModel() == SUCCESS;
+    if( success ) {
+        vector<vector<double> > impulseResponse( NUM_QUANTITIES, vector<double>( numYears ) );
+        bool hasResponse = false;
+        for( int quantity = 0; quantity < NUM_QUANTITIES; ++quantity ) {
+            for( int i = 0; i < numYears; ++i ) {
+                impulseResponse[ quantity ][ i ] =
+                    ( getModelValue( static_cast<Quantity>( quantity ), mFirstYear + i )
+                      - mReference[ quantity ][ i ] ) / pulseSize;
+                hasResponse |= impulseResponse[ quantity ][ i ] != 0;
+            }
+        }
+        // A climate model which could not take the pulse in this year will
+        // not have responded to it and can not be emulated.
+        if( hasResponse ) {
+            mImpulseResponse.swap( impulseResponse );
+        }
+    }
+
+    // Remove the pulse and rerun so the climate model is left consistent with
+    // the emissions.
+    mClimateModel->setLUCEmissions( "CO2NetLandUse", mFirstYear, referenceLUC );
+    mClimateModel->runModel();
+
+    ILogger& climateLog = ILogger::getLogger( "climate-log" );
+    climateLog.setLevel( isCalibrated() ? ILogger::NOTICE : ILogger::WARNING );
+    climateLog << "Climate emulator calibration for years " << mFirstYear << " to "
+               << mLastYear << ( isCalibrated() ? " succeeded." : " failed." ) << endl;
+    return isCalibrated();
+}
+
+/*!
+ * \brief Whether the emulator has been successfully calibrated.
+ * \return True if the emulator has an impulse response to use.
+ */
+bool ClimateEmulator::isCalibrated() const {
+    return !mImpulseResponse.empty();
+}
+
+void ClimateEmulator::XMLParse( const DOMNode* node ) {
+    // The emulator is created by the target finder and is not read in.
+}
+
+void ClimateEmulator::toInputXML( ostream& out, Tabs* tabs ) const {
+    if( mClimateModel ) {
+        mClimateModel->toInputXML( out, tabs );
+    }
+}
+
+void ClimateEmulator::toDebugXML( const int period, ostream& out, Tabs* tabs ) const {
+    if( mClimateModel ) {
+        mClimateModel->toDebugXML( period, out, tabs );
+    }
+}
+
+void ClimateEmulator::completeInit( const string& aScenarioName ) {
+    // The wrapped climate model is initialized by the World.
+}
+
+bool ClimateEmulator::setEmissions( const string& aGasName, const int aPeriod,
+                                    const double aEmission )
+{
+    return mClimateModel->setEmissions( aGasName, aPeriod, aEmission );
+}
+
+bool ClimateEmulator::setLUCEmissions( const string& aGasName, const int aYear,
+                                       const double aEmission )
+{
+    return mClimateModel->setLUCEmissions( aGasName, aYear, aEmission );
+}
+
+double ClimateEmulator::getEmissions( const string& aGasName, const int aYear ) const {
+    return mClimateModel->getEmissions( aGasName, aYear );
+}
+
+/*!
+ * \brief Update the emulated quantities for the emissions currently set in the
+ *        wrapped climate model.
+ * \details This is the convolution of the change in total CO2 emissions since
+ *          calibration with the impulse response of each quantity.  If the
+ *          emulator is not calibrated the wrapped model is run instead.
+ * \return The status of the run.
+ */
+IClimateModel::runModelStatus ClimateEmulator::runModel() {
+    if( !isCalibrated() ) {
+        return mClimateModel->runModel();
+    }
+
+    const int numYears = mLastYear - mFirstYear + 1;
+    vector<double> emissionsChange( numYears );
+    for( int i = 0; i < numYears; ++i ) {
+        emissionsChange[ i ] = getTotalCO2Emissions( mFirstYear + i ) - mReferenceEmissions[ i ];
+    }
+
+    for( int quantity = 0; quantity < NUM_QUANTITIES; ++quantity ) {
+        const vector<double>& impulseResponse = mImpulseResponse[ quantity ];
+        const vector<double>& reference = mReference[ quantity ];
+        vector<double>& emulated = mEmulated[ quantity ];
+        for( int i = 0; i < numYears; ++i ) {
+            double response = 0;
+            for( int j = 0; j <= i; ++j ) {
+                response += impulseResponse[ i - j ] * emissionsChange[ j ];
+            }
+            emulated[ i ] = reference[ i ] + response;
+        }
+    }
+    return SUCCESS;
+}
+
+IClimateModel::runModelStatus ClimateEmulator::runModel( const int aYear ) {
+    // The emulated path is cheap to update in full, emissions in later years
+    // will be updated once their periods have been solved.
+    return isCalibrated() ? runModel() : mClimateModel->runModel( aYear );
+}
+
+double ClimateEmulator::getConcentration( const string& aGasName, const int aYear ) const {
+    return aGasName == "CO2" ? getEmulatedValue( CO2_CONCENTRATION, aYear )
+                             : mClimateModel->getConcentration( aGasName, aYear );
+}
+
+double ClimateEmulator::getTemperature( const int aYear ) const {
+    return getEmulatedValue( TEMPERATURE, aYear );
+}
+
+double ClimateEmulator::getForcing( const string& aGasName, const int aYear ) const {
+    if( aGasName == "RCP" ) {
+        return getEmulatedValue( RCP_FORCING, aYear );
+    }
+    else if( aGasName == "CO2" ) {
+        return getEmulatedValue( CO2_FORCING, aYear );
+    }
+    return mClimateModel->getForcing( aGasName, aYear );
+}
+
+double ClimateEmulator::getTotalForcing( const int aYear ) const {
+    return getEmulatedValue( TOTAL_FORCING, aYear );
+}
+
+double ClimateEmulator::getNetTerrestrialUptake( const int aYear ) const {
+    return mClimateModel->getNetTerrestrialUptake( aYear );
+}
+
+double ClimateEmulator::getNetOceanUptake( const int aYear ) const {
+    return mClimateModel->getNetOceanUptake( aYear );
+}
+
+int ClimateEmulator::getCarbonModelStartYear() const {
+    return mClimateModel->getCarbonModelStartYear();
+}
+
+void ClimateEmulator::printFileOutput() const {
+    mClimateModel->printFileOutput();
+}
+
+void ClimateEmulator::printDBOutput() const {
+    mClimateModel->printDBOutput();
+}
+
+void ClimateEmulator::accept( IVisitor* aVisitor, const int aPeriod ) const {
+    mClimateModel->accept( aVisitor, aPeriod );
+}
+
+/*!
+ * \brief Get an emulated quantity from the wrapped climate model.
+ * \param aQuantity The quantity to get.
+ * \param aYear The year for which to get the quantity.
+ * \return The value from the wrapped climate model's last run.
+ */
+double ClimateEmulator::getModelValue( const Quantity aQuantity, const int aYear ) const {
+    switch( aQuantity ) {
+        case TEMPERATURE:
+            return mClimateModel->getTemperature( aYear );
+        case TOTAL_FORCING:
+            return mClimateModel->getTotalForcing( aYear );
+        case RCP_FORCING:
+            return mClimateModel->getForcing( "RCP", aYear );
+        case CO2_FORCING:
+            return mClimateModel->getForcing( "CO2", aYear );
+        case CO2_CONCENTRATION:
+            return mClimateModel->getConcentration( "CO2", aYear );
+        default:
+            assert( false );
+            return 0;
+    }
+}
+
+/*!
+ * \brief Get an emulated quantity.
+ * \details Years outside of the emulated range and all years when the emulator
+ *          is not calibrated are taken from the wrapped climate model.
+ * \param aQuantity The quantity to get.
+ * \param aYear The year for which to get the quantity.
+ * \return The value of the quantity.
+ */
+double ClimateEmulator::getEmulatedValue( const Quantity aQuantity, const int aYear ) const {
+    if( !isCalibrated() || aYear < mFirstYear || aYear > mLastYear ) {
+        return getModelValue( aQuantity, aYear );
+    }
+    return mEmulated[ aQuantity ][ aYear - mFirstYear ];
+}
+
+/*!
+ * \brief Get the total CO2 emissions which the wrapped model uses in a year.
+ * \details Fossil and industrial CO2 is set by period and so is interpolated
+ *          between periods in the same way the climate models do, net land use
+ *          change CO2 is set by year.
+ * \param aYear The year for which to get emissions.
+ * \return Total CO2 emissions in the year.
+ */
+double ClimateEmulator::getTotalCO2Emissions( const int aYear ) const {
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int period = modeltime->getyr_to_per( aYear );
+    const int periodYear = modeltime->getper_to_yr( period );
+    double fossilEmissions = mClimateModel->getEmissions( "CO2", periodYear );
+    if( periodYear != aYear && period > 0 ) {
+        const int prevYear = modeltime->getper_to_yr( period - 1 );
+        const double prevEmissions = mClimateModel->getEmissions( "CO2", prevYear );
+        fossilEmissions = prevEmissions + ( fossilEmissions - prevEmissions )
+            * static_cast<double>( aYear - prevYear ) / ( periodYear - prevYear );
+    }
+    return fossilEmissions + mClimateModel->getEmissions( "CO2NetLandUse", aYear );
+}
@@ -39,10 +39,17 @@
  */
 
 #include <memory>
+#include <algorithm>
 #include <limits>
 #include <fstream>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/algorithm/string/classification.hpp>
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/parallel_for.h>
+#endif
 
 #include "climate/include/hector_model.hpp"
 
@@ -54,6 +61,8 @@
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/ivisitor.h"
+#include "util/base/include/auto_file.h"
+#include "util/base/include/util.h"
 
 #include "climate/source/hector/headers/components/component_data.hpp"
 #include "climate/source/hector/headers/data/unitval.hpp"
@@ -85,6 +94,31 @@ namespace {
 
     // don't ask
     bool hector_log_is_init = false;
+
+    // The quantiles of the ensemble results to report.
+    const double ENSEMBLE_QUANTILES[] = { 0.05, 0.17, 0.5, 0.83, 0.95 };
+
+    /*!
+     * \brief Calculate a quantile of a set of values by linear interpolation
+     *        between the closest ranks, ignoring any values which are not
+     *        valid numbers.
+     * \param aValues The values, which are reordered.
+     * \param aQuantile The quantile to calculate between 0 and 1.
+     * \return The quantile or NaN if there are no valid values.
+     */
+    double calcQuantile( vector<double>& aValues, const double aQuantile ) {
+        aValues.erase( remove_if( aValues.begin(), aValues.end(),
+                                  []( const double aValue ) { return !util::isValidNumber( aValue ); } ),
+                       aValues.end() );
+        if( aValues.empty() ) {
+            return numeric_limits<double>::quiet_NaN();
+        }
+        sort( aValues.begin(), aValues.end() );
+        const double rank = aQuantile * ( aValues.size() - 1 );
+        const size_t lower = static_cast<size_t>( floor( rank ) );
+        const size_t upper = min( lower + 1, aValues.size() - 1 );
+        return aValues[ lower ] + ( rank - lower ) * ( aValues[ upper ] - aValues[ lower ] );
+    }
 } 
 
 HectorModel::HectorModel()
@@ -100,6 +134,8 @@ HectorModel::HectorModel()
     mEmissionsSwitchYear = def_switch_year;
     // Hector config location.  
     mHectorIniFile = def_ini_file; 
+
+    mIsEnsembleMember = false;
 }
 
 
@@ -188,6 +224,7 @@ void HectorModel::completeInit( const string& aScenarioName ) {
     climatelog.setLevel( ILogger::NOTICE );
     
     mLastYear = 0;
+    mFirstChangedYear = numeric_limits<int>::max();
 
     climatelog << "Climate model is Hector.  Configuration:"
                << endl << "\thector-end-year = " << mHectorEndYear
@@ -218,6 +255,20 @@ void HectorModel::completeInit( const string& aScenarioName ) {
         throw;
     } 
 
+    setupTables();
+
+    // reset up to (but not including) period 1.
+    reset( 1 );
+}
+
+/*!
+ * \brief Set up the gas name and unit tables and size the emissions and
+ *        results tables.
+ */
+void HectorModel::setupTables() {
+    ILogger& climatelog = ILogger::getLogger( "climate-log" );
+    climatelog.setLevel( ILogger::NOTICE );
+
     // Set up the name tables for each of the gases that GCAM and
     // hector both know about.  
     mHectorEmissionsMsg["CO2"]           = D_FFI_EMISSIONS; 
@@ -291,10 +342,6 @@ void HectorModel::completeInit( const string& aScenarioName ) {
         mEmissionsTable[ it->first ].resize (scenario->getModeltime()->getmaxper() );
         mUnitConvFac[ it->first ] = 1.0; // default value; will set exceptions below
         mHectorUnits[ it->first ] = Hector::U_GG; // This is the default; exceptions below
-
-        // per-gas results tables
-        mConcTable[ it->first ].resize( nrslt );
-        mGasRFTable[ it->first ].resize( nrslt ); 
         
         climatelog << "Tracking GCAM gas " << it->first << " as Hector gas "
                    << it->second << endl;
@@ -307,7 +354,8 @@ void HectorModel::completeInit( const string& aScenarioName ) {
     mTemperatureTable.resize( nrslt );
     mLandFlux.resize( nrslt );
     mOceanFlux.resize( nrslt );
-    // set up the other results tables
+    // set up the per-gas results tables, only the gases which are actually
+    // stored by storeConc and storeRF get a table
     setupConcTbl();
     setupRFTbl();
     
@@ -333,9 +381,6 @@ void HectorModel::completeInit( const string& aScenarioName ) {
     mHectorUnits["CH4"]                                 = Hector::U_TG_CH4;
     mHectorUnits["N2O"]                                 = Hector::U_TG_N2O;
     mHectorUnits["SO2tot"]                              = Hector::U_GG_S;
-    
-    // reset up to (but not including) period 1.
-    reset( 1 );
 }
 
 
@@ -362,13 +407,16 @@ void HectorModel::reset( const int aPeriod ) {
         mHcore->shutDown();
         mHcore.release();
     }
-    if( !mOfile.get() ) {
-        mOfile.reset( new ofstream( "logs/gcam-hector-outputstream.csv" ) );
-        mHosv.reset( new Hector::CSVOutputStreamVisitor( *mOfile, true ) );
-    }
-    else {
-        // log the core reset
-        (*mOfile) << "\n\n################ Hector Core Reset ################\n\n";
+    // Ensemble members do not write the Hector output stream.
+    if( !mIsEnsembleMember ) {
+        if( !mOfile.get() ) {
+            mOfile.reset( new ofstream( "logs/gcam-hector-outputstream.csv" ) );
+            mHosv.reset( new Hector::CSVOutputStreamVisitor( *mOfile, true ) );
+        }
+        else {
+            // log the core reset
+            (*mOfile) << "\n\n################ Hector Core Reset ################\n\n";
+        }
     }
 
     // set up a new core
@@ -378,7 +426,22 @@ void HectorModel::reset( const int aPeriod ) {
     climatelog << "Parsing ini file= " << mHectorIniFile << endl;
     Hector::INIToCoreReader coreParser( mHcore.get() );
     coreParser.parse( mHectorIniFile );
-    mHcore->addVisitor( mHosv.get() ); 
+
+    // Override any parameters from the ini file, this is used to perturb the
+    // parameters of ensemble members.
+    for( map<string, map<string, string> >::const_iterator compIt = mParameterOverrides.begin();
+         compIt != mParameterOverrides.end(); ++compIt )
+    {
+        for( map<string, string>::const_iterator varIt = compIt->second.begin();
+             varIt != compIt->second.end(); ++varIt )
+        {
+            mHcore->setData( compIt->first, varIt->first,
+                             Hector::message_data( varIt->second ) );
+        }
+    }
+    if( mHosv.get() ) {
+        mHcore->addVisitor( mHosv.get() ); 
+    }
     mHcore->prepareToRun();
 
     const Modeltime* modeltime = scenario->getModeltime();
@@ -416,6 +479,28 @@ void HectorModel::reset( const int aPeriod ) {
     // updated output we would like to report from hector along the way.
     mLastYear = modeltime->getStartYear();
     mHcore->run( static_cast<double>( mLastYear ) );
+
+    // The core is now consistent with all of the emissions it will run.
+    mFirstChangedYear = numeric_limits<int>::max();
+}
+
+/*! \brief Record a change to emissions which may invalidate years the core
+ *         has already run.
+ *  \details Only changes affecting years the Hector core has already run
+ *           past are recorded, anything later will be picked up when the core
+ *           runs those years.
+ *  \param aOldEmissions The emissions previously set.
+ *  \param aNewEmissions The emissions being set.
+ *  \param aFirstAffectedYear The first year whose results the change may
+ *         affect.
+ */
+void HectorModel::recordEmissionsChange( const double aOldEmissions,
+                                         const double aNewEmissions,
+                                         const int aFirstAffectedYear )
+{
+    if( aFirstAffectedYear <= mLastYear && aOldEmissions != aNewEmissions ) {
+        mFirstChangedYear = min( mFirstChangedYear, aFirstAffectedYear );
+    }
 }
 
 /*! \brief Set emissions for hector model 
@@ -477,10 +562,16 @@ bool HectorModel::setEmissionsByYear( const string& aGasName,
 bool HectorModel::setEmissions( const string& aGasName, const int aPeriod,
                                 double aEmissions )
 {
-    int year = scenario->getModeltime()->getper_to_yr( aPeriod ); 
+    const Modeltime* modeltime = scenario->getModeltime();
+    int year = modeltime->getper_to_yr( aPeriod ); 
     bool valid = setEmissionsByYear( aGasName, year, aEmissions );
     if( valid ) {
-        mEmissionsTable[ aGasName ][ aPeriod ] = aEmissions;
+        // Hector interpolates between periods so the change may affect any year
+        // after the previous period.
+        double& emissions = mEmissionsTable[ aGasName ][ aPeriod ];
+        recordEmissionsChange( emissions, aEmissions,
+            aPeriod > 0 ? modeltime->getper_to_yr( aPeriod - 1 ) + 1 : year );
+        emissions = aEmissions;
     }
     return valid;
 }
@@ -506,7 +597,9 @@ bool HectorModel::setLUCEmissions( const string& aGasName,
     bool valid = setEmissionsByYear( aGasName, aYear, aEmissions );
 
     if( valid ) {
-        mEmissionsTable[ aGasName ] [ yearlyDataIndex( aYear ) ] = aEmissions;
+        double& emissions = mEmissionsTable[ aGasName ][ yearlyDataIndex( aYear ) ];
+        recordEmissionsChange( emissions, aEmissions, aYear );
+        emissions = aEmissions;
     }
     return valid;
 }
@@ -515,7 +608,14 @@ bool HectorModel::setLUCEmissions( const string& aGasName,
  */
 IClimateModel::runModelStatus HectorModel::runModel( const int aYear ) {
     const Modeltime* modeltime = scenario->getModeltime();
-    if( aYear <= mLastYear ) {
+    if( aYear <= mLastYear && aYear < mFirstChangedYear ) {
+        // None of the emissions up to this year have changed since the core
+        // ran them so the stored results are still valid and there is no need
+        // to rewind the core.  It is left where it is in case the later years
+        // are unchanged as well.
+        return SUCCESS;
+    }
+    if( aYear <= mLastYear || mFirstChangedYear <= mLastYear ) {
         int period;
         if( aYear <= modeltime->getper_to_yr( 1 )) {
             // before the first valid period.
@@ -881,6 +981,158 @@ void HectorModel::printDBOutput() const {
     dboutput4( "global", "General", "netLUEm", "Period", "GtC", data );
 }
 
+/*!
+ * \brief Run an ensemble of Hector with perturbed parameters.
+ * \details The parameter file is a CSV file with a header row naming each
+ *          parameter as component.variable, as the section and name would be
+ *          given in the Hector ini file, followed by one row of values for each
+ *          ensemble member.  Lines starting with # are ignored.  Each member
+ *          runs a separate Hector core with the ini file parameters overridden
+ *          by its values and the emissions of the last run.  When
+ *          GCAM_PARALLEL_ENABLED the members are run concurrently.  Quantiles
+ *          across the members of temperature, total forcing and CO2
+ *          concentration for each model period are then written once to the
+ *          climate-ensemble-output file.  The results of this model are not
+ *          changed.
+ * \param aParameterFile The file containing the parameter samples.
+ * \return Whether the ensemble was run.
+ */
+IClimateModel::runModelStatus HectorModel::runEnsemble( const string& aParameterFile ) {
+    ILogger& climatelog = ILogger::getLogger( "climate-log" );
+
+    // Read the parameter names and samples.
+    ifstream parameterFile( aParameterFile.c_str() );
+    if( !parameterFile ) {
+        climatelog.setLevel( ILogger::ERROR );
+        climatelog << "Could not open climate ensemble parameter file " << aParameterFile << endl;
+        return INVALID;
+    }
+    vector<pair<string, string> > parameterNames;
+    vector<vector<string> > samples;
+    string line;
+    while( getline( parameterFile, line ) ) {
+        boost::trim( line );
+        if( line.empty() || line[ 0 ] == '#' ) {
+            continue;
+        }
+        vector<string> fields;
+        boost::split( fields, line, boost::is_any_of( "," ) );
+        for( vector<string>::iterator it = fields.begin(); it != fields.end(); ++it ) {
+            boost::trim( *it );
+        }
+        if( parameterNames.empty() ) {
+            for( vector<string>::const_iterator it = fields.begin(); it != fields.end(); ++it ) {
+                const size_t separator = it->find( '.' );
+                if( separator == string::npos ) {
+                    climatelog.setLevel( ILogger::ERROR );
+                    climatelog << "Climate ensemble parameter " << *it
+                               << " must be given as component.variable." << endl;
+                    return INVALID;
+                }
+                parameterNames.push_back( make_pair( it->substr( 0, separator ),
+                                                     it->substr( separator + 1 ) ) );
+            }
+        }
+        else if( fields.size() != parameterNames.size() ) {
+            climatelog.setLevel( ILogger::ERROR );
+            climatelog << "Climate ensemble sample " << samples.size() + 1 << " has "
+                       << fields.size() << " values but " << parameterNames.size()
+                       << " parameters were given." << endl;
+            return INVALID;
+        }
+        else {
+            samples.push_back( fields );
+        }
+    }
+
+    // The results indexed by output, ensemble member and then period.
+    enum { TEMPERATURE, TOTAL_FORCING, CO2_CONCENTRATION, NUM_RESULTS };
+    const string RESULT_NAMES[] = { "temperature", "total-forcing", "CO2-concentration" };
+    const Modeltime* modeltime = scenario->getModeltime();
+    const int maxPeriod = modeltime->getmaxper();
+    vector<vector<vector<double> > > results( NUM_RESULTS,
+        vector<vector<double> >( samples.size(),
+            vector<double>( maxPeriod, numeric_limits<double>::quiet_NaN() ) ) );
+
+    const int endYear = mHcore->getEndDate();
+    auto runMember = [&]( const size_t aMember ) {
+        HectorModel member;
+        member.mIsEnsembleMember = true;
+        member.mHectorEndYear = mHectorEndYear;
+        member.mEmissionsSwitchYear = mEmissionsSwitchYear;
+        member.mHectorIniFile = mHectorIniFile;
+        member.mCarbonModelStartYear = mCarbonModelStartYear;
+        for( size_t i = 0; i < parameterNames.size(); ++i ) {
+            member.mParameterOverrides[ parameterNames[ i ].first ][ parameterNames[ i ].second ] =
+                samples[ aMember ][ i ];
+        }
+        member.setupTables();
+        member.mEmissionsTable = mEmissionsTable;
+        try {
+            member.reset( maxPeriod - 1 );
+            if( member.runModel( endYear ) == SUCCESS ) {
+                for( int period = 0; period < maxPeriod; ++period ) {
+                    const int year = modeltime->getper_to_yr( period );
+                    results[ TEMPERATURE ][ aMember ][ period ] = member.getTemperature( year );
+                    results[ TOTAL_FORCING ][ aMember ][ period ] = member.getTotalForcing( year );
+                    results[ CO2_CONCENTRATION ][ aMember ][ period ] = member.getConcentration( "CO2", year );
+                }
+            }
+            member.mHcore->shutDown();
+        }
+        catch( const h_exception& e ) {
+            // The member's results are left invalid and are excluded from the
+            // quantiles.
+        }
+    };
+
+#if GCAM_PARALLEL_ENABLED
+    tbb::parallel_for( tbb::blocked_range<size_t>( 0, samples.size(), 1 ),
+        [&runMember]( const tbb::blocked_range<size_t>& aRange ) {
+            for( size_t member = aRange.begin(); member != aRange.end(); ++member ) {
+                runMember( member );
+            }
+        } );
+#else
+    for( size_t member = 0; member < samples.size(); ++member ) {
+        runMember( member );
+    }
+#endif
+
+    int numFailed = 0;
+    for( size_t member = 0; member < samples.size(); ++member ) {
+        if( !util::isValidNumber( results[ TEMPERATURE ][ member ][ maxPeriod - 1 ] ) ) {
+            ++numFailed;
+        }
+    }
+    climatelog.setLevel( numFailed > 0 ? ILogger::WARNING : ILogger::NOTICE );
+    climatelog << "Ran climate ensemble of " << samples.size() << " members, "
+               << numFailed << " failed." << endl;
+
+    // Write the quantiles of each result.
+    AutoOutputFile ensembleFile( "climate-ensemble-output", "climate-ensemble.csv" );
+    *ensembleFile << "variable,quantile";
+    for( int period = 0; period < maxPeriod; ++period ) {
+        *ensembleFile << "," << modeltime->getper_to_yr( period );
+    }
+    *ensembleFile << endl;
+    vector<double> values;
+    for( int result = 0; result < NUM_RESULTS; ++result ) {
+        for( size_t quantile = 0; quantile < sizeof( ENSEMBLE_QUANTILES ) / sizeof( ENSEMBLE_QUANTILES[ 0 ] ); ++quantile ) {
+            *ensembleFile << RESULT_NAMES[ result ] << "," << ENSEMBLE_QUANTILES[ quantile ];
+            for( int period = 0; period < maxPeriod; ++period ) {
+                values.resize( samples.size() );
+                for( size_t member = 0; member < samples.size(); ++member ) {
+                    values[ member ] = results[ result ][ member ][ period ];
+                }
+                *ensembleFile << "," << calcQuantile( values, ENSEMBLE_QUANTILES[ quantile ] );
+            }
+            *ensembleFile << endl;
+        }
+    }
+    return numFailed < static_cast<int>( samples.size() ) ? SUCCESS : FAILURE;
+}
+
 void HectorModel::accept( IVisitor* aVisitor, const int aPeriod ) const {
     aVisitor->startVisitClimateModel( this, aPeriod );
     aVisitor->endVisitClimateModel( this, aPeriod );
@@ -194,6 +194,10 @@ void MagiccModel::completeInit( const string& aScenarioName ){
     mOutputGasNameMap[ "RCP" ] = 27; // RCP radiative forcing (total - nitrate, albedo, mineral dust)
     
     overwriteMAGICCParameters( );
+
+    // MAGICC's diagnostic files are only written if requested, its results are
+    // kept in memory.
+    SET_MAGICC_FILE_OUTPUT( Configuration::getInstance()->getBool( "MAGICC-file-output" ) );
 }
 
 /*! \brief Overwrite MAGICC default parameters with new values.
@@ -876,8 +880,8 @@ int MagiccModel::getCarbonModelStartYear() const {
 
 /*! \brief Write out data from the emissions model to the main csv output file.*/
 void MagiccModel::printFileOutput() const {
-    void fileoutput3(string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3(const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     // Fill up a vector of CO2 concentrations.
     const Modeltime* modeltime = scenario->getModeltime();
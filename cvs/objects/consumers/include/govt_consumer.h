@@ -54,6 +54,7 @@
 
 #include "consumers/include/consumer.h"
 #include "util/base/include/value.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class NationalAccount;
 class Demographic;
@@ -133,6 +134,9 @@ private:
     // Calculated parameters.
     Value mBaseTransferPopCoef;
     Value mSigma;
+
+    //! The trial government taxes market located in initCalc.
+    CachedMarketVector mTaxMarket;
 };
 
 #endif // _GOVT_CONSUMER_H_
@@ -49,6 +49,7 @@
 #include <xercesc/dom/DOMNode.hpp>
 
 #include "consumers/include/consumer.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class NationalAccount;
 class Demographic;
@@ -181,6 +182,21 @@ private:
     double workingAgePopFemale; //!< population of working age females(from Demographics)
     double workingAgePop; //!< population of working age (from Demographics)
 
+    //! Whether this consumer is in the numeraire region, set in completeInit.
+    bool mIsNumeraireRegion;
+
+    //! The name of the budget market, set in initCalc so that it is not
+    //! rebuilt on every call to operate.
+    std::string mBudgetMarketName;
+
+    //! Factor and budget markets located in initCalc and used during operate
+    //! to avoid looking them up by name on every iteration.
+    CachedMarketVector mUnSkLabMarket;
+    CachedMarketVector mSkLabMarket;
+    CachedMarketVector mCapitalMarket;
+    CachedMarketVector mLandMarket;
+    CachedMarketVector mBudgetMarket;
+
     void copy( const HouseholdConsumer& householdConsumerIn );
 };
 
@@ -196,6 +196,7 @@ void GovtConsumer::initCalc( const MoreSectorInfo* aMoreSectorInfo, const string
         // TODO: is this really needed?
         BaseTechnology::calcPricePaid(aMoreSectorInfo, aRegionName, aSectorName, aPeriod, 
             modelTime->gettimestep( aPeriod ) );
+        mTaxMarket.locateMarket( "government-taxes", aRegionName, aPeriod );
         if( aPeriod == 0 ){
 
             // set trial price (budget) to the solution price for the base year
@@ -246,7 +247,6 @@ void GovtConsumer::calcTotalTax( NationalAccount& aNationalAccount, const string
     // We need to add the taxes from the production side to the trial market since they
     // do not do that themselves.  Consumers are responsible for adding their taxes into
     // this market.
-    Marketplace* marketplace = scenario->getMarketplace();
     mTaxCorporate.set( aNationalAccount.getAccountValue( NationalAccount::CORPORATE_INCOME_TAXES ) );
     mTaxIBT.set( aNationalAccount.getAccountValue( NationalAccount::INDIRECT_BUSINESS_TAX ) );
     double totalProductionTaxes = aNationalAccount.getAccountValue( NationalAccount::CORPORATE_INCOME_TAXES )
@@ -257,7 +257,7 @@ void GovtConsumer::calcTotalTax( NationalAccount& aNationalAccount, const string
     //marketplace->addToDemand( "government-taxes", aRegionName, totalProductionTaxes, aPeriod );
     
     // get the trial total taxes
-    double totalTaxes = marketplace->getPrice( "government-taxes", aRegionName, aPeriod );
+    double totalTaxes = mTaxMarket.getPrice( "government-taxes", aRegionName, aPeriod );
     expenditures[ aPeriod ].setType( Expenditure::INCOME, totalTaxes );
 
     // is this appropriate to put in here since it did not spend its
@@ -73,6 +73,7 @@ HouseholdConsumer::HouseholdConsumer() {
     baseScalerLaborMale = 0;
     baseScalerLaborFemale = 0;
     baseScalerSavings = 0;
+    mIsNumeraireRegion = false;
 
     maxLandSupplyFrac = 0;
     maxLaborSupplyFracMale = 0;
@@ -347,6 +348,8 @@ void HouseholdConsumer::completeInit( const string& aRegionName,
                                       const string& aSubsectorName )
 {
     BaseTechnology::completeInit( aRegionName, aSectorName, aSubsectorName );
+
+    mIsNumeraireRegion = aRegionName == Configuration::getInstance()->getString( "numeraire-region", "USA" );
     
     // Only the base year consumer should setup the market, future consumers
     // will use it.
@@ -398,6 +401,16 @@ void HouseholdConsumer::initCalc( const MoreSectorInfo* aMoreSectorInfo, const s
     if ( year == modelTime->getper_to_yr( aPeriod ) ) {
         const Configuration* conf = Configuration::getInstance();
         const string numeraireRegion = conf->getString( "numeraire-region", "USA" );
+
+        // Locate the markets used during operate now that they have all been
+        // created.
+        mBudgetMarketName = getBudgetMarketName();
+        mBudgetMarket.locateMarket( mBudgetMarketName, aRegionName, aPeriod );
+        mUnSkLabMarket.locateMarket( "UnSkLab", aRegionName, aPeriod );
+        mSkLabMarket.locateMarket( "SkLab", aRegionName, aPeriod );
+        mCapitalMarket.locateMarket( "Capital", aRegionName, aPeriod );
+        mLandMarket.locateMarket( "Land", aRegionName, aPeriod );
+
         if( aPeriod == 0 ) {
             Marketplace* marketplace = scenario->getMarketplace();
             // calculate Price Paid
@@ -503,10 +516,9 @@ void HouseholdConsumer::calcFactorDemand( const string& regionName, int period )
 
 //! calculate social security tax
 double HouseholdConsumer::calcSocialSecurityTax( NationalAccount& nationalAccount, const string& regionName, int period ) {
-    Marketplace* marketplace = scenario->getMarketplace();
-    double socialSecurityTax = socialSecurityTaxRate * ( marketplace->getPrice( "UnSkLab", regionName, period )
+    double socialSecurityTax = socialSecurityTaxRate * ( mUnSkLabMarket.getPrice( "UnSkLab", regionName, period )
                                * ( laborSupplyMaleUnSkLab + laborSupplyFemaleUnSkLab ) +
-                               marketplace->getPrice( "SkLab", regionName, period ) * 
+                               mSkLabMarket.getPrice( "SkLab", regionName, period ) * 
                                ( laborSupplyMaleSkLab + laborSupplyFemaleSkLab ) );
 
     expenditures[ period ].setType( Expenditure::SOCIAL_SECURITY_TAX, socialSecurityTax );
@@ -515,11 +527,10 @@ double HouseholdConsumer::calcSocialSecurityTax( NationalAccount& nationalAccoun
 
 //! calculate savings
 void HouseholdConsumer::calcSavings( double disposableIncome, const string& regionName, int period ) {
-    Marketplace* marketplace = scenario->getMarketplace();
     //maxSavingsRate = So, S1 = 1, S2 = savingsBaseCoef
     const int S1 = 1;
     double savings = maxSavingsSupplyFrac * disposableIncome * ( 1 - S1*exp( 
-        baseScalerSavings * marketplace->getPrice( "Capital", regionName, period ) ) ); // looks to be the correct price
+        baseScalerSavings * mCapitalMarket.getPrice( "Capital", regionName, period ) ) ); // looks to be the correct price
     //double savings = baseScalerSavings * disposableIncome;
     expenditures[ period ].setType( Expenditure::SAVINGS, savings );
     assert( savings > 0 );
@@ -528,11 +539,10 @@ void HouseholdConsumer::calcSavings( double disposableIncome, const string& regi
 
 // calculate land supply
 void HouseholdConsumer::calcLandSupply( const string& regionName, int period ) {
-    Marketplace* marketplace = scenario->getMarketplace();
     //maxSavingsRate = So, S1 = 1, S2 = savingsBaseCoef
     const int R1 = 1;
     landSupply = maxLandSupplyFrac * totalLandArea * ( 1 - R1*exp(
-        baseScalerLand * marketplace->getPrice( "Land", regionName, period ) ) ); // not sure i think i found this, and this is the correct price
+        baseScalerLand * mLandMarket.getPrice( "Land", regionName, period ) ) ); // not sure i think i found this, and this is the correct price
     //marketplace->addToSupply("Land", regionName, landSupply, period );
 }
 
@@ -597,10 +607,9 @@ void HouseholdConsumer::calcIncome( NationalAccount& nationalAccount, const stri
     }
     double socialSecurityTax = calcSocialSecurityTax( nationalAccount, regionName, period );
 
-    Marketplace* marketplace = scenario->getMarketplace();
-    double laborWages = marketplace->getPrice( "UnSkLab", regionName, period )
+    double laborWages = mUnSkLabMarket.getPrice( "UnSkLab", regionName, period )
                         * laborSupplyUnSkLab  +
-                        marketplace->getPrice( "SkLab", regionName, period )
+                        mSkLabMarket.getPrice( "SkLab", regionName, period )
                         * laborSupplySkLab;
 
     double taxableIncome = nationalAccount.getAccountValue( NationalAccount::DIVIDENDS ) +
@@ -687,8 +696,7 @@ void HouseholdConsumer::operate( NationalAccount& aNationalAccount, const Demogr
         // that households may demand land and labor, which would increase their
         // income, and increase their budget.
         Marketplace* marketplace = scenario->getMarketplace();
-        double trialBudget = marketplace->getPrice( getBudgetMarketName(),
-                                                    aRegionName, aPeriod );
+        double trialBudget = mBudgetMarket.getPrice( mBudgetMarketName, aRegionName, aPeriod );
         calcInputDemand( trialBudget, aRegionName, aSectorName, aPeriod );
 
         Expenditure& currExpenditure = expenditures[ aPeriod ];
@@ -698,7 +706,7 @@ void HouseholdConsumer::operate( NationalAccount& aNationalAccount, const Demogr
             priceIndexNum += (*inputIt)->getPhysicalDemand( 0 ) *
                 (*inputIt)->getPricePaid( aRegionName, aPeriod );
         }
-        if( aRegionName == Configuration::getInstance()->getString( "numeraire-region", "USA" ) ) {
+        if( mIsNumeraireRegion ) {
             //marketplace->addToSupply( getPriceIndexMarketName(), aRegionName, priceIndexNum, aPeriod );
         }
 
@@ -46,10 +46,12 @@
 
 #include <string>
 #include <list>
+#include <vector>
 #include <memory>
 #include <xercesc/dom/DOMNode.hpp>
 #include "containers/include/iscenario_runner.h"
 class Timer;
+class BatchCSVOutputter;
 
 /*! 
  * \ingroup Objects
@@ -74,7 +76,21 @@ class Timer;
  *          
  *          The batch runner is turned on using the boolean configuration value
  *          "BatchMode". The name of the configuration file is determined by the
- *          file configuration value "BatchFileName".
+ *          file configuration value "BatchFileName". Setting the integer
+ *          configuration value "batch-concurrent-scenarios" above one runs up to
+ *          that many scenarios at once in separate worker processes.  When
+ *          GCAM is run on several MPI ranks the scenarios are instead handed
+ *          out to the ranks. Setting the boolean configuration value
+ *          "batch-share-parsed-inputs" as well parses the inputs which the
+ *          concurrent scenarios share only once before the workers are forked.
+ *
+ *          Scenarios which only differ in file sets with a first-year, such as
+ *          policies which begin in a future year, are identical before the
+ *          earliest of those years. If the "checkpoint-location" is written
+ *          the periods before it are solved once and shared between the
+ *          scenarios through checkpoints named after the scenario runner and
+ *          the file sets without a first-year. The scenario runner must not
+ *          alter those periods either.
  *
  *          <b>XML specification for BatchRunner</b>
  *          - XML name: \c BatchRunner
@@ -88,6 +104,8 @@ class Timer;
  *                      - \c FileSet BatchRunner::FileSet
  *                          - Attributes:
  *                              - \c name Name of the FileSet.
+ *                              - \c first-year (optional) The first year the
+ *                                files affect.
  *                          - Elements:
  *                              - \c %Value Path to a single file.
  *                                  - Attributes:
@@ -147,6 +165,9 @@ protected:
 
         //! The name for the set of files.
         std::string mName;
+
+        //! The first year the files affect, zero if they affect all years.
+        int mFirstYear;
     };
 
     //! A structure which defines a single named component consisting of
@@ -178,12 +199,37 @@ protected:
     //! The current scenario runner.
     IScenarioRunner* mInternalRunner;
 
+    //! The status of a scenario run by a concurrent batch worker process.
+    enum ScenarioStatus {
+        SCENARIO_NOT_RUN,
+        SCENARIO_RUNNING,
+        SCENARIO_SOLVED,
+        SCENARIO_FAILED
+    };
+
 	BatchRunner();
 	bool runSingleScenario( IScenarioRunner* aScenarioRunner,
                             const Component& aCurrComponent,
                             const int aSinglePeriod,
                             Timer& aTimer );
 
+    bool runAllScenarioRunners( const Component& aComponent,
+                                BatchCSVOutputter& aCSVOutputter,
+                                const int aSinglePeriod,
+                                Timer& aTimer );
+
+    bool runConcurrentScenarios( const std::vector<Component>& aScenarios,
+                                 const int aNumWorkers,
+                                 const int aSinglePeriod,
+                                 Timer& aTimer );
+
+    bool runDistributedScenarios( const std::vector<Component>& aScenarios,
+                                  const int aSinglePeriod,
+                                  Timer& aTimer );
+
+    static std::string getWorkerCSVFileName( const std::string& aCSVFileName,
+                                             const int aScenarioIndex );
+
     bool XMLParseComponentSet( const xercesc::DOMNode* aNode );
 
     bool XMLParseRunnerSet( const xercesc::DOMNode* aNode );
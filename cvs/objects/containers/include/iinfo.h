@@ -47,6 +47,8 @@
 #include <string>
 #include <iosfwd>
 
+#include "containers/include/info_keys.h"
+
 class Tabs;
 
 /*!
@@ -57,6 +59,8 @@ class Tabs;
 *          accessed by their string key. The properties may be booleans,
 *          integers, double or strings. Operations exist to set or update values
 *          for a key, query if a key exists, and get the value for a key.
+*          Frequently used properties registered in InfoKeys may also be
+*          accessed by their numeric identifier which avoids hashing the key.
 * \todo Evaluate whether functions to add to a double value, and update an
 *       average would be useful as additions to the interface.
 * \todo Add longevity to properties.
@@ -201,6 +205,98 @@ public:
     */
     virtual bool hasValue( const std::string& aStringKey ) const = 0;
 
+    /*! \brief Set a boolean value for a registered key.
+    * \param aKey The registered key for which to set or update the value.
+    * \param aValue The new value.
+    * \see setBoolean( const std::string&, const bool )
+    */
+    virtual bool setBoolean( const InfoKeys::Key aKey, const bool aValue ) = 0;
+
+    /*! \brief Set an integer value for a registered key.
+    * \param aKey The registered key for which to set or update the value.
+    * \param aValue The new value.
+    * \see setInteger( const std::string&, const int )
+    */
+    virtual bool setInteger( const InfoKeys::Key aKey, const int aValue ) = 0;
+
+    /*! \brief Set a double value for a registered key.
+    * \param aKey The registered key for which to set or update the value.
+    * \param aValue The new value.
+    * \see setDouble( const std::string&, const double )
+    */
+    virtual bool setDouble( const InfoKeys::Key aKey, const double aValue ) = 0;
+
+    /*! \brief Set a string value for a registered key.
+    * \param aKey The registered key for which to set or update the value.
+    * \param aValue The new value.
+    * \see setString( const std::string&, const std::string& )
+    */
+    virtual bool setString( const InfoKeys::Key aKey, const std::string& aValue ) = 0;
+
+    /*! \brief Get a boolean from the IInfo with a registered key.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aMustExist Whether the value should exist in the IInfo.
+    * \return The boolean associated with the key or false if it does not exist.
+    */
+    virtual bool getBoolean( const InfoKeys::Key aKey, const bool aMustExist ) const = 0;
+
+    /*! \brief Get an integer from the IInfo with a registered key.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aMustExist Whether the value should exist in the IInfo.
+    * \return The integer associated with the key or zero if it does not exist.
+    */
+    virtual int getInteger( const InfoKeys::Key aKey, const bool aMustExist ) const = 0;
+
+    /*! \brief Get a double from the IInfo with a registered key.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aMustExist Whether the value should exist in the IInfo.
+    * \return The double associated with the key or zero if it does not exist.
+    */
+    virtual double getDouble( const InfoKeys::Key aKey, const bool aMustExist ) const = 0;
+
+    /*! \brief Get a string from the IInfo with a registered key.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aMustExist Whether the value should exist in the IInfo.
+    * \return The string(by reference) associated with the key or the empty
+    *         string if it does not exist.
+    */
+    virtual const std::string& getString( const InfoKeys::Key aKey, const bool aMustExist ) const = 0;
+
+    /*! \brief Get a boolean with a registered key searching the parents.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aFound Whether the value is found or not.
+    * \return The boolean associated with the key or false if it does not exist.
+    */
+    virtual bool getBooleanHelper( const InfoKeys::Key aKey, bool& aFound ) const = 0;
+
+    /*! \brief Get an integer with a registered key searching the parents.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aFound Whether the value is found or not.
+    * \return The integer associated with the key or zero if it does not exist.
+    */
+    virtual int getIntegerHelper( const InfoKeys::Key aKey, bool& aFound ) const = 0;
+
+    /*! \brief Get a double with a registered key searching the parents.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aFound Whether the value is found or not.
+    * \return The double associated with the key or zero if it does not exist.
+    */
+    virtual double getDoubleHelper( const InfoKeys::Key aKey, bool& aFound ) const = 0;
+
+    /*! \brief Get a string with a registered key searching the parents.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \param aFound Whether the value is found or not.
+    * \return The string(by reference) associated with the key or the empty
+    *         string if it does not exist.
+    */
+    virtual const std::string& getStringHelper( const InfoKeys::Key aKey, bool& aFound ) const = 0;
+
+    /*! \brief Return whether a value for a registered key exists in the IInfo.
+    * \param aKey The registered key for which to search the IInfo object.
+    * \return Whether the key exists in the IInfo.
+    */
+    virtual bool hasValue( const InfoKeys::Key aKey ) const = 0;
+
     /*! \brief Write the IInfo object to an output stream as XML.
     * \details Writes the set of keys and values to an output stream as XML.
     * \param aPeriod Model period for which to write debugging information.
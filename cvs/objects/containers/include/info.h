@@ -47,6 +47,7 @@
 
 #include <string>
 #include <iosfwd>
+#include <vector>
 #include <boost/any.hpp>
 #include <boost/noncopyable.hpp>
 #include "containers/include/iinfo.h"
@@ -66,6 +67,10 @@ class Tabs;
 * \ingroup Objects
 * \brief This class contains a set of properties which can be accessed by their
 *        unique identifier.
+* \details Properties are stored in a hashmap by their string key, except for
+*          the properties registered in InfoKeys which are stored in typed
+*          slots indexed by their numeric identifier. A registered property set
+*          or retrieved by its string key uses the same slot.
 * \author Josh Lurz
 * \todo Add longevity to properties.
 */
@@ -102,6 +107,20 @@ public:
 
     bool hasValue( const std::string& aStringKey ) const;
 
+    bool setBoolean( const InfoKeys::Key aKey, const bool aValue );
+    bool setInteger( const InfoKeys::Key aKey, const int aValue );
+    bool setDouble( const InfoKeys::Key aKey, const double aValue );
+    bool setString( const InfoKeys::Key aKey, const std::string& aValue );
+    bool getBoolean( const InfoKeys::Key aKey, const bool aMustExist ) const;
+    int getInteger( const InfoKeys::Key aKey, const bool aMustExist ) const;
+    double getDouble( const InfoKeys::Key aKey, const bool aMustExist ) const;
+    const std::string& getString( const InfoKeys::Key aKey, const bool aMustExist ) const;
+    bool getBooleanHelper( const InfoKeys::Key aKey, bool& aFound ) const;
+    int getIntegerHelper( const InfoKeys::Key aKey, bool& aFound ) const;
+    double getDoubleHelper( const InfoKeys::Key aKey, bool& aFound ) const;
+    const std::string& getStringHelper( const InfoKeys::Key aKey, bool& aFound ) const;
+    bool hasValue( const InfoKeys::Key aKey ) const;
+
     void toDebugXML( const int aPeriod, Tabs* aTabs, std::ostream& aOut ) const;
 protected:
     Info( const IInfo* aParentInfo, const std::string& aOwnerName );
@@ -133,6 +152,44 @@ private:
 
     template<class T> const T& getItemValueLocal( const std::string& aStringKey, bool& aExists ) const;
 
+    /*!
+     * \brief Storage for the value of a single registered property.
+     * \details Only the member corresponding to mType is used.
+     */
+    struct TypedSlot {
+        TypedSlot();
+        //! Whether a value has been set.
+        bool mIsSet;
+        //! The type of the value.
+        AnyType mType;
+        //! The value if it is a boolean.
+        bool mBoolean;
+        //! The value if it is an integer.
+        int mInteger;
+        //! The value if it is a double.
+        double mDouble;
+        //! The value if it is a string.
+        std::string mString;
+    };
+
+    template<class T> bool setSlotValue( const InfoKeys::Key aKey,
+                                         const AnyType aType,
+                                         const T& aValue );
+    template<class T> const T& getSlotValue( const InfoKeys::Key aKey, bool& aExists ) const;
+    static inline void setSlotMember( TypedSlot& aSlot, const bool aValue );
+    static inline void setSlotMember( TypedSlot& aSlot, const int aValue );
+    static inline void setSlotMember( TypedSlot& aSlot, const double aValue );
+    static inline void setSlotMember( TypedSlot& aSlot, const std::string& aValue );
+    static inline const bool& getSlotMember( const TypedSlot& aSlot, const bool* );
+    static inline const int& getSlotMember( const TypedSlot& aSlot, const int* );
+    static inline const double& getSlotMember( const TypedSlot& aSlot, const double* );
+    static inline const std::string& getSlotMember( const TypedSlot& aSlot, const std::string* );
+    static inline AnyType getSlotType( const bool* );
+    static inline AnyType getSlotType( const int* );
+    static inline AnyType getSlotType( const double* );
+    static inline AnyType getSlotType( const std::string* );
+    void writeSlotsToDebugXML( Tabs* aTabs, std::ostream& aOut ) const;
+
     size_t getInitialSize() const;
 
     void printItemNotFoundWarning( const std::string& aStringKey ) const;
@@ -153,6 +210,10 @@ private:
 
     //! Internal storage mapping item names to item values.
     std::auto_ptr<InfoMap> mInfoMap;
+
+    //! Typed storage for the registered properties indexed by their InfoKeys
+    //! identifier. This is empty until the first registered property is set.
+    std::vector<TypedSlot> mSlots;
 #if GCAM_PARALLEL_ENABLED
     // actions that modify mInfoMap MUST obtain a write lock on the info map.
     // Those that merely read it MUST obtain a read lock
@@ -178,6 +239,12 @@ template<class T> bool Info::setItemValueLocal( const std::string& aStringKey,
     /*! \pre A valid key was passed. */
     assert( !aStringKey.empty() );
 
+    // Registered properties are kept in their typed slot.
+    const int key = InfoKeys::findKey( aStringKey );
+    if( key != InfoKeys::NOT_FOUND ){
+        return setSlotValue( static_cast<InfoKeys::Key>( key ), aType, aValue );
+    }
+
     // If debug checking is turned on search for the key in the current object
     // to determine if the type of the existing and new types match. Search in
     // the parent to see if this new item will shadow a variable in the parent.
@@ -237,6 +304,12 @@ const T& Info::getItemValueLocal( const std::string& aStringKey,
     /*! \pre A valid key was passed. */
     assert( !aStringKey.empty() );
 
+    // Registered properties are kept in their typed slot.
+    const int key = InfoKeys::findKey( aStringKey );
+    if( key != InfoKeys::NOT_FOUND ){
+        return getSlotValue<T>( static_cast<InfoKeys::Key>( key ), aExists );
+    }
+
 #if GCAM_PARALLEL_ENABLED
     // read lock for reading the map
     tbb::queuing_rw_mutex::scoped_lock readlock(mInfoMapMutex, false);
@@ -276,6 +349,131 @@ const T& Info::getItemValueLocal( const std::string& aStringKey,
     return defaultValue;
 }
 
+/*! \brief Set the value of a registered property in its typed slot.
+* \details The slots are allocated the first time any registered property is
+*          set. If the property already has a value of a different type a
+*          warning is printed and the value and type are replaced.
+* \param aKey The identifier of the property.
+* \param aType Enum value of the type.
+* \param aValue The value to be associated with this key.
+*/
+template<class T> bool Info::setSlotValue( const InfoKeys::Key aKey,
+                                           const AnyType aType,
+                                           const T& aValue )
+{
+    // If debug checking is turned on search the parent to see if this new item
+    // will shadow a variable in the parent.
+    const static bool debugChecking = Configuration::getInstance()->getBool( "debugChecking" );
+    if( debugChecking && mParentInfo && !hasValue( aKey ) && mParentInfo->hasValue( aKey ) ){
+        printShadowWarning( InfoKeys::getName( aKey ) );
+    }
+#if GCAM_PARALLEL_ENABLED
+    // acquire a write lock for updating the slots
+    tbb::queuing_rw_mutex::scoped_lock writelock(mInfoMapMutex, true);
+#endif
+    if( mSlots.empty() ){
+        mSlots.resize( InfoKeys::eNumKeys );
+    }
+    TypedSlot& slot = mSlots[ aKey ];
+    if( slot.mIsSet && slot.mType != aType ){
+        printBadCastWarning( InfoKeys::getName( aKey ), true );
+    }
+    slot.mIsSet = true;
+    slot.mType = aType;
+    setSlotMember( slot, aValue );
+    return true;
+}
+
+/*! \brief Get the value of a registered property from its typed slot.
+* \param aKey The identifier of the property.
+* \param aExists Return parameter to update with whether the item existed.
+* \return The value associated with the key if it exists, the default value
+*         otherwise.
+* \warning As with getItemValueLocal this returns a reference to the stored
+*          value which is only valid until the value is updated.
+*/
+template<class T>
+const T& Info::getSlotValue( const InfoKeys::Key aKey, bool& aExists ) const
+{
+    /*! \pre The key is a registered property. */
+    assert( aKey >= 0 && aKey < InfoKeys::eNumKeys );
+#if GCAM_PARALLEL_ENABLED
+    // read lock for reading the slots
+    tbb::queuing_rw_mutex::scoped_lock readlock(mInfoMapMutex, false);
+#endif
+    if( !mSlots.empty() && mSlots[ aKey ].mIsSet ){
+        if( mSlots[ aKey ].mType == getSlotType( static_cast<const T*>( 0 ) ) ){
+            aExists = true;
+            return getSlotMember( mSlots[ aKey ], static_cast<const T*>( 0 ) );
+        }
+        printBadCastWarning( InfoKeys::getName( aKey ), false );
+    }
+    // Return the default value if a successful return has not already occurred.
+    aExists = false;
+    static const T defaultValue = T();
+    return defaultValue;
+}
+
+//! Store a boolean in a typed slot.
+void Info::setSlotMember( TypedSlot& aSlot, const bool aValue ){
+    aSlot.mBoolean = aValue;
+}
+
+//! Store an integer in a typed slot.
+void Info::setSlotMember( TypedSlot& aSlot, const int aValue ){
+    aSlot.mInteger = aValue;
+}
+
+//! Store a double in a typed slot.
+void Info::setSlotMember( TypedSlot& aSlot, const double aValue ){
+    aSlot.mDouble = aValue;
+}
+
+//! Store a string in a typed slot.
+void Info::setSlotMember( TypedSlot& aSlot, const std::string& aValue ){
+    aSlot.mString = aValue;
+}
+
+//! Get the boolean stored in a typed slot.
+const bool& Info::getSlotMember( const TypedSlot& aSlot, const bool* ){
+    return aSlot.mBoolean;
+}
+
+//! Get the integer stored in a typed slot.
+const int& Info::getSlotMember( const TypedSlot& aSlot, const int* ){
+    return aSlot.mInteger;
+}
+
+//! Get the double stored in a typed slot.
+const double& Info::getSlotMember( const TypedSlot& aSlot, const double* ){
+    return aSlot.mDouble;
+}
+
+//! Get the string stored in a typed slot.
+const std::string& Info::getSlotMember( const TypedSlot& aSlot, const std::string* ){
+    return aSlot.mString;
+}
+
+//! Get the type enum for a boolean.
+Info::AnyType Info::getSlotType( const bool* ){
+    return eBoolean;
+}
+
+//! Get the type enum for an integer.
+Info::AnyType Info::getSlotType( const int* ){
+    return eInteger;
+}
+
+//! Get the type enum for a double.
+Info::AnyType Info::getSlotType( const double* ){
+    return eDouble;
+}
+
+//! Get the type enum for a string.
+Info::AnyType Info::getSlotType( const std::string* ){
+    return eString;
+}
+
 /*!
  * \brief Print a single any type value to XML.
  * \param aValue Value stored as an any type.
@@ -0,0 +1,102 @@
+#ifndef _INFO_KEYS_H_
+#define _INFO_KEYS_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file info_keys.h
+* \ingroup objects
+* \brief The InfoKeys class header file.
+*/
+
+#include <string>
+
+/*!
+* \ingroup Objects
+* \brief A registry of the Info properties which are accessed frequently during
+*        the model calculations.
+* \details Each registered property has a numeric identifier which Info uses to
+*          store the value in a typed slot, so that looking up the property by
+*          its identifier is an array index instead of a string hash. The same
+*          properties may also be accessed by their string name as usual, the
+*          string name is mapped to the identifier so that both ways of
+*          accessing a property always refer to the same value. New properties
+*          should be added to the Key enum and to the list of names in
+*          info_keys.cpp in the same order.
+*/
+class InfoKeys {
+public:
+    //! Identifiers of the registered properties.
+    enum Key {
+        //! Lower bound of the supply price of a market.
+        eLowerBoundSupplyPrice,
+        //! Upper bound of the supply price of a market.
+        eUpperBoundSupplyPrice,
+        //! CO2 emissions coefficient of a good.
+        eCO2Coefficient,
+        //! Whether a technology is operating.
+        eIsTechOperating,
+        //! Capacity factor of a technology.
+        eTechCapacityFactor,
+        //! Whether a tax or subsidy is share based.
+        eIsShareBased,
+        //! Price paid for a good.
+        ePricePaid,
+        //! Price received for a good.
+        ePriceReceived,
+        //! Whether a good has a fixed price.
+        eIsFixedPrice,
+        //! Unit conversion factor of a good.
+        eConversionFactor,
+        //! Price unit of a market.
+        ePriceUnit,
+        //! Output unit of a market.
+        eOutputUnit,
+        //! The number of registered properties, must be last.
+        eNumKeys
+    };
+
+    //! Identifier returned by findKey if the name is not registered.
+    static const int NOT_FOUND = -1;
+
+    static const std::string& getName( const Key aKey );
+    static int findKey( const std::string& aName );
+private:
+    InfoKeys();
+};
+
+#endif // _INFO_KEYS_H_
@@ -48,11 +48,18 @@
 #include <vector>
 #include <string>
 #include <set>
+#include <map>
+#include <list>
+
+#if GCAM_PARALLEL_ENABLED
+#include <boost/shared_ptr.hpp>
+#endif
 
 class Marketplace;
 class IActivity;
 #if GCAM_PARALLEL_ENABLED
 class GcamFlowGraph;
+template<class nodeid_t> class digraph;
 #endif
 
 /*! 
@@ -76,9 +83,10 @@ class GcamFlowGraph;
  *                this process markets will be bound to the activities which
  *                are directly affected by a change in the price of that market.
  *              - Get the global ordering via getOrdering() or a market specific
- *                ordering via getOrdering(int marketNumber).  Note that for market
- *                specific ordering a search will be performed to get a complete
- *                list of items to calculate.
+ *                ordering via getOrdering(int marketNumber).  Note that the market
+ *                specific orderings are all searched for by createOrdering and
+ *                kept for the rest of the model run, with markets which affect
+ *                the same activities sharing a single list.
  *
  * \author Pralit Patel
  */
@@ -94,10 +102,12 @@ public:
                         const std::string& aDependencyRegion,
                         const bool aCanBeBroken = true );
 
-    const std::vector<IActivity*> getOrdering( const int aMarketNumber = -1 ) const;
+    const std::vector<IActivity*>& getOrdering( const int aMarketNumber = -1 ) const;
 
 #if GCAM_PARALLEL_ENABLED
-    GcamFlowGraph* getFlowGraph( const int aMarketNumber = -1 );
+    GcamFlowGraph* getFlowGraph();
+
+    boost::shared_ptr<GcamFlowGraph> createFlowGraph( const int aGrainSize );
 #endif
 
     void resolveActivityToDependency( const std::string& aRegionName, 
@@ -116,7 +126,7 @@ public:
      */
     struct CalcVertex {
         CalcVertex( IActivity* aCalcItem, DependencyItem* aDepItem, const int aUID )
-        :mCalcItem( aCalcItem ), mDepItem( aDepItem ), mUID( aUID ), mIndex( -1 ), mLowLink( -1 ) {}
+        :mCalcItem( aCalcItem ), mDepItem( aDepItem ), mUID( aUID ), mIndex( -1 ), mLowLink( -1 ), mOrderIndex( -1 ) {}
         ~CalcVertex();
         
         //! The object which does the calculations for this vertex.
@@ -140,6 +150,10 @@ public:
         //! the smallest index of a vertex know to be reachable from this vertex.
         int mLowLink;
 
+        //! The position of mCalcItem in the global ordering, set once the
+        //! ordering has been created.
+        int mOrderIndex;
+
         //! Some implied verticies to calculate (special case for the land-allocator)
         std::set<CalcVertex*> mImpliedInEdges;
     };
@@ -276,11 +290,7 @@ public:
      *        which would need to recalculate if the solver changed it's price.
      */
     struct MarketToDependencyItem {
-        MarketToDependencyItem( const int aMarketNumber ):mMarket( aMarketNumber )
-#if GCAM_PARALLEL_ENABLED
-                                                          ,mFlowGraph( 0 )
-#endif
-        {}
+        MarketToDependencyItem( const int aMarketNumber ):mMarket( aMarketNumber ) {}
         
         //! The market number which this struct represents.  Note that we do not
         //! directly link to a Market* since they are created by model period
@@ -290,19 +300,6 @@ public:
         //! A unique set of vertices to re-calculate should this market change
         //! it's price.
         std::set<CalcVertex*> mImpliedVertices;
-
-        //! A complete list of vertices to re-calculate should this market change
-        //! it's price.  Note that this is essentially a cache and only computed
-        //! the first time it is needed.
-        std::vector<IActivity*> mCalcList;
-
-#if GCAM_PARALLEL_ENABLED
-        //! A flow graph of vertices to re-calculate in parallel should this market
-        //! change it's price.  Note that this is essentially a cache and only computed
-        //! the first time it is needed.  This memory is owned my MarketDependencyFinder
-        //! and will be released explictly by it.
-        GcamFlowGraph* mFlowGraph;
-#endif
     };
     
     /*!
@@ -329,19 +326,60 @@ public:
     //! The final global ordering
     std::vector<IActivity*> mGlobalOrdering;
 
+    //! The distinct market specific orderings, each of which may be shared by
+    //! several markets which affect exactly the same activities.
+    std::vector<std::vector<IActivity*> > mMarketOrderings;
+
+    //! The index into mMarketOrderings of the ordering of each market by
+    //! market number, or -1 if the market is not linked to the graph.
+    std::vector<int> mMarketOrderingIndex;
+
     //! A UID counter to able to compare CalcVertex uniquely between runs
     int mCalcVertexUIDCount;
 
+    //! A hash of the dependency information which identifies the graph for
+    //! the purposes of the dependency cache.
+    size_t mDependencyHash;
+
+    //! The items converted to trial markets to break cycles, by region and
+    //! name, in the order they were chosen.
+    std::vector<std::pair<std::string, std::string> > mCycleTrials;
+
+    //! The key (see GcamParallel::getGrainKey) for which mGrains is valid.
+    size_t mGrainKey;
+
+    //! The grains of the global flow graph as CalcVertex UIDs, either read from
+    //! the dependency cache or recorded to be written to it.
+    std::vector<std::vector<int> > mGrains;
+
 #if GCAM_PARALLEL_ENABLED
     //! The global flow graph to calculate the full model in parallel
     GcamFlowGraph* mTBBGraphGlobal;
+
+    //! The flow graph of all activities from which the global graph and any
+    //! graphs made by createFlowGraph are taken.  Built the first time one of
+    //! them is needed.
+    digraph<IActivity*>* mGCAMFlowGraph;
+
+    //! Activities added to mGCAMFlowGraph to aggregate multi-region markets which
+    //! are identified in mGrains by the UID -( index + 1 ).
+    std::vector<IActivity*> mAggregationActivities;
 #endif
     
-    void findVerticesToCalculate( CalcVertex* aVertex, std::set<IActivity*>& aVisited ) const;
+    void findVerticesToCalculate( CalcVertex* aVertex, std::vector<bool>& aVisited,
+                                  std::vector<int>& aFound ) const;
+    void createMarketOrderings();
     void findStronglyConnected( CalcVertex* aCurrVertex, int& aMaxIndex,std::list<CalcVertex*>& aHasVisited,
                                 CalcVertexCountMap& aTotalVisits ) const;
     int markCycles( CalcVertex* aCurrVertex, std::list<CalcVertex*>& aHasVisited, CalcVertexCountMap& aTotalVisits ) const;
     void createTrialsForItem( CItemIterator aItemToReset, CalcVertexCountMap& aNumDependencies );
+    std::vector<CItemIterator> chooseCycleTrials( const CalcVertexCountMap& aNumDependencies, size_t& aGreedyCount ) const;
+    size_t calcDependencyHash() const;
+    void readCache( std::vector<std::pair<std::string, std::string> >& aCachedTrials );
+    void writeCache() const;
+#if GCAM_PARALLEL_ENABLED
+    const digraph<IActivity*>& getGCAMFlowGraph();
+#endif
 };
 
 #endif // _MARKET_DEPENDENCY_FINDER_H_
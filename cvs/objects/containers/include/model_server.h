@@ -0,0 +1,113 @@
+#ifndef _MODEL_SERVER_H_
+#define _MODEL_SERVER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file model_server.h
+ * \ingroup Objects
+ * \brief The ModelServer class header file.
+ */
+
+#include <iosfwd>
+#include <list>
+#include <string>
+
+class Timer;
+
+/*! 
+ * \ingroup Objects
+ * \brief Runs scenario variants on request from a persistent process which
+ *        keeps the parsed base inputs resident.
+ * \details The base input file and the configured scenario components are
+ *          parsed once when the server starts.  Requests are then read one per
+ *          line, each of which runs a scenario from those inputs together with
+ *          some additional scenario components.  Each request is run in a
+ *          forked copy of the server, as the batch runner does with
+ *          "batch-share-parsed-inputs", so the base inputs are shared copy on
+ *          write and are left untouched for the next request however the
+ *          request modifies them.  The scenario can not be shared past
+ *          completeInit since the additional components must be parsed before
+ *          it.  Requests are run one at a time and the outputs which are
+ *          written for each are those the configuration selects, for a scenario
+ *          named by appending the name given in the request to the configured
+ *          scenario name.  On platforms without fork the
+ *          base inputs are parsed again for each request.
+ *
+ *          The requests are:
+ *          - run <name> <stop-period> [<scenario component file> ...]
+ *          - quit
+ *
+ *          where a stop period of -1 runs all periods.  Each request is
+ *          answered by a single line prefixed with RESPONSE_PREFIX so that it
+ *          may be told apart from any log messages written to the console:
+ *          - <prefix> ready, once the base inputs have been parsed
+ *          - <prefix> solved <name>, or <prefix> unsolved <name>
+ *          - <prefix> failed <name>, if the scenario could not be set up or
+ *            its process exited unexpectedly
+ *          - <prefix> error <message>, for a request that was not understood
+ *          - <prefix> bye, once the server is exiting
+ */
+class ModelServer
+{
+public:
+    static bool run( Timer& aTimer, std::istream& aIn, std::ostream& aOut );
+
+    //! The prefix of every line written in response to a request.
+    static const std::string RESPONSE_PREFIX;
+
+private:
+    //! The outcome of running a single request.
+    enum Outcome {
+        //! The scenario ran and every period solved.
+        SOLVED,
+
+        //! The scenario ran but some period did not solve.
+        UNSOLVED,
+
+        //! The scenario could not be set up or did not complete.
+        FAILED
+    };
+
+    static Outcome runRequest( const std::string& aName, const int aStopPeriod,
+                               const std::list<std::string>& aComponents, Timer& aTimer );
+
+    static Outcome runScenario( const std::string& aName, const int aStopPeriod,
+                                const std::list<std::string>& aComponents, Timer& aTimer );
+};
+
+#endif // _MODEL_SERVER_H_
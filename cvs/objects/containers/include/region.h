@@ -90,6 +90,7 @@ public:
     void toDebugXML( const int period, std::ostream& out, Tabs* tabs ) const;
     static const std::string& getXMLNameStatic();
     virtual void completeInit();
+    virtual void completeSocioeconomicInit();
     const std::string& getName() const;
     
     virtual void initCalc( const int period );
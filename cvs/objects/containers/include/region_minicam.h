@@ -71,6 +71,7 @@ class GDP;
 class Curve;
 class AFinalDemand;
 class Consumer;
+class IndirectEmissionsCalculator;
 
 /*! 
 * \ingroup Objects
@@ -104,6 +105,7 @@ public:
     virtual ~RegionMiniCAM();
     static const std::string& getXMLNameStatic();
     virtual void completeInit();
+    virtual void completeSocioeconomicInit();
     
     virtual void initCalc( const int period );
 
@@ -157,6 +159,10 @@ protected:
     
     std::vector<Summary> summary; //!< summary values and totals for reporting
 
+    //! Indirect emissions of the sectors in this region, calculated for all
+    //! periods on first use by the output functions and shared by them.
+    mutable std::auto_ptr<IndirectEmissionsCalculator> mIndirectEmissionsCalc;
+
     virtual const std::string& getXMLName() const;
     virtual void toInputXMLDerived( std::ostream& out, Tabs* tabs ) const;
     virtual bool XMLDerivedClassParse( const std::string& nodeName, const xercesc::DOMNode* curr );
@@ -174,6 +180,8 @@ protected:
 
     void setCO2CoefsIntoMarketplace( const int aPeriod );
 
+    const IndirectEmissionsCalculator* getIndirectEmissionsCalculator() const;
+
 private:
     void clear();
     bool ensureGDP() const;
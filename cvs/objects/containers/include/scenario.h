@@ -54,6 +54,7 @@
 #include "util/base/include/ivisitable.h"
 #include "util/base/include/iround_trippable.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/hardware_counters.h"
 
 // Forward declarations
 class Modeltime;
@@ -103,7 +104,8 @@ public:
     void toInputXML( std::ostream& out, Tabs* tabs ) const;
 
     const std::string& getName() const;
-    bool run( const int aSinglePeriod, const bool aPrintDebugging, const std::string& aFilenameEnding = "" );
+    bool run( const int aSinglePeriod, const bool aPrintDebugging, const std::string& aFilenameEnding = "",
+              const int aRestartPeriod = 0 );
     void setTax( const GHGPolicy* aTax );
     std::map<std::string, const Curve*> getEmissionsQuantityCurves( const std::string& ghgName ) const;
     std::map<std::string, const Curve*> getEmissionsPriceCurves( const std::string& ghgName ) const;
@@ -114,6 +116,11 @@ public:
     static const std::string& getXMLNameStatic();
     const std::vector<int>& getUnsolvedPeriods() const;
     void invalidatePeriod( const int aPeriod );
+
+    void setInitialPrices( const int aPeriod, const std::vector<double>& aPrices );
+
+    void setSharedCheckpoints( const std::string& aCheckpointName, const int aBranchPeriod );
+
     ManageStateVariables* getManageStateVariables() const;
 
     //! Constant which when passed to the run method means to run all model periods.
@@ -163,13 +170,90 @@ protected:
     
     ManageStateVariables* mManageStateVars;
 
+    //! The performance measured while solving a single period.
+    struct PeriodPerformance {
+        //! The year of the period.
+        int mYear;
+
+        //! Whether the period solved.
+        bool mSolved;
+
+        //! The time taken to solve the period in seconds.
+        double mSeconds;
+
+        //! The number of world calcs made in the period up to the end of solving.
+        int mWorldCalcs;
+
+        //! The time spent calculating Jacobians in seconds.
+        double mJacobianSeconds;
+
+        //! The peak resident memory of the process in MB after solving.
+        double mPeakResidentMemory;
+
+#if GCAM_USE_PERF_COUNTERS
+        //! The hardware counts of the main thread while solving.
+        HardwareCounters::Counts mCounters;
+#endif
+    };
+
+    //! The performance of each period solved in the current run, only recorded
+    //! if the "period-performance" file is to be written.
+    std::vector<PeriodPerformance> mPeriodPerformance;
+
+    //! Prices to start the solver from the next time a period is calculated
+    //! by period.
+    std::map<int, std::vector<double> > mInitialPrices;
+
+    //! The name of the checkpoints shared with other scenarios, empty if the
+    //! checkpoints are named after this scenario.
+    std::string mSharedCheckpointName;
+
+    //! The first period which is not shared with other scenarios through the
+    //! shared checkpoints.
+    int mBranchPeriod;
+
+    //! Whether the next period is started speculatively in a forked copy of
+    //! the process while each period is solved.
+    bool mPipelinePeriods;
+
+    //! Whether this process is a speculative copy.
+    bool mIsSpeculativeCopy;
+
+    //! The period a speculative copy was started from, or -1 if there is none.
+    int mSpeculationPeriod;
+
+    //! The process id of the speculative copy, only set in the original process.
+    int mSpeculationPid;
+
+    //! The pipe to the speculative copy: the read end in the original process
+    //! and the write end in the copy.
+    int mSpeculationPipe;
+
     bool solve( const int period );
 
+    bool writePeriodPerformance( const std::string& aFileName ) const;
+
     bool calculatePeriod( const int aPeriod,
         std::ostream& aXMLDebugFile,
         std::ostream& aSGMDebugFile,
         Tabs* aTabs,
-        const bool aPrintDebugging );
+        const bool aPrintDebugging,
+        const bool aRestore );
+
+    std::string getPriceGuessFileName( const int aPeriod ) const;
+    std::string getCheckpointFileName( const int aPeriod ) const;
+    bool writeCheckpoint( const int aPeriod, const bool aSolved ) const;
+    bool readCheckpoint( const int aPeriod, bool& aSolved );
+
+    void replaySolvers( const int aPeriod );
+    bool raceSolvers( const int aPeriod );
+
+    void startSpeculation( const int aPeriod );
+    void finishSpeculation( const int aPeriod );
+    void stopSpeculation();
+    void sendSpeculativePrices( const int aPeriod, const bool aSolved );
+
+    void reportMemoryUsage( const std::string& aWhen );
 
     void printGraphs( const int aPeriod ) const;
     void printLandAllocatorGraph( const int aPeriod, const bool aPrintValues ) const;
@@ -112,6 +112,10 @@ public:
 
     XMLDBOutputter* getXMLDBOutputter() const;
 
+    static bool prepareSharedScenario( Timer& aTimer );
+
+    static void releaseSharedScenario();
+
 protected:    
     SingleScenarioRunner();
     static const std::string& getXMLNameStatic();
@@ -122,5 +126,23 @@ protected:
     //! it around in case we want to do additional processing once GCAM
     //! is done running.
     mutable XMLDBOutputter* mXMLDBOutputter;
+
+    //! All of the input files of the scenario in the order they are parsed.
+    std::list<std::string> mInputFiles;
+
+    //! The first period to solve rather than restore from its checkpoint.
+    int mRestartPeriod;
+
+    bool isIncrementalRerun() const;
+
+    std::string getInputManifestFileName() const;
+
+    //! A scenario which has parsed the inputs shared by the batch scenarios
+    //! and will be used by the next call to setupScenarios.
+    static std::auto_ptr<Scenario> sSharedScenario;
+
+    static bool parseInputFiles( Scenario* aScenario,
+                                 const std::list<std::string>& aInputFiles,
+                                 const bool aUseSnapshot );
 };
 #endif // _SINGLE_SCENARIO_RUNNER_H_
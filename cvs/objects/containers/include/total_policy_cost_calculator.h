@@ -48,6 +48,7 @@
 #include <map>
 #include <memory>
 #include <vector>
+#include <string>
 
 class SingleScenarioRunner;
 class Curve;
@@ -59,6 +60,20 @@ class Curve;
 * \details This class runs a scenario multiple times while varying a fixed
 *          carbon price, to determine the MAC curve and total cost for the
 *          scenario.
+*
+*          The trials are independent of one another and may be distributed
+*          over several model processes. If the configuration value
+*          "cost-curve-workers" is greater than one each process runs the
+*          trials for which the trial number modulo the number of workers is
+*          its "cost-curve-worker" index and writes the emissions curves of
+*          each into the "cost-curve-points" directory. The first worker waits
+*          for the trials of the others to appear there and then assembles the
+*          cost curves.
+*
+*          If the boolean configuration value "adaptive-cost-curve" is set the
+*          trials are instead placed one at a time where the estimated error of
+*          integrating the cost curves is largest, using at most
+*          "numPointsForCO2CostCurve" trials.
 * \author Josh Lurz
 */
 class TotalPolicyCostCalculator {
@@ -83,6 +98,16 @@ private:
     //! The name of the GHG for which to calculate the marginal abatement curve.
     std::string mGHGName;
 
+    //! The number of model processes the trials are distributed over.
+    unsigned int mNumWorkers;
+
+    //! The index of this process among the workers.
+    unsigned int mWorker;
+
+    //! An identifier shared by all workers of the same run which is written
+    //! in the name and header of the trial files.
+    std::string mRunID;
+
     //! The scenario runner which controls running the initial scenario, and all
     //! fixed taxed scenarios after. This is a weak reference.
     SingleScenarioRunner* mSingleScenario;
@@ -108,6 +133,13 @@ private:
     RegionCurves mRegionalCostCurves;
 
     bool runTrials();
+    bool runTrial( const double aFraction, const std::string& aRunName );
+    bool runAdaptiveTrials();
+    double estimateIntegrationErrors( std::vector<double>& aIntervalErrors ) const;
+    std::string getTrialFileName( const unsigned int aPoint ) const;
+    void removeTrialFiles() const;
+    bool writeTrial( const unsigned int aPoint ) const;
+    bool readTrials();
     void createCostCurvesByPeriod();
     void createRegionalCostCurves();
     const std::string createXMLOutputString() const;
@@ -101,19 +101,23 @@ public:
     void calc( const int period );
     void calc( const int period, const std::vector<IActivity*>& aRegionsToCalc );
     void updateSummary( const std::list<std::string> aPrimaryFuelList, const int period ); 
-    void setEmissions( int period );
+    void setEmissions( const int aPeriod );
     void runClimateModel();
     void runClimateModel( int period );
+    void waitForClimateModel() const;
+    void setClimateModelEmulator( IClimateModel* aClimateModelEmulator );
     void csvOutputFile() const; 
     void dbOutput( const std::list<std::string>& aPrimaryFuelList ) const; 
     const std::map<std::string,int> getOutputRegionMap() const;
     bool isAllCalibrated( const int period, double calAccuracy, const bool printWarnings ) const;
     void setTax( const GHGPolicy* aTax );
     const IClimateModel* getClimateModel() const;
+    IClimateModel* getClimateModel();
     std::map<std::string, const Curve*> getEmissionsQuantityCurves( const std::string& ghgName ) const;
     std::map<std::string, const Curve*> getEmissionsPriceCurves( const std::string& ghgName ) const;
     CalcCounter* getCalcCounter() const;
     int getGlobalOrderingSize() const {return mGlobalOrdering.size();}
+    const std::vector<IActivity*>& getGlobalOrdering() const {return mGlobalOrdering;}
     
     const GlobalTechnologyDatabase* getGlobalTechnologyDatabase() const;
 
@@ -166,6 +170,39 @@ protected:
     //! The global ordering of activities which can be used to calculate the model.
     std::vector<IActivity*> mGlobalOrdering;
 
+    //! An emulator of the climate model to run in its place, or null to run
+    //! the climate model.  This object does not own the emulator.
+    IClimateModel* mClimateModelEmulator;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Whether regions are initialized and post-calculated concurrently.
+    bool mParallelRegions;
+
+    struct ClimateModelTask;
+
+    //! The climate model run which may still be in progress, null unless the
+    //! climate model is run concurrently with setting up the next period.
+    ClimateModelTask* mClimateModelTask;
+
+    //! The time accumulated by flow graph calcs run one way or the other.
+    struct CalcDispatchStats {
+        CalcDispatchStats() : mCalls( 0 ), mActivities( 0.0 ), mSeconds( 0.0 ) {}
+        int mCalls;
+        double mActivities;
+        double mSeconds;
+    };
+
+    //! The estimated activity time in seconds below which a partial calc list
+    //! given to the flow graph calc is run inline instead.
+    double mInlineCalcSeconds;
+
+    //! Calcs of partial calc lists which were run inline in global order.
+    CalcDispatchStats mInlineCalcStats;
+
+    //! Calcs which were run by the flow graph.
+    CalcDispatchStats mGraphCalcStats;
+#endif
+
     void clear();
 
     void csvGlobalDataFile() const;
@@ -43,17 +43,35 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "containers/include/batch_runner.h"
 #include "containers/include/scenario_runner_factory.h"
+#include "containers/include/single_scenario_runner.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/xml_helper.h"
 #include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
+#include "util/base/include/gcam_mpi.h"
+#include "util/base/include/input_snapshot.h"
 #include "util/logger/include/ilogger.h"
+#include "util/logger/include/logger_factory.h"
 #include "containers/include/scenario.h"
+#include "util/base/include/model_time.h"
 #include "reporting/include/batch_csv_outputter.h"
 
+#if !defined(_WIN32)
+#include <atomic>
+#include <sys/mman.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace xercesc;
 
@@ -119,7 +137,7 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
     // The scenarios are created by determining all possible combinations of
     // file sets. The algorithm operates as follows:
     // 1) Set the current file set in each component to the initial position.
-    // 2) Run the scenario.
+    // 2) Record the scenario.
     // 3) Set the current component to the first.
     // 4) Increment the current file set in the current component.
     // 5a) If this is a valid position in the current component and go to 2.
@@ -134,9 +152,8 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
     //
     // All generated scenarios are run with each scenario runner in the order in
     // which the scenario runners were read.
+    vector<Component> scenariosToRun;
     bool shouldExit = false;
-    bool success = true;
-    BatchCSVOutputter csvOutputter;
     while( !shouldExit ){
         // The data structure containing the current run.
         Component fileSetsToRun;
@@ -146,17 +163,7 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
             fileSetsToRun.mFileSets.push_back( *( currSet->mFileSetIterator ) );
             fileSetsToRun.mName += currSet->mFileSetIterator->mName;
         }
-
-        // Run it using each possible type of IScenarioRunner.
-        for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner ){
-            bool scenarioSuccess = runSingleScenario( *runner, fileSetsToRun, aSinglePeriod, aTimer );
-            success &= scenarioSuccess;
-            (*runner)->getInternalScenario()->accept( &csvOutputter, -1 );
-            csvOutputter.writeDidScenarioSolve( scenarioSuccess );
-            // Clean up the current scenario runner before we move on to the next
-            // so that we do not accumulate a large amount of idle memory.
-            (*runner)->cleanup();
-        }
+        scenariosToRun.push_back( fileSetsToRun );
 
         // Loop forward to find a position to increment.
         for( ComponentSet::iterator outPos = mComponentSet.begin(); outPos != mComponentSet.end(); ++outPos ){
@@ -175,7 +182,322 @@ bool BatchRunner::runScenarios( const int aSinglePeriod,
             }
         }
     }
+
+    bool success = true;
+    const int numConcurrent = Configuration::getInstance()->getInt( "batch-concurrent-scenarios", 1 );
+    if( GcamMPI::getSize() > 1 ){
+        success = runDistributedScenarios( scenariosToRun, aSinglePeriod, aTimer );
+    }
+    else if( numConcurrent > 1 && scenariosToRun.size() > 1 ){
+        success = runConcurrentScenarios( scenariosToRun, numConcurrent, aSinglePeriod, aTimer );
+    }
+    else {
+        BatchCSVOutputter csvOutputter;
+        for( vector<Component>::const_iterator currRun = scenariosToRun.begin(); currRun != scenariosToRun.end(); ++currRun ){
+            success &= runAllScenarioRunners( *currRun, csvOutputter, aSinglePeriod, aTimer );
+        }
+    }
+
+    // Release the input files the scenarios shared if they were cached.
+    InputSnapshot::clearCache();
+    return success;
+}
+
+/*!
+ * \brief Run a single combination of file sets with each scenario runner.
+ * \param aComponent The combination of file sets to run.
+ * \param aCSVOutputter The batch CSV outputter to write results to.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether all of the model runs solved successfully.
+ */
+bool BatchRunner::runAllScenarioRunners( const Component& aComponent,
+                                         BatchCSVOutputter& aCSVOutputter,
+                                         const int aSinglePeriod,
+                                         Timer& aTimer )
+{
+    bool success = true;
+    for( RunnerIterator runner = mScenarioRunners.begin(); runner != mScenarioRunners.end(); ++runner ){
+        bool scenarioSuccess = runSingleScenario( *runner, aComponent, aSinglePeriod, aTimer );
+        success &= scenarioSuccess;
+        (*runner)->getInternalScenario()->accept( &aCSVOutputter, -1 );
+        aCSVOutputter.writeDidScenarioSolve( scenarioSuccess );
+        // Clean up the current scenario runner before we move on to the next
+        // so that we do not accumulate a large amount of idle memory.
+        (*runner)->cleanup();
+    }
+    return success;
+}
+
+/*!
+ * \brief Run the batch scenarios in several worker processes at once.
+ * \details The model relies on a global Scenario and on several process wide
+ *          singletons so independent scenarios can not share a single process.
+ *          Instead this forks aNumWorkers copies of the batch runner, before any
+ *          scenario has been set up so that no worker threads have been
+ *          started, each of which repeatedly claims the next scenario that has
+ *          not yet been started from a counter held in shared memory.  Workers
+ *          therefore balance themselves however long the individual scenarios
+ *          take.  Each worker writes its batch CSV rows to a separate file for
+ *          each scenario which are merged, in batch order, once all of the
+ *          workers have finished.  Worker N writes its logs and its XML
+ *          database to the configured names with "_workerN" inserted so
+ *          that no files are written by more than one process.  On platforms
+ *          without fork the scenarios are run one after another.
+ *
+ *          If the configuration value "batch-share-parsed-inputs" is set the
+ *          base input file and the configured scenario components are parsed
+ *          once before forking. Each worker then runs every scenario in a
+ *          forked copy of itself which only parses the file sets of that
+ *          scenario, sharing the copy on write pages of the parsed inputs with
+ *          all of the other scenarios.
+ * \param aScenarios The combinations of file sets to run.
+ * \param aNumWorkers The maximum number of scenarios to run at once.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether all of the model runs solved successfully.
+ */
+bool BatchRunner::runConcurrentScenarios( const vector<Component>& aScenarios,
+                                          const int aNumWorkers,
+                                          const int aSinglePeriod,
+                                          Timer& aTimer )
+{
+    BatchCSVOutputter csvOutputter;
+    const int numScenarios = static_cast<int>( aScenarios.size() );
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if defined(_WIN32)
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Concurrent batch scenarios are not supported on this platform, running them one at a time." << endl;
+    bool success = true;
+    for( int i = 0; i < numScenarios; ++i ){
+        success &= runAllScenarioRunners( aScenarios[ i ], csvOutputter, aSinglePeriod, aTimer );
+    }
+    return success;
+#else
+    // The shared region holds the index of the next scenario to claim followed
+    // by the status of each scenario.
+    const size_t sharedSize = sizeof( atomic<int> ) + numScenarios;
+    void* sharedMem = mmap( 0, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0 );
+    if( sharedMem == MAP_FAILED ){
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not allocate shared memory for concurrent batch scenarios, running them one at a time." << endl;
+        bool success = true;
+        for( int i = 0; i < numScenarios; ++i ){
+            success &= runAllScenarioRunners( aScenarios[ i ], csvOutputter, aSinglePeriod, aTimer );
+        }
+        return success;
+    }
+    atomic<int>* nextScenario = new( sharedMem ) atomic<int>( 0 );
+    char* status = static_cast<char*>( sharedMem ) + sizeof( atomic<int> );
+    fill( status, status + numScenarios, SCENARIO_NOT_RUN );
+
+    const string csvFileName = Configuration::getInstance()->getFile( "batchCSVOutputFile", "batch-csv-out.csv" );
+    const int numWorkers = min( aNumWorkers, numScenarios );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running " << numScenarios << " batch scenarios in " << numWorkers << " worker processes." << endl;
+
+    // Parse the inputs which all of the scenarios share once so that the
+    // workers inherit them.
+    const bool shareInputs = Configuration::getInstance()->getBool( "batch-share-parsed-inputs", false, false )
+        && SingleScenarioRunner::prepareSharedScenario( aTimer );
+
+    vector<pid_t> workers;
+    LoggerFactory::prepareForFork();
+    for( int worker = 0; worker < numWorkers; ++worker ){
+        pid_t pid = fork();
+        if( pid == 0 ){
+            // Worker process: write to separate logs and an XML database of its
+            // own then claim scenarios until there are none left.
+            GcamMPI::setBatchWorker( worker );
+            LoggerFactory::reopenLogs();
+            int curr;
+            while( ( curr = nextScenario->fetch_add( 1 ) ) < numScenarios ){
+                status[ curr ] = SCENARIO_RUNNING;
+                // Run each scenario in a copy of the worker so that the shared
+                // inputs, which setting up a scenario takes over, remain for
+                // the next one. The copy shares their pages until it modifies
+                // them.
+                pid_t scenarioPid = -1;
+                if( shareInputs ){
+                    LoggerFactory::prepareForFork();
+                    scenarioPid = fork();
+                    LoggerFactory::resumeAfterFork();
+                    if( scenarioPid > 0 ){
+                        int exitStatus;
+                        waitpid( scenarioPid, &exitStatus, 0 );
+                        continue;
+                    }
+                }
+                bool success;
+                {
+                    BatchCSVOutputter workerCSV( getWorkerCSVFileName( csvFileName, curr ) );
+                    success = runAllScenarioRunners( aScenarios[ curr ], workerCSV, aSinglePeriod, aTimer );
+                }
+                status[ curr ] = success ? SCENARIO_SOLVED : SCENARIO_FAILED;
+                if( scenarioPid == 0 ){
+                    _exit( 0 );
+                }
+            }
+            // Skip the destructors of objects copied from the parent process
+            // such as its batch CSV file.
+            _exit( 0 );
+        }
+        else if( pid < 0 ){
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could only start " << worker << " batch worker processes." << endl;
+            break;
+        }
+        workers.push_back( pid );
+    }
+    LoggerFactory::resumeAfterFork();
+
+    // If no workers could be started run everything in this process.
+    if( workers.empty() ){
+        int curr;
+        while( ( curr = nextScenario->fetch_add( 1 ) ) < numScenarios ){
+            status[ curr ] = runAllScenarioRunners( aScenarios[ curr ], csvOutputter, aSinglePeriod, aTimer )
+                ? SCENARIO_SOLVED : SCENARIO_FAILED;
+        }
+    }
+    for( vector<pid_t>::const_iterator pid = workers.begin(); pid != workers.end(); ++pid ){
+        int exitStatus;
+        waitpid( *pid, &exitStatus, 0 );
+    }
+    SingleScenarioRunner::releaseSharedScenario();
+
+    bool success = true;
+    for( int i = 0; i < numScenarios; ++i ){
+        if( !workers.empty() ){
+            csvOutputter.appendFile( getWorkerCSVFileName( csvFileName, i ) );
+        }
+        if( status[ i ] != SCENARIO_SOLVED ){
+            success = false;
+            // Scenarios run in this process already recorded their failure.
+            if( !workers.empty() ){
+                mUnsolvedNames.push_back( aScenarios[ i ].mName );
+            }
+            if( status[ i ] != SCENARIO_FAILED ){
+                mainLog.setLevel( ILogger::ERROR );
+                mainLog << "Batch worker running scenario " << aScenarios[ i ].mName << " exited before it completed." << endl;
+            }
+        }
+    }
+    nextScenario->~atomic<int>();
+    munmap( sharedMem, sharedSize );
     return success;
+#endif
+}
+
+/*!
+ * \brief Run the batch scenarios on several MPI ranks.
+ * \details Rank zero does not run any scenarios itself but hands the next
+ *          scenario which has not been started to each of the other ranks as
+ *          they become free.  Each worker rank returns whether its scenario
+ *          solved along with its batch CSV results which rank zero writes, in
+ *          batch order, once all of the scenarios are done.  Jacobians are not
+ *          distributed while doing so since the ranks are each running a
+ *          different scenario.
+ * \param aScenarios The combinations of file sets to run.
+ * \param aSinglePeriod The model period to run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether all of the model runs on this rank solved successfully.
+ */
+bool BatchRunner::runDistributedScenarios( const vector<Component>& aScenarios,
+                                           const int aSinglePeriod,
+                                           Timer& aTimer )
+{
+    // Message tags used to hand out work and return results.
+    enum { TAG_RESULT = 1, TAG_CSV, TAG_WORK };
+    const int numScenarios = static_cast<int>( aScenarios.size() );
+    GcamMPI::setDistributeJacobian( false );
+
+    bool success = true;
+    if( GcamMPI::isRoot() ){
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Distributing " << numScenarios << " batch scenarios to "
+                << GcamMPI::getSize() - 1 << " MPI ranks." << endl;
+
+        vector<char> status( numScenarios, SCENARIO_NOT_RUN );
+        vector<string> csvResults( numScenarios );
+        int nextScenario = 0;
+        int numActive = GcamMPI::getSize() - 1;
+        while( numActive > 0 ){
+            // Each message contains the index of the scenario the worker just
+            // finished, or -1 if it has not run one yet, and whether it solved.
+            // Every message is answered with the next scenario to run or -1
+            // if there are none left.
+            vector<int> result;
+            const int worker = GcamMPI::recvInts( GcamMPI::ANY_SOURCE, TAG_RESULT, result );
+            if( result[ 0 ] >= 0 ){
+                status[ result[ 0 ] ] = result[ 1 ] ? SCENARIO_SOLVED : SCENARIO_FAILED;
+                GcamMPI::recvString( worker, TAG_CSV, csvResults[ result[ 0 ] ] );
+            }
+            vector<int> work( 1, nextScenario < numScenarios ? nextScenario++ : -1 );
+            if( work[ 0 ] == -1 ){
+                --numActive;
+            }
+            else {
+                mainLog << "Sending scenario " << aScenarios[ work[ 0 ] ].mName << " to rank " << worker << "." << endl;
+            }
+            GcamMPI::sendInts( worker, TAG_WORK, work );
+        }
+
+        BatchCSVOutputter csvOutputter;
+        for( int i = 0; i < numScenarios; ++i ){
+            istringstream csvRows( csvResults[ i ] );
+            csvOutputter.appendRows( csvRows );
+            if( status[ i ] != SCENARIO_SOLVED ){
+                success = false;
+                mUnsolvedNames.push_back( aScenarios[ i ].mName );
+            }
+        }
+    }
+    else {
+        const string csvFileName = GcamMPI::getRankFileName(
+            Configuration::getInstance()->getFile( "batchCSVOutputFile", "batch-csv-out.csv" ) );
+        vector<int> result( 2, 0 );
+        result[ 0 ] = -1;
+        GcamMPI::sendInts( 0, TAG_RESULT, result );
+        vector<int> work;
+        GcamMPI::recvInts( 0, TAG_WORK, work );
+        while( work[ 0 ] >= 0 ){
+            const string scenarioCSVFileName = getWorkerCSVFileName( csvFileName, work[ 0 ] );
+            bool scenarioSuccess;
+            {
+                BatchCSVOutputter workerCSV( scenarioCSVFileName );
+                scenarioSuccess = runAllScenarioRunners( aScenarios[ work[ 0 ] ], workerCSV, aSinglePeriod, aTimer );
+            }
+            success &= scenarioSuccess;
+
+            ifstream csvFile( scenarioCSVFileName.c_str() );
+            ostringstream csvRows;
+            csvRows << csvFile.rdbuf();
+            csvFile.close();
+            remove( scenarioCSVFileName.c_str() );
+
+            result[ 0 ] = work[ 0 ];
+            result[ 1 ] = scenarioSuccess;
+            GcamMPI::sendInts( 0, TAG_RESULT, result );
+            GcamMPI::sendString( 0, TAG_CSV, csvRows.str() );
+            GcamMPI::recvInts( 0, TAG_WORK, work );
+        }
+    }
+    return success;
+}
+
+/*!
+ * \brief Get the name of the file a batch worker process writes the batch CSV
+ *        results of a single scenario to.
+ * \param aCSVFileName The name of the merged batch CSV file.
+ * \param aScenarioIndex The index of the scenario in the batch.
+ * \return The file name to use for the scenario.
+ */
+string BatchRunner::getWorkerCSVFileName( const string& aCSVFileName, const int aScenarioIndex ){
+    return aCSVFileName + "." + util::toString( aScenarioIndex );
 }
 
 void BatchRunner::printOutput( Timer& aTimer, const bool aCloseDB ) const {
@@ -252,6 +574,28 @@ bool BatchRunner::runSingleScenario( IScenarioRunner* aScenarioRunner,
         return false;
     }
 
+    // Share the periods before the earliest file set which does not affect all
+    // years with the other scenarios which have the same remaining file sets.
+    if( Configuration::getInstance()->shouldWriteFile( "checkpoint-location", false, false ) ) {
+        string trunkName = "trunk-" + aScenarioRunner->getName();
+        int branchYear = 0;
+        for( CFileSetIterator currFileSet = aComponent.mFileSets.begin(); currFileSet != aComponent.mFileSets.end(); ++currFileSet ){
+            if( currFileSet->mFirstYear == 0 ){
+                trunkName += "-" + currFileSet->mName;
+            }
+            else if( branchYear == 0 || currFileSet->mFirstYear < branchYear ){
+                branchYear = currFileSet->mFirstYear;
+            }
+        }
+        if( branchYear != 0 ){
+            Scenario* scenario = mInternalRunner->getInternalScenario();
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Sharing the periods before " << branchYear << " through the checkpoints "
+                    << trunkName << "." << endl;
+            scenario->setSharedCheckpoints( trunkName, scenario->getModeltime()->getyr_to_per( branchYear ) );
+        }
+    }
+
     // Run the scenario.
     success = mInternalRunner->runScenarios( aSinglePeriod, false, aTimer );
     
@@ -418,6 +762,7 @@ bool BatchRunner::XMLParseFileSet( const DOMNode* aNode, Component& aCurrCompone
     // Create the new file set and set the name.
     FileSet newFileSet;
     newFileSet.mName = XMLHelper<string>::getAttr( aNode, XMLHelper<void>::name() );
+    newFileSet.mFirstYear = XMLHelper<int>::getAttr( aNode, "first-year" );
 
     // get the children of the node.
     DOMNodeList* nodeList = aNode->getChildNodes();
@@ -213,6 +213,12 @@ const string& Info::getStringHelper( const string& aStringKey, bool& aFound ) co
 }
 
 bool Info::hasValue( const string& aStringKey ) const {
+    // Registered properties are kept in their typed slot.
+    const int key = InfoKeys::findKey( aStringKey );
+    if( key != InfoKeys::NOT_FOUND ){
+        return hasValue( static_cast<InfoKeys::Key>( key ) );
+    }
+
 #if GCAM_PARALLEL_ENABLED
     // get a read lock on the info map
     tbb::queuing_rw_mutex::scoped_lock readlock(mInfoMapMutex,false);
@@ -232,6 +238,165 @@ bool Info::hasValue( const string& aStringKey ) const {
     return currHasValue;
 }
 
+bool Info::setBoolean( const InfoKeys::Key aKey, const bool aValue ){
+    return setSlotValue( aKey, eBoolean, aValue );
+}
+
+bool Info::setInteger( const InfoKeys::Key aKey, const int aValue ){
+    return setSlotValue( aKey, eInteger, aValue );
+}
+
+bool Info::setDouble( const InfoKeys::Key aKey, const double aValue ){
+    return setSlotValue( aKey, eDouble, aValue );
+}
+
+bool Info::setString( const InfoKeys::Key aKey, const string& aValue ){
+    return setSlotValue( aKey, eString, aValue );
+}
+
+bool Info::getBoolean( const InfoKeys::Key aKey, const bool aMustExist ) const
+{
+    // Perform a local search.
+    bool found = false;
+    bool value = getSlotValue<bool>( aKey, found );
+
+    // If the item wasn't found search the parent info.
+    if( !found ){
+        if( mParentInfo ){
+            value = mParentInfo->getBooleanHelper( aKey, found );
+        }
+        // The item must exist and was not found or there was no parent to search.
+        if( aMustExist && !found ){
+            printItemNotFoundWarning( InfoKeys::getName( aKey ) );
+        }
+    }
+    return value;
+}
+
+int Info::getInteger( const InfoKeys::Key aKey, const bool aMustExist ) const
+{
+    // Perform a local search.
+    bool found = false;
+    int value = getSlotValue<int>( aKey, found );
+
+    // If the item wasn't found search the parent info.
+    if( !found ){
+        if( mParentInfo ){
+            value = mParentInfo->getIntegerHelper( aKey, found );
+        }
+        // The item must exist and was not found or there was no parent to search.
+        if( aMustExist && !found ){
+            printItemNotFoundWarning( InfoKeys::getName( aKey ) );
+        }
+    }
+    return value;
+}
+
+double Info::getDouble( const InfoKeys::Key aKey, const bool aMustExist ) const
+{
+    // Perform a local search.
+    bool found = false;
+    double value = getSlotValue<double>( aKey, found );
+
+    // If the item wasn't found search the parent info.
+    if( !found ){
+        if( mParentInfo ){
+            value = mParentInfo->getDoubleHelper( aKey, found );
+        }
+        // The item must exist and was not found or there was no parent to search.
+        if( aMustExist && !found ){
+            printItemNotFoundWarning( InfoKeys::getName( aKey ) );
+        }
+    }
+    return value;
+}
+
+const string& Info::getString( const InfoKeys::Key aKey, const bool aMustExist ) const
+{
+    // Perform a local search.
+    bool found = false;
+    const string& value = getSlotValue<string>( aKey, found );
+    if( !found ){
+        // If the item wasn't found search the parent info.
+        if( mParentInfo ){
+            return mParentInfo->getStringHelper( aKey, found );
+        }
+        // The item must exist and was not found or there was no parent to search.
+        if( aMustExist && !found ){
+            printItemNotFoundWarning( InfoKeys::getName( aKey ) );
+        }
+    }
+    return value;
+}
+
+bool Info::getBooleanHelper( const InfoKeys::Key aKey, bool& aFound ) const
+{
+    // Perform a local search.
+    bool value = getSlotValue<bool>( aKey, aFound );
+
+    // If the item wasn't found and parent exists, search the parent info.
+    if( !aFound && mParentInfo ){
+        value = mParentInfo->getBooleanHelper( aKey, aFound );
+    }
+    return value;
+}
+
+int Info::getIntegerHelper( const InfoKeys::Key aKey, bool& aFound ) const
+{
+    // Perform a local search.
+    int value = getSlotValue<int>( aKey, aFound );
+
+    // If the item wasn't found and parent exists, search the parent info.
+    if( !aFound && mParentInfo ){
+        value = mParentInfo->getIntegerHelper( aKey, aFound );
+    }
+    return value;
+}
+
+double Info::getDoubleHelper( const InfoKeys::Key aKey, bool& aFound ) const
+{
+    // Perform a local search.
+    double value = getSlotValue<double>( aKey, aFound );
+
+    // If the item wasn't found and parent exists, search the parent info.
+    if( !aFound && mParentInfo ){
+        value = mParentInfo->getDoubleHelper( aKey, aFound );
+    }
+    return value;
+}
+
+const string& Info::getStringHelper( const InfoKeys::Key aKey, bool& aFound ) const
+{
+    // Perform a local search.
+    const string& value = getSlotValue<string>( aKey, aFound );
+
+    // If the item wasn't found and parent exists, search the parent info.
+    if( !aFound && mParentInfo ){
+        return mParentInfo->getStringHelper( aKey, aFound );
+    }
+    return value;
+}
+
+bool Info::hasValue( const InfoKeys::Key aKey ) const {
+#if GCAM_PARALLEL_ENABLED
+    // get a read lock on the slots
+    tbb::queuing_rw_mutex::scoped_lock readlock(mInfoMapMutex,false);
+#endif
+    // Check the local store.
+    bool currHasValue = !mSlots.empty() && mSlots[ aKey ].mIsSet;
+
+#if GCAM_PARALLEL_ENABLED
+    // the lock on our local slots is no longer needed.  Release before
+    // recursing into parent structures
+    readlock.release();
+#endif
+    // If the value was not found, check the parent.
+    if( !currHasValue && mParentInfo ){
+        currHasValue = mParentInfo->hasValue( aKey );
+    }
+    return currHasValue;
+}
+
 void Info::toDebugXML( const int aperiod, Tabs* aTabs, ostream& aOut ) const {
 #if GCAM_PARALLEL_ENABLED
     // get read lock for the info map
@@ -258,9 +423,53 @@ void Info::toDebugXML( const int aperiod, Tabs* aTabs, ostream& aOut ) const {
         }
         XMLWriteClosingTag( "Pair", aOut, aTabs );
     }
+    writeSlotsToDebugXML( aTabs, aOut );
     XMLWriteClosingTag( "Info", aOut, aTabs );
 }
 
+/*! \brief Write the registered properties which have been set as XML.
+* \details The properties are written in the same format as the properties
+*          stored in the hashmap.  The caller must hold the lock on the info.
+* \param aTabs Tabs manager.
+* \param aOut Output stream.
+*/
+void Info::writeSlotsToDebugXML( Tabs* aTabs, ostream& aOut ) const {
+    for( size_t key = 0; key < mSlots.size(); ++key ){
+        const TypedSlot& slot = mSlots[ key ];
+        if( !slot.mIsSet ){
+            continue;
+        }
+        XMLWriteOpeningTag( "Pair", aOut, aTabs );
+        XMLWriteElement( InfoKeys::getName( static_cast<InfoKeys::Key>( key ) ), "Key", aOut, aTabs );
+        switch( slot.mType ){
+            case eBoolean:
+                XMLWriteElement( slot.mBoolean, "Value", aOut, aTabs );
+                break;
+            case eInteger:
+                XMLWriteElement( slot.mInteger, "Value", aOut, aTabs );
+                break;
+            case eDouble:
+                XMLWriteElement( slot.mDouble, "Value", aOut, aTabs );
+                break;
+            case eString:
+                XMLWriteElement( slot.mString, "Value", aOut, aTabs );
+                break;
+            // No default so the compiler can flag omissions.
+        }
+        XMLWriteClosingTag( "Pair", aOut, aTabs );
+    }
+}
+
+//! Constructor
+Info::TypedSlot::TypedSlot():
+mIsSet( false ),
+mType( eDouble ),
+mBoolean( false ),
+mInteger( 0 ),
+mDouble( 0 )
+{
+}
+
 /*! \brief Return the initial size for the underlying hashmap.
 * \details Returns how many slots to allocate initially for the hashmap. The
 *          hashmap will increase in size if it gets too full, but the resize
@@ -0,0 +1,111 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file info_keys.cpp
+* \ingroup Objects
+* \brief InfoKeys class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <vector>
+#include <memory>
+#include "containers/include/info_keys.h"
+#include "util/base/include/hash_map.h"
+
+using namespace std;
+
+namespace {
+    //! The names of the registered properties in the order of InfoKeys::Key.
+    const char* const KEY_NAMES[] = {
+        "lower-bound-supply-price",
+        "upper-bound-supply-price",
+        "CO2coefficient",
+        "is-tech-operating",
+        "tech-capacity-factor",
+        "isShareBased",
+        "pricePaid",
+        "priceReceived",
+        "IsFixedPrice",
+        "ConversionFactor",
+        "price-unit",
+        "output-unit"
+    };
+
+    static_assert( sizeof( KEY_NAMES ) / sizeof( KEY_NAMES[ 0 ] ) == InfoKeys::eNumKeys,
+                   "A name must be given for each InfoKeys::Key." );
+
+    //! Type of the map from the property names to their identifiers.
+    typedef HashMap<string, int> KeyMap;
+
+    /*!
+     * \brief Create the map from the property names to their identifiers.
+     * \return The new map.
+     */
+    KeyMap* createKeyMap() {
+        // Prime number comfortably larger than the number of keys.
+        const unsigned int KEY_MAP_SIZE = 29;
+        KeyMap* keyMap = new KeyMap( KEY_MAP_SIZE );
+        for( int i = 0; i < InfoKeys::eNumKeys; ++i ) {
+            keyMap->insert( make_pair( string( KEY_NAMES[ i ] ), i ) );
+        }
+        return keyMap;
+    }
+}
+
+/*!
+* \brief Get the string name of a registered property.
+* \param aKey The identifier of the property.
+* \return The name of the property.
+*/
+const string& InfoKeys::getName( const Key aKey ) {
+    /*! \pre The key is a registered property. */
+    assert( aKey >= 0 && aKey < eNumKeys );
+
+    static const vector<string> names( KEY_NAMES, KEY_NAMES + eNumKeys );
+    return names[ aKey ];
+}
+
+/*!
+* \brief Find the identifier of a property by its string name.
+* \details The map is created on the first call and never changes after that,
+*          so this may be called concurrently.
+* \param aName The name of the property.
+* \return The identifier of the property or NOT_FOUND if it is not registered.
+*/
+int InfoKeys::findKey( const string& aName ) {
+    static const auto_ptr<KeyMap> keyMap( createKeyMap() );
+    KeyMap::const_iterator iter = keyMap->find( aName );
+    return iter != keyMap->end() ? iter->second : NOT_FOUND;
+}
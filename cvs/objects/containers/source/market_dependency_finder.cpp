@@ -40,7 +40,12 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <algorithm>
+#include <map>
+#include <fstream>
+#include <sstream>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/functional/hash/hash.hpp>
 #include "containers/include/market_dependency_finder.h"
 #include "util/logger/include/ilogger.h"
 #include "marketplace/include/marketplace.h"
@@ -49,6 +54,8 @@
 #include "marketplace/include/market.h"
 #include "marketplace/include/linked_market.h"
 #include "containers/include/iactivity.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/auto_file.h"
 
 #if GCAM_PARALLEL_ENABLED
 #include "parallel/include/gcam_parallel.hpp"
@@ -61,9 +68,10 @@ using namespace std;
  * \param aMarketplace The marketplace object in which this object is contained.
  */
 MarketDependencyFinder::MarketDependencyFinder( Marketplace* aMarketplace ):
-mMarketplace( aMarketplace ), mCalcVertexUIDCount( 0 )
+mMarketplace( aMarketplace ), mCalcVertexUIDCount( 0 ), mDependencyHash( 0 ), mGrainKey( 0 )
 #if GCAM_PARALLEL_ENABLED
-,mTBBGraphGlobal( 0 )
+,mTBBGraphGlobal( 0 ),
+mGCAMFlowGraph( 0 )
 #endif
 {
 }
@@ -79,8 +87,9 @@ MarketDependencyFinder::~MarketDependencyFinder() {
     }
 #if GCAM_PARALLEL_ENABLED
     delete mTBBGraphGlobal;
-    for( CMarketToDepIterator it = mMarketsToDep.begin(); it != mMarketsToDep.end(); ++it ) {
-        delete (*it)->mFlowGraph;
+    delete mGCAMFlowGraph;
+    for( vector<IActivity*>::const_iterator it = mAggregationActivities.begin(); it != mAggregationActivities.end(); ++it ) {
+        delete *it;
     }
 #endif
 }
@@ -194,137 +203,110 @@ void MarketDependencyFinder::resolveActivityToDependency( const string& aRegionN
  * \details If called with a market number of -1 (the default value) then the complete
  *          ordering which will calculate all objects in the model is returned.
  *          When a valid market number is given the in-order list of activities which
- *          would be affected by that market changing it's price would be generated
- *          and returned.
+ *          would be affected by that market changing it's price, as found by
+ *          createOrdering, is returned.
  * \param aMarketNumber The market number to get an ordered list of items which
  *                      are required to be calculated if that market changes prices,
  *                      or if -1 the full global list.
  * \return The appropriate list of activities to calculate for the given market.
- *         Note the caller is not responsible for the returned memory.
+ *         Note the caller is not responsible for the returned memory which is
+ *         kept for the lifetime of this object.
  */
-const vector<IActivity*> MarketDependencyFinder::getOrdering( const int aMarketNumber ) const {
+const vector<IActivity*>& MarketDependencyFinder::getOrdering( const int aMarketNumber ) const {
     if( aMarketNumber == -1 ) {
         // Just return the global ordering which has already been generated.
         return mGlobalOrdering;
     }
-    else {
-        // Find the entry points into the graph for the given market.
-        auto_ptr<MarketToDependencyItem> marketToDep( new MarketToDependencyItem( aMarketNumber ) );
-        CMarketToDepIterator mrktIter = mMarketsToDep.find( marketToDep.get() );
-        if( mrktIter == mMarketsToDep.end() ) {
-            // Somehow this market was not linked to any entry points into the graph.
-            ILogger& mainLog = ILogger::getLogger( "main_log" );
-            mainLog.setLevel( ILogger::ERROR );
-            mainLog << "Could not find market: " << mMarketplace->mMarkets[ aMarketNumber ]->getName()
-                    << " to get an ordering for." << endl;
-            exit( 1 );
-        }
-
-        // First check the MarketToDependencyItem and see if we have this cached.
-        if( !(*mrktIter)->mCalcList.empty() ) {
-            return (*mrktIter)->mCalcList;
-        }
-
-        // We must generate the full list of nodes to calculate.  The createOrdering
-        // method has created a link from markets to "entry points" into the graph.
-        // We must then do a search on the graph from those entry points to come up
-        // with a full set of items which must be recalculated.
-        // To ensure the set of items are in order we can utilize the already created
-        // global ordering.
-        
-        
-        // Do a search from all of the entry points to get a set of unique items
-        // to calculate.
-        set<IActivity*> dependenentCalcs;
-        typedef set<CalcVertex*>::const_iterator CVertexIterator;
-        for( CVertexIterator it = (*mrktIter)->mImpliedVertices.begin(); it != (*mrktIter)->mImpliedVertices.end(); ++it ) {
-            findVerticesToCalculate( *it, dependenentCalcs );
-        }
-        
-        // Loop over the global ordering and move an item from the dependenentCalcs
-        // into the ordered list to return should it exist in dependenentCalcs.
-        vector<IActivity*> orderedListForMarket;
-        for( vector<IActivity*>::const_iterator it = mGlobalOrdering.begin(); it != mGlobalOrdering.end(); ++it ) {
-            set<IActivity*>::iterator dependIter = dependenentCalcs.find( *it );
-            if( dependIter != dependenentCalcs.end() ) {
-                orderedListForMarket.push_back( *dependIter );
-                dependenentCalcs.erase( dependIter );
-            }
-        }
-        // Go ahead and cache this list so we do not need to calculate it again.
-        (*mrktIter)->mCalcList = orderedListForMarket;
-        return orderedListForMarket;
+    // The orderings were all created by createOrdering.
+    const int orderingIndex = aMarketNumber < static_cast<int>( mMarketOrderingIndex.size() ) ?
+        mMarketOrderingIndex[ aMarketNumber ] : -1;
+    if( orderingIndex == -1 ) {
+        // Somehow this market was not linked to any entry points into the graph.
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not find market: " << mMarketplace->mMarkets[ aMarketNumber ]->getName()
+                << " to get an ordering for." << endl;
+        exit( 1 );
     }
+    return mMarketOrderings[ orderingIndex ];
 }
 
 #if GCAM_PARALLEL_ENABLED
 /*!
- * \brief Get flow graph which can be used to calculate the model in parallel.
- * \details If called with a market number of -1 (the default value) then the global
- *          graph which will calculate all objects in the model is returned.
- *          When a valid market number is given the flow graph of activities which
- *          would be affected by that market changing it's price would be generated
- *          and returned.
- * \param aMarketNumber The market number to get a flow graph of items which
- *                      are required to be calculated if that market changes prices,
- *                      or if -1 the full global list.
- * \return The appropriate list of activities to calculate for the given market.
- *         Note the caller is not responsible for the returned memory.
+ * \brief Get the global flow graph which can be used to calculate the full model
+ *        in parallel.
+ * \details The graph is generated the first time it is requested and is owned by
+ *          this class.
+ * \return The global flow graph.
  */
-GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
-    if( aMarketNumber == -1 ) {
-        if( !mTBBGraphGlobal ) {
-            // reads parameters from the global configuration
-            GcamParallel config;
-            GcamParallel::FlowGraph gcamFlowGraph;
-            GcamParallel::FlowGraph grainGraph;
-
-            // convert dependency table to flow graph 
-            config.makeGCAMFlowGraph( *this, gcamFlowGraph );
-            // parse flow graph
-            config.graphParseGrainCollect( gcamFlowGraph, grainGraph ); 
-            if( !gcamFlowGraph.topology_valid() ) {
-                ILogger& mainLog = ILogger::getLogger( "main_log" );
-                mainLog.setLevel( ILogger::ERROR );
-                mainLog << "Topological indices not computed." << endl;
-                abort();
+GcamFlowGraph* MarketDependencyFinder::getFlowGraph() {
+    if( !mTBBGraphGlobal ) {
+        // reads parameters from the global configuration
+        GcamParallel config;
+        const GcamParallel::FlowGraph& gcamFlowGraph = getGCAMFlowGraph();
+        GcamParallel::FlowGraph grainGraph;
+
+        // Reuse the grains from the dependency cache if they were found for
+        // this same graph and grain parameters, otherwise parse the flow graph
+        // and record the grains so that they may be cached.
+        map<int, IActivity*> uidToActivity;
+        map<IActivity*, int> activityToUID;
+        for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
+            for( int priceOrDemand = 0; priceOrDemand <= 1; ++priceOrDemand ) {
+                const VertexList& vertices = priceOrDemand ? (*it)->mPriceVertices : (*it)->mDemandVertices;
+                for( CVertexIterator vIter = vertices.begin(); vIter != vertices.end(); ++vIter ) {
+                    uidToActivity[ (*vIter)->mUID ] = (*vIter)->mCalcItem;
+                    activityToUID[ (*vIter)->mCalcItem ] = (*vIter)->mUID;
+                }
             }
-            // build the tbb graph structure
-            mTBBGraphGlobal = new GcamFlowGraph();
-            config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *mTBBGraphGlobal ); 
         }
-        return mTBBGraphGlobal;
-    }
-    else {
-        // Find the entry points into the graph for the given market.
-        auto_ptr<MarketToDependencyItem> marketToDep( new MarketToDependencyItem( aMarketNumber ) );
-        CMarketToDepIterator mrktIter = mMarketsToDep.find( marketToDep.get() );
-        if( mrktIter == mMarketsToDep.end() ) {
-            // Somehow this market was not linked to any entry points into the graph.
-            ILogger& mainLog = ILogger::getLogger( "main_log" );
-            mainLog.setLevel( ILogger::ERROR );
-            mainLog << "Could not find market: " << mMarketplace->mMarkets[ aMarketNumber ]->getName()
-                    << " to get an ordering for." << endl;
-            exit( 1 );
+        for( size_t i = 0; i < mAggregationActivities.size(); ++i ) {
+            const int uid = -( static_cast<int>( i ) + 1 );
+            uidToActivity[ uid ] = mAggregationActivities[ i ];
+            activityToUID[ mAggregationActivities[ i ] ] = uid;
         }
-
-        // First check the MarketToDependencyItem and see if we have this cached.
-        if( (*mrktIter)->mFlowGraph ) {
-            return (*mrktIter)->mFlowGraph;
+        const size_t grainKey = config.getGrainKey();
+        vector<vector<IActivity*> > grains;
+        if( grainKey == mGrainKey && !mGrains.empty() ) {
+            // make sure the cached grains exactly cover the graph
+            set<IActivity*> covered;
+            bool isValid = true;
+            grains.resize( mGrains.size() );
+            for( size_t i = 0; i < mGrains.size() && isValid; ++i ) {
+                for( size_t j = 0; j < mGrains[ i ].size() && isValid; ++j ) {
+                    map<int, IActivity*>::const_iterator actIter = uidToActivity.find( mGrains[ i ][ j ] );
+                    isValid = actIter != uidToActivity.end() &&
+                        gcamFlowGraph.nodelist().find( actIter->second ) != gcamFlowGraph.nodelist().end() &&
+                        covered.insert( actIter->second ).second;
+                    if( isValid ) {
+                        grains[ i ].push_back( actIter->second );
+                    }
+                }
+            }
+            if( !isValid || covered.size() != gcamFlowGraph.nodelist().size() ) {
+                ILogger& depLog = ILogger::getLogger( "dependency_finder_log" );
+                depLog.setLevel( ILogger::WARNING );
+                depLog << "Cached grains do not match the flow graph, they will be recalculated." << endl;
+                grains.clear();
+            }
+        }
+        if( !grains.empty() ) {
+            config.collectGrains( gcamFlowGraph, grains, grainGraph );
+        }
+        else {
+            // parse flow graph
+            config.graphParseGrainCollect( gcamFlowGraph, grainGraph ); 
+            GcamParallel::getGrains( grainGraph, grains );
+            mGrainKey = grainKey;
+            mGrains.clear();
+            mGrains.resize( grains.size() );
+            for( size_t i = 0; i < grains.size(); ++i ) {
+                for( size_t j = 0; j < grains[ i ].size(); ++j ) {
+                    mGrains[ i ].push_back( activityToUID[ grains[ i ][ j ] ] );
+                }
+            }
+            writeCache();
         }
-
-        // We must generate the flow graph following the same procedure as the global graph.
-        // It may be a good idea to make some of these tempararies members to avoid recalculating
-        // them over and over.
-        GcamParallel config;
-        GcamParallel::FlowGraph gcamFlowGraph;
-        GcamParallel::FlowGraph grainGraph;
-        
-        // convert dependency table to flow graph
-        config.makeGCAMFlowGraph( *this, gcamFlowGraph );
-        // Parse flow graph subsetting for only the activities effected.  Use getOrdering
-        // to get this list incase it has not yet been calculated.
-        config.graphParseGrainCollect( gcamFlowGraph, grainGraph, getOrdering( aMarketNumber ) );
         if( !gcamFlowGraph.topology_valid() ) {
             ILogger& mainLog = ILogger::getLogger( "main_log" );
             mainLog.setLevel( ILogger::ERROR );
@@ -332,10 +314,45 @@ GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
             abort();
         }
         // build the tbb graph structure
-        (*mrktIter)->mFlowGraph = new GcamFlowGraph();
-        config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *(*mrktIter)->mFlowGraph );
-        return (*mrktIter)->mFlowGraph;
+        mTBBGraphGlobal = new GcamFlowGraph();
+        config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *mTBBGraphGlobal ); 
     }
+    return mTBBGraphGlobal;
+}
+
+/*!
+ * \brief Create a new flow graph which can be used to calculate the full model
+ *        using the given grain size.
+ * \details Unlike the global flow graph the graph is neither cached nor are its
+ *          grains written to the dependency cache, this allows for instance
+ *          ParallelBenchmark to compare grain sizes.  Note the TBB graph is
+ *          bound to the task arena it is created in.
+ * \param aGrainSize The target grain size to partition the activities with.
+ * \return The new flow graph.
+ */
+boost::shared_ptr<GcamFlowGraph> MarketDependencyFinder::createFlowGraph( const int aGrainSize ) {
+    GcamParallel config( aGrainSize );
+    const GcamParallel::FlowGraph& gcamFlowGraph = getGCAMFlowGraph();
+    GcamParallel::FlowGraph grainGraph;
+    config.graphParseGrainCollect( gcamFlowGraph, grainGraph );
+    boost::shared_ptr<GcamFlowGraph> flowGraph( new GcamFlowGraph() );
+    config.makeTBBFlowGraph( grainGraph, gcamFlowGraph, *flowGraph );
+    return flowGraph;
+}
+
+/*!
+ * \brief Get the flow graph of all activities in the model, generating it the
+ *        first time it is needed.
+ * \return The flow graph of all activities.
+ */
+const GcamParallel::FlowGraph& MarketDependencyFinder::getGCAMFlowGraph() {
+    if( !mGCAMFlowGraph ) {
+        GcamParallel config;
+        mGCAMFlowGraph = new GcamParallel::FlowGraph();
+        // convert dependency table to flow graph 
+        config.makeGCAMFlowGraph( *this, *mGCAMFlowGraph, mAggregationActivities );
+    }
+    return *mGCAMFlowGraph;
 }
 #endif
 
@@ -344,28 +361,91 @@ GcamFlowGraph* MarketDependencyFinder::getFlowGraph( const int aMarketNumber ) {
  * \details Recursively search for vertices.  The end points for recursion are if
  *          at vertices which have already been found or that have no out edges.
  * \param aVertex The current vertex being visited.
- * \param aVisited The set of vertices which have already been visited.
+ * \param aVisited Flags by position in the global ordering of the activities
+ *                 which have already been visited.
+ * \param aFound The positions in the global ordering of the activities visited.
  */
-void MarketDependencyFinder::findVerticesToCalculate( CalcVertex* aVertex, std::set<IActivity*>& aVisited ) const {
+void MarketDependencyFinder::findVerticesToCalculate( CalcVertex* aVertex, std::vector<bool>& aVisited,
+                                                      std::vector<int>& aFound ) const
+{
+    /*! \pre The global ordering has been created. */
+    assert( aVertex->mOrderIndex >= 0 );
+
     // Attempt to add the current vertex to the list of visited vertices.
-    if( !aVisited.insert( aVertex->mCalcItem ).second ) {
+    if( aVisited[ aVertex->mOrderIndex ] ) {
         // Already processed this subgraph so no need to continue search from
         // here.
         return;
     }
+    aVisited[ aVertex->mOrderIndex ] = true;
+    aFound.push_back( aVertex->mOrderIndex );
     
     // Visit all vertices along the out edges from aVertex.
     typedef vector<CalcVertex*>::const_iterator CVertexIterator;
     for( CVertexIterator it = aVertex->mOutEdges.begin(); it != aVertex->mOutEdges.end(); ++it ) {
-        findVerticesToCalculate( *it, aVisited );
+        findVerticesToCalculate( *it, aVisited, aFound );
     }
 
     // Add any implied in edges that should be calculated (special case for the
     // land-allocator).
     typedef set<CalcVertex*>::const_iterator CImpVertexIterator;
     for( CImpVertexIterator it = aVertex->mImpliedInEdges.begin(); it != aVertex->mImpliedInEdges.end(); ++it ) {
-        findVerticesToCalculate( *it, aVisited );
+        findVerticesToCalculate( *it, aVisited, aFound );
+    }
+}
+
+/*!
+ * \brief Find the in-order list of activities to calculate for each market.
+ * \details For each market the graph is searched from its entry points for the
+ *          activities to recalculate should its price change, which are put in
+ *          the order of the global ordering.  Many markets, such as those
+ *          which are only used by a single activity, affect exactly the same
+ *          activities so only the distinct lists are kept and shared between
+ *          markets.  Doing this for all markets up front means getOrdering
+ *          does not need to search or allocate and is safe to call
+ *          concurrently.
+ */
+void MarketDependencyFinder::createMarketOrderings() {
+    mMarketOrderings.clear();
+    mMarketOrderingIndex.clear();
+    int maxMarket = -1;
+    for( CMarketToDepIterator mrktIter = mMarketsToDep.begin(); mrktIter != mMarketsToDep.end(); ++mrktIter ) {
+        maxMarket = max( maxMarket, (*mrktIter)->mMarket );
+    }
+    mMarketOrderingIndex.resize( maxMarket + 1, -1 );
+
+    map<vector<int>, int> distinctOrderings;
+    vector<bool> visited( mGlobalOrdering.size(), false );
+    vector<int> found;
+    typedef set<CalcVertex*>::const_iterator CImpVertexIterator;
+    for( CMarketToDepIterator mrktIter = mMarketsToDep.begin(); mrktIter != mMarketsToDep.end(); ++mrktIter ) {
+        found.clear();
+        for( CImpVertexIterator it = (*mrktIter)->mImpliedVertices.begin(); it != (*mrktIter)->mImpliedVertices.end(); ++it ) {
+            findVerticesToCalculate( *it, visited, found );
+        }
+        // Only reset the flags which were set rather than all of them.
+        for( vector<int>::const_iterator it = found.begin(); it != found.end(); ++it ) {
+            visited[ *it ] = false;
+        }
+        sort( found.begin(), found.end() );
+
+        pair<map<vector<int>, int>::iterator, bool> inserted =
+            distinctOrderings.insert( make_pair( found, static_cast<int>( mMarketOrderings.size() ) ) );
+        if( inserted.second ) {
+            mMarketOrderings.push_back( vector<IActivity*>() );
+            vector<IActivity*>& orderedListForMarket = mMarketOrderings.back();
+            orderedListForMarket.reserve( found.size() );
+            for( vector<int>::const_iterator it = found.begin(); it != found.end(); ++it ) {
+                orderedListForMarket.push_back( mGlobalOrdering[ *it ] );
+            }
+        }
+        mMarketOrderingIndex[ (*mrktIter)->mMarket ] = inserted.first->second;
     }
+
+    ILogger& depLog = ILogger::getLogger( "dependency_finder_log" );
+    depLog.setLevel( ILogger::NOTICE );
+    depLog << "Created " << mMarketOrderings.size() << " distinct orderings for "
+           << mMarketsToDep.size() << " markets." << endl;
 }
 
 /*!
@@ -441,6 +521,12 @@ void MarketDependencyFinder::createOrdering() {
             }
         }
     }
+
+    // The dependency information is now complete so we can check if we have
+    // already broken the cycles for this graph in an earlier run.
+    mDependencyHash = calcDependencyHash();
+    vector<pair<string, string> > cachedTrials;
+    readCache( cachedTrials );
     
     // Initialize vertices in the graph.
     CalcVertexCountMap numDependencies;
@@ -572,7 +658,46 @@ void MarketDependencyFinder::createOrdering() {
             createTrialsForItem( it, numDependencies );
         }
     }
+
+    // Recreate the trial markets which were chosen to break cycles the last
+    // time this graph was seen.  This is the same set of markets the search
+    // below would find, and leaves it nothing to do.  Should the cache be stale
+    // in some way we could not detect the search will still break any cycles
+    // that remain.
+    for( auto trial : cachedTrials ) {
+        DependencyItem key( trial.second, trial.first );
+        CItemIterator it = mDependencyItems.find( &key );
+        if( it != mDependencyItems.end() && !(*it)->mIsSolved && (*it)->mCanBreakCycle &&
+            !(*it)->mPriceVertices.empty() && !(*it)->mDemandVertices.empty() )
+        {
+            depLog.setLevel( ILogger::NOTICE );
+            depLog << "Creating trial markets for " << (*it)->mName << " in " << (*it)->mLocatedInRegion
+                   << " from the dependency cache." << endl;
+            createTrialsForItem( it, numDependencies );
+            mCycleTrials.push_back( trial );
+        }
+    }
     
+    // Break the cycles up front with as few trial markets as we can find rather
+    // than one at a time as the topological sort runs into them.  Anything this
+    // misses is still handled by the search below.
+    if( Configuration::getInstance()->getBool( "minimize-cycle-trials", false, false ) ) {
+        size_t greedyCount = 0;
+        const vector<CItemIterator> trials = chooseCycleTrials( numDependencies, greedyCount );
+        if( !trials.empty() ) {
+            depLog.setLevel( ILogger::NOTICE );
+            depLog << "Breaking cycles with " << trials.size() << " trial markets, the greedy choice used "
+                   << greedyCount << "." << endl;
+        }
+        for( auto it : trials ) {
+            depLog.setLevel( ILogger::WARNING );
+            depLog << "Creating trial markets for " << (*it)->mName << " in " << (*it)->mLocatedInRegion
+                   << " to break cycles." << endl;
+            createTrialsForItem( it, numDependencies );
+            mCycleTrials.push_back( make_pair( (*it)->mLocatedInRegion, (*it)->mName ) );
+        }
+    }
+
     // A map which will be populated with vertices in cycles the first time one is
     // found and can be used there after to break cycles as needed while
     // performing the topological sort.
@@ -691,6 +816,7 @@ void MarketDependencyFinder::createOrdering() {
             
             // Reset this item to be solved via trials and adjust the depenencies accordingly.
             createTrialsForItem( maxItem, numDependencies );
+            mCycleTrials.push_back( make_pair( (*maxItem)->mLocatedInRegion, (*maxItem)->mName ) );
 
             // Remove both the price and demand vertex from totalVisits since they can not be
             // used again to try to break a dependency.
@@ -705,12 +831,171 @@ void MarketDependencyFinder::createOrdering() {
         }
     }
     
-    // All vertices are now cleared and we have a global ordering.
+    // All vertices are now cleared and we have a global ordering.  Record the
+    // position of each vertex's activity in it, using the first should an
+    // activity appear more than once, so that market specific orderings may
+    // be put in order without searching.
+    map<IActivity*, int> orderIndex;
+    for( size_t i = 0; i < mGlobalOrdering.size(); ++i ) {
+        orderIndex.insert( make_pair( mGlobalOrdering[ i ], static_cast<int>( i ) ) );
+    }
+    for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
+        for( int priceOrDemand = 0; priceOrDemand <= 1; ++priceOrDemand ) {
+            const VertexList& vertices = priceOrDemand ? (*it)->mPriceVertices : (*it)->mDemandVertices;
+            for( CVertexIterator vIter = vertices.begin(); vIter != vertices.end(); ++vIter ) {
+                map<IActivity*, int>::const_iterator indexIter = orderIndex.find( (*vIter)->mCalcItem );
+                (*vIter)->mOrderIndex = indexIter != orderIndex.end() ? indexIter->second : -1;
+            }
+        }
+    }
+
+    createMarketOrderings();
+
+    depLog.setLevel( ILogger::NOTICE );
+    depLog << "Created " << mCycleTrials.size() << " trial markets to break cycles." << endl;
+
     depLog.setLevel( ILogger::DEBUG );
     depLog << "Global Ordering:" << endl;
     for( vector<IActivity*>::iterator it = mGlobalOrdering.begin(); it != mGlobalOrdering.end(); ++it ) {
         depLog << "- " << (*it)->getDescription() << endl;
     }
+
+    // Any cached grains were for the graph with the cached trials, if we had to
+    // break additional cycles they are no longer valid.
+    if( mCycleTrials != cachedTrials ) {
+        mGrains.clear();
+    }
+    writeCache();
+}
+
+/*!
+ * \brief Calculate a hash of all of the dependency information which goes
+ *        into creating the ordering.
+ * \details Everything which may influence which cycles need to be broken, or
+ *          the structure of the resulting flow graph, is included so that the
+ *          dependency cache is only reused when the inputs are unchanged.
+ * \return The hash.
+ */
+size_t MarketDependencyFinder::calcDependencyHash() const {
+    size_t hash = 0;
+    // The trial markets chosen depend on how cycles are broken.
+    boost::hash_combine( hash, Configuration::getInstance()->getBool( "minimize-cycle-trials", false, false ) );
+    for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
+        boost::hash_combine( hash, (*it)->mName );
+        boost::hash_combine( hash, (*it)->mLocatedInRegion );
+        boost::hash_combine( hash, (*it)->mIsSolved );
+        boost::hash_combine( hash, (*it)->mCanBreakCycle );
+        boost::hash_combine( hash, (*it)->mHasSelfDependence );
+        for( int priceOrDemand = 0; priceOrDemand <= 1; ++priceOrDemand ) {
+            const VertexList& vertices = priceOrDemand ? (*it)->mPriceVertices : (*it)->mDemandVertices;
+            boost::hash_combine( hash, vertices.size() );
+            for( CVertexIterator vIter = vertices.begin(); vIter != vertices.end(); ++vIter ) {
+                boost::hash_combine( hash, (*vIter)->mUID );
+                boost::hash_combine( hash, (*vIter)->mCalcItem->getDescription() );
+            }
+        }
+        for( CItemIterator depIt = (*it)->mDependentList.begin(); depIt != (*it)->mDependentList.end(); ++depIt ) {
+            boost::hash_combine( hash, (*depIt)->mName );
+            boost::hash_combine( hash, (*depIt)->mLocatedInRegion );
+        }
+    }
+    return hash;
+}
+
+/*!
+ * \brief Read the dependency cache if one exists for the current dependencies.
+ * \details The cache file is given by the "dependency-cache-file" configuration
+ *          file.  It holds the hash of the dependencies it was created for (see
+ *          calcDependencyHash), the items converted to trial markets to break
+ *          cycles and the grains of the global flow graph.  If the hash does not
+ *          match the current dependencies the file is ignored.
+ * \param aCachedTrials The items, by region and name, which were converted to
+ *                      trial markets to break cycles.
+ */
+void MarketDependencyFinder::readCache( vector<pair<string, string> >& aCachedTrials ) {
+    const string fileName = Configuration::getInstance()->getFile( "dependency-cache-file", "", false );
+    if( fileName.empty() ) {
+        return;
+    }
+    ifstream cacheFile( fileName.c_str() );
+    if( !cacheFile ) {
+        return;
+    }
+
+    ILogger& depLog = ILogger::getLogger( "dependency_finder_log" );
+    string line;
+    bool isValid = false;
+    while( getline( cacheFile, line ) ) {
+        istringstream lineStream( line );
+        string tag;
+        getline( lineStream, tag, '\t' );
+        if( tag == "hash" ) {
+            size_t hash = 0;
+            lineStream >> hash;
+            isValid = hash == mDependencyHash;
+            if( !isValid ) {
+                depLog.setLevel( ILogger::NOTICE );
+                depLog << "Dependencies have changed, ignoring the dependency cache." << endl;
+                break;
+            }
+        }
+        else if( !isValid ) {
+            // the hash must come first
+            break;
+        }
+        else if( tag == "trial" ) {
+            string region;
+            string name;
+            getline( lineStream, region, '\t' );
+            getline( lineStream, name );
+            aCachedTrials.push_back( make_pair( region, name ) );
+        }
+        else if( tag == "grain-key" ) {
+            lineStream >> mGrainKey;
+        }
+        else if( tag == "grain" ) {
+            mGrains.push_back( vector<int>() );
+            int uid;
+            while( lineStream >> uid ) {
+                mGrains.back().push_back( uid );
+            }
+        }
+    }
+    if( isValid ) {
+        depLog.setLevel( ILogger::NOTICE );
+        depLog << "Using the dependency cache " << fileName << " with " << aCachedTrials.size()
+               << " trial markets and " << mGrains.size() << " grains." << endl;
+    }
+    else {
+        aCachedTrials.clear();
+        mGrains.clear();
+    }
+}
+
+/*!
+ * \brief Write the dependency cache for the current dependencies.
+ * \details This is only done if the "dependency-cache-file" is set to
+ *          write-output.  See readCache for the contents.
+ */
+void MarketDependencyFinder::writeCache() const {
+    if( !Configuration::getInstance()->shouldWriteFile( "dependency-cache-file", false, false ) ) {
+        return;
+    }
+    AutoOutputFile cacheFile( "dependency-cache-file", "dependency-cache.txt" );
+    (*cacheFile) << "hash\t" << mDependencyHash << '\n';
+    for( auto trial : mCycleTrials ) {
+        (*cacheFile) << "trial\t" << trial.first << '\t' << trial.second << '\n';
+    }
+    if( !mGrains.empty() ) {
+        (*cacheFile) << "grain-key\t" << mGrainKey << '\n';
+        for( size_t i = 0; i < mGrains.size(); ++i ) {
+            (*cacheFile) << "grain";
+            for( size_t j = 0; j < mGrains[ i ].size(); ++j ) {
+                (*cacheFile) << (j == 0 ? '\t' : ' ') << mGrains[ i ][ j ];
+            }
+            (*cacheFile) << '\n';
+        }
+    }
 }
 
 /*!
@@ -831,6 +1116,203 @@ int MarketDependencyFinder::markCycles( CalcVertex* aCurrVertex, list<CalcVertex
     }
 }
 
+/*!
+ * \brief Choose the items to convert to trial markets so that all of the cycles
+ *        which remain in the graph are broken by as few of them as possible.
+ * \details The choice is made on a copy of the graph in which converting an item
+ *          has the same effect on the edges as createTrialsForItem.  The graph
+ *          is first trimmed to its core by repeatedly removing vertices with no
+ *          in or out edges which leaves only the cycles and the paths between
+ *          them.  Items are then converted greedily taking the one which removes
+ *          the most edges from the core until none remains.  Finally each item
+ *          chosen is given back, last chosen first, if the others still break
+ *          every cycle without it.  The result therefore has no redundant trial
+ *          markets although, as finding the smallest such set is NP-hard, it is
+ *          not guaranteed to be the smallest possible.
+ * \param aNumDependencies The vertices which have yet to be ordered.
+ * \param aGreedyCount The number of items chosen by the greedy pass before any
+ *                     were given back.
+ * \return The items to convert in the order they were chosen, empty if there
+ *         are no cycles or they can not all be broken.
+ */
+vector<MarketDependencyFinder::CItemIterator> MarketDependencyFinder::chooseCycleTrials(
+    const CalcVertexCountMap& aNumDependencies, size_t& aGreedyCount ) const
+{
+    aGreedyCount = 0;
+
+    // Number the vertices and copy the edges between them.
+    map<const CalcVertex*, int> vertexIndex;
+    for( CalcVertexCountMap::const_iterator it = aNumDependencies.begin(); it != aNumDependencies.end(); ++it ) {
+        vertexIndex.insert( make_pair( (*it).first, static_cast<int>( vertexIndex.size() ) ) );
+    }
+    const int numVertices = static_cast<int>( vertexIndex.size() );
+    vector<vector<int> > origEdges( numVertices );
+    for( map<const CalcVertex*, int>::const_iterator it = vertexIndex.begin(); it != vertexIndex.end(); ++it ) {
+        for( CVertexIterator outIter = (*it).first->mOutEdges.begin(); outIter != (*it).first->mOutEdges.end(); ++outIter ) {
+            map<const CalcVertex*, int>::const_iterator outIndex = vertexIndex.find( *outIter );
+            if( outIndex != vertexIndex.end() ) {
+                origEdges[ (*it).second ].push_back( (*outIndex).second );
+            }
+        }
+    }
+
+    // The items which may be converted along with the vertices converting them
+    // would change, and which demand vertices lose their edges to a converted
+    // item's demand.
+    vector<CItemIterator> candidates;
+    vector<int> lastPriceOf( numVertices, -1 );
+    vector<int> firstDemandOf( numVertices, -1 );
+    vector<bool> isCutDemand( numVertices, false );
+    for( CItemIterator it = mDependencyItems.begin(); it != mDependencyItems.end(); ++it ) {
+        for( CVertexIterator vertexIter = (*it)->mDemandVertices.begin(); vertexIter != (*it)->mDemandVertices.end(); ++vertexIter ) {
+            map<const CalcVertex*, int>::const_iterator index = vertexIndex.find( *vertexIter );
+            if( index != vertexIndex.end() ) {
+                isCutDemand[ (*index).second ] =
+                    !boost::algorithm::ends_with( (*vertexIter)->mCalcItem->getDescription(), "-fixed-output" );
+            }
+        }
+        if( (*it)->mIsSolved || !(*it)->mCanBreakCycle || (*it)->mLinkedMarket < 0 ||
+            (*it)->mPriceVertices.empty() || (*it)->mDemandVertices.empty() )
+        {
+            continue;
+        }
+        map<const CalcVertex*, int>::const_iterator lastPrice = vertexIndex.find( (*it)->getLastPriceVertex() );
+        map<const CalcVertex*, int>::const_iterator firstDemand = vertexIndex.find( (*it)->getFirstDemandVertex() );
+        if( lastPrice != vertexIndex.end() && firstDemand != vertexIndex.end() ) {
+            lastPriceOf[ (*lastPrice).second ] = static_cast<int>( candidates.size() );
+            firstDemandOf[ (*firstDemand).second ] = static_cast<int>( candidates.size() );
+            candidates.push_back( it );
+        }
+    }
+    vector<int> candidateFirstDemand( candidates.size() );
+    for( int v = 0; v < numVertices; ++v ) {
+        if( firstDemandOf[ v ] >= 0 ) {
+            candidateFirstDemand[ firstDemandOf[ v ] ] = v;
+        }
+    }
+
+    // Build the edges of the graph with the given items converted.
+    vector<vector<int> > edges;
+    auto buildGraph = [&]( const vector<bool>& aIsConverted ) {
+        edges.assign( numVertices, vector<int>() );
+        for( int v = 0; v < numVertices; ++v ) {
+            if( lastPriceOf[ v ] >= 0 && aIsConverted[ lastPriceOf[ v ] ] ) {
+                edges[ v ].push_back( candidateFirstDemand[ lastPriceOf[ v ] ] );
+                continue;
+            }
+            for( auto w : origEdges[ v ] ) {
+                if( !isCutDemand[ v ] || firstDemandOf[ w ] < 0 || !aIsConverted[ firstDemandOf[ w ] ] ) {
+                    edges[ v ].push_back( w );
+                }
+            }
+        }
+    };
+
+    // Trim the graph to its core and return the number of vertices in it.
+    vector<bool> inCore;
+    auto findCore = [&]() {
+        vector<int> numIn( numVertices, 0 );
+        vector<int> numOut( numVertices, 0 );
+        vector<vector<int> > inEdges( numVertices );
+        for( int v = 0; v < numVertices; ++v ) {
+            numOut[ v ] = static_cast<int>( edges[ v ].size() );
+            for( auto w : edges[ v ] ) {
+                ++numIn[ w ];
+                inEdges[ w ].push_back( v );
+            }
+        }
+        inCore.assign( numVertices, true );
+        vector<int> toRemove;
+        for( int v = 0; v < numVertices; ++v ) {
+            if( numIn[ v ] == 0 || numOut[ v ] == 0 ) {
+                inCore[ v ] = false;
+                toRemove.push_back( v );
+            }
+        }
+        int coreSize = numVertices - static_cast<int>( toRemove.size() );
+        while( !toRemove.empty() ) {
+            const int v = toRemove.back();
+            toRemove.pop_back();
+            for( auto w : edges[ v ] ) {
+                if( inCore[ w ] && --numIn[ w ] == 0 ) {
+                    inCore[ w ] = false;
+                    toRemove.push_back( w );
+                    --coreSize;
+                }
+            }
+            for( auto u : inEdges[ v ] ) {
+                if( inCore[ u ] && --numOut[ u ] == 0 ) {
+                    inCore[ u ] = false;
+                    toRemove.push_back( u );
+                    --coreSize;
+                }
+            }
+        }
+        return coreSize;
+    };
+
+    vector<bool> isConverted( candidates.size(), false );
+    vector<int> chosen;
+    bool isAcyclic = false;
+    while( true ) {
+        buildGraph( isConverted );
+        if( findCore() == 0 ) {
+            isAcyclic = true;
+            break;
+        }
+        // Count the core edges each item would remove.
+        vector<int> score( candidates.size(), 0 );
+        for( int v = 0; v < numVertices; ++v ) {
+            if( !inCore[ v ] ) {
+                continue;
+            }
+            for( auto w : edges[ v ] ) {
+                if( inCore[ w ] ) {
+                    if( lastPriceOf[ v ] >= 0 ) {
+                        ++score[ lastPriceOf[ v ] ];
+                    }
+                    if( isCutDemand[ v ] && firstDemandOf[ w ] >= 0 ) {
+                        ++score[ firstDemandOf[ w ] ];
+                    }
+                }
+            }
+        }
+        int best = -1;
+        for( size_t c = 0; c < candidates.size(); ++c ) {
+            if( !isConverted[ c ] && score[ c ] > 0 && ( best < 0 || score[ c ] > score[ best ] ) ) {
+                best = static_cast<int>( c );
+            }
+        }
+        if( best < 0 ) {
+            break;
+        }
+        isConverted[ best ] = true;
+        chosen.push_back( best );
+    }
+    aGreedyCount = chosen.size();
+    if( !isAcyclic ) {
+        // Leave the cycles to the search in createOrdering.
+        return vector<CItemIterator>();
+    }
+
+    // Give back any items which are not needed to break the cycles.
+    for( size_t i = chosen.size(); i-- > 0; ) {
+        isConverted[ chosen[ i ] ] = false;
+        buildGraph( isConverted );
+        if( findCore() != 0 ) {
+            isConverted[ chosen[ i ] ] = true;
+        }
+    }
+
+    vector<CItemIterator> trials;
+    for( auto c : chosen ) {
+        if( isConverted[ c ] ) {
+            trials.push_back( candidates[ c ] );
+        }
+    }
+    return trials;
+}
+
 /*!
  * \brief Reset a market identified by it's iterator into the dependency items to a solved
  *        market by using trial price/demand markets.
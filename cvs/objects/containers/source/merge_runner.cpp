@@ -43,6 +43,7 @@
 #include "containers/include/merge_runner.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/xml_helper.h"
+#include "util/base/include/xml_stream_parser.h"
 #include "util/base/include/configuration.h"
 #include "util/base/include/auto_file.h"
 #include "containers/include/scenario.h"
@@ -74,7 +75,7 @@ bool MergeRunner::setupScenarios( Timer& timer, const string aName, const list<s
     // Parse the input file.
     const Configuration* conf = Configuration::getInstance();
     
-    bool success = XMLHelper<void>::parseXML( conf->getFile( "xmlInputFileName" ), mScenario.get() );
+    bool success = XMLStreamParser::parseInput( conf->getFile( "xmlInputFileName" ), mScenario.get() );
 
     // Parsing failed.
     if( !success ){
@@ -103,7 +104,7 @@ bool MergeRunner::setupScenarios( Timer& timer, const string aName, const list<s
     typedef list<string>::const_iterator ScenCompIter;
     for( ScenCompIter currComp = scenComponents.begin(); currComp != scenComponents.end(); ++currComp ) {
         mainLog << "Parsing " << *currComp << " scenario component." << endl;
-        if( !XMLHelper<void>::parseXML( *currComp, mScenario.get() ) ){
+        if( !XMLStreamParser::parseInput( *currComp, mScenario.get() ) ){
             // Parsing failed.
             return false;
         }
@@ -0,0 +1,184 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file model_server.cpp
+ * \ingroup Objects
+ * \brief ModelServer class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+#include <sstream>
+#include <cstdlib>
+#include <memory>
+#include "containers/include/model_server.h"
+#include "containers/include/single_scenario_runner.h"
+#include "containers/include/scenario_runner_factory.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/timer.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+#if !defined(_WIN32)
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+const string ModelServer::RESPONSE_PREFIX = "gcam-server:";
+
+/*!
+ * \brief Serve requests until the input is exhausted or a quit request is
+ *        read.
+ * \param aTimer The timer used to print out the amount of time spent
+ *        performing operations.
+ * \param aIn The stream to read requests from.
+ * \param aOut The stream to write responses to.
+ * \return Whether the base inputs could be parsed.
+ */
+bool ModelServer::run( Timer& aTimer, istream& aIn, ostream& aOut ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if !defined(_WIN32)
+    if( !SingleScenarioRunner::prepareSharedScenario( aTimer ) ) {
+        aOut << RESPONSE_PREFIX << " failed to parse the base inputs" << endl;
+        return false;
+    }
+#endif
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Model server ready for requests." << endl;
+    aOut << RESPONSE_PREFIX << " ready" << endl;
+
+    string line;
+    while( getline( aIn, line ) ) {
+        istringstream request( line );
+        string command;
+        if( !( request >> command ) ) {
+            continue;
+        }
+        if( command == "quit" ) {
+            break;
+        }
+        string name;
+        int stopPeriod;
+        if( command != "run" || !( request >> name >> stopPeriod ) ) {
+            aOut << RESPONSE_PREFIX << " error expected run <name> <stop-period> [<component> ...] or quit" << endl;
+            continue;
+        }
+        list<string> components;
+        string component;
+        while( request >> component ) {
+            components.push_back( component );
+        }
+
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Model server running " << name << " with " << components.size()
+                << " additional scenario components." << endl;
+        const Outcome outcome = runRequest( name, stopPeriod, components, aTimer );
+        aOut << RESPONSE_PREFIX << ( outcome == SOLVED ? " solved " : outcome == UNSOLVED ? " unsolved " : " failed " )
+             << name << endl;
+    }
+
+    SingleScenarioRunner::releaseSharedScenario();
+    aOut << RESPONSE_PREFIX << " bye" << endl;
+    return true;
+}
+
+/*!
+ * \brief Run a single request in a copy of the server process.
+ * \details The outcome is passed back as the exit status of the copy.  Without
+ *          fork the request is run in this process from freshly parsed inputs.
+ * \param aName The scenario name to run under.
+ * \param aStopPeriod The last period to run or Scenario::RUN_ALL_PERIODS.
+ * \param aComponents The additional scenario components to parse.
+ * \param aTimer The timer used to print out the amount of time spent
+ *        performing operations.
+ * \return The outcome of the request.
+ */
+ModelServer::Outcome ModelServer::runRequest( const string& aName, const int aStopPeriod,
+                                              const list<string>& aComponents, Timer& aTimer )
+{
+#if defined(_WIN32)
+    return runScenario( aName, aStopPeriod, aComponents, aTimer );
+#else
+    // Flush anything buffered so that it is not written again by the copy.
+    cout.flush();
+    pid_t pid = fork();
+    if( pid == 0 ) {
+        const Outcome outcome = runScenario( aName, aStopPeriod, aComponents, aTimer );
+        cout.flush();
+        // Skip the destructors of objects copied from the server.
+        _exit( outcome );
+    }
+    else if( pid < 0 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not start a process to run " << aName << "." << endl;
+        return FAILED;
+    }
+    int exitStatus;
+    if( waitpid( pid, &exitStatus, 0 ) != pid || !WIFEXITED( exitStatus ) ) {
+        return FAILED;
+    }
+    const int outcome = WEXITSTATUS( exitStatus );
+    return outcome == SOLVED || outcome == UNSOLVED ? static_cast<Outcome>( outcome ) : FAILED;
+#endif
+}
+
+/*!
+ * \brief Set up, run and write the outputs of a scenario in this process.
+ * \param aName The scenario name to run under.
+ * \param aStopPeriod The last period to run or Scenario::RUN_ALL_PERIODS.
+ * \param aComponents The additional scenario components to parse.
+ * \param aTimer The timer used to print out the amount of time spent
+ *        performing operations.
+ * \return The outcome of the scenario.
+ */
+ModelServer::Outcome ModelServer::runScenario( const string& aName, const int aStopPeriod,
+                                               const list<string>& aComponents, Timer& aTimer )
+{
+    Configuration* conf = Configuration::getInstance();
+    auto_ptr<SingleScenarioRunner> runner = ScenarioRunnerFactory::createSingleScenarioRunner();
+    const bool isSetup = runner->setupScenarios( aTimer, aName, aComponents );
+    Outcome outcome = FAILED;
+    if( isSetup ) {
+        const bool printDebug = conf->shouldWriteFile( "xmlDebugFileName" );
+        outcome = runner->runScenarios( aStopPeriod, printDebug, aTimer ) ? SOLVED : UNSOLVED;
+        runner->printOutput( aTimer );
+    }
+    runner->cleanup();
+    return outcome;
+}
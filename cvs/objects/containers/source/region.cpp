@@ -307,8 +307,8 @@ const std::string& Region::getXMLNameStatic() {
 /*! \brief Complete the initialization. 
  *
  * Completes the initialization for this regions data members.
- * \todo Figure out if Demographics and supplysectors calls to completeInit can
- *       be moved down from RegionMiniCAM and RegionCGE.
+ * \todo Figure out if the supplysectors calls to completeInit can be moved
+ *       down from RegionMiniCAM and RegionCGE.
  * \author Pralit Patel
  */
 void Region::completeInit() {    
@@ -323,6 +323,20 @@ void Region::completeInit() {
     }
 }
 
+/*!
+ * \brief Precompute the socioeconomic projections for all periods.
+ * \details The population projection depends only on the read in data of this
+ *          region and so is calculated once for all periods here rather than
+ *          during completeInit.  This is called by the World before the
+ *          regions complete their initialization and may be called for several
+ *          regions concurrently.
+ */
+void Region::completeSocioeconomicInit() {
+    if( mDemographic ){
+        mDemographic->completeInit();
+    }
+}
+
 /*!
  * \brief Function to initialize objects prior to starting a model period.
  * \param aPeriod The model period about to begin.
@@ -232,10 +232,6 @@ void RegionCGE::toDebugXMLDerived( const int period, std::ostream& out, Tabs* ta
 void RegionCGE::completeInit() {
     Region::completeInit();
 
-    // initialize demographic
-    if( mDemographic ){
-        mDemographic->completeInit();
-    }
     for( SectorIterator sectorIter = mSupplySector.begin(); sectorIter != mSupplySector.end(); ++sectorIter ) {
         ( *sectorIter )->completeInit( 0, 0 );
     }
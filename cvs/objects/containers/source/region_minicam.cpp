@@ -235,6 +235,20 @@ bool RegionMiniCAM::XMLDerivedClassParse( const std::string& nodeName, const xer
 }
 
 
+/*!
+ * \brief Precompute the population and the unadjusted GDP projection for all
+ *        periods.
+ * \details The GDP is still recalculated each period during initCalc so that
+ *          any feedback from energy service prices is included.
+ */
+void RegionMiniCAM::completeSocioeconomicInit() {
+    Region::completeSocioeconomicInit();
+
+    if( mGDP ){
+        mGDP->initData( mDemographic );
+    }
+}
+
 /*! Complete the initialization. Get the size of vectors, initialize AGLU,
 *   create all markets, call complete initialization
 *  functions for nested objects, update the fuel map, and find simultaneities.
@@ -262,16 +276,6 @@ void RegionMiniCAM::completeInit() {
     // Add the land private discount rate to the region info.
     mRegionInfo->setDouble( "private-discount-rate-land", mPrivateDiscountRateLand );
 
-    // initialize demographic
-    if( mDemographic ){
-        mDemographic->completeInit();
-    }
-
-    // Initialize the GDP
-    if( mGDP ){
-        mGDP->initData( mDemographic );
-    }
-
     for( SectorIterator sectorIter = mSupplySector.begin(); sectorIter != mSupplySector.end(); ++sectorIter ) {
         ( *sectorIter )->completeInit( mRegionInfo, mLandAllocator );
     }
@@ -615,6 +619,9 @@ void RegionMiniCAM::setCO2CoefsIntoMarketplace( const int aPeriod ){
 void RegionMiniCAM::postCalc( const int aPeriod ) {
     Region::postCalc( aPeriod );
 
+    // Any indirect emissions calculated are out of date.
+    mIndirectEmissionsCalc.reset();
+
     for( CConsumerIterator consumerIter = mConsumers.begin(); consumerIter != mConsumers.end(); ++consumerIter ) {
         (*consumerIter)->postCalc( mName, "", aPeriod );
     }
@@ -624,6 +631,24 @@ void RegionMiniCAM::postCalc( const int aPeriod ) {
     }
 }
 
+/*!
+ * \brief Get the indirect emissions of the sectors in this region.
+ * \details The emissions are calculated for all periods the first time they
+ *          are requested after the model is run so that the output functions
+ *          can share them rather than each visiting the region once per period.
+ * \return The indirect emissions calculator.
+ */
+const IndirectEmissionsCalculator* RegionMiniCAM::getIndirectEmissionsCalculator() const {
+    if( !mIndirectEmissionsCalc.get() ) {
+        mIndirectEmissionsCalc.reset( new IndirectEmissionsCalculator );
+        const int maxPeriod = scenario->getModeltime()->getmaxper();
+        for( int period = 0; period < maxPeriod; ++period ) {
+            accept( mIndirectEmissionsCalc.get(), period );
+        }
+    }
+    return mIndirectEmissionsCalc.get();
+}
+
 //! Calculate regional emissions from resources.
 void RegionMiniCAM::calcEmissions( const int period ) {
     summary[period].clearemiss(); // clear emissions map
@@ -675,8 +700,8 @@ void RegionMiniCAM::csvOutputFile() const {
     const int maxper = modeltime->getmaxper();
     vector<double> temp(maxper);
     // function protocol
-    void fileoutput3(string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3(const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     // write population results to database
     if( mDemographic ){
@@ -715,19 +740,13 @@ void RegionMiniCAM::csvOutputFile() const {
     }
     fileoutput3(mName,"Pri Energy","total","","zTotal","EJ",temp);
 
-    // Calculate indirect emissions so they can be written to the database.
-    IndirectEmissionsCalculator indEmissCalc;
-    for( int i = 0; i < modeltime->getmaxper(); ++i ){
-        accept( &indEmissCalc, i );
-    }
-
     // write resource results to file
     for ( unsigned int i = 0; i < mResources.size(); i++ )
         mResources[i]->csvOutputFile( mName );
 
     // write supply sector results to file
     for ( unsigned int i = 0; i < mSupplySector.size(); i++ ) {
-        mSupplySector[i]->csvOutputFile( mGDP, &indEmissCalc );
+        mSupplySector[i]->csvOutputFile( mGDP, getIndirectEmissionsCalculator() );
     }
 
     // write end-use sector demand results to file
@@ -797,7 +816,7 @@ void RegionMiniCAM::dbOutput( const list<string>& aPrimaryFuelList ) const {
 
     // regional emissions for all greenhouse gases
     typedef map<string,double>:: const_iterator CI;
-    map<string,double> temissmap = summary[0].getemission(); // get gases for period 0
+    const map<string,double>& temissmap = summary[0].getemission(); // get gases for period 0
     for (CI gmap=temissmap.begin(); gmap!=temissmap.end(); ++gmap) {
         for ( int m= 0;m<maxper;m++) {
             temp[m] = summary[m].get_emissmap_second(gmap->first);
@@ -806,7 +825,7 @@ void RegionMiniCAM::dbOutput( const list<string>& aPrimaryFuelList ) const {
     }
 
     // regional fuel consumption (primary and secondary) by fuel type
-    map<string,double> tfuelmap = summary[0].getfuelcons();
+    const map<string,double>& tfuelmap = summary[0].getfuelcons();
     for (CI fmap=tfuelmap.begin(); fmap!=tfuelmap.end(); ++fmap) {
         for ( int m= 0;m<maxper;m++) {
             temp[m] = summary[m].get_fmap_second(fmap->first);
@@ -851,15 +870,9 @@ void RegionMiniCAM::dbOutput( const list<string>& aPrimaryFuelList ) const {
         mResources[i]->dbOutput( mName );
     }
 
-    // Calculate indirect emissions so they can be written to the database.
-        IndirectEmissionsCalculator indEmissCalc;
-        for( int i = 0; i < modeltime->getmaxper(); ++i ){
-            accept( &indEmissCalc, i );
-    }
-
     // write supply sector results to database
     for ( unsigned int i = 0; i < mSupplySector.size(); i++ ) {
-        mSupplySector[i]->dbOutput( mGDP, &indEmissCalc );
+        mSupplySector[i]->dbOutput( mGDP, getIndirectEmissionsCalculator() );
     }
     // write end-use sector demand results to database
     for ( unsigned int i = 0; i < mFinalDemands.size(); i++ ) {
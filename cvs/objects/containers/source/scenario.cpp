@@ -44,6 +44,11 @@
 #include <cassert>
 #include <ctime>
 #include <iomanip>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <sstream>
+#include <boost/algorithm/string.hpp>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -57,13 +62,30 @@
 #include "util/curves/include/curve.h"
 #include "solution/solvers/include/solver.h"
 #include "util/base/include/auto_file.h"
+#include "util/base/include/csv_output_buffer.h"
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
+#include "util/base/include/activity_profiler.h"
+#include "util/base/include/allocation_tracker.h"
+#include "util/base/include/startup_profile.h"
+#include "util/base/include/memory_report.h"
+#include "solution/util/include/calc_counter.h"
 #include "reporting/include/graph_printer.h"
 #include "reporting/include/land_allocator_printer.h"
+#include "reporting/include/arrow_outputter.h"
 #include "containers/include/output_meta_data.h"
 #include "solution/solvers/include/solver_factory.h"
 #include "solution/solvers/include/bisection_nr_solver.h"
 #include "solution/util/include/solution_info_param_parser.h" 
+#include "solution/util/include/solution_info.h"
+#include "solution/util/include/jacobian_profiler.h"
+#include "solution/util/include/solver_trace.h"
+#include "solution/util/include/solver_telemetry.h"
+#include "solution/util/include/solver_profile.h"
+#include "parallel/include/gcam_parallel.hpp"
+#include "parallel/include/parallel_benchmark.hpp"
+#include "util/base/include/hash_map_benchmark.h"
+#include "solution/util/include/dense_lu_benchmark.h"
 #include "containers/include/imodel_feedback_calc.h"
 #include "util/base/include/manage_state_variables.hpp"
 
@@ -72,6 +94,14 @@
 #include <tbb/tick_count.h>
 #endif
 
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/select.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 using namespace std;
 using namespace xercesc;
 using namespace boost;
@@ -90,6 +120,12 @@ Scenario::Scenario() {
     mSolutionInfoParamParser = 0;
     
     mManageStateVars = 0;
+    mBranchPeriod = 0;
+    mPipelinePeriods = false;
+    mIsSpeculativeCopy = false;
+    mSpeculationPeriod = -1;
+    mSpeculationPid = -1;
+    mSpeculationPipe = -1;
 }
 
 //! Destructor
@@ -252,7 +288,9 @@ void Scenario::completeInit() {
         mWorld->completeInit();
 
         // initialize solvers
+        StartupProfile::getInstance().startPhase( "initialize solvers" );
         initSolvers();
+        StartupProfile::getInstance().endPhase( "initialize solvers" );
     }
     else {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -263,6 +301,9 @@ void Scenario::completeInit() {
     // Set the valid period vector to false.
     mIsValidPeriod.clear();
     mIsValidPeriod.resize( mModeltime->getmaxper(), false );
+    if( Configuration::getInstance()->getBool( "report-memory-usage", false, false ) ) {
+        reportMemoryUsage( "after completeInit" );
+    }
 }
 
 //! Write object to xml output stream.
@@ -299,17 +340,34 @@ const string& Scenario::getName() const {
 * \param aPrintDebugging Whether to print extra debugging files.
 * \param aFilenameEnding The string to add to the end of the debug output file
 *        for uniqueness.
+* \param aRestartPeriod The first period to solve, the periods before it are
+*        restored from the checkpoints written by a previous run.
 * \return Whether all model runs solved successfully.
 */
 bool Scenario::run( const int aSinglePeriod,
                     const bool aPrintDebugging,
-                    const string& aFilenameEnding )
+                    const string& aFilenameEnding,
+                    const int aRestartPeriod )
 {
-    // Avoid accumulating unsolved periods.
-    mUnsolvedPeriods.clear();
+    // Avoid accumulating unsolved periods. A single period run does not
+    // recalculate the valid periods before it so they keep their status.
+    if( aSinglePeriod == RUN_ALL_PERIODS ) {
+        mUnsolvedPeriods.clear();
+    }
+    else {
+        vector<int> stillUnsolved;
+        for( auto period : mUnsolvedPeriods ) {
+            if( period < aSinglePeriod && mIsValidPeriod[ period ] ) {
+                stillUnsolved.push_back( period );
+            }
+        }
+        mUnsolvedPeriods.swap( stillUnsolved );
+    }
     
-    // Open the debugging files.
-    AutoOutputFile XMLDebugFile( "xmlDebugFileName", "debug.xml", aPrintDebugging );
+    // Open the debugging files.  The debug XML may be compressed and written to
+    // the file in the background as it is produced.
+    AutoOutputFile XMLDebugFile( "xmlDebugFileName", "debug.xml", aPrintDebugging,
+                                 Configuration::getInstance()->getBool( "async-debug-output", false, false ) );
     AutoOutputFile SGMDebugFile( "ObjectSGMFileName", "ObjectSGMout.csv", aPrintDebugging );
     Tabs tabs;
     if( aPrintDebugging ) {
@@ -323,17 +381,23 @@ bool Scenario::run( const int aSinglePeriod,
 
     Timer& fullScenarioTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::FULLSCENARIO );
     fullScenarioTimer.start();
+    mPeriodPerformance.clear();
     
     // Log that a run is beginning.
     logRunBeginning();
 
     bool success = true;
 
+    // Later periods are only started speculatively when they will be run.
+    mPipelinePeriods = aSinglePeriod == RUN_ALL_PERIODS
+        && Configuration::getInstance()->getBool( "pipeline-periods", false, false );
+
     // If the single period is RUN_ALL_PERIODS that means to calculate all periods. Loop over
     // time steps and operate model.
     if( aSinglePeriod == RUN_ALL_PERIODS ){
         for( int per = 0; per < mModeltime->getmaxper(); per++ ){
-            success &= calculatePeriod( per, *XMLDebugFile, *SGMDebugFile, &tabs, aPrintDebugging );
+            success &= calculatePeriod( per, *XMLDebugFile, *SGMDebugFile, &tabs, aPrintDebugging,
+                                        per < aRestartPeriod || per < mBranchPeriod );
         }
     }
     // Check if the single period is invalid.
@@ -347,7 +411,8 @@ bool Scenario::run( const int aSinglePeriod,
         // Run all periods up to the single period which are invalid.
         for( int per = 0; per < aSinglePeriod; per++ ){
             if( !mIsValidPeriod[ per ] ){
-                success &= calculatePeriod( per, *XMLDebugFile, *SGMDebugFile, &tabs, aPrintDebugging );
+                success &= calculatePeriod( per, *XMLDebugFile, *SGMDebugFile, &tabs, aPrintDebugging,
+                                            per < aRestartPeriod || per < mBranchPeriod );
             }
         }
         
@@ -358,8 +423,10 @@ bool Scenario::run( const int aSinglePeriod,
 
         // Now run the requested period. Results past this period will no longer
         // be valid. Do not attempt to use them!
-        success &= calculatePeriod( aSinglePeriod, *XMLDebugFile, *SGMDebugFile, &tabs, aPrintDebugging );
+        success &= calculatePeriod( aSinglePeriod, *XMLDebugFile, *SGMDebugFile, &tabs, aPrintDebugging,
+                                    false );
     }
+    stopSpeculation();
     
     // Print any unsolved periods.
     // TODO: This should be added to the db.
@@ -382,6 +449,31 @@ bool Scenario::run( const int aSinglePeriod,
     mainLog.setLevel( ILogger::DEBUG );
     fullScenarioTimer.stop();
     TimerRegistry::getInstance().printAllTimers( mainLog );
+    if( Configuration::getInstance()->shouldWriteFile( "timer-report", false, false ) ) {
+        const string& timerFile = Configuration::getInstance()->getFile( "timer-report" );
+        if( !TimerRegistry::getInstance().writeJSON( timerFile ) ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not write the timer report to " << timerFile << "." << endl;
+            mainLog.setLevel( ILogger::DEBUG );
+        }
+    }
+    if( Configuration::getInstance()->shouldWriteFile( "period-performance", false, false ) ) {
+        const string& performanceFile = Configuration::getInstance()->getFile( "period-performance" );
+        if( !writePeriodPerformance( performanceFile ) ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not write the period performance to " << performanceFile << "." << endl;
+            mainLog.setLevel( ILogger::DEBUG );
+        }
+    }
+#if GCAM_TRACK_ALLOCATIONS
+    AllocationTracker::printActivities( mainLog );
+    AllocationTracker::clearActivities();
+#endif
+    JacobianProfiler::getInstance().printReport();
+#if GCAM_PARALLEL_ENABLED
+    ActivityCostModel::getInstance().writeCosts();
+    FlowGraphTracer::getInstance().writeTrace();
+#endif
 
     // Run the climate model.
     mWorld->runClimateModel();
@@ -403,13 +495,17 @@ bool Scenario::run( const int aSinglePeriod,
 * \param aSGMDebugFile SGM debugging file.
 * \param aTabs Tabs formatting object.
 * \param aPrintDebugging Whether to print debugging information.
+* \param aRestore Whether to restore the solution from the checkpoint of the
+*        period instead of solving it.  The period is solved if the checkpoint
+*        can not be read.
 * \return Whether the period was calculated successfully.
 */
 bool Scenario::calculatePeriod( const int aPeriod,
                                 ostream& aXMLDebugFile,
                                 ostream& aSGMDebugFile,
                                 Tabs* aTabs,
-                                bool aPrintDebugging )
+                                bool aPrintDebugging,
+                                const bool aRestore )
 {
     logPeriodBeginning( aPeriod );
 
@@ -430,9 +526,43 @@ bool Scenario::calculatePeriod( const int aPeriod,
         modelFeedback->calcFeedbacksBeforePeriod( this, mWorld->getClimateModel(), aPeriod );
     }
     
+    // Start from the prices another scenario solved this period with, if any.
+    // Initial prices which were provided directly take precedence.
+    const string priceGuessFile = getPriceGuessFileName( aPeriod );
+    if( !aRestore && !priceGuessFile.empty() ) {
+        const int numSet = mMarketplace->setPricesFromFile( priceGuessFile, aPeriod );
+        if( numSet > 0 ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Starting " << numSet << " markets from the prices in " << priceGuessFile << "." << endl;
+        }
+    }
+
+    // Start from the initial prices which were provided for this period, if any.
+    map<int, vector<double> >::iterator initialPrices = mInitialPrices.find( aPeriod );
+    if( initialPrices != mInitialPrices.end() ) {
+        mMarketplace->setInitialPrices( initialPrices->second, aPeriod );
+        mInitialPrices.erase( initialPrices );
+    }
+
+    // Only solve the markets of a single region and hold all other regions at
+    // the prices they solved at in a reference run.
+    const string solveRegion = Configuration::getInstance()->getString( "solve-region", "", false );
+    if( !aRestore && !solveRegion.empty() ) {
+        const string referencePriceFile = Configuration::getInstance()->getFile( "reference-price-location", "", false )
+            + "/" + util::toString( mModeltime->getper_to_yr( aPeriod ) ) + ".prices";
+        const int numFrozen = mMarketplace->freezeMarketsOutsideRegion( solveRegion, referencePriceFile, aPeriod );
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Froze " << numFrozen << " markets outside of " << solveRegion << " at the prices in "
+                << referencePriceFile << "." << endl;
+    }
+    
     // Set up the state data for the current period.
+    StartupProfile::getInstance().startPhase( "collect state variables" );
     delete mManageStateVars;
     mManageStateVars = new ManageStateVariables( aPeriod );
+    StartupProfile::getInstance().endPhase( "collect state variables" );
     
     // SGM Period 0 needs to clear out the supplies and demands put in by initCalc.
     if( aPeriod == 0 ){
@@ -497,7 +627,65 @@ bool Scenario::calculatePeriod( const int aPeriod,
 #endif
     
     
-    bool success = solve( aPeriod ); // solution uses Bisect and NR routine to clear markets
+    const Configuration* conf = Configuration::getInstance();
+    bool success;
+    if( mIsSpeculativeCopy || !aRestore || !readCheckpoint( aPeriod, success ) ) {
+        if( !mIsSpeculativeCopy ) {
+#if GCAM_PARALLEL_ENABLED
+            if( mModeltime->getper_to_yr( aPeriod ) == conf->getInt( "parallel-benchmark-year", -1, false ) ) {
+                ParallelBenchmark( aPeriod, mSolutionInfoParamParser ).run();
+            }
+#endif
+            if( mModeltime->getper_to_yr( aPeriod ) == conf->getInt( "hash-map-benchmark-year", -1, false ) ) {
+                HashMapBenchmark().run( mMarketplace, aPeriod );
+            }
+            if( mModeltime->getper_to_yr( aPeriod ) == conf->getInt( "dense-lu-benchmark-year", -1, false ) ) {
+                DenseLUBenchmark().run( static_cast<int>( mMarketplace->getMarketsToSolve( aPeriod ).size() ) );
+            }
+            if( mModeltime->getper_to_yr( aPeriod ) == conf->getInt( "replay-year", -1, false ) ) {
+                replaySolvers( aPeriod );
+            }
+            if( !conf->getFile( "race-solver-configs", "", false ).empty() ) {
+                raceSolvers( aPeriod );
+            }
+            // Start from the prices a speculative copy found for this period and
+            // start a new copy which goes on to the next one.
+            if( mPipelinePeriods ) {
+                finishSpeculation( aPeriod );
+                startSpeculation( aPeriod );
+            }
+        }
+
+        if( mIsSpeculativeCopy ) {
+            // A speculative copy solves without any of the side effects of the
+            // original process and only reports its prices.
+            success = mSolvers[ aPeriod ]->solve( aPeriod, mSolutionInfoParamParser );
+            sendSpeculativePrices( aPeriod, success );
+        }
+        else {
+            success = solve( aPeriod ); // solution uses Bisect and NR routine to clear markets
+
+            // Save the solution so that a later run may restart from it.
+            if( conf->shouldWriteFile( "checkpoint-location", false, false )
+                && ( mSharedCheckpointName.empty() || aPeriod < mBranchPeriod ) )
+            {
+                writeCheckpoint( aPeriod, success );
+            }
+
+            // Share the solved prices with later scenarios.
+            if( success && !priceGuessFile.empty() ) {
+                mMarketplace->writePrices( priceGuessFile, aPeriod );
+            }
+        }
+    }
+    else if( !success ) {
+        mUnsolvedPeriods.push_back( aPeriod );
+    }
+
+    // Report while the state is still allocated.
+    if( !mIsSpeculativeCopy && conf->getBool( "report-memory-usage", false, false ) ) {
+        reportMemoryUsage( "at the end of " + util::toString( mModeltime->getper_to_yr( aPeriod ) ) );
+    }
     
     delete mManageStateVars;
     mManageStateVars = 0;
@@ -531,16 +719,145 @@ bool Scenario::calculatePeriod( const int aPeriod,
         modelFeedback->calcFeedbacksAfterPeriod( this, mWorld->getClimateModel(), aPeriod );
     }
 
+    // Stream the results of the period to the output store so that they may
+    // be queried while later periods run.
+    if( !mIsSpeculativeCopy && conf->getBool( "incremental-output", false )
+        && conf->shouldWriteFile( "arrow-output-location", false, false ) )
+    {
+        ArrowOutputter::writePeriod( this, conf->getFile( "arrow-output-location" ), aPeriod );
+    }
+
     logPeriodEnding( aPeriod );
+
+#if GCAM_PROFILE_SCOPES
+    ScopeProfiler::reportPeriod( mModeltime->getper_to_yr( aPeriod ) );
+#endif
+    ActivityProfiler::getInstance().reportPeriod( mModeltime->getper_to_yr( aPeriod ) );
     
     // Write out the results for debugging.
-    if( aPrintDebugging ){
+    if( !mIsSpeculativeCopy && aPrintDebugging && util::isDebugYear( mModeltime->getper_to_yr( aPeriod ) ) ){
         writeDebuggingFiles( aXMLDebugFile, aSGMDebugFile, aTabs, aPeriod );
     }
 
     return success;
 }
 
+//! The identifier at the start of each checkpoint file.
+static const char CHECKPOINT_MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'C', 'K', 'P', 'T' };
+
+//! The version of the checkpoint file format.
+static const uint32_t CHECKPOINT_VERSION = 1;
+
+/*!
+ * \brief Get the name of the file holding the solved prices of a period which
+ *        are shared between scenarios.
+ * \param aPeriod Model period.
+ * \return The file name in the price-guess-location directory, or the empty
+ *         string if sharing prices is not enabled.
+ */
+string Scenario::getPriceGuessFileName( const int aPeriod ) const {
+    const Configuration* conf = Configuration::getInstance();
+    if( !conf->shouldWriteFile( "price-guess-location", false, false ) ) {
+        return "";
+    }
+    return conf->getFile( "price-guess-location" ) + "/"
+        + util::toString( mModeltime->getper_to_yr( aPeriod ) ) + ".prices";
+}
+
+/*!
+ * \brief Get the name of the checkpoint file of a period.
+ * \param aPeriod Model period.
+ * \return The checkpoint file name in the checkpoint-location directory.
+ */
+string Scenario::getCheckpointFileName( const int aPeriod ) const {
+    const string& name = mSharedCheckpointName.empty() ? mName : mSharedCheckpointName;
+    return Configuration::getInstance()->getFile( "checkpoint-location" ) + "/" + name + "."
+           + util::toString( mModeltime->getper_to_yr( aPeriod ) ) + ".ckpt";
+}
+
+/*!
+ * \brief Write a binary checkpoint of the solution of a period.
+ * \details The checkpoint holds every active STATE value of the period which
+ *          includes the market prices, supplies and demands as well as the
+ *          outputs of each vintage.  Everything else is recalculated by
+ *          initCalc.  The file is written under a temporary name and then
+ *          renamed so that a restart never reads a partially written file.
+ * \pre The state variables of the period must still be collected.
+ * \param aPeriod Model period which was just solved.
+ * \param aSolved Whether the period solved.
+ * \return Whether the checkpoint was written.
+ */
+bool Scenario::writeCheckpoint( const int aPeriod, const bool aSolved ) const {
+    assert( mManageStateVars );
+    const string fileName = getCheckpointFileName( aPeriod );
+    // Scenarios sharing checkpoints may write the same one at once so the
+    // temporary file is named after this scenario.
+    const string tempFileName = fileName + "." + mName + ".tmp";
+    bool success;
+    {
+        ofstream out( tempFileName.c_str(), ios::out | ios::binary | ios::trunc );
+        const int32_t period = aPeriod;
+        const uint8_t solved = aSolved;
+        out.write( CHECKPOINT_MAGIC, sizeof( CHECKPOINT_MAGIC ) );
+        out.write( reinterpret_cast<const char*>( &CHECKPOINT_VERSION ), sizeof( CHECKPOINT_VERSION ) );
+        out.write( reinterpret_cast<const char*>( &period ), sizeof( period ) );
+        out.write( reinterpret_cast<const char*>( &solved ), sizeof( solved ) );
+        mManageStateVars->writeState( out );
+        out.close();
+        success = !out.fail();
+    }
+    if( success ) {
+        // Renaming onto an existing file fails on Windows.
+        remove( fileName.c_str() );
+        success = rename( tempFileName.c_str(), fileName.c_str() ) == 0;
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( success ? ILogger::DEBUG : ILogger::ERROR );
+    mainLog << ( success ? "Wrote checkpoint " : "Failed to write checkpoint " ) << fileName << "." << endl;
+    return success;
+}
+
+/*!
+ * \brief Restore the solution of a period from the checkpoint written by
+ *        writeCheckpoint.
+ * \details The checkpoint is only valid for a run with the same inputs, a
+ *          checkpoint with a different number of state values is rejected
+ *          which catches most but not all changes.
+ * \pre The state variables of the period must be collected.
+ * \param aPeriod Model period to restore.
+ * \param aSolved Set to whether the period had solved when it was written.
+ * \return Whether the checkpoint was read, the state is unchanged otherwise.
+ */
+bool Scenario::readCheckpoint( const int aPeriod, bool& aSolved ) {
+    assert( mManageStateVars );
+    const string fileName = getCheckpointFileName( aPeriod );
+    ifstream in( fileName.c_str(), ios::in | ios::binary );
+    char magic[ sizeof( CHECKPOINT_MAGIC ) ];
+    uint32_t version = 0;
+    int32_t period = -1;
+    uint8_t solved = 0;
+    in.read( magic, sizeof( magic ) );
+    in.read( reinterpret_cast<char*>( &version ), sizeof( version ) );
+    in.read( reinterpret_cast<char*>( &period ), sizeof( period ) );
+    in.read( reinterpret_cast<char*>( &solved ), sizeof( solved ) );
+    const bool success = in && equal( magic, magic + sizeof( magic ), CHECKPOINT_MAGIC )
+                         && version == CHECKPOINT_VERSION && period == aPeriod
+                         && mManageStateVars->readState( in );
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( success ? ILogger::NOTICE : ILogger::WARNING );
+    if( success ) {
+        aSolved = solved != 0;
+        mainLog << "Restored period " << aPeriod << " from checkpoint " << fileName << "." << endl;
+    }
+    else {
+        mainLog << "Could not restore period " << aPeriod << " from checkpoint " << fileName
+                << ", solving it instead." << endl;
+    }
+    return success;
+}
+
 /*! \brief Perform any logging which should occur when a period begins.
 * \param aPeriod Model period.
 */
@@ -720,6 +1037,439 @@ map<string, const Curve*> Scenario::getEmissionsPriceCurves( const string& ghgNa
     return mWorld->getEmissionsPriceCurves( ghgName );
 }
 
+/*!
+ * \brief Replay the solve of a period under each of the alternative solver
+ *        configurations listed in the configuration.
+ * \details The starting state of the period is saved and each of the
+ *          semicolon separated "replay-solver-configs" files is parsed for
+ *          the solver of the period which is then run from that same starting
+ *          state, reporting the time and world calcs it took.  The solvers
+ *          and starting state are restored afterwards so that the period is
+ *          then solved as usual.  Combined with restart-period and stop-period
+ *          this allows solver configurations to be compared on a single
+ *          period without running the rest of the model.
+ * \pre The state variables of the period must be collected.
+ * \param aPeriod Model period to replay.
+ */
+void Scenario::replaySolvers( const int aPeriod ) {
+    assert( mManageStateVars );
+    const Configuration* conf = Configuration::getInstance();
+    const string configList = conf->getFile( "replay-solver-configs", "", false );
+    vector<string> configFiles;
+    boost::split( configFiles, configList, boost::is_any_of( ";" ), boost::token_compress_on );
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const bool writeReport = conf->shouldWriteFile( "solver-replay", false, false );
+    ofstream report;
+    if( writeReport ) {
+        report.open( conf->getFile( "solver-replay" ).c_str(), ios::out | ios::app );
+    }
+
+    stringstream startState( ios::in | ios::out | ios::binary );
+    mManageStateVars->writeState( startState );
+    const vector<boost::shared_ptr<Solver> > savedSolvers( mSolvers );
+    const int year = mModeltime->getper_to_yr( aPeriod );
+
+    for( vector<string>::const_iterator fileIt = configFiles.begin(); fileIt != configFiles.end(); ++fileIt ) {
+        const string configFile = boost::trim_copy( *fileIt );
+        if( configFile.empty() ) {
+            continue;
+        }
+
+        // Parsing overwrites the solvers of any periods the file sets, so clear
+        // the one of interest to tell if it was found.
+        mSolvers[ aPeriod ].reset();
+        XMLHelper<void>::parseXML( configFile, this );
+        boost::shared_ptr<Solver> solver = mSolvers[ aPeriod ];
+        mSolvers = savedSolvers;
+        if( !solver.get() ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "No solver for " << year << " found in replay configuration " << configFile << "." << endl;
+            continue;
+        }
+        solver->init();
+
+        startState.clear();
+        startState.seekg( 0 );
+        mManageStateVars->readState( startState );
+
+        const int startCalcs = mWorld->getCalcCounter()->getPeriodCount();
+        Timer replayTimer;
+        replayTimer.start();
+        const bool solved = solver->solve( aPeriod, mSolutionInfoParamParser );
+        replayTimer.stop();
+        const int worldCalcs = mWorld->getCalcCounter()->getPeriodCount() - startCalcs;
+
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Replayed " << year << " with " << configFile << ": "
+                << ( solved ? "solved" : "did not solve" ) << " in "
+                << replayTimer.getTotalTimeDifference() << " seconds and "
+                << worldCalcs << " world calcs." << endl;
+        if( writeReport ) {
+            report << "{ \"scenario\": \"" << mName << "\", \"year\": " << year
+                   << ", \"solver-config\": \"" << configFile << "\""
+                   << ", \"solved\": " << ( solved ? "true" : "false" )
+                   << ", \"seconds\": " << replayTimer.getTotalTimeDifference()
+                   << ", \"world-calcs\": " << worldCalcs << " }" << endl;
+        }
+    }
+
+    // Start the regular solve from the same state as the replays.
+    startState.clear();
+    startState.seekg( 0 );
+    mManageStateVars->readState( startState );
+}
+
+/*!
+ * \brief Race the solver of a period against the alternative solver
+ *        configurations listed in the configuration and start the regular
+ *        solve from the prices of the first to solve.
+ * \details Each solver, starting with the regular one, is run in a forked copy
+ *          of this process so they all start from the same state and run on
+ *          separate cores. The semicolon separated "race-solver-configs" files
+ *          are parsed for their solver of the period as in replaySolvers. The
+ *          first copy to solve sends back its prices and the others are
+ *          killed. The regular solve then starts from those prices so that
+ *          the state of every object is calculated in this process and should
+ *          already be within tolerance. If no copy solves this process is left
+ *          as it was. Copies write to the same logs as this process so their
+ *          output may be interleaved.
+ * \note Racing is not available on Windows or with a parallel build since the
+ *       TBB worker threads are not copied by fork.
+ * \param aPeriod Model period to solve.
+ * \return Whether one of the solvers solved the period.
+ */
+bool Scenario::raceSolvers( const int aPeriod ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+#if defined(_WIN32) || GCAM_PARALLEL_ENABLED
+    static bool warned = false;
+    if( !warned ) {
+        warned = true;
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Racing solvers is not supported by this build, solving with the regular solver only." << endl;
+    }
+    return false;
+#else
+    const string configList = Configuration::getInstance()->getFile( "race-solver-configs", "", false );
+    vector<string> configFiles;
+    boost::split( configFiles, configList, boost::is_any_of( ";" ), boost::token_compress_on );
+
+    // The regular solver is always one of the racers.
+    vector<boost::shared_ptr<Solver> > racers( 1, mSolvers[ aPeriod ] );
+    vector<string> racerNames( 1, "the regular solver" );
+    const vector<boost::shared_ptr<Solver> > savedSolvers( mSolvers );
+    for( vector<string>::const_iterator fileIt = configFiles.begin(); fileIt != configFiles.end(); ++fileIt ) {
+        const string configFile = boost::trim_copy( *fileIt );
+        if( configFile.empty() ) {
+            continue;
+        }
+        mSolvers[ aPeriod ].reset();
+        XMLHelper<void>::parseXML( configFile, this );
+        boost::shared_ptr<Solver> solver = mSolvers[ aPeriod ];
+        mSolvers = savedSolvers;
+        if( solver.get() ) {
+            solver->init();
+            racers.push_back( solver );
+            racerNames.push_back( configFile );
+        }
+    }
+    const int year = mModeltime->getper_to_yr( aPeriod );
+    if( racers.size() < 2 ) {
+        return false;
+    }
+
+    Timer raceTimer;
+    raceTimer.start();
+    vector<pid_t> pids;
+    vector<int> pipes;
+    for( size_t i = 0; i < racers.size(); ++i ) {
+        int fds[ 2 ];
+        if( pipe( fds ) != 0 ) {
+            break;
+        }
+        pid_t pid = fork();
+        if( pid == 0 ) {
+            close( fds[ 0 ] );
+            if( racers[ i ]->solve( aPeriod, mSolutionInfoParamParser ) ) {
+                const vector<double> prices = mMarketplace->getPrices( aPeriod );
+                const char* data = reinterpret_cast<const char*>( &prices[ 0 ] );
+                size_t remaining = prices.size() * sizeof( double );
+                ssize_t written;
+                while( remaining > 0 && ( written = write( fds[ 1 ], data, remaining ) ) > 0 ) {
+                    data += written;
+                    remaining -= written;
+                }
+            }
+            // Skip the destructors of objects copied from the parent process.
+            _exit( 0 );
+        }
+        close( fds[ 1 ] );
+        if( pid < 0 ) {
+            close( fds[ 0 ] );
+            break;
+        }
+        pids.push_back( pid );
+        pipes.push_back( fds[ 0 ] );
+    }
+
+    // Collect what each racer sends until one of them finishes having sent a
+    // full set of prices or all of them have finished.
+    const size_t priceBytes = mMarketplace->getPrices( aPeriod ).size() * sizeof( double );
+    vector<string> received( pipes.size() );
+    vector<bool> finished( pipes.size(), false );
+    size_t numFinished = 0;
+    int winner = -1;
+    while( winner < 0 && numFinished < pipes.size() ) {
+        fd_set readSet;
+        FD_ZERO( &readSet );
+        int maxFd = -1;
+        for( size_t i = 0; i < pipes.size(); ++i ) {
+            if( !finished[ i ] ) {
+                FD_SET( pipes[ i ], &readSet );
+                maxFd = max( maxFd, pipes[ i ] );
+            }
+        }
+        if( select( maxFd + 1, &readSet, 0, 0, 0 ) < 0 ) {
+            break;
+        }
+        for( size_t i = 0; i < pipes.size() && winner < 0; ++i ) {
+            if( finished[ i ] || !FD_ISSET( pipes[ i ], &readSet ) ) {
+                continue;
+            }
+            char buffer[ 4096 ];
+            const ssize_t numRead = read( pipes[ i ], buffer, sizeof( buffer ) );
+            if( numRead > 0 ) {
+                received[ i ].append( buffer, numRead );
+            }
+            else {
+                finished[ i ] = true;
+                ++numFinished;
+                if( received[ i ].size() == priceBytes && priceBytes > 0 ) {
+                    winner = static_cast<int>( i );
+                }
+            }
+        }
+    }
+
+    for( size_t i = 0; i < pids.size(); ++i ) {
+        kill( pids[ i ], SIGKILL );
+        int exitStatus;
+        waitpid( pids[ i ], &exitStatus, 0 );
+        close( pipes[ i ] );
+    }
+    raceTimer.stop();
+
+    if( winner < 0 ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "None of the " << pids.size() << " racing solvers solved " << year << "." << endl;
+        return false;
+    }
+    const double* prices = reinterpret_cast<const double*>( received[ winner ].data() );
+    mMarketplace->setInitialPrices( vector<double>( prices, prices + priceBytes / sizeof( double ) ), aPeriod );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Racing " << pids.size() << " solvers, " << racerNames[ winner ] << " solved " << year
+            << " first in " << raceTimer.getTotalTimeDifference() << " seconds." << endl;
+    return true;
+#endif
+}
+
+#if !defined(_WIN32) && !GCAM_PARALLEL_ENABLED
+/*!
+ * \brief Write the prices of every market to a pipe.
+ * \param aFd The write end of the pipe.
+ * \param aPrices The prices to write.
+ */
+static void writePricesToPipe( const int aFd, const vector<double>& aPrices ) {
+    const char* data = reinterpret_cast<const char*>( &aPrices[ 0 ] );
+    size_t remaining = aPrices.size() * sizeof( double );
+    ssize_t written;
+    while( remaining > 0 && ( written = write( aFd, data, remaining ) ) > 0 ) {
+        data += written;
+        remaining -= written;
+    }
+}
+
+/*!
+ * \brief Read the prices of every market from a pipe, blocking until they have
+ *        all been sent.
+ * \param aFd The read end of the pipe.
+ * \param aPrices The prices to read which must be sized to the number of markets.
+ * \return Whether all of the prices were read before the pipe was closed.
+ */
+static bool readPricesFromPipe( const int aFd, vector<double>& aPrices ) {
+    char* data = reinterpret_cast<char*>( &aPrices[ 0 ] );
+    size_t remaining = aPrices.size() * sizeof( double );
+    ssize_t numRead;
+    while( remaining > 0 && ( numRead = read( aFd, data, remaining ) ) > 0 ) {
+        data += numRead;
+        remaining -= numRead;
+    }
+    return remaining == 0 && !aPrices.empty();
+}
+#endif
+
+/*!
+ * \brief Start a speculative copy of the process which goes on to the next
+ *        period before this one is fully solved.
+ * \details The copy is forked from the state the period is about to be solved
+ *          from. It solves the period with the solution tolerances multiplied
+ *          by the "pipeline-tolerance-scale" and sends back the prices it
+ *          found, then continues through the rest of the period and solves the
+ *          next one the same way, sends back those prices as well and exits.
+ *          The copy runs on a spare core while this process solves the period
+ *          to the full tolerance, after which finishSpeculation decides whether
+ *          the next period may start from the prices of the copy.
+ * \note Speculation is not available on Windows or with a parallel build since
+ *       the TBB worker threads are not copied by fork.
+ * \param aPeriod Model period about to be solved.
+ */
+void Scenario::startSpeculation( const int aPeriod ) {
+#if defined(_WIN32) || GCAM_PARALLEL_ENABLED
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Pipelining periods is not supported by this build, solving them one after another." << endl;
+    mPipelinePeriods = false;
+#else
+    if( aPeriod + 1 >= mModeltime->getmaxper() ) {
+        return;
+    }
+    int fds[ 2 ];
+    if( pipe( fds ) != 0 ) {
+        return;
+    }
+    pid_t pid = fork();
+    if( pid == 0 ) {
+        close( fds[ 0 ] );
+        mIsSpeculativeCopy = true;
+        mSpeculationPeriod = aPeriod;
+        mSpeculationPipe = fds[ 1 ];
+        SolutionInfo::setToleranceScale( Configuration::getInstance()->getDouble( "pipeline-tolerance-scale", 10, false ) );
+        return;
+    }
+    close( fds[ 1 ] );
+    if( pid < 0 ) {
+        close( fds[ 0 ] );
+        return;
+    }
+    mSpeculationPeriod = aPeriod;
+    mSpeculationPid = pid;
+    mSpeculationPipe = fds[ 0 ];
+#endif
+}
+
+/*!
+ * \brief Start a period from the prices of the speculative copy started in the
+ *        previous period if they may be relied on.
+ * \details The prices the copy found for the previous period with the loose
+ *          tolerance are compared to those it was then solved to. If no price
+ *          moved by more than the relative "pipeline-price-threshold" this
+ *          waits for the copy to solve the period and sets its prices as the
+ *          starting point. Otherwise the period is solved from the usual
+ *          starting point. The copy is stopped in either case.
+ * \param aPeriod Model period about to be solved.
+ */
+void Scenario::finishSpeculation( const int aPeriod ) {
+#if !defined(_WIN32) && !GCAM_PARALLEL_ENABLED
+    if( mSpeculationPid < 0 ) {
+        return;
+    }
+    if( mSpeculationPeriod == aPeriod - 1 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::NOTICE );
+        const int year = mModeltime->getper_to_yr( aPeriod );
+        const vector<double> solvedPrices = mMarketplace->getPrices( aPeriod - 1 );
+        vector<double> approxPrices( solvedPrices.size() );
+        if( readPricesFromPipe( mSpeculationPipe, approxPrices ) ) {
+            double maxChange = 0;
+            for( size_t i = 0; i < solvedPrices.size(); ++i ) {
+                const double scale = max( fabs( solvedPrices[ i ] ), fabs( approxPrices[ i ] ) );
+                if( scale > util::getSmallNumber() ) {
+                    maxChange = max( maxChange, fabs( solvedPrices[ i ] - approxPrices[ i ] ) / scale );
+                }
+            }
+            vector<double> nextPrices( solvedPrices.size() );
+            if( maxChange > Configuration::getInstance()->getDouble( "pipeline-price-threshold", 0.01, false ) ) {
+                mainLog << "Discarding the speculative start of " << year << " since prices moved by up to "
+                        << maxChange << " while finishing the previous period." << endl;
+            }
+            else if( readPricesFromPipe( mSpeculationPipe, nextPrices ) ) {
+                mMarketplace->setInitialPrices( nextPrices, aPeriod );
+                mainLog << "Starting " << year << " from the prices of its speculative start." << endl;
+            }
+            else {
+                mainLog << "The speculative start of " << year << " did not solve." << endl;
+            }
+        }
+    }
+    stopSpeculation();
+#endif
+}
+
+/*!
+ * \brief Stop the speculative copy of the process, if any.
+ */
+void Scenario::stopSpeculation() {
+#if !defined(_WIN32) && !GCAM_PARALLEL_ENABLED
+    if( mIsSpeculativeCopy ) {
+        // Skip the destructors of objects copied from the original process.
+        _exit( 0 );
+    }
+    if( mSpeculationPid < 0 ) {
+        return;
+    }
+    kill( mSpeculationPid, SIGKILL );
+    int exitStatus;
+    waitpid( mSpeculationPid, &exitStatus, 0 );
+    close( mSpeculationPipe );
+    mSpeculationPeriod = -1;
+    mSpeculationPid = -1;
+    mSpeculationPipe = -1;
+#endif
+}
+
+/*!
+ * \brief Send the prices a speculative copy found for a period back to the
+ *        original process.
+ * \details The prices of the period the copy was started from are always sent
+ *          so that they may be compared. Those of the next period are only
+ *          sent if it solved, after which the copy exits.
+ * \param aPeriod Model period which was solved.
+ * \param aSolved Whether the period solved.
+ */
+void Scenario::sendSpeculativePrices( const int aPeriod, const bool aSolved ) {
+#if !defined(_WIN32) && !GCAM_PARALLEL_ENABLED
+    if( aPeriod == mSpeculationPeriod || aSolved ) {
+        writePricesToPipe( mSpeculationPipe, mMarketplace->getPrices( aPeriod ) );
+    }
+    if( aPeriod > mSpeculationPeriod ) {
+        stopSpeculation();
+    }
+#endif
+}
+
+/*!
+ * \brief Print an estimate of the memory retained by each class of object to
+ *        the main log.
+ * \details In addition to the Data found by MemoryReport the STATE slots of
+ *          the current period, if any, and the global flow graph are included.
+ * \param aWhen A description of the point in the run the report was made.
+ */
+void Scenario::reportMemoryUsage( const string& aWhen ) {
+    MemoryReport memoryReport;
+    memoryReport.collect( this );
+    if( mManageStateVars ) {
+        memoryReport.addUsage( "STATE slots", mManageStateVars->getNumAllocatedStates(),
+                               mManageStateVars->getStateBytes() );
+    }
+#if GCAM_PARALLEL_ENABLED
+    if( mWorld && mWorld->getGlobalFlowGraph() ) {
+        memoryReport.addUsage( "TBB flow graph", 1, mWorld->getGlobalFlowGraph()->getMemoryEstimate() );
+    }
+#endif
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    memoryReport.print( mainLog, aWhen );
+}
+
 /*! \brief Solve the marketplace using the Solver for a given period. 
 * \details The solve method calls the solve method of the instance of the Solver
 *          object that was created in the constructor. This method then checks
@@ -730,20 +1480,112 @@ map<string, const Curve*> Scenario::getEmissionsPriceCurves( const string& ghgNa
 */
 
 bool Scenario::solve( const int period ){
+    GCAM_PROFILE_SCOPE( "solve period" );
     /*! \pre The solver must be instantiated. */
     assert( mSolvers[ period ].get() );
 
     // Solve the marketplace. If the return code is false than the model did not
     // solve for the period. Add the period to the scenario list of unsolved
     // periods. 
-    const bool success = mSolvers[ period ]->solve( period, mSolutionInfoParamParser );
+    SolverTrace::getInstance().startPeriod( period );
+    SolverTelemetry::getInstance().startPeriod( period, mModeltime->getper_to_yr( period ) );
+    const bool recordPerformance = Configuration::getInstance()->shouldWriteFile( "period-performance", false, false );
+    const Timer& jacobianTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::JACOBIAN );
+    const double startJacobianSeconds = jacobianTimer.getTotalTimeDifference();
+    const int startWorldCalcs = mWorld->getCalcCounter()->getPeriodCount();
+    Timer periodTimer;
+    periodTimer.start();
+
+    // Choose the solver from the profile of previous runs if one is kept.
+    boost::shared_ptr<Solver> solver = mSolvers[ period ];
+    SolverProfile& solverProfile = SolverProfile::getInstance();
+    size_t profileAlternative = 0;
+    if( solverProfile.isEnabled() ) {
+        profileAlternative = solverProfile.chooseAlternative( mModeltime->getper_to_yr( period ) );
+        if( profileAlternative > 0 ) {
+            // Parsing overwrites the solvers of any periods the file sets, so
+            // clear the one of interest to tell if it was found.
+            const vector<boost::shared_ptr<Solver> > savedSolvers( mSolvers );
+            const string& configFile = solverProfile.getAlternatives()[ profileAlternative ];
+            mSolvers[ period ].reset();
+            XMLHelper<void>::parseXML( configFile, this );
+            boost::shared_ptr<Solver> profileSolver = mSolvers[ period ];
+            mSolvers = savedSolvers;
+            if( profileSolver.get() ) {
+                profileSolver->init();
+                solver = profileSolver;
+            }
+            else {
+                ILogger& mainLog = ILogger::getLogger( "main_log" );
+                mainLog.setLevel( ILogger::WARNING );
+                mainLog << "No solver for " << mModeltime->getper_to_yr( period )
+                        << " found in profile configuration " << configFile << "." << endl;
+                profileAlternative = 0;
+            }
+        }
+    }
+
+    const bool success = solver->solve( period, mSolutionInfoParamParser );
+    if( solverProfile.isEnabled() ) {
+        solverProfile.record( mModeltime->getper_to_yr( period ), profileAlternative,
+                              mWorld->getCalcCounter()->getPeriodCount() - startWorldCalcs, success );
+    }
     if( !success ) {
         mUnsolvedPeriods.push_back( period );
+        SolverTrace::getInstance().write( mName, mModeltime->getper_to_yr( period ) );
+    }
+
+    if( recordPerformance ) {
+        periodTimer.stop();
+        PeriodPerformance performance;
+        performance.mYear = mModeltime->getper_to_yr( period );
+        performance.mSolved = success;
+        performance.mSeconds = periodTimer.getTotalTimeDifference();
+        performance.mWorldCalcs = mWorld->getCalcCounter()->getPeriodCount() - startWorldCalcs;
+        performance.mJacobianSeconds = jacobianTimer.getTotalTimeDifference() - startJacobianSeconds;
+        double residentMemory;
+        StartupProfile::getMemoryUsage( residentMemory, performance.mPeakResidentMemory );
+#if GCAM_USE_PERF_COUNTERS
+        performance.mCounters = periodTimer.getCounters();
+#endif
+        mPeriodPerformance.push_back( performance );
     }
     
     return success;
 }
 
+/*!
+ * \brief Write the performance of each period solved in the current run to a
+ *        JSON file.
+ * \details The file contains an array with an object for each period giving
+ *          the year, whether it solved, the solve time, the number of world
+ *          calcs, the Jacobian time and the peak resident memory so that
+ *          scripts can compare the performance of runs of the same inputs.
+ * \param aFileName The name of the file to write.
+ * \return Whether the file was written.
+ */
+bool Scenario::writePeriodPerformance( const string& aFileName ) const {
+    ofstream out( aFileName.c_str() );
+    out << "[" << endl;
+    for( vector<PeriodPerformance>::const_iterator it = mPeriodPerformance.begin(); it != mPeriodPerformance.end(); ++it ) {
+        out << "  { \"year\": " << it->mYear
+            << ", \"solved\": " << ( it->mSolved ? "true" : "false" )
+            << ", \"seconds\": " << it->mSeconds
+            << ", \"world-calcs\": " << it->mWorldCalcs
+            << ", \"jacobian-seconds\": " << it->mJacobianSeconds
+            << ", \"peak-resident-mb\": " << it->mPeakResidentMemory;
+#if GCAM_USE_PERF_COUNTERS
+        out << ", \"cycles\": " << it->mCounters.mCycles
+            << ", \"instructions\": " << it->mCounters.mInstructions
+            << ", \"cache-misses\": " << it->mCounters.mCacheMisses
+            << ", \"branch-misses\": " << it->mCounters.mBranchMisses;
+#endif
+        out << " }" << ( it + 1 != mPeriodPerformance.end() ? "," : "" ) << endl;
+    }
+    out << "]" << endl;
+    return static_cast<bool>( out );
+}
+
 //! Output Scenario members to a CSV file.
 // I don't really like this function being hard-coded to an output file, but its very hard-coded.
 void Scenario::writeOutputFiles() const {
@@ -786,6 +1628,10 @@ void Scenario::writeOutputFiles() const {
         }
         outFile << "Date,Notes" << endl;
 
+        // Collect the rows so that they are written in large blocks.
+        CSVOutputBuffer rows( outFile );
+        CSVOutputBuffer::Scope rowsScope( rows );
+
         // Write global market info to file
         mMarketplace->csvOutputFile( "global" );
 
@@ -865,12 +1711,44 @@ void Scenario::initSolvers() {
 
 /*!
  * \brief Get the periods that did not solve in the last call to run.
+ * \details This includes the periods which were not recalculated by a single
+ *          period run because they were still valid.
  * \return A vector of model periods that did not solve.
  */
 const vector<int>& Scenario::getUnsolvedPeriods() const {
     return mUnsolvedPeriods;
 }
 
+/*!
+ * \brief Provide the prices the solver should start from the next time a
+ *        period is calculated.
+ * \details The prices replace those forecast from the previous period for the
+ *          markets which will be solved and are only used once.
+ * \param aPeriod The model period.
+ * \param aPrices The prices in the order returned by Marketplace::getPrices.
+ */
+void Scenario::setInitialPrices( const int aPeriod, const vector<double>& aPrices ) {
+    mInitialPrices[ aPeriod ] = aPrices;
+}
+
+/*!
+ * \brief Share the solution of the periods before a branch period with other
+ *        scenarios through checkpoints.
+ * \details The periods before aBranchPeriod are restored from the checkpoints
+ *          named aCheckpointName if they exist and are otherwise solved and
+ *          written to them. Only those periods are written so that the
+ *          checkpoints never hold results particular to this scenario. The
+ *          caller is responsible for only sharing checkpoints between
+ *          scenarios which are identical before the branch period.
+ * \param aCheckpointName The name of the shared checkpoints.
+ * \param aBranchPeriod The first period which may differ from the other
+ *        scenarios.
+ */
+void Scenario::setSharedCheckpoints( const string& aCheckpointName, const int aBranchPeriod ) {
+    mSharedCheckpointName = aCheckpointName;
+    mBranchPeriod = aBranchPeriod;
+}
+
 /*!
  * \brief Reset the flag which indicates if a model period should be
  *        recalculated to force it to do so the next time run is called.
@@ -86,7 +86,7 @@ void SectorActivity::setPrices( const int aPeriod ) {
     static const bool calibrationActive = Configuration::getInstance()->getBool( "CalibrationActive" );
     if( calibrationActive && calibrationPeriod ) {
         CalibrateShareWeightVisitor calibrator( mRegionName, mGDP );
-        mSector->accept( &calibrator, aPeriod );
+        calibrator.calibrateSector( mSector, aPeriod );
     }
     mSector->calcFinalSupplyPrice( mGDP, aPeriod );
 }
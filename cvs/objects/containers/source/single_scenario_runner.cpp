@@ -40,10 +40,18 @@
 
 #include "util/base/include/definitions.h"
 #include <cassert>
+#include <cstdio>
 #include <xercesc/dom/DOMNode.hpp>
 #include "containers/include/single_scenario_runner.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/xml_helper.h"
+#include "util/base/include/xml_stream_parser.h"
+#include "util/base/include/input_snapshot.h"
+#include "util/base/include/input_manifest.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/mapped_data_table.h"
+#include "util/base/include/startup_profile.h"
+#include "util/base/include/concurrent_xml_parser.h"
 #include "util/base/include/configuration.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/configuration.h"
@@ -51,6 +59,8 @@
 #include "util/logger/include/ilogger.h"
 #include "util/logger/include/logger_factory.h"
 #include "reporting/include/xml_db_outputter.h"
+#include "reporting/include/arrow_outputter.h"
+#include "reporting/include/query_summary_writer.h"
 
 using namespace std;
 using namespace xercesc;
@@ -64,9 +74,12 @@ extern void closeDB();
 extern void openDB();
 extern void createDBout();
 
+auto_ptr<Scenario> SingleScenarioRunner::sSharedScenario;
+
 /*! \brief Constructor */
 SingleScenarioRunner::SingleScenarioRunner(){
     mXMLDBOutputter = 0;
+    mRestartPeriod = 0;
 }
 
 //! Destructor.
@@ -100,49 +113,47 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
         mainLog << "Early warning Java checks failed and database output was requested" << endl;
         abort();
     }
-    // Ensure that a new scenario is created for each run.
-    mScenario.reset( new Scenario );
-
-    // Set the global scenario pointer.
-    // TODO: Remove global scenario pointer.
-    scenario = mScenario.get();
 
-    // Parse the input file.
-    bool success =
-        XMLHelper<void>::parseXML( conf->getFile( "xmlInputFileName" ),
-                                   mScenario.get() );
-    
-    // Check if parsing succeeded.
-    if( !success ){
-        return false;
+    list<string> inputFiles;
+    const bool isShared = sSharedScenario.get() != 0;
+    if( isShared ) {
+        // The base input file and the configured scenario components were
+        // already parsed before the batch runner forked this process.
+        mScenario.reset( sSharedScenario.release() );
+    }
+    else {
+        // Ensure that a new scenario is created for each run.
+        mScenario.reset( new Scenario );
+        inputFiles = conf->getScenarioComponents();
+        inputFiles.push_front( conf->getFile( "xmlInputFileName" ) );
     }
 
-    // Fetch the listing of Scenario Components.
-    list<string> scenComponents = conf->getScenarioComponents();
+    // Set the global scenario pointer.  Only one scenario may be active in a
+    // process, see the note at the definition of the global in main.cpp.
+    scenario = mScenario.get();
 
     // Add on any scenario components that were passed in.
     for( list<string>::const_iterator curr = aScenComponents.begin();
 		curr != aScenComponents.end(); ++curr )
 	{
-        scenComponents.push_back( *curr );
+        inputFiles.push_back( *curr );
     }
-    
-    // Iterate over the vector.
-    typedef list<string>::const_iterator ScenCompIter;
-    ILogger& mainLog = ILogger::getLogger( "main_log" );
-    for( ScenCompIter currComp = scenComponents.begin();
-		 currComp != scenComponents.end(); ++currComp )
-	{
-        mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Parsing " << *currComp << " scenario component." << endl;
-        success = XMLHelper<void>::parseXML( *currComp, mScenario.get() );
-        
-        // Check if parsing succeeded.
-        if( !success ){
-            return false;
-        }
+
+    // Record every input file of the scenario, including those parsed before
+    // it was shared.
+    mInputFiles = conf->getScenarioComponents();
+    mInputFiles.push_front( conf->getFile( "xmlInputFileName" ) );
+    mInputFiles.insert( mInputFiles.end(), aScenComponents.begin(), aScenComponents.end() );
+
+    // The snapshot covers the base input file so it can not be used for the
+    // remaining components of a shared scenario.
+    if( !parseInputFiles( mScenario.get(), inputFiles, !isShared ) ) {
+        return false;
     }
     
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    StartupProfile& profile = StartupProfile::getInstance();
+
     // Override scenario name from data file with that from configuration file
     const string overrideName = conf->getString( "scenarioName" ) + aName;
     if ( !overrideName.empty() ) {
@@ -160,9 +171,181 @@ bool SingleScenarioRunner::setupScenarios( Timer& timer,
     mainLog.setLevel( ILogger::DEBUG );
     timer.print( mainLog, "XML Readin Time:" );
 
+    // Objects look up their columns of the data table during completeInit so
+    // it must be mapped, or set to collect a new table, before then.
+    const string dataTableFile = conf->getFile( "mapped-data-table", "", false );
+    const bool writeDataTable = !dataTableFile.empty() && conf->shouldWriteFile( "mapped-data-table", false, false );
+    MappedDataTable& dataTable = MappedDataTable::getInstance();
+    if( writeDataTable ) {
+        dataTable.setCollecting( true );
+    }
+    else if( !dataTableFile.empty() && !dataTable.isOpen() ) {
+        dataTable.open( dataTableFile );
+    }
+
     // Finish initialization.
     if( mScenario.get() ){
+        profile.startPhase( "completeInit" );
         mScenario->completeInit();
+        profile.endPhase( "completeInit" );
+    }
+
+    if( writeDataTable ) {
+        dataTable.write( dataTableFile );
+        dataTable.setCollecting( false );
+    }
+
+    // Restore the periods which are unaffected by any changes to the input
+    // files since the last run.
+    mRestartPeriod = conf->getInt( "restart-period", 0 );
+    if( isIncrementalRerun() ) {
+        mRestartPeriod = InputManifest::getNumUnchangedPeriods( getInputManifestFileName(), mInputFiles,
+                                                                mScenario->getModeltime() );
+        // The checkpoints will no longer match the manifest once this run
+        // starts to overwrite them.
+        remove( getInputManifestFileName().c_str() );
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Whether only the periods affected by changes to the input files
+ *        since the last run are solved.
+ * \return Whether incremental reruns are enabled and checkpoints are written.
+ */
+bool SingleScenarioRunner::isIncrementalRerun() const {
+    const Configuration* conf = Configuration::getInstance();
+    return conf->getBool( "incremental-rerun", false, false )
+        && conf->shouldWriteFile( "checkpoint-location", false, false );
+}
+
+/*!
+ * \brief Get the name of the manifest of the input files of the last run of
+ *        the scenario.
+ * \return The manifest file name in the checkpoint-location directory.
+ */
+string SingleScenarioRunner::getInputManifestFileName() const {
+    return Configuration::getInstance()->getFile( "checkpoint-location" ) + "/"
+           + mScenario->getName() + ".inputs";
+}
+
+/*!
+ * \brief Parse the base input file and the scenario components from the
+ *        configuration into a scenario which the next call to setupScenarios
+ *        in this process, or in any process forked from it, continues from.
+ * \details This allows the batch runner to parse the inputs each batch
+ *          scenario shares only once and fork a process for each batch
+ *          scenario which then only parses its own components. The scenario
+ *          can not be shared past completeInit since the remaining components
+ *          must be parsed before it. Parsing does not start any worker threads
+ *          which would be lost when forking.
+ * \param aTimer The timer used to print out the parsing time.
+ * \return Whether parsing was successful.
+ */
+bool SingleScenarioRunner::prepareSharedScenario( Timer& aTimer ) {
+    const Configuration* conf = Configuration::getInstance();
+    sSharedScenario.reset( new Scenario );
+    scenario = sSharedScenario.get();
+
+    list<string> inputFiles = conf->getScenarioComponents();
+    inputFiles.push_front( conf->getFile( "xmlInputFileName" ) );
+    const bool success = parseInputFiles( sSharedScenario.get(), inputFiles, true );
+    if( !success ) {
+        sSharedScenario.reset();
+    }
+    scenario = 0;
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::DEBUG );
+    aTimer.print( mainLog, "Shared XML Readin Time:" );
+    return success;
+}
+
+/*!
+ * \brief Delete the scenario prepared by prepareSharedScenario if it has not
+ *        been used.
+ */
+void SingleScenarioRunner::releaseSharedScenario() {
+    sSharedScenario.reset();
+}
+
+/*!
+ * \brief Parse a list of input files into a scenario in order.
+ * \details The files are read from the input snapshot instead if one is
+ *          configured, allowed and up to date, and the snapshot is written
+ *          after parsing if requested.  If "batch-cache-parsed-inputs" is set
+ *          each file is parsed through the in memory InputSnapshot cache so
+ *          that later scenarios of a batch do not read it again.
+ * \param aScenario The scenario to parse into.
+ * \param aInputFiles The files to parse in the order they must be parsed.
+ * \param aUseSnapshot Whether the input snapshot may be used for these files.
+ * \return Whether parsing was successful.
+ */
+bool SingleScenarioRunner::parseInputFiles( Scenario* aScenario,
+                                            const list<string>& aInputFiles,
+                                            const bool aUseSnapshot )
+{
+    const Configuration* conf = Configuration::getInstance();
+    const string snapshotFile = aUseSnapshot ? conf->getFile( "input-snapshot", "", false ) : "";
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    StartupProfile& profile = StartupProfile::getInstance();
+    if( !snapshotFile.empty() && InputSnapshot::isCurrent( snapshotFile, aInputFiles ) ) {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Parsing input snapshot " << snapshotFile << "." << endl;
+        profile.startPhase( "parse " + snapshotFile );
+        const bool success = InputSnapshot::read( snapshotFile, aScenario );
+        profile.endPhase( "parse " + snapshotFile );
+        return success;
+    }
+
+    if( conf->getBool( "batch-cache-parsed-inputs", false ) ) {
+        typedef list<string>::const_iterator ScenCompIter;
+        for( ScenCompIter currComp = aInputFiles.begin();
+             currComp != aInputFiles.end(); ++currComp )
+        {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Parsing " << *currComp << "." << endl;
+            profile.startPhase( "parse " + *currComp );
+            const bool success = InputSnapshot::parseCached( *currComp, aScenario );
+            profile.endPhase( "parse " + *currComp );
+
+            if( !success ){
+                return false;
+            }
+        }
+    }
+    else if( conf->getBool( "parallel-xml-parse", false ) && !conf->getBool( "stream-xml-input", false ) ) {
+        // The files are read concurrently so they can only be timed together.
+        profile.startPhase( "parse input files" );
+        const bool success = ConcurrentXMLParser::parseXMLFiles( aInputFiles, aScenario );
+        profile.endPhase( "parse input files" );
+        if( !success ) {
+            return false;
+        }
+    }
+    else {
+        typedef list<string>::const_iterator ScenCompIter;
+        for( ScenCompIter currComp = aInputFiles.begin();
+             currComp != aInputFiles.end(); ++currComp )
+        {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Parsing " << *currComp << "." << endl;
+            profile.startPhase( "parse " + *currComp );
+            const bool success = XMLStreamParser::parseInput( *currComp, aScenario );
+            profile.endPhase( "parse " + *currComp );
+        
+            // Check if parsing succeeded.
+            if( !success ){
+                return false;
+            }
+        }
+    }
+
+    if( !snapshotFile.empty() && conf->shouldWriteFile( "input-snapshot", false, false ) ) {
+        profile.startPhase( "write " + snapshotFile );
+        InputSnapshot::write( snapshotFile, aInputFiles );
+        profile.endPhase( "write " + snapshotFile );
     }
     return true;
 }
@@ -188,11 +371,22 @@ bool SingleScenarioRunner::runScenarios( const int aSinglePeriod,
 	if( mScenario.get() ){
 		// Perform the initial run of the scenario.
         success = mScenario->run( aSinglePeriod, aPrintDebugging,
-                                  mScenario->getName() );
+                                  mScenario->getName(), mRestartPeriod );
+
+        // Record the inputs the checkpoints were calculated from.
+        if( isIncrementalRerun() ) {
+            InputManifest::write( getInputManifestFileName(), mInputFiles,
+                                  aSinglePeriod == Scenario::RUN_ALL_PERIODS
+                                  ? mScenario->getModeltime()->getmaxper() : aSinglePeriod + 1 );
+        }
 
         // Compute model run time.
         mainLog.setLevel( ILogger::DEBUG );
         aTimer.print( mainLog, "Data Readin & Initial Model Run Time:" );
+
+        // The state variables are first collected during the run so the
+        // startup profile is only complete now.
+        StartupProfile::getInstance().report();
 	}
 	else {
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -255,6 +449,33 @@ void SingleScenarioRunner::printOutput( Timer& aTimer, const bool aCloseDB ) con
         // Print the output.
         mXMLDBOutputter->finish();
     }
+
+    // Write the results to a columnar Arrow file which avoids the JVM.  In
+    // incremental mode each period was already written as it solved.
+    if( Configuration::getInstance()->shouldWriteFile( "arrow-output-location", false, false )
+        && !Configuration::getInstance()->getBool( "incremental-output", false ) )
+    {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Starting output to Arrow file." << endl;
+        ArrowOutputter::writeScenario( mScenario.get(),
+                                       Configuration::getInstance()->getFile( "arrow-output-location" ) );
+    }
+
+    // Total the standard queries directly from the model in memory so that
+    // the usual results are available without querying the XML database.
+    const string summaryQueryFile = Configuration::getInstance()->getFile( "summary-query-file", "", false );
+    if( !summaryQueryFile.empty() && Configuration::getInstance()->shouldWriteFile( "summary-query-output", false, false ) ) {
+        QuerySummaryWriter summaryWriter;
+        if( XMLHelper<void>::parseXML( summaryQueryFile, &summaryWriter ) ) {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Writing " << summaryWriter.getNumQueries() << " summary queries." << endl;
+            summaryWriter.write( mScenario.get(), Configuration::getInstance()->getFile( "summary-query-output" ) );
+        }
+        else {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not read the summary queries " << summaryQueryFile << "." << endl;
+        }
+    }
     writeTimer.stop();
     
     // Print the timestamps.
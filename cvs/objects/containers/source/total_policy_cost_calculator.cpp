@@ -42,6 +42,16 @@
 #include <cassert>
 #include <vector>
 #include <string>
+#include <fstream>
+#include <cstdio>
+#include <limits>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
 #include "containers/include/scenario.h"
 #include "containers/include/world.h"
 #include "util/base/include/util.h"
@@ -60,10 +70,125 @@
 #include "containers/include/single_scenario_runner.h"
 #include "policy/include/policy_ghg.h"
 #include "reporting/include/xml_db_outputter.h"
+#include "util/base/include/iparsable.h"
 
 using namespace std;
 using namespace xercesc;
 
+namespace {
+    /*!
+     * \brief Parses the emissions curves of a single trial written by
+     *        TotalPolicyCostCalculator::writeTrial.
+     * \details The header of the file, which precedes the curves, must match
+     *          the trial and run being read.  Otherwise the file is left from
+     *          another run, or an earlier run of the same scenario, and parsing
+     *          stops before any curves are read.
+     */
+    class TrialParser : public IParsable {
+    public:
+        TrialParser( map<string, const Curve*>& aQuantityCurves,
+                     map<string, const Curve*>& aPriceCurves,
+                     const unsigned int aPoint,
+                     const unsigned int aNumPoints,
+                     const string& aScenarioName,
+                     const string& aRunID ):
+        mQuantityCurves( aQuantityCurves ),
+        mPriceCurves( aPriceCurves ),
+        mPoint( aPoint ),
+        mNumPoints( aNumPoints ),
+        mScenarioName( aScenarioName ),
+        mRunID( aRunID ),
+        mIsStale( false )
+        {
+        }
+
+        virtual bool XMLParse( const DOMNode* aNode ) {
+            // The number of header elements which matched.
+            unsigned int numMatched = 0;
+            const unsigned int NUM_HEADER_ELEMENTS = 3;
+            if( XMLHelper<string>::getAttr( aNode, "name" ) != util::toString( mPoint ) ) {
+                mIsStale = true;
+                return false;
+            }
+            DOMNodeList* nodeList = aNode->getChildNodes();
+            for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+                const DOMNode* curr = nodeList->item( i );
+                const string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+                if( nodeName == XMLHelper<void>::text() ) {
+                    continue;
+                }
+                else if( nodeName == "scenario" || nodeName == "run-id" || nodeName == "num-points" ) {
+                    const bool matches = nodeName == "scenario" ? XMLHelper<string>::getValue( curr ) == mScenarioName
+                        : nodeName == "run-id" ? XMLHelper<string>::getValue( curr ) == mRunID
+                        : XMLHelper<unsigned int>::getValue( curr ) == mNumPoints;
+                    if( !matches ) {
+                        mIsStale = true;
+                        return false;
+                    }
+                    ++numMatched;
+                }
+                else if( numMatched != NUM_HEADER_ELEMENTS ) {
+                    // The curves were reached without a complete header.
+                    mIsStale = true;
+                    return false;
+                }
+                else if( nodeName == "emissions-quantity" || nodeName == "emissions-price" ) {
+                    map<string, const Curve*>& curves = nodeName == "emissions-quantity" ?
+                        mQuantityCurves : mPriceCurves;
+                    const string region = XMLHelper<string>::getAttr( curr, "name" );
+                    DOMNodeList* curveNodes = curr->getChildNodes();
+                    for( unsigned int j = 0; j < curveNodes->getLength(); ++j ) {
+                        const DOMNode* curveNode = curveNodes->item( j );
+                        if( XMLHelper<string>::safeTranscode( curveNode->getNodeName() ) != Curve::getXMLNameStatic() ) {
+                            continue;
+                        }
+                        Curve* curve = Curve::getCurve( XMLHelper<string>::getAttr( curveNode, "type" ) );
+                        if( !curve ) {
+                            return false;
+                        }
+                        curve->XMLParse( curveNode );
+                        delete curves[ region ];
+                        curves[ region ] = curve;
+                    }
+                }
+                else {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        /*!
+         * \brief Whether parsing stopped because the header did not match.
+         * \return Whether the file is left from another run.
+         */
+        bool isStale() const {
+            return mIsStale;
+        }
+    private:
+        //! The emissions quantity curves by region.
+        map<string, const Curve*>& mQuantityCurves;
+
+        //! The emissions price curves by region.
+        map<string, const Curve*>& mPriceCurves;
+
+        //! The trial number the file must contain.
+        const unsigned int mPoint;
+
+        //! The number of trials of the run the file must be from.
+        const unsigned int mNumPoints;
+
+        //! The name of the scenario the file must be from.
+        const string mScenarioName;
+
+        //! The run identifier the file must be from.
+        const string mRunID;
+
+        //! Whether the header did not match.
+        bool mIsStale;
+    };
+}
+
 /*! \brief Constructor.
 * \param aSingleScenario The single scenario runner.
 */
@@ -78,6 +203,22 @@ TotalPolicyCostCalculator::TotalPolicyCostCalculator( SingleScenarioRunner* aSin
     const Configuration* conf = Configuration::getInstance();
     mGHGName = conf->getString( "AbatedGasForCostCurves", "CO2" );
     mNumPoints = conf->getInt( "numPointsForCO2CostCurve", 5 );
+    mNumWorkers = max( conf->getInt( "cost-curve-workers", 1, false ), 1 );
+    mWorker = conf->getInt( "cost-curve-worker", 0, false );
+    mRunID = conf->getString( "cost-curve-run-id", "", false );
+    if( mNumWorkers > 1 && !conf->shouldWriteFile( "cost-curve-points", false, false ) ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The cost curve trials can not be distributed without a cost-curve-points"
+                << " location, running all trials." << endl;
+        mNumWorkers = 1;
+    }
+    if( mWorker >= mNumWorkers ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Invalid cost curve worker " << mWorker << ", running as worker 0." << endl;
+        mWorker = 0;
+    }
 }
 
 //! Destructor. Deallocated memory for all the curves created. 
@@ -124,16 +265,41 @@ bool TotalPolicyCostCalculator::calculateAbatementCostCurve() {
         return true;
     }
 
+    // Place the trials adaptively if requested, the trials can then not be
+    // distributed over workers as each depends on the ones before it.
+    const bool useAdaptivePoints = Configuration::getInstance()->getBool( "adaptive-cost-curve", false, false );
+    if( useAdaptivePoints && mNumWorkers > 1 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Adaptive cost curve points can not be distributed over workers,"
+                << " using evenly spaced points." << endl;
+    }
+
     // Set the size of the emissions curve vectors to the number of trials plus 1 for the base.
-    mEmissionsQCurves.resize( mNumPoints + 1 );
-    mEmissionsTCurves.resize( mNumPoints + 1 );
+    const unsigned int numInitialPoints = useAdaptivePoints && mNumWorkers == 1 ? 0 : mNumPoints;
+    mEmissionsQCurves.resize( numInitialPoints + 1 );
+    mEmissionsTCurves.resize( numInitialPoints + 1 );
 
     // Get prices and emissions for the primary scenario run.
-    mEmissionsQCurves[ mNumPoints ] = mSingleScenario->getInternalScenario()->getEmissionsQuantityCurves( mGHGName );
-    mEmissionsTCurves[ mNumPoints ] = mSingleScenario->getInternalScenario()->getEmissionsPriceCurves( mGHGName );
+    mEmissionsQCurves[ numInitialPoints ] = mSingleScenario->getInternalScenario()->getEmissionsQuantityCurves( mGHGName );
+    mEmissionsTCurves[ numInitialPoints ] = mSingleScenario->getInternalScenario()->getEmissionsPriceCurves( mGHGName );
     
     // Run the trials and store the cost curves.
-    bool success = runTrials();
+    bool success = numInitialPoints == 0 ? runAdaptiveTrials() : runTrials();
+
+    // Only the first worker assembles the cost curves once the trials of all
+    // others are available.
+    if( mNumWorkers > 1 ) {
+        if( mWorker != 0 ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Cost curve trials of worker " << mWorker << " are complete." << endl;
+            return success;
+        }
+        if( !readTrials() ) {
+            return false;
+        }
+    }
     
     // Create a cost curve for each period and region.
     createCostCurvesByPeriod();
@@ -156,10 +322,6 @@ bool TotalPolicyCostCalculator::calculateAbatementCostCurve() {
 * \author Josh Lurz
 */
 bool TotalPolicyCostCalculator::runTrials(){
-    // Get the number of max periods.
-    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
-    const int maxPeriod = modeltime->getmaxper();
-
     bool success = true;
     const static bool usingRestartPeriod = Configuration::getInstance()->getInt(
         "restart-period", -1 ) != -1;
@@ -167,42 +329,28 @@ bool TotalPolicyCostCalculator::runTrials(){
     if( !usingRestartPeriod ) {
         mSingleScenario->getInternalScenario()->getMarketplace()->store_prices_for_cost_calculation();
     }
+    // Remove any files left by an earlier run so that they can not be mistaken
+    // for the trials of this one.
+    if( mNumWorkers > 1 ) {
+        removeTrialFiles();
+    }
     // Loop through for each point.
     for( int currPoint = mNumPoints - 1; currPoint >= 0; currPoint-- ){
-        // Determine the fraction of the full tax this tax will be.
-        const double fraction = static_cast<double>( currPoint ) / static_cast<double>( mNumPoints );
-        // Iterate through the regions to set different taxes for each if necessary.
-        // Currently this will set the same for all of them.
-        for( CRegionCurvesIterator rIter = mEmissionsTCurves[ mNumPoints ].begin(); rIter != mEmissionsTCurves[ mNumPoints ].end(); ++rIter ){
-            // Vector which will contain taxes for this trial.
-            vector<double> currTaxes( maxPeriod );
-
-            // Set the tax for each year. 
-            for( int per = 0; per < maxPeriod; per++ ){
-                const int year = modeltime->getper_to_yr( per );
-                double origTax = rIter->second->getY( year );
-                currTaxes[ per ] = origTax == Marketplace::NO_MARKET_PRICE ? Marketplace::NO_MARKET_PRICE :
-                    origTax * fraction;
-            }
-            // Set the fixed taxes into the world.
-            GHGPolicy tax( mGHGName, rIter->first, currTaxes );
-            mSingleScenario->getInternalScenario()->setTax( &tax );
+        // Skip the trials run by other workers.
+        if( currPoint % mNumWorkers != mWorker ) {
+            continue;
         }
 
-        // Create an ending for the output files using the run number.
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::NOTICE );
-        mainLog << "Starting cost curve point run number " << currPoint << "." << endl;
-
-        // Run the scenario with the add-on extension to the output file names
-        // as the point number. This allows the output file to be named debug +
-        // point number.
-        success &= mSingleScenario->getInternalScenario()->run( Scenario::RUN_ALL_PERIODS, true,
-                                                                util::toString( currPoint ) );
+        // Determine the fraction of the full tax this tax will be.
+        const double fraction = static_cast<double>( currPoint ) / static_cast<double>( mNumPoints );
+        success &= runTrial( fraction, util::toString( currPoint ) );
 
         // Save information.
         mEmissionsQCurves[ currPoint ] = mSingleScenario->getInternalScenario()->getEmissionsQuantityCurves( mGHGName );
         mEmissionsTCurves[ currPoint ] = mSingleScenario->getInternalScenario()->getEmissionsPriceCurves( mGHGName );
+        if( mNumWorkers > 1 ) {
+            success &= writeTrial( currPoint );
+        }
 
         // Restore original solved market prices after each cost iteration to ensure same
         // starting prices for each iteration.  This is necessary due to changing initial prices.
@@ -213,6 +361,294 @@ bool TotalPolicyCostCalculator::runTrials(){
     return success;
 }
 
+/*!
+ * \brief Run the scenario with a fraction of the tax of the primary run.
+ * \param aFraction The fraction of the full tax in every period.
+ * \param aRunName The ending to add to the output file names of the run.
+ * \return Whether the run completed successfully.
+ */
+bool TotalPolicyCostCalculator::runTrial( const double aFraction, const string& aRunName ) {
+    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
+    const int maxPeriod = modeltime->getmaxper();
+
+    // Iterate through the regions to set different taxes for each if necessary.
+    // Currently this will set the same for all of them. The primary run is
+    // always the last trial.
+    for( CRegionCurvesIterator rIter = mEmissionsTCurves.back().begin(); rIter != mEmissionsTCurves.back().end(); ++rIter ){
+        // Vector which will contain taxes for this trial.
+        vector<double> currTaxes( maxPeriod );
+
+        // Set the tax for each year. 
+        for( int per = 0; per < maxPeriod; per++ ){
+            const int year = modeltime->getper_to_yr( per );
+            double origTax = rIter->second->getY( year );
+            currTaxes[ per ] = origTax == Marketplace::NO_MARKET_PRICE ? Marketplace::NO_MARKET_PRICE :
+                origTax * aFraction;
+        }
+        // Set the fixed taxes into the world.
+        GHGPolicy tax( mGHGName, rIter->first, currTaxes );
+        mSingleScenario->getInternalScenario()->setTax( &tax );
+    }
+
+    // Create an ending for the output files using the run number.
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Starting cost curve point run number " << aRunName << " at "
+            << aFraction << " of the tax." << endl;
+
+    // Run the scenario with the add-on extension to the output file names
+    // as the point number. This allows the output file to be named debug +
+    // point number.
+    return mSingleScenario->getInternalScenario()->run( Scenario::RUN_ALL_PERIODS, true,
+                                                        aRunName );
+}
+
+/*!
+ * \brief Run trials at adaptively placed tax fractions and store the abatement
+ *        curves.
+ * \details Starts from trials at no tax and half the tax and then repeatedly
+ *          bisects the interval between adjacent trials with the largest
+ *          estimated integration error until the total estimated error is
+ *          within "cost-curve-tolerance" of the total abatement cost or the
+ *          maximum of mNumPoints trials has been run. The curves are kept in
+ *          order of increasing tax with the primary run last.
+ * \return Whether all model runs completed successfully.
+ */
+bool TotalPolicyCostCalculator::runAdaptiveTrials() {
+    const double tolerance = Configuration::getInstance()->getDouble( "cost-curve-tolerance", 0.01 );
+    const static bool usingRestartPeriod = Configuration::getInstance()->getInt(
+        "restart-period", -1 ) != -1;
+    if( !usingRestartPeriod ) {
+        mSingleScenario->getInternalScenario()->getMarketplace()->store_prices_for_cost_calculation();
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    vector<double> fractions( 1, 1.0 );
+    bool success = true;
+    while( fractions.size() - 1 < mNumPoints ) {
+        double fraction;
+        if( fractions.size() == 1 ) {
+            fraction = 0;
+        }
+        else if( fractions.size() == 2 ) {
+            fraction = 0.5;
+        }
+        else {
+            vector<double> intervalErrors;
+            const double totalCost = estimateIntegrationErrors( intervalErrors );
+            const double totalError = accumulate( intervalErrors.begin(), intervalErrors.end(), 0.0 );
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Estimated cost curve integration error is " << totalError
+                    << " of a total cost of " << totalCost << " with "
+                    << fractions.size() - 1 << " trials." << endl;
+            if( totalError <= tolerance * totalCost ) {
+                break;
+            }
+            const size_t worst = max_element( intervalErrors.begin(), intervalErrors.end() )
+                - intervalErrors.begin();
+            fraction = ( fractions[ worst ] + fractions[ worst + 1 ] ) / 2.0;
+        }
+
+        success &= runTrial( fraction, util::toString( fractions.size() - 1 ) );
+
+        // Keep the trials in order of increasing tax.
+        const size_t position = lower_bound( fractions.begin(), fractions.end(), fraction ) - fractions.begin();
+        fractions.insert( fractions.begin() + position, fraction );
+        mEmissionsQCurves.insert( mEmissionsQCurves.begin() + position,
+            mSingleScenario->getInternalScenario()->getEmissionsQuantityCurves( mGHGName ) );
+        mEmissionsTCurves.insert( mEmissionsTCurves.begin() + position,
+            mSingleScenario->getInternalScenario()->getEmissionsPriceCurves( mGHGName ) );
+
+        // Restore original solved market prices after each cost iteration to
+        // ensure same starting prices for each iteration.
+        if( !usingRestartPeriod ) {
+            mSingleScenario->getInternalScenario()->getMarketplace()->restore_prices_for_cost_calculation();
+        }
+    }
+    if( usingRestartPeriod ) {
+        mSingleScenario->getInternalScenario()->getMarketplace()->restore_prices_for_cost_calculation();
+    }
+    return success;
+}
+
+/*!
+ * \brief Estimate the error of integrating the period cost curves between each
+ *        pair of adjacent trials.
+ * \details The trapezoidal error of an interval is estimated as h^3 / 12 times
+ *          the curvature of the cost curve, where h is the reduction across the
+ *          interval and the curvature is estimated from the change in slope at
+ *          the trials on either end. Errors are summed over all regions and
+ *          periods with a tax.
+ * \param aIntervalErrors The vector to store the estimated error of each
+ *        interval between adjacent trials in.
+ * \return The total abatement cost over all regions and periods.
+ */
+double TotalPolicyCostCalculator::estimateIntegrationErrors( vector<double>& aIntervalErrors ) const {
+    const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
+    const size_t numTrials = mEmissionsQCurves.size();
+    aIntervalErrors.assign( numTrials - 1, 0.0 );
+    double totalCost = 0;
+    vector<double> reductions( numTrials );
+    vector<double> taxes( numTrials );
+    vector<double> slopes( numTrials - 1 );
+    vector<double> curvatures( numTrials );
+    for( CRegionCurvesIterator rIter = mEmissionsQCurves[ 0 ].begin(); rIter != mEmissionsQCurves[ 0 ].end(); ++rIter ){
+        const string& region = rIter->first;
+        for( int per = 0; per < modeltime->getmaxper(); ++per ){
+            const int year = modeltime->getper_to_yr( per );
+            if( mEmissionsTCurves.back().find( region )->second->getY( year ) <= 0 ) {
+                continue;
+            }
+            for( size_t trial = 0; trial < numTrials; ++trial ) {
+                reductions[ trial ] = rIter->second->getY( year )
+                    - mEmissionsQCurves[ trial ].find( region )->second->getY( year );
+                taxes[ trial ] = mEmissionsTCurves[ trial ].find( region )->second->getY( year );
+            }
+            for( size_t trial = 0; trial + 1 < numTrials; ++trial ) {
+                const double width = reductions[ trial + 1 ] - reductions[ trial ];
+                totalCost += fabs( ( taxes[ trial ] + taxes[ trial + 1 ] ) / 2.0 * width );
+                slopes[ trial ] = width == 0 ? 0 : ( taxes[ trial + 1 ] - taxes[ trial ] ) / width;
+            }
+            fill( curvatures.begin(), curvatures.end(), 0.0 );
+            for( size_t trial = 1; trial + 1 < numTrials; ++trial ) {
+                const double width = fabs( reductions[ trial + 1 ] - reductions[ trial - 1 ] );
+                curvatures[ trial ] = width == 0 ? 0 : 2.0 * fabs( slopes[ trial ] - slopes[ trial - 1 ] ) / width;
+            }
+            for( size_t trial = 0; trial + 1 < numTrials; ++trial ) {
+                const double width = fabs( reductions[ trial + 1 ] - reductions[ trial ] );
+                aIntervalErrors[ trial ] += pow( width, 3 ) / 12.0
+                    * max( curvatures[ trial ], curvatures[ trial + 1 ] );
+            }
+        }
+    }
+    return totalCost;
+}
+
+/*!
+ * \brief Get the name of the file in which the curves of a trial are exchanged
+ *        between workers.
+ * \details The name includes the scenario name and the cost-curve-run-id so
+ *          that several runs may share the cost-curve-points location.
+ * \param aPoint The trial number.
+ * \return The file name.
+ */
+string TotalPolicyCostCalculator::getTrialFileName( const unsigned int aPoint ) const {
+    string fileName = Configuration::getInstance()->getFile( "cost-curve-points" )
+        + "/" + mSingleScenario->getInternalScenario()->getName();
+    if( !mRunID.empty() ) {
+        fileName += "-" + mRunID;
+    }
+    return fileName + "-cost-curve-point-" + util::toString( aPoint ) + ".xml";
+}
+
+/*!
+ * \brief Remove the trial files of the trials run by this worker.
+ * \details Only the files of this worker are removed since the other workers
+ *          may already have written theirs.  Files of other workers left from
+ *          an earlier run are instead rejected by their header when read.
+ */
+void TotalPolicyCostCalculator::removeTrialFiles() const {
+    for( unsigned int point = mWorker; point < mNumPoints; point += mNumWorkers ) {
+        remove( getTrialFileName( point ).c_str() );
+    }
+}
+
+/*!
+ * \brief Write the emissions curves of a trial for the first worker to read.
+ * \details The file is written under a temporary name and then renamed so
+ *          that it is complete once it can be seen.
+ * \param aPoint The trial number.
+ * \return Whether the file was written.
+ */
+bool TotalPolicyCostCalculator::writeTrial( const unsigned int aPoint ) const {
+    const string fileName = getTrialFileName( aPoint );
+    const string tempFileName = fileName + ".tmp";
+    {
+        ofstream out( tempFileName.c_str() );
+        out.precision( numeric_limits<double>::digits10 + 2 );
+        Tabs tabs;
+        XMLWriteOpeningTag( "cost-curve-point", out, &tabs, util::toString( aPoint ) );
+        XMLWriteElement( mSingleScenario->getInternalScenario()->getName(), "scenario", out, &tabs );
+        XMLWriteElement( mRunID, "run-id", out, &tabs );
+        XMLWriteElement( mNumPoints, "num-points", out, &tabs );
+        for( CRegionCurvesIterator rIter = mEmissionsQCurves[ aPoint ].begin(); rIter != mEmissionsQCurves[ aPoint ].end(); ++rIter ) {
+            XMLWriteOpeningTag( "emissions-quantity", out, &tabs, rIter->first );
+            rIter->second->toInputXML( out, &tabs );
+            XMLWriteClosingTag( "emissions-quantity", out, &tabs );
+        }
+        for( CRegionCurvesIterator rIter = mEmissionsTCurves[ aPoint ].begin(); rIter != mEmissionsTCurves[ aPoint ].end(); ++rIter ) {
+            XMLWriteOpeningTag( "emissions-price", out, &tabs, rIter->first );
+            rIter->second->toInputXML( out, &tabs );
+            XMLWriteClosingTag( "emissions-price", out, &tabs );
+        }
+        XMLWriteClosingTag( "cost-curve-point", out, &tabs );
+        if( !out ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not write the cost curve point to " << tempFileName << "." << endl;
+            return false;
+        }
+    }
+    if( rename( tempFileName.c_str(), fileName.c_str() ) != 0 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write the cost curve point to " << fileName << "." << endl;
+        return false;
+    }
+    return true;
+}
+
+/*!
+ * \brief Read the emissions curves of the trials run by the other workers.
+ * \details Waits for each trial file to be written for at most
+ *          "cost-curve-wait-seconds" in total.  A file whose header does not
+ *          match this run is ignored until the worker replaces it.
+ * \return Whether the curves of all trials were read.
+ */
+bool TotalPolicyCostCalculator::readTrials() {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const int waitSeconds = Configuration::getInstance()->getInt( "cost-curve-wait-seconds", 86400, false );
+    const chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::seconds( waitSeconds );
+    for( unsigned int point = 0; point < mNumPoints; ++point ) {
+        if( point % mNumWorkers == mWorker ) {
+            continue;
+        }
+
+        const string fileName = getTrialFileName( point );
+        const string scenarioName = mSingleScenario->getInternalScenario()->getName();
+        bool warnedStale = false;
+        while( true ) {
+            if( ifstream( fileName.c_str() ) ) {
+                TrialParser parser( mEmissionsQCurves[ point ], mEmissionsTCurves[ point ],
+                                    point, mNumPoints, scenarioName, mRunID );
+                if( XMLHelper<void>::parseXML( fileName, &parser ) ) {
+                    break;
+                }
+                if( !parser.isStale() ) {
+                    mainLog.setLevel( ILogger::ERROR );
+                    mainLog << "Could not read cost curve point " << fileName << "." << endl;
+                    return false;
+                }
+                if( !warnedStale ) {
+                    mainLog.setLevel( ILogger::WARNING );
+                    mainLog << "Ignoring cost curve point " << fileName
+                            << " which is not from this run." << endl;
+                    warnedStale = true;
+                }
+            }
+            if( chrono::steady_clock::now() > deadline ) {
+                mainLog.setLevel( ILogger::ERROR );
+                mainLog << "Timed out waiting for cost curve point " << fileName << "." << endl;
+                return false;
+            }
+            this_thread::sleep_for( chrono::seconds( 1 ) );
+        }
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Read cost curve point " << point << " from " << fileName << "." << endl;
+    }
+    return true;
+}
+
 /*! \brief Create a cost curve for each period and region.
 * \details Using the cost curves generated by the trials, generate and stored a set of cost
 * curves by period and region.
@@ -231,7 +667,7 @@ void TotalPolicyCostCalculator::createCostCurvesByPeriod() {
             ExplicitPointSet* currPoints = new ExplicitPointSet();
             const string region = rIter->first;
             // Iterate over each trial.
-            for( unsigned int trial = 0; trial < mNumPoints + 1; trial++ ){
+            for( unsigned int trial = 0; trial < mEmissionsQCurves.size(); trial++ ){
                 double reduction = rIter->second->getY( year )
                                    - mEmissionsQCurves[ trial ][ region ]->getY( year );
                 const double tax = mEmissionsTCurves[ trial ][ region ]->getY( year );
@@ -354,8 +790,8 @@ void TotalPolicyCostCalculator::printOutput() const {
 */
 void TotalPolicyCostCalculator::writeToCSV() const {
     // function protocol
-    void fileoutput3(string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3(const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     const Modeltime* modeltime = mSingleScenario->getInternalScenario()->getModeltime();
     const int maxPeriod = modeltime->getmaxper();
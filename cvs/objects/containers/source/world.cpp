@@ -40,11 +40,18 @@
 
 #include "util/base/include/definitions.h"
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
+#include "util/base/include/activity_profiler.h"
+#include "util/base/include/deterministic_reduction.h"
+#include "util/base/include/allocation_tracker.h"
+#include "util/base/include/startup_profile.h"
+#include "util/base/include/value.h"
 
 #include <string>
 #include <cassert>
 #include <vector>
 #include <map>
+#include <sstream>
 #include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -59,6 +66,7 @@
 #include "util/base/include/configuration.h"
 #include "util/base/include/util.h"
 #include "util/base/include/summary.h"
+#include "util/base/include/csv_output_buffer.h"
 #include "util/curves/include/curve.h"
 #include "util/curves/include/point_set_curve.h"
 #include "util/curves/include/point_set.h"
@@ -81,6 +89,9 @@
 
 #if GCAM_PARALLEL_ENABLED
 #include "parallel/include/gcam_parallel.hpp"
+#include "util/base/include/iparallel_region_visitor.h"
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
 #endif
 
 // Uncommenting the following two lines will turn on floating-point exceptions within World::calc(),
@@ -95,10 +106,26 @@ using namespace xercesc;
 
 extern Scenario* scenario;
 
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \brief The climate model run for a period which is allowed to proceed while
+ *        the next period is set up.
+ */
+struct World::ClimateModelTask {
+    tbb::task_group mTaskGroup;
+};
+#endif
+
 //! Default constructor.
 World::World()
 {
     mClimateModel = 0;
+    mClimateModelEmulator = 0;
+#if GCAM_PARALLEL_ENABLED
+    mParallelRegions = false;
+    mClimateModelTask = 0;
+    mInlineCalcSeconds = 0.0;
+#endif
     mCalcCounter = new CalcCounter();
     mGlobalTechDB = new GlobalTechnologyDatabase();
 }
@@ -110,6 +137,10 @@ World::~World(){
 
 //! Helper member function for the destructor. Performs memory deallocation. 
 void World::clear(){
+    waitForClimateModel();
+#if GCAM_PARALLEL_ENABLED
+    delete mClimateModelTask;
+#endif
     for ( RegionIterator regionIter = mRegions.begin(); regionIter != mRegions.end(); regionIter++ ) {
         delete *regionIter;
     }
@@ -175,22 +206,75 @@ void World::completeInit() {
     
     // Initialize Climate Model
     mClimateModel->completeInit( scenario->getName() );
+#if GCAM_PARALLEL_ENABLED
+    if( Configuration::getInstance()->getBool( "async-climate-model", false ) && !mClimateModelTask ) {
+        mClimateModelTask = new ClimateModelTask();
+    }
+
+    // Region initCalc and postCalc touch their own region, the thread safe
+    // market info and concurrent supplies and demands, and may set prices and
+    // solve flags of markets shared with other regions which the Marketplace
+    // serializes.  Regions must therefore not set different values for a
+    // market they share in the same period as which is written last would
+    // depend on the schedule.  SGM regions read and modify shared markets
+    // throughout initCalc and so are always done serially.
+    mParallelRegions = Configuration::getInstance()->getBool( "parallel-region-init", false );
+    for( CRegionIterator regionIter = mRegions.begin(); regionIter != mRegions.end(); ++regionIter ) {
+        if( dynamic_cast<const RegionCGE*>( *regionIter ) ) {
+            mParallelRegions = false;
+        }
+    }
+    mInlineCalcSeconds = Configuration::getInstance()->getDouble( "flow-graph-inline-seconds", 1.0e-3, false );
+#endif
     
+    StartupProfile& profile = StartupProfile::getInstance();
+
+    // The demographic and GDP projections of each region are independent of all
+    // other regions and the marketplace and so can be precomputed concurrently.
+    profile.startPhase( "socioeconomic completeInit" );
+#if GCAM_PARALLEL_ENABLED
+    if( mParallelRegions ) {
+        tbb::parallel_for( tbb::blocked_range<size_t>( 0, mRegions.size(), 1 ), [this]( const tbb::blocked_range<size_t>& aRange ) {
+            for( size_t i = aRange.begin(); i != aRange.end(); ++i ) {
+                mRegions[ i ]->completeSocioeconomicInit();
+            }
+        } );
+    }
+    else
+#endif
+    {
+        for( RegionIterator regionIter = mRegions.begin(); regionIter != mRegions.end(); ++regionIter ) {
+            ( *regionIter )->completeSocioeconomicInit();
+        }
+    }
+    profile.endPhase( "socioeconomic completeInit" );
+
     // Finish initializing all the regions.
+    profile.startPhase( "region completeInit" );
     for( RegionIterator regionIter = mRegions.begin(); regionIter != mRegions.end(); regionIter++ ) {
         ( *regionIter )->completeInit();
     }
+    profile.endPhase( "region completeInit" );
 
     // Now that all regions have finished with completeInit we can instruct the
     // market dependency finder to create the global ordering.  We will store that
     // ordering here to avoid re-copying it every time world.calc is called.
+    profile.startPhase( "market dependency ordering" );
     MarketDependencyFinder* depFinder = scenario->getMarketplace()->getDependencyFinder();
     depFinder->createOrdering();
     mGlobalOrdering = depFinder->getOrdering();
+    ActivityProfiler::getInstance().setActivities( mGlobalOrdering );
+    // Flow graph calculations may reduce supplies and demands in the order of
+    // the global ordering so that results do not depend on the threads used.
+    DeterministicReduction::setEnabled( Configuration::getInstance()->getBool( "deterministic-reduction", false, false ) );
+    DeterministicReduction::setActivities( mGlobalOrdering );
+    profile.endPhase( "market dependency ordering" );
 #if GCAM_PARALLEL_ENABLED
     Timer &totalgraphtimer = TimerRegistry::getInstance().getTimer("total-graph");
     totalgraphtimer.start();
+    profile.startPhase( "flow graph" );
     mTBBGraphGlobal = depFinder->getFlowGraph();
+    profile.endPhase( "flow graph" );
     totalgraphtimer.stop();
     ILogger &mainlog = ILogger::getLogger("main_log");
     totalgraphtimer.print(mainlog, "Total of all graph analysis setup:  ");
@@ -209,6 +293,7 @@ void World::toInputXML( ostream& out, Tabs* tabs ) const {
     // must be written out before any of the carbon cycle historical
     // year data is written which is contained in the regions
     if ( mClimateModel ) {
+        waitForClimateModel();
         mClimateModel->toInputXML( out, tabs );
     }
 
@@ -230,17 +315,42 @@ void World::toDebugXML( const int period, ostream& out, Tabs* tabs ) const {
 
     scenario->getMarketplace()->toDebugXML( period, out, tabs );
 
-    // Only print debug XML information for the specified region to avoid
+    // Only print debug XML information for the specified regions to avoid
     // unmanagably large XML files.
-    const static string debugRegion = Configuration::getInstance()->getString( "debug-region", "USA" );
+    vector<const Region*> debugRegions;
     for( CRegionIterator i = mRegions.begin(); i != mRegions.end(); i++ ) {
-        if( ( *i )->getName() == debugRegion ){
-            ( *i )->toDebugXML( period, out, tabs );
+        if( util::isDebugRegion( ( *i )->getName() ) ){
+            debugRegions.push_back( *i );
+        }
+    }
+#if GCAM_PARALLEL_ENABLED
+    // The regions may be written into separate buffers concurrently which are
+    // then copied out in order so that the file is the same as when they are
+    // written one at a time.
+    if( debugRegions.size() > 1 && Configuration::getInstance()->getBool( "parallel-debug-output", false ) ) {
+        vector<stringstream> regionBuffers( debugRegions.size() );
+        tbb::parallel_for( tbb::blocked_range<size_t>( 0, debugRegions.size(), 1 ),
+            [period, tabs, &debugRegions, &regionBuffers] ( const tbb::blocked_range<size_t>& aRange ) {
+                for( size_t i = aRange.begin(); i != aRange.end(); ++i ) {
+                    Tabs regionTabs( *tabs );
+                    debugRegions[ i ]->toDebugXML( period, regionBuffers[ i ], &regionTabs );
+                }
+            } );
+        for( size_t i = 0; i < regionBuffers.size(); ++i ) {
+            out << regionBuffers[ i ].str();
+        }
+    }
+    else
+#endif
+    {
+        for( size_t i = 0; i < debugRegions.size(); ++i ) {
+            debugRegions[ i ]->toDebugXML( period, out, tabs );
         }
     }
 
     // Climate model parameters
     if ( !mClimateModel ) {
+        waitForClimateModel();
         mClimateModel->toDebugXML( period, out, tabs );
     }
 
@@ -279,6 +389,18 @@ const string& World::getName() const {
 */
 void World::initCalc( const int period ) {
 
+#if GCAM_PARALLEL_ENABLED
+    // The base period keeps the serial order in which each region updates the
+    // marketplace and is initialized before the next region updates it.
+    if( mParallelRegions && period > 0 ) {
+        tbb::parallel_for( tbb::blocked_range<size_t>( 0, mRegions.size(), 1 ), [this, period]( const tbb::blocked_range<size_t>& aRange ) {
+            for( size_t regionIndex = aRange.begin(); regionIndex != aRange.end(); ++regionIndex ) {
+                this->mRegions[ regionIndex ]->initCalc( period );
+            }
+        });
+    }
+    else
+#endif
     for( vector<Region*>::iterator i = mRegions.begin(); i != mRegions.end(); i++ ){
         // Add supplies and demands to the marketplace in the base year for checking data consistency
         // and for getting demand and supply totals.
@@ -324,6 +446,7 @@ void World::calc( const int aPeriod ) {
 * \param aItemsToCalc The items which need to be calculated.
 */
 void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc ) {   
+    GCAM_PROFILE_SCOPE( "world calc" );
     /*! \invariant The number of items to calculate must be between 0 and the
      *              total number of items globally inclusive. 
      */
@@ -337,8 +460,24 @@ void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc
     mCalcCounter->incrementCount( static_cast<double>( aItemsToCalc.size() ) / static_cast<double>( mGlobalOrdering.size() ) );
     
     // Perform calculation on each item to calculate. 
+    ActivityProfiler& activityProfiler = ActivityProfiler::getInstance();
+    const bool isFullCalc = aItemsToCalc.size() == mGlobalOrdering.size();
+    Value::ScopedStateBinding stateBinding;
     for( vector<IActivity*>::const_iterator it = aItemsToCalc.begin(); it != aItemsToCalc.end(); ++it ) {
-        (*it)->calc( aPeriod );
+#if GCAM_TRACK_ALLOCATIONS
+        const AllocationTracker::Counts startAllocations = AllocationTracker::getThreadCounts();
+#endif
+        if( activityProfiler.isEnabled() ) {
+            const ActivityProfiler::Clock::time_point start = ActivityProfiler::Clock::now();
+            (*it)->calc( aPeriod );
+            ActivityProfiler::record( activityProfiler.getCounts( *it ), isFullCalc, start );
+        }
+        else {
+            (*it)->calc( aPeriod );
+        }
+#if GCAM_TRACK_ALLOCATIONS
+        AllocationTracker::recordActivity( *it, startAllocations );
+#endif
     }
 #ifdef GNU_SOURCE
     feenableexcept(except);
@@ -356,13 +495,39 @@ void World::calc( const int aPeriod, const std::vector<IActivity*>& aItemsToCalc
  * \param aCalcList This can be used when only a partial model calculation is needed
  *                  and a flow graph has not been created for it.  In that case the
  *                  full model flow graph will be used while skipping calculations
- *                  not contained in aCalcList.
+ *                  not contained in aCalcList.  If the activities in aCalcList are
+ *                  estimated to take less time than flow-graph-inline-seconds they
+ *                  are instead calculated inline in global order, as starting the
+ *                  graph and skipping the activities not in the list would take
+ *                  longer than the work itself.  The estimate uses the average time
+ *                  per activity measured by earlier inline calcs.
+ * \warning The flow graph is shared so this may only be called by one thread
+ *          at a time, partial calcs which may run concurrently should use the
+ *          serial calc.
  */
 void World::calc( const int aPeriod, GcamFlowGraph *aWorkGraph, const vector<IActivity*>* aCalcList )
 {
+    typedef ActivityProfiler::Clock Clock;
+    if( aCalcList && !aWorkGraph ) {
+        const double secondsPerActivity = mInlineCalcStats.mActivities > 0.0
+            ? mInlineCalcStats.mSeconds / mInlineCalcStats.mActivities : 0.0;
+        if( secondsPerActivity * aCalcList->size() < mInlineCalcSeconds ) {
+            const Clock::time_point start = Clock::now();
+            calc( aPeriod, *aCalcList );
+            ++mInlineCalcStats.mCalls;
+            mInlineCalcStats.mActivities += aCalcList->size();
+            mInlineCalcStats.mSeconds += chrono::duration<double>( Clock::now() - start ).count();
+            return;
+        }
+    }
+
+    GCAM_PROFILE_SCOPE( "world graph calc" );
 #ifdef GNU_SOURCE
     int except = feenableexcept(FE_DIVBYZERO | FE_INVALID);
 #endif
+    const Clock::time_point start = Clock::now();
+    ++mGraphCalcStats.mCalls;
+    mGraphCalcStats.mActivities += aCalcList ? aCalcList->size() : mGlobalOrdering.size();
 
     // increment the evaulation count by the fraction of the whole model that we're solving
     mCalcCounter->incrementCount( aCalcList ? (double)(aCalcList->size()) / (double) mGlobalOrdering.size() : 1.0 );
@@ -380,9 +545,19 @@ void World::calc( const int aPeriod, GcamFlowGraph *aWorkGraph, const vector<IAc
         aWorkGraph->mCalcList = 0;
     }
     aWorkGraph->mPeriod = aPeriod;
+    FlowGraphTracer& tracer = FlowGraphTracer::getInstance();
+    if( tracer.isEnabled() ) {
+        tracer.startRun( *aWorkGraph );
+    }
     // do the model calculation
+    DeterministicReduction::beginCalc();
     aWorkGraph->mHead.try_put( tbb::flow::continue_msg() );
     aWorkGraph->mTBBFlowGraph.wait_for_all();
+    DeterministicReduction::endCalc();
+    if( tracer.isEnabled() ) {
+        tracer.finishRun( *aWorkGraph );
+    }
+    mGraphCalcStats.mSeconds += chrono::duration<double>( Clock::now() - start ).count();
 
 #ifdef GNU_SOURCE
     feenableexcept(except);
@@ -399,9 +574,16 @@ void World::updateSummary( const list<string> aPrimaryFuelList, const int period
     }
 }
 
-/*! Calculates the global emissions.
+/*! \brief Calculates the global emissions and passes them to the climate model.
+ * \details The emissions for all periods are summed in one visit of the model
+ *          so when all of them are needed, such as when the climate model is
+ *          re-run by a target finder, a period of -1 may be given to set
+ *          them all at once.  The regions may be visited concurrently, see
+ *          IParallelRegionVisitor.
+ * \param aPeriod The model period to set emissions for or -1 for all periods
+ *                after the base period.
  */
-void World::setEmissions( int period ) {
+void World::setEmissions( const int aPeriod ) {
     // Declare visitors which will aggregate emissions by period.
     EmissionsSummer co2Summer( "CO2" );
     LUCEmissionsSummer co2LandUseSummer( "CO2NetLandUse" );
@@ -505,202 +687,285 @@ void World::setEmissions( int period ) {
     const double HFC43_TO_134 = ( 1640.0 / 1430.0 );
     
     // Update all emissions values.
-    accept( &allSummer, period );
-    accept( &co2LandUseSummer, period );
+    accept( &allSummer, aPeriod );
+    accept( &co2LandUseSummer, aPeriod );
         
-    // Only set emissions if they are valid. If these are not set
-    // MAGICC will use the default values.
-    if( co2Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CO2", period,
-                                     co2Summer.getEmissions( period )
-                                     / TG_TO_PG );
-    }
-    
-    const int currYear = scenario->getModeltime()->getper_to_yr( period );
-    const int startYear = currYear - scenario->getModeltime()->gettimestep( period ) + 1;
-    for ( int i = startYear; i <= currYear; i++ ) {
-        if( co2LandUseSummer.areEmissionsSet( i ) ){
-            mClimateModel->setLUCEmissions( "CO2NetLandUse", i,
-                                            co2LandUseSummer.getEmissions( i )
-                                            / TG_TO_PG );
-        }
-    }
-    
-    if( ch4Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CH4", period,
-                                     ch4Summer.getEmissions( period ) +
-                                     ch4agrSummer.getEmissions( period ) + 
-                                     ch4awbSummer.getEmissions( period ));
-    }
-    
-    if( coSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CO", period,
-                                     coSummer.getEmissions( period ) +
-                                     coagrSummer.getEmissions( period ) +
-                                     coawbSummer.getEmissions( period ));
-    }
-    
-    // MAGICC wants N2O emissions in Tg N, but miniCAM calculates Tg N2O
-    if( n2oSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "N2O", period,
-                                     ( n2oSummer.getEmissions( period ) +
-                                       n2oawbSummer.getEmissions( period ) +
-                                       n2oagrSummer.getEmissions( period )  )
-                                     / N_TO_N2O );
-    }
-    
-    // MAGICC wants NOx emissions in Tg N, but miniCAM calculates Tg NOx
-    // FORTRAN code uses the conversion for NO2
-    if( noxSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "NOx", period,
-                                     ( noxSummer.getEmissions( period ) +
-                                       noxagrSummer.getEmissions( period ) +
-                                       noxawbSummer.getEmissions( period ))
-                                     / N_TO_NO2 );
-    }
-    
-    double so2total=0.0;
-    // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
-    // Region 1 includes SO21 and 60% of SO24 (FSU)
-    if( so21Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
-        double so21 = so21Summer.getEmissions( period ) +
-            so21awbSummer.getEmissions( period )
-            + 0.6*so24Summer.getEmissions( period ) 
-            + 0.6*so24awbSummer.getEmissions( period ); 
+    const int firstPeriod = aPeriod == -1 ? 1 : aPeriod;
+    const int lastPeriod = aPeriod == -1 ? scenario->getModeltime()->getmaxper() - 1 : aPeriod;
+    for( int period = firstPeriod; period <= lastPeriod; ++period ) {
+        // Only set emissions if they are valid. If these are not set
+        // MAGICC will use the default values.
+        if( co2Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CO2", period,
+                                         co2Summer.getEmissions( period )
+                                         / TG_TO_PG );
+        }
+    
+        const int currYear = scenario->getModeltime()->getper_to_yr( period );
+        const int startYear = currYear - scenario->getModeltime()->gettimestep( period ) + 1;
+        for ( int i = startYear; i <= currYear; i++ ) {
+            if( co2LandUseSummer.areEmissionsSet( i ) ){
+                mClimateModel->setLUCEmissions( "CO2NetLandUse", i,
+                                                co2LandUseSummer.getEmissions( i )
+                                                / TG_TO_PG );
+            }
+        }
+    
+        if( ch4Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CH4", period,
+                                         ch4Summer.getEmissions( period ) +
+                                         ch4agrSummer.getEmissions( period ) + 
+                                         ch4awbSummer.getEmissions( period ));
+        }
+    
+        if( coSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CO", period,
+                                         coSummer.getEmissions( period ) +
+                                         coagrSummer.getEmissions( period ) +
+                                         coawbSummer.getEmissions( period ));
+        }
+    
+        // MAGICC wants N2O emissions in Tg N, but miniCAM calculates Tg N2O
+        if( n2oSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "N2O", period,
+                                         ( n2oSummer.getEmissions( period ) +
+                                           n2oawbSummer.getEmissions( period ) +
+                                           n2oagrSummer.getEmissions( period )  )
+                                         / N_TO_N2O );
+        }
+    
+        // MAGICC wants NOx emissions in Tg N, but miniCAM calculates Tg NOx
+        // FORTRAN code uses the conversion for NO2
+        if( noxSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "NOx", period,
+                                         ( noxSummer.getEmissions( period ) +
+                                           noxagrSummer.getEmissions( period ) +
+                                           noxawbSummer.getEmissions( period ))
+                                         / N_TO_NO2 );
+        }
+    
+        double so2total=0.0;
+        // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
+        // Region 1 includes SO21 and 60% of SO24 (FSU)
+        if( so21Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
+            double so21 = so21Summer.getEmissions( period ) +
+                so21awbSummer.getEmissions( period )
+                + 0.6*so24Summer.getEmissions( period ) 
+                + 0.6*so24awbSummer.getEmissions( period ); 
         
-        mClimateModel->setEmissions( "SOXreg1", period, so21/S_TO_SO2);
-        so2total += so21;
-    }
+            mClimateModel->setEmissions( "SOXreg1", period, so21/S_TO_SO2);
+            so2total += so21;
+        }
     
-    // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
-    // Region 2 includes SO22 and 40% of SO24 (FSU)
-    if( so22Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
-        double so22 = so22Summer.getEmissions( period ) +
-            so22awbSummer.getEmissions( period )
-            + 0.4*so24Summer.getEmissions( period ) 
-            + 0.4*so24awbSummer.getEmissions( period );
+        // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
+        // Region 2 includes SO22 and 40% of SO24 (FSU)
+        if( so22Summer.areEmissionsSet( period ) && so24Summer.areEmissionsSet( period )){
+            double so22 = so22Summer.getEmissions( period ) +
+                so22awbSummer.getEmissions( period )
+                + 0.4*so24Summer.getEmissions( period ) 
+                + 0.4*so24awbSummer.getEmissions( period );
         
-        mClimateModel->setEmissions( "SOXreg2", period, so22 / S_TO_SO2);
-        so2total += so22;
-    }
+            mClimateModel->setEmissions( "SOXreg2", period, so22 / S_TO_SO2);
+            so2total += so22;
+        }
     
-    // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
-    if( so23Summer.areEmissionsSet( period ) ){
-        double so23 = so23Summer.getEmissions( period ) +
-            so23awbSummer.getEmissions( period );
+        // MAGICC wants SO2 emissions in Tg S, but miniCAM calculates Tg SO2
+        if( so23Summer.areEmissionsSet( period ) ){
+            double so23 = so23Summer.getEmissions( period ) +
+                so23awbSummer.getEmissions( period );
         
-        mClimateModel->setEmissions( "SOXreg3", period, so23 / S_TO_SO2 );
-        so2total += so23;
-    }
+            mClimateModel->setEmissions( "SOXreg3", period, so23 / S_TO_SO2 );
+            so2total += so23;
+        }
     
-    // set total SO2 emissions for those models that want it.
-    // Emissions are in Tg SO2; it is up to models that want
-    // something different to make their own conversion.
-    mClimateModel->setEmissions("SO2tot", period, so2total);
+        // set total SO2 emissions for those models that want it.
+        // Emissions are in Tg SO2; it is up to models that want
+        // something different to make their own conversion.
+        mClimateModel->setEmissions("SO2tot", period, so2total);
     
-    if( cf4Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "CF4", period,
-                                     cf4Summer.getEmissions( period ) );
-    }
+        if( cf4Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "CF4", period,
+                                         cf4Summer.getEmissions( period ) );
+        }
     
-    if( c2f6Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "C2F6", period,
-                                     c2f6Summer.getEmissions( period ) );
-    }
+        if( c2f6Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "C2F6", period,
+                                         c2f6Summer.getEmissions( period ) );
+        }
     
-    if( sf6Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "SF6", period,
-                                     sf6Summer.getEmissions( period ) );
-    }
+        if( sf6Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "SF6", period,
+                                         sf6Summer.getEmissions( period ) );
+        }
     
-    if( hfc125Summer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "HFC125", period,
-                                     hfc125Summer.getEmissions( period ) );
-    } 
+        if( hfc125Summer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "HFC125", period,
+                                         hfc125Summer.getEmissions( period ) );
+        } 
     
-    if( hfc134aSummer.areEmissionsSet( period ) && hfc43Summer.areEmissionsSet( period )  ){
-        mClimateModel->setEmissions( "HFC134a", period,
-                                     hfc134aSummer.getEmissions( period ) +
-                                     hfc43Summer.getEmissions( period ) * HFC43_TO_134);
-    }
+        if( hfc134aSummer.areEmissionsSet( period ) && hfc43Summer.areEmissionsSet( period )  ){
+            mClimateModel->setEmissions( "HFC134a", period,
+                                         hfc134aSummer.getEmissions( period ) +
+                                         hfc43Summer.getEmissions( period ) * HFC43_TO_134);
+        }
 
-    if( hfc245faSummer.areEmissionsSet( period ) && hfc32Summer.areEmissionsSet( period ) && hfc365mfcSummer.areEmissionsSet( period ) && hfc152aSummer.areEmissionsSet( period ) ){
-        // MAGICC needs HFC245fa in kton of HFC245ca
-        mClimateModel->setEmissions( "HFC245ca", period,
-                                     hfc245faSummer.getEmissions( period ) / HFC_CA_TO_FA +
-                                     hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
-                                     hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
-                                     hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
-        // For models that need ktonnes of HFC245fa (no single model should implement both of these):
-        mClimateModel->setEmissions("HFC245fa", period,
-                                    hfc245faSummer.getEmissions(period)+
-                                    hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
-                                    hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
-                                    hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
-    }
+        if( hfc245faSummer.areEmissionsSet( period ) && hfc32Summer.areEmissionsSet( period ) && hfc365mfcSummer.areEmissionsSet( period ) && hfc152aSummer.areEmissionsSet( period ) ){
+            // MAGICC needs HFC245fa in kton of HFC245ca
+            mClimateModel->setEmissions( "HFC245ca", period,
+                                         hfc245faSummer.getEmissions( period ) / HFC_CA_TO_FA +
+                                         hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
+                                         hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
+                                         hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
+            // For models that need ktonnes of HFC245fa (no single model should implement both of these):
+            mClimateModel->setEmissions("HFC245fa", period,
+                                        hfc245faSummer.getEmissions(period)+
+                                        hfc32Summer.getEmissions( period ) * HFC32_TO_245 +
+                                        hfc365mfcSummer.getEmissions( period ) * HFC365_TO_245 +
+                                        hfc152aSummer.getEmissions( period ) * HFC152_TO_245);
+        }
     
-    // MAGICC needs this in tons of VOC. Input is in TgC
-    if( vocSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "NMVOCs", period,
-                                     ( vocSummer.getEmissions( period ) +
-                                       vocagrSummer.getEmissions( period ) +
-                                       vocawbSummer.getEmissions( period ) ));
-    }
+        // MAGICC needs this in tons of VOC. Input is in TgC
+        if( vocSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "NMVOCs", period,
+                                         ( vocSummer.getEmissions( period ) +
+                                           vocagrSummer.getEmissions( period ) +
+                                           vocawbSummer.getEmissions( period ) ));
+        }
     
-    // MAGICC needs this in GgC. Model output is in TgC
-    if( bcSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "BC", period,
-                                     ( bcSummer.getEmissions( period ) +
-                                       bcawbSummer.getEmissions( period ) )
-                                     * TG_TO_PG );
-    }
+        // MAGICC needs this in GgC. Model output is in TgC
+        if( bcSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "BC", period,
+                                         ( bcSummer.getEmissions( period ) +
+                                           bcawbSummer.getEmissions( period ) )
+                                         * TG_TO_PG );
+        }
     
-    // MAGICC needs this in GgC. Model output is in TgC
-    if( ocSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "OC", period,
-                                     ( ocSummer.getEmissions( period ) +
-                                       ocawbSummer.getEmissions( period ) )
-                                     * TG_TO_PG );
-    }
+        // MAGICC needs this in GgC. Model output is in TgC
+        if( ocSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "OC", period,
+                                         ( ocSummer.getEmissions( period ) +
+                                           ocawbSummer.getEmissions( period ) )
+                                         * TG_TO_PG );
+        }
     
     
-    if( hfc227eaSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "HFC227ea", period,
-                                     hfc227eaSummer.getEmissions( period ) );
-    }
+        if( hfc227eaSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "HFC227ea", period,
+                                         hfc227eaSummer.getEmissions( period ) );
+        }
     
-    if( hfc143aSummer.areEmissionsSet( period ) && hfc23Summer.areEmissionsSet( period ) && hfc236faSummer.areEmissionsSet( period ) ){
-        mClimateModel->setEmissions( "HFC143a", period,
-                                     hfc143aSummer.getEmissions( period ) +
-                                     hfc23Summer.getEmissions( period ) * HFC23_TO_143 +
-                                     hfc236faSummer.getEmissions( period ) * HFC236_TO_143);
+        if( hfc143aSummer.areEmissionsSet( period ) && hfc23Summer.areEmissionsSet( period ) && hfc236faSummer.areEmissionsSet( period ) ){
+            mClimateModel->setEmissions( "HFC143a", period,
+                                         hfc143aSummer.getEmissions( period ) +
+                                         hfc23Summer.getEmissions( period ) * HFC23_TO_143 +
+                                         hfc236faSummer.getEmissions( period ) * HFC236_TO_143);
+        }
     }
 }
     
 void World::runClimateModel() {
+    waitForClimateModel();
+
     // The Climate model reads in data for the base period, so skip passing it in.
-    for( int period = 1; period < scenario->getModeltime()->getmaxper(); ++period ) {
-        setEmissions( period );
-    }
+    setEmissions( -1 );
     
-    // Run the model.
-    mClimateModel->runModel();
+    // Run the model, or update the emulator which reads the emissions back
+    // from the model.
+    if( mClimateModelEmulator ) {
+        mClimateModelEmulator->runModel();
+    }
+    else {
+        mClimateModel->runModel();
+
+        // Run an ensemble of the climate model to characterize the parametric
+        // uncertainty of the results if samples of the parameters were given.
+        const string ensembleFile = Configuration::getInstance()->getFile( "climate-ensemble-parameters", "", false );
+        if( !ensembleFile.empty() &&
+            mClimateModel->runEnsemble( ensembleFile ) == IClimateModel::NOT_IMPLEMENTED )
+        {
+            ILogger& climatelog = ILogger::getLogger( "climate-log" );
+            climatelog.setLevel( ILogger::WARNING );
+            climatelog << "The climate model does not support ensemble runs, climate-ensemble-parameters is ignored." << endl;
+        }
+    }
 }
 
+/*!
+ * \brief Run the climate model through the given period.
+ * \details The emissions are always passed to the climate model before
+ *          returning.  If async-climate-model is set in a parallel build the
+ *          climate model itself is run as a task so that the next period may
+ *          be set up and solved at the same time, anything which needs the
+ *          climate results must then call waitForClimateModel, which
+ *          getClimateModel does.
+ * \param aPeriod The period which has just been solved.
+ */
 void World::runClimateModel( int aPeriod ) {
+    // Only one run of the climate model may be in progress at a time.
+    waitForClimateModel();
     if( aPeriod > 0 ) {
         setEmissions( aPeriod );
-        mClimateModel->runModel( scenario->getModeltime()->getper_to_yr( aPeriod ) );
+        const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
+        if( mClimateModelEmulator ) {
+            mClimateModelEmulator->runModel( year );
+            return;
+        }
+#if GCAM_PARALLEL_ENABLED
+        if( mClimateModelTask ) {
+            IClimateModel* climateModel = mClimateModel;
+            mClimateModelTask->mTaskGroup.run( [climateModel, year] {
+                climateModel->runModel( year );
+            } );
+            return;
+        }
+#endif
+        mClimateModel->runModel( year );
     }
 }
 
+/*!
+ * \brief Wait for any climate model run started by runClimateModel to finish.
+ * \details This is a no-op unless async-climate-model is set.  Any error from
+ *          the climate model run is rethrown here.
+ */
+void World::waitForClimateModel() const {
+#if GCAM_PARALLEL_ENABLED
+    if( mClimateModelTask ) {
+        mClimateModelTask->mTaskGroup.wait();
+    }
+#endif
+}
 
-//! write results for all regions to file
+
+/*!
+ * \brief Write results for all regions to file.
+ * \details When GCAM_PARALLEL_ENABLED and the boolean configuration value
+ *          "parallel-csv-output" is set the rows of each region are assembled
+ *          concurrently and then written in the order of the regions so that
+ *          the file is the same as when they are written one at a time.
+ */
 void World::csvOutputFile() const {
 
     // Write global data
     csvGlobalDataFile();
     
+#if GCAM_PARALLEL_ENABLED
+    CSVOutputBuffer* fileRows = CSVOutputBuffer::getCurrent();
+    if( fileRows && Configuration::getInstance()->getBool( "parallel-csv-output", false ) ) {
+        vector<CSVOutputBuffer> regionRows( mRegions.size() );
+        tbb::parallel_for( tbb::blocked_range<size_t>( 0, mRegions.size(), 1 ),
+            [this, &regionRows] ( const tbb::blocked_range<size_t>& aRange ) {
+                for( size_t i = aRange.begin(); i != aRange.end(); ++i ) {
+                    CSVOutputBuffer::Scope regionScope( regionRows[ i ] );
+                    mRegions[ i ]->csvOutputFile();
+                }
+            } );
+        for( size_t i = 0; i < regionRows.size(); ++i ) {
+            fileRows->append( regionRows[ i ] );
+        }
+        return;
+    }
+#endif
     for( CRegionIterator i = mRegions.begin(); i != mRegions.end(); i++ ){
         ( *i )->csvOutputFile();
     }
@@ -711,8 +976,8 @@ void World::csvGlobalDataFile() const {
     const int maxper = scenario->getModeltime()->getmaxper();
     vector<double> temp(maxper);
     // function protocol
-    void fileoutput3(string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3(const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     // write total emissions for World
     for ( int m = 0; m < maxper; m++ ){
@@ -725,12 +990,14 @@ void World::csvGlobalDataFile() const {
     fileoutput3( "global"," "," "," ","CO2 emiss","MTC",temp);
 
     // Write out concentrations.
+    waitForClimateModel();
     mClimateModel->printFileOutput();
 }
 
 //! MiniCAM style output to database
 void World::dbOutput( const list<string>& aPrimaryFuelList ) const {
     // Write out concentrations
+    waitForClimateModel();
     mClimateModel->printDBOutput();
 
     // call regional output
@@ -812,9 +1079,33 @@ void World::setTax( const GHGPolicy* aTax ){
 * \return The climate model.
 */
 const IClimateModel* World::getClimateModel() const {
+    waitForClimateModel();
+    return mClimateModel;
+}
+
+/*! \brief Return a mutable pointer to the climate model.
+ * \details Used by objects which need to run the climate model directly, such
+ *          as to calibrate a ClimateEmulator.
+ * \return The climate model.
+ */
+IClimateModel* World::getClimateModel() {
+    waitForClimateModel();
     return mClimateModel;
 }
 
+/*!
+ * \brief Set an emulator to run in place of the climate model.
+ * \details Emissions are still passed to the climate model but it is no longer
+ *          run by runClimateModel, instead the emulator is run once the
+ *          scenario is complete.
+ * \param aClimateModelEmulator The emulator to use, or null to go back to
+ *        running the climate model.  The World does not take ownership.
+ */
+void World::setClimateModelEmulator( IClimateModel* aClimateModelEmulator ) {
+    waitForClimateModel();
+    mClimateModelEmulator = aClimateModelEmulator;
+}
+
 /*! \brief A function to generate a series of ghg emissions quantity curves based on an already performed model run.
 * \details This function used the information stored in it to create a series of curves, one for each region,
 * with each datapoint containing a time period and an amount of gas emissions.
@@ -872,7 +1163,36 @@ CalcCounter* World::getCalcCounter() const {
 * \author Sonny Kim, Josh Lurz
 */
 void World::postCalc( const int aPeriod ){
+#if GCAM_PARALLEL_ENABLED
+    // Report the time per call of the flow graph calcs and the partial calcs
+    // which were run inline so far in the scenario so that flow-graph-inline-seconds may be tuned.
+    if( mGraphCalcStats.mCalls > 0 || mInlineCalcStats.mCalls > 0 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::DEBUG );
+        const CalcDispatchStats* stats[] = { &mGraphCalcStats, &mInlineCalcStats };
+        const char* names[] = { "Flow graph", "Inline" };
+        for( int i = 0; i < 2; ++i ) {
+            if( stats[ i ]->mCalls > 0 ) {
+                mainLog << names[ i ] << " calcs: " << stats[ i ]->mCalls << " calls, "
+                        << stats[ i ]->mActivities / stats[ i ]->mCalls << " activities and "
+                        << 1.0e6 * stats[ i ]->mSeconds / stats[ i ]->mCalls << " us per call, "
+                        << 1.0e6 * stats[ i ]->mSeconds / max( stats[ i ]->mActivities, 1.0 )
+                        << " us per activity." << endl;
+            }
+        }
+    }
+#endif
     // Finalize sectors.
+#if GCAM_PARALLEL_ENABLED
+    if( mParallelRegions ) {
+        tbb::parallel_for( tbb::blocked_range<size_t>( 0, mRegions.size(), 1 ), [this, aPeriod]( const tbb::blocked_range<size_t>& aRange ) {
+            for( size_t regionIndex = aRange.begin(); regionIndex != aRange.end(); ++regionIndex ) {
+                this->mRegions[ regionIndex ]->postCalc( aPeriod );
+            }
+        });
+        return;
+    }
+#endif
     for( RegionIterator region = mRegions.begin(); region != mRegions.end(); ++region ){
         (*region)->postCalc( aPeriod );
     }
@@ -899,6 +1219,8 @@ const GlobalTechnologyDatabase* World::getGlobalTechnologyDatabase() const {
 }
 
 /*! \brief Update a visitor for the World.
+* \details Visitors which implement IParallelRegionVisitor may have the regions
+*          visited concurrently, see that interface.
 * \param aVisitor Visitor to update.
 * \param aPeriod Period to update.
 */
@@ -909,9 +1231,40 @@ void World::accept( IVisitor* aVisitor, const int aPeriod ) const {
     scenario->getMarketplace()->accept( aVisitor, aPeriod );
 
     // Visit the climate model.
+    waitForClimateModel();
     mClimateModel->accept( aVisitor, aPeriod );
 
     // loop for regions
+#if GCAM_PARALLEL_ENABLED
+    IParallelRegionVisitor* parallelVisitor = dynamic_cast<IParallelRegionVisitor*>( aVisitor );
+    if( parallelVisitor && Configuration::getInstance()->getBool( "parallel-visit", false ) ) {
+        // Visit the regions in windows of a limited number of regions so that
+        // only that many region results are held at once.  A window of zero
+        // visits all of the regions together.
+        const int configWindow = Configuration::getInstance()->getInt( "parallel-visit-window", 0 );
+        const size_t window = configWindow > 0 ? configWindow : mRegions.size();
+        for( size_t windowStart = 0; windowStart < mRegions.size(); windowStart += window ) {
+            const size_t windowEnd = min( windowStart + window, mRegions.size() );
+            vector<IVisitor*> regionVisitors( windowEnd - windowStart );
+            for( size_t i = 0; i < regionVisitors.size(); ++i ) {
+                regionVisitors[ i ] = parallelVisitor->createRegionVisitor();
+            }
+            tbb::parallel_for( tbb::blocked_range<size_t>( windowStart, windowEnd, 1 ),
+                [this, &regionVisitors, windowStart, aPeriod]( const tbb::blocked_range<size_t>& aRange ) {
+                    for( size_t regionIndex = aRange.begin(); regionIndex != aRange.end(); ++regionIndex ) {
+                        this->mRegions[ regionIndex ]->accept( regionVisitors[ regionIndex - windowStart ], aPeriod );
+                    }
+                });
+            // Merge in region order so that the result does not depend on
+            // the order in which the regions finished.
+            for( size_t i = 0; i < regionVisitors.size(); ++i ) {
+                parallelVisitor->mergeRegionVisitor( regionVisitors[ i ] );
+                delete regionVisitors[ i ];
+            }
+        }
+    }
+    else
+#endif
     for( CRegionIterator currRegion = mRegions.begin(); currRegion != mRegions.end(); ++currRegion ){
         (*currRegion)->accept( aVisitor, aPeriod );
     }
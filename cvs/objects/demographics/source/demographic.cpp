@@ -349,8 +349,8 @@ void Demographic::csvOutputFile( const string& regionName ) const {
     vector<double> temp( maxPeriod );
 
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     // write population to temporary array since not all will be sent to output
     for ( int i = 0; i < maxPeriod; i++ ){
@@ -83,6 +83,8 @@ public:
     
     double getEmissionsReduction( const std::string& aRegionName, const int aPeriod, const GDP* aGDP );
 
+    virtual bool isPeriodConstant() const;
+
     virtual const std::string& getName() const;
 
     /*!
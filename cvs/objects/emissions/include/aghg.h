@@ -58,6 +58,7 @@
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
 #include "util/base/include/data_definition_util.h"
+#include "marketplace/include/cached_market_vector.h"
 
 // Forward declarations
 class GDP;
@@ -67,11 +68,13 @@ class AEmissionsDriver;
 class AEmissionsControl;
 class ICaptureComponent;
 class IInput;
-class CachedMarket;
 
 // Need to forward declare the subclasses as well.
 class CO2Emissions;
 class NonCO2Emissions;
+namespace objects {
+    class Atom;
+}
 
 /*! 
  * \ingroup Objects
@@ -107,6 +110,8 @@ public:
 
     virtual const std::string& getName() const;
 
+    const objects::Atom* getNameAtom() const;
+
     virtual void completeInit( const std::string& aRegionName,
                                const std::string& aSectorName,
                                const IInfo* aTechIInfo );
@@ -213,9 +218,13 @@ protected:
         DEFINE_VARIABLE( ARRAY | STATE, "emissions", mEmissions, objects::PeriodVector<Value> )
     )
     
-    //! Pre-located market which has been cached from the marketplace to get the price
+    //! Pre-located markets which have been cached from the marketplace in each period to get the price
     //! of this ghg and add demands to the market.
-    std::auto_ptr<CachedMarket> mCachedMarket;
+    CachedMarketVector mCachedMarket;
+
+    //! The interned name of the gas which is set in completeInit so that
+    //! visitors can match gases without comparing strings.
+    const objects::Atom* mNameAtom;
 
     /*!
      * \brief Parses any child nodes specific to derived classes
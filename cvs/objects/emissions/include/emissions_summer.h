@@ -44,10 +44,17 @@
 * \author Josh Lurz
 */
 
+#include <vector>
+#include <boost/shared_ptr.hpp>
 #include "util/base/include/time_vector.h"
 #include "util/base/include/default_visitor.h"
+#include "util/base/include/iparallel_region_visitor.h"
 #include "util/base/include/value.h"
 
+namespace objects {
+    class Atom;
+}
+
 /*! 
 * \ingroup Objects
 * \brief A class which sums emissions for a particular gas.
@@ -68,10 +75,17 @@ public:
     double areEmissionsSet( const int aPeriod ) const;
     
     const std::string& getGHGName() const;
+
+    const objects::Atom* getGHGAtom() const;
+
+    void addEmissions( const EmissionsSummer& aEmissionsSummer );
 private:
     //! The name of the GHG being summed.
     const std::string mGHGName;
 
+    //! The interned name of the GHG being summed.
+    const objects::Atom* mGHGAtom;
+
     //! The current sum.
     objects::PeriodVector<Value> mEmissionsByPeriod;
 };
@@ -89,9 +103,13 @@ private:
  *       Although this behavior could easily be changed.
  * \author Pralit Patel
  */
-class GroupedEmissionsSummer : public DefaultVisitor {
+class GroupedEmissionsSummer : public DefaultVisitor, public IParallelRegionVisitor {
 public:
     void addEmissionsSummer( EmissionsSummer* aEmissionsSummer );
+
+    // IParallelRegionVisitor methods
+    virtual IVisitor* createRegionVisitor() const;
+    virtual void mergeRegionVisitor( IVisitor* aRegionVisitor );
     
     // DefaultVisitor methods
     virtual void startVisitGHG( const AGHG* aGHG,
@@ -101,11 +119,14 @@ public:
                                        const int aPeriod );*/
     
 private:
-    //! A map of emissions summer by GHG name.  The memory for the EmissionsSummer
-    //! is not managed by this class.
-    std::map<std::string, EmissionsSummer*> mEmissionsSummers;
+    //! A map of emissions summer by interned GHG name.  The memory for the
+    //! EmissionsSummer is not managed by this class.
+    std::map<const objects::Atom*, EmissionsSummer*> mEmissionsSummers;
     
-    typedef std::map<std::string, EmissionsSummer*>::const_iterator CSummerIterator;
+    typedef std::map<const objects::Atom*, EmissionsSummer*>::const_iterator CSummerIterator;
+
+    //! The EmissionsSummers owned by a region visitor.
+    std::vector<boost::shared_ptr<EmissionsSummer> > mRegionSummers;
 };
 
 #endif // _EMISSIONS_SUMMER_H_
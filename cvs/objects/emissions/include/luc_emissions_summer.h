@@ -46,6 +46,7 @@
 
 #include "util/base/include/time_vector.h"
 #include "util/base/include/default_visitor.h"
+#include "util/base/include/iparallel_region_visitor.h"
 #include "util/base/include/value.h"
 
 /*! 
@@ -55,10 +56,14 @@
 * \author Josh Lurz
 */
 
-class LUCEmissionsSummer : public DefaultVisitor {
+class LUCEmissionsSummer : public DefaultVisitor, public IParallelRegionVisitor {
 public:
     explicit LUCEmissionsSummer( const std::string& aGHGName );
 
+    // IParallelRegionVisitor methods
+    virtual IVisitor* createRegionVisitor() const;
+    virtual void mergeRegionVisitor( IVisitor* aRegionVisitor );
+
     virtual void startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc,
                                        const int aPeriod );
 
@@ -67,6 +72,9 @@ public:
 
     double areEmissionsSet( const int aYear ) const;
 private:
+    void addCarbonCalcEmissions( const ICarbonCalc* aCarbonCalc,
+                                 const int aPeriod );
+
     //! The name of the GHG being summed.
     const std::string mGHGName;
 
@@ -48,6 +48,7 @@
 
 #include "emissions/include/aemissions_control.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class PointSetCurve;
 
@@ -75,6 +76,8 @@ public:
                            const NonCO2Emissions* aParentGHG,
                            const int aPeriod );
 
+    virtual bool isPeriodConstant() const;
+
 protected:
     MACControl( const MACControl& aOther );
     MACControl& operator=( const MACControl& aOther );
@@ -107,9 +110,25 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "mac-price-conversion", mCovertPriceValue, Value ),
         
         //! Name of market who's price is used to look up the curve.
-        DEFINE_VARIABLE( SIMPLE, "market-name", mPriceMarketName, std::string )
+        DEFINE_VARIABLE( SIMPLE, "market-name", mPriceMarketName, std::string ),
+        
+        //! The converted price at which mReduction was last calculated, or
+        //! -DBL_MAX if it has not been calculated in the current period.
+        DEFINE_VARIABLE( SIMPLE | STATE, "mac-price", mCachedMACPrice, Value )
     )
 
+    //! The largest price on the MAC curve, above which the curve is not extrapolated.
+    double mMaxMACPrice;
+
+    //! The reduction at a zero price, before any tech change is applied.
+    double mZeroCostReduction;
+
+    //! The accumulated tech change multiplier in each period.
+    objects::PeriodVector<double> mTechChangeMultiplier;
+
+    //! The price market located for each period.
+    CachedMarketVector mPriceMarket;
+
 private:
     void copy( const MACControl& other );
     double getMACValue( const double aCarbonPrice ) const;
@@ -123,9 +123,23 @@ protected:
                                 
         //! Stored Emissions Coefficient (needed for some control technologies)
         //! The emissions coefficient is the current ratio of emissions to driver, accounting for any controls   
-        DEFINE_VARIABLE( ARRAY | STATE, "control-adjusted-emiss-coef", mAdjustedEmissCoef, objects::PeriodVector<Value> )
+        DEFINE_VARIABLE( ARRAY | STATE, "control-adjusted-emiss-coef", mAdjustedEmissCoef, objects::PeriodVector<Value> ),
+
+        //! The product of one minus the reductions of the period constant
+        //! emissions controls, or -DBL_MAX if it has not been calculated yet
+        //! in the current period.
+        DEFINE_VARIABLE( SIMPLE | STATE, "fixed-control-multiplier", mFixedControlMult, Value )
     )
 
+    //! The emissions controls whose reductions must be recalculated in every
+    //! World.calc, set in initCalc.  These are weak references into
+    //! mEmissionsControls.
+    std::vector<AEmissionsControl*> mPriceControls;
+
+    //! The period for which initCalc last set mPriceControls and reset
+    //! mFixedControlMult.
+    int mControlPeriod;
+
     //! A flag to indicate if mInputEmissions should be used recalibrate mEmissionsCoef
     //! in the current model period.
     bool mShouldCalibrateEmissCoef;
@@ -144,6 +158,10 @@ protected:
     void clear();
 
     void copy( const NonCO2Emissions& aOther );
+
+    double calcFixedControlMult( const std::string& aRegionName, const int aPeriod ) const;
+
+    double calcPriceControlMult( const std::string& aRegionName, const int aPeriod ) const;
 };
 
 #endif // _NONCO2_EMISSIONS_H_
@@ -145,6 +145,20 @@ double AEmissionsControl::getEmissionsReduction( const std::string& aRegionName,
     return mReduction;
 }
 
+/*!
+ * \brief Whether the reduction is fixed for a period once initCalc has been
+ *        called.
+ * \details The reductions of controls which are period constant may be
+ *          calculated once per period and folded together by the containing
+ *          NonCO2Emissions rather than recalculated in every World.calc.
+ *          Controls whose reduction depends on a market price must override
+ *          this to return false.
+ * \return True, the default.
+ */
+bool AEmissionsControl::isPeriodConstant() const {
+    return true;
+}
+
 void AEmissionsControl::setEmissionsReduction( double aReduction ){
     mReduction = aReduction;
 }
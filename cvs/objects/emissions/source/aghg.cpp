@@ -54,8 +54,9 @@
 #include "util/logger/include/ilogger.h"
 #include "technologies/include/ioutput.h"
 #include "technologies/include/icapture_component.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 #include "containers/include/market_dependency_finder.h"
+#include "util/base/include/atom_registry.h"
 
 using namespace std;
 using namespace xercesc;
@@ -63,7 +64,8 @@ using namespace xercesc;
 extern Scenario* scenario;
 
 //! Default constructor.
-AGHG::AGHG()
+AGHG::AGHG():
+mNameAtom( 0 )
 {
 }
 
@@ -75,6 +77,7 @@ AGHG::~AGHG(){
 void AGHG::copy( const AGHG& aOther ){
     mName = aOther.mName;
     mEmissionsUnit = aOther.mEmissionsUnit;
+    mNameAtom = aOther.mNameAtom;
 
     // Note results (such as emissions) are never copied.
 }
@@ -146,6 +149,17 @@ const string& AGHG::getName() const {
     return mName;
 }
 
+/*!
+ * \brief Get the interned name of the gas.
+ * \details The name is interned in completeInit.  Before that the registry is
+ *          searched instead, which will return null if no object has interned
+ *          the name.
+ * \return The interned name of the gas.
+ */
+const objects::Atom* AGHG::getNameAtom() const {
+    return mNameAtom ? mNameAtom : objects::AtomRegistry::getInstance()->findAtom( getName() );
+}
+
 /*!
  * \brief Complete the initialization of the ghg object.
  * \note This routine is only called once per model run
@@ -158,6 +172,8 @@ const string& AGHG::getName() const {
 void AGHG::completeInit( const string& aRegionName, const string& aSectorName,
                          const IInfo* aTechInfo )
 {
+    mNameAtom = objects::AtomRegistry::getInstance()->getAtom( getName() );
+
     scenario->getMarketplace()->getDependencyFinder()->addDependency( aSectorName,
                                                                       aRegionName,
                                                                       getName(),
@@ -172,7 +188,7 @@ void AGHG::completeInit( const string& aRegionName, const string& aSectorName,
  * \param aPeriod Model period.
  */
 void AGHG::initCalc( const string& aRegionName, const IInfo* aLocalInfo, const int aPeriod ) {
-    mCachedMarket = scenario->getMarketplace()->locateMarket( getName(), aRegionName, aPeriod );
+    mCachedMarket.locateMarket( getName(), aRegionName, aPeriod );
 }
 
 /*!
@@ -182,7 +198,7 @@ void AGHG::initCalc( const string& aRegionName, const IInfo* aLocalInfo, const i
  */
 void AGHG::addEmissionsToMarket( const string& aRegionName, const int aPeriod ){
     // set emissions as demand side of gas market
-    mCachedMarket->addToDemand( getName(), aRegionName,
+    mCachedMarket.addToDemand( getName(), aRegionName,
                                 mEmissions[ aPeriod ],
                                 aPeriod, false );
 }
@@ -206,7 +222,7 @@ double AGHG::getGHGValue( const IInput* aInput, const string& aRegionName,
                           const int aPeriod ) const
 {
     // Determine if there is a tax.
-    double ghgTax = mCachedMarket->getPrice( getName(), aRegionName, aPeriod, false );
+    double ghgTax = mCachedMarket.getPrice( getName(), aRegionName, aPeriod, false );
     if( ghgTax == Marketplace::NO_MARKET_PRICE ){
         ghgTax = 0;
     }
@@ -244,7 +260,7 @@ double AGHG::getGHGValue( const IOutput* aOutput, const string& aRegionName,
                           const int aPeriod ) const
 {
     // Determine if there is a tax.
-    double ghgTax = mCachedMarket->getPrice( getName(), aRegionName, aPeriod, false );
+    double ghgTax = mCachedMarket.getPrice( getName(), aRegionName, aPeriod, false );
     if( ghgTax == Marketplace::NO_MARKET_PRICE ){
         ghgTax = 0;
     }
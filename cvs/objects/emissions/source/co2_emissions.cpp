@@ -45,7 +45,7 @@
 #include "functions/include/iinput.h"
 #include "technologies/include/ioutput.h"
 #include "technologies/include/icapture_component.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 #include "marketplace/include/marketplace.h"
 
 using namespace std;
@@ -159,7 +159,7 @@ double CO2Emissions::getGHGValue( const std::string& aRegionName,
     double removeFraction = aSequestrationDevice ? aSequestrationDevice->getRemoveFraction( getName() ) : 0;
 
     // Get the greenhouse gas tax from the marketplace.
-    double GHGTax = mCachedMarket->getPrice( getName(), aRegionName, aPeriod, false );
+    double GHGTax = mCachedMarket.getPrice( getName(), aRegionName, aPeriod, false );
 
     if( GHGTax == Marketplace::NO_MARKET_PRICE ){
         GHGTax = 0;
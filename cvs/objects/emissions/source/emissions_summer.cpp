@@ -43,6 +43,7 @@
 #include <cassert>
 #include "emissions/include/emissions_summer.h"
 #include "emissions/include/aghg.h"
+#include "util/base/include/atom_registry.h"
 
 using namespace std;
 
@@ -50,7 +51,8 @@ using namespace std;
 * \param aGHG GHG that is being summed.
 */
 EmissionsSummer::EmissionsSummer( const string& aGHGName ):
-mGHGName( aGHGName ){
+mGHGName( aGHGName ),
+mGHGAtom( objects::AtomRegistry::getInstance()->getAtom( aGHGName ) ){
 }
 
 /*! \brief Add emissions from a GHG to the stored emissions.
@@ -58,7 +60,7 @@ mGHGName( aGHGName ){
 * \param aPeriod Period in which to update.
 */
 void EmissionsSummer::startVisitGHG( const AGHG* aGHG, const int aPeriod ){
-    if( aGHG->getName() == mGHGName ){
+    if( aGHG->getNameAtom() == mGHGAtom ){
         mEmissionsByPeriod[ aPeriod ] += aGHG->getEmission( aPeriod );
     }
 }
@@ -90,6 +92,29 @@ const string& EmissionsSummer::getGHGName() const {
     return mGHGName;
 }
 
+/*!
+ * \brief Get the interned GHG name.
+ * \return The interned name of the GHG that is summed by this object.
+ */
+const objects::Atom* EmissionsSummer::getGHGAtom() const {
+    return mGHGAtom;
+}
+
+/*!
+ * \brief Add the emissions summed by another EmissionsSummer for the same GHG.
+ * \details Only periods which the other summer has set emissions for are
+ *          added so that areEmissionsSet is unchanged for the rest.
+ * \param aEmissionsSummer The summer to add emissions from.
+ */
+void EmissionsSummer::addEmissions( const EmissionsSummer& aEmissionsSummer ) {
+    assert( aEmissionsSummer.mGHGName == mGHGName );
+    for( int period = 0; period < scenario->getModeltime()->getmaxper(); ++period ) {
+        if( aEmissionsSummer.areEmissionsSet( period ) ) {
+            mEmissionsByPeriod[ period ] += aEmissionsSummer.getEmissions( period );
+        }
+    }
+}
+
 /*!
  * \brief Add an EmissionsSummer to the group.
  * \details The given EmissionsSummer will be updated for all model periods.  The
@@ -97,16 +122,46 @@ const string& EmissionsSummer::getGHGName() const {
  * \param A refernce to an EmissionsSummer to update when this group is updated.
  */
 void GroupedEmissionsSummer::addEmissionsSummer( EmissionsSummer* aEmissionsSummer ) {
-    mEmissionsSummers[ aEmissionsSummer->getGHGName() ] = aEmissionsSummer;
+    mEmissionsSummers[ aEmissionsSummer->getGHGAtom() ] = aEmissionsSummer;
 }
 
 void GroupedEmissionsSummer::startVisitGHG( const AGHG* aGHG, const int aPeriod ) {
     // We are currently assuming all periods should be updated.
     
-    CSummerIterator it = mEmissionsSummers.find( aGHG->getName() );
+    CSummerIterator it = mEmissionsSummers.find( aGHG->getNameAtom() );
     if( it != mEmissionsSummers.end() ) {
         for( int period = 1; period < scenario->getModeltime()->getmaxper(); ++period ) {
             (*it).second->startVisitGHG( aGHG, period );
         }
     }
 }
+
+/*!
+ * \brief Create a visitor which sums the emissions of a single region.
+ * \details The region visitor sums the same GHGs as this group into
+ *          EmissionsSummers of its own.
+ * \return The region visitor.
+ */
+IVisitor* GroupedEmissionsSummer::createRegionVisitor() const {
+    GroupedEmissionsSummer* regionSummer = new GroupedEmissionsSummer();
+    for( CSummerIterator it = mEmissionsSummers.begin(); it != mEmissionsSummers.end(); ++it ) {
+        boost::shared_ptr<EmissionsSummer> summer( new EmissionsSummer( it->second->getGHGName() ) );
+        regionSummer->mRegionSummers.push_back( summer );
+        regionSummer->addEmissionsSummer( summer.get() );
+    }
+    return regionSummer;
+}
+
+/*!
+ * \brief Add the emissions summed by a region visitor to the summers of this
+ *        group.
+ * \details Note that since the emissions are first summed by region the totals
+ *          may differ from a serial visit in the last digits.
+ * \param aRegionVisitor A visitor created by createRegionVisitor.
+ */
+void GroupedEmissionsSummer::mergeRegionVisitor( IVisitor* aRegionVisitor ) {
+    GroupedEmissionsSummer* regionSummer = static_cast<GroupedEmissionsSummer*>( aRegionVisitor );
+    for( CSummerIterator it = regionSummer->mEmissionsSummers.begin(); it != regionSummer->mEmissionsSummers.end(); ++it ) {
+        mEmissionsSummers[ it->first ]->addEmissions( *it->second );
+    }
+}
@@ -56,8 +56,57 @@ LUCEmissionsSummer::LUCEmissionsSummer( const string& aGHGName ):
 {
 }
 
+/*!
+ * \brief Add the emissions of a carbon calculator.
+ * \details If the period is -1 the emissions of every model period, after the
+ *          base period, are added so that a single visit may update all of
+ *          them at once.
+ * \param aCarbonCalc The carbon calculator.
+ * \param aPeriod The model period or -1 for all model periods.
+ */
 void LUCEmissionsSummer::startVisitCarbonCalc( const ICarbonCalc* aCarbonCalc,
                                                const int aPeriod )
+{
+    if( aPeriod == -1 ) {
+        for( int period = 1; period < scenario->getModeltime()->getmaxper(); ++period ) {
+            addCarbonCalcEmissions( aCarbonCalc, period );
+        }
+    }
+    else {
+        addCarbonCalcEmissions( aCarbonCalc, aPeriod );
+    }
+}
+
+/*!
+ * \brief Create a visitor which sums the emissions of a single region.
+ * \return The region visitor.
+ */
+IVisitor* LUCEmissionsSummer::createRegionVisitor() const {
+    return new LUCEmissionsSummer( mGHGName );
+}
+
+/*!
+ * \brief Add the emissions summed by a region visitor to this summer.
+ * \details Note that since the emissions are first summed by region the totals
+ *          may differ from a serial visit in the last digits.
+ * \param aRegionVisitor A visitor created by createRegionVisitor.
+ */
+void LUCEmissionsSummer::mergeRegionVisitor( IVisitor* aRegionVisitor ) {
+    const LUCEmissionsSummer* regionSummer = static_cast<LUCEmissionsSummer*>( aRegionVisitor );
+    for( unsigned int year = mEmissionsByYear.getStartYear(); year <= mEmissionsByYear.getEndYear(); ++year ) {
+        if( regionSummer->areEmissionsSet( year ) ) {
+            mEmissionsByYear[ year ] += regionSummer->getEmissions( year );
+        }
+    }
+}
+
+/*!
+ * \brief Add the emissions of a carbon calculator for a single model period.
+ * \param aCarbonCalc The carbon calculator.
+ * \param aPeriod The model period.
+ */
+void LUCEmissionsSummer::addCarbonCalcEmissions( const ICarbonCalc* aCarbonCalc,
+                                                 const int aPeriod )
 {
     const int currYear = scenario->getModeltime()->getper_to_yr( aPeriod );
     // Add land use change emissions.
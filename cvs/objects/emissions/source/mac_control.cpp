@@ -66,10 +66,14 @@ MACControl::MACControl():
 AEmissionsControl(),
 mNoZeroCostReductions( false ),
 mTechChange( 0.0 ),
+mMacCurve( new PointSetCurve( new ExplicitPointSet() ) ),
 mZeroCostPhaseInTime( 25 ),
 mCovertPriceValue( 1 ),
 mPriceMarketName( "CO2" ),
-mMacCurve( new PointSetCurve( new ExplicitPointSet() ) )
+mCachedMACPrice( -DBL_MAX ),
+mMaxMACPrice( 0 ),
+mZeroCostReduction( 0 ),
+mTechChangeMultiplier( 1.0 )
 {
 }
 
@@ -115,6 +119,9 @@ void MACControl::copy( const MACControl& aOther ){
     mZeroCostPhaseInTime = aOther.mZeroCostPhaseInTime;
     mCovertPriceValue = aOther.mCovertPriceValue;
     mPriceMarketName = aOther.mPriceMarketName;
+    mMaxMACPrice = aOther.mMaxMACPrice;
+    mZeroCostReduction = aOther.mZeroCostReduction;
+    mTechChangeMultiplier = aOther.mTechChangeMultiplier;
 }
 
 /*!
@@ -198,6 +205,21 @@ void MACControl::completeInit( const string& aRegionName, const string& aSectorN
         mainLog.setLevel( ILogger::WARNING );
         mainLog << "MAC Curve " << getName() << " appears to have no data. " << endl;
     }
+
+    // The curve and tech change are fixed once read in so the parts of the
+    // reduction which do not depend on the price are calculated only once
+    // rather than in every call to calcEmissionsReduction.
+    mMaxMACPrice = mMacCurve->getMaxX();
+    mZeroCostReduction = getMACValue( 0 );
+
+    // note technical change is a rate of change per year, therefore we must
+    // be sure to apply it for as many years as are in a model time step
+    const Modeltime* modeltime = scenario->getModeltime();
+    double techChange = 1;
+    for( int period = 0; period < modeltime->getmaxper(); ++period ) {
+        techChange *= pow( 1 + mTechChange[ period ], modeltime->gettimestep( period ) );
+        mTechChangeMultiplier[ period ] = techChange;
+    }
 }
 
 void MACControl::initCalc( const string& aRegionName,
@@ -205,6 +227,19 @@ void MACControl::initCalc( const string& aRegionName,
                            const NonCO2Emissions* aParentGHG,
                            const int aPeriod )
 {
+    mPriceMarket.locateMarket( mPriceMarketName, aRegionName, aPeriod );
+
+    // The reduction in a previous period is not valid for this one.
+    mCachedMACPrice = -DBL_MAX;
+}
+
+/*!
+ * \brief The reduction depends on the emissions price unless the MAC curve has
+ *        been turned off with a negative price conversion.
+ * \return Whether the MAC curve is turned off.
+ */
+bool MACControl::isPeriodConstant() const {
+    return mCovertPriceValue < 0;
 }
 
 void MACControl::calcEmissionsReduction( const std::string& aRegionName, const int aPeriod, const GDP* aGDP ) {
@@ -214,14 +249,23 @@ void MACControl::calcEmissionsReduction( const std::string& aRegionName, const i
         return;
     }
     
-    const Marketplace* marketplace = scenario->getMarketplace();
-    double emissionsPrice = marketplace->getPrice( mPriceMarketName, aRegionName, aPeriod, false );
+    double emissionsPrice = mPriceMarket.getPrice( mPriceMarketName, aRegionName, aPeriod, false );
     if( emissionsPrice == Marketplace::NO_MARKET_PRICE ) {
         emissionsPrice = 0;
     }
     
     emissionsPrice *= mCovertPriceValue;
 
+    // The reduction depends only on the price within a period.  Most calls,
+    // such as partial derivatives with respect to other markets, see the same
+    // price as the last call so the reduction already set can be kept.  The
+    // cached price is state so that concurrent evaluations each compare
+    // against their own last price.
+    if( emissionsPrice == mCachedMACPrice ) {
+        return;
+    }
+    mCachedMACPrice = emissionsPrice;
+
     double reduction = getMACValue( emissionsPrice );
     reduction = adjustForTechChange( aPeriod, reduction );
     
@@ -242,12 +286,12 @@ void MACControl::calcEmissionsReduction( const std::string& aRegionName, const i
     int modelYear = scenario->getModeltime()->getper_to_yr( aPeriod );
 
     // Amount of zero-cost reduction
-    double zeroCostReduction = getMACValue( 0 );
+    const double zeroCostReduction = mZeroCostReduction;
 
     if ( ( reduction > 0.0 ) && ( zeroCostReduction > 0.0 ) &&
         ( modelYear <= ( lastCalYear + mZeroCostPhaseInTime ) ) )
     {
-        const double maxEmissionsTax = mMacCurve->getMaxX();
+        const double maxEmissionsTax = mMaxMACPrice;
 
 		// Fraction of zero cost that is removed from original reduction value
 		// Equal to 1 at last calibration year and zero at the zero cost phase in time
@@ -271,7 +315,7 @@ void MACControl::calcEmissionsReduction( const std::string& aRegionName, const i
  * \param aCarbonPrice carbon price
  */
 double MACControl::getMACValue( const double aCarbonPrice ) const {
-    const double maxCO2Tax = mMacCurve->getMaxX();
+    const double maxCO2Tax = mMaxMACPrice;
     
     // so that getY function won't interpolate beyond last value
     double effectiveCarbonPrice = min( aCarbonPrice, maxCO2Tax );
@@ -301,15 +345,7 @@ double MACControl::getMACValue( const double aCarbonPrice ) const {
  */
 double MACControl::adjustForTechChange( const int aPeriod, double reduction ) {
 
-    // note technical change is a rate of change per year, therefore we must
-    // be sure to apply it for as many years as are in a model time step
-    double techChange = 1;
-    int timestep = scenario->getModeltime()->gettimestep( 0 );
-    for ( int i=0; i <= aPeriod; i++ ) {
-        timestep = scenario->getModeltime()->gettimestep( i );
-        techChange *= pow( 1 + mTechChange[ i ], timestep );
-    }
-    reduction *= techChange;
+    reduction *= mTechChangeMultiplier[ aPeriod ];
     
     // TODO: Include read-in max reduction -- some sectors really shouldn't be able to reduce 100%. We could allow a read-in maximum
     if ( reduction > 1 ) {
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 
+#include <cfloat>
 #include <xercesc/dom/DOMNode.hpp>
 
 #include "emissions/include/nonco2_emissions.h"
@@ -55,7 +56,7 @@
 #include "containers/include/iinfo.h"
 #include "technologies/include/ioutput.h"
 #include "functions/include/function_utils.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 #include "technologies/include/icapture_component.h"
 
 using namespace std;
@@ -66,6 +67,7 @@ extern Scenario* scenario;
 //! Default constructor.
 NonCO2Emissions::NonCO2Emissions():
 AGHG(),
+mControlPeriod( -1 ),
 mShouldCalibrateEmissCoef( false ),
 mGDP( 0 )
 {
@@ -262,11 +264,20 @@ void NonCO2Emissions::initCalc( const string& aRegionName, const IInfo* aTechInf
     // the initial vintage year of the technology.
     mShouldCalibrateEmissCoef = mInputEmissions.isInited() && aTechInfo->getBoolean( "new-vintage-tech", true );
     
+    mPriceControls.clear();
     for ( CControlIterator controlIt = mEmissionsControls.begin(); controlIt != mEmissionsControls.end(); ++controlIt ) {
         (*controlIt)->initCalc( aRegionName, aTechInfo, this, aPeriod );
+        if( !(*controlIt)->isPeriodConstant() ) {
+            mPriceControls.push_back( *controlIt );
+        }
     }
+    // The reductions of the period constant controls are folded into a single
+    // multiplier the first time emissions are calculated rather than here since
+    // the regional GDP for the period has not been calculated yet.
+    mControlPeriod = aPeriod;
+    mFixedControlMult = -DBL_MAX;
 
-    const bool isTechOperating = aTechInfo->getBoolean( "is-tech-operating", true );
+    const bool isTechOperating = aTechInfo->getBoolean( InfoKeys::eIsTechOperating, true );
     // Ensure the user set an emissions coefficient in the input, either by reading it in, copying it from the previous period
     // or reading in the emissions
     if( !mEmissionsCoef.isInited() && !mShouldCalibrateEmissCoef && isTechOperating ){
@@ -297,7 +308,7 @@ double NonCO2Emissions::getGHGValue( const string& aRegionName,
     // Conversion from teragrams (Tg=MT) of X per EJ to metric tons of X per GJ
     const double CVRT_Tg_per_EJ_to_Tonne_per_GJ = 1e-3;
     
-    double GHGTax = mCachedMarket->getPrice( getName(), aRegionName, aPeriod, false );
+    double GHGTax = mCachedMarket.getPrice( getName(), aRegionName, aPeriod, false );
     if( GHGTax == Marketplace::NO_MARKET_PRICE ){
         return 0;
     }
@@ -313,9 +324,9 @@ double NonCO2Emissions::getGHGValue( const string& aRegionName,
     // Compute emissions reductions. These are only applied in future years
     double emissMult = 1.0;
     if ( aPeriod > scenario->getModeltime()->getFinalCalibrationPeriod() ) {
-        for ( CControlIterator controlIt = mEmissionsControls.begin(); controlIt != mEmissionsControls.end(); ++controlIt ) {
-            emissMult *= 1.0 - (*controlIt)->getEmissionsReduction( aRegionName, aPeriod, mGDP );
-        }
+        const bool isFixedMultSet = aPeriod == mControlPeriod && mFixedControlMult != -DBL_MAX;
+        emissMult = ( isFixedMultSet ? mFixedControlMult : calcFixedControlMult( aRegionName, aPeriod ) )
+            * calcPriceControlMult( aRegionName, aPeriod );
     }
     
     /*!
@@ -371,9 +382,17 @@ void NonCO2Emissions::calcEmission( const string& aRegionName,
     // Compute emissions reductions. These are only applied in future years
     double emissMult = 1.0;
     if ( aPeriod > scenario->getModeltime()->getFinalCalibrationPeriod() ) {
-        for ( CControlIterator controlIt = mEmissionsControls.begin(); controlIt != mEmissionsControls.end(); ++controlIt ) {
-            emissMult *= 1.0 - (*controlIt)->getEmissionsReduction( aRegionName, aPeriod, mGDP );
+        double fixedMult;
+        if( aPeriod != mControlPeriod ) {
+            fixedMult = calcFixedControlMult( aRegionName, aPeriod );
         }
+        else {
+            if( mFixedControlMult == -DBL_MAX ) {
+                mFixedControlMult = calcFixedControlMult( aRegionName, aPeriod );
+            }
+            fixedMult = mFixedControlMult;
+        }
+        emissMult = fixedMult * calcPriceControlMult( aRegionName, aPeriod );
     }
     
     // Compute emissions, including any reductions.
@@ -395,6 +414,52 @@ void NonCO2Emissions::calcEmission( const string& aRegionName,
     addEmissionsToMarket( aRegionName, aPeriod );
 }
 
+/*!
+ * \brief Calculate the combined multiplier of the period constant emissions
+ *        controls.
+ * \param aRegionName Region name.
+ * \param aPeriod Model period.
+ * \return The product of one minus the reduction of each control for which
+ *         isPeriodConstant is true.
+ */
+double NonCO2Emissions::calcFixedControlMult( const string& aRegionName, const int aPeriod ) const {
+    double emissMult = 1.0;
+    for ( CControlIterator controlIt = mEmissionsControls.begin(); controlIt != mEmissionsControls.end(); ++controlIt ) {
+        if( (*controlIt)->isPeriodConstant() ) {
+            emissMult *= 1.0 - (*controlIt)->getEmissionsReduction( aRegionName, aPeriod, mGDP );
+        }
+    }
+    return emissMult;
+}
+
+/*!
+ * \brief Calculate the combined multiplier of the emissions controls which
+ *        depend on prices.
+ * \details If called for a period other than the one initCalc was last called
+ *          for, mPriceControls has not been set for it and every control which
+ *          is not period constant is evaluated instead.
+ * \param aRegionName Region name.
+ * \param aPeriod Model period.
+ * \return The product of one minus the reduction of each price dependent
+ *         control.
+ */
+double NonCO2Emissions::calcPriceControlMult( const string& aRegionName, const int aPeriod ) const {
+    double emissMult = 1.0;
+    if( aPeriod == mControlPeriod ) {
+        for ( CControlIterator controlIt = mPriceControls.begin(); controlIt != mPriceControls.end(); ++controlIt ) {
+            emissMult *= 1.0 - (*controlIt)->getEmissionsReduction( aRegionName, aPeriod, mGDP );
+        }
+    }
+    else {
+        for ( CControlIterator controlIt = mEmissionsControls.begin(); controlIt != mEmissionsControls.end(); ++controlIt ) {
+            if( !(*controlIt)->isPeriodConstant() ) {
+                emissMult *= 1.0 - (*controlIt)->getEmissionsReduction( aRegionName, aPeriod, mGDP );
+            }
+        }
+    }
+    return emissMult;
+}
+
 void NonCO2Emissions::doInterpolations( const int aYear, const int aPreviousYear,
                                         const int aNextYear, const AGHG* aPreviousGHG,
                                         const AGHG* aNextGHG )
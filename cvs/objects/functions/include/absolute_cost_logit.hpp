@@ -69,7 +69,7 @@
  *
  * \author Robert Link
  */
-class AbsoluteCostLogit : public IDiscreteChoice {
+class AbsoluteCostLogit final : public IDiscreteChoice {
     friend class CalibrateShareWeightVisitor;
 public:
     AbsoluteCostLogit();
@@ -94,6 +94,10 @@ public:
 
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const;
+
+    virtual void calcUnnormalizedShares( const double* aShareWeights, const double* aValues,
+                                         double* aLogShares, const size_t aNumOptions,
+                                         const int aPeriod ) const;
     
     virtual double calcAverageValue( const double aUnnormalizedShareSum,
                                      const double aLogShareFac,
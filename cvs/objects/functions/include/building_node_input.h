@@ -124,6 +124,9 @@ public:
 
 	double getInternalGains( const int aPeriod ) const;
 
+	double getThermalLoad( const size_t aChildIndex, const double aInternalGainsPerSqMeter,
+	                       const int aPeriod ) const;
+
 	SatiationDemandFunction* getSatiationDemandFunction() const;
 
     // INestedInput methods
@@ -422,6 +425,17 @@ protected:
 
     //! Cache the vector of children as IInput* which is needed for the mFunction
     std::vector<IInput*> mChildInputsCache;
+
+    //! The part of the thermal load of each child in mChildInputsCache which
+    //! does not depend on internal gains, prepared during initCalc.
+    std::vector<double> mFixedThermalLoad;
+
+    //! The internal gains scalar of each child in mChildInputsCache, prepared
+    //! during initCalc.
+    std::vector<double> mInternalGainsScalar;
+
+    //! The period for which mFixedThermalLoad and mInternalGainsScalar are valid.
+    int mThermalLoadPeriod;
                           
     //! Stored region name only necessary because there is no
     //! post calc to store the trial internal gains supply
@@ -50,6 +50,7 @@
 #include "functions/include/inested_input.h"
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class IFunction;
 class BuildingNodeInput;
@@ -95,6 +96,11 @@ public:
                                     const double aInternalGainsPerSqMeter,
                                     const int aPeriod ) const;
 
+    virtual void calcThermalLoadCoefficients( const BuildingNodeInput* aBuildingInput,
+                                              const int aPeriod,
+                                              double& aFixedLoad,
+                                              double& aInternalGainsScalar ) const;
+
     // INestedInput methods
     // define them to do nothing since a BuildingServiceInput is a leaf in the nesting structure
     // this should be the end point for recursion
@@ -329,6 +335,10 @@ protected:
         //! Satiation demand function.
         DEFINE_VARIABLE( CONTAINER, "satiation-demand-function", mSatiationDemandFunction, SatiationDemandFunction* )
     )
+
+    //! Pre-located markets which have been cached from the marketplace in each
+    //! period to get the price and add demands to.
+    CachedMarketVector mCachedMarket;
     
     void copy( const BuildingServiceInput& aInput );
 };
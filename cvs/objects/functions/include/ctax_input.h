@@ -72,7 +72,7 @@ class Tabs;
  *
  * \author Pralit Patel
  */
-class CTaxInput: public MiniCAMInput
+class CTaxInput final: public MiniCAMInput
 {
     friend class InputFactory;
 public:
@@ -51,10 +51,10 @@
 #include "functions/include/minicam_input.h"
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class Tabs;
 class ICoefficient;
-class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -82,7 +82,7 @@ class CachedMarket;
  *
  * \author Josh Lurz
  */
-class EnergyInput: public MiniCAMInput
+class EnergyInput final: public MiniCAMInput
 {
     friend class InputFactory;
 public:
@@ -206,12 +206,37 @@ protected:
         DEFINE_VARIABLE( ARRAY | STATE, "current-coef", mAdjustedCoefficients, objects::PeriodVector<Value> )
     )
     
-    //! A pre-located market which has been cahced from the marketplace to get
+    //! Pre-located markets which have been cached from the marketplace in each period to get
     //! the price and add demands to.
-    std::auto_ptr<CachedMarket> mCachedMarket;
+    CachedMarketVector mCachedMarket;
 
 private:
     const static std::string XML_REPORTING_NAME; //!< tag name for reporting xml db 
 };
 
+// Inline function definitions.
+inline double EnergyInput::getPrice( const std::string& aRegionName,
+                                     const int aPeriod ) const
+{
+    return mPriceUnitConversionFactor *
+        mCachedMarket.getPrice( mName, mMarketName, aPeriod );
+}
+
+inline void EnergyInput::setPhysicalDemand( double aPhysicalDemand,
+                                            const std::string& aRegionName,
+                                            const int aPeriod )
+{
+    mPhysicalDemand[ aPeriod ].set( aPhysicalDemand );
+    mCachedMarket.addToDemand( mName, mMarketName,
+                                       mPhysicalDemand[ aPeriod ],
+                                       aPeriod, true );
+}
+
+inline double EnergyInput::getCoefficient( const int aPeriod ) const {
+    // Check that the coefficient has been initialized.
+    assert( mAdjustedCoefficients[ aPeriod ].isInited() );
+
+    return mAdjustedCoefficients[ aPeriod ];
+}
+
 #endif // _ENERGY_INPUT_H_
@@ -43,11 +43,14 @@
  * \brief IDiscreteChoice class declaration file
  * \author Robert Link
  */
+#include <limits>
+#include <utility>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/iparsable.h"
 #include "util/base/include/iround_trippable.h"
 #include "util/base/include/data_definition_util.h"
+#include "sectors/include/sector_utils.h"
 
 // Need to forward declare the subclasses as well.
 class RelativeCostLogit;
@@ -127,6 +130,59 @@ public:
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const = 0;
 
+    /*!
+     * \brief Compute the unnormalized shares of several options at once.
+     * \details Subclasses may override this to evaluate the options in a tight
+     *          loop with the parameters of the period looked up only once.  The
+     *          default implementation calls calcUnnormalizedShare for each.
+     * \param aShareWeights The share weight of each option.
+     * \param aValues The value of each option.
+     * \param aLogShares The log of the unnormalized share of each option.
+     * \param aNumOptions The number of options.
+     * \param aPeriod The current model period.
+     */
+    virtual void calcUnnormalizedShares( const double* aShareWeights, const double* aValues,
+                                         double* aLogShares, const size_t aNumOptions,
+                                         const int aPeriod ) const
+    {
+        for( size_t i = 0; i < aNumOptions; ++i ) {
+            aLogShares[ i ] = calcUnnormalizedShare( aShareWeights[ i ], aValues[ i ], aPeriod );
+        }
+    }
+
+    /*!
+     * \brief Compute the normalized shares of several options at once.
+     * \details Calculates the unnormalized shares with calcUnnormalizedShares,
+     *          adds any additional log share terms such as fuel preferences and
+     *          then normalizes the shares, all in a single pass over the
+     *          options.  An option with a log share adjustment of negative
+     *          infinity receives no share regardless of its share weight and
+     *          value.
+     * \param aShareWeights The share weight of each option.
+     * \param aValues The value of each option.
+     * \param aLogShareAdjustments A term to add to the log of the unnormalized
+     *                             share of each option or null if there are none.
+     * \param aShares The normalized share of each option, not the log.
+     * \param aNumOptions The number of options.
+     * \param aPeriod The current model period.
+     * \return The unnormalized sum of the shares and the log adjustment factor
+     *         which was factored out of it as in SectorUtils::normalizeLogShares.
+     */
+    std::pair<double, double> calcShares( const double* aShareWeights, const double* aValues,
+                                          const double* aLogShareAdjustments, double* aShares,
+                                          const size_t aNumOptions, const int aPeriod ) const
+    {
+        calcUnnormalizedShares( aShareWeights, aValues, aShares, aNumOptions, aPeriod );
+        if( aLogShareAdjustments ) {
+            const double minInf = -std::numeric_limits<double>::infinity();
+            for( size_t i = 0; i < aNumOptions; ++i ) {
+                aShares[ i ] = aLogShareAdjustments[ i ] == minInf ? minInf
+                               : aShares[ i ] + aLogShareAdjustments[ i ];
+            }
+        }
+        return SectorUtils::normalizeLogShares( aShares, aNumOptions );
+    }
+
     /*!
      * \brief Compute the mean value according the the discrete choice function's
      *        parameterization.
@@ -152,6 +152,24 @@ public:
         
     };
 
+    /*!
+     * \brief The concrete input classes which callers in the innermost loops
+     *        may dispatch to directly, avoiding virtual calls.
+     * \details Each of these classes is final so that once the pointer has been
+     *          cast to it the compiler may inline its accessors.  All other
+     *          inputs are OTHER_INPUT and must be called through this interface.
+     */
+    enum ConcreteType {
+        //! Any input class not listed below.
+        OTHER_INPUT,
+
+        //! An EnergyInput.
+        ENERGY_INPUT,
+
+        //! A NonEnergyInput.
+        NON_ENERGY_INPUT
+    };
+
     /*!
      * \brief Constructor.
      * \details Inlined constructor to avoid compiler problems with abstract
@@ -159,6 +177,12 @@ public:
      */
     IInput();
 
+    /*!
+     * \brief Constructor for the concrete input classes listed in ConcreteType.
+     * \param aConcreteType The concrete type of the input.
+     */
+    explicit IInput( const ConcreteType aConcreteType );
+
     /*!
      * \brief Destructor.
      * \details Inlined destructor to avoid compiler problems with abstract base
@@ -171,6 +195,16 @@ public:
      * \return An exact copy of the capture input. 
      */
     virtual IInput* clone() const = 0;
+
+    /*!
+     * \brief Get the concrete type of the input.
+     * \details This is not virtual so that it may be used to choose a direct
+     *          call in the innermost loops.
+     * \return The concrete type of the input.
+     */
+    ConcreteType getConcreteType() const {
+        return mConcreteType;
+    }
     
     /*!
      * \brief Copy parameters from another input.
@@ -522,10 +556,21 @@ protected:
                                 RenewableInput, InputSubsidy, InputTax, InputOMVar,
                                 InputOMFixed, InputCapital, CTaxInput )
     )
+
+private:
+    //! The concrete type of the input.
+    const ConcreteType mConcreteType;
 };
 
 // Inline function definitions.
-inline IInput::IInput(){
+inline IInput::IInput():
+mConcreteType( OTHER_INPUT )
+{
+}
+
+inline IInput::IInput( const ConcreteType aConcreteType ):
+mConcreteType( aConcreteType )
+{
 }
 
 inline IInput::~IInput(){
@@ -74,7 +74,7 @@ class Tabs;
  *
  * \author Josh Lurz
  */
-class InputOMFixed: public MiniCAMInput
+class InputOMFixed final: public MiniCAMInput
 {
     friend class InputFactory;
 public:
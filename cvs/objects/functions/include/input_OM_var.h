@@ -71,7 +71,7 @@ class Tabs;
  *
  * \author Josh Lurz
  */
-class InputOMVar: public MiniCAMInput
+class InputOMVar final: public MiniCAMInput
 {
     friend class InputFactory;
 public:
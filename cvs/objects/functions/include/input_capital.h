@@ -74,7 +74,7 @@ class Tabs;
  *
  * \author Josh Lurz
  */
-class InputCapital: public MiniCAMInput
+class InputCapital final: public MiniCAMInput
 {
     friend class InputFactory;
 public:
@@ -51,6 +51,7 @@
 #include "functions/include/minicam_input.h"
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class Tabs;
 
@@ -78,7 +79,7 @@ class Tabs;
  *
  * \author Kate Calvin
  */
-class InputTax: public MiniCAMInput
+class InputTax final: public MiniCAMInput
 {
     friend class InputFactory;
 public:
@@ -174,6 +175,10 @@ protected:
 
     //! Stash the current sector name for use in setPhysicalDemand
     std::string mSectorName;
+
+    //! Pre-located markets which have been cached from the marketplace in each
+    //! period to get the price and add demands to.
+    CachedMarketVector mCachedMarket;
 private:
     const static std::string XML_REPORTING_NAME; //!< tag name for reporting xml db 
 };
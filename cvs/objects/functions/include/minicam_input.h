@@ -220,6 +220,8 @@ public:
 protected:
     MiniCAMInput();
 
+    explicit MiniCAMInput( const ConcreteType aConcreteType );
+
     // Define data such that introspection utilities can process the data from this
     // subclass together with the data members of the parent classes.
     DEFINE_DATA_WITH_PARENT(
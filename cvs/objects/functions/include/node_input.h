@@ -368,6 +368,23 @@ protected:
                            
     //! Hack to avoiding excessive levelized cost calcs to help performance.
     bool mNodePriceSet;
+
+    //! The nodes of the nest, including this one, ordered such that every node
+    //! comes after all of the nodes beneath it.  Only set for the root in
+    //! initCalc so that the nest can be calculated without recursion.
+    std::vector<NodeInput*> mNodeOrder;
+
+    //! The children which are not nodes and so are not in mNodeOrder.
+    std::vector<INestedInput*> mNonNodeChildren;
+
+    void addToNodeOrder( std::vector<NodeInput*>& aNodeOrder );
+
+    void calcNodeLevelizedCost( const std::string& aRegionName, const std::string& aSectorName,
+        const int aPeriod, const double aAlphaZero );
+
+    double calcNodeInputDemand( const std::string& aRegionName, const std::string& aSectorName,
+        const int aPeriod, const double aPhysicalOutput, const double aUtilityParameterA,
+        const double aAlphaZero );
                            
     typedef std::vector<INestedInput*>::iterator NestedInputIterator;
     typedef std::vector<INestedInput*>::const_iterator CNestedInputIterator;
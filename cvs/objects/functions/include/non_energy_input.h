@@ -73,7 +73,7 @@ class Tabs;
  *
  * \author Josh Lurz
  */
-class NonEnergyInput: public MiniCAMInput
+class NonEnergyInput final: public MiniCAMInput
 {
     friend class InputFactory;
     friend class IntermittentTechnology;
@@ -186,4 +186,24 @@ private:
     const static std::string XML_REPORTING_NAME; //!< tag name for reporting xml db 
 };
 
+// Inline function definitions.
+inline double NonEnergyInput::getPrice( const std::string& aRegionName,
+                                        const int aPeriod ) const
+{
+    assert( mAdjustedCosts[ aPeriod ].isInited() );
+    return mAdjustedCosts[ aPeriod ];
+}
+
+inline void NonEnergyInput::setPhysicalDemand( double aPhysicalDemand,
+                                               const std::string& aRegionName,
+                                               const int aPeriod )
+{
+    // Does not add to the marketplace.
+}
+
+inline double NonEnergyInput::getCoefficient( const int aPeriod ) const {
+    assert( mAdjustedCoefficients[ aPeriod ].isInited() );
+    return mAdjustedCoefficients[ aPeriod ];
+}
+
 #endif // _NON_ENERGY_INPUT_H_
@@ -73,7 +73,7 @@
  *          situations are handled.
  * \author Robert Link
  */
-class RelativeCostLogit : public IDiscreteChoice {
+class RelativeCostLogit final : public IDiscreteChoice {
 public:
     RelativeCostLogit();
     virtual ~RelativeCostLogit();
@@ -98,6 +98,10 @@ public:
     virtual double calcUnnormalizedShare( const double aShareWeight, const double aValue,
                                           const int aPeriod ) const;
 
+    virtual void calcUnnormalizedShares( const double* aShareWeights, const double* aValues,
+                                         double* aLogShares, const size_t aNumOptions,
+                                         const int aPeriod ) const;
+
     virtual double calcAverageValue( const double aUnnormalizedShareSum,
                                      const double aLogShareFac,
                                      const int aPeriod ) const;
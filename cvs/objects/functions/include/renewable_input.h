@@ -74,7 +74,7 @@ class Tabs;
  *
  * \author Josh Lurz
  */
-class RenewableInput: public MiniCAMInput
+class RenewableInput final: public MiniCAMInput
 {
     friend class InputFactory;
     friend class UnmanagedLandTechnology;
@@ -51,11 +51,11 @@
 #include "util/base/include/time_vector.h"
 #include "functions/include/iinput.h"
 #include "functions/include/inested_input.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class Tabs;
 class DemandInput;
 class ProductionInput;
-class CachedMarket;
 
 /*! 
  * \ingroup Objects
@@ -171,6 +171,9 @@ public:
 
     double getPriceReceived( const std::string& aRegionName, const int aPeriod ) const;
 
+    bool getFixedPriceNetSupply( const std::string& aRegionName, const int aPeriod,
+                                 double& aNetSupply ) const;
+
     void setCurrencyDemand( const double aCurrencyDemand, const std::string& aRegionName, const int aPeriod );
 
     void setPhysicalDemand( const double aPhysicalDemand, const std::string& aRegionName, const int aPeriod );
@@ -280,9 +283,9 @@ protected:
     //! Type flags.
     int mTypeFlags;
 
-    //! A pre-located market which has been cahced from the marketplace to get
+    //! Pre-located markets which have been cached from the marketplace in each period to get
     //! the price and add demands to.
-    std::auto_ptr<CachedMarket> mCachedMarket;
+    CachedMarketVector mCachedMarket;
 
     void initializeTypeFlags( const std::string& aRegionName );
     void initializeCachedCoefficients( const std::string& aRegionName );
@@ -90,6 +90,11 @@ public:
     virtual double calcThermalLoad( const BuildingNodeInput* aBuildingInput,
                                     const double aFloorspace,
                                     const int aPeriod ) const;
+
+    virtual void calcThermalLoadCoefficients( const BuildingNodeInput* aBuildingInput,
+                                              const int aPeriod,
+                                              double& aFixedLoad,
+                                              double& aInternalGainsScalar ) const;
     
     // IInput methods
     virtual IInput* clone() const;
@@ -50,6 +50,7 @@
 #include "functions/include/absolute_cost_logit.hpp"
 #include "util/base/include/xml_helper.h"
 #include "util/logger/include/ilogger.h"
+#include "util/base/include/vector_math.h"
 
 using namespace std;
 using namespace xercesc;
@@ -200,6 +201,30 @@ double AbsoluteCostLogit::calcUnnormalizedShare( const double aShareWeight, cons
     return logShareWeight + mLogitExponent[ aPeriod ] * aValue / mBaseValue;
 }
 
+void AbsoluteCostLogit::calcUnnormalizedShares( const double* aShareWeights, const double* aValues,
+                                                double* aLogShares, const size_t aNumOptions,
+                                                const int aPeriod ) const
+{
+    /*!
+     * \pre A valid base cost has been set.
+     */
+    assert( mBaseValue > 0 );
+
+    const double minInf = -std::numeric_limits<double>::infinity();
+    const double logitExponent = mLogitExponent[ aPeriod ];
+    const double baseValue = mBaseValue;
+    // Take the logs of the share weights all at once so that they may be
+    // vectorized.
+    for( size_t i = 0; i < aNumOptions; ++i ) {
+        aLogShares[ i ] = aShareWeights[ i ] > 0.0 ? aShareWeights[ i ] : 1.0;
+    }
+    VectorMath::log( aLogShares, aNumOptions );
+    for( size_t i = 0; i < aNumOptions; ++i ) {
+        aLogShares[ i ] = aShareWeights[ i ] > 0.0 ?
+            aLogShares[ i ] + logitExponent * aValues[ i ] / baseValue : minInf;
+    }
+}
+
 double AbsoluteCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
                                            const double aLogShareFac,
                                            const int aPeriod ) const
@@ -66,7 +66,8 @@ extern Scenario* scenario;
 
 //! Default Constructor
 BuildingNodeInput::BuildingNodeInput():
-mInternalGainsTrialSupply( 0.001 )
+mInternalGainsTrialSupply( 0.001 ),
+mThermalLoadPeriod( -1 )
 {
     mSatiationDemandFunction = 0;
 }
@@ -211,6 +212,24 @@ void BuildingNodeInput::initCalc( const string& aRegionName,
                                       aIsTrade, aTechInfo, aPeriod );
         mChildInputsCache.push_back( *nestedInputIter );
     }
+
+    // The degree days, shell conductance and floor to surface ratio are fixed
+    // within a period so the thermal load coefficients of each child can be
+    // computed once here rather than on each demand calculation.
+    mFixedThermalLoad.resize( mChildInputsCache.size() );
+    mInternalGainsScalar.resize( mChildInputsCache.size() );
+    for( size_t i = 0; i < mChildInputsCache.size(); ++i ) {
+        const BuildingServiceInput* serviceInput = dynamic_cast<const BuildingServiceInput*>( mChildInputsCache[ i ] );
+        if( serviceInput ) {
+            serviceInput->calcThermalLoadCoefficients( this, aPeriod, mFixedThermalLoad[ i ],
+                                                       mInternalGainsScalar[ i ] );
+        }
+        else {
+            mFixedThermalLoad[ i ] = 1;
+            mInternalGainsScalar[ i ] = 0;
+        }
+    }
+    mThermalLoadPeriod = aPeriod;
 }
 
 void BuildingNodeInput::copyParam( const IInput* aInput,
@@ -393,6 +412,26 @@ double BuildingNodeInput::getInternalGains( const int aPeriod ) const {
     return SectorUtils::getTrialSupply( mRegionName, mInternalGainsMarketname, aPeriod );
 }
 
+/*!
+ * \brief Get the thermal load of a child service input using the coefficients
+ *        prepared during initCalc.
+ * \param aChildIndex The index of the child in the inputs passed to the function.
+ * \param aInternalGainsPerSqMeter The level of internal gains normalized per square meter
+ *                                 of building floorspace.
+ * \param aPeriod The model period.
+ * \return The thermal load of the child, equivalent to BuildingServiceInput::calcThermalLoad.
+ */
+double BuildingNodeInput::getThermalLoad( const size_t aChildIndex, const double aInternalGainsPerSqMeter,
+                                          const int aPeriod ) const
+{
+    /*!
+     * \pre The coefficients have been prepared for this period.
+     */
+    assert( mThermalLoadPeriod == aPeriod && aChildIndex < mFixedThermalLoad.size() );
+
+    return mFixedThermalLoad[ aChildIndex ] + mInternalGainsScalar[ aChildIndex ] * aInternalGainsPerSqMeter;
+}
+
 /*!
  * \brief Get the satiation demand function to be used in demand calculations.
  * \return The satiation demand function.
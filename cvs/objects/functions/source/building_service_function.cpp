@@ -65,14 +65,16 @@ double BuildingServiceFunction::calcCoefficient( InputSet& input, double consump
     const double floorSpace = buildingParentInput->getPhysicalDemand( period );
     const double internalGainsPerSqMeter = buildingParentInput->getInternalGains( period )
         / floorSpace;
-    for( InputSet::iterator inputIter = input.begin(); inputIter != input.end(); ++inputIter ) {
+    size_t inputIndex = 0;
+    for( InputSet::iterator inputIter = input.begin(); inputIter != input.end(); ++inputIter, ++inputIndex ) {
         double coefficient = 1;
         // Guard against zero floorspace which happens for 1975 since no data was read in for
         // that period.
         assert( floorSpace != 0 || period == 0 );
         if( floorSpace != 0 ) {
             BuildingServiceInput* buildingServiceInput = static_cast<BuildingServiceInput*>( *inputIter );
-            double thermalLoad = buildingServiceInput->calcThermalLoad( buildingParentInput, internalGainsPerSqMeter, period );
+            // The period fixed parts of the thermal load were prepared by the parent.
+            double thermalLoad = buildingParentInput->getThermalLoad( inputIndex, internalGainsPerSqMeter, period );
             double servicePerFloorspace = buildingServiceInput->getPhysicalDemand( period ) / floorSpace;
             double servicePrice = max( buildingServiceInput->getPricePaid( regionName, period ), SectorUtils::getDemandPriceThreshold() );
             buildingServiceInput->getSatiationDemandFunction()->calibrateSatiationImpedance( servicePerFloorspace, income / servicePrice, period );
@@ -96,7 +98,8 @@ double BuildingServiceFunction::calcDemand( InputSet& input, double consumption,
     const double internalGainsPerSqMeter = buildingParentInput->getInternalGains( period )
         / floorSpace;
     double totalDemand = 0;
-    for( InputSet::iterator inputIter = input.begin(); inputIter != input.end(); ++inputIter ) {
+    size_t inputIndex = 0;
+    for( InputSet::iterator inputIter = input.begin(); inputIter != input.end(); ++inputIter, ++inputIndex ) {
         double demand = 0;
         // Guard against zero floorspace which happens for 1975 since no data was read in for
         // that period.
@@ -104,7 +107,8 @@ double BuildingServiceFunction::calcDemand( InputSet& input, double consumption,
         if( floorSpace != 0 ) {
             // calculations for energy service
             BuildingServiceInput* buildingServiceInput = static_cast<BuildingServiceInput*>( *inputIter );
-            double thermalLoad = buildingServiceInput->calcThermalLoad( buildingParentInput, internalGainsPerSqMeter, period );
+            // The period fixed parts of the thermal load were prepared by the parent.
+            double thermalLoad = buildingParentInput->getThermalLoad( inputIndex, internalGainsPerSqMeter, period );
             double serviceDensity = calcServiceDensity( buildingServiceInput, income, regionName, period );
             double adjustedServiceDensity = buildingServiceInput->getCoefficient( period ) * thermalLoad * serviceDensity;
             // Set the thermal load adjusted service density back into the input for reporting.
@@ -142,6 +142,8 @@ void BuildingServiceInput::initCalc( const string& aRegionName,
 {
     /*! \pre There must be a valid region name. */
     assert( !aRegionName.empty() );
+
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
 }
 
 void BuildingServiceInput::copyParam( const IInput* aInput,
@@ -208,6 +210,27 @@ double BuildingServiceInput::calcThermalLoad( const BuildingNodeInput* aBuilding
     return 1;
 }
 
+/*!
+ * \brief Calculate the coefficients of the thermal load which are fixed within a period.
+ * \details The thermal load is linear in the internal gains per square meter, which
+ *          change with the trial internal gains supply, while the remaining terms
+ *          only change by period.  The thermal load is therefore
+ *          aFixedLoad + aInternalGainsScalar * internal gains per square meter.
+ * \param aBuildingInput The parent building input from which to get building characteristics.
+ * \param aPeriod The model period.
+ * \param aFixedLoad The part of the thermal load independent of internal gains.
+ * \param aInternalGainsScalar The multiplier on the internal gains per square meter.
+ */
+void BuildingServiceInput::calcThermalLoadCoefficients( const BuildingNodeInput* aBuildingInput,
+                                                        const int aPeriod,
+                                                        double& aFixedLoad,
+                                                        double& aInternalGainsScalar ) const
+{
+    // Generic building services do not adjust demands based on thermal load.
+    aFixedLoad = 1;
+    aInternalGainsScalar = 0;
+}
+
 /*!
  * \brief Set the calculated service density for reporting.
  * \param aServiceDensity The calculated service density.
@@ -257,7 +280,7 @@ void BuildingServiceInput::setPhysicalDemand( double aPhysicalDemand, const stri
         mServiceDemand[ aPeriod ].set( aPhysicalDemand );
     }
     
-    scenario->getMarketplace()->addToDemand( mName, aRegionName,
+    mCachedMarket.addToDemand( mName, aRegionName,
         mServiceDemand[ aPeriod ], aPeriod );
 }
 
@@ -286,7 +309,7 @@ void BuildingServiceInput::setCoefficient( const double aCoefficient, const int
  * \return The market or unadjusted price.
  */
 double BuildingServiceInput::getPrice( const string& aRegionName, const int aPeriod ) const {
-    return scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod );
+    return mCachedMarket.getPrice( mName, aRegionName, aPeriod );
 }
 
 void BuildingServiceInput::setPrice( const string& aRegionName,
@@ -54,7 +54,7 @@
 #include "functions/include/intensity.h"
 #include "containers/include/iinfo.h"
 #include "functions/include/function_utils.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 #include "containers/include/market_dependency_finder.h"
 
 using namespace std;
@@ -93,8 +93,8 @@ const string& EnergyInput::getXMLReportingName() const{
 }
 
 //! Constructor
-EnergyInput::EnergyInput() :
-    mCachedMarket( 0 )
+EnergyInput::EnergyInput():
+MiniCAMInput( ENERGY_INPUT )
 {
     
     mCoefficient = 0;
@@ -117,7 +117,8 @@ EnergyInput::~EnergyInput() {
  *          allocated memory.
  * \param aOther Energy input from which to copy.
  */
-EnergyInput::EnergyInput( const EnergyInput& aOther )
+EnergyInput::EnergyInput( const EnergyInput& aOther ):
+MiniCAMInput( ENERGY_INPUT )
 {
     MiniCAMInput::copy( aOther );
     /*!
@@ -326,7 +327,7 @@ void EnergyInput::initCalc( const string& aRegionName,
         mAdjustedCoefficients[ aPeriod ] = 1;
     }
     
-    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, mMarketName, aPeriod );
+    mCachedMarket.locateMarket( mName, mMarketName, aPeriod );
 }
 
 /*! \brief Initialize the type flags.
@@ -379,23 +380,6 @@ double EnergyInput::getCarbonContent( const int aPeriod ) const {
     return mPhysicalDemand[ aPeriod ] * mCO2Coefficient;
 }
 
-void EnergyInput::setPhysicalDemand( double aPhysicalDemand,
-                                     const string& aRegionName,
-                                     const int aPeriod )
-{
-    mPhysicalDemand[ aPeriod ].set( aPhysicalDemand );
-    mCachedMarket->addToDemand( mName, mMarketName,
-                                       mPhysicalDemand[ aPeriod ],
-                                       aPeriod, true );
-}
-
-double EnergyInput::getCoefficient( const int aPeriod ) const {
-    // Check that the coefficient has been initialized.
-    assert( mAdjustedCoefficients[ aPeriod ].isInited() );
-
-    return mAdjustedCoefficients[ aPeriod ];
-}
-
 void EnergyInput::setCoefficient( const double aCoefficient,
                                   const int aPeriod )
 {
@@ -406,13 +390,6 @@ void EnergyInput::setCoefficient( const double aCoefficient,
     mAdjustedCoefficients[ aPeriod ] = aCoefficient;
 }
 
-double EnergyInput::getPrice( const string& aRegionName,
-                              const int aPeriod ) const
-{
-    return mPriceUnitConversionFactor *
-        mCachedMarket->getPrice( mName, mMarketName, aPeriod );
-}
-
 void EnergyInput::setPrice( const string& aRegionName,
                             const double aPrice,
                             const int aPeriod )
@@ -327,7 +327,7 @@ void FunctionUtils::setPricePaid( const string& aRegionName,
 
     /*! \invariant The market and market info must exist. */
     assert( marketInfo );
-    marketInfo->setDouble( "pricePaid", aPricePaid );
+    marketInfo->setDouble( InfoKeys::ePricePaid, aPricePaid );
 }
 
 /*! \brief Gets the price paid for the good by querying the marketplace.
@@ -348,7 +348,7 @@ double FunctionUtils::getPricePaid( const string& aRegionName,
 
     /*! \invariant The market and market info must exist. */
     assert( marketInfo );
-    return marketInfo->getDouble( "pricePaid", true );
+    return marketInfo->getDouble( InfoKeys::ePricePaid, true );
 }
 
 /*! \brief Set the price received for a good into the marketplace.
@@ -370,7 +370,7 @@ void FunctionUtils::setPriceReceived( const string& aRegionName,
 
     /*! \invariant The market and market info must exist. */
     assert( marketInfo );
-    marketInfo->setDouble( "priceReceived", aPriceReceived );
+    marketInfo->setDouble( InfoKeys::ePriceReceived, aPriceReceived );
 }
 
 /*! \brief Gets the price received for the good by querying the marketplace.
@@ -390,7 +390,7 @@ double FunctionUtils::getPriceReceived( const string& aRegionName,
     const IInfo* marketInfo = marketplace->getMarketInfo( aGoodName, aRegionName, aPeriod, true );
     /*! \invariant The market and market info must exist. */
     assert( marketInfo );
-    return marketInfo->getDouble( "priceReceived", true );
+    return marketInfo->getDouble( InfoKeys::ePriceReceived, true );
 }
 
 /*! \brief Calculate the expected price received for the good produced by the
@@ -504,7 +504,7 @@ bool FunctionUtils::isFixedPrice( const string& aRegionName,
                                   const int aPeriod )
 {
     const IInfo* marketInfo = scenario->getMarketplace()->getMarketInfo( aGoodName, aRegionName, aPeriod, false );
-    return marketInfo && marketInfo->getBoolean( "IsFixedPrice", false );
+    return marketInfo && marketInfo->getBoolean( InfoKeys::eIsFixedPrice, false );
 }
 
 /*! \brief Static function which returns the conversion factor for the good
@@ -524,7 +524,7 @@ double FunctionUtils::getMarketConversionFactor( const string& aRegionName,
 
     const IInfo* marketInfo = scenario->getMarketplace()->getMarketInfo( aGoodName, aRegionName, 0, aMustExist );
 
-    return marketInfo ? marketInfo->getDouble( "ConversionFactor", aMustExist ) : 0;
+    return marketInfo ? marketInfo->getDouble( InfoKeys::eConversionFactor, aMustExist ) : 0;
 }
 
 /*!
@@ -574,7 +574,7 @@ double FunctionUtils::getCO2Coef( const string& aRegionName,
     // to the primary good. The info should not be null except in cases of
     // improperly constructed input files. This function will have already
     // warned in that case.
-    return productInfo ? productInfo->getDouble( "CO2coefficient", false ) : 0;
+    return productInfo ? productInfo->getDouble( InfoKeys::eCO2Coefficient, false ) : 0;
 }
 
 /*!
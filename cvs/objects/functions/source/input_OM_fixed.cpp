@@ -188,7 +188,7 @@ void InputOMFixed::completeInit( const string& aRegionName,
 {   
     // technology capacity factor
     // capacity factor needed before levelized fixed om cost calculation
-    mCapacityFactor = aTechInfo->getDouble("tech-capacity-factor", true);
+    mCapacityFactor = aTechInfo->getDouble( InfoKeys::eTechCapacityFactor, true );
 
     // completeInit() is called for each technology for each period
     // so levelized O&M fixed cost calculation is done here.
@@ -202,7 +202,7 @@ void InputCapital::completeInit( const string& aRegionName,
     
     // technology capacity factor
     // capacity factor needed before levelized cost calculation
-    mCapacityFactor = aTechInfo->getDouble("tech-capacity-factor", true);
+    mCapacityFactor = aTechInfo->getDouble( InfoKeys::eTechCapacityFactor, true );
                                            
     // completeInit() is called for each technology for each period
     // so levelized capital cost calculation is done here.
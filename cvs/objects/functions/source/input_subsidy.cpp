@@ -218,6 +218,8 @@ void InputSubsidy::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mAdjustedCoefficients[ aPeriod ] = 1.0;
+
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
 }
 
 void InputSubsidy::copyParam( const IInput* aInput,
@@ -258,8 +260,8 @@ void InputSubsidy::setPhysicalDemand( double aPhysicalDemand,
 
     // If subsidy is shared based, then divide by sector output.
     // Check if marketInfo exists and has the "isShareBased" boolean.
-    if( marketInfo && marketInfo->hasValue( "isShareBased" ) ){
-        if( marketInfo->getBoolean( "isShareBased", true ) ){
+    if( marketInfo && marketInfo->hasValue( InfoKeys::eIsShareBased ) ){
+        if( marketInfo->getBoolean( InfoKeys::eIsShareBased, true ) ){
             // Each share is additive
             aPhysicalDemand/= marketplace->getDemand( mSectorName, aRegionName, aPeriod );
         }
@@ -270,8 +272,8 @@ void InputSubsidy::setPhysicalDemand( double aPhysicalDemand,
     // This is so solver can use the excess demand to determine
     // whether to increase or decrease a subsidy. 
     // Each technology share is additive.
-    marketplace->addToSupply( mName, aRegionName, mPhysicalDemand[ aPeriod ],
-                              aPeriod, true );
+    mCachedMarket.addToSupply( mName, aRegionName, mPhysicalDemand[ aPeriod ],
+                               aPeriod, true );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
 }
@@ -295,7 +297,7 @@ double InputSubsidy::getPrice( const string& aRegionName,
     // Return negative of price to reflect subsidy for portfolio
     // standard market.
     // A high subsidy increases supply.
-    return - scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    return - mCachedMarket.getPrice( mName, aRegionName, aPeriod, true );
 }
 
 void InputSubsidy::setPrice( const string& aRegionName,
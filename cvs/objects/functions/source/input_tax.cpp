@@ -218,6 +218,8 @@ void InputTax::initCalc( const string& aRegionName,
     // There must be a valid region name.
     assert( !aRegionName.empty() );
     mAdjustedCoefficients[ aPeriod ] = 1.0;
+
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
 }
 
 void InputTax::copyParam( const IInput* aInput,
@@ -258,8 +260,8 @@ void InputTax::setPhysicalDemand( double aPhysicalDemand,
 
     // If tax is shared based, then divide by sector output.
     // Check if marketInfo exists and has the "isShareBased" boolean.
-    if( marketInfo && marketInfo->hasValue( "isShareBased" ) ){
-        if( marketInfo->getBoolean( "isShareBased", true ) ){
+    if( marketInfo && marketInfo->hasValue( InfoKeys::eIsShareBased ) ){
+        if( marketInfo->getBoolean( InfoKeys::eIsShareBased, true ) ){
             // Each share is additive
             aPhysicalDemand/= marketplace->getDemand( mSectorName, aRegionName, aPeriod );
         }
@@ -267,8 +269,8 @@ void InputTax::setPhysicalDemand( double aPhysicalDemand,
     // mPhysicalDemand can be a share if tax is share based.
     mPhysicalDemand[ aPeriod ].set( aPhysicalDemand );
     // Each technology share is additive.
-    marketplace->addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ],
-                              aPeriod, true );
+    mCachedMarket.addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ],
+                               aPeriod, true );
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::NOTICE );
 }
@@ -290,7 +292,7 @@ double InputTax::getPrice( const string& aRegionName,
                               const int aPeriod ) const
 {
     // A high tax decreases demand.
-    return scenario->getMarketplace()->getPrice( mName, aRegionName, aPeriod, true );
+    return mCachedMarket.getPrice( mName, aRegionName, aPeriod, true );
 }
 
 void InputTax::setPrice( const string& aRegionName,
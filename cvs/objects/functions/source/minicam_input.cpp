@@ -52,6 +52,17 @@ MiniCAMInput::MiniCAMInput(): mTypeFlags( 0 )
 {
 }
 
+/*!
+ * \brief Constructor for the concrete input classes listed in
+ *        IInput::ConcreteType.
+ * \param aConcreteType The concrete type of the input.
+ */
+MiniCAMInput::MiniCAMInput( const ConcreteType aConcreteType ):
+IInput( aConcreteType ),
+mTypeFlags( 0 )
+{
+}
+
 //! Destructor
 MiniCAMInput::~MiniCAMInput() {
 }
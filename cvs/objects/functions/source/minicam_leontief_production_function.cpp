@@ -46,6 +46,8 @@
 
 #include "functions/include/minicam_leontief_production_function.h"
 #include "functions/include/iinput.h"
+#include "functions/include/energy_input.h"
+#include "functions/include/non_energy_input.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
 #include "util/base/include/util.h"
@@ -57,16 +59,88 @@ using namespace std;
 
 extern Scenario* scenario;
 
+namespace {
+    /*!
+     * \brief Get the cost of an input per unit of output.
+     * \details Energy and non-energy inputs make up nearly all of the inputs
+     *          in practice so they are called directly, allowing their
+     *          accessors to be inlined, and all others virtually.
+     * \param aInput The input.
+     * \param aRegionName The region name.
+     * \param aPeriod The model period.
+     * \return The coefficient times price of the input.
+     */
+    inline double getInputCost( const IInput* aInput, const string& aRegionName, const int aPeriod ) {
+        switch( aInput->getConcreteType() ) {
+        case IInput::ENERGY_INPUT: {
+            const EnergyInput* input = static_cast<const EnergyInput*>( aInput );
+            return input->getCoefficient( aPeriod ) * input->getPrice( aRegionName, aPeriod );
+        }
+        case IInput::NON_ENERGY_INPUT: {
+            const NonEnergyInput* input = static_cast<const NonEnergyInput*>( aInput );
+            return input->getCoefficient( aPeriod ) * input->getPrice( aRegionName, aPeriod );
+        }
+        default:
+            return aInput->getCoefficient( aPeriod ) * aInput->getPrice( aRegionName, aPeriod );
+        }
+    }
+
+    /*!
+     * \brief Set the demand of an input given the scaled output.
+     * \details Dispatches directly to energy and non-energy inputs as in
+     *          getInputCost.
+     * \param aInput The input.
+     * \param aScaledOutput The output divided by alpha zero.
+     * \param aRegionName The region name.
+     * \param aPeriod The model period.
+     * \return The demand for the input.
+     */
+    inline double setInputDemand( IInput* aInput, const double aScaledOutput, const string& aRegionName,
+                                  const int aPeriod )
+    {
+        switch( aInput->getConcreteType() ) {
+        case IInput::ENERGY_INPUT: {
+            EnergyInput* input = static_cast<EnergyInput*>( aInput );
+            const double inputDemand = input->getCoefficient( aPeriod ) * aScaledOutput;
+            input->setPhysicalDemand( inputDemand, aRegionName, aPeriod );
+            return inputDemand;
+        }
+        case IInput::NON_ENERGY_INPUT: {
+            // Non-energy inputs do not track their demand.
+            return static_cast<NonEnergyInput*>( aInput )->getCoefficient( aPeriod ) * aScaledOutput;
+        }
+        default: {
+            const double inputDemand = aInput->getCoefficient( aPeriod ) * aScaledOutput;
+            aInput->setPhysicalDemand( inputDemand, aRegionName, aPeriod );
+            return inputDemand;
+        }
+        }
+    }
+
+    /*!
+     * \brief Sum the cost of each input per unit of output.
+     * \details Shared by calcCosts and calcLevelizedCost which are the same
+     *          for a Leontief function.
+     * \param aInputs The inputs.
+     * \param aRegionName The region name.
+     * \param aPeriod The model period.
+     * \return The sum of coefficient times price over the inputs.
+     */
+    inline double sumInputCosts( const InputSet& aInputs, const string& aRegionName, const int aPeriod ) {
+        double totalCost = 0;
+        for( CInputSetIterator input = aInputs.begin(); input != aInputs.end(); ++input ) {
+            totalCost += getInputCost( *input, aRegionName, aPeriod );
+        }
+        return totalCost;
+    }
+}
+
 double MinicamLeontiefProductionFunction::calcCosts( const InputSet& aInputs,
                                                      const string& aRegionName,
                                                      const double aAlphaZero,
                                                      int aPeriod ) const
 {
-    double totalCost = 0;
-    for( CInputSetIterator input = aInputs.begin(); input != aInputs.end(); ++input ) {
-        totalCost += ( *input )->getCoefficient( aPeriod ) * ( *input )->getPrice( aRegionName, aPeriod );
-    }
-    return totalCost / aAlphaZero;
+    return sumInputCosts( aInputs, aRegionName, aPeriod ) / aAlphaZero;
 }
 
 double MinicamLeontiefProductionFunction::calcProfits( InputSet& aInputs,
@@ -129,11 +203,10 @@ double MinicamLeontiefProductionFunction::calcDemand( InputSet& aInputs,
     assert( aAlphaZero >= 1 );
 
     // PersonalIncome == demand.
+    const double scaledOutput = aPersonalIncome / aAlphaZero;
     double totalDemand = 0;
     for( CInputSetIterator input = aInputs.begin(); input != aInputs.end(); ++input ) {
-        double inputDemand = ( *input )->getCoefficient( aPeriod ) * aPersonalIncome / aAlphaZero;
-        ( *input )->setPhysicalDemand( inputDemand, aRegionName, aPeriod );
-        totalDemand += inputDemand;
+        totalDemand += setInputDemand( *input, scaledOutput, aRegionName, aPeriod );
     }
     return totalDemand;
 }
@@ -160,13 +233,7 @@ double MinicamLeontiefProductionFunction::calcLevelizedCost( const InputSet& aIn
 {
     assert( aAlphaZero >= 1 );
 
-    // Loop through the inputs and add on their costs.
-    double levelizedCost = 0;
-    for( CInputSetIterator input = aInputs.begin(); input != aInputs.end(); ++input ) {
-        levelizedCost += ( *input )->getCoefficient( aPeriod )
-                         * ( *input )->getPrice( aRegionName, aPeriod );
-    }
-    return levelizedCost / aAlphaZero;
+    return sumInputCosts( aInputs, aRegionName, aPeriod ) / aAlphaZero;
 }
 
 double MinicamLeontiefProductionFunction::calcOutput( InputSet& aInputs,
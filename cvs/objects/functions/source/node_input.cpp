@@ -210,15 +210,40 @@ void NodeInput::initCalc( const string& aRegionName,
     // vector of the subclass INestedInput* instead of IInput*
     mChildInputsCache.clear();
     mChildInputsCache.reserve( mNestedInputs.size() );
+    mNonNodeChildren.clear();
     for( NestedInputIterator nestedInputIter = mNestedInputs.begin();
         nestedInputIter != mNestedInputs.end(); ++nestedInputIter )
     {
         (*nestedInputIter)->initCalc( aRegionName, aSectorName, aIsNewInvestmentPeriod, 
                                       aIsTrade, aTechInfo, aPeriod );
         mChildInputsCache.push_back( *nestedInputIter );
+        if( !dynamic_cast<NodeInput*>( *nestedInputIter ) ) {
+            mNonNodeChildren.push_back( *nestedInputIter );
+        }
     }
     // initialized the hack
     mNodePriceSet = false;
+
+    // The root orders the whole nest once so that calcLevelizedCost and
+    // calcInputDemand can walk it in a single loop.
+    mNodeOrder.clear();
+    if( mName == "root" ) {
+        addToNodeOrder( mNodeOrder );
+    }
+}
+
+/*!
+ * \brief Add the nodes beneath this one and then this node to the given order.
+ * \param aNodeOrder The order of the nodes to add to.
+ */
+void NodeInput::addToNodeOrder( vector<NodeInput*>& aNodeOrder ) {
+    for( NestedInputIterator it = mNestedInputs.begin(); it != mNestedInputs.end(); ++it ) {
+        NodeInput* childNode = dynamic_cast<NodeInput*>( *it );
+        if( childNode ) {
+            childNode->addToNodeOrder( aNodeOrder );
+        }
+    }
+    aNodeOrder.push_back( this );
 }
 
 void NodeInput::copyParam( const IInput* aInput,
@@ -384,6 +409,10 @@ const string& NodeInput::getName() const {
 }
 
 void NodeInput::removeEmptyInputs() {
+    // Inputs may be deleted so the nest must be ordered again in initCalc.
+    mNodeOrder.clear();
+    mNonNodeChildren.clear();
+
     const Modeltime* modeltime = scenario->getModeltime();
     const int BASE_PERIOD = modeltime->getBasePeriod();
     double currNodeDemand = 0;
@@ -507,9 +536,41 @@ void NodeInput::calcLevelizedCost( const std::string& aRegionName, const std::st
     if( mNodePriceSet ) {
         return;
     }
-    // have children calculate their levelized costs first
-    // the leaves are assumed to already have calculated their appropriate price paid
-    for( NestedInputIterator it = mNestedInputs.begin(); it != mNestedInputs.end(); ++it ) {
+    if( !mNodeOrder.empty() ) {
+        // The order puts every node after the nodes beneath it so walking it
+        // calculates the children before their parents.
+        for( vector<NodeInput*>::const_iterator it = mNodeOrder.begin(); it != mNodeOrder.end(); ++it ) {
+            (*it)->calcNodeLevelizedCost( aRegionName, aSectorName, aPeriod, aAlphaZero );
+        }
+    }
+    else {
+        // have children calculate their levelized costs first
+        // the leaves are assumed to already have calculated their appropriate price paid
+        for( NestedInputIterator it = mNestedInputs.begin(); it != mNestedInputs.end(); ++it ) {
+            (*it)->calcLevelizedCost( aRegionName, aSectorName, aPeriod, aAlphaZero );
+        }
+        calcNodeLevelizedCost( aRegionName, aSectorName, aPeriod, aAlphaZero );
+    }
+
+    // we only set the hack for the root so that we don't have to recurse through
+    // the nest when it comes time to reset this flag
+    if( mName == "root" ) {
+        mNodePriceSet = true;
+    }
+}
+
+/*!
+ * \brief Calculate the levelized cost of this node once the nodes beneath it
+ *        have calculated theirs.
+ * \param aRegionName The region name.
+ * \param aSectorName The sector name.
+ * \param aPeriod The model period.
+ * \param aAlphaZero The alpha zero of the technology.
+ */
+void NodeInput::calcNodeLevelizedCost( const std::string& aRegionName, const std::string& aSectorName,
+        const int aPeriod, const double aAlphaZero )
+{
+    for( NestedInputIterator it = mNonNodeChildren.begin(); it != mNonNodeChildren.end(); ++it ) {
         (*it)->calcLevelizedCost( aRegionName, aSectorName, aPeriod, aAlphaZero );
     }
 
@@ -519,12 +580,6 @@ void NodeInput::calcLevelizedCost( const std::string& aRegionName, const std::st
 
     setPricePaid( tempPrice, aPeriod );
 
-    // we only set the hack for the root so that we don't have to recurse through
-    // the nest when it comes time to reset this flag
-    if( mName == "root" ) {
-        mNodePriceSet = true;
-    }
-
     // We need to store the base year price paids since they are require to adjust our coefficients
     // with new sigmas in the future.  Note this may be inconsistent if the base year was not read in
     // balanced.
@@ -577,6 +632,19 @@ double NodeInput::calcInputDemand( const std::string& aRegionName, const std::st
         const int aPeriod, const double aPhysicalOutput, const double aUtilityParameterA,
         const double aAlphaZero )
 {
+    if( !mNodeOrder.empty() ) {
+        // Walking the order backwards calculates every node before the nodes
+        // beneath it.  This node is last in the order.
+        assert( mNodeOrder.back() == this );
+        const double retDemand = calcNodeInputDemand( aRegionName, aSectorName, aPeriod, aPhysicalOutput,
+                                                      aUtilityParameterA, aAlphaZero );
+        for( vector<NodeInput*>::const_reverse_iterator it = mNodeOrder.rbegin() + 1; it != mNodeOrder.rend(); ++it ) {
+            (*it)->calcNodeInputDemand( aRegionName, aSectorName, aPeriod, (*it)->getPhysicalDemand( aPeriod ),
+                                        aUtilityParameterA, aAlphaZero );
+        }
+        return retDemand;
+    }
+
     // first calculate the demands for the direct children
     double retDemand = mProdDmdFn->calcDemand( mChildInputsCache, aPhysicalOutput, aRegionName, aSectorName, 1,
         aPeriod, aUtilityParameterA, aAlphaZero, mCurrentSigma, mPricePaid );
@@ -592,6 +660,33 @@ double NodeInput::calcInputDemand( const std::string& aRegionName, const std::st
     return retDemand;
 }
 
+/*!
+ * \brief Calculate the demands for the children of this node and those of the
+ *        children which are not nodes.
+ * \details The children which are nodes calculate the demands for their own
+ *          children when they are reached in the node order.
+ * \param aRegionName The region name.
+ * \param aSectorName The sector name.
+ * \param aPeriod The model period.
+ * \param aPhysicalOutput The demand for this node.
+ * \param aUtilityParameterA The utility parameter A.
+ * \param aAlphaZero The alpha zero of the technology.
+ * \return The demand calculated by the production function of this node.
+ */
+double NodeInput::calcNodeInputDemand( const std::string& aRegionName, const std::string& aSectorName,
+        const int aPeriod, const double aPhysicalOutput, const double aUtilityParameterA,
+        const double aAlphaZero )
+{
+    double retDemand = mProdDmdFn->calcDemand( mChildInputsCache, aPhysicalOutput, aRegionName, aSectorName, 1,
+        aPeriod, aUtilityParameterA, aAlphaZero, mCurrentSigma, mPricePaid );
+
+    for( NestedInputIterator it = mNonNodeChildren.begin(); it != mNonNodeChildren.end(); ++it ) {
+        (*it)->calcInputDemand( aRegionName, aSectorName, aPeriod, (*it)->getPhysicalDemand( aPeriod ),
+            aUtilityParameterA, aAlphaZero );
+    }
+    return retDemand;
+}
+
 double NodeInput::calcCapitalOutputRatio( const std::string& aRegionName, const std::string& aSectorName,
         const int aPeriod, const double aAlphaZero ) {
     /*
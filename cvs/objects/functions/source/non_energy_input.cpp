@@ -82,7 +82,8 @@ const string& NonEnergyInput::getXMLReportingName() const{
 }
 
 //! Constructor
-NonEnergyInput::NonEnergyInput()
+NonEnergyInput::NonEnergyInput():
+MiniCAMInput( NON_ENERGY_INPUT )
 {
 }
 
@@ -92,7 +93,8 @@ NonEnergyInput::NonEnergyInput()
 * objects.
 * \author Steve Smith
 */
-NonEnergyInput::NonEnergyInput( const std::string& aName )
+NonEnergyInput::NonEnergyInput( const std::string& aName ):
+MiniCAMInput( NON_ENERGY_INPUT )
 {
     mName = aName;
 }
@@ -214,13 +216,6 @@ void NonEnergyInput::initCalc( const string& aRegionName,
     mAdjustedCoefficients[ aPeriod ] = 1;
 }
 
-double NonEnergyInput::getPrice( const string& aRegionName,
-                                 const int aPeriod ) const
-{
-    assert( mAdjustedCosts[ aPeriod ].isInited() );
-    return mAdjustedCosts[ aPeriod ];
-}
-
 void NonEnergyInput::setPrice( const string& aRegionName,
                                const double aPrice,
                                const int aPeriod ) 
@@ -232,13 +227,6 @@ double NonEnergyInput::getPhysicalDemand( const int aPeriod ) const {
     return 0;
 }
 
-void NonEnergyInput::setPhysicalDemand( double aPhysicalDemand,
-                                        const string& aRegionName,
-                                        const int aPeriod )
-{
-    // Does not add to the marketplace.
-}
-
 double NonEnergyInput::getCO2EmissionsCoefficient( const string& aGHGName,
                                                 const int aPeriod ) const
 {
@@ -246,11 +234,6 @@ double NonEnergyInput::getCO2EmissionsCoefficient( const string& aGHGName,
     return 0;
 }
 
-double NonEnergyInput::getCoefficient( const int aPeriod ) const {
-    assert( mAdjustedCoefficients[ aPeriod ].isInited() );
-    return mAdjustedCoefficients[ aPeriod ];
-}
-
 void NonEnergyInput::setCoefficient( const double aCoefficient,
                                      const int aPeriod )
 {
@@ -48,6 +48,7 @@
 #include "functions/include/relative_cost_logit.hpp"
 #include "util/base/include/xml_helper.h"
 #include "util/logger/include/ilogger.h"
+#include "util/base/include/vector_math.h"
 
 using namespace std;
 using namespace xercesc;
@@ -197,6 +198,32 @@ double RelativeCostLogit::calcUnnormalizedShare( const double aShareWeight, cons
     // logit and the absolute value logit.
 }
 
+void RelativeCostLogit::calcUnnormalizedShares( const double* aShareWeights, const double* aValues,
+                                                double* aLogShares, const size_t aNumOptions,
+                                                const int aPeriod ) const
+{
+    const double minInf = -std::numeric_limits<double>::infinity();
+    const double minValue = getMinValueThreshold();
+    const double logitExponent = mLogitExponent[ aPeriod ];
+    // Take the logs of the share weights and values in batches so that they
+    // may be vectorized.
+    double logValues[ VectorMath::BATCH_SIZE ];
+    for( size_t start = 0; start < aNumOptions; start += VectorMath::BATCH_SIZE ) {
+        const size_t count = std::min( VectorMath::BATCH_SIZE, aNumOptions - start );
+        double* logShares = aLogShares + start;
+        for( size_t i = 0; i < count; ++i ) {
+            logShares[ i ] = aShareWeights[ start + i ] > 0.0 ? aShareWeights[ start + i ] : 1.0;
+            logValues[ i ] = std::max( aValues[ start + i ], minValue );
+        }
+        VectorMath::log( logShares, count );
+        VectorMath::log( logValues, count );
+        for( size_t i = 0; i < count; ++i ) {
+            logShares[ i ] = aShareWeights[ start + i ] > 0.0 ?
+                logShares[ i ] + logitExponent * logValues[ i ] : minInf;
+        }
+    }
+}
+
 double RelativeCostLogit::calcAverageValue( const double aUnnormalizedShareSum,
                                            const double aLogShareFac,
                                            const int aPeriod ) const
@@ -57,7 +57,7 @@
 #include "sectors/include/more_sector_info.h"
 #include "containers/include/national_account.h"
 #include "technologies/include/expenditure.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 
 using namespace std;
 using namespace xercesc;
@@ -207,7 +207,7 @@ void SGMInput::initCalc( const string& aRegionName,
     /*! \pre There must be a valid region name. */
     assert( !aRegionName.empty() );
 
-    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, aRegionName, aPeriod );
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
 
     initializeCachedCoefficients( aRegionName );
     initializeTypeFlags( aRegionName );
@@ -376,7 +376,7 @@ void SGMInput::setPhysicalDemand( double aPhysicalDemand, const string& aRegionN
     // this physical demand is a quantity of capital and the Capital market
     // works in annual dollar amounts
     if( !hasTypeFlag( IInput::CAPITAL ) && aPhysicalDemand > util::getSmallNumber() ) {
-        mCachedMarket->addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ], aPeriod );
+        mCachedMarket.addToDemand( mName, aRegionName, mPhysicalDemand[ aPeriod ], aPeriod );
     }
 }
 
@@ -418,7 +418,7 @@ void SGMInput::setCoefficient( const double aCoefficient, const int aPeriod ) {
 * \author Josh Lurz
 */
 double SGMInput::getPrice( const string& aRegionName, const int aPeriod ) const {
-    return mCachedMarket->getPrice( mName, aRegionName, aPeriod );
+    return mCachedMarket.getPrice( mName, aRegionName, aPeriod );
 }
 
 void SGMInput::setPrice( const string& aRegionName,
@@ -523,7 +523,34 @@ double SGMInput::calcTaxes( const string& aRegionName, NationalAccount* aNationa
 * \author Josh Lurz
 */
 double SGMInput::getPriceReceived( const string& aRegionName, const int aPeriod ) const {
-    return FunctionUtils::getPriceReceived( aRegionName, mName, aPeriod );
+    const IInfo* marketInfo = mCachedMarket.getMarketInfo( mName, aRegionName, aPeriod, true );
+    /*! \invariant The market and market info must exist. */
+    assert( marketInfo );
+    return marketInfo->getDouble( InfoKeys::ePriceReceived, true );
+}
+
+/*! \brief Get the supply less the demand of the market for the input if it has
+*          a fixed price.
+* \details The market located in initCalc is used so that trade inputs, which
+*          are located in the trading partner's market, do not look up the
+*          market by region and good name.
+* \param aRegionName Name of the region of the market which must be the one
+*        the input was initialized with.
+* \param aPeriod Period
+* \param aNetSupply The supply less the demand of the market, only set if the
+*        market has a fixed price.
+* \return Whether the market has a fixed price.
+*/
+bool SGMInput::getFixedPriceNetSupply( const string& aRegionName, const int aPeriod,
+                                       double& aNetSupply ) const
+{
+    const IInfo* marketInfo = mCachedMarket.getMarketInfo( mName, aRegionName, aPeriod, false );
+    if( !marketInfo || !marketInfo->getBoolean( InfoKeys::eIsFixedPrice, false ) ) {
+        return false;
+    }
+    aNetSupply = mCachedMarket.getSupply( mName, aRegionName, aPeriod )
+                 - mCachedMarket.getDemand( mName, aRegionName, aPeriod );
+    return true;
 }
 
 /*! \brief Returns the price adjustment.
@@ -557,7 +584,7 @@ void SGMInput::initializeCachedCoefficients( const string& aRegionName ){
     if( !mConversionFactor.isInited() ){
         // Get the conversion factor from the marketplace.
         const IInfo* marketInfo = scenario->getMarketplace()->getMarketInfo( mName, aRegionName, 0, false );
-        const double convFactor = marketInfo ? marketInfo->getDouble( "ConversionFactor", false ) : 0;
+        const double convFactor = marketInfo ? marketInfo->getDouble( InfoKeys::eConversionFactor, false ) : 0;
         if( convFactor == 0 && isEnergyGood( aRegionName ) ){
             ILogger& mainLog = ILogger::getLogger( "main_log" );
             mainLog.setLevel( ILogger::WARNING );
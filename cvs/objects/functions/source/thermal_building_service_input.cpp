@@ -190,6 +190,27 @@ void ThermalBuildingServiceInput::toDebugXML( const int aPeriod, ostream& aOut,
 double ThermalBuildingServiceInput::calcThermalLoad( const BuildingNodeInput* aBuildingInput,
                                                      const double aInternalGainsPerSqMeter,
                                                      const int aPeriod ) const
+{
+    double fixedLoad;
+    double internalGainsScalar;
+    calcThermalLoadCoefficients( aBuildingInput, aPeriod, fixedLoad, internalGainsScalar );
+    return fixedLoad + internalGainsScalar * aInternalGainsPerSqMeter;
+}
+
+/*!
+ * \brief Calculate the coefficients of the thermal load which are fixed within a period.
+ * \details The degree days, shell conductance and floor to surface ratio only
+ *          change by period so that their product may be computed once.
+ * \param aBuildingInput The parent building input from which to get building characteristics.
+ * \param aPeriod The model period.
+ * \param aFixedLoad The part of the thermal load independent of internal gains.
+ * \param aInternalGainsScalar The multiplier on the internal gains per square meter.
+ * \sa BuildingServiceInput::calcThermalLoadCoefficients
+ */
+void ThermalBuildingServiceInput::calcThermalLoadCoefficients( const BuildingNodeInput* aBuildingInput,
+                                                               const int aPeriod,
+                                                               double& aFixedLoad,
+                                                               double& aInternalGainsScalar ) const
 {
     /*!
      * \pre Degree days have been set for this period.
@@ -201,9 +222,9 @@ double ThermalBuildingServiceInput::calcThermalLoad( const BuildingNodeInput* aB
      */
     assert( mInternalGainsScalar.isInited() );
     
-    return ( mDegreeDays[ aPeriod ] * aBuildingInput->getShellConductance( aPeriod )
-             * aBuildingInput->getFloorToSurfaceRatio( aPeriod )
-             + mInternalGainsScalar * aInternalGainsPerSqMeter );
+    aFixedLoad = mDegreeDays[ aPeriod ] * aBuildingInput->getShellConductance( aPeriod )
+                 * aBuildingInput->getFloorToSurfaceRatio( aPeriod );
+    aInternalGainsScalar = mInternalGainsScalar;
 }
 
 /*!
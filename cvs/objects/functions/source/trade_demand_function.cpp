@@ -53,6 +53,7 @@
 
 #include "functions/include/trade_demand_function.h"
 #include "functions/include/iinput.h"
+#include "functions/include/sgm_input.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/marketplace.h"
 #include "util/base/include/util.h"
@@ -75,7 +76,15 @@ double TradeDemandFunction::calcDemand( InputSet& input, double consumption, con
 		if( !input[ i ]->hasTypeFlag( IInput::FACTOR ) ){
 			// Open Trade
             double netExport;
-            if( FunctionUtils::isFixedPrice( regionName, input[ i ]->getName(), period ) ){
+            // SGM inputs use the markets they located in initCalc unless
+            // they are located in another region's market.
+            const SGMInput* sgmInput = dynamic_cast<const SGMInput*>( input[ i ] );
+            if( sgmInput && sgmInput->getMarketName( regionName ) == regionName ) {
+                if( !sgmInput->getFixedPriceNetSupply( regionName, period, netExport ) ) {
+                    netExport = input[ i ]->getPhysicalDemand( period );
+                }
+            }
+            else if( FunctionUtils::isFixedPrice( regionName, input[ i ]->getName(), period ) ){
 				netExport = marketplace->getSupply( input[ i ]->getName(), regionName, period ) -
 					marketplace->getDemand( input[ i ]->getName(), regionName, period );
 			}
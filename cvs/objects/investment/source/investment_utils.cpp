@@ -201,18 +201,8 @@ double InvestmentUtils::sumFixedInvestment( const vector<IInvestable*>& aInvesta
 vector<IInvestable*> InvestmentUtils::getTechInvestables( const vector<BaseTechnology*>& aAllTechs,
                                                 const int aPeriod )
 {
-    const Modeltime* modeltime = scenario->getModeltime();
-    vector<BaseTechnology*> investableTechs;
-    typedef vector<BaseTechnology*>::const_iterator BaseTechIterator;
-    for( BaseTechIterator currTech = aAllTechs.begin(); currTech != aAllTechs.end(); ++currTech ){
-        // TODO change this to check if the tech year <= the current year so that we can
-        // avoid some extra processing
-        //if ( (*currTech)->isNewInvestment( aPeriod ) ){
-            investableTechs.push_back( *currTech );
-        //}
-    }
-    vector<IInvestable*> investables( investableTechs.size() );
-    copy( investableTechs.begin(), investableTechs.end(), investables.begin() );
-    return investables;
+    // TODO change this to check if the tech year <= the current year so that we can
+    // avoid some extra processing using isNewInvestment.
+    return vector<IInvestable*>( aAllTechs.begin(), aAllTechs.end() );
 }
 
@@ -119,6 +119,7 @@ class ALandAllocatorItem : public TreeItem<ALandAllocatorItem>,
                            private boost::noncopyable
 {
     friend class XMLDBOutputter;
+    friend class FlatLandAllocator;
 public:
     typedef TreeItem<ALandAllocatorItem> ParentTreeType;
 
@@ -423,6 +424,9 @@ public:
                    const int aPeriod );
     
     double getShare( const int aPeriod ) const;
+
+    bool updateUnnormalizedShare( const double aUnnormalizedShare,
+                                  const int aPeriod );
         
     const ALandAllocatorItem* getParent() const;
 
@@ -462,6 +466,10 @@ protected:
         //! Land observed profit rate
         DEFINE_VARIABLE( ARRAY | STATE, "profit-rate", mProfitRate, objects::PeriodVector<Value> ),
 
+        //! The log of the unnormalized share last calculated for this item by
+        //! calcLandShares which the parent uses to detect if it has changed.
+        DEFINE_VARIABLE( ARRAY | STATE, "unnormalized-share", mUnnormalizedShare, objects::PeriodVector<Value> ),
+
         //! The ghost unnormalized share, or the share a future crop/technology would
         //! get if it was available in the final calibration period at the profit rate
         //! calculated in the final calibration period.
@@ -0,0 +1,148 @@
+#ifndef _FLAT_LAND_ALLOCATOR_H_
+#define _FLAT_LAND_ALLOCATOR_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file flat_land_allocator.h
+* \ingroup Objects
+* \brief The FlatLandAllocator class header file.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/core/noncopyable.hpp>
+
+class ALandAllocatorItem;
+class LandNode;
+class LandLeaf;
+
+/*!
+* \ingroup Objects
+* \brief A flattened copy of the structure of a land allocation tree which
+*        calculates the land shares and allocations without recursing.
+* \details The tree is flattened once its structure is final, after
+*          completeInit, into arrays holding a value for each item in breadth
+*          first order so that the children of every node are stored
+*          contiguously after their parent.  Each calculation gathers the share
+*          weights and the profit rates of the leaves into these arrays, then
+*          calculates the shares and profit rate of each node, children before
+*          parents, evaluating the discrete choice function of the node for
+*          all of its children in a single call.  The allocations are then
+*          calculated parents before children.  The results are written back
+*          to the items so that they are seen by the rest of the model and by
+*          reporting exactly as if the tree had calculated them.
+*
+*          The same operations are performed in the same order for each node
+*          as LandNode::calcLandShares and calcLandAllocation so the results
+*          are identical.  Demands for land expansion cost markets are added
+*          in the original depth first order of the leaves.
+*
+*          For screening runs the nodes at or below an aggregation depth may be
+*          treated as aggregated leaves (see setAggregatedShares).  The shares
+*          within such a node are then held at those of the previous period,
+*          the node's profit rate being the share weighted average of its
+*          children's profit rates, so that only the nodes above the
+*          aggregation depth evaluate their discrete choice functions.  The
+*          land of an aggregated node is disaggregated to its children in
+*          proportion to the held shares.  The results are only approximate.
+*/
+class FlatLandAllocator : private boost::noncopyable {
+public:
+    FlatLandAllocator( LandNode* aRoot, const int aAggregationDepth );
+
+    void setAggregatedShares( const int aPeriod );
+
+    void calcLandShares( const int aPeriod );
+
+    void calcLandAllocation( const std::string& aRegionName, const double aRootLandAllocation,
+                             const int aPeriod );
+private:
+    //! Each item in breadth first order, the first is the root.
+    std::vector<ALandAllocatorItem*> mItems;
+
+    //! The index of the parent of each item, -1 for the root.
+    std::vector<int> mParent;
+
+    //! Whether each item is a leaf.
+    std::vector<char> mIsLeaf;
+
+    //! The share weight of each item.
+    std::vector<double> mShareWeight;
+
+    //! The profit rate of each item.
+    std::vector<double> mProfitRate;
+
+    //! The share of each item within its parent.
+    std::vector<double> mShare;
+
+    //! The land allocated to each item.
+    std::vector<double> mLandAllocation;
+
+    //! Each node, in the same order as mItems.
+    std::vector<LandNode*> mNodes;
+
+    //! The index in mItems of each node.
+    std::vector<int> mNodeItem;
+
+    //! The index in mItems of the first child of each node.
+    std::vector<int> mChildBegin;
+
+    //! The index in mItems past the last child of each node.
+    std::vector<int> mChildEnd;
+
+    //! Whether each node is at or below the aggregation depth.
+    std::vector<char> mIsAggregated;
+
+    //! Whether the shares of each node's children are held at mHeldShare in
+    //! the current period.
+    std::vector<char> mIsHeld;
+
+    //! The held share of each item within its parent.
+    std::vector<double> mHeldShare;
+
+        //! Each leaf in depth first order.
+    std::vector<LandLeaf*> mLeaves;
+
+    //! The index in mItems of each leaf.
+    std::vector<int> mLeafItem;
+
+    void addLeaves( ALandAllocatorItem* aItem, const std::map<const ALandAllocatorItem*, int>& aItemIndex );
+};
+
+#endif // _FLAT_LAND_ALLOCATOR_H_
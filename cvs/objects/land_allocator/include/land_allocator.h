@@ -47,8 +47,10 @@
 #include "land_allocator/include/iland_allocator.h"
 #include "land_allocator/include/land_node.h"
 #include "util/base/include/ivisitable.h"
+#include <memory>
 
 class IInfo;
+class FlatLandAllocator;
 
 /*! 
  * \brief Root of a single land allocation tree.
@@ -161,6 +163,10 @@ protected:
     )
 
 private:
+    //! The flattened land allocation tree used to calculate the shares and
+    //! allocations if "flat-land-allocation" is set, otherwise null.
+    std::auto_ptr<FlatLandAllocator> mFlatAllocator;
+
     void calibrateLandAllocator( const std::string& aRegionName, const int aPeriod );
 
     void checkLandArea( const std::string& aRegionName, const int aPeriod );
@@ -68,6 +68,7 @@ class ICarbonCalc;
  */
 class LandLeaf : public ALandAllocatorItem {
     friend class XMLDBOutputter;
+    friend class FlatLandAllocator;
 public:
     LandLeaf( const ALandAllocatorItem* aParent,
               const std::string& aName );
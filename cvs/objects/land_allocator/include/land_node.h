@@ -74,6 +74,7 @@ class NodeCarbonCalc;
  *              - \c node-carbon-calc LandNode::mCarbonCalc
  */
 class LandNode : public ALandAllocatorItem {
+    friend class FlatLandAllocator;
 public:
     explicit LandNode( const ALandAllocatorItem* aParent );
 
@@ -201,7 +202,12 @@ protected:
 
         //! (optional) A carbon calculation which can used when children maybe similar
         //! in terms of switching between them does not mean carbon is emitted per se.
-        DEFINE_VARIABLE( CONTAINER, "node-carbon-calc", mCarbonCalc, NodeCarbonCalc* )
+        DEFINE_VARIABLE( CONTAINER, "node-carbon-calc", mCarbonCalc, NodeCarbonCalc* ),
+
+        //! A flag, one or zero, for whether the shares of the children have been
+        //! calculated from their stored unnormalized shares and may be reused
+        //! by calcLandShares if those have not changed.
+        DEFINE_VARIABLE( ARRAY | STATE, "shares-calculated", mSharesCalculated, objects::PeriodVector<Value> )
     )
 };
 
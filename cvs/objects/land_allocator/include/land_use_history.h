@@ -44,11 +44,13 @@
  * \author Josh Lurz
  */
 #include <map>
+#include <vector>
 #include <xercesc/dom/DOMNode.hpp>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/ivisitable.h"
 #include "util/base/include/data_definition_util.h"
+#include "util/base/include/mapped_data_table.h"
 
 class Tabs;
 /*!
@@ -67,6 +69,12 @@ class Tabs;
  *              - \c allocation LandUseHistory::mHistoricalLand (value is a double)
  *                  -Attributes
  *                      - \c year the year of the land allocation
+ *
+ *          The allocations may instead be read from the MappedDataTable in
+ *          which case the history keeps a view of the mapped column rather
+ *          than a copy, see bindMappedData.  Allocations read from XML are
+*          likewise moved out of the map into sorted arrays once the history
+*          has been bound since that is considerably more compact.
  */
 class LandUseHistory : public IVisitable,
                        public IParsable,
@@ -114,6 +122,8 @@ public:
 
 	void printHistory() const;
 
+    void bindMappedData( const std::string& aKey );
+
 protected:
 
     DEFINE_DATA(
@@ -129,6 +139,23 @@ protected:
         //! Average below ground carbon content historically.
         DEFINE_VARIABLE( SIMPLE, "below-ground-carbon-density", mHistoricBelowGroundCarbonDensity, double )
     )
+
+    //! A view of the allocations in the MappedDataTable which is used instead
+    //! of mHistoricalLand when it is set.
+    MappedDataTable::Column mMappedLand;
+
+    //! The years of the allocations read from XML once they have been compacted
+    //! out of mHistoricalLand, see bindMappedData.
+    std::vector<unsigned int> mCompactYears;
+
+    //! The allocations for each year in mCompactYears.
+    std::vector<double> mCompactLand;
+
+    bool isMapped() const;
+
+    void compact();
+
+    void expand();
 };
 
 #endif // _HISTORICAL_LAND_USE_H_
@@ -39,6 +39,8 @@
  */
 
 #include "util/base/include/definitions.h"
+#include <algorithm>
+#include <limits>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/base/include/xml_helper.h"
 #include "land_allocator/include/aland_allocator_item.h"
@@ -78,6 +80,28 @@ void ALandAllocatorItem::setShare( const double aShare,
     mShare[ aPeriod ] = aShare;
 }
 
+/*!
+ * \brief Store the log of the unnormalized share calculated for this item.
+ * \details This allows the parent node to skip normalizing the shares of its
+ *          children when none of them have changed since the last time, such
+ *          as for most partial derivatives.  Note an unnormalized share of zero
+ *          is stored as the lowest finite double since it can not be held in a
+ *          Value.
+ * \param aUnnormalizedShare The log of the unnormalized share.
+ * \param aPeriod Model period.
+ * \return Whether the unnormalized share differs from the one stored before.
+ */
+bool ALandAllocatorItem::updateUnnormalizedShare( const double aUnnormalizedShare,
+                                                  const int aPeriod )
+{
+    const double unnormalizedShare = max( aUnnormalizedShare, -numeric_limits<double>::max() );
+    if( mUnnormalizedShare[ aPeriod ] == unnormalizedShare ) {
+        return false;
+    }
+    mUnnormalizedShare[ aPeriod ] = unnormalizedShare;
+    return true;
+}
+
 const string& ALandAllocatorItem::getName() const {
     return mName;
 }
@@ -0,0 +1,223 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file flat_land_allocator.cpp
+* \ingroup Objects
+* \brief FlatLandAllocator class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+
+#include "land_allocator/include/flat_land_allocator.h"
+#include "land_allocator/include/land_node.h"
+#include "land_allocator/include/land_leaf.h"
+#include "functions/include/idiscrete_choice.hpp"
+#include "sectors/include/sector_utils.h"
+#include "marketplace/include/marketplace.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/model_time.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+/*!
+ * \brief Constructor which flattens the tree below aRoot.
+ * \param aRoot The root of the land allocation tree.
+ * \param aAggregationDepth The depth, with the children of the root at a depth
+ *        of one, at or below which nodes are aggregated, or zero or less to
+ *        calculate every node.
+ */
+FlatLandAllocator::FlatLandAllocator( LandNode* aRoot, const int aAggregationDepth ) {
+    map<const ALandAllocatorItem*, int> itemIndex;
+    vector<int> depth;
+    mItems.push_back( aRoot );
+    mParent.push_back( -1 );
+    depth.push_back( 0 );
+    itemIndex[ aRoot ] = 0;
+
+    // Visiting the items in the order they are added gives the breadth first
+    // order with the children of each node added together.
+    for( size_t curr = 0; curr < mItems.size(); ++curr ) {
+        ALandAllocatorItem* item = mItems[ curr ];
+        mIsLeaf.push_back( item->getType() == eLeaf );
+        if( item->getType() == eLeaf ) {
+            continue;
+        }
+        mNodes.push_back( static_cast<LandNode*>( item ) );
+        mNodeItem.push_back( static_cast<int>( curr ) );
+        mIsAggregated.push_back( aAggregationDepth > 0 && depth[ curr ] >= aAggregationDepth );
+        mChildBegin.push_back( static_cast<int>( mItems.size() ) );
+        for( size_t i = 0; i < item->getNumChildren(); ++i ) {
+            ALandAllocatorItem* child = item->getChildAt( i );
+            itemIndex[ child ] = static_cast<int>( mItems.size() );
+            mItems.push_back( child );
+            mParent.push_back( static_cast<int>( curr ) );
+            depth.push_back( depth[ curr ] + 1 );
+        }
+        mChildEnd.push_back( static_cast<int>( mItems.size() ) );
+    }
+    addLeaves( aRoot, itemIndex );
+
+    mShareWeight.resize( mItems.size() );
+    mProfitRate.resize( mItems.size() );
+    mShare.resize( mItems.size() );
+    mLandAllocation.resize( mItems.size() );
+    mIsHeld.resize( mNodes.size(), false );
+    mHeldShare.resize( mItems.size() );
+}
+
+/*!
+ * \brief Hold the shares within the aggregated nodes at those of the previous
+ *        period for the calculations of a period.
+ * \details Nothing is held in calibration periods since the aggregation is only
+ *          an approximation.  A node whose children had no share
+ *          in the previous period is calculated in full since there would be
+ *          nothing to disaggregate its land with.  This should be called during
+ *          initCalc so that the shares held do not change during the period.
+ * \param aPeriod Model period.
+ */
+void FlatLandAllocator::setAggregatedShares( const int aPeriod ) {
+    const bool isCalibrationPeriod = aPeriod <= scenario->getModeltime()->getFinalCalibrationPeriod();
+    for( size_t node = 0; node < mNodes.size(); ++node ) {
+        mIsHeld[ node ] = false;
+        if( !mIsAggregated[ node ] || isCalibrationPeriod ) {
+            continue;
+        }
+        double sum = 0.0;
+        for( int i = mChildBegin[ node ]; i < mChildEnd[ node ]; ++i ) {
+            mHeldShare[ i ] = mItems[ i ]->mShare[ aPeriod - 1 ];
+            sum += mHeldShare[ i ];
+        }
+        mIsHeld[ node ] = sum > 0.0;
+    }
+}
+
+/*!
+ * \brief Add the leaves below an item in depth first order.
+ * \param aItem The item to add the leaves of.
+ * \param aItemIndex The index in mItems of each item.
+ */
+void FlatLandAllocator::addLeaves( ALandAllocatorItem* aItem,
+                                   const map<const ALandAllocatorItem*, int>& aItemIndex )
+{
+    if( aItem->getType() == eLeaf ) {
+        mLeaves.push_back( static_cast<LandLeaf*>( aItem ) );
+        mLeafItem.push_back( aItemIndex.find( aItem )->second );
+        return;
+    }
+    for( size_t i = 0; i < aItem->getNumChildren(); ++i ) {
+        addLeaves( aItem->getChildAt( i ), aItemIndex );
+    }
+}
+
+/*!
+ * \brief Calculate the share of every item and the profit rate of every node.
+ * \details This is equivalent to LandNode::calcLandShares on the root.  The
+ *          shares and node profit rates are written back to the items.  The
+ *          share of the root is left for the LandAllocator to set.
+ * \param aPeriod Model period.
+ */
+void FlatLandAllocator::calcLandShares( const int aPeriod ) {
+    const size_t numItems = mItems.size();
+    for( size_t i = 0; i < numItems; ++i ) {
+        mShareWeight[ i ] = mItems[ i ]->mShareWeight[ aPeriod ];
+        mProfitRate[ i ] = mItems[ i ]->mProfitRate[ aPeriod ];
+    }
+
+    // Nodes are stored parents first so going backwards calculates the profit
+    // rate of each node before it is needed by the share calculation of its
+    // parent.
+    for( size_t node = mNodes.size(); node-- > 0; ) {
+        const int begin = mChildBegin[ node ];
+        const size_t numChildren = mChildEnd[ node ] - begin;
+        if( mIsHeld[ node ] ) {
+            double profitRate = 0.0;
+            for( int i = begin; i < mChildEnd[ node ]; ++i ) {
+                mShare[ i ] = mHeldShare[ i ];
+                profitRate += mShare[ i ] * mProfitRate[ i ];
+            }
+            mProfitRate[ mNodeItem[ node ] ] = profitRate;
+            continue;
+        }
+        const IDiscreteChoice* choiceFn = mNodes[ node ]->mChoiceFn;
+        choiceFn->calcUnnormalizedShares( &mShareWeight[ begin ], &mProfitRate[ begin ],
+                                          &mShare[ begin ], numChildren, aPeriod );
+        pair<double, double> unnormalizedSum = SectorUtils::normalizeLogShares( &mShare[ begin ], numChildren );
+        mProfitRate[ mNodeItem[ node ] ] = choiceFn->calcAverageValue( unnormalizedSum.first,
+                                                                       unnormalizedSum.second,
+                                                                       aPeriod );
+    }
+
+    for( size_t i = 1; i < numItems; ++i ) {
+        assert( mShare[ i ] >= 0 && mShare[ i ] <= 1 );
+        mItems[ i ]->mShare[ aPeriod ] = mShare[ i ];
+    }
+    for( size_t node = 0; node < mNodes.size(); ++node ) {
+        mNodes[ node ]->mProfitRate[ aPeriod ] = mProfitRate[ mNodeItem[ node ] ];
+    }
+}
+
+/*!
+ * \brief Calculate the land allocated to every item using the shares from
+ *        the last call to calcLandShares.
+ * \details This is equivalent to calling LandNode::calcLandAllocation for each
+ *          child of the root.  The allocations of the leaves are written back
+ *          and demands for land expansion cost markets added.
+ * \param aRegionName Region name.
+ * \param aRootLandAllocation The total land of the root.
+ * \param aPeriod Model period.
+ */
+void FlatLandAllocator::calcLandAllocation( const string& aRegionName, const double aRootLandAllocation,
+                                            const int aPeriod )
+{
+    const size_t numItems = mItems.size();
+    mLandAllocation[ 0 ] = aRootLandAllocation;
+    for( size_t i = 1; i < numItems; ++i ) {
+        const double landAllocationAbove = mLandAllocation[ mParent[ i ] ];
+        const bool hasLand = landAllocationAbove > 0.0 && ( mIsLeaf[ i ] || mShare[ i ] > 0.0 );
+        mLandAllocation[ i ] = hasLand ? landAllocationAbove * mShare[ i ] : 0.0;
+    }
+
+    Marketplace* marketplace = scenario->getMarketplace();
+    for( size_t leaf = 0; leaf < mLeaves.size(); ++leaf ) {
+        LandLeaf* currLeaf = mLeaves[ leaf ];
+        currLeaf->mLandAllocation[ aPeriod ] = mLandAllocation[ mLeafItem[ leaf ] ];
+        if( currLeaf->mIsLandExpansionCost ) {
+            marketplace->addToDemand( currLeaf->mLandExpansionCostName, aRegionName,
+                                      currLeaf->mLandAllocation[ aPeriod ], aPeriod, true );
+        }
+    }
+}
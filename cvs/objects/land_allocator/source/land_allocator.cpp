@@ -42,6 +42,7 @@
 #include "util/base/include/xml_helper.h"
 
 #include "land_allocator/include/land_allocator.h"
+#include "land_allocator/include/flat_land_allocator.h"
 #include "containers/include/scenario.h"
 #include "containers/include/iinfo.h"
 #include "util/base/include/model_time.h"
@@ -134,6 +135,10 @@ void LandAllocator::initCalc( const string& aRegionName, const int aPeriod )
 
     // Call land node's initCalc
     LandNode::initCalc( aRegionName, aPeriod );
+
+    if( mFlatAllocator.get() ) {
+        mFlatAllocator->setAggregatedShares( aPeriod );
+    }
     
     // Ensure that carbon price increase rate is positive
     if ( mCarbonPriceIncreaseRate[ aPeriod ] < 0 ) {
@@ -163,6 +168,13 @@ void LandAllocator::completeInit( const string& aRegionName,
 
     // Set the soil time scale
     setSoilTimeScale( mSoilTimeScale );
+
+    // The structure of the tree is now final so it may be flattened.  Nodes may
+    // only be aggregated in the flattened tree.
+    const int aggregationDepth = Configuration::getInstance()->getInt( "land-aggregation-depth", 0, false );
+    if( Configuration::getInstance()->getBool( "flat-land-allocation", false ) || aggregationDepth > 0 ) {
+        mFlatAllocator.reset( new FlatLandAllocator( this, aggregationDepth ) );
+    }
 }
 
 
@@ -310,6 +322,9 @@ void LandAllocator::setInitShares( const string& aRegionName,
 
     // This is the root node so its share is 100%.
     mShare[ aPeriod ] = 1;
+
+    // The shares of the children have just been overwritten.
+    mSharesCalculated[ aPeriod ] = 0.0;
 }
 
 double LandAllocator::calcLandShares( const string& aRegionName,
@@ -319,7 +334,12 @@ double LandAllocator::calcLandShares( const string& aRegionName,
     // First set value of unmanaged land leaves
     setUnmanagedLandProfitRate( aRegionName, mUnManagedLandValue, aPeriod );
 
-    LandNode::calcLandShares( aRegionName, aChoiceFnAbove, aPeriod );
+    if( mFlatAllocator.get() ) {
+        mFlatAllocator->calcLandShares( aPeriod );
+    }
+    else {
+        LandNode::calcLandShares( aRegionName, aChoiceFnAbove, aPeriod );
+    }
  
     // This is the root node so its share is 100%.
     mShare[ aPeriod ] = 1;
@@ -329,6 +349,10 @@ double LandAllocator::calcLandShares( const string& aRegionName,
 void LandAllocator::calcLandAllocation( const string& aRegionName,
                                             const double aLandAllocationAbove,
                                             const int aPeriod ){
+    if( mFlatAllocator.get() ) {
+        mFlatAllocator->calcLandAllocation( aRegionName, mLandAllocation[ aPeriod ], aPeriod );
+        return;
+    }
     for ( unsigned int i = 0; i < mChildren.size(); ++i ){
         mChildren[ i ]->calcLandAllocation( aRegionName, mLandAllocation[ aPeriod ], aPeriod );
     }
@@ -280,6 +280,7 @@ void LandLeaf::initLandUseHistory( const string& aRegionName )
                 << getName() << " in region " << aRegionName << endl;
         abort();
     }
+    mLandUseHistory->bindMappedData( getXMLName() + "/" + aRegionName + "/" + getName() );
     mCarbonContentCalc->setLandUseObjects( mLandUseHistory, this );
 }
 
@@ -250,6 +250,9 @@ void LandNode::completeInit( const string& aRegionName,
                 << aRegionName << ", " << mName << endl;
         abort();
     }
+    if( mLandUseHistory ) {
+        mLandUseHistory->bindMappedData( getXMLName() + "/" + aRegionName + "/" + getName() );
+    }
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
         mChildren[ i ]->completeInit( aRegionName, aRegionInfo );
     }
@@ -271,6 +274,10 @@ void LandNode::initCalc( const string& aRegionName, const int aPeriod )
         }
     }
 
+    // The discrete choice function may have changed so the shares must be
+    // calculated in full the next time.
+    mSharesCalculated[ aPeriod ] = 0.0;
+
     // Call initCalc on any children
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
         mChildren[ i ]->initCalc( aRegionName, aPeriod );
@@ -304,6 +311,9 @@ void LandNode::setInitShares( const string& aRegionName,
         mShare[ aPeriod ] = nodeLandAllocation / aLandAllocationAbove;
    }
 
+    // The shares of the children are about to be overwritten.
+    mSharesCalculated[ aPeriod ] = 0.0;
+
     // Call setInitShares on all children
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {        
         mChildren[ i ]->setInitShares( aRegionName,
@@ -381,10 +391,12 @@ double LandNode::calcLandShares( const string& aRegionName,
     // These calls need to be made to initiate recursion into lower nests even
     // if the current node will have fixed shares.
     // Note these are the log( unnormalized shares )
+    bool hasChanged = mSharesCalculated[ aPeriod ] == 0.0;
     for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
         unnormalizedShares[ i ] = mChildren[ i ]->calcLandShares( aRegionName,
                                                                   mChoiceFn,
                                                                   aPeriod );
+        hasChanged = mChildren[ i ]->updateUnnormalizedShare( unnormalizedShares[ i ], aPeriod ) || hasChanged;
     }
 
     // Step 2 Normalize and set the share of each child
@@ -392,13 +404,20 @@ double LandNode::calcLandShares( const string& aRegionName,
     // do it making an attempt to avoid numerical instabilities given the profit rates
     // may be large values.  The value returned is a pair<unnormalizedSum, log(scale factor)>
     // again in order to try to make calculations in a numerically stable way.
-    pair<double, double> unnormalizedSum = SectorUtils::normalizeLogShares( unnormalizedShares );
-    for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
-        mChildren[ i ]->setShare( unnormalizedShares[ i ], aPeriod );
-    }
+    // If none of the children changed, such as when a partial derivative only
+    // perturbs the profit rates in another nest, then their shares and the
+    // profit rate of this node are already up to date and steps 2 and 3 can
+    // be skipped.
+    if( hasChanged ) {
+        pair<double, double> unnormalizedSum = SectorUtils::normalizeLogShares( unnormalizedShares );
+        for ( unsigned int i = 0; i < mChildren.size(); i++ ) {
+            mChildren[ i ]->setShare( unnormalizedShares[ i ], aPeriod );
+        }
 
-    // Step 3 Option (a) . compute node profit based on share denominator
-    mProfitRate[ aPeriod ] = mChoiceFn->calcAverageValue( unnormalizedSum.first, unnormalizedSum.second, aPeriod );
+        // Step 3 Option (a) . compute node profit based on share denominator
+        mProfitRate[ aPeriod ] = mChoiceFn->calcAverageValue( unnormalizedSum.first, unnormalizedSum.second, aPeriod );
+        mSharesCalculated[ aPeriod ] = 1.0;
+    }
 
     // Step 4. Calculate the unnormalized share for this node, but here using the discrete choice of the 
     // containing or parant node.  This will be used to determine this nodes share within its 
@@ -478,6 +497,7 @@ void LandNode::calculateNodeProfitRates( const string& aRegionName,
     }
     mProfitRate[ aPeriod ] = maxChildProfitRate;
     mChoiceFn->setBaseValue( maxChildProfitRate );
+    mSharesCalculated[ aPeriod ] = 0.0;
 }
 
 /*!
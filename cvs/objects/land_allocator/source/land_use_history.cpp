@@ -39,6 +39,7 @@
  */
 
 #include "util/base/include/definitions.h"
+#include <algorithm>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/base/include/xml_helper.h"
 #include "land_allocator/include/land_use_history.h"
@@ -69,6 +70,9 @@ bool LandUseHistory::XMLParse( const xercesc::DOMNode* aNode ){
     // assume we are passed a valid node.
     assert( aNode );
 
+    // Allocations may still be added to a compacted history.
+    expand();
+
     // get all the children.
     DOMNodeList* nodeList = aNode->getChildNodes();
     
@@ -121,8 +125,9 @@ void LandUseHistory::toInputXML( ostream& aOut,
                                     Tabs* aTabs ) const
 {
     XMLWriteOpeningTag( getXMLNameStatic(), aOut, aTabs );
-    for( LandMapType::const_iterator i = mHistoricalLand.begin();
-         i != mHistoricalLand.end(); ++i )
+    const LandMapType historicalLand = getHistoricalLand();
+    for( LandMapType::const_iterator i = historicalLand.begin();
+         i != historicalLand.end(); ++i )
     {
         XMLWriteElement( i->second, "allocation", aOut, aTabs, i->first );
     }
@@ -136,8 +141,9 @@ void LandUseHistory::toDebugXML( const int aPeriod,
                                     Tabs* aTabs ) const
 {
     XMLWriteOpeningTag( getXMLNameStatic(), aOut, aTabs );
-    for( LandMapType::const_iterator i = mHistoricalLand.begin();
-         i != mHistoricalLand.end(); ++i )
+    const LandMapType historicalLand = getHistoricalLand();
+    for( LandMapType::const_iterator i = historicalLand.begin();
+         i != historicalLand.end(); ++i )
     {
         XMLWriteElement( i->second, "allocation", aOut, aTabs, i->first );
     }
@@ -157,6 +163,9 @@ void LandUseHistory::accept( IVisitor* aVisitor,
  * \return The earliest year with a historical land allocation.
  */
 unsigned int LandUseHistory::getMinYear() const {
+    if( isMapped() ){
+        return mMappedLand.mYears[ 0 ];
+    }
     if( mHistoricalLand.empty() ){
         return 0;
     }
@@ -172,6 +181,9 @@ unsigned int LandUseHistory::getMinYear() const {
  * \return The last year with a historical land allocation.
  */
 unsigned int LandUseHistory::getMaxYear() const {
+    if( isMapped() ){
+        return mMappedLand.mYears[ mMappedLand.mSize - 1 ];
+    }
     if( mHistoricalLand.empty() ){
         return 0;
     }
@@ -191,6 +203,24 @@ unsigned int LandUseHistory::getMaxYear() const {
  * \return Historical land allocation for the year.
  */
 double LandUseHistory::getAllocation( const unsigned int aYear ) const {
+    if( isMapped() ){
+        // The same rules apply to the mapped column which is sorted by year.
+        const unsigned int* years = mMappedLand.mYears;
+        const unsigned int last = mMappedLand.mSize - 1;
+        if( aYear >= years[ last ] ){
+            return mMappedLand.mValues[ last ];
+        }
+        if( aYear <= years[ 0 ] ){
+            return mMappedLand.mValues[ 0 ];
+        }
+        const unsigned int upper = std::lower_bound( years, years + last, aYear ) - years;
+        if( years[ upper ] == aYear ){
+            return mMappedLand.mValues[ upper ];
+        }
+        return util::linearInterpolateY( aYear, years[ upper - 1 ], years[ upper ],
+                                         mMappedLand.mValues[ upper - 1 ], mMappedLand.mValues[ upper ] );
+    }
+
     // If there are no values in the map always return zero.
     if( mHistoricalLand.empty() ){
         return 0;
@@ -246,13 +276,93 @@ double LandUseHistory::getHistoricBelowGroundCarbonDensity( ) const {
 }
 
 const LandMapType LandUseHistory::getHistoricalLand() const {
+    if( isMapped() ){
+        LandMapType historicalLand;
+        for( unsigned int i = 0; i < mMappedLand.mSize; ++i ){
+            historicalLand[ mMappedLand.mYears[ i ] ] = mMappedLand.mValues[ i ];
+        }
+        return historicalLand;
+    }
 	return mHistoricalLand;
 }
 
 void LandUseHistory::printHistory() const {
-	 for( LandMapType::const_iterator i = mHistoricalLand.begin();
-         i != mHistoricalLand.end(); ++i )
+    const LandMapType historicalLand = getHistoricalLand();
+	 for( LandMapType::const_iterator i = historicalLand.begin();
+         i != historicalLand.end(); ++i )
     {
 		std::cout<<i->second<<" "<<i->first<<endl;
     }
 }
+
+/*!
+ * \brief Connect the history to its column of the MappedDataTable.
+ * \details When the table is collecting columns the allocations read from XML
+ *          are added to it under the given key.  Otherwise, if no allocations
+ *          were read from XML and the mapped table has a column for the key,
+ *          the history uses a view of that column from then on.  Allocations
+ *          read in always take precedence so that add-on files may still
+ *          override a mapped history.
+ * \param aKey A key for this history which is unique within the scenario.
+ */
+void LandUseHistory::bindMappedData( const string& aKey ) {
+    MappedDataTable& table = MappedDataTable::getInstance();
+    if( table.isCollecting() ){
+        // The allocations may have already been compacted by an earlier bind.
+        if( !mHistoricalLand.empty() || !mCompactYears.empty() ){
+            table.addColumn( aKey, getHistoricalLand() );
+        }
+    }
+    else if( mHistoricalLand.empty() && mCompactYears.empty() && table.isOpen() ){
+        MappedDataTable::Column column;
+        if( table.getColumn( aKey, column ) && column.mSize > 0 ){
+            mMappedLand = column;
+        }
+    }
+    compact();
+}
+
+/*!
+ * \brief Move the allocations read from XML out of mHistoricalLand into the
+ *        sorted compact arrays and view them the same way as a mapped column.
+ * \details A map node costs several times the year and allocation it holds
+ *          and there is a history for every land type in every region so this
+ *          adds up.  The lookups in getAllocation are just as fast.
+ */
+void LandUseHistory::compact() {
+    if( isMapped() || mHistoricalLand.empty() ){
+        return;
+    }
+    mCompactYears.reserve( mHistoricalLand.size() );
+    mCompactLand.reserve( mHistoricalLand.size() );
+    for( LandMapType::const_iterator i = mHistoricalLand.begin(); i != mHistoricalLand.end(); ++i ){
+        mCompactYears.push_back( i->first );
+        mCompactLand.push_back( i->second );
+    }
+    LandMapType().swap( mHistoricalLand );
+    mMappedLand.mYears = &mCompactYears[ 0 ];
+    mMappedLand.mValues = &mCompactLand[ 0 ];
+    mMappedLand.mSize = static_cast<unsigned int>( mCompactYears.size() );
+}
+
+/*!
+ * \brief Move compacted allocations back into mHistoricalLand so that it may
+ *        be modified again.
+ */
+void LandUseHistory::expand() {
+    if( mCompactYears.empty() ){
+        return;
+    }
+    mHistoricalLand = getHistoricalLand();
+    mMappedLand = MappedDataTable::Column();
+    vector<unsigned int>().swap( mCompactYears );
+    vector<double>().swap( mCompactLand );
+}
+
+/*!
+ * \brief Check if the allocations are a view of the MappedDataTable.
+ * \return Whether the history is bound to a mapped column.
+ */
+bool LandUseHistory::isMapped() const {
+    return mMappedLand.mSize > 0;
+}
@@ -0,0 +1,246 @@
+#ifndef _GCAM_API_H_
+#define _GCAM_API_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file gcam_api.h
+* \ingroup Objects
+* \brief The C interface used to embed GCAM in another model.
+* \details A coupled model links against the libgcam_api shared library, built
+*          by the gcam-shared target, and drives the scenario a period at a
+*          time from its own time loop.  Markets and emissions are resolved to
+*          handles once, after which reading and setting their values does no
+*          name lookups.  Only one session may exist in a process at a time as
+*          the model is reached through global state.
+*
+*          A typical coupling loop is:
+*          \code
+*          GcamSession* session = gcam_create( "configuration.xml", "log_conf.xml" );
+*          GcamMarketHandle carbon = gcam_find_market( session, "USA", "CO2" );
+*          GcamEmissionsHandle co2 = gcam_find_emissions( session, "CO2" );
+*          int numPeriods;
+*          const double* emissions = gcam_get_emissions( session, co2, &numPeriods );
+*          while( gcam_advance_period( session ) ) {
+*              const int period = gcam_get_current_period( session );
+*              // exchange emissions[ period ] and prices with the coupled model.
+*          }
+*          gcam_destroy( session );
+*          \endcode
+*/
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*! \brief An opaque handle to a parsed and initialized scenario. */
+typedef struct GcamSession GcamSession;
+
+/*! \brief A handle to a market resolved by gcam_find_market. */
+typedef int GcamMarketHandle;
+
+/*! \brief A handle to a global emissions series resolved by
+ *         gcam_find_emissions. */
+typedef int GcamEmissionsHandle;
+
+/*! \brief The handle returned when a market or gas could not be found. */
+#define GCAM_INVALID_HANDLE -1
+
+/*!
+ * \brief Parse the inputs named in a configuration file and initialize the
+ *        scenario.
+ * \param aConfigurationFile The configuration file to read.
+ * \param aLogConfigurationFile The log configuration file to read.
+ * \return The new session, or null if the inputs could not be read or a session
+ *         already exists.
+ */
+GcamSession* gcam_create( const char* aConfigurationFile, const char* aLogConfigurationFile );
+
+/*!
+ * \brief Release a session and everything it owns.  All handles and emissions
+ *        arrays of the session become invalid.
+ * \param aSession The session, which may be null.
+ */
+void gcam_destroy( GcamSession* aSession );
+
+/*!
+ * \brief Get the number of model periods.
+ * \param aSession The session.
+ * \return The number of model periods.
+ */
+int gcam_get_num_periods( const GcamSession* aSession );
+
+/*!
+ * \brief Get the year of a model period.
+ * \param aSession The session.
+ * \param aPeriod The model period.
+ * \return The year the period ends in.
+ */
+int gcam_get_period_year( const GcamSession* aSession, int aPeriod );
+
+/*!
+ * \brief Get the last period which was run.
+ * \param aSession The session.
+ * \return The last period run, or -1 if no period has been run.
+ */
+int gcam_get_current_period( const GcamSession* aSession );
+
+/*!
+ * \brief Run a model period.
+ * \details Any earlier periods which have not been calculated are run first.
+ *          Periods after the given one must be run again before their results
+ *          are used.  Registered emissions arrays are refreshed afterwards.
+ * \param aSession The session.
+ * \param aPeriod The model period to run.
+ * \return 1 if the period, and all periods run before it, solved and 0
+ *         otherwise.
+ */
+int gcam_run_period( GcamSession* aSession, int aPeriod );
+
+/*!
+ * \brief Run the period after the last period which was run.
+ * \param aSession The session.
+ * \return 1 if the period solved, 0 if it did not or the final period had
+ *         already been run.
+ */
+int gcam_advance_period( GcamSession* aSession );
+
+/*!
+ * \brief Write the configured output files and database for the periods run.
+ * \param aSession The session.
+ */
+void gcam_write_output( GcamSession* aSession );
+
+/*!
+ * \brief Resolve the market in which a region trades a good.
+ * \param aSession The session.
+ * \param aRegion The name of the region.
+ * \param aGood The name of the good.
+ * \return The market handle, or GCAM_INVALID_HANDLE if there is no such
+ *         market.
+ */
+GcamMarketHandle gcam_find_market( GcamSession* aSession, const char* aRegion, const char* aGood );
+
+/*!
+ * \brief Get the price of a market.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \return The price.
+ */
+double gcam_get_price( const GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod );
+
+/*!
+ * \brief Set the price of a market.
+ * \details Prices of markets which are not solved, such as a tax or a price
+ *          imposed by the coupled model, are used as given when the period is
+ *          next run.  The price of a solved market only serves as the initial
+ *          guess of the solver.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \param aPrice The new price.
+ */
+void gcam_set_price( GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod, double aPrice );
+
+/*!
+ * \brief Get the supply of a market.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \return The supply.
+ */
+double gcam_get_supply( const GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod );
+
+/*!
+ * \brief Get the demand of a market.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \return The demand.
+ */
+double gcam_get_demand( const GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod );
+
+/*!
+ * \brief Add a quantity to the supply of a market.
+ * \details Supplies and demands are recalculated each time the model is
+ *          evaluated, so this only affects the period as it currently stands
+ *          and is mainly useful between runs to impose the quantities of the
+ *          coupled model on reporting of the market.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \param aQuantity The quantity to add.
+ */
+void gcam_add_to_supply( GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod, double aQuantity );
+
+/*!
+ * \brief Add a quantity to the demand of a market.
+ * \details See gcam_add_to_supply.
+ * \param aSession The session.
+ * \param aMarket The market handle.
+ * \param aPeriod The model period.
+ * \param aQuantity The quantity to add.
+ */
+void gcam_add_to_demand( GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod, double aQuantity );
+
+/*!
+ * \brief Register the global emissions of a gas to be summed after each run.
+ * \param aSession The session.
+ * \param aGasName The name of the gas, such as CO2.
+ * \return The emissions handle.  Resolving the same gas twice returns the same
+ *         handle.
+ */
+GcamEmissionsHandle gcam_find_emissions( GcamSession* aSession, const char* aGasName );
+
+/*!
+ * \brief Get the global emissions of a gas by period.
+ * \details The array is owned by the session and is updated in place by each
+ *          run, so it may be read repeatedly without copying.  It remains valid
+ *          until the session is destroyed.
+ * \param aSession The session.
+ * \param aEmissions The emissions handle.
+ * \param aNumPeriods [out] The length of the array, which may be null.
+ * \return The emissions by model period.
+ */
+const double* gcam_get_emissions( const GcamSession* aSession, GcamEmissionsHandle aEmissions,
+                                  int* aNumPeriods );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _GCAM_API_H_ */
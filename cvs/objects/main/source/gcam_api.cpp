@@ -0,0 +1,374 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+ * \file gcam_api.cpp
+ * \ingroup Objects
+ * \brief The implementation of the C interface used to embed GCAM in another
+ *        model.
+ * \details This file takes the place of main.cpp in the shared library and so
+ *          defines the globals which main.cpp otherwise provides.
+ */
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <exception>
+#include <boost/shared_ptr.hpp>
+
+#include "main/include/gcam_api.h"
+#include "containers/include/scenario.h"
+#include "containers/include/single_scenario_runner.h"
+#include "containers/include/scenario_runner_factory.h"
+#include "marketplace/include/marketplace.h"
+#include "marketplace/include/cached_market.h"
+#include "emissions/include/emissions_summer.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/value.h"
+#include "util/base/include/timer.h"
+#include "util/base/include/xml_helper.h"
+#include "util/logger/include/ilogger.h"
+#include "util/logger/include/logger_factory.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_scheduler_init.h>
+#endif
+
+using namespace std;
+
+// The globals normally defined in main.cpp.
+ofstream outFile;
+Scenario* scenario;
+
+/*!
+ * \brief The state behind a GcamSession handle.
+ */
+struct GcamSession {
+    //! A market resolved for every model period.
+    struct MarketHandle {
+        //! The name of the good.
+        string mGoodName;
+
+        //! The name of the region.
+        string mRegionName;
+
+        //! The located market in each period.
+        vector<boost::shared_ptr<CachedMarket> > mMarkets;
+    };
+
+    //! The global emissions of a gas.
+    struct EmissionsHandle {
+        //! The name of the gas.
+        string mGasName;
+
+        //! The emissions by period which are handed out to callers.
+        vector<double> mEmissions;
+
+        //! Whether the base period emissions, which do not change after the
+        //! base period is run, have been summed.
+        bool mIsBaseSet;
+    };
+
+    //! Keeps the loggers alive for the duration of the session.
+    LoggerFactoryWrapper mLoggerFactoryWrapper;
+
+    //! The timer used to report the time spent in the model.
+    Timer mTimer;
+
+    //! The scenario runner which owns the scenario.
+    auto_ptr<SingleScenarioRunner> mRunner;
+
+    //! The last period run, or -1 if none have been.
+    int mCurrentPeriod;
+
+    //! The resolved markets, indexed by GcamMarketHandle.
+    vector<MarketHandle> mMarketHandles;
+
+    //! The registered emissions, indexed by GcamEmissionsHandle.  A deque so
+    //! that registering a gas does not move the arrays already handed out.
+    deque<EmissionsHandle> mEmissionsHandles;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Limits the threads used to calculate the model.
+    auto_ptr<tbb::task_scheduler_init> mThreadLimit;
+#endif
+    
+    GcamSession():mCurrentPeriod( -1 ){
+    }
+
+    Scenario* getScenario() const {
+        return mRunner->getInternalScenario();
+    }
+
+    void updateEmissions();
+};
+
+namespace {
+    //! The session which currently exists, only one may at a time.
+    GcamSession* gActiveSession = 0;
+
+    /*!
+     * \brief Log an exception which would otherwise escape through the C
+     *        interface.
+     * \param aFunction The name of the interface function.
+     * \param aWhat A description of the exception.
+     */
+    void logException( const char* aFunction, const char* aWhat ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << aFunction << " failed: " << aWhat << endl;
+    }
+}
+
+/*!
+ * \brief Sum the registered emissions for every period in a single visit of
+ *        the model and store them in the arrays handed out to callers.
+ */
+void GcamSession::updateEmissions() {
+    if( mEmissionsHandles.empty() || mCurrentPeriod < 0 ) {
+        return;
+    }
+
+    const Scenario* currScenario = getScenario();
+    vector<boost::shared_ptr<EmissionsSummer> > summers;
+    GroupedEmissionsSummer allSummer;
+    for( auto& handle : mEmissionsHandles ) {
+        summers.push_back( boost::shared_ptr<EmissionsSummer>( new EmissionsSummer( handle.mGasName ) ) );
+        allSummer.addEmissionsSummer( summers.back().get() );
+    }
+    // The grouped summer does not update the base period.
+    currScenario->accept( &allSummer, -1 );
+
+    for( size_t i = 0; i < mEmissionsHandles.size(); ++i ) {
+        EmissionsHandle& handle = mEmissionsHandles[ i ];
+        if( !handle.mIsBaseSet ) {
+            EmissionsSummer baseSummer( handle.mGasName );
+            currScenario->accept( &baseSummer, 0 );
+            handle.mEmissions[ 0 ] = baseSummer.getEmissions( 0 );
+            handle.mIsBaseSet = true;
+        }
+        for( size_t period = 1; period < handle.mEmissions.size(); ++period ) {
+            handle.mEmissions[ period ] = summers[ i ]->getEmissions( period );
+        }
+    }
+}
+
+GcamSession* gcam_create( const char* aConfigurationFile, const char* aLogConfigurationFile ) {
+    if( gActiveSession ) {
+        return 0;
+    }
+
+    auto_ptr<GcamSession> session( new GcamSession() );
+    session->mTimer.start();
+    if( !XMLHelper<void>::parseXML( aLogConfigurationFile, &session->mLoggerFactoryWrapper ) ) {
+        return 0;
+    }
+
+    try {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Configuration file:  " << aConfigurationFile << endl;
+        mainLog << "Parsing input files..." << endl;
+        Configuration* conf = Configuration::getInstance();
+        if( !XMLHelper<void>::parseXML( aConfigurationFile, conf ) ) {
+            return 0;
+        }
+
+#if GCAM_PARALLEL_ENABLED
+        const int numThreads = conf->getInt( "parallel-threads", 0, false );
+        session->mThreadLimit.reset( new tbb::task_scheduler_init(
+            numThreads > 0 ? numThreads : tbb::task_scheduler_init::automatic ) );
+#endif
+
+        session->mRunner = ScenarioRunnerFactory::createSingleScenarioRunner();
+        if( !session->mRunner->setupScenarios( session->mTimer ) || !session->getScenario() ) {
+            return 0;
+        }
+    }
+    catch( const exception& aException ) {
+        logException( "gcam_create", aException.what() );
+        return 0;
+    }
+
+    gActiveSession = session.release();
+    return gActiveSession;
+}
+
+void gcam_destroy( GcamSession* aSession ) {
+    if( !aSession ) {
+        return;
+    }
+
+    // Release the cached markets before the marketplace which owns them.
+    aSession->mMarketHandles.clear();
+    if( aSession->mRunner.get() ) {
+        aSession->mRunner->cleanup();
+    }
+    if( gActiveSession == aSession ) {
+        gActiveSession = 0;
+    }
+    delete aSession;
+    XMLHelper<void>::cleanupParser();
+}
+
+int gcam_get_num_periods( const GcamSession* aSession ) {
+    return aSession->getScenario()->getModeltime()->getmaxper();
+}
+
+int gcam_get_period_year( const GcamSession* aSession, int aPeriod ) {
+    return aSession->getScenario()->getModeltime()->getper_to_yr( aPeriod );
+}
+
+int gcam_get_current_period( const GcamSession* aSession ) {
+    return aSession->mCurrentPeriod;
+}
+
+int gcam_run_period( GcamSession* aSession, int aPeriod ) {
+    if( aPeriod < 0 || aPeriod >= gcam_get_num_periods( aSession ) ) {
+        return 0;
+    }
+
+    bool success = false;
+    try {
+        success = aSession->mRunner->runScenarios( aPeriod, false, aSession->mTimer );
+        aSession->mCurrentPeriod = aPeriod;
+        if( aPeriod == 0 ) {
+            for( auto& handle : aSession->mEmissionsHandles ) {
+                handle.mIsBaseSet = false;
+            }
+        }
+        aSession->updateEmissions();
+    }
+    catch( const exception& aException ) {
+        logException( "gcam_run_period", aException.what() );
+        return 0;
+    }
+    return success ? 1 : 0;
+}
+
+int gcam_advance_period( GcamSession* aSession ) {
+    return gcam_run_period( aSession, aSession->mCurrentPeriod + 1 );
+}
+
+void gcam_write_output( GcamSession* aSession ) {
+    try {
+        aSession->mRunner->printOutput( aSession->mTimer );
+    }
+    catch( const exception& aException ) {
+        logException( "gcam_write_output", aException.what() );
+    }
+}
+
+GcamMarketHandle gcam_find_market( GcamSession* aSession, const char* aRegion, const char* aGood ) {
+    const Marketplace* marketplace = aSession->getScenario()->getMarketplace();
+    GcamSession::MarketHandle handle;
+    handle.mGoodName = aGood;
+    handle.mRegionName = aRegion;
+    // Check the market exists before locating it in every period, a missing
+    // market is located as an empty CachedMarket.
+    if( !marketplace->getMarketInfo( handle.mGoodName, handle.mRegionName, 0, false ) ) {
+        return GCAM_INVALID_HANDLE;
+    }
+
+    const int maxPeriod = gcam_get_num_periods( aSession );
+    for( int period = 0; period < maxPeriod; ++period ) {
+        handle.mMarkets.push_back( boost::shared_ptr<CachedMarket>(
+            marketplace->locateMarket( handle.mGoodName, handle.mRegionName, period ).release() ) );
+    }
+    aSession->mMarketHandles.push_back( handle );
+    return static_cast<GcamMarketHandle>( aSession->mMarketHandles.size() - 1 );
+}
+
+double gcam_get_price( const GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod ) {
+    const GcamSession::MarketHandle& handle = aSession->mMarketHandles[ aMarket ];
+    return handle.mMarkets[ aPeriod ]->getPrice( handle.mGoodName, handle.mRegionName, aPeriod );
+}
+
+void gcam_set_price( GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod, double aPrice ) {
+    GcamSession::MarketHandle& handle = aSession->mMarketHandles[ aMarket ];
+    handle.mMarkets[ aPeriod ]->setPrice( handle.mGoodName, handle.mRegionName, aPrice, aPeriod );
+}
+
+double gcam_get_supply( const GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod ) {
+    const GcamSession::MarketHandle& handle = aSession->mMarketHandles[ aMarket ];
+    return handle.mMarkets[ aPeriod ]->getSupply( handle.mGoodName, handle.mRegionName, aPeriod );
+}
+
+double gcam_get_demand( const GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod ) {
+    const GcamSession::MarketHandle& handle = aSession->mMarketHandles[ aMarket ];
+    return handle.mMarkets[ aPeriod ]->getDemand( handle.mGoodName, handle.mRegionName, aPeriod );
+}
+
+void gcam_add_to_supply( GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod, double aQuantity ) {
+    GcamSession::MarketHandle& handle = aSession->mMarketHandles[ aMarket ];
+    handle.mMarkets[ aPeriod ]->addToSupply( handle.mGoodName, handle.mRegionName, Value( aQuantity ), aPeriod );
+}
+
+void gcam_add_to_demand( GcamSession* aSession, GcamMarketHandle aMarket, int aPeriod, double aQuantity ) {
+    GcamSession::MarketHandle& handle = aSession->mMarketHandles[ aMarket ];
+    handle.mMarkets[ aPeriod ]->addToDemand( handle.mGoodName, handle.mRegionName, Value( aQuantity ), aPeriod );
+}
+
+GcamEmissionsHandle gcam_find_emissions( GcamSession* aSession, const char* aGasName ) {
+    const string gasName( aGasName );
+    for( size_t i = 0; i < aSession->mEmissionsHandles.size(); ++i ) {
+        if( aSession->mEmissionsHandles[ i ].mGasName == gasName ) {
+            return static_cast<GcamEmissionsHandle>( i );
+        }
+    }
+
+    GcamSession::EmissionsHandle handle;
+    handle.mGasName = gasName;
+    handle.mEmissions.resize( gcam_get_num_periods( aSession ), 0.0 );
+    handle.mIsBaseSet = false;
+    aSession->mEmissionsHandles.push_back( handle );
+
+    // Fill in the periods which have already been run.
+    aSession->updateEmissions();
+    return static_cast<GcamEmissionsHandle>( aSession->mEmissionsHandles.size() - 1 );
+}
+
+const double* gcam_get_emissions( const GcamSession* aSession, GcamEmissionsHandle aEmissions,
+                                  int* aNumPeriods )
+{
+    const GcamSession::EmissionsHandle& handle = aSession->mEmissionsHandles[ aEmissions ];
+    if( aNumPeriods ) {
+        *aNumPeriods = static_cast<int>( handle.mEmissions.size() );
+    }
+    return &handle.mEmissions[ 0 ];
+}
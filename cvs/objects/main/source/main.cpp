@@ -71,10 +71,17 @@
 #include "containers/include/scenario.h"
 #include "containers/include/iscenario_runner.h"
 #include "containers/include/scenario_runner_factory.h"
+#include "containers/include/model_server.h"
 #include "util/logger/include/ilogger.h"
 #include "util/logger/include/logger_factory.h"
+#include "util/logger/include/binary_logger.h"
 #include "util/base/include/timer.h"
 #include "util/base/include/version.h"
+#include "util/base/include/gcam_mpi.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_scheduler_init.h>
+#endif
 
 using namespace std;
 using namespace xercesc;
@@ -85,19 +92,31 @@ ofstream outFile;
 
 // Initialize time and set some pointers to null.
 // Declared outside Main to make global.
+/* \todo The scenario is reached through this global from several hundred
+ *       places, including the solver's Jacobian and state management, so only
+ *       one scenario may be active in a process.  The Configuration, logger and
+ *       profiling singletons have the same restriction.  Until all of these can
+ *       be passed explicitly, concurrent scenarios are run in separate worker
+ *       processes by the BatchRunner (see batch-concurrent-scenarios).
+ */
 Scenario* scenario; // model scenario info
 
-void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg );
+void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg, bool& serverArg );
 void printUsageMessage( unsigned int argc, char* argv[] );
 
 //! Main program. 
 int main( int argc, char *argv[] ) {
 
+    // Initialize MPI, if enabled, before anything else so that the ranks are
+    // known when the log files are opened.
+    GcamMPI::Session mpiSession( argc, argv );
+
     // identify default file names for control input and logging controls
     string configurationArg = "configuration.xml";
     string loggerFactoryArg = "log_conf.xml";
+    bool serverArg = false;
     // Parse any command line arguments.  Can override defaults with command lone args
-    parseArgs( argc, argv, configurationArg, loggerFactoryArg );
+    parseArgs( argc, argv, configurationArg, loggerFactoryArg, serverArg );
 
     // Add OS dependent prefixes to the arguments.
     const string configurationFileName = configurationArg;
@@ -167,6 +186,29 @@ int main( int argc, char *argv[] ) {
         return 1;
     }
 
+    // Apply the settings found by a previous parallel benchmark unless the
+    // benchmark is to be run again.
+    const bool runParallelBenchmark = conf->getInt( "parallel-benchmark-year", -1, false ) != -1;
+    const string tuningFileName = conf->getFile( "parallel-tuning", "", false );
+    if( !runParallelBenchmark && !tuningFileName.empty() && ifstream( tuningFileName.c_str() ).good() ) {
+        mainLog << "Parallel tuning file:  " << tuningFileName << endl;
+        XMLHelper<void>::parseXML( tuningFileName, conf );
+    }
+#if GCAM_PARALLEL_ENABLED
+    // Limit the threads used to calculate the model, the benchmark needs all
+    // of them.
+    const int numThreads = runParallelBenchmark ? 0 : conf->getInt( "parallel-threads", 0, false );
+    tbb::task_scheduler_init threadLimit( numThreads > 0 ? numThreads : tbb::task_scheduler_init::automatic );
+#endif
+
+    // In server mode scenarios are run on request from standard input until
+    // it is closed.
+    if( serverArg ) {
+        success = ModelServer::run( timer, cin, cout );
+        XMLHelper<void>::cleanupParser();
+        return success ? 0 : 1;
+    }
+
     // Create an empty exclusion list so that any type of IScenarioRunner can be
     // created.
     list<string> exclusionList;
@@ -190,8 +232,11 @@ int main( int argc, char *argv[] ) {
     const bool printDebug = conf->shouldWriteFile( "xmlDebugFileName" );
     success = runner->runScenarios( stopPeriod, printDebug, timer );
 
-    // Print the output.
-    runner->printOutput( timer );
+    // Print the output.  When the Jacobian is distributed every rank has run
+    // the same scenario so only the root rank needs to write it out.
+    if( GcamMPI::isRoot() || !GcamMPI::shouldDistributeJacobian() ) {
+        runner->printOutput( timer );
+    }
     mainLog.setLevel( ILogger::WARNING ); // Increase level so that user will know that model is done
     mainLog << "Model exiting successfully." << endl;
     runner->cleanup();
@@ -208,9 +253,10 @@ int main( int argc, char *argv[] ) {
 * \param argv List of arguments.
 * \param confArg [out] Name of the configuration file.
 * \param logFacArg [out] Name of the log configuration file.
+* \param serverArg [out] Whether to run scenarios on request as a ModelServer.
 * \todo Allow a space between the flags and the file names.
 */
-void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg ) {
+void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFacArg, bool& serverArg ) {
     for( unsigned int i = 1; i < argc; ){
         string temp( argv[ i ] );
         if( temp == "-C" ) {
@@ -239,6 +285,10 @@ void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFac
             logFacArg = temp.substr( 2, temp.length() );
             ++i;
         }
+        else if( temp == "--server" ) {
+            serverArg = true;
+            ++i;
+        }
         else if( temp == "--version" ) {
             cout << "GCAM version " << __ObjECTS_VER__ << " Revision: " << __REVISION_NUMBER__ << endl;
             exit( 0 );
@@ -247,6 +297,15 @@ void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFac
             cout << __REVISION_NUMBER__ << endl;
             exit( 0 );
         }
+        else if( temp == "--binary-log-to-text" ) {
+            if( ( i + 1 ) == argc ) {
+                cout << "Not enough arguments" << endl;
+                printUsageMessage( argc, argv );
+                abort();
+            }
+            // Convert a log written by a BinaryLogger to text and exit.
+            exit( BinaryLogger::convertToText( argv[ i + 1 ], cout ) ? 0 : 1 );
+        }
         else {
             cout << "Invalid argument: " << temp << endl;
             printUsageMessage( argc, argv );
@@ -261,10 +320,12 @@ void parseArgs( unsigned int argc, char* argv[], string& confArg, string& logFac
  * \param argv List of arguments.
  */
 void printUsageMessage( unsigned int argc, char* argv[] ) {
-    cout << "Usage: " << argv[ 0 ] << " [-CconfigurationFileName ][ -LloggerFactoryFileName ]" << endl;
+    cout << "Usage: " << argv[ 0 ] << " [-CconfigurationFileName ][ -LloggerFactoryFileName ][ --server ]" << endl;
     cout << "OR" << endl;
     cout << "Usage: " << argv[ 0 ] << " --version" << endl;
     cout << "OR" << endl;
     cout << "Usage: " << argv[ 0 ] << " --versionID" << endl;
+    cout << "OR" << endl;
+    cout << "Usage: " << argv[ 0 ] << " --binary-log-to-text binaryLogFileName" << endl;
 }
 
@@ -0,0 +1,99 @@
+#ifndef _CACHED_MARKET_VECTOR_H_
+#define _CACHED_MARKET_VECTOR_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file cached_market_vector.h
+ * \ingroup Objects
+ * \brief The CachedMarketVector class header file.
+ */
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "util/base/include/time_vector.h"
+
+class CachedMarket;
+class IInfo;
+class Value;
+
+/*!
+ * \brief A CachedMarket for a single good and region in each model period.
+ * \details Objects which repeatedly access the same market, such as inputs,
+ *          outputs and emissions, locate the market for a period once during
+ *          initCalc and then access it through this class for the rest of the
+ *          period without any MarketLocator lookup.  A CachedMarket is kept for
+ *          every period so that accessing a period other than the current one,
+ *          for instance during reporting, still uses the correct market.  If
+ *          the market has not yet been located for the requested period the
+ *          methods fall back to the equivalent Marketplace method, so the
+ *          behavior is always the same as calling the Marketplace directly.
+ *          The methods mimic the corresponding methods in Marketplace.
+ * \warning It is up to the user to ensure the good and region names passed to
+ *          the methods match those used to locate the markets.
+ * \see CachedMarket
+ */
+class CachedMarketVector
+{
+public:
+    void locateMarket( const std::string& aGoodName, const std::string& aRegionName,
+                       const int aPeriod );
+
+    void addToSupply( const std::string& aGoodName, const std::string& aRegionName, const Value& aValue,
+                      const int aPeriod, bool aMustExist = true );
+
+    void addToDemand( const std::string& aGoodName, const std::string& aRegionName, const Value& aValue,
+                      const int aPeriod, bool aMustExist = true );
+
+    double getPrice( const std::string& aGoodName, const std::string& aRegionName, const int aPeriod,
+                     bool aMustExist = true ) const;
+
+    double getSupply( const std::string& aGoodName, const std::string& aRegionName,
+                      const int aPeriod ) const;
+
+    double getDemand( const std::string& aGoodName, const std::string& aRegionName,
+                      const int aPeriod ) const;
+
+    const IInfo* getMarketInfo( const std::string& aGoodName, const std::string& aRegionName,
+                                const int aPeriod, const bool aMustExist ) const;
+private:
+    //! The located market in each period, null if it has not been located.
+    objects::PeriodVector<boost::shared_ptr<CachedMarket> > mCachedMarkets;
+};
+
+#endif // _CACHED_MARKET_VECTOR_H_
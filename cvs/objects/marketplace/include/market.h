@@ -55,9 +55,6 @@
 #include "util/base/include/value.h"
 #include "util/base/include/data_definition_util.h"
 
-#if GCAM_PARALLEL_ENABLED
-#include "tbb/spin_rw_mutex.h"
-#endif
 
 class IInfo;
 class Tabs;
@@ -135,6 +132,10 @@ public:
     double getForecastPrice() const;
     void setForecastDemand( double aForecastDemand );
     double getForecastDemand() const;
+    void setJacobianStep( double aJacobianStep );
+    double getJacobianStep() const;
+    void setLearnedElasticity( double aElasticity );
+    double getLearnedElasticity() const;
 
     virtual void nullDemand();
     virtual void addToDemand( const double demandIn );
@@ -201,6 +202,14 @@ protected:
 
         //! Forecast demand (used for rescaling in solver)
         DEFINE_VARIABLE( SIMPLE, "forecast-demand", mForecastDemand, double ),
+
+        //! Relative step used for finite difference derivatives with respect
+        //! to this market's price, zero until the solver has chosen one.
+        DEFINE_VARIABLE( SIMPLE, "jacobian-step", mJacobianStep, double ),
+
+        //! Response of log excess demand to log price found by the solver at
+        //! the last solution, zero until one has been found.
+        DEFINE_VARIABLE( SIMPLE, "learned-elasticity", mLearnedElasticity, double ),
         
         //! The market demand.
         DEFINE_VARIABLE( SIMPLE | STATE, "demand", mDemand, Value ),
@@ -212,15 +221,6 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "year", mYear, int )
     )
     
-#if GCAM_PARALLEL_ENABLED
-    typedef tbb::speculative_spin_rw_mutex Mutex;
-    //! A fast lock to protect conccurent adds to demand.
-    mutable Mutex mDemandMutex;
-    
-    //! A fast lock to protect concurrent adds to supply.
-    mutable Mutex mSupplyMutex;
-#endif
-    
     //! Object containing information related to the market.
     std::auto_ptr<IInfo> mMarketInfo;
     
@@ -106,6 +106,8 @@ public:
     double forecastDemand( const int aPeriod );
     double forecastPrice( const int aPeriod );
     double extrapolate( const int aPeriod, getpsd_t aDataFn );
+
+    double extrapolateTrend( const int aPeriod, getpsd_t aDataFn, const int aNumPeriods );
 protected:
     
     DEFINE_DATA(
@@ -46,11 +46,10 @@
 */
 
 #include <string>
-#include <memory>
-#include <boost/shared_ptr.hpp>
-template <class T, class U> class HashMap;
-
-#include <boost/functional/hash/hash.hpp>
+#include <vector>
+namespace objects {
+    class Atom;
+}
 
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/enumerable_thread_specific.h>
@@ -68,14 +67,15 @@ template <class T, class U> class HashMap;
 *          Marketplace gives the MarketLocator the name of a market area, a
 *          region, a good name, and a lookup number to use if the MarketLocator
 *          does not already know the location of the market. The MarketLocator
-*          stores this information in a pair of list. The first list contains
-*          nodes which represent market areas. These nodes each store a list of
-*          sectors and their corresponding sector numbers. This first list is
-*          only used during the market creation process. The second list stored
-*          by the MarketLocator is a list of nodes representing regions, each
-*          containing a list of sectors and their market numbers. This is the
-*          list which is used to determine a market number from a region name
-*          and good name throughout the model run.
+*          stores this information in a pair of tables. The first maps a market
+*          area and good to a market number and is only used during the market
+*          creation process. The second maps a region and good to a market
+*          number and is used to determine a market number from a region name
+*          and good name throughout the model run. Region, market and good
+*          names are interned as Atoms so that the tables are keyed by pairs of
+*          Atom pointers and hashed with the precomputed Atom hash codes. Callers
+*          which already hold the interned names may look up markets without
+*          any string hashing or comparison.
 * \author Josh Lurz
 */
 class MarketLocator
@@ -86,6 +86,7 @@ public:
     int addMarket( const std::string& aMarket, const std::string& aRegion, const std::string& aGoodName,
         const int aUniqueNumber );
     int getMarketNumber( const std::string& aRegion, const std::string& aGoodName ) const;
+    int getMarketNumber( const objects::Atom* aRegion, const objects::Atom* aGoodName ) const;
 
     //! An identifier returned by the various functions if the market does not
     //! exist.
@@ -93,67 +94,50 @@ public:
 private:
     int getMarketNumberInternal( const std::string& aRegion, const std::string& aGoodName ) const;
 
-    /*! \brief A single node in a list of goods which contains the name of the
-    *          good and its market location.
-    */
-    class GoodNode {
+    /*!
+     * \brief An open addressing hash table from a pair of interned names to a
+     *        market number.
+     * \details The entries are stored inline in a single array which is probed
+     *          linearly starting from the combined hash codes of the two Atoms.
+     *          The array is kept at most half full and entries are never
+     *          removed.
+     */
+    class AtomPairTable {
     public:
-        GoodNode( const std::string& aName, int aMarketNumber );
+        AtomPairTable();
+        int find( const objects::Atom* aFirst, const objects::Atom* aSecond ) const;
+        int insert( const objects::Atom* aFirst, const objects::Atom* aSecond, const int aNumber );
+    private:
+        //! A single slot in the table, empty if mFirst is null.
+        struct Entry {
+            const objects::Atom* mFirst;
+            const objects::Atom* mSecond;
+            int mNumber;
+        };
 
-        //! The good name.
-        const std::string mName;
+        size_t findSlot( const objects::Atom* aFirst, const objects::Atom* aSecond ) const;
 
-        //! The market number.
-        const int mNumber;
-    };
+        void grow();
 
-    /*! \brief A single node in a list of Regions or Markets which contains the
-    *          name of the Region or Market and a list of good names and market
-    *          locations. 
-    */
-    class RegionOrMarketNode {
-    public:
-        RegionOrMarketNode( const std::string& aName );
-        ~RegionOrMarketNode();
-        inline const std::string& getName() const;
-        int addGood( const std::string& aGoodName, const int aMarketNumber );
-        int getMarketNumber( const std::string& aGoodName ) const;
-    private:
-        //! The type of the list that contains the goods.
-        typedef HashMap<std::string, boost::shared_ptr<GoodNode> > SectorNodeList;
-
-        //! A list of sectors contained by this market or region.
-        std::auto_ptr<SectorNodeList> mSectorNodeList;
-        
-        //! The region or market area name.
-        const std::string mName;
+        //! The slots of the table, the size of which is always a power of two.
+        std::vector<Entry> mEntries;
+
+        //! The number of slots which are filled.
+        size_t mSize;
     };
 
-    //! The type of the lists of regions or markets.
-    typedef HashMap<std::string, boost::shared_ptr<RegionOrMarketNode> > RegionMarketList;
+    //! The market number of each good in each market area.
+    AtomPairTable mMarketTable;
 
-    //! A pointer to the last region looked up.
+    //! The market number of each good in each region.
+    AtomPairTable mRegionTable;
+
+    //! The interned name of the last region looked up by name.
 #if GCAM_PARALLEL_ENABLED
-    mutable tbb::enumerable_thread_specific<const RegionOrMarketNode*> mLastRegionLookup;
+    mutable tbb::enumerable_thread_specific<const objects::Atom*> mLastRegionLookup;
 #else
-    mutable const RegionOrMarketNode* mLastRegionLookup;
+    mutable const objects::Atom* mLastRegionLookup;
 #endif
-
-    //! A list of market areas each containing a list of sectors contained by
-    //! the market.
-    std::auto_ptr<RegionMarketList> mMarketList;
-
-    //! A list of regions each containing a list of of sectors contained by the
-    //! region.
-    std::auto_ptr<RegionMarketList> mRegionList;
 };
 
-// Inline definitions.
-/*! \brief Get the name of the RegionOrMarketNode.
-* \return The name of the RegionOrMarketNode.
-*/
-const std::string& MarketLocator::RegionOrMarketNode::getName() const {
-    return mName;
-}
-
 #endif // _MARKET_LOCATOR_H_
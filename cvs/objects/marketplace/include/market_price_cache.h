@@ -0,0 +1,168 @@
+#ifndef _MARKET_PRICE_CACHE_H_
+#define _MARKET_PRICE_CACHE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file market_price_cache.h
+* \ingroup Objects
+* \brief MarketPriceCache class header file.
+*/
+
+#include <vector>
+#include <utility>
+#include <boost/core/noncopyable.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/enumerable_thread_specific.h>
+#endif
+
+class Market;
+
+/*!
+ * \ingroup Objects
+ * \brief Records the market prices read during a calculation so that the
+ *        calculation may be skipped when none of them have changed.
+ * \details While a MarketPriceCache::Scope is active on a thread the
+ *          Marketplace and CachedMarket report each market price they return
+ *          to the cache made current by the scope.  The owner then stores the
+ *          result of the calculation with setValue and afterwards isValid
+ *          checks whether any of those prices, or the result itself, have since
+ *          changed.  The prices are compared by value rather than by a version
+ *          of each market since the solver also restores prices directly through
+ *          the state variables, which is also why the result is checked.
+ *          Reading the supply, demand or market info of any market in the scope
+ *          marks the cache as never valid since the result then may depend on
+ *          more than just prices.  When GCAM_PARALLEL_ENABLED each thread keeps
+ *          a separate record as each may be working on a different copy of the
+ *          model state, unless the cache is created to be shared by all threads
+ *          for calculations which are only recorded when every thread uses the
+ *          same "base" state.  The supplies and demands added to markets in the
+ *          scope are recorded as well so that the owner may add them again with
+ *          addRecordedQuantities instead of repeating the calculation.
+ */
+class MarketPriceCache : private boost::noncopyable {
+    struct Record;
+public:
+    /*!
+     * \brief Makes a cache current for the calling thread for the lifetime of
+     *        the scope, recording the prices read into it.
+     */
+    class Scope : private boost::noncopyable {
+    public:
+        Scope( MarketPriceCache& aCache, const int aPeriod );
+        ~Scope();
+    private:
+        //! The record of the cache which was current before this scope.
+        Record* mPrevious;
+    };
+
+    explicit MarketPriceCache( const bool aIsThreadSpecific = true );
+
+    bool isValid( const int aPeriod, const double aValue ) const;
+
+    void setValue( const double aValue );
+
+    void invalidate();
+
+    static void invalidateAll();
+
+    void addRecordedQuantities() const;
+
+    static void recordPrice( const Market* aMarket, const double aPrice );
+
+    static void recordQuantity( Market* aMarket, const double aValue, const bool aIsSupply );
+
+    static void recordNonPriceRead();
+private:
+    //! A supply or demand added to a market.
+    struct Quantity {
+        //! The market the quantity was added to.
+        Market* mMarket;
+
+        //! The amount added.
+        double mValue;
+
+        //! Whether the quantity was added to supply rather than demand.
+        bool mIsSupply;
+    };
+
+    //! The prices read during a single calculation by one thread.
+    struct Record {
+        Record();
+
+        //! The markets and the prices that were read from them.
+        std::vector<std::pair<const Market*, double> > mPrices;
+
+        //! The supplies and demands that were added to markets.
+        std::vector<Quantity> mQuantities;
+
+        //! The period the prices were recorded in, or -1 if there are none.
+        int mPeriod;
+
+        //! The result of the calculation.
+        double mValue;
+
+        //! Whether something other than a price was read while recording.
+        bool mHasNonPriceRead;
+
+        //! The generation of all caches the prices were recorded in.
+        unsigned int mGeneration;
+    };
+
+#if GCAM_PARALLEL_ENABLED
+    //! The record of each thread.
+    mutable tbb::enumerable_thread_specific<Record> mRecords;
+#else
+    //! The record.
+    Record mRecords;
+#endif
+
+    //! The record used by all threads if the cache is not thread specific.
+    Record mSharedRecord;
+
+    //! Whether each thread keeps a separate record.
+    const bool mIsThreadSpecific;
+
+    const Record& getRecord() const;
+    Record& getRecord();
+
+    static Record*& getCurrentRecord();
+
+    static unsigned int& getGeneration();
+};
+
+#endif // _MARKET_PRICE_CACHE_H_
@@ -50,6 +50,10 @@
 #include <memory>
 #include <boost/core/noncopyable.hpp>
 
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
 #include "marketplace/include/imarket_type.h"
 #include "util/base/include/ivisitable.h"
 #include "util/base/include/data_definition_util.h"
@@ -133,6 +137,8 @@ class Marketplace: public IVisitable, private boost::noncopyable
     friend class SolverLibrary;
     friend class MarketDependencyFinder;
     friend class LogEDFun;
+    friend class BisectAll;
+    friend class HashMapBenchmark;
 #if DEBUG_STATE
     friend class ManageStateVariables;
     friend class Value;
@@ -166,6 +172,12 @@ public:
         const int period ) const;
 
     void init_to_last( const int period );
+    std::vector<double> getPrices( const int aPeriod ) const;
+    void setInitialPrices( const std::vector<double>& aPrices, const int aPeriod );
+    bool writePrices( const std::string& aFileName, const int aPeriod ) const;
+    int setPricesFromFile( const std::string& aFileName, const int aPeriod );
+    int freezeMarketsOutsideRegion( const std::string& aRegionName, const std::string& aFileName,
+                                    const int aPeriod );
     void dbOutput() const; 
     void csvOutputFile( std::string marketsToPrint = "" ) const; 
     int resetToPriceMarket( const int aMarketNumber );
@@ -197,6 +209,8 @@ public:
     
     MarketDependencyFinder* getDependencyFinder() const;
 
+    static bool isDerivativeCalc();
+
     // The methods from here down are diagnostics
     std::vector<double> fullstate( int period ) const; //!< Return all supplies and demands in all markets in a single vector
     bool checkstate(int period, const std::vector<double>&, std::ostream *log=0, unsigned tol=0) const;
@@ -224,6 +238,12 @@ protected:
     
     //! Flag indicating whether the next call to world->calc() will be part of a partial derivative calculation 
     static bool mIsDerivativeCalc;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Serializes setting prices and solve flags which regions initialized
+    //! concurrently may do for a market they share.
+    tbb::spin_mutex mSetMutex;
+#endif
 };
 
 #endif
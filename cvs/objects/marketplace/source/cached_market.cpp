@@ -42,6 +42,7 @@
 #include "marketplace/include/cached_market.h"
 
 #include "marketplace/include/market.h"
+#include "marketplace/include/market_price_cache.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/util.h"
 #include "marketplace/include/marketplace.h"
@@ -161,8 +162,10 @@ void CachedMarket::addToSupply( const string& aGoodName, const string& aRegionNa
     }
     
     if ( mCachedMarket ) {
-        mCachedMarket->addToSupply( scenario->getMarketplace()->mIsDerivativeCalc ?
-                                    aValue.getDiff() : aValue.get() );
+        const double quantity = scenario->getMarketplace()->mIsDerivativeCalc ?
+            aValue.getDiff() : aValue.get();
+        mCachedMarket->addToSupply( quantity );
+        MarketPriceCache::recordQuantity( mCachedMarket, quantity, true );
     }
     else if( aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -209,8 +212,10 @@ void CachedMarket::addToDemand( const string& aGoodName, const string& aRegionNa
     }
     
     if ( mCachedMarket ) {
-        mCachedMarket->addToDemand( scenario->getMarketplace()->mIsDerivativeCalc ?
-                                    aValue.getDiff() : aValue.get() );
+        const double quantity = scenario->getMarketplace()->mIsDerivativeCalc ?
+            aValue.getDiff() : aValue.get();
+        mCachedMarket->addToDemand( quantity );
+        MarketPriceCache::recordQuantity( mCachedMarket, quantity, false );
     }
     else if( aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -248,7 +253,9 @@ double CachedMarket::getPrice( const string& aGoodName, const string& aRegionNam
     assert( aPeriod == mPeriod );
     
     if( mCachedMarket ) {
-        return mCachedMarket->getPrice();
+        const double price = mCachedMarket->getPrice();
+        MarketPriceCache::recordPrice( mCachedMarket, price );
+        return price;
     }
     
     if( aMustExist ) {
@@ -287,6 +294,7 @@ double CachedMarket::getSupply( const string& aGoodName, const string& aRegionNa
     assert( aPeriod == mPeriod );
     
     if ( mCachedMarket ) {
+        MarketPriceCache::recordNonPriceRead();
         return mCachedMarket->getSupply();
     }
     
@@ -323,6 +331,7 @@ double CachedMarket::getDemand(  const string& aGoodName, const string& aRegionN
     assert( aPeriod == mPeriod );
     
     if ( mCachedMarket ) {
+        MarketPriceCache::recordNonPriceRead();
         return mCachedMarket->getDemand();
     }
     
@@ -367,6 +376,7 @@ const IInfo* CachedMarket::getMarketInfo( const string& aGoodName, const string&
 
     const IInfo* info = 0;
     if ( mCachedMarket ) {
+        MarketPriceCache::recordNonPriceRead();
         info = mCachedMarket->getMarketInfo();
         /*! \invariant The market is required to return an information object
          *              that is non-null. 
@@ -419,6 +429,7 @@ IInfo* CachedMarket::getMarketInfo( const string& aGoodName, const string& aRegi
     
     IInfo* info = 0;
     if ( mCachedMarket ) {
+        MarketPriceCache::recordNonPriceRead();
         info = mCachedMarket->getMarketInfo();
         /*! \invariant The market is required to return an information object
          *              that is non-null. 
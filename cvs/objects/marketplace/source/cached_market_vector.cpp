@@ -0,0 +1,176 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file cached_market_vector.cpp
+ * \ingroup Objects
+ * \brief CachedMarketVector class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include "marketplace/include/cached_market_vector.h"
+
+#include "marketplace/include/cached_market.h"
+#include "marketplace/include/marketplace.h"
+#include "containers/include/scenario.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+/*!
+ * \brief Locate the market for the given good and region in a period.
+ * \details This should be called during initCalc once all markets have been
+ *          created.  Any previously located market for the period is replaced.
+ * \param aGoodName The good of the market to locate.
+ * \param aRegionName The region of the market to locate.
+ * \param aPeriod The period for which to locate.
+ * \see Marketplace::locateMarket
+ */
+void CachedMarketVector::locateMarket( const string& aGoodName, const string& aRegionName,
+                                       const int aPeriod )
+{
+    mCachedMarkets[ aPeriod ].reset(
+        scenario->getMarketplace()->locateMarket( aGoodName, aRegionName, aPeriod ).release() );
+}
+
+/*!
+ * \brief Add to the supply for this market.
+ * \param aGoodName The good of the market.
+ * \param aRegionName The region adding supply.
+ * \param aValue The supply value to add.
+ * \param aPeriod The period in which to add the supply.
+ * \param aMustExist Whether it is an error for the market not to exist.
+ * \see Marketplace::addToSupply
+ */
+void CachedMarketVector::addToSupply( const string& aGoodName, const string& aRegionName,
+                                      const Value& aValue, const int aPeriod, bool aMustExist )
+{
+    if( mCachedMarkets[ aPeriod ].get() ) {
+        mCachedMarkets[ aPeriod ]->addToSupply( aGoodName, aRegionName, aValue, aPeriod, aMustExist );
+    }
+    else {
+        scenario->getMarketplace()->addToSupply( aGoodName, aRegionName, aValue, aPeriod, aMustExist );
+    }
+}
+
+/*!
+ * \brief Add to the demand for this market.
+ * \param aGoodName The good of the market.
+ * \param aRegionName The region adding demand.
+ * \param aValue The demand value to add.
+ * \param aPeriod The period in which to add the demand.
+ * \param aMustExist Whether it is an error for the market not to exist.
+ * \see Marketplace::addToDemand
+ */
+void CachedMarketVector::addToDemand( const string& aGoodName, const string& aRegionName,
+                                      const Value& aValue, const int aPeriod, bool aMustExist )
+{
+    if( mCachedMarkets[ aPeriod ].get() ) {
+        mCachedMarkets[ aPeriod ]->addToDemand( aGoodName, aRegionName, aValue, aPeriod, aMustExist );
+    }
+    else {
+        scenario->getMarketplace()->addToDemand( aGoodName, aRegionName, aValue, aPeriod, aMustExist );
+    }
+}
+
+/*!
+ * \brief Return the market price.
+ * \param aGoodName The good of the market.
+ * \param aRegionName The region requesting the price.
+ * \param aPeriod The period for which to get the price.
+ * \param aMustExist Whether it is an error for the market not to exist.
+ * \return The market price.
+ * \see Marketplace::getPrice
+ */
+double CachedMarketVector::getPrice( const string& aGoodName, const string& aRegionName,
+                                     const int aPeriod, bool aMustExist ) const
+{
+    if( mCachedMarkets[ aPeriod ].get() ) {
+        return mCachedMarkets[ aPeriod ]->getPrice( aGoodName, aRegionName, aPeriod, aMustExist );
+    }
+    return scenario->getMarketplace()->getPrice( aGoodName, aRegionName, aPeriod, aMustExist );
+}
+
+/*!
+ * \brief Return the market supply.
+ * \param aGoodName The good of the market.
+ * \param aRegionName The region requesting the supply.
+ * \param aPeriod The period for which to get the supply.
+ * \return The market supply.
+ * \see Marketplace::getSupply
+ */
+double CachedMarketVector::getSupply( const string& aGoodName, const string& aRegionName,
+                                      const int aPeriod ) const
+{
+    if( mCachedMarkets[ aPeriod ].get() ) {
+        return mCachedMarkets[ aPeriod ]->getSupply( aGoodName, aRegionName, aPeriod );
+    }
+    return scenario->getMarketplace()->getSupply( aGoodName, aRegionName, aPeriod );
+}
+
+/*!
+ * \brief Return the market demand.
+ * \param aGoodName The good of the market.
+ * \param aRegionName The region requesting the demand.
+ * \param aPeriod The period for which to get the demand.
+ * \return The market demand.
+ * \see Marketplace::getDemand
+ */
+double CachedMarketVector::getDemand( const string& aGoodName, const string& aRegionName,
+                                      const int aPeriod ) const
+{
+    if( mCachedMarkets[ aPeriod ].get() ) {
+        return mCachedMarkets[ aPeriod ]->getDemand( aGoodName, aRegionName, aPeriod );
+    }
+    return scenario->getMarketplace()->getDemand( aGoodName, aRegionName, aPeriod );
+}
+
+/*!
+ * \brief Get the information object for this market.
+ * \param aGoodName The good of the market.
+ * \param aRegionName The region of the market.
+ * \param aPeriod The period for which to get the information object.
+ * \param aMustExist Whether it is an error for the market not to exist.
+ * \return The market information object or null if the market does not exist.
+ * \see Marketplace::getMarketInfo
+ */
+const IInfo* CachedMarketVector::getMarketInfo( const string& aGoodName, const string& aRegionName,
+                                                const int aPeriod, const bool aMustExist ) const
+{
+    if( mCachedMarkets[ aPeriod ].get() ) {
+        return mCachedMarkets[ aPeriod ]->getMarketInfo( aGoodName, aRegionName, aPeriod, aMustExist );
+    }
+    const Marketplace* marketplace = scenario->getMarketplace();
+    return marketplace->getMarketInfo( aGoodName, aRegionName, aPeriod, aMustExist );
+}
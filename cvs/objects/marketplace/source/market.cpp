@@ -83,6 +83,8 @@ mMarketInfo( InfoFactory::constructInfo( 0, aContainer->getName() ) )
     mDemand = 0.0;
     mForecastPrice = 0.0;
     mForecastDemand = 0.0;
+    mJacobianStep = 0.0;
+    mLearnedElasticity = 0.0;
     mOriginal_price = 0.0;
 }
 
@@ -101,6 +103,8 @@ void Market::copy( const Market& aMarket ) {
     mDemand = aMarket.mDemand;
     mForecastPrice = aMarket.mForecastPrice;
     mForecastDemand = aMarket.mForecastDemand;
+    mJacobianStep = aMarket.mJacobianStep;
+    mLearnedElasticity = aMarket.mLearnedElasticity;
     mOriginal_price = aMarket.mOriginal_price;
     mYear = aMarket.mYear;
 }
@@ -292,6 +296,40 @@ double Market::getForecastDemand() const {
     return mForecastDemand;
 }
 
+/*!
+ * \brief Sets the relative step size the solver found to give a usable finite
+ *        difference derivative with respect to this market's price.
+ * \param aJacobianStep The relative step size.
+ */
+void Market::setJacobianStep( double aJacobianStep ) {
+    mJacobianStep = aJacobianStep;
+}
+
+/*!
+ * \brief Get the relative finite difference step size for this market.
+ * \return The step size, or zero if none has been set.
+ */
+double Market::getJacobianStep() const {
+    return mJacobianStep;
+}
+
+/*!
+ * \brief Sets the derivative of the log of demand over supply with respect to
+ *        the log of this market's price found at the solver's last solution.
+ * \param aElasticity The derivative.
+ */
+void Market::setLearnedElasticity( double aElasticity ) {
+    mLearnedElasticity = aElasticity;
+}
+
+/*!
+ * \brief Get the learned elasticity of excess demand for this market.
+ * \return The elasticity, or zero if none has been learned.
+ */
+double Market::getLearnedElasticity() const {
+    return mLearnedElasticity;
+}
+
 /*! \brief Get the market price.
 * \details This method is used to get the price out of a Market.
 * \return The price for the Market.
@@ -326,17 +364,7 @@ void Market::nullDemand() {
 * \sa setRawDemand
 */
 void Market::addToDemand( const double demandIn ) {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock writeLock( mDemandMutex, true );
-        mDemand += demandIn;
-    }
-    else {
-        mDemand += demandIn;
-    }
-#else
-    mDemand += demandIn;
-#endif
+    mDemand.addConcurrent( demandIn );
 }
 
 /*! \brief Get the raw demand.
@@ -347,17 +375,7 @@ void Market::addToDemand( const double demandIn ) {
 * \sa getDemand
 */
 double Market::getRawDemand() const {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mDemandMutex, false );
-        return mDemand;
-    }
-    else {
-        return mDemand;
-    }
-#else
-    return mDemand;
-#endif
+    return mDemand.getConcurrent();
 }
 
 /*! \brief Get the demand used in the solver.
@@ -368,17 +386,7 @@ double Market::getRawDemand() const {
  * \sa getRawDemand
  */
 double Market::getSolverDemand() const {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mDemandMutex, false );
-        return mDemand;
-    }
-    else {
-        return mDemand;
-    }
-#else
-    return mDemand;
-#endif
+    return mDemand.getConcurrent();
 }
 
 /*! \brief Get the demand.
@@ -386,17 +394,7 @@ double Market::getSolverDemand() const {
 * \return Market demand.
 */
 double Market::getDemand() const {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mDemandMutex, false );
-        return mDemand;
-    }
-    else {
-        return mDemand;
-    }
-#else
-    return mDemand;
-#endif
+    return mDemand.getConcurrent();
 }
 
 /*! \brief Null the supply.
@@ -414,17 +412,7 @@ void Market::nullSupply() {
 * \sa getSupply
 */
 double Market::getRawSupply() const {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mSupplyMutex, false );
-        return mSupply;
-    }
-    else {
-        return mSupply;
-    }
-#else
-    return mSupply;
-#endif
+    return mSupply.getConcurrent();
 }
 
 /*! \brief Get the supply value to be used in the solver
@@ -436,17 +424,7 @@ double Market::getRawSupply() const {
 * \sa getRawSupply
 */
 double Market::getSolverSupply() const {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mSupplyMutex, false );
-        return mSupply;
-    }
-    else {
-        return mSupply;
-    }
-#else
-    return mSupply;
-#endif
+    return mSupply.getConcurrent();
 }
 
 /*! \brief Get the supply.
@@ -454,17 +432,7 @@ double Market::getSolverSupply() const {
 * \return Market supply
 */
 double Market::getSupply() const {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock readLock( mSupplyMutex, false );
-        return mSupply;
-    }
-    else {
-        return mSupply;
-    }
-#else
-    return mSupply;
-#endif
+    return mSupply.getConcurrent();
 }
 
 /*! \brief Add to the the Market an amount of supply in a method based on the
@@ -474,17 +442,7 @@ double Market::getSupply() const {
 * \sa setRawSupply
 */
 void Market::addToSupply( const double supplyIn ) {
-#if GCAM_PARALLEL_ENABLED
-    if( !Marketplace::mIsDerivativeCalc ) {
-        Mutex::scoped_lock writeLock( mSupplyMutex, true );
-        mSupply += supplyIn;
-    }
-    else {
-        mSupply += supplyIn;
-    }
-#else
-    mSupply += supplyIn;
-#endif
+    mSupply.addConcurrent( supplyIn );
 }
 
 /*! \brief Return the market name.
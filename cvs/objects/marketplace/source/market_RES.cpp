@@ -84,8 +84,7 @@ void MarketRES::initPrice() {
         }
     }
     // get the minimum price from the market info
-    const string LOWER_BOUND_KEY = "lower-bound-supply-price";
-    mMinPrice = mMarketInfo->getDouble( LOWER_BOUND_KEY, 0.0 );
+    mMinPrice = mMarketInfo->getDouble( InfoKeys::eLowerBoundSupplyPrice, 0.0 );
 }
 
 void MarketRES::setPrice( const double priceIn ) {
@@ -44,6 +44,7 @@
 #include "marketplace/include/market_container.h"
 #include "util/base/include/model_time.h"
 #include "util/base/include/util.h"
+#include "util/base/include/configuration.h"
 #include "containers/include/scenario.h"
 #include "marketplace/include/imarket_type.h"
 #include "marketplace/include/market.h"
@@ -267,18 +268,7 @@ void MarketContainer::resetToPriceMarket( MarketContainer* aDemandMarkets ) {
  */
 void MarketContainer::addRegion( const string& aRegion ) {
     // Convert the string to an atom.
-    const Atom* regionID = AtomRegistry::getInstance()->findAtom( aRegion );
-    
-    // Could be the first request for this name.  Note the atom registry will
-    // manage this memory.
-    if( !regionID ) {
-        regionID = new Atom( aRegion );
-    }
-    
-    /*! \invariant The ID of the found atom is the same as the name of the
-     *              region, this ensures the lookup was correct.
-     */
-    assert( regionID->getID() == aRegion );
+    const Atom* regionID = AtomRegistry::getInstance()->getAtom( aRegion );
     
     // Check if the region ID does not already exist in the list.
     if( find( mContainedRegions.begin(), mContainedRegions.end(), regionID ) == mContainedRegions.end() ) {
@@ -386,6 +376,10 @@ double MarketContainer::forecastDemand( const int aPeriod )
 /*!
  * \brief extrapolate some arbitrary value  using the last three values from the
  *        previous model periods.
+ * \details If the configuration value "price-forecast-periods" is more than
+ *          three a linear trend is instead fit by least squares to the values
+ *          of that many previous periods, which is less sensitive to a single
+ *          period which moved abruptly.
  * \param aPeriod The current model period to extrapolate to.
  * \param aDataFn A function pointer which will be used to look up the actual data
  *                value that we are extrapolating.
@@ -402,6 +396,11 @@ double MarketContainer::extrapolate( const int aPeriod, getpsd_t aDataFn )
      * \pre Period must be greater than zero.
      */
     assert( aPeriod > 0 );
+
+    const static int numTrendPeriods = Configuration::getInstance()->getInt( "price-forecast-periods", 3, false );
+    if( numTrendPeriods > 3 ) {
+        return extrapolateTrend( aPeriod, aDataFn, numTrendPeriods );
+    }
     
     for( int i = 2; i >= 0; --i ) {
         int currPeriod = aPeriod + i - 3;
@@ -436,3 +435,43 @@ double MarketContainer::extrapolate( const int aPeriod, getpsd_t aDataFn )
     double currYear = modeltime->getper_to_yr( aPeriod );
     return y[ 2 ] + m * ( currYear - x[ 2 ] );
 }
+
+/*!
+ * \brief Extrapolate some arbitrary value using a least squares linear trend
+ *        over the values from several previous model periods.
+ * \details Periods before the value first becomes nonzero are skipped, as in
+ *          extrapolate, and the last value is used if fewer than two periods
+ *          remain.
+ * \param aPeriod The current model period to extrapolate to.
+ * \param aDataFn A function pointer which will be used to look up the actual data
+ *                value that we are extrapolating.
+ * \param aNumPeriods The number of previous periods to fit the trend to.
+ * \return The extrapolated data point for aPeriod.
+ */
+double MarketContainer::extrapolateTrend( const int aPeriod, getpsd_t aDataFn, const int aNumPeriods )
+{
+    const Modeltime* modeltime = Modeltime::getInstance();
+    const double lastValue = (mMarkets[ aPeriod - 1 ]->*aDataFn)();
+    double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+    int numPoints = 0;
+    for( int currPeriod = aPeriod - 1; currPeriod >= max( aPeriod - aNumPeriods, 0 ); --currPeriod ) {
+        const double y = (mMarkets[ currPeriod ]->*aDataFn)();
+        if( currPeriod < aPeriod - 1 && y < util::getTinyNumber() ) {
+            break;
+        }
+        // Center the years on the current period to keep the sums small.
+        const double x = modeltime->getper_to_yr( currPeriod ) - modeltime->getper_to_yr( aPeriod );
+        sumX += x;
+        sumY += y;
+        sumXX += x * x;
+        sumXY += x * y;
+        ++numPoints;
+    }
+    const double denominator = numPoints * sumXX - sumX * sumX;
+    if( numPoints < 2 || denominator == 0.0 ) {
+        return lastValue;
+    }
+    // The trend evaluated at the current period is its intercept.
+    const double slope = ( numPoints * sumXY - sumX * sumY ) / denominator;
+    return ( sumY - slope * sumX ) / numPoints;
+}
@@ -42,8 +42,11 @@
 #include <cassert>
 #include <string>
 
+#include <boost/functional/hash/hash.hpp>
+
 #include "marketplace/include/market_locator.h"
-#include "util/base/include/hash_map.h"
+#include "util/base/include/atom.h"
+#include "util/base/include/atom_registry.h"
 
 #define PERFORM_TIMING 0
 #if PERFORM_TIMING
@@ -56,16 +59,14 @@ static int gNumLookups;
 #endif
 
 using namespace std;
+using namespace objects;
 
 
 
 /*! \brief Constructor */
 MarketLocator::MarketLocator()
-:mLastRegionLookup( static_cast<const RegionOrMarketNode*>( 0 ) )
+:mLastRegionLookup( static_cast<const Atom*>( 0 ) )
 {
-    const unsigned int MARKET_REGION_LIST_SIZE = 71;
-    mRegionList.reset( new RegionMarketList( MARKET_REGION_LIST_SIZE ) );
-    mMarketList.reset( new RegionMarketList( MARKET_REGION_LIST_SIZE ) );
 }
 
 //! Destructor
@@ -92,40 +93,17 @@ int MarketLocator::addMarket( const string& aMarket,
                               const string& aGoodName,
                               const int aUniqueNumber )
 {
-    // Check if the market area exists in the market area list.
-    RegionMarketList::iterator iter = mMarketList->find( aMarket );
-    
-    int goodNumber;
-    // The market area does not exist. Create a new entry.
-    if( iter == mMarketList->end() ){
-        boost::shared_ptr<RegionOrMarketNode> newMarketNode( new RegionOrMarketNode( aMarket ) );
-        // Add the node to the hashmap.
-        mMarketList->insert( make_pair( aMarket, newMarketNode ) );
+    // Intern the names so that lookups may be done by Atom.
+    AtomRegistry* registry = AtomRegistry::getInstance();
+    const Atom* market = registry->getAtom( aMarket );
+    const Atom* region = registry->getAtom( aRegion );
+    const Atom* good = registry->getAtom( aGoodName );
 
-        // Add the item to it.
-        goodNumber = newMarketNode->addGood( aGoodName, aUniqueNumber );
-    }
-    else {
-        // The market area already exists. Add the item to it.
-        goodNumber = iter->second->addGood( aGoodName, aUniqueNumber );
-    }
+    // Add the good to the market area, or find the number it already has.
+    const int goodNumber = mMarketTable.insert( market, good, aUniqueNumber );
 
-    // Check if the region exists in the region list.
-    iter = mRegionList->find( aRegion );
-
-    // The region does not exist. Create a new entry.
-    if( iter == mRegionList->end() ){
-        boost::shared_ptr<RegionOrMarketNode> newRegionNode( new RegionOrMarketNode( aRegion ) );
-        // Add the new region to the region list.
-        mRegionList->insert( make_pair( aRegion, newRegionNode ) );
-        
-        // Add the item to the region list.
-        newRegionNode->addGood( aGoodName, goodNumber );
-    }
-    else {
-        // The region already exists. Add the item to it.
-        iter->second->addGood( aGoodName, goodNumber );
-    }
+    // Add the good to the region.
+    mRegionTable.insert( region, good, goodNumber );
 
     // Return the good number used.
     return goodNumber;
@@ -155,10 +133,22 @@ int MarketLocator::getMarketNumber( const string& aRegion, const string& aGoodNa
 #endif
 }
 
+/*! \brief Find the market number for a given interned region and good name.
+* \details This lookup requires no string hashing or comparison and should be
+*          preferred by callers which already hold the interned names.
+* \param aRegion Interned name of the region for which to search.
+* \param aGoodName Interned name of the good for which to search.
+* \return The market number or MARKET_NOT_FOUND if it is not present.
+*/
+int MarketLocator::getMarketNumber( const Atom* aRegion, const Atom* aGoodName ) const {
+    return mRegionTable.find( aRegion, aGoodName );
+}
+
 /*! \brief Internal calculation which determines the market number from a region
 *          and good name.
 * \details Performs the calculation which determines the market number from a
-*          region and good name.
+*          region and good name. The names are converted to their interned
+*          Atoms, if either name was never interned the market cannot exist.
 * \param aRegion Region for which to search.
 * \param aGoodName Good for which to search.
 * \return The number of the associated market or MARKET_NOT_FOUND if it does not
@@ -167,103 +157,103 @@ int MarketLocator::getMarketNumber( const string& aRegion, const string& aGoodNa
 int MarketLocator::getMarketNumberInternal( const string& aRegion,
                                             const string& aGoodName ) const
 {
-    // First check if the cached market number matched the region.
-    const RegionOrMarketNode* region;
-#if GCAM_PARALLEL_ENABLED
-    const RegionOrMarketNode*& localCache = mLastRegionLookup.local();
-    if( localCache && localCache->getName() == aRegion ){
-        region = localCache;
-    }
-#else
-    if( mLastRegionLookup && mLastRegionLookup->getName() == aRegion ) {
-        region = mLastRegionLookup;
-    }
-#endif
-    else {
-        RegionMarketList::const_iterator iter = mRegionList->find( aRegion );
-        // Check if the region was found.
-        if( iter != mRegionList->end() ){
-            /*! \invariant If the key is in the list the node must be non-null. */
-            assert( iter->second.get() );
-            region = iter->second.get();
+    const AtomRegistry* registry = AtomRegistry::getInstance();
+
+    // First check if the cached region matches the region name to avoid
+    // searching for the region Atom.
 #if GCAM_PARALLEL_ENABLED
-            localCache = region;
+    const Atom*& region = mLastRegionLookup.local();
 #else
-            mLastRegionLookup = region;
+    const Atom*& region = mLastRegionLookup;
 #endif
+    if( !region || region->getID() != aRegion ) {
+        const Atom* regionID = registry->findAtom( aRegion );
+        // If the region was never interned the market cannot exist.
+        if( !regionID ) {
+            return MARKET_NOT_FOUND;
         }
-        // Search failed.
-        else {
-            region = 0;
-        }
+        region = regionID;
     }
 
-    // If the region lookup succeeded search for the good, otherwise return
-    // market not found.
-    return region ? region->getMarketNumber( aGoodName ) : MARKET_NOT_FOUND;
+    const Atom* goodID = registry->findAtom( aGoodName );
+    return goodID ? mRegionTable.find( region, goodID ) : MARKET_NOT_FOUND;
 }
 
 //! Constructor
-MarketLocator::RegionOrMarketNode::RegionOrMarketNode( const string& aName ):
-mName( aName ){
-    const unsigned int SECTOR_LIST_SIZE = 51;
-    mSectorNodeList.reset( new SectorNodeList( SECTOR_LIST_SIZE ) );
+MarketLocator::AtomPairTable::AtomPairTable():
+mEntries( 1024 ),
+mSize( 0 )
+{
+    for( auto& entry : mEntries ) {
+        entry.mFirst = 0;
+    }
 }
 
-//! Destructor
-MarketLocator::RegionOrMarketNode::~RegionOrMarketNode(){
+/*! \brief Find the number stored for a pair of names.
+* \param aFirst The interned region or market area name.
+* \param aSecond The interned good name.
+* \return The stored number, MARKET_NOT_FOUND if the pair is not in the table.
+*/
+int MarketLocator::AtomPairTable::find( const Atom* aFirst, const Atom* aSecond ) const {
+    const Entry& entry = mEntries[ findSlot( aFirst, aSecond ) ];
+    return entry.mFirst ? entry.mNumber : MARKET_NOT_FOUND;
 }
 
-/*! \brief Add a Good to the RegionOrMarketNode.
-* \param aGoodName Name of the Good to add.
-* \param aUniqueNumber A unique market location to use if the good is added to
-*        the list.
-* \return aUniqueNumber if the good was added to the list, the market number if
-*         it already existed.
+/*! \brief Add a pair of names to the table.
+* \param aFirst The interned region or market area name.
+* \param aSecond The interned good name.
+* \param aNumber The number to store if the pair is not already in the table.
+* \return aNumber if the pair was added to the table, the stored number if it
+*         already existed.
 */
-int MarketLocator::RegionOrMarketNode::addGood( const string& aGoodName,
-                                                const int aUniqueNumber )
-{
-    // Check if it exists in the good list.
-    SectorNodeList::iterator iter = mSectorNodeList->find( aGoodName );
+int MarketLocator::AtomPairTable::insert( const Atom* aFirst, const Atom* aSecond, const int aNumber ) {
+    /*! \pre The names are not null. */
+    assert( aFirst && aSecond );
 
-    // Check if the good was found.
-    if( iter != mSectorNodeList->end() ){
-        /*! \invariant If the key is in the list the node must be non-null. */
-        assert( iter->second.get() );
-
-        // Return the good number.
-        return iter->second->mNumber;
+    Entry* entry = &mEntries[ findSlot( aFirst, aSecond ) ];
+    if( entry->mFirst ) {
+        return entry->mNumber;
     }
-
-    // The good node does not exist. Create a new one.
-    boost::shared_ptr<GoodNode> newGoodNode( new GoodNode( aGoodName, aUniqueNumber ) );
-
-    // Add the new node to the hashmap.
-    mSectorNodeList->insert( make_pair( aGoodName, newGoodNode ) );
-
-    // Return the new index.
-    return aUniqueNumber;
+    // Keep the table at most half full so that probe sequences stay short.
+    if( 2 * ( mSize + 1 ) > mEntries.size() ) {
+        grow();
+        entry = &mEntries[ findSlot( aFirst, aSecond ) ];
+    }
+    entry->mFirst = aFirst;
+    entry->mSecond = aSecond;
+    entry->mNumber = aNumber;
+    ++mSize;
+    return aNumber;
 }
 
-/*! \brief Find a market number given a Good name.
-* \param aGoodName The name of the Good to search for.
-* \return The market number for the Good, MARKET_NOT_FOUND otherwise.
+/*! \brief Find the slot which holds a pair of names or the empty slot where it
+*          would be added.
+* \param aFirst The interned region or market area name.
+* \param aSecond The interned good name.
+* \return The index of the slot.
 */
-int MarketLocator::RegionOrMarketNode::getMarketNumber( const string& aGoodName ) const {
-    // Check if it exists in the good list.
-    SectorNodeList::const_iterator iter = mSectorNodeList->find( aGoodName );
-    if( iter != mSectorNodeList->end() ){
-        return iter->second->mNumber;
+size_t MarketLocator::AtomPairTable::findSlot( const Atom* aFirst, const Atom* aSecond ) const {
+    size_t hash = aFirst->getHashCode();
+    boost::hash_combine( hash, aSecond->getHashCode() );
+    const size_t mask = mEntries.size() - 1;
+    for( size_t slot = hash & mask; ; slot = ( slot + 1 ) & mask ) {
+        const Entry& entry = mEntries[ slot ];
+        if( !entry.mFirst || ( entry.mFirst == aFirst && entry.mSecond == aSecond ) ) {
+            return slot;
+        }
     }
-
-    // Return that the market was not found.
-    return MARKET_NOT_FOUND;
 }
 
-//! Constructor
-MarketLocator::GoodNode::GoodNode( const string& aName, const int aMarketNumber ):
-mName( aName ),
-mNumber( aMarketNumber )
-{
+//! Double the number of slots and re-insert the filled ones.
+void MarketLocator::AtomPairTable::grow() {
+    vector<Entry> oldEntries( 2 * mEntries.size() );
+    oldEntries.swap( mEntries );
+    for( auto& entry : mEntries ) {
+        entry.mFirst = 0;
+    }
+    for( const auto& entry : oldEntries ) {
+        if( entry.mFirst ) {
+            mEntries[ findSlot( entry.mFirst, entry.mSecond ) ] = entry;
+        }
+    }
 }
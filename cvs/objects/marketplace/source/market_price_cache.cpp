@@ -0,0 +1,252 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file market_price_cache.cpp
+* \ingroup Objects
+* \brief MarketPriceCache class source file.
+*/
+
+#include "util/base/include/definitions.h"
+
+#include "marketplace/include/market_price_cache.h"
+#include "marketplace/include/market.h"
+
+using namespace std;
+
+/*!
+ * \brief Constructor which clears the record of aCache for the calling thread
+ *        and makes it current.
+ * \param aCache The cache to record the prices in.
+ * \param aPeriod The period being calculated.
+ */
+MarketPriceCache::Scope::Scope( MarketPriceCache& aCache, const int aPeriod ):
+mPrevious( getCurrentRecord() )
+{
+    Record& record = aCache.getRecord();
+    record.mPrices.clear();
+    record.mQuantities.clear();
+    record.mPeriod = aPeriod;
+    record.mHasNonPriceRead = false;
+    record.mGeneration = getGeneration();
+    getCurrentRecord() = &record;
+}
+
+//! Destructor which restores the previously current record.
+MarketPriceCache::Scope::~Scope() {
+    getCurrentRecord() = mPrevious;
+}
+
+//! Constructor for an empty record.
+MarketPriceCache::Record::Record():
+mPeriod( -1 ),
+mValue( 0 ),
+mHasNonPriceRead( false ),
+mGeneration( 0 )
+{
+}
+
+/*!
+ * \brief Constructor for a cache with nothing recorded which is not valid.
+ * \param aIsThreadSpecific Whether each thread keeps a separate record.  A
+ *        single shared record may only be used for calculations which are not
+ *        made concurrently on different copies of the model state.
+ */
+MarketPriceCache::MarketPriceCache( const bool aIsThreadSpecific ):
+mIsThreadSpecific( aIsThreadSpecific )
+{
+}
+
+/*!
+ * \brief Get the record of the calling thread.
+ * \return The record.
+ */
+const MarketPriceCache::Record& MarketPriceCache::getRecord() const {
+    if( !mIsThreadSpecific ) {
+        return mSharedRecord;
+    }
+#if GCAM_PARALLEL_ENABLED
+    return mRecords.local();
+#else
+    return mRecords;
+#endif
+}
+
+/*!
+ * \brief Get the record of the calling thread.
+ * \return The record.
+ */
+MarketPriceCache::Record& MarketPriceCache::getRecord() {
+    if( !mIsThreadSpecific ) {
+        return mSharedRecord;
+    }
+#if GCAM_PARALLEL_ENABLED
+    return mRecords.local();
+#else
+    return mRecords;
+#endif
+}
+
+/*!
+ * \brief Get the record market prices read by the calling thread are added to.
+ * \return A reference to the current record, null if there is none.
+ */
+MarketPriceCache::Record*& MarketPriceCache::getCurrentRecord() {
+    static thread_local Record* sCurrentRecord = 0;
+    return sCurrentRecord;
+}
+
+/*!
+ * \brief Get the generation of all caches which is advanced by invalidateAll.
+ * \return A reference to the current generation.
+ */
+unsigned int& MarketPriceCache::getGeneration() {
+    static unsigned int sGeneration = 0;
+    return sGeneration;
+}
+
+/*!
+ * \brief Check if the prices and result recorded are all unchanged.
+ * \param aPeriod The period being calculated.
+ * \param aValue The current value of the result of the calculation.
+ * \return Whether the prices were recorded in the given period, the result is
+ *         unchanged and none of the markets now have a different price.
+ */
+bool MarketPriceCache::isValid( const int aPeriod, const double aValue ) const {
+    const Record& record = getRecord();
+    if( aPeriod != record.mPeriod || record.mHasNonPriceRead || aValue != record.mValue ||
+        record.mGeneration != getGeneration() )
+    {
+        return false;
+    }
+    for( vector<pair<const Market*, double> >::const_iterator it = record.mPrices.begin();
+         it != record.mPrices.end(); ++it )
+    {
+        if( (*it).first->getPrice() != (*it).second ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Set the result of the calculation for which the prices were recorded.
+ * \param aValue The result.
+ */
+void MarketPriceCache::setValue( const double aValue ) {
+    getRecord().mValue = aValue;
+}
+
+/*!
+ * \brief Invalidate the cache for all threads, for instance when something other
+ *        than the market prices the calculation depends on has been changed.
+ */
+void MarketPriceCache::invalidate() {
+    mSharedRecord.mPeriod = -1;
+#if GCAM_PARALLEL_ENABLED
+    for( tbb::enumerable_thread_specific<Record>::iterator it = mRecords.begin(); it != mRecords.end(); ++it ) {
+        (*it).mPeriod = -1;
+    }
+#else
+    mRecords.mPeriod = -1;
+#endif
+}
+
+/*!
+ * \brief Invalidate every cache for all threads.
+ * \details This is needed when the model state is restored wholesale, such as
+ *          by rolling back the undo log, since the recorded supplies and
+ *          demands and any other state the calculations changed would then not
+ *          match what the restored prices alone suggest.  Must not be called
+ *          while any thread is calculating in a scope.
+ */
+void MarketPriceCache::invalidateAll() {
+    ++getGeneration();
+}
+
+/*!
+ * \brief Add the supplies and demands recorded to the markets again.
+ * \pre isValid is true so that repeating the calculation would have added
+ *      the same quantities.
+ */
+void MarketPriceCache::addRecordedQuantities() const {
+    const Record& record = getRecord();
+    for( vector<Quantity>::const_iterator it = record.mQuantities.begin();
+         it != record.mQuantities.end(); ++it )
+    {
+        if( (*it).mIsSupply ) {
+            (*it).mMarket->addToSupply( (*it).mValue );
+        }
+        else {
+            (*it).mMarket->addToDemand( (*it).mValue );
+        }
+    }
+}
+
+/*!
+ * \brief Record a price read from a market in the cache current for the calling
+ *        thread, if any.
+ * \param aMarket The market.
+ * \param aPrice The price which was read.
+ */
+void MarketPriceCache::recordPrice( const Market* aMarket, const double aPrice ) {
+    Record* record = getCurrentRecord();
+    if( record ) {
+        record->mPrices.push_back( make_pair( aMarket, aPrice ) );
+    }
+}
+
+/*!
+ * \brief Record that market data other than a price was read so that the cache
+ *        current for the calling thread, if any, will not be valid.
+ */
+void MarketPriceCache::recordNonPriceRead() {
+    Record* record = getCurrentRecord();
+    if( record ) {
+        record->mHasNonPriceRead = true;
+    }
+}
+
+/*!
+ * \brief Record a supply or demand added to a market in the cache current for
+ *        the calling thread, if any.
+ * \param aMarket The market.
+ * \param aValue The amount which was added.
+ * \param aIsSupply Whether the amount was added to supply rather than demand.
+ */
+void MarketPriceCache::recordQuantity( Market* aMarket, const double aValue, const bool aIsSupply ) {
+    Record* record = getCurrentRecord();
+    if( record ) {
+        const Quantity quantity = { aMarket, aValue, aIsSupply };
+        record->mQuantities.push_back( quantity );
+    }
+}
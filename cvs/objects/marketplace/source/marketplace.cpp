@@ -42,9 +42,14 @@
 
 #include <vector>
 #include <iomanip>
+#include <fstream>
+#include <map>
+#include <limits>
+#include <cstdio>
 
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/parallel_for.h>
+#include <tbb/spin_mutex.h>
 #endif
 
 #include "marketplace/include/marketplace.h"
@@ -61,10 +66,13 @@
 #include "util/base/include/ivisitor.h"
 #include "containers/include/iinfo.h"
 #include "marketplace/include/cached_market.h"
+#include "marketplace/include/market_price_cache.h"
 #include "containers/include/market_dependency_finder.h"
 #include "solution/util/include/ublas-helpers.hpp"
+#include "util/base/include/atom.h"
 
 using namespace std;
+using namespace objects;
 
 extern Scenario* scenario;
 const double Marketplace::NO_MARKET_PRICE = util::getLargeNumber();
@@ -126,13 +134,10 @@ void Marketplace::toDebugXML( const int period, ostream& out, Tabs* tabs ) const
     XMLWriteElement( static_cast<int>( mMarkets.size() ), "numberOfMarkets", out, tabs );
 
     // Write out the individual markets
-    const static string debugRegion =
-        Configuration::getInstance()->getString( "debug-region", "USA" );
-
     for( unsigned int i = 0; i < mMarkets.size(); i++ ){
         // TODO: This isn't quite right. This should search the contained
         // region list.
-        if( mMarkets[ i ]->getMarket( period )->getRegionName() == debugRegion ||
+        if( util::isDebugRegion( mMarkets[ i ]->getMarket( period )->getRegionName() ) ||
             mMarkets[ i ]->getMarket( period )->getRegionName() == "global" )
         {
             mMarkets[ i ]->getMarket( period )->toDebugXML( period, out, tabs );
@@ -335,6 +340,9 @@ void Marketplace::setPriceVector( const string& goodName, const string& regionNa
             << goodName << " " << regionName << endl;
     }
     else {
+#if GCAM_PARALLEL_ENABLED
+        tbb::spin_mutex::scoped_lock lock( mSetMutex );
+#endif
         for( unsigned int i = 0; i < mMarkets[ marketNumber ]->size() && i < prices.size(); i++ ){
             mMarkets[ marketNumber ]->getMarket( i )->setPrice( prices[ i ] );
         }
@@ -378,6 +386,9 @@ void Marketplace::setMarketToSolve ( const string& goodName, const string& regio
 
     // If the market exists.
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+#if GCAM_PARALLEL_ENABLED
+        tbb::spin_mutex::scoped_lock lock( mSetMutex );
+#endif
         mMarkets[ marketNumber ]->getMarket( per )->setSolveMarket( true );
     }
     else {
@@ -406,6 +417,9 @@ void Marketplace::unsetMarketToSolve ( const string& goodName, const string& reg
 
     // If the market exists.
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+#if GCAM_PARALLEL_ENABLED
+        tbb::spin_mutex::scoped_lock lock( mSetMutex );
+#endif
         mMarkets[ marketNumber ]->getMarket( per )->setSolveMarket( false );
         mMarkets[ marketNumber ]->getMarket( per )->nullSupply();
         mMarkets[ marketNumber ]->getMarket( per )->nullDemand();
@@ -502,6 +516,9 @@ void Marketplace::setPrice( const string& goodName, const string& regionName, co
 
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+#if GCAM_PARALLEL_ENABLED
+        tbb::spin_mutex::scoped_lock lock( mSetMutex );
+#endif
         mMarkets[ marketNumber ]->getMarket( per )->setPrice( value );
     }
     else if( aMustExist ){
@@ -540,7 +557,10 @@ void Marketplace::addToSupply( const string& goodName, const string& regionName,
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
 
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
-        mMarkets[ marketNumber ]->getMarket( per )->addToSupply( mIsDerivativeCalc ? value.getDiff() : value.get() );
+        Market* market = mMarkets[ marketNumber ]->getMarket( per );
+        const double quantity = mIsDerivativeCalc ? value.getDiff() : value.get();
+        market->addToSupply( quantity );
+        MarketPriceCache::recordQuantity( market, quantity, true );
     }
     else if( aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -577,7 +597,10 @@ void Marketplace::addToDemand( const string& goodName, const string& regionName,
 
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
-        mMarkets[ marketNumber ]->getMarket( per )->addToDemand( mIsDerivativeCalc ? value.getDiff() : value.get() );
+        Market* market = mMarkets[ marketNumber ]->getMarket( per );
+        const double quantity = mIsDerivativeCalc ? value.getDiff() : value.get();
+        market->addToDemand( quantity );
+        MarketPriceCache::recordQuantity( market, quantity, false );
     }
     else if( aMustExist ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -605,7 +628,10 @@ double Marketplace::getPrice( const string& goodName, const string& regionName,
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
     
     if( marketNumber != MarketLocator::MARKET_NOT_FOUND ){
-        return mMarkets[ marketNumber ]->getMarket( per )->getPrice();
+        const Market* market = mMarkets[ marketNumber ]->getMarket( per );
+        const double price = market->getPrice();
+        MarketPriceCache::recordPrice( market, price );
+        return price;
     }
 
     if( aMustExist ) {
@@ -632,6 +658,7 @@ double Marketplace::getSupply( const string& goodName, const string& regionName,
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
 
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+        MarketPriceCache::recordNonPriceRead();
         return mMarkets[ marketNumber ]->getMarket( per )->getSupply();
     }
 
@@ -656,6 +683,7 @@ double Marketplace::getDemand(  const string& goodName, const string& regionName
     const int marketNumber = mMarketLocator->getMarketNumber( regionName, goodName );
 
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+        MarketPriceCache::recordNonPriceRead();
         return mMarkets[ marketNumber ]->getMarket( per )->getDemand();
     }
 
@@ -726,6 +754,200 @@ void Marketplace::init_to_last( const int period ) {
             mMarkets[ i ]->forecastDemand( period );
         }
     }
+
+    // Start from the finite difference step sizes and elasticities the solver
+    // settled on in the previous period.
+    if( period > 0 ) {
+        for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+            Market* currMarket = mMarkets[ i ]->getMarket( period );
+            const Market* prevMarket = mMarkets[ i ]->getMarket( period - 1 );
+            if( currMarket->getJacobianStep() == 0.0 ) {
+                currMarket->setJacobianStep( prevMarket->getJacobianStep() );
+            }
+            if( currMarket->getLearnedElasticity() == 0.0 ) {
+                currMarket->setLearnedElasticity( prevMarket->getLearnedElasticity() );
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Get the price of every market in a period.
+ * \details These are the raw prices as seen by the solver.
+ * \param aPeriod The model period.
+ * \return The prices in the order of the markets in the marketplace.
+ */
+vector<double> Marketplace::getPrices( const int aPeriod ) const {
+    vector<double> prices( mMarkets.size() );
+    for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+        prices[ i ] = mMarkets[ i ]->getMarket( aPeriod )->getRawPrice();
+    }
+    return prices;
+}
+
+/*!
+ * \brief Set the prices the solver will start from in a period.
+ * \details Only the prices of markets which will be solved are set, the prices
+ *          of all other markets such as fixed taxes are left unchanged. This
+ *          must be called after init_to_last which would otherwise replace
+ *          them.
+ * \param aPrices The prices in the order returned by getPrices. They are
+ *        ignored if the number of markets has changed since.
+ * \param aPeriod The model period.
+ */
+void Marketplace::setInitialPrices( const vector<double>& aPrices, const int aPeriod ) {
+    if( aPrices.size() != mMarkets.size() ) {
+        return;
+    }
+    for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+        Market* currMarket = mMarkets[ i ]->getMarket( aPeriod );
+        if( currMarket->isSolvable() ) {
+            currMarket->setRawPrice( aPrices[ i ] );
+        }
+    }
+}
+
+/*!
+ * \brief Write the price of every market in a period along with its name.
+ * \details The file is written to a temporary file which is then renamed so
+ *          that another scenario never reads a partially written one.
+ * \param aFileName The file to write.
+ * \param aPeriod The model period.
+ * \return Whether the file was written.
+ */
+bool Marketplace::writePrices( const string& aFileName, const int aPeriod ) const {
+    const string tempFileName = aFileName + "." + scenario->getName() + ".tmp";
+    bool success;
+    {
+        ofstream out( tempFileName.c_str() );
+        out.precision( numeric_limits<double>::digits10 + 2 );
+        for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+            out << mMarkets[ i ]->getName() << '\t' << mMarkets[ i ]->getMarket( aPeriod )->getRawPrice() << '\n';
+        }
+        out.close();
+        success = !out.fail();
+    }
+    if( success ) {
+        // Renaming onto an existing file fails on Windows.
+        remove( aFileName.c_str() );
+        success = rename( tempFileName.c_str(), aFileName.c_str() ) == 0;
+    }
+    if( !success ) {
+        remove( tempFileName.c_str() );
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write the prices to " << aFileName << "." << endl;
+    }
+    return success;
+}
+
+/*!
+ * \brief Start the markets of a period from prices written by writePrices.
+ * \details The prices are matched by market name so they may have been written
+ *          by a different scenario, such as another scenario of the same
+ *          batch. Only the prices of markets which will be solved are set and
+ *          they are also recorded as the forecast price so that
+ *          logForecastEvaluation measures them. This must be called after
+ *          init_to_last which would otherwise replace them.
+ * \param aFileName The file to read.
+ * \param aPeriod The model period.
+ * \return The number of markets which were set.
+ */
+int Marketplace::setPricesFromFile( const string& aFileName, const int aPeriod ) {
+    ifstream in( aFileName.c_str() );
+    map<string, double> prices;
+    string name;
+    double price;
+    while( getline( in, name, '\t' ) && in >> price ) {
+        prices[ name ] = price;
+        in.ignore( numeric_limits<streamsize>::max(), '\n' );
+    }
+
+    int numSet = 0;
+    for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+        Market* currMarket = mMarkets[ i ]->getMarket( aPeriod );
+        map<string, double>::const_iterator currPrice = prices.find( mMarkets[ i ]->getName() );
+        if( currMarket->isSolvable() && currPrice != prices.end() && util::isValidNumber( currPrice->second ) ) {
+            currMarket->setRawPrice( currPrice->second );
+            currMarket->setForecastPrice( currPrice->second );
+            ++numSet;
+        }
+    }
+    return numSet;
+}
+
+/*!
+ * \brief Fix the markets of a period which do not contain the given region at
+ *        the prices written by writePrices in a reference run.
+ * \details Every solvable market which does not contain aRegionName is set to
+ *          its price in the file and is no longer solved in the period, so only
+ *          the markets of that region and any multi-region markets which include
+ *          it are left to the solver.  Since the other regions are calculated at
+ *          the prices they solved at in the reference run their supplies and
+ *          demands are also those of the reference run, except as they are
+ *          affected by the solved markets.  Markets which have no price in the
+ *          file continue to be solved.  This must be called after init_to_last
+ *          and World::initCalc which could otherwise reset the prices or the
+ *          solve flags.
+ * \param aRegionName The region whose markets should be solved.
+ * \param aFileName The file of reference prices to read.
+ * \param aPeriod The model period.
+ * \return The number of markets which were frozen.
+ */
+int Marketplace::freezeMarketsOutsideRegion( const string& aRegionName, const string& aFileName,
+                                             const int aPeriod )
+{
+    ifstream in( aFileName.c_str() );
+    if( !in ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open the reference prices " << aFileName << ", all regions will be solved." << endl;
+        return 0;
+    }
+    map<string, double> prices;
+    string name;
+    double price;
+    while( getline( in, name, '\t' ) && in >> price ) {
+        prices[ name ] = price;
+        in.ignore( numeric_limits<streamsize>::max(), '\n' );
+    }
+
+    int numFrozen = 0;
+    int numMissing = 0;
+    for( unsigned int i = 0; i < mMarkets.size(); ++i ) {
+        Market* currMarket = mMarkets[ i ]->getMarket( aPeriod );
+        if( !currMarket->isSolvable() ) {
+            continue;
+        }
+        const vector<const Atom*>& containedRegions = currMarket->getContainedRegions();
+        bool containsRegion = false;
+        for( vector<const Atom*>::const_iterator regionIter = containedRegions.begin();
+             regionIter != containedRegions.end() && !containsRegion; ++regionIter )
+        {
+            containsRegion = (*regionIter)->getID() == aRegionName;
+        }
+        if( containsRegion ) {
+            continue;
+        }
+        map<string, double>::const_iterator currPrice = prices.find( mMarkets[ i ]->getName() );
+        if( currPrice != prices.end() && util::isValidNumber( currPrice->second ) ) {
+            currMarket->setRawPrice( currPrice->second );
+            currMarket->setForecastPrice( currPrice->second );
+            currMarket->setSolveMarket( false );
+            ++numFrozen;
+        }
+        else {
+            ++numMissing;
+        }
+    }
+
+    if( numMissing > 0 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << numMissing << " markets outside of " << aRegionName << " have no price in "
+                << aFileName << " and will be solved." << endl;
+    }
+    return numFrozen;
 }
 
 /*! \brief Store market prices for policy cost caluclation.
@@ -782,6 +1004,7 @@ const IInfo* Marketplace::getMarketInfo( const string& aGoodName, const string&
     const int marketNumber = mMarketLocator->getMarketNumber( aRegionName, aGoodName );
     const IInfo* info = 0;
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+        MarketPriceCache::recordNonPriceRead();
         info = mMarkets[ marketNumber ]->getMarket( aPeriod )->getMarketInfo();
         /*! \invariant The market is required to return an information object
         *              that is non-null. 
@@ -825,6 +1048,7 @@ IInfo* Marketplace::getMarketInfo( const string& aGoodName, const string& aRegio
     const int marketNumber = mMarketLocator->getMarketNumber( aRegionName, aGoodName );
     IInfo* info = 0;
     if ( marketNumber != MarketLocator::MARKET_NOT_FOUND ) {
+        MarketPriceCache::recordNonPriceRead();
         info = mMarkets[ marketNumber ]->getMarket( aPeriod )->getMarketInfo();
         /*! \invariant The market is required to return an information object
         *              that is non-null. 
@@ -919,8 +1143,8 @@ void Marketplace::csvOutputFile( string marketsToPrint ) const {
     // function protocol
     void fileoutput2(string var1name,string var2name,string var3name,
         string var4name,string var5name,vector<double> dout,string uname);
-    void fileoutput3(string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3(const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     const int maxPeriod = modeltime->getmaxper();
     vector<double> temp( maxPeriod );
@@ -1004,6 +1228,17 @@ MarketDependencyFinder* Marketplace::getDependencyFinder() const {
     return mDependencyFinder.get();
 }
 
+/*!
+ * \brief Whether the current calculation is part of a partial derivative
+ *        calculation.
+ * \details During partial derivative calculations only the differences from
+ *          the "base" state are added to the markets.
+ * \return Whether a partial derivative is being calculated.
+ */
+bool Marketplace::isDerivativeCalc() {
+    return mIsDerivativeCalc;
+}
+
 /*!
  * \brief Get the full state of the marketplace.
  * \param period The model period.
@@ -1013,6 +1248,7 @@ MarketDependencyFinder* Marketplace::getDependencyFinder() const {
 std::vector<double> Marketplace::fullstate( int period ) const
 {
   std::vector<double> state;
+  state.reserve( 3 * mMarkets.size() );
   for(unsigned i=0; i<mMarkets.size(); ++i) {
     state.push_back(mMarkets[i]->getMarket( period )->getRawPrice());
     state.push_back(mMarkets[i]->getMarket( period )->getRawDemand());
@@ -38,16 +38,25 @@
 /* standard headers */
 #include <list>
 #include <set>
+#include <map>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <boost/core/noncopyable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 /* graph analysis headers */
 #include "parallel/include/digraph.hpp"
+#include "util/base/include/activity_profiler.h"
 
 /* TBB headers */
 #include <tbb/flow_graph.h>
+#include <tbb/spin_mutex.h>
 
 // Forward declare when possible
 class IActivity;
 class MarketDependencyFinder;
+struct FlowGraphTraceRun;
 
 /*!
  * \brief Class to package all of the information we need to carry around to use the flow graph
@@ -57,9 +66,13 @@ class GcamFlowGraph {
     friend class GcamParallel;
     friend class World;
     friend class MarketDependencyFinder;
+    friend class FlowGraphTracer;
+public:
+    //! Get an estimate of the bytes retained by the nodes and edges of the graph.
+    size_t getMemoryEstimate() const { return mMemoryEstimate; }
 private:
     //! Private constructor to only allow select classes to create flow graphs.
-    GcamFlowGraph() : mTBBFlowGraph(), mHead( mTBBFlowGraph ), mPeriod( 0 ), mCalcList( 0 ) {}
+    GcamFlowGraph() : mTBBFlowGraph(), mHead( mTBBFlowGraph ), mPeriod( 0 ), mCalcList( 0 ), mTraceRun( 0 ), mMemoryEstimate( 0 ) {}
     
     //! The TBB calculation flow graph.
     tbb::flow::graph mTBBFlowGraph;
@@ -75,6 +88,155 @@ private:
     //! not be calculated for sub-graphs.  Note when null it implies all activities
     //! will be calculated.
     const std::vector<IActivity*>* mCalcList;
+
+    //! The grains which must finish before each grain may start, indexed by
+    //! grain id.  This is only filled in when the FlowGraphTracer is enabled.
+    std::vector<std::vector<int> > mGrainPredecessors;
+
+    //! The trace of the current execution of this graph, null if not tracing.
+    FlowGraphTraceRun* mTraceRun;
+
+    //! An estimate of the bytes retained by the nodes and edges, set when the
+    //! graph is made.
+    size_t mMemoryEstimate;
+};
+
+/*!
+ * \brief The grains executed during a single run of a flow graph.
+ */
+struct FlowGraphTraceRun {
+    //! The execution of a single grain.
+    struct GrainEvent {
+        //! The grain id in the flow graph.
+        int mGrain;
+        //! The number of activities in the grain.
+        int mSize;
+        //! The index of the thread which ran the grain.
+        int mThread;
+        //! Start and end in microseconds since the tracer was created.
+        long mStart;
+        long mEnd;
+    };
+
+    //! The model period being calculated.
+    int mPeriod;
+
+    //! Start and end in microseconds since the tracer was created.
+    long mStart;
+    long mEnd;
+
+    //! The grains executed, in the order they finished.
+    std::vector<GrainEvent> mEvents;
+
+    //! Protects mEvents as grains finish concurrently.
+    tbb::spin_mutex mEventLock;
+};
+
+/*!
+ * \brief Records when each grain of the flow graphs is executed and on which
+ *        thread to show where parallel time is lost.
+ * \details When the "parallel-trace-file" configuration file is set to
+ *          write-output every execution of a flow graph is recorded.  At the
+ *          end of the run the grain executions are written to that file in the
+ *          Chrome trace event format, which may be viewed with chrome://tracing
+ *          or Perfetto, and a summary comparing the critical path through the
+ *          grains with the total work is written to the main log.  The critical
+ *          path of a run is the longest chain of dependent grains using their
+ *          measured times, so total work divided by the critical path bounds the
+ *          speed up more threads could give.  Only the first
+ *          "parallel-trace-max-runs" runs keep their individual grain events for
+ *          the trace file, the summary includes all runs.
+ */
+class FlowGraphTracer : private boost::noncopyable {
+public:
+    static FlowGraphTracer& getInstance();
+
+    bool isEnabled() const;
+    FlowGraphTraceRun* startRun( GcamFlowGraph& aGraph );
+    void finishRun( GcamFlowGraph& aGraph );
+    long now() const;
+    void writeTrace() const;
+private:
+    FlowGraphTracer();
+
+    //! Whether flow graph runs should be traced.
+    bool mEnabled;
+
+    //! The time the tracer was created which all times are relative to.
+    boost::posix_time::ptime mEpoch;
+
+    //! The maximum number of runs to keep for the trace file.
+    int mMaxRuns;
+
+    //! The runs kept for the trace file, a list so that in progress runs do
+    //! not move.
+    std::list<FlowGraphTraceRun> mRuns;
+
+    //! Summed over all runs: run wall time, total grain time, and critical path
+    //! length, in microseconds.
+    double mTotalWall;
+    double mTotalWork;
+    double mTotalCriticalPath;
+
+    //! The number of runs traced.
+    int mNumRuns;
+
+    //! Protects the run list and totals as graphs may be run concurrently.
+    tbb::spin_mutex mRunLock;
+
+    static long criticalPath( const GcamFlowGraph& aGraph, const FlowGraphTraceRun& aRun );
+};
+
+/*!
+ * \brief Measured costs of the individual activities, used to balance grains.
+ * \details When the "parallel-cost-file" configuration file is set to
+ *          write-output, the time taken by each activity calculated through the
+ *          flow graph is accumulated over the run and the average time per call
+ *          is written to that file, keyed by the activity description, when the
+ *          run finishes.  If the file exists when the flow graph is created the
+ *          costs it contains from an earlier profiling run are used to size the
+ *          grains (see GcamParallel::graphParseGrainCollect).  Activities which
+ *          were not measured are assumed to have the average cost.  If the
+ *          ActivityProfiler is on it does the timing instead and the full
+ *          evaluation costs it measured, which also include any serial full
+ *          calculations, are written.
+ */
+class ActivityCostModel : private boost::noncopyable {
+public:
+    //! The time accumulated by a single activity.  The totals are atomic
+    //! since the same activity may be calculated by several flow graphs, such
+    //! as those made with MarketDependencyFinder::createFlowGraph, at once.
+    struct Cost {
+        Cost() : mTotalTime( 0.0 ), mCalls( 0 ) {}
+        void add( const double aSeconds );
+        std::atomic<double> mTotalTime;
+        std::atomic<int> mCalls;
+    };
+
+    static ActivityCostModel& getInstance();
+
+    bool isRecording() const;
+    Cost* getCostSlot( IActivity* aActivity );
+    bool hasCosts() const;
+    double getCost( const IActivity* aActivity ) const;
+    size_t getHash() const;
+    void writeCosts() const;
+private:
+    ActivityCostModel();
+
+    //! Whether activity times should be measured.
+    bool mRecording;
+
+    //! Average seconds per call by activity description from the cost file.
+    std::map<std::string, double> mLoadedCosts;
+
+    //! Times measured during this run.  Map elements do not move once created
+    //! so the slots may be held by the flow graph grains.
+    std::map<IActivity*, Cost> mMeasuredCosts;
+
+    //! Protects mMeasuredCosts while slots are created since flow graphs may
+    //! be built concurrently.
+    tbb::spin_mutex mCostSlotMutex;
 };
 
 /*!
@@ -95,19 +257,38 @@ public:
     typedef digraph<FlowGraphNodeType> FlowGraph;
     
     GcamParallel();
+
+    explicit GcamParallel( const int aGrainSizeTarget );
     
     /* Graph analysis and parsing methods */
-    void makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyFinder, FlowGraph& aGCAMFlowGraph );
+    void makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyFinder, FlowGraph& aGCAMFlowGraph,
+                            std::vector<IActivity*>& aAggregationNodes );
     
     void graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph );
     
     void graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, FlowGraph& aGrainGraph,
                                  const std::vector<FlowGraphNodeType>& aCalcItems );
+
+    void collectGrains( const FlowGraph& aGCAMFlowGraph,
+                        const std::vector<std::vector<FlowGraphNodeType> >& aGrains,
+                        FlowGraph& aGrainGraph );
+
+    static void getGrains( const FlowGraph& aGrainGraph,
+                           std::vector<std::vector<FlowGraphNodeType> >& aGrains );
+
+    size_t getGrainKey() const;
+
+    //! Get the target grain size for the parallel decomposition.
+    int getGrainSizeTarget() const { return mGrainSizeTarget; }
     
     void makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGraph& aTopology,
                            GcamFlowGraph& aTBBGraph );
   
 protected:
+    static void aggregateEdges( FlowGraph& aGraph, const std::set<FlowGraphNodeType>& aNodes,
+                                const bool aIsSources, const std::string& aDescription,
+                                std::vector<IActivity*>& aAggregationNodes );
+
     //! Helper class for sorting lists in topological order
     struct TopologicalComparator {
         TopologicalComparator(const FlowGraph& aGraph ) : mTopology( aGraph ) {}
@@ -134,7 +315,7 @@ protected:
      */
     struct TBBFlowGraphBody {
         TBBFlowGraphBody( const std::set<FlowGraphNodeType>& aNodes, const FlowGraph& aTopology,
-                          const GcamFlowGraph& aGraph );
+                          const GcamFlowGraph& aGraph, const int aGrainId );
         
         void operator()( tbb::flow::continue_msg aMessage );
 
@@ -144,6 +325,17 @@ protected:
         
         //! A reference to the TBB flow graph to which this node belongs.
         const GcamFlowGraph& mGraph;
+
+        //! Where to accumulate the time of each activity in mNodes, in the same
+        //! order, if activity costs are being recorded.
+        std::vector<ActivityCostModel::Cost*> mCosts;
+
+        //! Where to record the calls to each activity in mNodes, in the same
+        //! order, if the ActivityProfiler is on.
+        std::vector<ActivityProfiler::Counts*> mProfileCounts;
+
+        //! The id of this grain within mGraph.
+        int mGrainId;
     };
     
     /* data members */
@@ -154,15 +346,14 @@ protected:
      *          Grains won't turn out to be exactly this size; however,
      *          larger gsize will generally result in larger grains, less
      *          parallelism, and less overhead.  Smaller gsize will result
-     *          in the opposite.  The default is 30.
+     *          in the opposite.  The default is 30.  When activity costs
+     *          are available the size is measured in units of the cost of
+     *          an average activity rather than a count of activities.
      */
     int mGrainSizeTarget;
     
     //! Default grain size
     static const int DEFAULT_GRAIN_SIZE;
-    
-    // right now, grain size is the only parameter in the heuristics.
-    // We may add more later.
 };
 
   
@@ -37,6 +37,8 @@
 #include "parallel/include/clanid.hpp"
 #include "parallel/include/bitvector.hpp"
 #include <sstream>
+#include <vector>
+#include <algorithm>
 
 template<class T> T* unique_nodetitle(T* bestnode, size_t setsize)
 {
@@ -109,11 +111,41 @@ nodeid_t grain_title(const bitvector &nodeset, const digraph<nodeid_t> &topology
 }
 
 
+/* Find the cost of a set of nodes
+ *
+ * costs, if supplied, gives the relative cost of each node indexed by
+ * topological index, scaled so that an average node costs 1.  Without
+ * it every node is assumed to cost the same, and the cost of the set
+ * is simply its size.
+ */
+inline double grain_cost(const bitvector &nodeset, const std::vector<double> *costs)
+{
+  if(!costs)
+    return nodeset.count();
+
+  double cost = 0.0;
+  bitvector_iterator nodeit(&nodeset);
+  while(nodeit.next())
+    cost += (*costs)[nodeit.bindex()];
+  return cost;
+}
+
+
+/* Collect the nodes of a clan into grains
+ *
+ * grain_min is the target grain size, in units of the cost of an
+ * average node.  If costs (see grain_cost) is given, subclans are
+ * sized by their measured cost rather than their node count, and the
+ * small subclans of an independent clan are packed into grains of
+ * roughly equal cost (longest-first), since the slowest of those grains
+ * sets the length of the critical path through the clan.
+ */
 template<class nodeid_t>
 void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
                    const typename digraph<clanid<nodeid_t> >::nodelist_c_iter_t &claniterator,
                    digraph <nodeid_t> &GrainGraph,
-                   unsigned grain_min)
+                   unsigned grain_min,
+                   const std::vector<double> *costs = 0)
 {
   // define the clanid type
   typedef clanid<nodeid_t> Clanid;
@@ -146,10 +178,10 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     {
     for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
         subclan != claniterator->second.successors.end(); ++subclan) {
-      unsigned nsub = subclan->nodes().count();
+      double nsub = grain_cost(subclan->nodes(), costs);
       // search large subclans for grains
       if(nsub >= grain_min)
-        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min);
+        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min, costs);
       else
         node_group.setunion(subclan->nodes());
     }
@@ -160,14 +192,40 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     // exactly, since we don't know the distribution of the sizes of
     // the leftover clans.  We'll guess that they're pretty uniform
     // and build heuristics around that.
-    int nnode = node_group.count(); // cache the number of nodes in the group.  Be careful to update whenever we change the group membership!
-    int nbreakup = nnode / grain_min;
+    double nnode = grain_cost(node_group, costs); // cache the cost of the group.  Be careful to update whenever we change the group membership!
+    int nbreakup = int(nnode / grain_min);
     if(nbreakup < 2 && nnode >= ind_split_min )
       // fudge the minimum grain size a little for extra parallelism.
       // It was probably just a guess anyhow.
       nbreakup = 2;
 
-    if(nbreakup > 1) {
+    if(nbreakup > 1 && costs) {
+      // With real costs the subclans can differ in size by orders of
+      // magnitude, so walking them in order would give very uneven
+      // grains.  Instead hand out the most expensive remaining subclan
+      // to the cheapest grain so far.
+      std::vector<std::pair<double, const Clanid*> > small;
+      for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
+          subclan != claniterator->second.successors.end(); ++subclan) {
+        double nsub = grain_cost(subclan->nodes(), costs);
+        if(nsub < grain_min)
+          small.push_back(std::make_pair(nsub, &*subclan));
+      }
+      std::sort(small.rbegin(), small.rend());
+
+      std::vector<bitvector> bins(nbreakup, bitvector(topology.nodelist().size()));
+      std::vector<double> load(nbreakup, 0.0);
+      for(size_t i=0; i<small.size(); ++i) {
+        size_t b = std::min_element(load.begin(), load.end()) - load.begin();
+        bins[b].setunion(small[i].second->nodes());
+        load[b] += small[i].first;
+      }
+      for(size_t b=0; b<bins.size(); ++b)
+        if(!bins[b].empty())
+          GrainGraph.collapse_subgraph(topology.convert_to_set(bins[b]), grain_title(bins[b], topology));
+      node_group.clearall();
+    }
+    else if(nbreakup > 1) {
       // this will be the approximate size of the new grains we will make.
       unsigned grain_size_thresh = nnode / nbreakup;
       node_group.clearall();       // nnode no lonber valid!
@@ -213,7 +271,7 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
     for(typename std::set<Clanid>::const_iterator subclan = claniterator->second.successors.begin();
         subclan != claniterator->second.successors.end(); ++subclan) {
       if( (subclan->type == independent || subclan->type == pseudoindependent) &&
-          subclan->nodes().count() >= ind_split_min ) {
+          grain_cost(subclan->nodes(), costs) >= ind_split_min ) {
         // only recurse on independent clans that are guaranteed to
         // split (an independent could split with as few as
         // grain_min+1 clans, but it's not guaranteed and rarely
@@ -226,7 +284,7 @@ void grain_collect(const digraph<clanid<nodeid_t> > &ClanTree,
           node_group.clearall();   // start the next grain
         }
         // then recurse on the subclan
-        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min);
+        grain_collect(ClanTree, ClanTree.nodelist().find(*subclan), GrainGraph, grain_min, costs);
       }
       else {
         // add this clan's nodes to the node group
@@ -148,6 +148,151 @@ void filter_to_subgraph(std::set<nodeid_t> &set, const bitvector *subgraph, cons
 }
 
 
+//! maximum size, in bits, of each of the dense reachability tables
+//! \details When the ancestor and descendant tables for a (sub)graph
+//! would be larger than this, the reachability class searches the
+//! graph each time a set of ancestors or descendants is needed
+//! instead.  The default of 2^28 bits limits each table to 32 MB.
+const double dense_reachability_maxbits_default = 268435456.0;
+double dense_reachability_maxbits = dense_reachability_maxbits_default;
+
+//! Ancestors and descendants of sets of nodes in a graph
+//! \details For graphs small enough that the ancestors and
+//! descendants of every node fit in two bitvector tables (see
+//! dense_reachability_maxbits) the tables are computed once, and the
+//! ancestors of a set of nodes are the union of the table rows for
+//! the nodes in the set.  This takes O(n^2) memory, which is
+//! prohibitive for graphs with tens of thousands of nodes, so for
+//! larger graphs we instead do a depth first search from all of the
+//! nodes in the set sharing a single visited set.  The searches use
+//! adjacency lists of topological indices built once from the graph,
+//! so that they need no map lookups.  Each search costs at most O(E)
+//! time, but the memory required is only O(n+E).
+//! \remark All of the sets returned include the starting nodes, so
+//! they correspond to D* and A* in McCreary and Reed.
+template <class nodeid_t>
+class reachability {
+  const digraph<nodeid_t> &G;
+  const bitvector *subgraph;
+  bool dense;
+  std::vector<bitvector> ancestor_tbl, descendant_tbl;
+  //! parents and children of each node in the subgraph, by topological index
+  std::vector<std::vector<unsigned> > parent_idx, child_idx;
+
+  void search(const bitvector &start, bitvector &rslt, bool reverse,
+              const bitvector *within) const;
+public:
+  reachability(const digraph<nodeid_t> &Gin, const bitvector *subg);
+
+  //! flag indicating whether the dense tables are in use
+  bool isdense(void) const {return dense;}
+  //! find the nodes in start and all of their descendants in the subgraph
+  void descendants(const bitvector &start, bitvector &rslt) const {search(start, rslt, false, subgraph);}
+  //! find the nodes in start and all of their ancestors in the subgraph
+  void ancestors(const bitvector &start, bitvector &rslt) const {search(start, rslt, true, subgraph);}
+  //! find the nodes in start and all of their ancestors in the set
+  //! within, which must itself be contained in the subgraph.
+  //! \details In the sparse case only the part of the graph in within
+  //! is searched, which makes this much cheaper than ancestors()
+  //! followed by an intersection when within is small.
+  //! \pre start is a subset of within, and every node on a path
+  //! between a node in within and a node in start is also in within.
+  void ancestors_within(const bitvector &start, const bitvector &within, bitvector &rslt) const {
+    search(start, rslt, true, &within);
+    if(dense)
+      rslt.setintersection(within);
+  }
+};
+
+template <class nodeid_t>
+reachability<nodeid_t>::reachability(const digraph<nodeid_t> &Gin, const bitvector *subg) :
+  G(Gin), subgraph(subg)
+{
+  const int NMAX = G.nodelist().size();
+  const double nsub = subgraph ? subgraph->count() : NMAX;
+  dense = nsub * NMAX <= dense_reachability_maxbits;
+  if(!dense) {
+    parent_idx.resize(NMAX);
+    child_idx.resize(NMAX);
+    for(typename digraph<nodeid_t>::nodelist_c_iter_t nit = G.nodelist().begin();
+        nit != G.nodelist().end(); ++nit) {
+      const int nidx = G.topological_index(nit->first);
+      if(subgraph && !subgraph->get(nidx))
+        continue;
+      const std::set<nodeid_t> &children(nit->second.successors);
+      for(typename std::set<nodeid_t>::const_iterator cit = children.begin();
+          cit != children.end(); ++cit) {
+        const int cidx = G.topological_index(*cit);
+        if(!subgraph || subgraph->get(cidx)) {
+          child_idx[nidx].push_back(cidx);
+          parent_idx[cidx].push_back(nidx);
+        }
+      }
+    }
+    return;
+  }
+
+  // The index is the node's topological index.  If we're working on a
+  // subgraph, then some of the entries won't get initialized at all,
+  // but since we only ever reference entries that are in the subgraph,
+  // that is ok.
+  ancestor_tbl.resize(NMAX);
+  descendant_tbl.resize(NMAX);
+  bitvector working_set(NMAX);
+  for(typename digraph<nodeid_t>::nodelist_c_iter_t nit = G.nodelist().begin();
+      nit != G.nodelist().end(); ++nit) {
+    const nodeid_t &n(nit->first);
+    const int nidx = G.topological_index(n);
+    if(subgraph && !subgraph->get(nidx))
+      continue;
+
+    working_set.clearall();
+    G.find_ancestors(n, working_set, subgraph);
+    ancestor_tbl[nidx] = working_set;
+
+    working_set.clearall();
+    G.find_descendants(n, working_set, subgraph);
+    descendant_tbl[nidx] = working_set;
+  }
+}
+
+template <class nodeid_t>
+void reachability<nodeid_t>::search(const bitvector &start, bitvector &rslt, bool reverse,
+                                    const bitvector *within) const
+{
+  rslt = start;
+  bitvector_iterator startit(&start);
+  if(dense) {
+    const std::vector<bitvector> &tbl(reverse ? ancestor_tbl : descendant_tbl);
+    while(startit.next())
+      rslt.setunion(tbl[startit.bindex()]);
+  }
+  else {
+    // The start nodes are already marked as seen, so the search stops
+    // at any start node it reaches.  That node is on the stack already
+    // and will cover what lies beyond it, so no node is visited more
+    // than once.  The adjacency lists are already restricted to the
+    // subgraph, so we need only check within when it is narrower.
+    const std::vector<std::vector<unsigned> > &adj(reverse ? parent_idx : child_idx);
+    const bool filter = within && within != subgraph;
+    std::vector<unsigned> stack;
+    while(startit.next())
+      stack.push_back(startit.bindex());
+    while(!stack.empty()) {
+      const std::vector<unsigned> &next(adj[stack.back()]);
+      stack.pop_back();
+      for(size_t i=0; i<next.size(); ++i) {
+        const unsigned j = next[i];
+        if(!rslt.get(j) && (!filter || within->get(j))) {
+          rslt.set(j);
+          stack.push_back(j);
+        }
+      }
+    }
+  }
+}
+
+
 template <class nodeid_t>
 bool clan_desc_by_size(const clanid<nodeid_t> &c1, const clanid<nodeid_t> &c2)
 {
@@ -281,26 +426,20 @@ void identify_clans(const digraph<nodeid_t> &Gr, const bitvector *subgraph, std:
   typedef map<nodeset_t, nodeset_t> graph_partition_t;
   typedef typename graph_partition_t::iterator partition_iter_t;
 
-  // 1) Compile tables of ancestors and descendants.  The index is the
-  // node's topological index.  We will need these later. NB: We won't
-  // initialize the array entries until we actually compute the
-  // ancestors and descendants below.  If we're working on a subgraph,
-  // then some of the entries won't get initialized at all, but since
-  // we only ever reference entries that are in the subgraph, that is
-  // ok. 
-  // TODO: hoist this table out of the identify_clans function so that
-  // we only compute these tables once.  This is harder to do than it
+  // 1) Set up the lookup of ancestors and descendants, which will
+  // compile tables of them up front if the graph is small enough.
+  // TODO: hoist this out of the identify_clans function so that we
+  // only compute these tables once.  This is harder to do than it
   // seems at first glance, since the graph topology *does* change
   // when we augment primitive clans to reparse them.  Thus, if we
   // save the tables we must also recompute the entries for nodes to
   // which we add edges.
-  std::vector<nodeset_t> ancestor_tbl(NMAX), descendant_tbl(NMAX);
+  const reachability<nodeid_t> reach(Gr, subgraph);
 
   // 2) Also, make two partitions on the graph: once according to parents, and
-  // once according to children.  We'll do this in the same loop with step 1.
+  // once according to children.
   graph_partition_t S;          // partition by parents
   graph_partition_t M;          // partition by children
-  nodeset_t working_set(NMAX);
   typename Graph::nodelist_c_iter_t nit = Gr.nodelist().begin();
   for( ; nit != Gr.nodelist().end(); nit++) {
     const nodeid_t &n(nit->first);
@@ -308,14 +447,6 @@ void identify_clans(const digraph<nodeid_t> &Gr, const bitvector *subgraph, std:
     if(subgraph && !subgraph->get(nidx))
       continue;                 // skip this node; it's not part of the subgraph we're working on
 
-    working_set.clearall();
-    Gr.find_ancestors(n, working_set, subgraph);
-    ancestor_tbl[nidx] = working_set;
-
-    working_set.clearall();
-    Gr.find_descendants(n, working_set, subgraph);
-    descendant_tbl[nidx] = working_set;
-
     // add this node to the appropriate partitions. -- We have to use
     // sort of a roundabout way of doing this in order to make sure
     // that a bitvector of the correct size gets inserted.
@@ -361,8 +492,13 @@ void identify_clans(const digraph<nodeid_t> &Gr, const bitvector *subgraph, std:
 #ifdef IDCLANS_VERBOSE
   std::cerr << "Node\tancestors\tdescendants\n";
   for(int i=0; i<NMAX; ++i)
-    if(ancestor_tbl[i].length() > 0 && descendant_tbl[i].length() > 0)
-      std::cerr << i << "\t" << ancestor_tbl[i] << "\t" << descendant_tbl[i] << "\n\n";
+    if(!subgraph || subgraph->get(i)) {
+      nodeset_t node(NMAX), anc(NMAX), desc(NMAX);
+      node.set(i);
+      reach.ancestors(node, anc);
+      reach.descendants(node, desc);
+      std::cerr << i << "\t" << anc << "\t" << desc << "\n\n";
+    }
 #endif
 
   
@@ -375,27 +511,29 @@ void identify_clans(const digraph<nodeid_t> &Gr, const bitvector *subgraph, std:
                                      // nodes in X, plus their
                                      // descendants. astar is same for
                                      // ancestors.
+  nodeset_t F(NMAX);
   partition_iter_t siter, miter;
   for(siter=S.begin(); siter != S.end(); ++siter) {
+    const nodeset_t &si = siter->second;
+    // D*(S) depends only on the source partition, so compute it once
+    // for all of the sink partitions.
+    reach.descendants(si, dstar);
     for(miter=M.begin(); miter != M.end(); ++miter) {
-      const nodeset_t &si = siter->second;
       const nodeset_t &mj = miter->second;
-      dstar.copyin(si);
-      astar.copyin(mj);
-
-      bitvector_iterator ssit(&si);
-      while(ssit.next())
-        dstar.setunion(descendant_tbl[ssit.bindex()]);
 
-      bitvector_iterator msit(&mj);
-      while(msit.next())
-        astar.setunion(ancestor_tbl[msit.bindex()]);
+      // Any ancestor of M that is in D*(S) lies on a path from S to a
+      // node of M which is itself in D*(S), so if no node of M is in
+      // D*(S) the prospective clan is empty.  Otherwise it suffices to
+      // search back from those nodes without leaving D*(S).
+      astar.copyin(mj);
+      astar.setintersection(dstar);
+      if(astar.empty())
+        continue;
       
       // F is the prospective clan formed from the intersection of
       // D*(S) and A*(M) (i.e., all of the descendants of the source
       // nodes S that sink to the sink nodes M)
-      nodeset_t &F(dstar);
-      F.setintersection(astar);
+      reach.ancestors_within(astar, dstar, F);
 
 #ifdef IDCLANS_VERBOSE
       if(F.count() > 1) {
@@ -453,23 +591,14 @@ void identify_clans(const digraph<nodeid_t> &Gr, const bitvector *subgraph, std:
             compsrcs.setintersection(ccomp);
             compsinks.setintersection(ccomp);
             // D*(S) and A*(M), for this component only
-            nodeset_t dstarS(compsrcs), astarM(compsinks);
+            nodeset_t dstarS(NMAX), astarM(NMAX);
             // D*(M) and A*(S) for this component only
-            nodeset_t astarS(compsrcs), dstarM(compsinks);
+            nodeset_t astarS(NMAX), dstarM(NMAX);
 
-            bitvector_iterator compsrcit(&compsrcs);
-            while(compsrcit.next()) {
-              int j = (int) compsrcit.bindex();
-              dstarS.setunion(descendant_tbl[j]);
-              astarS.setunion(ancestor_tbl[j]);
-            }
-
-            bitvector_iterator compsinkit(&compsinks);
-            while(compsinkit.next()) {
-              int j = (int) compsinkit.bindex();
-              astarM.setunion(ancestor_tbl[j]);
-              dstarM.setunion(descendant_tbl[j]);
-            }
+            reach.descendants(compsrcs, dstarS);
+            reach.ancestors(compsrcs, astarS);
+            reach.ancestors(compsinks, astarM);
+            reach.descendants(compsinks, dstarM);
 
 #ifdef IDCLANS_VERBOSE
             if(ccomp.count() >= 32) {
@@ -0,0 +1,124 @@
+#ifndef _PARALLEL_BENCHMARK_HPP_
+#define _PARALLEL_BENCHMARK_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+#if GCAM_PARALLEL_ENABLED
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file parallel_benchmark.hpp
+ * \ingroup Objects
+ * \brief Header file for the ParallelBenchmark class.
+ */
+
+#include <string>
+#include <vector>
+
+class SolutionInfoParamParser;
+
+/*!
+ * \ingroup Objects
+ * \brief Measures how the model calculations scale with the number of threads
+ *        and the flow graph grain size.
+ * \details The benchmark is run for the period given by the
+ *          parallel-benchmark-year configuration value before the period is
+ *          solved.  For each of the thread counts in parallel-benchmark-threads,
+ *          by default the powers of two up to the number of cores, a Jacobian
+ *          of the solvable markets is timed, as is a full model calculation of
+ *          a flow graph made for each of the grain sizes in
+ *          parallel-benchmark-grain-sizes, by default just the configured one.
+ *          Each measurement is the average of parallel-benchmark-repeats runs.
+ *          The speedup and efficiency of each relative to the fewest threads
+ *          are printed to the main log and written to the optional
+ *          "parallel-benchmark" CSV file.  The thread count and grain size
+ *          with the lowest combined time may be written to the optional
+ *          "parallel-tuning" file which is a configuration fragment that is
+ *          read after the configuration in later runs.  A serial model
+ *          calculation in a "scratch" state is also timed with and without
+ *          Value::ScopedStateBinding to show the cost of finding each thread's
+ *          state on every STATE Value access.  The model state is restored
+ *          afterwards so the solution of the period is unaffected.
+ * \note Only the markets which would be solved by Newton-Raphson are included
+ *       in the Jacobian and the partial derivatives are calculated with the
+ *       ManageStateVariables thread pool, which is resized for each thread
+ *       count.  This is not possible when threads are pinned to NUMA nodes.
+ */
+class ParallelBenchmark {
+public:
+    ParallelBenchmark( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser );
+
+    void run();
+private:
+    //! The times measured for a single thread count and grain size.
+    struct Result {
+        //! The number of threads.
+        int mThreads;
+
+        //! The target grain size of the flow graph.
+        int mGrainSize;
+
+        //! The average time of a full model calculation in seconds.
+        double mCalcSeconds;
+
+        //! The average time of a Jacobian in seconds.
+        double mJacobianSeconds;
+    };
+
+    //! The model period to benchmark.
+    const int mPeriod;
+
+    //! The solution parameters to set up the markets of the Jacobian with.
+    const SolutionInfoParamParser* mSolutionInfoParamParser;
+
+    //! The number of times each measurement is repeated.
+    int mRepeats;
+
+    static std::vector<int> parseList( const std::string& aList );
+
+    double timeCalc( const int aThreads, const int aGrainSize );
+
+    double timeJacobian( const int aThreads );
+
+    double timeStateAccess( const bool aBindState );
+
+    void report( const std::vector<Result>& aResults ) const;
+
+    void writeTuning( const Result& aBest ) const;
+};
+
+#endif // GCAM_PARALLEL_ENABLED
+
+#endif // _PARALLEL_BENCHMARK_HPP_
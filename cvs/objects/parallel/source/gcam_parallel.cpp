@@ -32,6 +32,12 @@
 
 #if GCAM_PARALLEL_ENABLED
 #include <map>
+#include <fstream>
+#include <cstdlib>
+#include <algorithm>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/functional/hash/hash.hpp>
+#include <tbb/task_arena.h>
 /* gcam headers */
 #include "parallel/include/gcam_parallel.hpp"
 #include "util/base/include/configuration.h"
@@ -40,7 +46,11 @@
 #include "containers/include/market_dependency_finder.h"
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/timer.h"
+#include "util/base/include/startup_profile.h"
+#include "util/base/include/allocation_tracker.h"
 #include "util/base/include/auto_file.h"
+#include "util/base/include/value.h"
+#include "util/base/include/deterministic_reduction.h"
 /* more graph analysis headers */
 #include "parallel/include/clanid.hpp"
 #include "parallel/include/graph-parse.hpp"
@@ -51,6 +61,352 @@ using namespace std;
 
 const int GcamParallel::DEFAULT_GRAIN_SIZE = 30;
 
+namespace {
+    /*!
+     * \brief An activity which calculates nothing and only serves to join the
+     *        activities of all regions in a multi-region market to everything
+     *        which depends on them (see GcamParallel::aggregateEdges).
+     */
+    class MarketAggregationActivity : public IActivity {
+    public:
+        explicit MarketAggregationActivity( const string& aDescription ):mDescription( aDescription ) {}
+
+        // IActivity methods
+        virtual void calc( const int aPeriod ) {}
+
+        virtual string getDescription() const {
+            return mDescription;
+        }
+    private:
+        //! The description of this activity.
+        const string mDescription;
+    };
+}
+
+/*!
+ * \brief Constructor which loads any costs saved by an earlier profiling run.
+ */
+ActivityCostModel::ActivityCostModel()
+{
+    const Configuration* conf = Configuration::getInstance();
+    const string fileName = conf->getFile( "parallel-cost-file", "", false );
+    mRecording = !fileName.empty() && conf->shouldWriteFile( "parallel-cost-file", false, false );
+    if( fileName.empty() ) {
+        return;
+    }
+
+    ifstream costFile( fileName.c_str() );
+    if( !costFile ) {
+        // no costs yet, nothing to do
+        return;
+    }
+    string line;
+    // skip the header
+    getline( costFile, line );
+    while( getline( costFile, line ) ) {
+        // activity,seconds-per-call,calls; descriptions do not contain commas
+        // but search from the right anyway
+        size_t callsPos = line.rfind( ',' );
+        size_t costPos = callsPos == string::npos || callsPos == 0 ? string::npos : line.rfind( ',', callsPos - 1 );
+        if( costPos == string::npos ) {
+            continue;
+        }
+        mLoadedCosts[ line.substr( 0, costPos ) ] = atof( line.substr( costPos + 1, callsPos - costPos - 1 ).c_str() );
+    }
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Read " << mLoadedCosts.size() << " activity costs from " << fileName << endl;
+}
+
+/*!
+ * \brief Get the singleton instance of the ActivityCostModel.
+ * \return The ActivityCostModel.
+ */
+ActivityCostModel& ActivityCostModel::getInstance() {
+    static ActivityCostModel ACTIVITY_COST_MODEL;
+    return ACTIVITY_COST_MODEL;
+}
+
+/*!
+ * \brief Whether the time taken by each activity should be measured.
+ * \return True if the cost file is to be written at the end of the run.
+ */
+bool ActivityCostModel::isRecording() const {
+    return mRecording;
+}
+
+/*!
+ * \brief Get the place to accumulate the time taken by an activity.
+ * \details This is called while building a flow graph and may be called
+ *          while another graph is running.
+ * \param aActivity The activity to be timed.
+ * \return The cost slot which does not move for the duration of the run.
+ */
+ActivityCostModel::Cost* ActivityCostModel::getCostSlot( IActivity* aActivity ) {
+    tbb::spin_mutex::scoped_lock lock( mCostSlotMutex );
+    return &mMeasuredCosts[ aActivity ];
+}
+
+/*!
+ * \brief Add a call of the activity which took the given time.
+ * \details This may be called concurrently for the same activity.
+ * \param aSeconds The wall time of the call.
+ */
+void ActivityCostModel::Cost::add( const double aSeconds ) {
+    double curr = mTotalTime.load( std::memory_order_relaxed );
+    while( !mTotalTime.compare_exchange_weak( curr, curr + aSeconds, std::memory_order_relaxed ) ) {
+    }
+    mCalls.fetch_add( 1, std::memory_order_relaxed );
+}
+
+/*!
+ * \brief Whether any costs were loaded from an earlier run.
+ * \return True if costs are available to balance the grains.
+ */
+bool ActivityCostModel::hasCosts() const {
+    return !mLoadedCosts.empty();
+}
+
+/*!
+ * \brief Get the average time per call of an activity from the cost file.
+ * \param aActivity The activity to look up.
+ * \return The time in seconds or -1 if the activity was not measured.
+ */
+double ActivityCostModel::getCost( const IActivity* aActivity ) const {
+    map<string, double>::const_iterator it = mLoadedCosts.find( aActivity->getDescription() );
+    return it != mLoadedCosts.end() ? it->second : -1.0;
+}
+
+/*!
+ * \brief A hash of the loaded costs so that grains cached using one set of
+ *        costs are not reused with another.
+ * \return The hash, zero if no costs were loaded.
+ */
+size_t ActivityCostModel::getHash() const {
+    size_t hash = 0;
+    for( map<string, double>::const_iterator it = mLoadedCosts.begin(); it != mLoadedCosts.end(); ++it ) {
+        boost::hash_combine( hash, it->first );
+        boost::hash_combine( hash, it->second );
+    }
+    return hash;
+}
+
+/*!
+ * \brief Write the average time per call of each activity measured during
+ *        this run to the cost file.
+ */
+void ActivityCostModel::writeCosts() const {
+    if( !mRecording ) {
+        return;
+    }
+    AutoOutputFile costFile( "parallel-cost-file", "parallel-activity-costs.csv" );
+    (*costFile) << "activity,seconds-per-call,calls" << endl;
+    const ActivityProfiler& activityProfiler = ActivityProfiler::getInstance();
+    if( activityProfiler.isEnabled() ) {
+        const map<const IActivity*, ActivityProfiler::RunCost>& runCosts = activityProfiler.getRunCosts();
+        for( map<const IActivity*, ActivityProfiler::RunCost>::const_iterator it = runCosts.begin(); it != runCosts.end(); ++it ) {
+            if( it->second.mCalls > 0 ) {
+                (*costFile) << it->first->getDescription() << ','
+                            << it->second.mSeconds / it->second.mCalls << ','
+                            << it->second.mCalls << '\n';
+            }
+        }
+        return;
+    }
+    for( map<IActivity*, Cost>::const_iterator it = mMeasuredCosts.begin(); it != mMeasuredCosts.end(); ++it ) {
+        const int calls = it->second.mCalls.load();
+        if( calls > 0 ) {
+            (*costFile) << it->first->getDescription() << ','
+                        << it->second.mTotalTime.load() / calls << ','
+                        << calls << '\n';
+        }
+    }
+}
+
+/*!
+ * \brief Constructor which checks the configuration to see if tracing is on.
+ */
+FlowGraphTracer::FlowGraphTracer()
+:mEpoch( boost::posix_time::microsec_clock::universal_time() ),
+mTotalWall( 0 ),
+mTotalWork( 0 ),
+mTotalCriticalPath( 0 ),
+mNumRuns( 0 )
+{
+    const Configuration* conf = Configuration::getInstance();
+    mEnabled = conf->shouldWriteFile( "parallel-trace-file", false, false );
+    mMaxRuns = conf->getInt( "parallel-trace-max-runs", 1000 );
+}
+
+/*!
+ * \brief Get the singleton instance of the FlowGraphTracer.
+ * \return The FlowGraphTracer.
+ */
+FlowGraphTracer& FlowGraphTracer::getInstance() {
+    static FlowGraphTracer FLOW_GRAPH_TRACER;
+    return FLOW_GRAPH_TRACER;
+}
+
+/*!
+ * \brief Whether flow graph runs are being traced.
+ * \return True if the trace file is to be written at the end of the run.
+ */
+bool FlowGraphTracer::isEnabled() const {
+    return mEnabled;
+}
+
+/*!
+ * \brief The current time.
+ * \return Microseconds since the tracer was created.
+ */
+long FlowGraphTracer::now() const {
+    return ( boost::posix_time::microsec_clock::universal_time() - mEpoch ).total_microseconds();
+}
+
+/*!
+ * \brief Start tracing a run of a flow graph.
+ * \details Must be called before the graph is started, and finishRun called
+ *          once it has completed.  The graph must have been created while
+ *          tracing was enabled so that the grain dependencies are known.
+ * \param aGraph The graph about to be run.
+ * \return The trace the grains will be recorded in.
+ */
+FlowGraphTraceRun* FlowGraphTracer::startRun( GcamFlowGraph& aGraph ) {
+    tbb::spin_mutex::scoped_lock lock( mRunLock );
+    mRuns.emplace_back();
+    FlowGraphTraceRun& run = mRuns.back();
+    run.mPeriod = aGraph.mPeriod;
+    run.mStart = now();
+    run.mEnd = run.mStart;
+    run.mEvents.reserve( aGraph.mGrainPredecessors.size() );
+    aGraph.mTraceRun = &run;
+    return &run;
+}
+
+/*!
+ * \brief Finish tracing a run of a flow graph and add it to the summary.
+ * \details Runs beyond the configured maximum are only kept in the summary.
+ * \param aGraph The graph which has finished running.
+ */
+void FlowGraphTracer::finishRun( GcamFlowGraph& aGraph ) {
+    FlowGraphTraceRun* run = aGraph.mTraceRun;
+    if( !run ) {
+        return;
+    }
+    aGraph.mTraceRun = 0;
+    run->mEnd = now();
+    double work = 0;
+    for( const FlowGraphTraceRun::GrainEvent& event : run->mEvents ) {
+        work += event.mEnd - event.mStart;
+    }
+    const long cp = criticalPath( aGraph, *run );
+
+    tbb::spin_mutex::scoped_lock lock( mRunLock );
+    mTotalWall += run->mEnd - run->mStart;
+    mTotalWork += work;
+    mTotalCriticalPath += cp;
+    ++mNumRuns;
+    if( mNumRuns > mMaxRuns ) {
+        for( list<FlowGraphTraceRun>::iterator it = mRuns.begin(); it != mRuns.end(); ++it ) {
+            if( &*it == run ) {
+                mRuns.erase( it );
+                break;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Calculate the length of the critical path of a traced run.
+ * \details The longest chain of dependent grains weighted by the time each
+ *          grain took in this run.  Grains which were not run contribute
+ *          nothing.
+ * \param aGraph The graph which was run.
+ * \param aRun The trace of the run.
+ * \return The critical path length in microseconds.
+ */
+long FlowGraphTracer::criticalPath( const GcamFlowGraph& aGraph, const FlowGraphTraceRun& aRun ) {
+    const vector<vector<int> >& preds = aGraph.mGrainPredecessors;
+    vector<long> duration( preds.size(), 0 );
+    for( const FlowGraphTraceRun::GrainEvent& event : aRun.mEvents ) {
+        if( event.mGrain < static_cast<int>( duration.size() ) ) {
+            duration[ event.mGrain ] = event.mEnd - event.mStart;
+        }
+    }
+    // Grains finish after all of their predecessors so the events are already
+    // in a topological order, however grains which were not run still need
+    // to pass through the path lengths of their predecessors so just iterate
+    // with an explicit stack.
+    vector<long> pathLength( preds.size(), -1 );
+    long longest = 0;
+    for( size_t root = 0; root < preds.size(); ++root ) {
+        vector<int> stack( 1, static_cast<int>( root ) );
+        while( !stack.empty() ) {
+            const int grain = stack.back();
+            if( pathLength[ grain ] >= 0 ) {
+                stack.pop_back();
+                continue;
+            }
+            bool ready = true;
+            long predLength = 0;
+            for( int pred : preds[ grain ] ) {
+                if( pathLength[ pred ] < 0 ) {
+                    stack.push_back( pred );
+                    ready = false;
+                }
+                else {
+                    predLength = max( predLength, pathLength[ pred ] );
+                }
+            }
+            if( ready ) {
+                pathLength[ grain ] = predLength + duration[ grain ];
+                longest = max( longest, pathLength[ grain ] );
+                stack.pop_back();
+            }
+        }
+    }
+    return longest;
+}
+
+/*!
+ * \brief Write the traced grains in the Chrome trace event format and log a
+ *        summary of the available parallelism.
+ */
+void FlowGraphTracer::writeTrace() const {
+    if( !mEnabled ) {
+        return;
+    }
+    AutoOutputFile traceFile( "parallel-trace-file", "flow-graph-trace.json" );
+    (*traceFile) << "{\"traceEvents\":[";
+    bool first = true;
+    int runIndex = 0;
+    for( const FlowGraphTraceRun& run : mRuns ) {
+        (*traceFile) << ( first ? "\n" : ",\n" )
+                     << "{\"name\":\"run " << runIndex << "\",\"cat\":\"run\",\"ph\":\"X\",\"ts\":" << run.mStart
+                     << ",\"dur\":" << run.mEnd - run.mStart << ",\"pid\":0,\"tid\":-1"
+                     << ",\"args\":{\"period\":" << run.mPeriod << ",\"grains\":" << run.mEvents.size() << "}}";
+        first = false;
+        for( const FlowGraphTraceRun::GrainEvent& event : run.mEvents ) {
+            (*traceFile) << ",\n{\"name\":\"grain " << event.mGrain << "\",\"cat\":\"grain\",\"ph\":\"X\",\"ts\":" << event.mStart
+                         << ",\"dur\":" << event.mEnd - event.mStart << ",\"pid\":0,\"tid\":" << event.mThread
+                         << ",\"args\":{\"run\":" << runIndex << ",\"activities\":" << event.mSize << "}}";
+        }
+        ++runIndex;
+    }
+    (*traceFile) << "\n]}" << endl;
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    const int threads = tbb::this_task_arena::max_concurrency();
+    mainLog << "Flow graph trace: " << mNumRuns << " runs, wall time " << mTotalWall * 1.0e-6
+            << "s, total work " << mTotalWork * 1.0e-6 << "s, critical path " << mTotalCriticalPath * 1.0e-6 << 's' << endl;
+    if( mTotalCriticalPath > 0 && mTotalWall > 0 ) {
+        mainLog << "Flow graph trace: average parallelism " << mTotalWork / mTotalCriticalPath
+                << ", achieved " << mTotalWork / mTotalWall
+                << ", utilization of " << threads << " threads " << 100.0 * mTotalWork / ( mTotalWall * threads ) << '%' << endl;
+    }
+}
+
 /*!
  * \brief Default constructor
  *
@@ -66,6 +422,16 @@ GcamParallel::GcamParallel()
 {
     mGrainSizeTarget = Configuration::getInstance()->getInt( "parallel-grain-size", DEFAULT_GRAIN_SIZE );
 }
+
+/*!
+ * \brief Constructor which uses the given grain size rather than the one from
+ *        the configuration.
+ * \param aGrainSizeTarget The target grain size.
+ */
+GcamParallel::GcamParallel( const int aGrainSizeTarget ):
+mGrainSizeTarget( aGrainSizeTarget )
+{
+}
   
 
 
@@ -80,9 +446,14 @@ GcamParallel::GcamParallel()
  * \param[out] aGCAMFlowGraph: The flow graph created by the routine.  On input it
  *                             should be a newly-created (i.e., empty) FGraph
  *                             object. 
+ * \param[out] aAggregationNodes: The activities added to the flow graph to
+ *                                aggregate multi-region markets which the caller
+ *                                is responsible for deleting once the flow graph
+ *                                is no longer in use.
  * \pre aDependencyFinder.createOrdering() has been run
  */
-void GcamParallel::makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyFinder, FlowGraph& aGCAMFlowGraph )
+void GcamParallel::makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyFinder, FlowGraph& aGCAMFlowGraph,
+                                      vector<IActivity*>& aAggregationNodes )
 {
     // Basic procedure: 
     // *  For each dependency item, d:
@@ -128,6 +499,43 @@ void GcamParallel::makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyF
             }
         }
     }
+
+    // The activities of a multi-region market, such as a global market for a
+    // traded good, in each region are dependent on the activities of all
+    // regions in the market (see MarketDependencyFinder::createOrdering).
+    // Rather than connecting each region's contribution directly to every
+    // dependent in every region join them through a single node per market so
+    // that the flow graph has an explicit two phase structure: all regions add
+    // to the market in parallel, then all dependents proceed in parallel.
+    map<int, vector<const MarketDependencyFinder::DependencyItem*> > marketItems;
+    for( diIter = dependencyItems.begin(); diIter != dependencyItems.end(); ++diIter ) {
+        if( (*diIter)->mLinkedMarket != -1 ) {
+            marketItems[ (*diIter)->mLinkedMarket ].push_back( *diIter );
+        }
+    }
+    for( map<int, vector<const MarketDependencyFinder::DependencyItem*> >::const_iterator marketIter = marketItems.begin();
+         marketIter != marketItems.end(); ++marketIter )
+    {
+        if( marketIter->second.size() < 2 ) {
+            continue;
+        }
+        set<FlowGraphNodeType> priceNodes;
+        set<FlowGraphNodeType> demandNodes;
+        for( vector<const MarketDependencyFinder::DependencyItem*>::const_iterator itemIter = marketIter->second.begin();
+             itemIter != marketIter->second.end(); ++itemIter )
+        {
+            if( !(*itemIter)->mPriceVertices.empty() ) {
+                priceNodes.insert( (*itemIter)->getLastPriceVertex()->mCalcItem );
+            }
+            if( !(*itemIter)->mDemandVertices.empty() ) {
+                demandNodes.insert( (*itemIter)->getFirstDemandVertex()->mCalcItem );
+            }
+        }
+        const string& name = (*marketIter->second.begin())->mName;
+        aggregateEdges( fgTemp, priceNodes, true, name + "-price-aggregation", aAggregationNodes );
+        aggregateEdges( fgTemp, demandNodes, false, name + "-demand-aggregation", aAggregationNodes );
+    }
+
     // copy the transitive reduction of the flow graph we just made into
     // the output argument
     Timer &graphtimer = TimerRegistry::getInstance().getTimer("graph-timer");
@@ -142,6 +550,84 @@ void GcamParallel::makeGCAMFlowGraph( const MarketDependencyFinder& aDependencyF
 }
 
 
+/*!
+ * \brief Route the edges shared by a set of nodes through a single new node.
+ * \details Finds the nodes which every one of aNodes has an edge to, if
+ *          aIsSources, or from otherwise.  Should there be enough of them the
+ *          complete set of edges between the two groups is replaced by edges
+ *          to and from a new MarketAggregationActivity.  Each node in either
+ *          group still depends on, or is depended on by, exactly the same
+ *          nodes as before, however the number of edges is reduced from the
+ *          product of the group sizes to their sum.
+ * \param[in,out] aGraph: The flow graph to modify.
+ * \param[in] aNodes: The nodes whose shared edges should be aggregated.
+ * \param[in] aIsSources: Whether aNodes are the origin of the shared edges.
+ * \param[in] aDescription: The description of the new activity.
+ * \param[out] aAggregationNodes: The list to which the new activity is added.
+ */
+void GcamParallel::aggregateEdges( FlowGraph& aGraph, const set<FlowGraphNodeType>& aNodes,
+                                   const bool aIsSources, const string& aDescription,
+                                   vector<IActivity*>& aAggregationNodes )
+{
+    if( aNodes.size() < 2 ) {
+        return;
+    }
+
+    // find the nodes linked to all of aNodes
+    set<FlowGraphNodeType> common;
+    for( set<FlowGraphNodeType>::const_iterator nodeIter = aNodes.begin(); nodeIter != aNodes.end(); ++nodeIter ) {
+        FlowGraph::nodelist_c_iter_t graphNode = aGraph.nodelist().find( *nodeIter );
+        if( graphNode == aGraph.nodelist().end() ) {
+            return;
+        }
+        const set<FlowGraphNodeType>& links = aIsSources ? graphNode->second.successors : graphNode->second.backlinks;
+        if( nodeIter == aNodes.begin() ) {
+            common = links;
+        }
+        else {
+            set<FlowGraphNodeType> intersection;
+            set_intersection( common.begin(), common.end(), links.begin(), links.end(),
+                              inserter( intersection, intersection.begin() ), common.key_comp() );
+            common.swap( intersection );
+        }
+        if( common.empty() ) {
+            return;
+        }
+    }
+
+    // only worthwhile if it would reduce the number of edges
+    if( aNodes.size() * common.size() <= aNodes.size() + common.size() ) {
+        return;
+    }
+
+    IActivity* aggregation = new MarketAggregationActivity( aDescription );
+    aAggregationNodes.push_back( aggregation );
+    for( set<FlowGraphNodeType>::const_iterator nodeIter = aNodes.begin(); nodeIter != aNodes.end(); ++nodeIter ) {
+        for( set<FlowGraphNodeType>::const_iterator commonIter = common.begin(); commonIter != common.end(); ++commonIter ) {
+            if( aIsSources ) {
+                aGraph.deledge( *nodeIter, *commonIter );
+            }
+            else {
+                aGraph.deledge( *commonIter, *nodeIter );
+            }
+        }
+        if( aIsSources ) {
+            aGraph.addedge( *nodeIter, aggregation );
+        }
+        else {
+            aGraph.addedge( aggregation, *nodeIter );
+        }
+    }
+    for( set<FlowGraphNodeType>::const_iterator commonIter = common.begin(); commonIter != common.end(); ++commonIter ) {
+        if( aIsSources ) {
+            aGraph.addedge( aggregation, *commonIter );
+        }
+        else {
+            aGraph.addedge( *commonIter, aggregation );
+        }
+    }
+}
+
 /*!
  * \brief Parse the GCAM flow graph and collect IActivies into computational grains 
  * \details This function collects the individual computational tasks (price and
@@ -174,6 +660,10 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
     ILogger &mainlog = ILogger::getLogger("main_log");
     mainlog.setLevel(ILogger::DEBUG);
 
+    // The graph setup is reported in the startup profile as well so that its
+    // time and memory may be compared against the rest of model startup.
+    StartupProfile& profile = StartupProfile::getInstance();
+    profile.startPhase( "flow graph parse" );
     parsetimer.start();
     FlowGraph gcamFGReduce = aGCAMFlowGraph.treduce(); // find transitive reduction of gcamfg
     gcamFGReduce.topological_sort();
@@ -181,17 +671,48 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
     ClanTree parseTree; 
     graph_parse( gcamFGReduce, 0, parseTree, mGrainSizeTarget );
     parsetimer.stop();
+    profile.endPhase( "flow graph parse" );
     
+    // If we have measured activity costs from a profiling run convert them to
+    // relative costs, indexed by topological index, so that the grains are
+    // sized by cost rather than by the number of activities.
+    profile.startPhase( "flow graph grain collect" );
+    graintimer.start();
+    vector<double> costs;
+    const ActivityCostModel& costModel = ActivityCostModel::getInstance();
+    if( costModel.hasCosts() ) {
+        const size_t numNodes = gcamFGReduce.nodelist().size();
+        costs.resize( numNodes );
+        double totalCost = 0.0;
+        int numKnown = 0;
+        for( size_t i = 0; i < numNodes; ++i ) {
+            costs[ i ] = costModel.getCost( gcamFGReduce.topological_lookup( i ) );
+            if( costs[ i ] >= 0.0 ) {
+                totalCost += costs[ i ];
+                ++numKnown;
+            }
+        }
+        const double meanCost = numKnown > 0 && totalCost > 0.0 ? totalCost / numKnown : 1.0;
+        for( size_t i = 0; i < numNodes; ++i ) {
+            // activities that were not measured get the average cost and
+            // ones too quick to measure still get a token cost
+            costs[ i ] = costs[ i ] < 0.0 ? 1.0 : max( costs[ i ] / meanCost, 1.0e-3 );
+        }
+        mainlog << "Balancing grains using " << numKnown << " of " << numNodes
+                << " measured activity costs." << endl;
+    }
+
     // Use the parse tree to roll up the node graph into a grain graph.  Start
     // with a copy of the node graph.
-    graintimer.start();
     FlowGraph grainGraphTemp = gcamFGReduce;
-    grain_collect( parseTree, parseTree.nodelist().begin(), grainGraphTemp, mGrainSizeTarget );
+    grain_collect( parseTree, parseTree.nodelist().begin(), grainGraphTemp, mGrainSizeTarget,
+                   costs.empty() ? 0 : &costs );
     
     // set the output graph to the transitive reduction of what came out of the
     // grain collection algorithm.
     aGrainGraph = grainGraphTemp.treduce();
     graintimer.stop();
+    profile.endPhase( "flow graph grain collect" );
 
     parsetimer.print(mainlog, "Graph parse in graphParseGrainCollect:  ");
     graintimer.print(mainlog, "Grain collect in graphParseGrainCollect:  ");
@@ -215,10 +736,94 @@ void GcamParallel::graphParseGrainCollect( const FlowGraph& aGCAMFlowGraph, Flow
     for( vector<FlowGraphNodeType>::const_iterator it = aCalcItems.begin(); it != aCalcItems.end(); ++it ) {
         subGraph[ *it ] = fullGraph[ *it ];
     }
+
+    // The nodes added by makeGCAMFlowGraph to aggregate multi-region markets are
+    // not themselves activities to calculate however any which follow an
+    // activity that is must be kept so the dependencies through them are not lost.
+    vector<FlowGraphNodeType> pending( aCalcItems );
+    while( !pending.empty() ) {
+        const set<FlowGraphNodeType> successors = fullGraph[ pending.back() ].successors;
+        pending.pop_back();
+        for( set<FlowGraphNodeType>::const_iterator it = successors.begin(); it != successors.end(); ++it ) {
+            if( subGraph.find( *it ) == subGraph.end() ) {
+                subGraph[ *it ] = fullGraph[ *it ];
+                pending.push_back( *it );
+            }
+        }
+    }
     FlowGraph subFlowGraph( subGraph, aGCAMFlowGraph.title() );
     graphParseGrainCollect( subFlowGraph, aGrainGraph );
 }
 
+/*!
+ * \brief Build the grain graph from grains found by an earlier call to
+ *        graphParseGrainCollect on the same flow graph.
+ * \details This skips the graph parse, which is the expensive part of grain
+ *          collection, when the grains have been cached (see
+ *          MarketDependencyFinder::getFlowGraph).  The caller is responsible
+ *          for making sure the grains partition the nodes of aGCAMFlowGraph
+ *          and were generated from an identical graph with the same grain
+ *          parameters (see getGrainKey).
+ * \param[in] aGCAMFlowGraph: The gcam flow graph generated by makeGCAMFlowGraph
+ * \param[in] aGrains: The activities in each grain.
+ * \param[out] aGrainGraph: The graph of computational grains.  On input it
+ *                          should be empty.
+ */
+void GcamParallel::collectGrains( const FlowGraph& aGCAMFlowGraph,
+                                  const vector<vector<FlowGraphNodeType> >& aGrains,
+                                  FlowGraph& aGrainGraph )
+{
+    Timer &graintimer = TimerRegistry::getInstance().getTimer("grain-timer");
+    graintimer.start();
+    FlowGraph gcamFGReduce = aGCAMFlowGraph.treduce();
+    gcamFGReduce.topological_sort();
+
+    FlowGraph grainGraphTemp = gcamFGReduce;
+    for( size_t i = 0; i < aGrains.size(); ++i ) {
+        bitvector nodes( gcamFGReduce.nodelist().size() );
+        for( size_t j = 0; j < aGrains[ i ].size(); ++j ) {
+            nodes.set( gcamFGReduce.topological_index( aGrains[ i ][ j ] ) );
+        }
+        grainGraphTemp.collapse_subgraph( gcamFGReduce.convert_to_set( nodes ),
+                                          grain_title( nodes, gcamFGReduce ) );
+    }
+    aGrainGraph = grainGraphTemp.treduce();
+    graintimer.stop();
+
+    ILogger &mainlog = ILogger::getLogger("main_log");
+    mainlog.setLevel(ILogger::DEBUG);
+    graintimer.print(mainlog, "Grain collect from cache in collectGrains:  ");
+}
+
+/*!
+ * \brief Get the activities contained in each grain of a grain graph.
+ * \param[in] aGrainGraph: A grain graph created by graphParseGrainCollect.
+ * \param[out] aGrains: The activities in each grain.
+ */
+void GcamParallel::getGrains( const FlowGraph& aGrainGraph, vector<vector<FlowGraphNodeType> >& aGrains )
+{
+    aGrains.clear();
+    for( FlowGraph::nodelist_c_iter_t gnodeIt = aGrainGraph.nodelist().begin();
+         gnodeIt != aGrainGraph.nodelist().end(); ++gnodeIt )
+    {
+        set<FlowGraphNodeType> subGraphNodes;
+        getkeys( gnodeIt->second.subgraph->nodelist(), subGraphNodes );
+        aGrains.push_back( vector<FlowGraphNodeType>( subGraphNodes.begin(), subGraphNodes.end() ) );
+    }
+}
+
+/*!
+ * \brief A key identifying the parameters which affect grain collection so
+ *        that cached grains are only reused with the same parameters.
+ * \return The key.
+ */
+size_t GcamParallel::getGrainKey() const {
+    size_t key = 0;
+    boost::hash_combine( key, mGrainSizeTarget );
+    boost::hash_combine( key, ActivityCostModel::getInstance().getHash() );
+    return key;
+}
+
 /*!
  * \brief Build the TBB flow graph for an input grain structure and topology 
  * \details This function builds a TBB flow graph for the input grain graph and
@@ -263,6 +868,13 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
     // able to find them from the node identifiers.
     map<FlowGraphNodeType, continue_node<continue_msg>* > nodeTable;
     map<FlowGraphNodeType, int> nodeSizeTable;
+    map<FlowGraphNodeType, int> nodeIdTable;
+    const bool tracing = FlowGraphTracer::getInstance().isEnabled();
+    // TBB does not report the memory it uses so approximate each node by its
+    // size and that of its body plus a list entry for each activity, and each
+    // edge by an entry in the successor and predecessor caches of the nodes.
+    const size_t listEntryBytes = 3 * sizeof( void* );
+    size_t memoryEstimate = 0;
     
     // The TBB flow graph structures don't automatically create nodes, so we'll do
     // two passes, creating nodes on the first and connecting them on the second.
@@ -281,12 +893,19 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
         // uses the topology to order the elements of the grain, but does not store
         // a reference.
         size_t nodeSize = subGraphNodes.size();
+        const int grainId = static_cast<int>( nodeIdTable.size() );
         nodeTable[ gnodeIt->first ] = new continue_node<continue_msg>( tbbFlowGraph,
-            TBBFlowGraphBody( subGraphNodes, aTopology, aTBBGraph ) );
+            TBBFlowGraphBody( subGraphNodes, aTopology, aTBBGraph, grainId ) );
         nodeSizeTable[ gnodeIt->first ] = nodeSize;
+        nodeIdTable[ gnodeIt->first ] = grainId;
+        memoryEstimate += sizeof( continue_node<continue_msg> ) + sizeof( TBBFlowGraphBody ) + nodeSize * listEntryBytes;
         pgLog << "\tContinue node: " << nodeTable[ gnodeIt->first ] << endl;
     }
     
+    if( tracing ) {
+        aTBBGraph.mGrainPredecessors.assign( nodeIdTable.size(), vector<int>() );
+    }
+
     // In the second pass, connect edges in the nodes we just created.
     // This will make the TBB flow graph isomorphic to the grain graph.
     for( FlowGraph::nodelist_c_iter_t gnodeIt= aGrainGraph.nodelist().begin();
@@ -300,6 +919,10 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
             // find the TBB flow graph nodes for the grain graph node and
             // the child node.  Connect them in the TBB flow graph.
             tbb::flow::make_edge( *nodeTable[ gnodeIt->first ], *nodeTable[ *cnodeIt ] );
+            memoryEstimate += 2 * listEntryBytes;
+            if( tracing ) {
+                aTBBGraph.mGrainPredecessors[ nodeIdTable[ *cnodeIt ] ].push_back( nodeIdTable[ gnodeIt->first ] );
+            }
             pgLog << nodeTable[ gnodeIt->first ] << "_" << nodeSizeTable[ gnodeIt->first ]
                 << " -> " << nodeTable[ *cnodeIt ] << "_" << nodeSizeTable[ *cnodeIt ] << endl;
         }
@@ -314,26 +937,68 @@ void GcamParallel::makeTBBFlowGraph( const FlowGraph& aGrainGraph, const FlowGra
         tbb::flow::make_edge( head, *nodeTable[ *srcIt ] );
         pgLog << "start node found:  " << nodeTable[ *srcIt ] << "_" << nodeSizeTable[ *srcIt ] << endl;
     }
+    for( size_t grain = 0; grain < aTBBGraph.mGrainPredecessors.size(); ++grain ) {
+        memoryEstimate += aTBBGraph.mGrainPredecessors[ grain ].capacity() * sizeof( int );
+    }
+    aTBBGraph.mMemoryEstimate = memoryEstimate;
     // TBB flow graph is ready to go.
 }
 
 void GcamParallel::TBBFlowGraphBody::operator()( tbb::flow::continue_msg aMessage )
 {
+    using namespace boost::posix_time;
+    FlowGraphTraceRun* traceRun = mGraph.mTraceRun;
+    FlowGraphTraceRun::GrainEvent event;
+    if( traceRun ) {
+        event.mGrain = mGrainId;
+        event.mSize = static_cast<int>( mNodes.size() );
+        event.mThread = tbb::this_task_arena::current_thread_index();
+        event.mStart = FlowGraphTracer::getInstance().now();
+    }
+    // All of the nodes of a grain are calculated on this thread.
+    Value::ScopedStateBinding stateBinding;
+    size_t i = 0;
     for( list<FlowGraphNodeType>::const_iterator nodeIt = mNodes.begin();
-         nodeIt != mNodes.end(); ++nodeIt )
+         nodeIt != mNodes.end(); ++nodeIt, ++i )
     {
         if( !mGraph.mCalcList ||
             find( mGraph.mCalcList->begin(), mGraph.mCalcList->end(), *nodeIt ) != mGraph.mCalcList->end() )
         {
-            (*nodeIt)->calc( mGraph.mPeriod );
+#if GCAM_TRACK_ALLOCATIONS
+            const AllocationTracker::Counts startAllocations = AllocationTracker::getThreadCounts();
+#endif
+            DeterministicReduction::ScopedActivity deterministicActivity( *nodeIt );
+            if( !mProfileCounts.empty() ) {
+                const ActivityProfiler::Clock::time_point start = ActivityProfiler::Clock::now();
+                (*nodeIt)->calc( mGraph.mPeriod );
+                ActivityProfiler::record( mProfileCounts[ i ], !mGraph.mCalcList, start );
+            }
+            else if( mCosts.empty() ) {
+                (*nodeIt)->calc( mGraph.mPeriod );
+            }
+            else {
+                ptime start = microsec_clock::universal_time();
+                (*nodeIt)->calc( mGraph.mPeriod );
+                mCosts[ i ]->add( ( microsec_clock::universal_time() - start ).total_microseconds() * 1.0e-6 );
+            }
+#if GCAM_TRACK_ALLOCATIONS
+            AllocationTracker::recordActivity( *nodeIt, startAllocations );
+#endif
         }
     }
+    if( traceRun ) {
+        event.mEnd = FlowGraphTracer::getInstance().now();
+        tbb::spin_mutex::scoped_lock lock( traceRun->mEventLock );
+        traceRun->mEvents.push_back( event );
+    }
 }
 
 GcamParallel::TBBFlowGraphBody::TBBFlowGraphBody( const std::set<FlowGraphNodeType>& aNodes,
                                                   const FlowGraph& aTopology,
-                                                  const GcamFlowGraph& aGraph )
-:mGraph( aGraph )
+                                                  const GcamFlowGraph& aGraph,
+                                                  const int aGrainId )
+:mGraph( aGraph ),
+mGrainId( aGrainId )
 {
     ILogger& pgLog = ILogger::getLogger( "parallel-grain-log" );
     pgLog.setLevel( ILogger::NOTICE );
@@ -346,6 +1011,19 @@ GcamParallel::TBBFlowGraphBody::TBBFlowGraphBody( const std::set<FlowGraphNodeTy
     
     mNodes.insert( mNodes.end(), aNodes.begin(), aNodes.end() );
     mNodes.sort( TopologicalComparator( aTopology ) );
+
+    ActivityProfiler& activityProfiler = ActivityProfiler::getInstance();
+    ActivityCostModel& costModel = ActivityCostModel::getInstance();
+    if( activityProfiler.isEnabled() ) {
+        for( list<FlowGraphNodeType>::const_iterator it = mNodes.begin(); it != mNodes.end(); ++it ) {
+            mProfileCounts.push_back( activityProfiler.getCounts( *it ) );
+        }
+    }
+    else if( costModel.isRecording() ) {
+        for( list<FlowGraphNodeType>::const_iterator it = mNodes.begin(); it != mNodes.end(); ++it ) {
+            mCosts.push_back( costModel.getCostSlot( *it ) );
+        }
+    }
     
     // log some output to allow us to analyze the parallel grain
     // structure (this allows us to see what is in the grains, but not
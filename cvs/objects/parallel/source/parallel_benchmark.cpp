@@ -0,0 +1,374 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \file parallel_benchmark.cpp
+ * \ingroup Objects
+ * \brief ParallelBenchmark class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <boost/shared_ptr.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_init.h>
+
+#include "parallel/include/parallel_benchmark.hpp"
+#include "parallel/include/gcam_parallel.hpp"
+#include "containers/include/scenario.h"
+#include "containers/include/world.h"
+#include "containers/include/market_dependency_finder.h"
+#include "marketplace/include/marketplace.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/solution_info.h"
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+#include "solution/util/include/edfun.hpp"
+#include "solution/util/include/fdjac.hpp"
+#include "util/base/include/manage_state_variables.hpp"
+#include "util/base/include/value.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/timer.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+namespace {
+    //! The solution tolerance used to set up the markets, it does not affect
+    //! the Jacobian.
+    const double SOLUTION_TOLERANCE = 0.001;
+
+    //! The solution floor used to set up the markets.
+    const double SOLUTION_FLOOR = 0.0001;
+}
+
+/*!
+ * \brief Constructor
+ * \param aPeriod The model period to benchmark.
+ * \param aSolutionInfoParamParser The solution parameters to set up the
+ *        markets with.
+ */
+ParallelBenchmark::ParallelBenchmark( const int aPeriod, const SolutionInfoParamParser* aSolutionInfoParamParser ):
+mPeriod( aPeriod ),
+mSolutionInfoParamParser( aSolutionInfoParamParser ),
+mRepeats( max( Configuration::getInstance()->getInt( "parallel-benchmark-repeats", 3, false ), 1 ) )
+{
+}
+
+/*!
+ * \brief Run the benchmark, report the results and write the best settings
+ *        if requested.
+ * \pre The state variables of the period must be collected.
+ */
+void ParallelBenchmark::run() {
+    const Configuration* conf = Configuration::getInstance();
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( conf->getBool( "parallel-numa-pinning", false, false ) ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "The parallel benchmark can not be run while threads are pinned to NUMA nodes." << endl;
+        return;
+    }
+
+    // Only as many "scratch" states as there are cores are allocated so the
+    // thread counts can not exceed it.
+    const int maxThreads = tbb::task_scheduler_init::default_num_threads();
+    vector<int> threadCounts = parseList( conf->getString( "parallel-benchmark-threads", "", false ) );
+    if( threadCounts.empty() ) {
+        for( int threads = 1; threads < maxThreads; threads *= 2 ) {
+            threadCounts.push_back( threads );
+        }
+        threadCounts.push_back( maxThreads );
+    }
+    for( auto& threads : threadCounts ) {
+        threads = min( threads, maxThreads );
+    }
+    sort( threadCounts.begin(), threadCounts.end() );
+    threadCounts.erase( unique( threadCounts.begin(), threadCounts.end() ), threadCounts.end() );
+
+    vector<int> grainSizes = parseList( conf->getString( "parallel-benchmark-grain-sizes", "", false ) );
+    if( grainSizes.empty() ) {
+        grainSizes.push_back( GcamParallel().getGrainSizeTarget() );
+    }
+
+    // Save the starting state so that it may be restored for the period to be
+    // solved as usual.
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    stringstream startState( ios::in | ios::out | ios::binary );
+    stateVars->writeState( startState );
+    const int poolConcurrency = stateVars->mThreadPool.max_concurrency();
+
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running the parallel benchmark for " << grainSizes.size() << " grain sizes on up to "
+            << threadCounts.back() << " threads." << endl;
+    vector<Result> results;
+    for( const int threads : threadCounts ) {
+        const double jacobianSeconds = timeJacobian( threads );
+        for( const int grainSize : grainSizes ) {
+            Result result;
+            result.mThreads = threads;
+            result.mGrainSize = grainSize;
+            result.mCalcSeconds = timeCalc( threads, grainSize );
+            result.mJacobianSeconds = jacobianSeconds;
+            results.push_back( result );
+        }
+    }
+
+    const double unboundSeconds = timeStateAccess( false );
+    const double boundSeconds = timeStateAccess( true );
+
+    stateVars->mThreadPool.terminate();
+    stateVars->mThreadPool.initialize( poolConcurrency );
+    startState.clear();
+    startState.seekg( 0 );
+    stateVars->readState( startState );
+
+    report( results );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Serial scratch state calc seconds without state binding: " << unboundSeconds
+            << ", with state binding: " << boundSeconds << ", speedup: "
+            << ( boundSeconds > 0 ? unboundSeconds / boundSeconds : 0 ) << endl;
+    const Result& best = *min_element( results.begin(), results.end(), []( const Result& aLHS, const Result& aRHS ) {
+        return aLHS.mCalcSeconds + aLHS.mJacobianSeconds < aRHS.mCalcSeconds + aRHS.mJacobianSeconds;
+    } );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Fastest parallel settings: " << best.mThreads << " threads with a grain size of "
+            << best.mGrainSize << "." << endl;
+    if( conf->shouldWriteFile( "parallel-tuning", false, false ) ) {
+        writeTuning( best );
+    }
+}
+
+/*!
+ * \brief Parse a comma separated list of positive integers.
+ * \param aList The list to parse.
+ * \return The integers in the list, any which are not positive are skipped.
+ */
+vector<int> ParallelBenchmark::parseList( const string& aList ) {
+    vector<int> values;
+    istringstream in( aList );
+    string item;
+    while( getline( in, item, ',' ) ) {
+        const int value = atoi( item.c_str() );
+        if( value > 0 ) {
+            values.push_back( value );
+        }
+    }
+    return values;
+}
+
+/*!
+ * \brief Time a full model calculation using a flow graph with the given grain
+ *        size.
+ * \param aThreads The number of threads to calculate with.
+ * \param aGrainSize The target grain size of the flow graph.
+ * \return The average time of a calculation in seconds.
+ */
+double ParallelBenchmark::timeCalc( const int aThreads, const int aGrainSize ) {
+    World* world = scenario->getWorld();
+    Marketplace* marketplace = scenario->getMarketplace();
+    tbb::task_arena arena( aThreads );
+    double seconds = 0;
+    arena.execute( [&]() {
+        // The graph must be made within the arena so that it runs on the
+        // arena's threads.
+        boost::shared_ptr<GcamFlowGraph> flowGraph = marketplace->getDependencyFinder()->createFlowGraph( aGrainSize );
+
+        // Do not time the first calculation which starts the threads.
+        marketplace->nullSuppliesAndDemands( mPeriod );
+        world->calc( mPeriod, flowGraph.get() );
+        Timer calcTimer;
+        calcTimer.start();
+        for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+            marketplace->nullSuppliesAndDemands( mPeriod );
+            world->calc( mPeriod, flowGraph.get() );
+        }
+        calcTimer.stop();
+        seconds = calcTimer.getTotalTimeDifference() / mRepeats;
+    } );
+    return seconds;
+}
+
+/*!
+ * \brief Time a Jacobian of the markets which would be solved by
+ *        Newton-Raphson at the current prices.
+ * \param aThreads The number of threads to calculate the partial derivatives
+ *        with.
+ * \return The average time of a Jacobian in seconds.
+ */
+double ParallelBenchmark::timeJacobian( const int aThreads ) {
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    stateVars->mThreadPool.terminate();
+    stateVars->mThreadPool.initialize( aThreads );
+
+    World* world = scenario->getWorld();
+    Marketplace* marketplace = scenario->getMarketplace();
+    SolutionInfoSet solutionSet( marketplace );
+    solutionSet.init( mPeriod, SOLUTION_TOLERANCE, SOLUTION_FLOOR, mSolutionInfoParamParser );
+    SolvableNRSolutionInfoFilter solvableFilter;
+    solutionSet.updateSolvable( &solvableFilter );
+    const size_t numSolvable = solutionSet.getNumSolvable();
+    if( numSolvable == 0 ) {
+        return 0;
+    }
+
+    LogEDFun F( solutionSet, world, marketplace, mPeriod );
+    boost::numeric::ublas::vector<double> x( numSolvable ), fx( numSolvable );
+    const vector<SolutionInfo> solvables = solutionSet.getSolvableSet();
+    for( size_t i = 0; i < numSolvable; ++i ) {
+        x[ i ] = log( max( solvables[ i ].getPrice(), util::getTinyNumber() ) );
+    }
+    F.scaleInitInputs( x );
+    F( x, fx );
+
+    boost::numeric::ublas::matrix<double> J( numSolvable, numSolvable );
+    Timer jacobianTimer;
+    jacobianTimer.start();
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        fdjac( F, x, fx, J, true );
+    }
+    jacobianTimer.stop();
+    return jacobianTimer.getTotalTimeDifference() / mRepeats;
+}
+
+/*!
+ * \brief Time a serial model calculation in a "scratch" state with or without
+ *        binding the thread's state for the STATE Value accesses.
+ * \details The partial derivative mode is used so that every STATE Value access
+ *          must locate the calling thread's "scratch" state unless it is bound.
+ * \param aBindState Whether Value::ScopedStateBinding should bind the state.
+ * \return The average time of a calculation in seconds.
+ */
+double ParallelBenchmark::timeStateAccess( const bool aBindState ) {
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    World* world = scenario->getWorld();
+    const bool wasEnabled = Value::ScopedStateBinding::isEnabled();
+    Value::ScopedStateBinding::setEnabled( aBindState );
+    stateVars->setPartialDeriv( true );
+
+    // Do not time the first calculation which sets up the state of the thread.
+    stateVars->copyState();
+    world->calc( mPeriod );
+    Timer calcTimer;
+    calcTimer.start();
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        stateVars->copyState();
+        world->calc( mPeriod );
+    }
+    calcTimer.stop();
+
+    stateVars->setPartialDeriv( false );
+    Value::ScopedStateBinding::setEnabled( wasEnabled );
+    return calcTimer.getTotalTimeDifference() / mRepeats;
+}
+
+/*!
+ * \brief Print the times, speedups and efficiencies to the main log and write
+ *        them to the "parallel-benchmark" file if requested.
+ * \details Speedups are relative to the fewest threads measured with the same
+ *          grain size and efficiency is the speedup divided by the increase in
+ *          threads.
+ * \param aResults The results of the benchmark ordered by thread count.
+ */
+void ParallelBenchmark::report( const vector<Result>& aResults ) const {
+    const Configuration* conf = Configuration::getInstance();
+    const bool writeFile = conf->shouldWriteFile( "parallel-benchmark", false, false );
+    ofstream out;
+    if( writeFile ) {
+        out.open( conf->getFile( "parallel-benchmark" ).c_str() );
+        out << "threads,grain-size,calc-seconds,calc-speedup,calc-efficiency,"
+            << "jacobian-seconds,jacobian-speedup,jacobian-efficiency" << endl;
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Parallel benchmark (threads, grain size, calc seconds, speedup, efficiency, "
+            << "Jacobian seconds, speedup, efficiency):" << endl;
+    for( const Result& curr : aResults ) {
+        const Result& base = *find_if( aResults.begin(), aResults.end(), [&curr]( const Result& aResult ) {
+            return aResult.mGrainSize == curr.mGrainSize;
+        } );
+        const double threadRatio = static_cast<double>( curr.mThreads ) / base.mThreads;
+        const double calcSpeedup = curr.mCalcSeconds > 0 ? base.mCalcSeconds / curr.mCalcSeconds : 0;
+        const double jacobianSpeedup = curr.mJacobianSeconds > 0 ? base.mJacobianSeconds / curr.mJacobianSeconds : 0;
+        mainLog << curr.mThreads << ", " << curr.mGrainSize << ", " << curr.mCalcSeconds << ", "
+                << calcSpeedup << ", " << calcSpeedup / threadRatio << ", " << curr.mJacobianSeconds << ", "
+                << jacobianSpeedup << ", " << jacobianSpeedup / threadRatio << endl;
+        if( writeFile ) {
+            out << curr.mThreads << ',' << curr.mGrainSize << ',' << curr.mCalcSeconds << ','
+                << calcSpeedup << ',' << calcSpeedup / threadRatio << ',' << curr.mJacobianSeconds << ','
+                << jacobianSpeedup << ',' << jacobianSpeedup / threadRatio << endl;
+        }
+    }
+    if( writeFile && !out ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write the parallel benchmark to " << conf->getFile( "parallel-benchmark" ) << "." << endl;
+    }
+}
+
+/*!
+ * \brief Write the given settings to the "parallel-tuning" file as a
+ *        configuration fragment.
+ * \param aBest The settings to write.
+ */
+void ParallelBenchmark::writeTuning( const Result& aBest ) const {
+    const string& fileName = Configuration::getInstance()->getFile( "parallel-tuning" );
+    ofstream out( fileName.c_str() );
+    out << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << endl
+        << "<Configuration>" << endl
+        << "\t<Ints>" << endl
+        << "\t\t<Value name=\"parallel-threads\">" << aBest.mThreads << "</Value>" << endl
+        << "\t\t<Value name=\"parallel-grain-size\">" << aBest.mGrainSize << "</Value>" << endl
+        << "\t</Ints>" << endl
+        << "</Configuration>" << endl;
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( !out ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write the parallel tuning to " << fileName << "." << endl;
+    }
+    else {
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Wrote the parallel tuning to " << fileName << "." << endl;
+    }
+}
+
+#endif // GCAM_PARALLEL_ENABLED
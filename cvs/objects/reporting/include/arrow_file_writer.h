@@ -0,0 +1,137 @@
+#ifndef _ARROW_FILE_WRITER_H_
+#define _ARROW_FILE_WRITER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file arrow_file_writer.h
+* \ingroup Objects
+* \brief ArrowFileWriter class header file.
+*/
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <boost/core/noncopyable.hpp>
+
+/*!
+* \ingroup Objects
+* \brief Writes a table to a file in the Apache Arrow IPC file format.
+* \details The table is written as a sequence of record batches so that the
+*          caller may stream it out in pieces without ever holding all of the
+*          rows.  Only the column types needed by the model output are
+*          supported: UTF-8 strings, 32 bit integers and doubles, all of which
+*          are written without nulls or compression.  The flatbuffer encoded
+*          metadata is produced directly so that no Arrow or flatbuffers
+*          library is required; the resulting files may be read by any Arrow
+*          implementation, for instance with pyarrow.ipc.open_file or the
+*          arrow R package.
+*/
+class ArrowFileWriter : private boost::noncopyable {
+public:
+    //! The supported column types.
+    enum ColumnType {
+        UTF8,
+        INT32,
+        FLOAT64
+    };
+
+    /*!
+     * \brief A single column of a record batch.
+     * \details Only the vector corresponding to the column type is used.
+     */
+    struct Column {
+        Column( const std::string& aName, const ColumnType aType );
+
+        size_t size() const;
+
+        void clear();
+
+        //! The name of the column.
+        std::string mName;
+
+        //! The type of the column.
+        ColumnType mType;
+
+        //! The values of a UTF8 column.
+        std::vector<std::string> mStrings;
+
+        //! The values of an INT32 column.
+        std::vector<int> mInts;
+
+        //! The values of a FLOAT64 column.
+        std::vector<double> mDoubles;
+    };
+
+    ArrowFileWriter( const std::string& aFileName, const std::vector<Column>& aSchema );
+
+    ~ArrowFileWriter();
+
+    bool isOpen() const;
+
+    bool writeBatch( const std::vector<Column>& aColumns );
+
+    bool close();
+private:
+    //! The location and size of a message written to the file.
+    struct Block {
+        //! The offset of the message in the file.
+        long long mOffset;
+
+        //! The size of the message metadata including its prefix and padding.
+        int mMetadataLength;
+
+        //! The size of the message body.
+        long long mBodyLength;
+    };
+
+    long long writeMessage( const std::string& aMetadata, const std::string& aBody );
+
+    //! The file being written.
+    std::ofstream mFile;
+
+    //! The names and types of the columns.
+    std::vector<Column> mSchema;
+
+    //! The record batches written so far which are indexed in the footer.
+    std::vector<Block> mRecordBatches;
+
+    //! Whether the footer has been written.
+    bool mIsClosed;
+};
+
+#endif // _ARROW_FILE_WRITER_H_
@@ -0,0 +1,177 @@
+#ifndef _ARROW_OUTPUTTER_H_
+#define _ARROW_OUTPUTTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file arrow_outputter.h
+* \ingroup Objects
+* \brief ArrowOutputter class header file.
+*/
+
+#include <string>
+#include <vector>
+#include "util/base/include/default_visitor.h"
+#include "reporting/include/arrow_file_writer.h"
+
+class Scenario;
+
+/*! 
+* \ingroup Objects
+* \brief A visitor which writes the main model results to an Arrow IPC file as
+*        a single long format table.
+* \details This is an alternative to the XMLDBOutputter which needs neither
+*          Java nor the XML database and never builds the whole output in
+*          memory.  Each scenario is written to its own file, named after the
+*          scenario, in the directory given by the "arrow-output-location"
+*          configuration file.  The model is visited one period at a time and
+*          the rows for each period are written as a record batch as soon as
+*          the visit is complete.
+*
+*          The table has the columns region, sector, subsector, technology,
+*          vintage, variable, name, year, value and unit.  The variables
+*          written are:
+*          - market price, supply and demand by good, in the market region;
+*          - resource production;
+*          - technology output and physical input demand by good;
+*          - emissions by gas from technologies and resources;
+*          - land allocation by land leaf;
+*          - global CO2 concentration, total forcing and temperature.
+*
+*          When the boolean configuration value "incremental-output" is set
+*          each period is instead written by the Scenario to its own complete
+*          file, named after the scenario and year, as soon as the period has
+*          solved so that results may be queried while the model is still
+*          running.  Periods with identical rows may then also share a
+*          single block file, see writePeriod.
+*
+*          Zero values are skipped as they are by the XMLDBOutputter, and
+*          columns which do not apply to a row are empty, or zero for vintage.
+*/
+class ArrowOutputter : public DefaultVisitor {
+public:
+    explicit ArrowOutputter( const std::string& aFileName );
+
+    ~ArrowOutputter();
+
+    static bool writeScenario( const Scenario* aScenario, const std::string& aLocation );
+
+    static bool writePeriod( const Scenario* aScenario, const std::string& aLocation, const int aPeriod );
+
+    bool finishPeriod();
+
+    bool finish();
+
+    // IVisitor methods
+    virtual void startVisitRegion( const Region* aRegion, const int aPeriod );
+
+    virtual void endVisitRegion( const Region* aRegion, const int aPeriod );
+
+    virtual void startVisitResource( const AResource* aResource, const int aPeriod );
+
+    virtual void endVisitResource( const AResource* aResource, const int aPeriod );
+
+    virtual void startVisitSector( const Sector* aSector, const int aPeriod );
+
+    virtual void endVisitSector( const Sector* aSector, const int aPeriod );
+
+    virtual void startVisitSubsector( const Subsector* aSubsector, const int aPeriod );
+
+    virtual void endVisitSubsector( const Subsector* aSubsector, const int aPeriod );
+
+    virtual void startVisitTechnology( const Technology* aTechnology, const int aPeriod );
+
+    virtual void endVisitTechnology( const Technology* aTechnology, const int aPeriod );
+
+    virtual void startVisitInput( const IInput* aInput, const int aPeriod );
+
+    virtual void startVisitOutput( const IOutput* aOutput, const int aPeriod );
+
+    virtual void startVisitGHG( const AGHG* aGHG, const int aPeriod );
+
+    virtual void startVisitMarket( const Market* aMarket, const int aPeriod );
+
+    virtual void startVisitLandLeaf( const LandLeaf* aLandLeaf, const int aPeriod );
+
+    virtual void startVisitClimateModel( const IClimateModel* aClimateModel, const int aPeriod );
+private:
+    //! The index of each column of the table.
+    enum ColumnIndex {
+        REGION,
+        SECTOR,
+        SUBSECTOR,
+        TECHNOLOGY,
+        VINTAGE,
+        VARIABLE,
+        NAME,
+        YEAR,
+        VALUE,
+        UNIT
+    };
+
+    static std::vector<ArrowFileWriter::Column> createColumns();
+
+    std::string hashRows() const;
+
+    void addRow( const std::string& aVariable, const std::string& aName,
+                 const int aPeriod, const double aValue, const std::string& aUnit );
+
+    const std::string& getOutputUnit( const std::string& aGoodName, const int aPeriod ) const;
+
+    //! The rows of the period being visited.
+    std::vector<ArrowFileWriter::Column> mColumns;
+
+    //! The file the results are written to.
+    ArrowFileWriter mWriter;
+
+    //! The name of the current region.
+    std::string mCurrentRegion;
+
+    //! The name of the current sector or resource.
+    std::string mCurrentSector;
+
+    //! The name of the current subsector.
+    std::string mCurrentSubsector;
+
+    //! The name of the current technology.
+    std::string mCurrentTechnology;
+
+    //! The vintage of the current technology.
+    int mCurrentVintage;
+};
+
+#endif // _ARROW_OUTPUTTER_H_
@@ -0,0 +1,98 @@
+#ifndef _ASYNC_OUTPUT_SINK_H_
+#define _ASYNC_OUTPUT_SINK_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file async_output_sink.h
+* \ingroup Objects
+* \brief AsyncOutputSink class header file.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <string>
+#include <functional>
+#include <boost/shared_ptr.hpp>
+#include <boost/iostreams/categories.hpp>
+
+/*! 
+* \ingroup Objects
+* \brief A boost iostreams sink which hands data to a writer thread.
+* \details Data written to the sink is collected into chunks of a fixed size
+*          which are put on a queue of bounded length.  A dedicated thread
+*          takes chunks off the queue and passes them to the writer function,
+*          so that producing the output and the often slow writes to their
+*          destination overlap.  When the queue is full a write blocks until
+*          the writer thread has made room which bounds the memory used no
+*          matter how far the writes fall behind.
+*
+*          Closing the sink writes the last partial chunk and waits for the
+*          writer thread to finish.  The writer function is only ever called
+*          from the writer thread, and the optional exit function is called
+*          on the writer thread once the last chunk is written, for instance
+*          to detach the thread from a JVM.
+*
+*          Copies of the sink share the same queue and thread as is required
+*          for a device in a boost iostreams chain.
+*/
+class AsyncOutputSink {
+public:
+    typedef char char_type;
+    //! The device is a sink which must be closed to flush the queue.
+    struct category : boost::iostreams::sink_tag, boost::iostreams::closable_tag {};
+
+    //! The function which writes a block of data.
+    typedef std::function<void( const char*, std::streamsize )> WriteFunction;
+
+    AsyncOutputSink( const WriteFunction& aWriter, const std::function<void()>& aOnWriterExit,
+                     const std::streamsize aChunkSize, const size_t aMaxChunks );
+
+    std::streamsize write( const char* aData, std::streamsize aLength );
+
+    void close();
+private:
+    struct Impl;
+
+    //! The queue and writer thread which are shared by copies of the sink.
+    boost::shared_ptr<Impl> mImpl;
+};
+
+#endif // GCAM_PARALLEL_ENABLED
+
+#endif // _ASYNC_OUTPUT_SINK_H_
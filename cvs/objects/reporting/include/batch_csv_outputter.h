@@ -59,10 +59,16 @@ class BatchCSVOutputter : public DefaultVisitor {
 public:
     BatchCSVOutputter();
 
+    explicit BatchCSVOutputter( const std::string& aFileName );
+
     ~BatchCSVOutputter();
 
     void writeDidScenarioSolve( bool aDidSolve );
 
+    void appendFile( const std::string& aFileName );
+
+    void appendRows( std::istream& aIn );
+
     //! IVisitor methods
     void startVisitScenario( const Scenario* aScenario, const int aPeriod );
 
@@ -44,10 +44,10 @@
  * \author Josh Lurz
  */
 #include "util/base/include/default_visitor.h"
-#include "util/base/include/time_vector.h"
 #include "util/base/include/value.h"
 #include <map>
 #include <string>
+#include <vector>
 
 /*! 
  * \ingroup Objects
@@ -86,19 +86,22 @@ public:
     void startVisitTechnology( const Technology* aTechnology,
                                const int aPeriod );
 private:
-    /*!
-     * \brief Storage type for the coefficients that contains one value per
-     *        sector and period.
-     * \todo Convert to a one period storage structure once the Access database
-     *       is removed.
-     */
-    typedef std::map<std::string, objects::PeriodVector<Value> > DoubleMap;
-    
-    //! Map of sector name to upstream emissions coefficient.
-    DoubleMap mUpstreamEmissionsCoefficients;
+    int getSectorIndex( const std::string& aSector ) const;
+
+    //! The row of each sector in the coefficient tables.
+    std::map<std::string, int> mSectorIndices;
+
+    //! The number of periods in each row of the tables.
+    int mNumPeriods;
+
+    //! Upstream emissions coefficients by sector row and period.
+    std::vector<Value> mUpstreamEmissionsCoefficients;
+
+    //! Indirect emissions by sector row and period.
+    std::vector<Value> mIndirectEmissions;
 
-    //! Map of sector name to indirect emissions.
-    DoubleMap mIndirectEmissions;
+    //! The row of the current sector.
+    int mCurrSectorIndex;
 
     //! Current sector name.
     std::string mCurrSectorName;
@@ -0,0 +1,85 @@
+#ifndef _QUERY_OUTPUT_FILTER_H_
+#define _QUERY_OUTPUT_FILTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file query_output_filter.h
+* \ingroup Objects
+* \brief QueryOutputFilter class header file.
+*/
+
+#include <string>
+#include <set>
+#include <xercesc/dom/DOMNode.hpp>
+#include "util/base/include/iparsable.h"
+
+/*! 
+* \ingroup Objects
+* \brief The set of output element names which a list of queries reads.
+* \details The filter is parsed from a ModelInterface batch query file.  The
+*          text of every xPath, axis1 and axis2 element, at any depth, is
+*          scanned for the element names the query steps through and these
+*          are collected.  The XMLDBOutputter then only writes the data
+*          values whose element name was collected.  Container elements such
+*          as sectors and technologies are still written whenever they have
+*          any data, so the names, types and attributes which queries match
+*          on are unchanged.
+*
+*          Collection errs on the side of keeping data: any name in a path
+*          which is not a quoted string, an attribute or a function call is
+*          kept.
+*/
+class QueryOutputFilter : public IParsable {
+public:
+    QueryOutputFilter();
+
+    virtual bool XMLParse( const xercesc::DOMNode* aNode );
+
+    bool isRequired( const std::string& aElementName ) const;
+
+    size_t getNumRequired() const;
+private:
+    void parseQueryNode( const xercesc::DOMNode* aNode );
+
+    void addPath( const std::string& aPath );
+
+    //! The names of the elements read by the queries.
+    std::set<std::string> mRequiredNames;
+};
+
+#endif // _QUERY_OUTPUT_FILTER_H_
@@ -0,0 +1,135 @@
+#ifndef _QUERY_SUMMARY_WRITER_H_
+#define _QUERY_SUMMARY_WRITER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file query_summary_writer.h
+* \ingroup Objects
+* \brief QuerySummaryWriter class header file.
+*/
+
+#include <map>
+#include <string>
+#include <vector>
+#include <xercesc/dom/DOMNode.hpp>
+#include "util/base/include/iparsable.h"
+
+class Scenario;
+struct FilterStep;
+
+/*! 
+* \ingroup Objects
+* \brief Evaluates a list of GCAMFusion queries against the model in memory and
+*        writes their totals to a CSV file.
+* \details This allows the standard results to be summarized at the end of a
+*          run without writing the XML database and scanning it with the Java
+*          query processor.  The query file has the form:
+*
+*          <summary-queries>
+*              <query title="CO2 emissions by region" group-by="1">
+*                  world/region/sector/subsector/technology/ghg[NamedFilter,StringEquals,CO2]/emissions
+*              </query>
+*          </summary-queries>
+*
+*          where the text of each query is a GCAMFusion filter string.  Every
+*          Value or double matched is added to the total of its year and group.
+*          The year of an array element is that of its index while the year
+*          of a single value is that of the closest enclosing container with a
+*          year, such as a technology vintage.  Note that a query which selects
+*          single elements of an array, such as with a YearFilter, loses their
+*          years so queries should match whole arrays.  The group is the names of the
+*          containers stepped into at the comma separated depths given by
+*          group-by, counting the first step of the query as zero.  Queries
+*          without group-by are totaled over all of the containers matched.
+*/
+class QuerySummaryWriter : public IParsable {
+public:
+    QuerySummaryWriter();
+    ~QuerySummaryWriter();
+
+    virtual bool XMLParse( const xercesc::DOMNode* aNode );
+
+    void write( Scenario* aScenario, const std::string& aFileName );
+
+    size_t getNumQueries() const;
+
+    // Templated callbacks for GCAMFusion
+    template<typename DataType>
+    void processData( DataType& aData );
+    template<typename DataType>
+    void pushFilterStep( const DataType& aData );
+    template<typename DataType>
+    void popFilterStep( const DataType& aData );
+private:
+    //! A single parsed query.
+    struct Query {
+        //! The title to report the results under.
+        std::string mTitle;
+
+        //! The parsed steps of the query.
+        std::vector<FilterStep*> mFilterSteps;
+
+        //! The depths of the containers whose names make up the group.
+        std::vector<size_t> mGroupDepths;
+    };
+
+    void addValue( const double aValue, const int aYear );
+
+    //! The queries in the order they were parsed.
+    std::vector<Query> mQueries;
+
+    //! The query currently being evaluated.
+    const Query* mCurrQuery;
+
+    //! The names of the containers currently being visited, empty for those
+    //! which are not named.
+    std::vector<std::string> mNameStack;
+
+    //! The years of the containers currently being visited, -1 for those
+    //! which do not have a year.
+    std::vector<int> mYearStack;
+
+    //! The totals of the current query by group and year.
+    std::map<std::pair<std::string, int>, double> mTotals;
+
+    // Not copyable since the filter steps are owned.
+    QuerySummaryWriter( const QuerySummaryWriter& );
+    QuerySummaryWriter& operator=( const QuerySummaryWriter& );
+};
+
+#endif // _QUERY_SUMMARY_WRITER_H_
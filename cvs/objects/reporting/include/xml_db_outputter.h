@@ -45,31 +45,42 @@
 */
 
 #include <stack>
+#include <set>
 #include <memory>
 #include <iosfwd>
 #include <boost/iostreams/filtering_stream.hpp>
+#include <string>
+#include <boost/shared_ptr.hpp>
 #include "util/base/include/default_visitor.h"
+#include "util/base/include/iparallel_region_visitor.h"
 
 #if( __HAVE_JAVA__ )
 #include <jni.h>
 #include <boost/iostreams/concepts.hpp>
 #endif
 
-class IndirectEmissionsCalculator;
+class QueryOutputFilter;
 
 /*! 
 * \ingroup Objects
 * \brief A visitor which writes model results to an XML database.
-* \details
+* \details If the "xmldb-query-filter" configuration file is set to a batch
+*          query file only the data elements which those queries read are
+*          written, see QueryOutputFilter.  Regions may be visited
+*          concurrently with each region written to a buffer of its own.
 * \author Josh Lurz
 */
 
-class XMLDBOutputter : public DefaultVisitor {
+class XMLDBOutputter : public DefaultVisitor, public IParallelRegionVisitor {
 public:
     XMLDBOutputter();
 
     ~XMLDBOutputter();
 
+    // IParallelRegionVisitor methods
+    virtual IVisitor* createRegionVisitor() const;
+    virtual void mergeRegionVisitor( IVisitor* aRegionVisitor );
+
     static bool checkJavaWorking();
 
     void finish() const;
@@ -267,8 +278,15 @@ private:
     //! database.
     std::stack<std::iostream*> mBufferStack;
 
-    //! Indirect emissions calculator for the current region.
-    std::auto_ptr<IndirectEmissionsCalculator> mIndirectEmissCalc;
+    //! The data elements to write or null to write all of them, shared with
+    //! any region visitors.
+    boost::shared_ptr<QueryOutputFilter> mQueryFilter;
+
+    //! The climate model outputs to write, all of them if empty.
+    std::set<std::string> mClimateOutputVariables;
+
+    //! The output of a region visitor which is held until it is merged.
+    std::string mRegionData;
 
 #if( __HAVE_JAVA__ )
     /*!
@@ -303,6 +321,8 @@ private:
 #endif
     static const std::string createContainerName( const std::string& aScenarioName );
 
+    XMLDBOutputter( const XMLDBOutputter* aParent );
+
     void writeItemToBuffer( const double aValue,
         const std::string& aName,
         std::ostream& out,
@@ -320,7 +340,14 @@ private:
         const double aValue,
         const int aYear );
 
+    void writeClimateItem( const std::string& aName,
+        const std::string& aUnit,
+        const double aValue,
+        const int aYear );
+
     bool isTechnologyOperating( const int aPeriod );
+
+    bool isRequired( const std::string& aElementName ) const;
     
     std::iostream* popBufferStack();
     
@@ -336,6 +363,8 @@ private:
      *          of memory to keep the XML document in memory at any point.  Using
      *          the boost::iostreams interface to accomplish this is much easier
      *          and less error prone than trying to do it in the std::iostream.
+     * \note The sink must only be written to from the thread which owns the
+     *       Java environment it was created with.
      * \note If an error is raised while trying to write the data to the DB the
      *       error flag in this class will be set.  Since there is no way to stop
      *       visiting once it has starting the best we can do is ignore all data
@@ -343,20 +372,24 @@ private:
      */
     class SendToJavaIOSink : public boost::iostreams::sink {
     public:
-        SendToJavaIOSink( const JNIContainer* aJNIContainer );
+        SendToJavaIOSink( const JNIContainer* aJNIContainer, JNIEnv* aJavaEnv );
         virtual ~SendToJavaIOSink();
         
         // boost::iostreams::sink methods
         virtual std::streamsize write( const char* aData, std::streamsize aLength );
+
+        //! The size of the blocks of data sent to Java.
+        static const std::streamsize BUFFER_SIZE;
     private:
         //! A weak pointer to the JNIContainer to communicate with Java
         const JNIContainer* mJNIContainer;
 
+        //! The Java environment of the thread which writes to this sink.
+        JNIEnv* mJavaEnv;
+
         //! A JNI method ID to the Java method that will receive the data.
         jmethodID mReceiveDataMID;
 
-        const std::streamsize BUFFER_SIZE;
-
         //! A JNI buffer that can be data can be put in to send to Java.
         jbyteArray mJNIBuffer;
 
@@ -0,0 +1,566 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file arrow_file_writer.cpp
+* \ingroup Objects
+* \brief ArrowFileWriter class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+
+#include "reporting/include/arrow_file_writer.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    /*
+     * The Arrow metadata is a set of flatbuffers.  A flatbuffer is a tree of
+     * tables, strings and vectors in which each reference is an unsigned
+     * offset forward from the referring location.  The classes below build
+     * such a tree and lay it out front to back, parents before children, which
+     * is all that is needed for the few small messages written here.  Values
+     * are written in the byte order of the host which is assumed to be little
+     * endian as is declared in the schema.
+     */
+    class FlatNode;
+    typedef boost::shared_ptr<FlatNode> FlatNodePtr;
+
+    //! A flatbuffer table, string or vector.
+    class FlatNode {
+    public:
+        //! The kind of flatbuffer object.
+        enum Kind {
+            TABLE,
+            STRING,
+            TABLE_VECTOR,
+            STRUCT_VECTOR
+        };
+
+        //! A field of a table which is either a scalar or a reference.
+        struct Field {
+            //! The index of the field in the schema of the table.
+            uint16_t mId;
+
+            //! The size of the scalar, or of the offset for a reference.
+            size_t mSize;
+
+            //! The bytes of a scalar.
+            char mBytes[ 8 ];
+
+            //! The referenced object or null for a scalar.
+            FlatNodePtr mChild;
+        };
+
+        static FlatNodePtr createTable() {
+            return FlatNodePtr( new FlatNode( TABLE ) );
+        }
+
+        static FlatNodePtr createString( const string& aValue ) {
+            FlatNodePtr node( new FlatNode( STRING ) );
+            node->mBytes = aValue;
+            return node;
+        }
+
+        static FlatNodePtr createTableVector() {
+            return FlatNodePtr( new FlatNode( TABLE_VECTOR ) );
+        }
+
+        static FlatNodePtr createStructVector() {
+            return FlatNodePtr( new FlatNode( STRUCT_VECTOR ) );
+        }
+
+        template<class T>
+        FlatNode& addScalar( const uint16_t aId, const T aValue ) {
+            assert( mKind == TABLE );
+            Field field;
+            field.mId = aId;
+            field.mSize = sizeof( T );
+            memcpy( field.mBytes, &aValue, sizeof( T ) );
+            mFields.push_back( field );
+            return *this;
+        }
+
+        FlatNode& addChild( const uint16_t aId, const FlatNodePtr& aChild ) {
+            assert( mKind == TABLE );
+            Field field;
+            field.mId = aId;
+            field.mSize = sizeof( uint32_t );
+            field.mChild = aChild;
+            mFields.push_back( field );
+            return *this;
+        }
+
+        void addElement( const FlatNodePtr& aElement ) {
+            assert( mKind == TABLE_VECTOR );
+            mElements.push_back( aElement );
+        }
+
+        //! Add a struct made up of eight byte aligned members.
+        void addStruct( const void* aStruct, const size_t aSize ) {
+            assert( mKind == STRUCT_VECTOR && aSize % 8 == 0 );
+            mBytes.append( static_cast<const char*>( aStruct ), aSize );
+            ++mCount;
+        }
+
+        //! The kind of object.
+        const Kind mKind;
+
+        //! The fields of a table.
+        vector<Field> mFields;
+
+        //! The elements of a vector of tables.
+        vector<FlatNodePtr> mElements;
+
+        //! The characters of a string or the structs of a vector of structs.
+        string mBytes;
+
+        //! The number of structs in a vector of structs.
+        uint32_t mCount;
+    private:
+        explicit FlatNode( const Kind aKind ):mKind( aKind ), mCount( 0 ) {
+        }
+    };
+
+    //! Orders fields from the largest to the smallest to reduce padding.
+    bool isLargerField( const FlatNode::Field& aLHS, const FlatNode::Field& aRHS ) {
+        return aLHS.mSize > aRHS.mSize;
+    }
+
+    //! Lays out a tree of FlatNodes as a flatbuffer.
+    class FlatSerializer {
+    public:
+        /*!
+         * \brief Create a flatbuffer with the given root table.
+         * \param aRoot The root table.
+         * \return The bytes of the flatbuffer.
+         */
+        static string serialize( const FlatNode& aRoot ) {
+            FlatSerializer serializer;
+            serializer.put<uint32_t>( 0 );
+            serializer.patchOffset( 0, serializer.write( aRoot ) );
+            return serializer.mBuffer;
+        }
+    private:
+        template<class T>
+        void put( const T aValue ) {
+            mBuffer.append( reinterpret_cast<const char*>( &aValue ), sizeof( T ) );
+        }
+
+        //! Pad until the buffer size is aRemainder modulo aAlignment.
+        void pad( const size_t aAlignment, const size_t aRemainder = 0 ) {
+            while( mBuffer.size() % aAlignment != aRemainder ) {
+                mBuffer += '\0';
+            }
+        }
+
+        void patchOffset( const size_t aLocation, const size_t aTarget ) {
+            assert( aTarget > aLocation );
+            const uint32_t offset = static_cast<uint32_t>( aTarget - aLocation );
+            memcpy( &mBuffer[ aLocation ], &offset, sizeof( offset ) );
+        }
+
+        /*!
+         * \brief Write a node followed by the objects it references.
+         * \param aNode The node to write.
+         * \return The location a reference to the node must point to.
+         */
+        size_t write( const FlatNode& aNode ) {
+            size_t location = 0;
+            switch( aNode.mKind ) {
+                case FlatNode::TABLE: {
+                    // The vtable holds its own size, the size of the table and
+                    // the offset of each field from the start of the table.
+                    uint16_t numSlots = 0;
+                    for( size_t i = 0; i < aNode.mFields.size(); ++i ) {
+                        numSlots = max<uint16_t>( numSlots, aNode.mFields[ i ].mId + 1 );
+                    }
+                    vector<uint16_t> vtable( 2 + numSlots, 0 );
+                    pad( sizeof( uint16_t ) );
+                    const size_t vtableLocation = mBuffer.size();
+                    mBuffer.append( vtable.size() * sizeof( uint16_t ), '\0' );
+
+                    // The table starts with the signed distance back to its vtable.
+                    pad( sizeof( uint32_t ) );
+                    location = mBuffer.size();
+                    put<int32_t>( static_cast<int32_t>( location - vtableLocation ) );
+
+                    vector<FlatNode::Field> fields( aNode.mFields );
+                    stable_sort( fields.begin(), fields.end(), isLargerField );
+                    vector<pair<size_t, FlatNodePtr> > references;
+                    for( size_t i = 0; i < fields.size(); ++i ) {
+                        pad( fields[ i ].mSize );
+                        vtable[ 2 + fields[ i ].mId ] = static_cast<uint16_t>( mBuffer.size() - location );
+                        if( fields[ i ].mChild ) {
+                            references.push_back( make_pair( mBuffer.size(), fields[ i ].mChild ) );
+                            put<uint32_t>( 0 );
+                        }
+                        else {
+                            mBuffer.append( fields[ i ].mBytes, fields[ i ].mSize );
+                        }
+                    }
+                    vtable[ 0 ] = static_cast<uint16_t>( vtable.size() * sizeof( uint16_t ) );
+                    vtable[ 1 ] = static_cast<uint16_t>( mBuffer.size() - location );
+                    memcpy( &mBuffer[ vtableLocation ], &vtable[ 0 ], vtable.size() * sizeof( uint16_t ) );
+
+                    for( size_t i = 0; i < references.size(); ++i ) {
+                        patchOffset( references[ i ].first, write( *references[ i ].second ) );
+                    }
+                    break;
+                }
+                case FlatNode::STRING: {
+                    pad( sizeof( uint32_t ) );
+                    location = mBuffer.size();
+                    put<uint32_t>( static_cast<uint32_t>( aNode.mBytes.size() ) );
+                    mBuffer += aNode.mBytes;
+                    mBuffer += '\0';
+                    break;
+                }
+                case FlatNode::TABLE_VECTOR: {
+                    pad( sizeof( uint32_t ) );
+                    location = mBuffer.size();
+                    put<uint32_t>( static_cast<uint32_t>( aNode.mElements.size() ) );
+                    const size_t elementsLocation = mBuffer.size();
+                    mBuffer.append( aNode.mElements.size() * sizeof( uint32_t ), '\0' );
+                    for( size_t i = 0; i < aNode.mElements.size(); ++i ) {
+                        patchOffset( elementsLocation + i * sizeof( uint32_t ), write( *aNode.mElements[ i ] ) );
+                    }
+                    break;
+                }
+                case FlatNode::STRUCT_VECTOR: {
+                    // The structs which follow the length must be eight byte aligned.
+                    pad( 8, 4 );
+                    location = mBuffer.size();
+                    put<uint32_t>( aNode.mCount );
+                    mBuffer += aNode.mBytes;
+                    break;
+                }
+            }
+            return location;
+        }
+
+        //! The flatbuffer being written.
+        string mBuffer;
+    };
+
+    //! The magic string at the start and end of an Arrow file.
+    const char ARROW_MAGIC[] = "ARROW1";
+
+    //! The continuation marker which starts each message.
+    const uint32_t CONTINUATION = 0xFFFFFFFF;
+
+    //! MetadataVersion.V5
+    const int16_t METADATA_VERSION = 4;
+
+    //! MessageHeader union type ids.
+    const uint8_t HEADER_SCHEMA = 1;
+    const uint8_t HEADER_RECORD_BATCH = 3;
+
+    //! Type union type ids.
+    const uint8_t TYPE_INT = 2;
+    const uint8_t TYPE_FLOATING_POINT = 3;
+    const uint8_t TYPE_UTF8 = 5;
+
+    //! Precision.DOUBLE
+    const int16_t PRECISION_DOUBLE = 2;
+
+    /*!
+     * \brief Create the Arrow Schema table for a set of columns.
+     * \param aSchema The columns.
+     * \return The Schema table.
+     */
+    FlatNodePtr createSchema( const vector<ArrowFileWriter::Column>& aSchema ) {
+        FlatNodePtr fields = FlatNode::createTableVector();
+        for( size_t i = 0; i < aSchema.size(); ++i ) {
+            FlatNodePtr type = FlatNode::createTable();
+            uint8_t typeId = 0;
+            switch( aSchema[ i ].mType ) {
+                case ArrowFileWriter::UTF8:
+                    typeId = TYPE_UTF8;
+                    break;
+                case ArrowFileWriter::INT32:
+                    typeId = TYPE_INT;
+                    type->addScalar<int32_t>( 0, 32 ).addScalar<uint8_t>( 1, 1 );
+                    break;
+                case ArrowFileWriter::FLOAT64:
+                    typeId = TYPE_FLOATING_POINT;
+                    type->addScalar<int16_t>( 0, PRECISION_DOUBLE );
+                    break;
+            }
+            // Readers expect the children vector even for primitive types.
+            FlatNodePtr field = FlatNode::createTable();
+            field->addChild( 0, FlatNode::createString( aSchema[ i ].mName ) )
+                .addScalar<uint8_t>( 1, 0 )
+                .addScalar<uint8_t>( 2, typeId )
+                .addChild( 3, type )
+                .addChild( 5, FlatNode::createTableVector() );
+            fields->addElement( field );
+        }
+        FlatNodePtr schema = FlatNode::createTable();
+        schema->addScalar<int16_t>( 0, 0 ).addChild( 1, fields );
+        return schema;
+    }
+
+    /*!
+     * \brief Create the flatbuffer for a message.
+     * \param aHeaderType The type of the message header.
+     * \param aHeader The message header.
+     * \param aBodyLength The length of the message body.
+     * \return The flatbuffer.
+     */
+    string createMessage( const uint8_t aHeaderType, const FlatNodePtr& aHeader, const int64_t aBodyLength ) {
+        FlatNodePtr message = FlatNode::createTable();
+        message->addScalar<int16_t>( 0, METADATA_VERSION )
+            .addScalar<uint8_t>( 1, aHeaderType )
+            .addChild( 2, aHeader )
+            .addScalar<int64_t>( 3, aBodyLength );
+        return FlatSerializer::serialize( *message );
+    }
+
+    //! Pad a message body to eight bytes.
+    void padBody( string& aBody ) {
+        aBody.append( ( 8 - aBody.size() % 8 ) % 8, '\0' );
+    }
+}
+
+/*!
+ * \brief Constructor.
+ * \param aName The name of the column.
+ * \param aType The type of the column.
+ */
+ArrowFileWriter::Column::Column( const string& aName, const ColumnType aType ):
+mName( aName ),
+mType( aType )
+{
+}
+
+/*!
+ * \brief Get the number of rows in the column.
+ * \return The number of rows.
+ */
+size_t ArrowFileWriter::Column::size() const {
+    return mType == UTF8 ? mStrings.size() : mType == INT32 ? mInts.size() : mDoubles.size();
+}
+
+//! Remove all rows from the column.
+void ArrowFileWriter::Column::clear() {
+    mStrings.clear();
+    mInts.clear();
+    mDoubles.clear();
+}
+
+/*!
+ * \brief Constructor which opens the file and writes the schema.
+ * \param aFileName The file to write.
+ * \param aSchema The names and types of the columns, any values are ignored.
+ */
+ArrowFileWriter::ArrowFileWriter( const string& aFileName, const vector<Column>& aSchema ):
+mFile( aFileName.c_str(), ios_base::out | ios_base::binary | ios_base::trunc ),
+mIsClosed( false )
+{
+    for( size_t i = 0; i < aSchema.size(); ++i ) {
+        mSchema.push_back( Column( aSchema[ i ].mName, aSchema[ i ].mType ) );
+    }
+    if( !mFile ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open " << aFileName << " for writing." << endl;
+        mIsClosed = true;
+        return;
+    }
+    // The magic string is padded to eight bytes.
+    mFile.write( ARROW_MAGIC, 6 );
+    mFile.write( "\0\0", 2 );
+    writeMessage( createMessage( HEADER_SCHEMA, createSchema( mSchema ), 0 ), "" );
+}
+
+//! Destructor which writes the footer if close has not been called.
+ArrowFileWriter::~ArrowFileWriter() {
+    close();
+}
+
+/*!
+ * \brief Check if batches may be written.
+ * \return Whether the file is open and has not been closed.
+ */
+bool ArrowFileWriter::isOpen() const {
+    return !mIsClosed && static_cast<bool>( mFile );
+}
+
+/*!
+ * \brief Write a record batch.
+ * \param aColumns The columns of the batch which must have the names and types
+ *                 of the schema and the same number of rows.
+ * \return Whether the batch was written.
+ */
+bool ArrowFileWriter::writeBatch( const vector<Column>& aColumns ) {
+    const size_t numRows = aColumns.empty() ? 0 : aColumns[ 0 ].size();
+    bool isValid = isOpen() && aColumns.size() == mSchema.size();
+    for( size_t i = 0; isValid && i < aColumns.size(); ++i ) {
+        isValid = aColumns[ i ].mType == mSchema[ i ].mType && aColumns[ i ].size() == numRows;
+    }
+    if( !isValid ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Record batch does not match the schema of the Arrow file." << endl;
+        return false;
+    }
+
+    // Each column has a node giving its length and null count and a list of
+    // buffers: an empty validity bitmap since there are no nulls, then the
+    // values, preceded by the offsets for strings.
+    string body;
+    FlatNodePtr nodes = FlatNode::createStructVector();
+    FlatNodePtr buffers = FlatNode::createStructVector();
+    for( size_t i = 0; i < aColumns.size(); ++i ) {
+        const int64_t node[ 2 ] = { static_cast<int64_t>( numRows ), 0 };
+        nodes->addStruct( node, sizeof( node ) );
+
+        vector<string> data( 1 );
+        if( aColumns[ i ].mType == UTF8 ) {
+            vector<int32_t> offsets( 1, 0 );
+            offsets.reserve( numRows + 1 );
+            for( size_t row = 0; row < numRows; ++row ) {
+                data[ 0 ] += aColumns[ i ].mStrings[ row ];
+                offsets.push_back( static_cast<int32_t>( data[ 0 ].size() ) );
+            }
+            data.insert( data.begin(), string( reinterpret_cast<const char*>( &offsets[ 0 ] ),
+                                               offsets.size() * sizeof( int32_t ) ) );
+        }
+        else if( aColumns[ i ].mType == INT32 ) {
+            for( size_t row = 0; row < numRows; ++row ) {
+                const int32_t value = aColumns[ i ].mInts[ row ];
+                data[ 0 ].append( reinterpret_cast<const char*>( &value ), sizeof( value ) );
+            }
+        }
+        else {
+            data[ 0 ].append( reinterpret_cast<const char*>( aColumns[ i ].mDoubles.data() ),
+                              numRows * sizeof( double ) );
+        }
+        data.insert( data.begin(), string() );
+
+        for( size_t j = 0; j < data.size(); ++j ) {
+            const int64_t buffer[ 2 ] = { static_cast<int64_t>( body.size() ), static_cast<int64_t>( data[ j ].size() ) };
+            buffers->addStruct( buffer, sizeof( buffer ) );
+            body += data[ j ];
+            padBody( body );
+        }
+    }
+
+    FlatNodePtr recordBatch = FlatNode::createTable();
+    recordBatch->addScalar<int64_t>( 0, static_cast<int64_t>( numRows ) )
+        .addChild( 1, nodes )
+        .addChild( 2, buffers );
+    writeMessage( createMessage( HEADER_RECORD_BATCH, recordBatch, static_cast<int64_t>( body.size() ) ), body );
+    return static_cast<bool>( mFile );
+}
+
+/*!
+ * \brief Write the end of stream marker and the footer and close the file.
+ * \details The file can not be read until it is closed.  Closing more than
+ *          once has no effect.
+ * \return Whether the file was written successfully.
+ */
+bool ArrowFileWriter::close() {
+    if( mIsClosed ) {
+        return static_cast<bool>( mFile );
+    }
+    mIsClosed = true;
+
+    // End of stream.
+    const uint32_t endOfStream[ 2 ] = { CONTINUATION, 0 };
+    mFile.write( reinterpret_cast<const char*>( endOfStream ), sizeof( endOfStream ) );
+
+    // The footer repeats the schema and locates each record batch.
+    FlatNodePtr recordBatches = FlatNode::createStructVector();
+    for( size_t i = 0; i < mRecordBatches.size(); ++i ) {
+        // struct Block { offset: long; metaDataLength: int; bodyLength: long; }
+        char block[ 24 ] = { 0 };
+        const int64_t offset = mRecordBatches[ i ].mOffset;
+        const int32_t metadataLength = mRecordBatches[ i ].mMetadataLength;
+        const int64_t bodyLength = mRecordBatches[ i ].mBodyLength;
+        memcpy( block, &offset, sizeof( offset ) );
+        memcpy( block + 8, &metadataLength, sizeof( metadataLength ) );
+        memcpy( block + 16, &bodyLength, sizeof( bodyLength ) );
+        recordBatches->addStruct( block, sizeof( block ) );
+    }
+    FlatNodePtr footer = FlatNode::createTable();
+    footer->addScalar<int16_t>( 0, METADATA_VERSION )
+        .addChild( 1, createSchema( mSchema ) )
+        .addChild( 2, FlatNode::createStructVector() )
+        .addChild( 3, recordBatches );
+    const string footerBuffer = FlatSerializer::serialize( *footer );
+    const int32_t footerLength = static_cast<int32_t>( footerBuffer.size() );
+    mFile.write( footerBuffer.data(), footerBuffer.size() );
+    mFile.write( reinterpret_cast<const char*>( &footerLength ), sizeof( footerLength ) );
+    mFile.write( ARROW_MAGIC, 6 );
+    mFile.close();
+    return !mFile.fail();
+}
+
+/*!
+ * \brief Write an encapsulated message.
+ * \details The message is the continuation marker, the length of the metadata,
+ *          the metadata padded so the body starts on an eight byte boundary and
+ *          then the body.  Record batches are remembered for the footer.
+ * \param aMetadata The flatbuffer Message.
+ * \param aBody The message body which must be a multiple of eight bytes.
+ * \return The offset of the message in the file.
+ */
+long long ArrowFileWriter::writeMessage( const string& aMetadata, const string& aBody ) {
+    assert( aBody.size() % 8 == 0 );
+    Block block;
+    block.mOffset = static_cast<long long>( mFile.tellp() );
+    string metadata( aMetadata );
+    metadata.append( ( 8 - ( metadata.size() + 8 ) % 8 ) % 8, '\0' );
+    const int32_t metadataLength = static_cast<int32_t>( metadata.size() );
+    mFile.write( reinterpret_cast<const char*>( &CONTINUATION ), sizeof( CONTINUATION ) );
+    mFile.write( reinterpret_cast<const char*>( &metadataLength ), sizeof( metadataLength ) );
+    mFile.write( metadata.data(), metadata.size() );
+    mFile.write( aBody.data(), aBody.size() );
+    block.mMetadataLength = metadataLength + 8;
+    block.mBodyLength = static_cast<long long>( aBody.size() );
+
+    // Only record batches are indexed in the footer; the schema is the first
+    // message written.
+    if( block.mOffset > 8 ) {
+        mRecordBatches.push_back( block );
+    }
+    return block.mOffset;
+}
@@ -0,0 +1,375 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file arrow_outputter.cpp
+* \ingroup Objects
+* \brief The ArrowOutputter class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <cstdio>
+#include <cstdint>
+#include <fstream>
+
+#include "reporting/include/arrow_outputter.h"
+#include "util/base/include/model_time.h"
+#include "util/base/include/util.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+#include "containers/include/scenario.h"
+#include "containers/include/region.h"
+#include "containers/include/iinfo.h"
+#include "resources/include/aresource.h"
+#include "sectors/include/sector.h"
+#include "sectors/include/subsector.h"
+#include "technologies/include/technology.h"
+#include "technologies/include/ioutput.h"
+#include "functions/include/iinput.h"
+#include "emissions/include/aghg.h"
+#include "marketplace/include/marketplace.h"
+#include "marketplace/include/market.h"
+#include "land_allocator/include/land_leaf.h"
+#include "climate/include/iclimate_model.h"
+
+using namespace std;
+
+extern Scenario* scenario;
+
+/*!
+ * \brief Constructor which opens the file and writes the schema.
+ * \param aFileName The file to write.
+ */
+ArrowOutputter::ArrowOutputter( const string& aFileName ):
+mColumns( createColumns() ),
+mWriter( aFileName, mColumns ),
+mCurrentVintage( 0 )
+{
+}
+
+//! Destructor.
+ArrowOutputter::~ArrowOutputter() {
+}
+
+/*!
+ * \brief Write the results of a scenario to its file in the given directory.
+ * \param aScenario The scenario which has been run.
+ * \param aLocation The directory to write to which must exist.
+ * \return Whether the results were written successfully.
+ */
+bool ArrowOutputter::writeScenario( const Scenario* aScenario, const string& aLocation ) {
+    const string fileName = aLocation + "/" + aScenario->getName() + ".arrow";
+    ArrowOutputter outputter( fileName );
+    bool success = true;
+    const Modeltime* modeltime = scenario->getModeltime();
+    for( int period = 0; period < modeltime->getmaxper(); ++period ) {
+        aScenario->accept( &outputter, period );
+        success = outputter.finishPeriod() && success;
+    }
+    success = outputter.finish() && success;
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( success ? ILogger::NOTICE : ILogger::ERROR );
+    mainLog << ( success ? "Wrote results to " : "Failed to write results to " ) << fileName << "." << endl;
+    return success;
+}
+
+/*!
+ * \brief Write the results of a single period of a scenario to a file of its
+ *        own in the given directory.
+ * \details The file is written under a temporary name and then renamed so
+ *          that a reader never sees a partially written file.  The file for a
+ *          period which is run again is replaced.
+ *
+ *          When the boolean configuration value "deduplicate-output" is set
+ *          the rows are instead stored in a block file named after a hash of
+ *          their contents, block-<hash>.arrow, and <scenario>.<year>.arrow.ref
+ *          is written with the name of the block.  A block which already
+ *          exists, for instance from an earlier scenario in a batch with
+ *          identical results for the period, is not written again.  Since the
+ *          table has no scenario column identical rows give an identical block.
+ * \param aScenario The scenario which has just solved the period.
+ * \param aLocation The directory to write to which must exist.
+ * \param aPeriod The model period.
+ * \return Whether the results were written successfully.
+ */
+bool ArrowOutputter::writePeriod( const Scenario* aScenario, const string& aLocation, const int aPeriod ) {
+    const string fileName = aLocation + "/" + aScenario->getName() + "."
+                            + util::toString( scenario->getModeltime()->getper_to_yr( aPeriod ) ) + ".arrow";
+    const string tempFileName = fileName + ".tmp";
+    const bool deduplicate = Configuration::getInstance()->getBool( "deduplicate-output", false );
+    string blockName;
+    string targetName = fileName;
+    bool isNewBlock = true;
+    bool success = true;
+    {
+        ArrowOutputter outputter( tempFileName );
+        aScenario->accept( &outputter, aPeriod );
+        if( deduplicate ) {
+            blockName = "block-" + outputter.hashRows() + ".arrow";
+            targetName = aLocation + "/" + blockName;
+            isNewBlock = !ifstream( targetName.c_str() ).is_open();
+        }
+        if( isNewBlock ) {
+            success = outputter.finishPeriod();
+            success = outputter.finish() && success;
+        }
+    }
+    if( success && isNewBlock ) {
+        // Renaming onto an existing file fails on Windows.
+        remove( targetName.c_str() );
+        success = rename( tempFileName.c_str(), targetName.c_str() ) == 0;
+    }
+    else {
+        remove( tempFileName.c_str() );
+    }
+    if( success && deduplicate ) {
+        ofstream reference( ( fileName + ".ref" ).c_str(), ios::out | ios::trunc );
+        reference << blockName << endl;
+        reference.close();
+        success = !reference.fail();
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( success ? ILogger::DEBUG : ILogger::ERROR );
+    mainLog << ( success ? "Wrote results to " : "Failed to write results to " ) << fileName;
+    if( deduplicate ) {
+        mainLog << ( isNewBlock ? " in new block " : " sharing block " ) << blockName;
+    }
+    mainLog << "." << endl;
+    return success;
+}
+
+/*!
+ * \brief Hash the rows of the period just visited.
+ * \details Two independent 64 bit hashes are calculated over the exact bytes
+ *          of every value, doubles included, so that rows which hash the same
+ *          may be taken to match bit for bit.
+ * \return The hash as 32 hexadecimal digits.
+ */
+string ArrowOutputter::hashRows() const {
+    // FNV-1a along with a multiplicative hash with a different seed and prime.
+    uint64_t fnv = 14695981039346656037ULL;
+    uint64_t mix = 0x9E3779B97F4A7C15ULL;
+    auto addBytes = [&fnv, &mix] ( const void* aData, const size_t aSize ) {
+        const unsigned char* bytes = static_cast<const unsigned char*>( aData );
+        for( size_t i = 0; i < aSize; ++i ) {
+            fnv = ( fnv ^ bytes[ i ] ) * 1099511628211ULL;
+            mix = ( mix + bytes[ i ] ) * 0xFF51AFD7ED558CCDULL;
+            mix ^= mix >> 29;
+        }
+    };
+    for( vector<ArrowFileWriter::Column>::const_iterator it = mColumns.begin(); it != mColumns.end(); ++it ) {
+        const uint64_t size = it->size();
+        addBytes( &size, sizeof( size ) );
+        for( vector<string>::const_iterator str = it->mStrings.begin(); str != it->mStrings.end(); ++str ) {
+            const uint64_t length = str->size();
+            addBytes( &length, sizeof( length ) );
+            addBytes( str->data(), str->size() );
+        }
+        if( !it->mInts.empty() ) {
+            addBytes( it->mInts.data(), sizeof( int ) * it->mInts.size() );
+        }
+        if( !it->mDoubles.empty() ) {
+            addBytes( it->mDoubles.data(), sizeof( double ) * it->mDoubles.size() );
+        }
+    }
+    char hash[ 33 ];
+    snprintf( hash, sizeof( hash ), "%016llx%016llx", static_cast<unsigned long long>( fnv ),
+              static_cast<unsigned long long>( mix ) );
+    return hash;
+}
+
+/*!
+ * \brief Write the rows of the period just visited as a record batch.
+ * \return Whether the batch was written.
+ */
+bool ArrowOutputter::finishPeriod() {
+    const bool success = mWriter.writeBatch( mColumns );
+    for( vector<ArrowFileWriter::Column>::iterator it = mColumns.begin(); it != mColumns.end(); ++it ) {
+        it->clear();
+    }
+    return success;
+}
+
+/*!
+ * \brief Complete the file after all periods have been written.
+ * \return Whether the file was written successfully.
+ */
+bool ArrowOutputter::finish() {
+    return mWriter.close();
+}
+
+void ArrowOutputter::startVisitRegion( const Region* aRegion, const int aPeriod ) {
+    mCurrentRegion = aRegion->getName();
+}
+
+void ArrowOutputter::endVisitRegion( const Region* aRegion, const int aPeriod ) {
+    mCurrentRegion.clear();
+}
+
+void ArrowOutputter::startVisitResource( const AResource* aResource, const int aPeriod ) {
+    mCurrentSector = aResource->getName();
+    addRow( "production", aResource->getName(), aPeriod,
+            aResource->getAnnualProd( mCurrentRegion, aPeriod ),
+            getOutputUnit( aResource->getName(), aPeriod ) );
+}
+
+void ArrowOutputter::endVisitResource( const AResource* aResource, const int aPeriod ) {
+    mCurrentSector.clear();
+}
+
+void ArrowOutputter::startVisitSector( const Sector* aSector, const int aPeriod ) {
+    mCurrentSector = aSector->getName();
+}
+
+void ArrowOutputter::endVisitSector( const Sector* aSector, const int aPeriod ) {
+    mCurrentSector.clear();
+}
+
+void ArrowOutputter::startVisitSubsector( const Subsector* aSubsector, const int aPeriod ) {
+    mCurrentSubsector = aSubsector->getName();
+}
+
+void ArrowOutputter::endVisitSubsector( const Subsector* aSubsector, const int aPeriod ) {
+    mCurrentSubsector.clear();
+}
+
+void ArrowOutputter::startVisitTechnology( const Technology* aTechnology, const int aPeriod ) {
+    mCurrentTechnology = aTechnology->getName();
+    mCurrentVintage = aTechnology->getYear();
+}
+
+void ArrowOutputter::endVisitTechnology( const Technology* aTechnology, const int aPeriod ) {
+    mCurrentTechnology.clear();
+    mCurrentVintage = 0;
+}
+
+void ArrowOutputter::startVisitInput( const IInput* aInput, const int aPeriod ) {
+    addRow( "input", aInput->getName(), aPeriod, aInput->getPhysicalDemand( aPeriod ),
+            getOutputUnit( aInput->getName(), aPeriod ) );
+}
+
+void ArrowOutputter::startVisitOutput( const IOutput* aOutput, const int aPeriod ) {
+    addRow( "output", aOutput->getName(), aPeriod, aOutput->getPhysicalOutput( aPeriod ),
+            getOutputUnit( aOutput->getName(), aPeriod ) );
+}
+
+void ArrowOutputter::startVisitGHG( const AGHG* aGHG, const int aPeriod ) {
+    addRow( "emissions", aGHG->getName(), aPeriod, aGHG->getEmission( aPeriod ), "" );
+}
+
+void ArrowOutputter::startVisitMarket( const Market* aMarket, const int aPeriod ) {
+    // Markets are not visited within a region so use the market region.
+    mCurrentRegion = aMarket->getRegionName();
+    const IInfo* marketInfo = aMarket->getMarketInfo();
+    const string priceUnit = marketInfo ? marketInfo->getString( InfoKeys::ePriceUnit, false ) : "";
+    const string outputUnit = marketInfo ? marketInfo->getString( InfoKeys::eOutputUnit, false ) : "";
+    addRow( "price", aMarket->getGoodName(), aPeriod, aMarket->getPrice(), priceUnit );
+    addRow( "supply", aMarket->getGoodName(), aPeriod, aMarket->getSupply(), outputUnit );
+    addRow( "demand", aMarket->getGoodName(), aPeriod, aMarket->getDemand(), outputUnit );
+    mCurrentRegion.clear();
+}
+
+void ArrowOutputter::startVisitLandLeaf( const LandLeaf* aLandLeaf, const int aPeriod ) {
+    addRow( "land-allocation", aLandLeaf->getName(), aPeriod,
+            aLandLeaf->getLandAllocation( aLandLeaf->getName(), aPeriod ), "thous km2" );
+}
+
+void ArrowOutputter::startVisitClimateModel( const IClimateModel* aClimateModel, const int aPeriod ) {
+    const int year = scenario->getModeltime()->getper_to_yr( aPeriod );
+    mCurrentRegion = "global";
+    addRow( "concentration", "CO2", aPeriod, aClimateModel->getConcentration( "CO2", year ), "PPM" );
+    addRow( "forcing", "total", aPeriod, aClimateModel->getTotalForcing( year ), "W/m^2" );
+    addRow( "temperature", "global-mean", aPeriod, aClimateModel->getTemperature( year ), "degC" );
+    mCurrentRegion.clear();
+}
+
+/*!
+ * \brief Create the empty columns of the output table.
+ * \return The columns in the order of ColumnIndex.
+ */
+vector<ArrowFileWriter::Column> ArrowOutputter::createColumns() {
+    vector<ArrowFileWriter::Column> columns;
+    columns.push_back( ArrowFileWriter::Column( "region", ArrowFileWriter::UTF8 ) );
+    columns.push_back( ArrowFileWriter::Column( "sector", ArrowFileWriter::UTF8 ) );
+    columns.push_back( ArrowFileWriter::Column( "subsector", ArrowFileWriter::UTF8 ) );
+    columns.push_back( ArrowFileWriter::Column( "technology", ArrowFileWriter::UTF8 ) );
+    columns.push_back( ArrowFileWriter::Column( "vintage", ArrowFileWriter::INT32 ) );
+    columns.push_back( ArrowFileWriter::Column( "variable", ArrowFileWriter::UTF8 ) );
+    columns.push_back( ArrowFileWriter::Column( "name", ArrowFileWriter::UTF8 ) );
+    columns.push_back( ArrowFileWriter::Column( "year", ArrowFileWriter::INT32 ) );
+    columns.push_back( ArrowFileWriter::Column( "value", ArrowFileWriter::FLOAT64 ) );
+    columns.push_back( ArrowFileWriter::Column( "unit", ArrowFileWriter::UTF8 ) );
+    return columns;
+}
+
+/*!
+ * \brief Add a row in the current context unless the value is zero or not a
+ *        number.
+ * \param aVariable The name of the quantity.
+ * \param aName The good, gas or other item the quantity is for.
+ * \param aPeriod The model period.
+ * \param aValue The value.
+ * \param aUnit The units of the value.
+ */
+void ArrowOutputter::addRow( const string& aVariable, const string& aName,
+                             const int aPeriod, const double aValue, const string& aUnit )
+{
+    if( aValue == 0.0 || !util::isValidNumber( aValue ) ) {
+        return;
+    }
+    mColumns[ REGION ].mStrings.push_back( mCurrentRegion );
+    mColumns[ SECTOR ].mStrings.push_back( mCurrentSector );
+    mColumns[ SUBSECTOR ].mStrings.push_back( mCurrentSubsector );
+    mColumns[ TECHNOLOGY ].mStrings.push_back( mCurrentTechnology );
+    mColumns[ VINTAGE ].mInts.push_back( mCurrentVintage );
+    mColumns[ VARIABLE ].mStrings.push_back( aVariable );
+    mColumns[ NAME ].mStrings.push_back( aName );
+    mColumns[ YEAR ].mInts.push_back( scenario->getModeltime()->getper_to_yr( aPeriod ) );
+    mColumns[ VALUE ].mDoubles.push_back( aValue );
+    mColumns[ UNIT ].mStrings.push_back( aUnit );
+}
+
+/*!
+ * \brief Get the output unit of a good from its market in the current region.
+ * \param aGoodName The good.
+ * \param aPeriod The model period.
+ * \return The unit or an empty string if it is not known.
+ */
+const string& ArrowOutputter::getOutputUnit( const string& aGoodName, const int aPeriod ) const {
+    static const string NO_UNIT;
+    const IInfo* marketInfo = scenario->getMarketplace()->getMarketInfo( aGoodName, mCurrentRegion, aPeriod, false );
+    return marketInfo ? marketInfo->getString( InfoKeys::eOutputUnit, false ) : NO_UNIT;
+}
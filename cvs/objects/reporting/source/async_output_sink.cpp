@@ -0,0 +1,177 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file async_output_sink.cpp
+* \ingroup Objects
+* \brief AsyncOutputSink class source file.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <cassert>
+#include <thread>
+#include <tbb/concurrent_queue.h>
+
+#include "reporting/include/async_output_sink.h"
+
+using namespace std;
+
+/*!
+ * \brief The state shared by all copies of an AsyncOutputSink.
+ */
+struct AsyncOutputSink::Impl {
+    Impl( const WriteFunction& aWriter, const function<void()>& aOnWriterExit,
+          const streamsize aChunkSize, const size_t aMaxChunks );
+    ~Impl();
+
+    void run();
+    void close();
+
+    //! The function which writes the data.
+    WriteFunction mWriter;
+
+    //! The function called on the writer thread when it is done.
+    function<void()> mOnWriterExit;
+
+    //! The size at which a chunk is passed to the writer thread.
+    const streamsize mChunkSize;
+
+    //! The chunk currently being filled.
+    string* mCurrChunk;
+
+    //! The full chunks waiting to be written, a null chunk signals the end.
+    tbb::concurrent_bounded_queue<string*> mQueue;
+
+    //! The thread which writes the chunks.
+    thread mWriterThread;
+};
+
+/*!
+ * \brief Constructor which starts the writer thread.
+ * \param aWriter The function which writes a block of data.
+ * \param aOnWriterExit A function to call on the writer thread when it is
+ *                      done, which may be empty.
+ * \param aChunkSize The size of the chunks passed to the writer.
+ * \param aMaxChunks The most full chunks to hold before blocking writes.
+ */
+AsyncOutputSink::AsyncOutputSink( const WriteFunction& aWriter, const function<void()>& aOnWriterExit,
+                                  const streamsize aChunkSize, const size_t aMaxChunks ):
+mImpl( new Impl( aWriter, aOnWriterExit, aChunkSize, aMaxChunks ) )
+{
+}
+
+/*!
+ * \brief Add data to be written.
+ * \details This only blocks if the queue of chunks waiting to be written is
+ *          full.
+ * \param aData The data to write.
+ * \param aLength The number of chars of data.
+ * \return The number of chars accepted which is always all of them.
+ */
+streamsize AsyncOutputSink::write( const char* aData, streamsize aLength ) {
+    streamsize offset = 0;
+    while( offset < aLength ) {
+        const streamsize numCopy = min( aLength - offset,
+            mImpl->mChunkSize - static_cast<streamsize>( mImpl->mCurrChunk->size() ) );
+        mImpl->mCurrChunk->append( aData + offset, numCopy );
+        offset += numCopy;
+        if( static_cast<streamsize>( mImpl->mCurrChunk->size() ) == mImpl->mChunkSize ) {
+            mImpl->mQueue.push( mImpl->mCurrChunk );
+            mImpl->mCurrChunk = new string();
+            mImpl->mCurrChunk->reserve( mImpl->mChunkSize );
+        }
+    }
+    return aLength;
+}
+
+/*!
+ * \brief Write any remaining data and wait for the writer thread to finish.
+ */
+void AsyncOutputSink::close() {
+    mImpl->close();
+}
+
+AsyncOutputSink::Impl::Impl( const WriteFunction& aWriter, const function<void()>& aOnWriterExit,
+                             const streamsize aChunkSize, const size_t aMaxChunks ):
+mWriter( aWriter ),
+mOnWriterExit( aOnWriterExit ),
+mChunkSize( aChunkSize ),
+mCurrChunk( new string() )
+{
+    assert( aChunkSize > 0 && aMaxChunks > 0 );
+    mCurrChunk->reserve( mChunkSize );
+    mQueue.set_capacity( aMaxChunks );
+    mWriterThread = thread( &AsyncOutputSink::Impl::run, this );
+}
+
+/*!
+ * \brief Destructor which closes the sink if that was not already done.
+ */
+AsyncOutputSink::Impl::~Impl() {
+    close();
+}
+
+/*!
+ * \brief The body of the writer thread.
+ */
+void AsyncOutputSink::Impl::run() {
+    string* chunk;
+    for( mQueue.pop( chunk ); chunk; mQueue.pop( chunk ) ) {
+        mWriter( chunk->data(), chunk->size() );
+        delete chunk;
+    }
+    if( mOnWriterExit ) {
+        mOnWriterExit();
+    }
+}
+
+/*!
+ * \brief Push the last chunk and the end marker and join the writer thread.
+ */
+void AsyncOutputSink::Impl::close() {
+    if( !mWriterThread.joinable() ) {
+        return;
+    }
+    if( !mCurrChunk->empty() ) {
+        mQueue.push( mCurrChunk );
+    }
+    else {
+        delete mCurrChunk;
+    }
+    mCurrChunk = 0;
+    mQueue.push( 0 );
+    mWriterThread.join();
+}
+
+#endif // GCAM_PARALLEL_ENABLED
@@ -52,6 +52,8 @@
 #include "climate/include/iclimate_model.h"
 
 #include <string>
+#include <fstream>
+#include <cstdio>
 
 #include "reporting/include/batch_csv_outputter.h"
 
@@ -68,6 +70,19 @@ mIsFirstScenario(true)
 {
 }
 
+/*!
+ * \brief Constructor which writes to the given file.
+ * \details This is used by concurrent batch worker processes which each write
+ *          their results to a separate file that is later merged using
+ *          appendFile.
+ * \param aFileName The name of the file to write to.
+ */
+BatchCSVOutputter::BatchCSVOutputter( const string& aFileName ):
+mFile( aFileName ),
+mIsFirstScenario(true)
+{
+}
+
 /*!
  * \brief Destructor
  */
@@ -178,3 +193,36 @@ void BatchCSVOutputter::startVisitClimateModel( const IClimateModel* aClimateMod
 void BatchCSVOutputter::writeDidScenarioSolve( bool aDidSolve ) {
     mFile << aDidSolve << endl;
 }
+
+/*!
+ * \brief Append the results written to another batch CSV file and remove it.
+ * \details Missing files are ignored since the scenario may have failed before
+ *          any results were written.
+ * \param aFileName The name of the file to append.
+ */
+void BatchCSVOutputter::appendFile( const string& aFileName ) {
+    ifstream inFile( aFileName.c_str() );
+    if( !inFile.is_open() ) {
+        return;
+    }
+    appendRows( inFile );
+    inFile.close();
+    remove( aFileName.c_str() );
+}
+
+/*!
+ * \brief Append the results written by another batch CSV outputter.
+ * \details The header line of the other results is only kept if no scenario
+ *          has been written to this file yet.
+ * \param aIn The stream to read the results from.
+ */
+void BatchCSVOutputter::appendRows( istream& aIn ) {
+    string line;
+    if( getline( aIn, line ) && mIsFirstScenario ) {
+        mFile << line << endl;
+        mIsFirstScenario = false;
+    }
+    while( getline( aIn, line ) ) {
+        mFile << line << endl;
+    }
+}
@@ -57,6 +57,8 @@ using namespace std;
  * \brief Constructor
  */
 IndirectEmissionsCalculator::IndirectEmissionsCalculator():
+mNumPeriods( scenario->getModeltime()->getmaxper() ),
+mCurrSectorIndex( -1 ),
 mCurrTotalEmissions( 0 ),
 mCurrIndirectEmissions( 0 ),
 mCurrOutput( 0 ){
@@ -74,15 +76,15 @@ mCurrOutput( 0 ){
 double IndirectEmissionsCalculator::getUpstreamEmissionsCoefficient( const string& aSector,
                                                                      const int aPeriod ) const
 {
-    DoubleMap::const_iterator upstreamEmissionsCoef = mUpstreamEmissionsCoefficients.find( aSector );
-    if( mUpstreamEmissionsCoefficients.end() == upstreamEmissionsCoef
-        || !upstreamEmissionsCoef->second[ aPeriod ].isInited() )
+    const int sectorIndex = getSectorIndex( aSector );
+    if( sectorIndex == -1
+        || !mUpstreamEmissionsCoefficients[ sectorIndex * mNumPeriods + aPeriod ].isInited() )
     {
         // Upstream emissions coefficients do not exist for resources, renewable
         // fuels and the 'none' fuel.
         return 0;
     }
-    return upstreamEmissionsCoef->second[ aPeriod ];
+    return mUpstreamEmissionsCoefficients[ sectorIndex * mNumPeriods + aPeriod ];
 }
 
 /*!
@@ -98,14 +100,24 @@ double IndirectEmissionsCalculator::getUpstreamEmissionsCoefficient( const strin
 double IndirectEmissionsCalculator::getIndirectEmissions( const string& aSector,
                                                           const int aPeriod ) const
 {
-    DoubleMap::const_iterator indirectEmissions = mIndirectEmissions.find( aSector );
-    if( mIndirectEmissions.end() == indirectEmissions || !indirectEmissions->second[ aPeriod ].isInited() ){
+    const int sectorIndex = getSectorIndex( aSector );
+    if( sectorIndex == -1 || !mIndirectEmissions[ sectorIndex * mNumPeriods + aPeriod ].isInited() ){
         ILogger& mainLog = ILogger::getLogger( "main_log" );
         mainLog.setLevel( ILogger::WARNING );
         mainLog << "No indirect emissions were calculated for sector " << aSector << "." << endl;
         return 0;
     }
-    return indirectEmissions->second[ aPeriod ];
+    return mIndirectEmissions[ sectorIndex * mNumPeriods + aPeriod ];
+}
+
+/*!
+ * \brief Get the row of a sector in the coefficient tables.
+ * \param aSector Name of the sector.
+ * \return The row of the sector, or -1 if it has not been visited.
+ */
+int IndirectEmissionsCalculator::getSectorIndex( const string& aSector ) const {
+    map<string, int>::const_iterator sectorIndex = mSectorIndices.find( aSector );
+    return sectorIndex != mSectorIndices.end() ? sectorIndex->second : -1;
 }
 
 void IndirectEmissionsCalculator::startVisitSector( const Sector* aSector,
@@ -118,12 +130,17 @@ void IndirectEmissionsCalculator::startVisitSector( const Sector* aSector,
     assert( mCurrSectorName.empty() && mCurrTotalEmissions == 0 && mCurrIndirectEmissions == 0
             && mCurrOutput == 0 );
 
-    // Ensure values have not already been calculated.
-    assert( mUpstreamEmissionsCoefficients.find( mCurrSectorName ) == mUpstreamEmissionsCoefficients.end() );
-    assert( mIndirectEmissions.find( mCurrSectorName ) == mIndirectEmissions.end() );
-
     // Set the current sector name.
     mCurrSectorName = aSector->getName();
+
+    // Add a row to the tables the first time the sector is visited.
+    mCurrSectorIndex = getSectorIndex( mCurrSectorName );
+    if( mCurrSectorIndex == -1 ) {
+        mCurrSectorIndex = static_cast<int>( mSectorIndices.size() );
+        mSectorIndices[ mCurrSectorName ] = mCurrSectorIndex;
+        mUpstreamEmissionsCoefficients.resize( mUpstreamEmissionsCoefficients.size() + mNumPeriods );
+        mIndirectEmissions.resize( mIndirectEmissions.size() + mNumPeriods );
+    }
 }
 
 void IndirectEmissionsCalculator::endVisitSector( const Sector* aSector, const int aPeriod ){
@@ -134,14 +151,15 @@ void IndirectEmissionsCalculator::endVisitSector( const Sector* aSector, const i
     assert( !mCurrSectorName.empty() );
 
     // Calculate the indirect emissions coefficient.
-    mUpstreamEmissionsCoefficients[ mCurrSectorName ][ aPeriod ] = mCurrOutput > util::getSmallNumber()
-                                                                   ? mCurrTotalEmissions / mCurrOutput : 0;
+    mUpstreamEmissionsCoefficients[ mCurrSectorIndex * mNumPeriods + aPeriod ] =
+        mCurrOutput > util::getSmallNumber() ? mCurrTotalEmissions / mCurrOutput : 0;
 
     // Store the indirect emissions.
-    mIndirectEmissions[ mCurrSectorName ][ aPeriod ] = mCurrIndirectEmissions;
+    mIndirectEmissions[ mCurrSectorIndex * mNumPeriods + aPeriod ] = mCurrIndirectEmissions;
 
     // Clear the state variables.
     mCurrSectorName.clear();
+    mCurrSectorIndex = -1;
     mCurrTotalEmissions = 0;
     mCurrIndirectEmissions = 0;
     mCurrOutput = 0;
@@ -0,0 +1,158 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file query_output_filter.cpp
+* \ingroup Objects
+* \brief QueryOutputFilter class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <cctype>
+#include <xercesc/dom/DOMNodeList.hpp>
+
+#include "reporting/include/query_output_filter.h"
+#include "util/base/include/xml_helper.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+    /*!
+     * \brief Whether a character may be part of an XML element name.
+     * \param aChar The character to check.
+     * \return Whether the character is a name character.
+     */
+    bool isNameChar( const char aChar ) {
+        return isalnum( static_cast<unsigned char>( aChar ) ) || aChar == '-' || aChar == '_' || aChar == '.';
+    }
+}
+
+//! Constructor
+QueryOutputFilter::QueryOutputFilter() {
+}
+
+/*!
+ * \brief Parse a batch query file.
+ * \details The structure of the file is not checked beyond looking for the
+ *          path elements so that query groups and any of the query types may
+ *          be used.
+ * \param aNode The root of the query file.
+ * \return Whether the parse was successful.
+ */
+bool QueryOutputFilter::XMLParse( const DOMNode* aNode ) {
+    assert( aNode );
+    parseQueryNode( aNode );
+    return true;
+}
+
+/*!
+ * \brief Collect the element names from any path elements at or below the
+ *        given node.
+ * \param aNode The node to search.
+ */
+void QueryOutputFilter::parseQueryNode( const DOMNode* aNode ) {
+    const string nodeName = XMLHelper<string>::safeTranscode( aNode->getNodeName() );
+    if( nodeName == "xPath" || nodeName == "axis1" || nodeName == "axis2" ) {
+        // Queries are often XQuery wrapped in a CDATA section so use all of
+        // the text content rather than the first text node.
+        addPath( XMLHelper<string>::safeTranscode( aNode->getTextContent() ) );
+        return;
+    }
+
+    const DOMNodeList* nodeList = aNode->getChildNodes();
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+        const DOMNode* curr = nodeList->item( i );
+        if( curr->getNodeType() == DOMNode::ELEMENT_NODE ) {
+            parseQueryNode( curr );
+        }
+    }
+}
+
+/*!
+ * \brief Add the element names found in an XPath expression.
+ * \details Names inside quotes, names of attributes, variables, axes and
+ *          functions are skipped.  Other words such as "and" are kept which is harmless.
+ * \param aPath The XPath expression.
+ */
+void QueryOutputFilter::addPath( const string& aPath ) {
+    size_t pos = 0;
+    while( pos < aPath.size() ) {
+        const char curr = aPath[ pos ];
+        if( curr == '\'' || curr == '"' ) {
+            // Skip to the end of the string literal.
+            const size_t end = aPath.find( curr, pos + 1 );
+            pos = end == string::npos ? aPath.size() : end + 1;
+        }
+        else if( isNameChar( curr ) ) {
+            const size_t start = pos;
+            while( pos < aPath.size() && isNameChar( aPath[ pos ] ) ) {
+                ++pos;
+            }
+            const bool isAttributeOrVariable = start > 0 && ( aPath[ start - 1 ] == '@'
+                || aPath[ start - 1 ] == '$' );
+            // Look past any white space for a function call or an axis.
+            size_t next = pos;
+            while( next < aPath.size() && isspace( static_cast<unsigned char>( aPath[ next ] ) ) ) {
+                ++next;
+            }
+            const bool isFunctionOrAxis = next < aPath.size() && ( aPath[ next ] == '('
+                || aPath.compare( next, 2, "::" ) == 0 );
+            if( !isAttributeOrVariable && !isFunctionOrAxis
+                && !isdigit( static_cast<unsigned char>( aPath[ start ] ) ) )
+            {
+                mRequiredNames.insert( aPath.substr( start, pos - start ) );
+            }
+        }
+        else {
+            ++pos;
+        }
+    }
+}
+
+/*!
+ * \brief Whether the queries read an element with the given name.
+ * \param aElementName The name of a data element.
+ * \return Whether the element should be written.
+ */
+bool QueryOutputFilter::isRequired( const string& aElementName ) const {
+    return mRequiredNames.find( aElementName ) != mRequiredNames.end();
+}
+
+/*!
+ * \brief Get the number of element names the queries read.
+ * \return The number of required element names.
+ */
+size_t QueryOutputFilter::getNumRequired() const {
+    return mRequiredNames.size();
+}
@@ -0,0 +1,280 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file query_summary_writer.cpp
+* \ingroup Objects
+* \brief QuerySummaryWriter class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/type_traits/is_base_of.hpp>
+#include <boost/utility/enable_if.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+
+#include "reporting/include/query_summary_writer.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/model_time.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/gcam_fusion.hpp"
+#include "util/base/include/gcam_data_containers.h"
+
+using namespace std;
+using namespace xercesc;
+
+extern Scenario* scenario;
+
+namespace {
+    // The name of a container which is INamed.
+    template<typename T>
+    typename boost::enable_if<boost::is_base_of<INamed, T>, string>::type
+    getContainerName( const T* aContainer ) {
+        return aContainer ? aContainer->getName() : string();
+    }
+
+    // Containers which are not INamed are not part of any group.
+    template<typename T>
+    typename boost::disable_if<boost::is_base_of<INamed, T>, string>::type
+    getContainerName( const T* aContainer ) {
+        return string();
+    }
+
+    // The year of a container which is IYeared.
+    template<typename T>
+    typename boost::enable_if<boost::is_base_of<IYeared, T>, int>::type
+    getContainerYear( const T* aContainer ) {
+        return aContainer ? aContainer->getYear() : -1;
+    }
+
+    // Containers which are not IYeared do not have a year.
+    template<typename T>
+    typename boost::disable_if<boost::is_base_of<IYeared, T>, int>::type
+    getContainerYear( const T* aContainer ) {
+        return -1;
+    }
+}
+
+//! Constructor
+QuerySummaryWriter::QuerySummaryWriter():
+mCurrQuery( 0 )
+{
+}
+
+//! Destructor
+QuerySummaryWriter::~QuerySummaryWriter() {
+    for( auto& query : mQueries ) {
+        for( auto filterStep : query.mFilterSteps ) {
+            delete filterStep;
+        }
+    }
+}
+
+/*!
+ * \brief Parse the list of queries.
+ * \param aNode The root of the query file.
+ * \return Whether the parse was successful.
+ */
+bool QuerySummaryWriter::XMLParse( const DOMNode* aNode ) {
+    assert( aNode );
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    const DOMNodeList* nodeList = aNode->getChildNodes();
+    for( unsigned int i = 0; i < nodeList->getLength(); ++i ) {
+        const DOMNode* curr = nodeList->item( i );
+        if( curr->getNodeType() != DOMNode::ELEMENT_NODE ) {
+            continue;
+        }
+        const string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
+        if( nodeName != "query" ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized text string: " << nodeName << " found while parsing summary queries." << endl;
+            continue;
+        }
+
+        string filter = XMLHelper<string>::safeTranscode( curr->getTextContent() );
+        boost::algorithm::trim( filter );
+        if( filter.empty() ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Skipping summary query with no filter." << endl;
+            continue;
+        }
+
+        Query query;
+        query.mTitle = XMLHelper<string>::getAttr( curr, "title" );
+        if( query.mTitle.empty() ) {
+            query.mTitle = filter;
+        }
+        const string groupBy = XMLHelper<string>::getAttr( curr, "group-by" );
+        vector<string> depths;
+        boost::split( depths, groupBy, boost::is_any_of( "," ) );
+        for( auto& depth : depths ) {
+            boost::algorithm::trim( depth );
+            if( !depth.empty() ) {
+                query.mGroupDepths.push_back( boost::lexical_cast<size_t>( depth ) );
+            }
+        }
+        query.mFilterSteps = parseFilterString( filter );
+        mQueries.push_back( query );
+    }
+    return true;
+}
+
+/*!
+ * \brief Get the number of queries parsed.
+ * \return The number of queries.
+ */
+size_t QuerySummaryWriter::getNumQueries() const {
+    return mQueries.size();
+}
+
+/*!
+ * \brief Evaluate each of the queries and write the totals by group and year.
+ * \details The file has the columns scenario, title, group, year and value
+ *          with the groups of a query in name order and the years of a group in
+ *          ascending order.  Values not associated with any year are written
+ *          with a year of -1.
+ * \param aScenario The scenario to query.
+ * \param aFileName The name of the file to write.
+ */
+void QuerySummaryWriter::write( Scenario* aScenario, const string& aFileName ) {
+    ofstream out( aFileName.c_str() );
+    if( !out ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open summary query output file " << aFileName << "." << endl;
+        return;
+    }
+    out.precision( 12 );
+    out << "scenario,title,group,year,value" << endl;
+    for( const auto& query : mQueries ) {
+        mCurrQuery = &query;
+        mTotals.clear();
+        GCAMFusion<QuerySummaryWriter, true, true, true> runQuery( *this, query.mFilterSteps );
+        runQuery.startFilter( aScenario );
+        for( const auto& total : mTotals ) {
+            out << aScenario->getName() << ",\"" << query.mTitle << "\",\"" << total.first.first
+                << "\"," << total.first.second << "," << total.second << endl;
+        }
+    }
+    mCurrQuery = 0;
+    mTotals.clear();
+}
+
+/*!
+ * \brief Add a matched value to the total of its group for the current query.
+ * \param aValue The value.
+ * \param aYear The year of the value.
+ */
+void QuerySummaryWriter::addValue( const double aValue, const int aYear ) {
+    assert( mCurrQuery );
+    string group;
+    for( auto depth : mCurrQuery->mGroupDepths ) {
+        if( !group.empty() ) {
+            group += "/";
+        }
+        if( depth < mNameStack.size() ) {
+            group += mNameStack[ depth ];
+        }
+    }
+
+    // Single values take the year of the closest container which has one.
+    int year = aYear;
+    for( auto iter = mYearStack.rbegin(); year == -1 && iter != mYearStack.rend(); ++iter ) {
+        year = *iter;
+    }
+    mTotals[ make_pair( group, year ) ] += aValue;
+}
+
+template<>
+void QuerySummaryWriter::processData<Value>( Value& aData ) {
+    addValue( aData, -1 );
+}
+
+template<>
+void QuerySummaryWriter::processData<double>( double& aData ) {
+    addValue( aData, -1 );
+}
+
+template<>
+void QuerySummaryWriter::processData<objects::PeriodVector<Value> >( objects::PeriodVector<Value>& aData ) {
+    const Modeltime* modeltime = scenario->getModeltime();
+    for( size_t period = 0; period < aData.size(); ++period ) {
+        addValue( aData[ period ], modeltime->getper_to_yr( period ) );
+    }
+}
+
+template<>
+void QuerySummaryWriter::processData<objects::PeriodVector<double> >( objects::PeriodVector<double>& aData ) {
+    const Modeltime* modeltime = scenario->getModeltime();
+    for( size_t period = 0; period < aData.size(); ++period ) {
+        addValue( aData[ period ], modeltime->getper_to_yr( period ) );
+    }
+}
+
+template<>
+void QuerySummaryWriter::processData<objects::YearVector<Value> >( objects::YearVector<Value>& aData ) {
+    int year = aData.getStartYear();
+    for( auto iter = aData.begin(); iter != aData.end(); ++iter, ++year ) {
+        addValue( *iter, year );
+    }
+}
+
+template<>
+void QuerySummaryWriter::processData<objects::YearVector<double> >( objects::YearVector<double>& aData ) {
+    int year = aData.getStartYear();
+    for( auto iter = aData.begin(); iter != aData.end(); ++iter, ++year ) {
+        addValue( *iter, year );
+    }
+}
+
+template<typename DataType>
+void QuerySummaryWriter::processData( DataType& aData ) {
+    // Only numeric Data is summarized.
+}
+
+template<typename DataType>
+void QuerySummaryWriter::pushFilterStep( const DataType& aData ) {
+    // Containers are always stepped into through a pointer to them.
+    mNameStack.push_back( getContainerName( aData ) );
+    mYearStack.push_back( getContainerYear( aData ) );
+}
+
+template<typename DataType>
+void QuerySummaryWriter::popFilterStep( const DataType& aData ) {
+    mNameStack.pop_back();
+    mYearStack.pop_back();
+}
@@ -97,7 +97,8 @@
 #include "containers/include/national_account.h"
 #include "sectors/include/more_sector_info.h"
 #include "util/base/include/util.h"
-#include "reporting/include/indirect_emissions_calculator.h"
+#include "reporting/include/query_output_filter.h"
+#include "reporting/include/async_output_sink.h"
 #include "technologies/include/default_technology.h"
 #include "technologies/include/iproduction_state.h"
 #include "util/base/include/auto_file.h"
@@ -109,6 +110,7 @@
 #include "land_allocator/include/land_use_history.h"
 #include "ccarbon_model/include/carbon_model_utils.h"
 #include "util/base/include/version.h"
+#include "util/base/include/gcam_mpi.h"
 #include "consumers/include/gcam_consumer.h"
 #include "functions/include/building_node_input.h"
 #include "functions/include/building_service_input.h"
@@ -127,6 +129,7 @@
 #if( !__HAVE_JAVA__ )
 #include <boost/iostreams/device/null.hpp>
 #endif
+#include <boost/iostreams/device/back_inserter.hpp>
 
 #include <ctime>
 
@@ -134,6 +137,7 @@
 #include <sstream>
 
 #include <boost/math/tr1.hpp>
+#include <boost/algorithm/string.hpp>
 
 #include "reporting/include/xml_db_outputter.h"
 
@@ -150,6 +154,10 @@ using namespace boost::iostreams;
 // Static initialize the JavaVM to be null
 JavaVM* XMLDBOutputter::JNIContainer::mJavaVM = 0;
 
+// The same buffer size as the one used in Java, if we try to tune this we should
+// adjust it both here and in Java.
+const streamsize XMLDBOutputter::SendToJavaIOSink::BUFFER_SIZE = 1024 * 1024;
+
 /*!
  * \brief Constructor for the JNI container.
  * \see createContainer()
@@ -197,11 +205,71 @@ mGDP( 0 )
 
 #if( __HAVE_JAVA__ )
     // Set Java as the sink of data for mBuffer.
-    SendToJavaIOSink sendToJavaSink( mJNIContainer.get() );
-    mBuffer.push( sendToJavaSink );
+    const Configuration* conf = Configuration::getInstance();
+    bool useAsyncSink = false;
+#if GCAM_PARALLEL_ENABLED
+    // Hand the data to Java on a writer thread so that visiting the model and
+    // writing to the database overlap.  The writer thread must attach to the
+    // JVM itself and so creates its own sink with its own Java environment.
+    useAsyncSink = mJNIContainer.get() && conf->getBool( "async-xmldb-output", false );
+    if( useAsyncSink ) {
+        const JNIContainer* jniContainer = mJNIContainer.get();
+        boost::shared_ptr<SendToJavaIOSink> threadSink;
+        const AsyncOutputSink::WriteFunction writer =
+            [jniContainer, threadSink]( const char* aData, streamsize aLength ) mutable {
+                if( !threadSink.get() ) {
+                    JNIEnv* javaEnv = 0;
+                    JNIContainer::mJavaVM->AttachCurrentThread( (void**)&javaEnv, 0 );
+                    threadSink.reset( new SendToJavaIOSink( jniContainer, javaEnv ) );
+                }
+                threadSink->write( aData, aLength );
+            };
+        mBuffer.push( AsyncOutputSink( writer, [] { JNIContainer::mJavaVM->DetachCurrentThread(); },
+                                       SendToJavaIOSink::BUFFER_SIZE,
+                                       conf->getInt( "xmldb-output-buffer-chunks", 8 ) ) );
+    }
+#endif
+    if( !useAsyncSink ) {
+        SendToJavaIOSink sendToJavaSink( mJNIContainer.get(),
+                                         mJNIContainer.get() ? mJNIContainer->mJavaEnv : 0 );
+        mBuffer.push( sendToJavaSink );
+    }
 #else
     mBuffer.push( null_sink() );
 #endif
+
+    // Only write the data read by a list of queries if one was given.
+    const string filterFile = Configuration::getInstance()->getFile( "xmldb-query-filter", "", false );
+    if( !filterFile.empty() ) {
+        mQueryFilter.reset( new QueryOutputFilter() );
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        if( XMLHelper<void>::parseXML( filterFile, mQueryFilter.get() ) ) {
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "Writing only the " << mQueryFilter->getNumRequired()
+                    << " data elements read by the queries in " << filterFile << "." << endl;
+        }
+        else {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not read the query filter " << filterFile << ", all data will be written." << endl;
+            mQueryFilter.reset();
+        }
+    }
+}
+
+/*!
+ * \brief Constructor for a visitor of a single region which writes to a buffer
+ *        of its own rather than to the database.
+ * \param aParent The visitor which will merge the output.
+ */
+XMLDBOutputter::XMLDBOutputter( const XMLDBOutputter* aParent ):
+mTabs( new Tabs( *aParent->mTabs ) ),
+mGDP( 0 ),
+mQueryFilter( aParent->mQueryFilter )
+#if( __HAVE_JAVA__ )
+,mJNIContainer( 0 )
+#endif
+{
+    mBuffer.push( back_insert_device<string>( mRegionData ) );
 }
 
 /*!
@@ -212,6 +280,24 @@ mGDP( 0 )
 XMLDBOutputter::~XMLDBOutputter(){
 }
 
+/*!
+ * \brief Create a visitor which writes a single region to a buffer.
+ * \return The region visitor.
+ */
+IVisitor* XMLDBOutputter::createRegionVisitor() const {
+    return new XMLDBOutputter( this );
+}
+
+/*!
+ * \brief Write the buffered output of a region visitor to the database.
+ * \param aRegionVisitor A visitor created by createRegionVisitor.
+ */
+void XMLDBOutputter::mergeRegionVisitor( IVisitor* aRegionVisitor ) {
+    XMLDBOutputter* regionVisitor = static_cast<XMLDBOutputter*>( aRegionVisitor );
+    regionVisitor->mBuffer.flush();
+    mBuffer.write( regionVisitor->mRegionData.data(), regionVisitor->mRegionData.size() );
+}
+
 /*!
  * \brief A utility method which can be used as a preliminary check to make sure
  *        all of the various compononents and libraries required to write to the
@@ -384,7 +470,7 @@ auto_ptr<XMLDBOutputter::JNIContainer> XMLDBOutputter::createContainer( const bo
     }
 
     // Get the location to open the environment.
-    string xmldbContainerName = conf->getFile( "xmldb-location", "database_basexdb" );
+    string xmldbContainerName = GcamMPI::getRankFileName( conf->getFile( "xmldb-location", "database_basexdb" ) );
     if( conf->shouldAppendScnToFile( "xmldb-location") ) {
         // note that util::appendScenarioToFileName searches for a '.' between which to insert
         // the scenario name however a '.' is not a valid character in a BaseX DB name so we
@@ -527,16 +613,6 @@ void XMLDBOutputter::startVisitRegion( const Region* aRegion,
     // Store the region name.
     assert( mCurrentRegion.empty() );
     mCurrentRegion = aRegion->getName();
-
-    // Calculate indirect emissions coefficients for all Technologies in a Region.
-    mIndirectEmissCalc.reset( new IndirectEmissionsCalculator );
-
-    // The XML db outputter is always called in all-period mode but the indirect
-    // emissions calculator only works in single period mode.
-    assert( aPeriod == -1 );
-    for( int m = 0; m < scenario->getModeltime()->getmaxper(); ++m ){
-        aRegion->accept( mIndirectEmissCalc.get(), m );
-    }
 }
 
 void XMLDBOutputter::endVisitRegion( const Region* aRegion,
@@ -852,12 +928,14 @@ void XMLDBOutputter::startVisitTechnology( const Technology* aTechnology, const
     mBufferStack.push( parentBuffer );
     mBufferStack.push( childBuffer );
 
-    if( !objects::isEqual<double>( aTechnology->getShareWeight(), 0.0 ) ) {
+    if( isRequired( "share-weight" ) && !objects::isEqual<double>( aTechnology->getShareWeight(), 0.0 ) ) {
         XMLWriteElement( aTechnology->getShareWeight(), "share-weight", *childBuffer, mTabs.get() );
     }
 
     // Do not write out default capacity factor of 1
-    XMLWriteElementCheckDefault( aTechnology->getCapacityFactor(), "capacity-factor", *childBuffer, mTabs.get() , 1.0 );
+    if( isRequired( "capacity-factor" ) ) {
+        XMLWriteElementCheckDefault( aTechnology->getCapacityFactor(), "capacity-factor", *childBuffer, mTabs.get() , 1.0 );
+    }
 
     // children of technology go in the child buffer
     for( int curr = 0; curr <= aPeriod; ++curr ){
@@ -968,7 +1046,7 @@ void XMLDBOutputter::startVisitInput( const IInput* aInput, const int aPeriod )
         // Avoid writing zeros to save space.
         // Write price paid for input.
         double currValue;
-        if( !aInput->hasTypeFlag( IInput::ENERGY ) ) {
+        if( !aInput->hasTypeFlag( IInput::ENERGY ) && isRequired( "price-paid" ) ) {
             currValue = aInput->getPricePaid( mCurrentRegion, i );
             if( !objects::isEqual<double>( currValue, 0.0 ) ) {
                 attrs[ "unit" ] = mCurrentPriceUnit;
@@ -979,7 +1057,7 @@ void XMLDBOutputter::startVisitInput( const IInput* aInput, const int aPeriod )
 
         // Write physical demand (not currency demand) for input.
         currValue = aInput->getPhysicalDemand( i );
-        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+        if( isRequired( "demand-physical" ) && !objects::isEqual<double>( currValue, 0.0 ) ) {
             attrs[ "unit" ] = "";
             if ( aInput->hasTypeFlag( IInput::ENERGY ) ) {
                // get the unit for this input good from the marketplace
@@ -999,7 +1077,7 @@ void XMLDBOutputter::startVisitInput( const IInput* aInput, const int aPeriod )
 
         // Write currency demand for input.
         currValue = aInput->getCurrencyDemand( i );
-        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+        if( isRequired( "demand-currency" ) && !objects::isEqual<double>( currValue, 0.0 ) ) {
             attrs[ "unit" ] = mCurrentPriceUnit;
             XMLWriteElementWithAttributes( currValue, "demand-currency", *childBuffer,
                 mTabs.get(), attrs );
@@ -1007,7 +1085,7 @@ void XMLDBOutputter::startVisitInput( const IInput* aInput, const int aPeriod )
 
         // Write the IO coefficient for the input.
         currValue = aInput->getCoefficient( i );
-        if( !objects::isEqual<double>( currValue, 0.0 ) &&
+        if( isRequired( "IO-coefficient" ) && !objects::isEqual<double>( currValue, 0.0 ) &&
             // hack to avoid writing out IO-coefficient for non-energy inputs
             !objects::isEqual<double>( aInput->getPhysicalDemand( i ), 0.0 ) )
         {
@@ -1018,7 +1096,7 @@ void XMLDBOutputter::startVisitInput( const IInput* aInput, const int aPeriod )
 
         // Write the carbon content of the input.
         currValue = aInput->getCarbonContent( i );
-        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+        if( isRequired( "carbon-content" ) && !objects::isEqual<double>( currValue, 0.0 ) ) {
             attrs[ "unit" ] = "MTC";
             XMLWriteElementWithAttributes( currValue, "carbon-content", *childBuffer,
                 mTabs.get(), attrs );
@@ -1082,7 +1160,7 @@ void XMLDBOutputter::startVisitOutput( const IOutput* aOutput, const int aPeriod
         // Avoid writing zeros to save space.
         // Write physical output for each output.
         double currValue = aOutput->getPhysicalOutput( curr );
-        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+        if( isRequired( "physical-output" ) && !objects::isEqual<double>( currValue, 0.0 ) ) {
             XMLWriteElementWithAttributes( currValue, "physical-output", *childBuffer,
                 mTabs.get(), attrs );
         }
@@ -1090,7 +1168,7 @@ void XMLDBOutputter::startVisitOutput( const IOutput* aOutput, const int aPeriod
         // from currency to physical and vice-versa so for the sake of saving space maybe
         // don't write both?
         currValue = aOutput->getCurrencyOutput( curr );
-        if( !objects::isEqual<double>( currValue, 0.0 ) ) {
+        if( isRequired( "currency-output" ) && !objects::isEqual<double>( currValue, 0.0 ) ) {
             XMLWriteElementWithAttributes( currValue, "currency-output", *childBuffer,
                 mTabs.get(), attrs );
         }
@@ -1172,7 +1250,7 @@ void XMLDBOutputter::startVisitGHG( const AGHG* aGHG, const int aPeriod ){
         currEmission = aGHG->getEmission( i );
         // Avoid writing zeros to save space.
         // Write GHG emissions.
-        if( !objects::isEqual<double>( currEmission, 0.0 ) ) {
+        if( isRequired( "emissions" ) && !objects::isEqual<double>( currEmission, 0.0 ) ) {
             XMLWriteElementWithAttributes( currEmission, "emissions",
                 *childBuffer, mTabs.get(), attrs );
         }
@@ -1183,7 +1261,7 @@ void XMLDBOutputter::startVisitGHG( const AGHG* aGHG, const int aPeriod ){
         currEmission = mCurrentTechnology && mCurrentTechnology->mCaptureComponent ?
             mCurrentTechnology->mCaptureComponent->getSequesteredAmount( aGHG->getName(), true, i ) +
             mCurrentTechnology->mCaptureComponent->getSequesteredAmount( aGHG->getName(), false, i ) : 0.0;
-        if( !objects::isEqual<double>( currEmission, 0.0 ) ) {
+        if( isRequired( "emissions-sequestered" ) && !objects::isEqual<double>( currEmission, 0.0 ) ) {
             XMLWriteElementWithAttributes( currEmission, "emissions-sequestered",
                 *childBuffer, mTabs.get(), attrs );
         }
@@ -1290,55 +1368,68 @@ void XMLDBOutputter::startVisitClimateModel( const IClimateModel* aClimateModel,
     assert( aPeriod == -1 );
     // Write the opening tag.
     XMLWriteOpeningTag( "climate-model", mBuffer, mTabs.get() );
+    const Configuration* conf = Configuration::getInstance();
     int outputInterval
-        = Configuration::getInstance()->getInt( "climateOutputInterval",
-                                   scenario->getModeltime()->gettimestep( 0 ) );
+        = conf->getInt( "climateOutputInterval",
+                        scenario->getModeltime()->gettimestep( 0 ) );
 
     // print at least to 2100 if interval is set appropriately
-    int endingYear = max( scenario->getModeltime()->getEndYear(), 2100 );
+    const int startingYear = conf->getInt( "climate-output-start-year",
+                                           scenario->getModeltime()->getStartYear(), false );
+    const int endingYear = conf->getInt( "climate-output-end-year",
+                                         max( scenario->getModeltime()->getEndYear(), 2100 ), false );
+
+    // The outputs to write, given as a semicolon separated list.
+    mClimateOutputVariables.clear();
+    const string variables = conf->getString( "climate-output-variables", "", false );
+    if( !variables.empty() ) {
+        vector<string> names;
+        boost::split( names, variables, boost::is_any_of( ";" ), boost::token_compress_on );
+        mClimateOutputVariables.insert( names.begin(), names.end() );
+    }
 
     // Write the concentrations for the request period.
-    for( int year = scenario->getModeltime()->getStartYear();
+    for( int year = startingYear;
          year <= endingYear; year += outputInterval )
     {
-         writeItemUsingYear( "CO2-concentration", "PPM",
+         writeClimateItem( "CO2-concentration", "PPM",
                              aClimateModel->getConcentration( "CO2", year ),
                              year );
-         writeItemUsingYear( "CH4-concentration", "PPB",
+         writeClimateItem( "CH4-concentration", "PPB",
                              aClimateModel->getConcentration( "CH4", year ),
                              year );
-         writeItemUsingYear( "N2O-concentration", "PPB",
+         writeClimateItem( "N2O-concentration", "PPB",
                              aClimateModel->getConcentration( "N2O", year ),
                              year );
-         writeItemUsingYear( "C2F6-concentration", "PPT",
+         writeClimateItem( "C2F6-concentration", "PPT",
                              aClimateModel->getConcentration( "C2F6", year ),
                              year );
-         writeItemUsingYear( "HCFC125-concentration", "PPT",
+         writeClimateItem( "HCFC125-concentration", "PPT",
                              aClimateModel->getConcentration( "HCFC125", year ),
                              year );
-         writeItemUsingYear( "HCFC134a-concentration", "PPT",
+         writeClimateItem( "HCFC134a-concentration", "PPT",
                              aClimateModel->getConcentration( "HCFC134A", year ),
                              year );
-         writeItemUsingYear( "HCFC143A-concentration", "PPT",
+         writeClimateItem( "HCFC143A-concentration", "PPT",
                              aClimateModel->getConcentration( "HCFC143A", year ),
                              year );
-         writeItemUsingYear( "HCFC245fa-concentration", "PPT",
+         writeClimateItem( "HCFC245fa-concentration", "PPT",
                              aClimateModel->getConcentration( "HCFC245fa", year ),
                              year );
-         writeItemUsingYear( "SF6-concentration", "PPT",
+         writeClimateItem( "SF6-concentration", "PPT",
                              aClimateModel->getConcentration( "SF6", year ),
                              year );
-         writeItemUsingYear( "CF4-concentration", "PPT",
+         writeClimateItem( "CF4-concentration", "PPT",
                              aClimateModel->getConcentration( "CF4", year ),
                              year );
     }
 
     // Write total radiative forcing
-    for( int year = scenario->getModeltime()->getStartYear();
+    for( int year = startingYear;
          year <= endingYear; year += outputInterval )
     {
         // Kyoto Forcing
-        writeItemUsingYear( "forcing-Kyoto", "W/m^2",
+        writeClimateItem( "forcing-Kyoto", "W/m^2",
                              aClimateModel->getForcing( "CO2", util::round( year ) )
         + aClimateModel->getForcing( "CH4", util::round( year ) )
         + aClimateModel->getForcing( "N2O", util::round( year ) )
@@ -1354,7 +1445,7 @@ void XMLDBOutputter::startVisitClimateModel( const IClimateModel* aClimateModel,
                              year );
 
         // Long-lived Forcing
-        writeItemUsingYear( "forcing-longlived", "W/m^2",
+        writeClimateItem( "forcing-longlived", "W/m^2",
                              aClimateModel->getForcing( "CO2", util::round( year ) )
         + aClimateModel->getForcing( "CH4", util::round( year ) )
         + aClimateModel->getForcing( "N2O", util::round( year ) )
@@ -1371,7 +1462,7 @@ void XMLDBOutputter::startVisitClimateModel( const IClimateModel* aClimateModel,
                              year );
 
                 // Long-lived Forcing
-        writeItemUsingYear( "forcing-halocarbons", "W/m^2",
+        writeClimateItem( "forcing-halocarbons", "W/m^2",
         aClimateModel->getForcing( "HCFC125", util::round( year ) )
         + aClimateModel->getForcing( "HCFC134A", util::round( year ) )
         + aClimateModel->getForcing( "HCFC143A", util::round( year ) )
@@ -1385,91 +1476,91 @@ void XMLDBOutputter::startVisitClimateModel( const IClimateModel* aClimateModel,
                              year );
 
         // CO2 Forcing
-        writeItemUsingYear( "forcing-CO2", "W/m^2",
+        writeClimateItem( "forcing-CO2", "W/m^2",
                              aClimateModel->getForcing( "CO2", util::round( year ) ),
                              year );
 		
 		// CH4 Forcing
-        writeItemUsingYear( "forcing-CH4", "W/m^2",
+        writeClimateItem( "forcing-CH4", "W/m^2",
 						   aClimateModel->getForcing( "CH4", util::round( year ) ),
 						   year );
 		
 		// N2O Forcing
-        writeItemUsingYear( "forcing-N2O", "W/m^2",
+        writeClimateItem( "forcing-N2O", "W/m^2",
 						   aClimateModel->getForcing( "N2O", util::round( year ) ),
 						   year );
 		
 		// SO2 Forcing
-        writeItemUsingYear( "forcing-SO2", "W/m^2",
+        writeClimateItem( "forcing-SO2", "W/m^2",
 						   aClimateModel->getForcing( "SO2", util::round( year ) ),
 						   year );
 		
 		// DirSO2 Forcing
-        writeItemUsingYear( "forcing-DirSO2", "W/m^2",
+        writeClimateItem( "forcing-DirSO2", "W/m^2",
 						   aClimateModel->getForcing( "DirSO2", util::round( year ) ),
 						   year );
 		
 		// TropO3 Forcing
-        writeItemUsingYear( "forcing-TropO3", "W/m^2",
+        writeClimateItem( "forcing-TropO3", "W/m^2",
 						   aClimateModel->getForcing( "TropO3", util::round( year ) ),
 						   year );
 		
 		// BC Forcing
-        writeItemUsingYear( "forcing-BC", "W/m^2",
+        writeClimateItem( "forcing-BC", "W/m^2",
 						   aClimateModel->getForcing( "BC", util::round( year ) ),
 						   year );
 		
 		// OC Forcing
-        writeItemUsingYear( "forcing-OC", "W/m^2",
+        writeClimateItem( "forcing-OC", "W/m^2",
 						   aClimateModel->getForcing( "OC", util::round( year ) ),
 						   year );
 		
 		// long-lived F-gas Forcing
-        writeItemUsingYear( "forcing-longlivedFgas", "W/m^2",
+        writeClimateItem( "forcing-longlivedFgas", "W/m^2",
 						   aClimateModel->getForcing( "SF6", util::round( year ) )
 						   + aClimateModel->getForcing( "CF4", util::round( year ) )
 						   + aClimateModel->getForcing( "C2F6", util::round( year ) ),
 						   year );
 		
 		// Montreal gas Forcing
-        writeItemUsingYear( "forcing-Montreal", "W/m^2",
+        writeClimateItem( "forcing-Montreal", "W/m^2",
 						   aClimateModel->getForcing( "Montreal", util::round( year ) ),
 						   year );
 		
         // Total Forcing
-        writeItemUsingYear( "forcing-total", "W/m^2",
+        writeClimateItem( "forcing-total", "W/m^2",
                             aClimateModel->getTotalForcing( year ),
                              year );
         
         // RCP Forcing
-        writeItemUsingYear( "forcing-RCP", "W/m^2",
+        writeClimateItem( "forcing-RCP", "W/m^2",
                            aClimateModel->getForcing( "RCP", year ),
                            year );
      }
 
     // Write net terrestrial uptake
-    for( int year = scenario->getModeltime()->getStartYear();
+    for( int year = startingYear;
          year <= endingYear; year += outputInterval )
     {
-        writeItemUsingYear( "net-terrestrial-uptake", "GtC",
+        writeClimateItem( "net-terrestrial-uptake", "GtC",
                              aClimateModel->getNetTerrestrialUptake( year ),
                              year );
     }
 
     // Write net ocean uptake
-    for( int year = scenario->getModeltime()->getStartYear();
+    for( int year = startingYear;
          year <= endingYear; year += outputInterval )
     {
-        writeItemUsingYear( "net-ocean-uptake", "GtC",
+        writeClimateItem( "net-ocean-uptake", "GtC",
                              aClimateModel->getNetOceanUptake( year ),
                              year );
     }
 
     // Global-mean temperature
-    for( int year = scenario->getModeltime()->getStartYear();
+    for( int year = startingYear;
          year <= endingYear; year += outputInterval )
     {
-        writeItemUsingYear( "global-mean-temperature", "degreesC",
+        writeClimateItem( "global-mean-temperature", "degreesC",
                              aClimateModel->getTemperature( year ),
                              year );
     }
@@ -2048,6 +2139,10 @@ void XMLDBOutputter::writeItemToBuffer( const double aValue,
                                         const int aPeriod,
                                         const string& aUnit )
 {
+    if( !isRequired( aName ) ) {
+        return;
+    }
+
     map<string, string> attributeMap;
     attributeMap[ "unit" ] = aUnit;
     int year = 0;
@@ -2099,6 +2194,10 @@ void XMLDBOutputter::writeItemUsingYear( const string& aName,
                                          const double aValue,
                                          const int aYear )
 {
+    if( !isRequired( aName ) ) {
+        return;
+    }
+
     map<string, string> attributeMap;
     attributeMap[ "unit" ] = aUnit;
 
@@ -2109,6 +2208,35 @@ void XMLDBOutputter::writeItemUsingYear( const string& aName,
                                    attributeMap );
 }
 
+/*!
+ * \brief Write a single climate model item to the XML database if it was
+ *        selected by the climate-output-variables configuration value.
+ * \param aName Element name.
+ * \param aUnit Unit of the item.
+ * \param aValue Value to write.
+ * \param aYear Year of the value.
+ * \see writeItemUsingYear
+ */
+void XMLDBOutputter::writeClimateItem( const string& aName,
+                                       const string& aUnit,
+                                       const double aValue,
+                                       const int aYear )
+{
+    if( mClimateOutputVariables.empty() || mClimateOutputVariables.count( aName ) ) {
+        writeItemUsingYear( aName, aUnit, aValue, aYear );
+    }
+}
+
+/*!
+ * \brief Whether a data element should be written.
+ * \details All elements are written unless a query filter was given.
+ * \param aElementName The name of the data element.
+ * \return Whether to write the element.
+ */
+bool XMLDBOutputter::isRequired( const string& aElementName ) const {
+    return !mQueryFilter.get() || mQueryFilter->isRequired( aElementName );
+}
+
 /**
  * \brief Function to test if technology is operating.
  * \return True or false.
@@ -2196,15 +2324,13 @@ map<string, string> XMLDBOutputter::decomposeLandName( string aLandName ) {
  * \param aJNIContainer A weak pointer to the container which holds the Java VM
  *                      references.  May be null if it did not initialize properly.
  */
-XMLDBOutputter::SendToJavaIOSink::SendToJavaIOSink( const JNIContainer* aJNIContainer )
+XMLDBOutputter::SendToJavaIOSink::SendToJavaIOSink( const JNIContainer* aJNIContainer, JNIEnv* aJavaEnv )
 :mJNIContainer( aJNIContainer ),
+mJavaEnv( aJavaEnv ),
 // Get the receiveDataFromGCAM method from the write DB class with arguments of a byte
 // array "[B", an integer "I", and a return type of bool "Z" 
-mReceiveDataMID( aJNIContainer ? aJNIContainer->mJavaEnv->GetMethodID( aJNIContainer->mWriteDBClass, "receiveDataFromGCAM", "([BI)Z") : 0 ),
-// The same buffer size as the one used in Java, if we try to tune this we should
-// adjust it both here and in Java.
-BUFFER_SIZE( 1024 * 1024 ),
-mJNIBuffer( aJNIContainer ? aJNIContainer->mJavaEnv->NewByteArray( BUFFER_SIZE  ) : 0 ),
+mReceiveDataMID( aJNIContainer && aJavaEnv ? aJavaEnv->GetMethodID( aJNIContainer->mWriteDBClass, "receiveDataFromGCAM", "([BI)Z") : 0 ),
+mJNIBuffer( aJNIContainer && aJavaEnv ? aJavaEnv->NewByteArray( BUFFER_SIZE  ) : 0 ),
 // If any of the required JNI data structures were not properly set then set the error flag.
 mErrorFlag( !mJNIContainer || !mReceiveDataMID || !mJNIBuffer )
 {
@@ -2230,8 +2356,8 @@ streamsize XMLDBOutputter::SendToJavaIOSink::write( const char *aData, std::stre
     const jbyte* jniData = reinterpret_cast<const jbyte*>( aData );
     while( !mErrorFlag && offset < aLength ) {
         streamsize numRead = min( aLength - offset, BUFFER_SIZE );
-        mJNIContainer->mJavaEnv->SetByteArrayRegion( mJNIBuffer, 0, numRead, jniData+offset );
-        mErrorFlag = mJNIContainer->mJavaEnv->CallBooleanMethod( mJNIContainer->mWriteDBInstance,
+        mJavaEnv->SetByteArrayRegion( mJNIBuffer, 0, numRead, jniData+offset );
+        mErrorFlag = mJavaEnv->CallBooleanMethod( mJNIContainer->mWriteDBInstance,
             mReceiveDataMID, mJNIBuffer, numRead );
         offset += numRead;
     }
@@ -47,6 +47,7 @@
 #include <vector>
 #include "resources/include/aresource.h"
 #include "util/base/include/value.h"
+#include "marketplace/include/cached_market_vector.h"
 
 /*! 
  * \ingroup Objects
@@ -142,6 +143,9 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "price", mInitialPrice, Value )
     )
 
+    //! The market for this resource located during initCalc.
+    CachedMarketVector mCachedMarket;
+
     void setMarket( const std::string& aRegionName );
 };
 
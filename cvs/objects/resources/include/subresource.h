@@ -45,6 +45,7 @@
 * \author Sonny Kim
 */
 #include <memory>
+#include <vector>
 #include <xercesc/dom/DOMNode.hpp>
 #include <boost/core/noncopyable.hpp>
 
@@ -105,6 +106,8 @@ protected:
     virtual bool XMLDerivedClassParse( const std::string& nodeName, const xercesc::DOMNode* node ) = 0;
     virtual void toXMLforDerivedClass( std::ostream& out, Tabs* tabs ) const;
 
+    size_t findGrade( const double aPrice, const int aPeriod ) const;
+
     DEFINE_DATA(
         /* Declare all subclasses of SubResource to allow automatic traversal of the
          * hierarchy under introspection.
@@ -150,6 +153,18 @@ protected:
     
     //!< The subsector's information store.
     std::auto_ptr<IInfo> mSubresourceInfo;
+
+    //! The cost of each grade in the current period, set in initCalc so that
+    //! the supply calculations do not need to query each grade and so that
+    //! the grade a price falls in can be found with a binary search.
+    std::vector<double> mGradeCosts;
+
+    //! The sum of the amount available of each grade and those before it.
+    std::vector<double> mCumulGradeAvail;
+
+    //! The period mGradeCosts were set for, or -1 if the grade costs are not
+    //! in increasing order and must be searched linearly.
+    int mGradeCostPeriod;
 };
 
 
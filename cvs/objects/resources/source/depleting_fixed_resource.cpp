@@ -180,6 +180,7 @@ void DepletingFixedResource::initCalc( const string& aRegionName,
                                                           true );
     assert( marketInfo );
     marketInfo->setDouble( "depleted-resource", 0 );
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
     if( aPeriod > 0 ) {
         // get the depletion from the previous period and subtract it
         // from the current quantity
@@ -239,10 +240,8 @@ void DepletingFixedResource::calcSupply( const string& aRegionName,
                                     const GDP* aGDP,
                                     const int aPeriod )
 {
-    Marketplace* marketplace = scenario->getMarketplace();
-
     // the supply is just the fixed amount that is left.
-    marketplace->addToSupply( mName, aRegionName, mFixedResource, aPeriod );
+    mCachedMarket.addToSupply( mName, aRegionName, mFixedResource, aPeriod );
 }
 
 double DepletingFixedResource::getAnnualProd( const string& aRegionName,
@@ -260,8 +259,8 @@ double DepletingFixedResource::getPrice( const int aPeriod ) const {
 void DepletingFixedResource::csvOutputFile( const string& aRegionName )
 {
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     const int maxper = scenario->getModeltime()->getmaxper();
     vector<double> temp( maxper );
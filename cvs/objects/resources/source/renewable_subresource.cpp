@@ -158,31 +158,28 @@ void SubRenewableResource::annualsupply( int aPeriod, const GDP* aGdp, double aP
     double fractionAvailable = -1;
     const double effectivePrice = aPrice + mPriceAdder[ aPeriod ];
 
-    // Move up the cost curve until a point is found above the current price.
-    for ( unsigned int i = 0; i < mGrade.size(); ++i ) {
-        if( effectivePrice <= mGrade[ i ]->getCost( aPeriod ) ) {
-            if( i == 0 ) {
-                // Below the bottom of the supply curve which means the fraction
-                // available is zero.
-                fractionAvailable = 0;
-            }
-            else {
-                // Determine the cost and available for the previous
-                // point. 
-                double prevGradeCost = mGrade[ i - 1 ]->getCost( aPeriod );
-                double prevGradeAvailable = mGrade[ i - 1 ]->getAvail();
-
-                // This should not be able to happen because the above if
-                // statement would fail.
-                assert( mGrade[ i ]->getCost( aPeriod ) > prevGradeCost );
-                double gradeFraction = ( effectivePrice - prevGradeCost )
-                    / ( mGrade[ i ]->getCost( aPeriod ) - prevGradeCost );
-                // compute production as fraction of total possible
-                fractionAvailable = prevGradeAvailable + gradeFraction
-                    * ( mGrade[ i ]->getAvail() - prevGradeAvailable ); 
-            }
+    // Find the first point on the cost curve which is not below the current price.
+    const size_t i = findGrade( effectivePrice, aPeriod );
+    if( i < mGrade.size() ) {
+        if( i == 0 ) {
+            // Below the bottom of the supply curve which means the fraction
+            // available is zero.
+            fractionAvailable = 0;
+        }
+        else {
+            // Determine the cost and available for the previous
+            // point. 
+            double prevGradeCost = mGrade[ i - 1 ]->getCost( aPeriod );
+            double prevGradeAvailable = mGrade[ i - 1 ]->getAvail();
 
-            break;
+            // This should not be able to happen because the above if
+            // statement would fail.
+            assert( mGrade[ i ]->getCost( aPeriod ) > prevGradeCost );
+            double gradeFraction = ( effectivePrice - prevGradeCost )
+                / ( mGrade[ i ]->getCost( aPeriod ) - prevGradeCost );
+            // compute production as fraction of total possible
+            fractionAvailable = prevGradeAvailable + gradeFraction
+                * ( mGrade[ i ]->getAvail() - prevGradeAvailable ); 
         }
     }
 
@@ -343,7 +343,7 @@ void Resource::initCalc( const string& aRegionName, const int aPeriod ) {
     // The GHG objects will need to check the following flags to properly
     // initialize and do error checking.
     mResourceInfo->setBoolean( "new-vintage-tech", true );
-    mResourceInfo->setBoolean( "is-tech-operating", true );
+    mResourceInfo->setBoolean( InfoKeys::eIsTechOperating, true );
     for( unsigned int i = 0; i < mGHG.size(); i++ ) {
         mGHG[ i ]->initCalc( aRegionName, mResourceInfo.get(), aPeriod );
     }
@@ -516,8 +516,8 @@ double Resource::getPrice( const int aPeriod ) const {
 void Resource::csvOutputFile( const string& regname )
 {
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     // function arguments are variable name, double array, db name, table name
     // the function writes all years
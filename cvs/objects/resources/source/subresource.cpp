@@ -43,6 +43,7 @@
 #include <string>
 #include <iostream>
 #include <cassert>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -69,7 +70,8 @@ mAnnualProd( Value( 0.0 ) ),
 mCumulProd( Value( 0.0 ) ),
 mCumulativeTechChange( 1.0 ),
 mEffectivePrice( Value( -1.0 ) ),
-mCalProduction( -1.0 )
+mCalProduction( -1.0 ),
+mGradeCostPeriod( -1 )
 {
 }
 
@@ -211,6 +213,18 @@ void SubResource::initCalc( const string& aRegionName, const string& aResourceNa
             mEnvironCost[ aPeriod ], aPeriod );
     }
 
+    // Store the grade costs and cumulative availability contiguously so that
+    // the supply calculations can search them.
+    mGradeCosts.resize( mGrade.size() );
+    mCumulGradeAvail.resize( mGrade.size() );
+    double cumulAvail = 0;
+    for( unsigned int gr = 0; gr < mGrade.size(); ++gr ) {
+        mGradeCosts[ gr ] = mGrade[ gr ]->getCost( aPeriod );
+        cumulAvail += mGrade[ gr ]->getAvail();
+        mCumulGradeAvail[ gr ] = cumulAvail;
+    }
+    mGradeCostPeriod = is_sorted( mGradeCosts.begin(), mGradeCosts.end() ) ? aPeriod : -1;
+
     // Fill price added after it is calibrated.  This will interpolate to any
     // price adders read in the future or just copy forward if there is nothing
     // to interpolate to.
@@ -360,46 +374,60 @@ void SubResource::cumulsupply( double aPrice, int aPeriod )
     mEffectivePrice[ aPeriod ] = aPrice + mPriceAdder[ aPeriod ];
 
     if ( aPeriod > 0 ) {
+        // The grade costs and cumulative availability were stored in initCalc.
+        const double effectivePrice = mEffectivePrice[ aPeriod ];
+
         // Case 1
         // if market price is less than cost of first grade, then zero cumulative 
         // production
-        if ( mEffectivePrice[ aPeriod ] <= mGrade[0]->getCost( aPeriod )) {
+        if ( effectivePrice <= mGradeCosts.front() ) {
             mCumulProd[ aPeriod ] = mCumulProd[ aPeriod - 1 ];
         }
         
         // Case 2
         // if market price is in between cost of first and last grade, then calculate 
         // cumulative production in between those grades
-        if ( mEffectivePrice[ aPeriod ] > mGrade[0]->getCost( aPeriod ) && mEffectivePrice[ aPeriod ] <= mGrade[ mGrade.size() - 1 ]->getCost( aPeriod )) {
-            mCumulProd[ aPeriod ] = 0;
-            int i = 0;
-            int iL = 0;
-            int iU = 0;
-            while ( mGrade[ i ]->getCost( aPeriod ) < mEffectivePrice[ aPeriod ] ) {
-                iL=i; i++; iU=i;
-            }
+        if ( effectivePrice > mGradeCosts.front() && effectivePrice <= mGradeCosts.back() ) {
+            const size_t iU = findGrade( effectivePrice, aPeriod );
+            const size_t iL = iU - 1;
             // add subrsrcs up to the lower grade
-            for ( i = 0; i <= iL; i++ ) {
-                mCumulProd[ aPeriod ] += Value( mGrade[i]->getAvail() );
-            }
+            mCumulProd[ aPeriod ] = mCumulGradeAvail[ iL ];
             // price must reach upper grade cost to produce all of lower grade
-            double slope = mGrade[iL]->getAvail()
-                / ( mGrade[iU]->getCost( aPeriod ) - mGrade[iL]->getCost( aPeriod ) );
-            mCumulProd[ aPeriod ] -= Value( slope * ( mGrade[iU]->getCost( aPeriod ) - mEffectivePrice[ aPeriod ] ) );
+            double slope = mGrade[iL]->getAvail() / ( mGradeCosts[ iU ] - mGradeCosts[ iL ] );
+            mCumulProd[ aPeriod ] -= Value( slope * ( mGradeCosts[ iU ] - effectivePrice ) );
         }
         
         // Case 3
         // if market price greater than the cost of the last grade, then
         // cumulative production is the amount in all grades
-        if ( mEffectivePrice[ aPeriod ] > mGrade[ mGrade.size() - 1 ]->getCost( aPeriod ) ) {
-            mCumulProd[ aPeriod ] = 0;
-            for ( unsigned int i = 0; i < mGrade.size(); i++ ) {
-                mCumulProd[ aPeriod ] += Value( mGrade[i]->getAvail() );
-            }
+        if ( effectivePrice > mGradeCosts.back() ) {
+            mCumulProd[ aPeriod ] = mCumulGradeAvail.back();
         }
     }
 }
 
+/*!
+ * \brief Find the first grade with a cost which is not less than the given
+ *        price.
+ * \details The grade costs stored in initCalc are searched with a binary search
+ *          if they are in increasing order, otherwise the grades are searched
+ *          in order.
+ * \param aPrice The price.
+ * \param aPeriod Model period.
+ * \return The index of the grade, or the number of grades if all of the grades
+ *         cost less than the price.
+ */
+size_t SubResource::findGrade( const double aPrice, const int aPeriod ) const {
+    if( aPeriod == mGradeCostPeriod ) {
+        return lower_bound( mGradeCosts.begin(), mGradeCosts.end(), aPrice ) - mGradeCosts.begin();
+    }
+    size_t i = 0;
+    while( i < mGradeCosts.size() && mGradeCosts[ i ] < aPrice ) {
+        ++i;
+    }
+    return i;
+}
+
 double SubResource::getCumulProd( const int aPeriod ) const {
     return mCumulProd[ aPeriod ];
 }
@@ -516,8 +544,8 @@ void SubResource::dbOutput( const string &regname, const string& secname ){
 void SubResource::csvOutputFile( const string &regname, const string& sname) {
     const Modeltime* modeltime = scenario->getModeltime();
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     const int maxper = modeltime->getmaxper();
     const string outputUnit = mSubresourceInfo->getString( "output-unit", true );
@@ -249,8 +249,8 @@ double UnlimitedResource::getPrice( const int aPeriod ) const {
 void UnlimitedResource::csvOutputFile( const string& aRegionName )
 {
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     const int maxper = scenario->getModeltime()->getmaxper();
     vector<double> temp( maxper );
@@ -113,6 +113,17 @@ public:
                                              const double aReserveMargin,
                                              const double aAverageGridCapacityFactor,
                                              const int aPeriod ) const;
+
+    virtual void calcBackupCapacities( const std::string& aSector,
+                                       const std::string& aElectricSector,
+                                       const std::string& aResource,
+                                       const std::string& aRegion,
+                                       const double aTechCapacityFactor,
+                                       const double aReserveMargin,
+                                       const double aAverageGridCapacityFactor,
+                                       const int aPeriod,
+                                       double& aMarginalBackup,
+                                       double& aAverageBackup ) const;
 protected:
     static const std::string& getXMLNameStatic();
     CapacityLimitBackupCalculator();
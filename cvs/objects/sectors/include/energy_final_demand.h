@@ -169,6 +169,10 @@ protected:
         void updateAEEI( const std::string& aRegionName,
                          const int aPeriod );
 
+        void calibrateAEEI( const std::string& aRegionName,
+                            const double aServiceDemand,
+                            const int aPeriod );
+
         double calcTechChange( const int aPeriod ) const;
 
         void toInputXML( std::ostream& aOut,
@@ -186,6 +190,10 @@ protected:
 
         //! Final energy to calibrate to.
         objects::PeriodVector<Value> mCalFinalEnergy;
+
+        //! Whether the AEEI is back-calculated from the final energy to
+        //! calibrate to instead of solved for by the TFE market.
+        bool mDirectCalibration;
     };
     
     // Define data such that introspection utilities can process the data from this
@@ -133,6 +133,46 @@ public:
                                              const double aReserveMargin,
                                              const double aAverageGridCapacityFactor,
                                              const int aPeriod ) const = 0;
+
+    /*!
+     * \brief Compute both the marginal and the average backup required per
+     *        unit of output.
+     * \details Technologies need both values each time their cost is
+     *          calculated.  Calculators which can share the work between them,
+     *          such as looking up the trial share, should override this.  The
+     *          default calls getMarginalBackupCapacity and
+     *          getAverageBackupCapacity.
+     * \param aSector The name of the sector which requires backup capacity.
+     * \param aElectricSector The name of the electricity sector into which the
+     *        sector having a backup amount calculated for will feed.
+     * \param aResource The name of the resource the sector consumes.
+     * \param aRegion Name of the containing region.
+     * \param aTechCapacityFactor The capacity factor of the technology.
+     * \param aReserveMargin Reserve margin for the electricity sector.
+     * \param aAverageGridCapacityFactor The average electricity grid capacity
+     *        factor.
+     * \param aPeriod Model period.
+     * \param aMarginalBackup [out] The marginal backup capacity required.
+     * \param aAverageBackup [out] The average backup capacity required.
+     */
+    virtual void calcBackupCapacities( const std::string& aSector,
+                                       const std::string& aElectricSector,
+                                       const std::string& aResource,
+                                       const std::string& aRegion,
+                                       const double aTechCapacityFactor,
+                                       const double aReserveMargin,
+                                       const double aAverageGridCapacityFactor,
+                                       const int aPeriod,
+                                       double& aMarginalBackup,
+                                       double& aAverageBackup ) const
+    {
+        aMarginalBackup = getMarginalBackupCapacity( aSector, aElectricSector, aResource, aRegion,
+                                                     aTechCapacityFactor, aReserveMargin,
+                                                     aAverageGridCapacityFactor, aPeriod );
+        aAverageBackup = getAverageBackupCapacity( aSector, aElectricSector, aResource, aRegion,
+                                                   aTechCapacityFactor, aReserveMargin,
+                                                   aAverageGridCapacityFactor, aPeriod );
+    }
     
 protected:
     
@@ -49,6 +49,7 @@
 #include "sectors/include/afinal_demand.h"
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 // Forward declarations
 class GDP;
@@ -119,6 +120,12 @@ protected:
         //! State value necessary to use Marketplace::addToDemand
         DEFINE_VARIABLE( SIMPLE | STATE, "curr-negative-emiss-value", mCurrNegEmissValue, Value )
     )
+
+    //! The emissions market located during initCalc.
+    CachedMarketVector mEmissionsMarket;
+
+    //! The policy market located during initCalc.
+    CachedMarketVector mPolicyMarket;
     
     virtual const std::string& getXMLName() const;
 };
@@ -47,9 +47,11 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
 #include "sectors/include/sector.h"
 
 class IInvestor;
+class IInvestable;
 class Demographic;
 class NationalAccount;
 class MoreSectorInfo;
@@ -158,6 +160,10 @@ private:
     //! in its various technologies. Different types of investment objects may
     //! be read in to change the investment behavior.
     std::auto_ptr<IInvestor> mInvestor;
+
+    //! The subsectors as investables, set in completeInit so that the vector
+    //! is not rebuilt each time investment is distributed.
+    std::vector<IInvestable*> mInvestableSubsecs;
     
     std::auto_ptr<MoreSectorInfo> moreSectorInfo; //! Additional sector information needed below sector
     
@@ -164,7 +164,7 @@ protected:
     virtual const std::string& getXMLName() const = 0;
     
     virtual double getFixedOutput( const int aPeriod ) const;
-    const std::vector<double> calcSubsectorShares( const GDP* aGDP, const int aPeriod ) const;
+    std::vector<double> calcSubsectorShares( const GDP* aGDP, const int aPeriod ) const;
 
     bool outputsAllFixed( const int period ) const;
     
@@ -207,10 +207,10 @@ public:
     virtual void dbOutput( const GDP* aGDP,
                            const IndirectEmissionsCalculator* aIndEmissCalc ) const = 0;
 
-    std::map<std::string, double> getfuelcons( const int period ) const;
+    const std::map<std::string, double>& getfuelcons( const int period ) const;
     double getConsByFuel( const int period, const std::string& key) const;
-    std::map<std::string, double> getemission( const int period ) const;
-    std::map<std::string, double> getemfuelmap( const int period ) const;
+    const std::map<std::string, double>& getemission( const int period ) const;
+    const std::map<std::string, double>& getemfuelmap( const int period ) const;
     void updateSummary( const std::list<std::string>& aPrimaryFuelList, const int period );
 
     virtual void operate( NationalAccount& nationalAccount, const Demographic* aDemographic, const int period ) = 0;
@@ -178,7 +178,7 @@ protected:
     virtual void toDebugXMLDerived( const int period, std::ostream& out, Tabs* tabs ) const {};
     void parseBaseTechHelper( const xercesc::DOMNode* curr, BaseTechnology* aNewTech );
     
-    virtual const std::vector<double> calcTechShares ( const GDP* gdp, const int period ) const;
+    virtual std::vector<double> calcTechShares ( const GDP* gdp, const int period ) const;
 
 public:
     Subsector( const std::string& regionName, const std::string& sectorName );
@@ -207,6 +207,8 @@ public:
     virtual void calcCost( const int aPeriod );
 
     virtual double calcShare( const IDiscreteChoice* aChoiceFn, const GDP* aGDP, const int aPeriod) const;
+    virtual bool getShareTerms( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                                double& aPrice, double& aLogShareAdjustment ) const;
     virtual double getShareWeight( const int period ) const;
 
     virtual void setOutput( const double aVariableDemand,
@@ -243,9 +245,9 @@ public:
                                  const double aNewInvestment,
                                  const int aPeriod );
 
-    std::map<std::string, double> getfuelcons( const int period ) const; 
-    std::map<std::string, double> getemission( const int period ) const;
-    std::map<std::string, double> getemfuelmap( const int period ) const; 
+    const std::map<std::string, double>& getfuelcons( const int period ) const; 
+    const std::map<std::string, double>& getemission( const int period ) const;
+    const std::map<std::string, double>& getemfuelmap( const int period ) const; 
 
     void updateSummary( const std::list<std::string>& aPrimaryFuelList, const int period );
     
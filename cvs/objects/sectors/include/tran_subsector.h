@@ -113,6 +113,12 @@ protected:
     //! Save time value for debugging purposes.
     mutable double mTimeValue;
 
+    //! The factor converting GDP per capita into the time value in each
+    //! period, which combines the time value multiplier, hours worked and speed.
+    objects::PeriodVector<double> mTimeValueScale;
+
+    void calcTimeValueScale( const int aPeriod );
+
     virtual void MCoutputSupplySector( const GDP* aGDP ) const; 
     virtual void MCoutputAllSectors( const GDP* aGDP,
                                      const IndirectEmissionsCalculator* aIndirectEmissionsCalc,
@@ -92,6 +92,14 @@ double AgSupplySubsector::calcShare( const IDiscreteChoice* aChoiceFn, const GDP
     return 1;
 }
 
+bool AgSupplySubsector::getShareTerms( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                                       double& aPrice, double& aLogShareAdjustment ) const
+{
+    // The share is not calculated from the discrete choice function so
+    // calcShare must be used.
+    return false;
+}
+
 void AgSupplySubsector::interpolateShareWeights( const int aPeriod ) {
     // ag sectors do not require share-weigts so do nothing
 }
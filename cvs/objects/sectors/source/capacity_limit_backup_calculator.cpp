@@ -250,6 +250,59 @@ double CapacityLimitBackupCalculator::getAverageBackupCapacity( const string& aS
     return SectorUtils::convertEnergyToCapacity( aTechCapacityFactor, averageBackup );
 }
 
+/*!
+ * \brief Compute both the marginal and the average backup capacity.
+ * \details Gives the same results as getMarginalBackupCapacity and
+ *          getAverageBackupCapacity, but looks up the trial share and
+ *          evaluates the exponential of the backup curve only once.
+ */
+void CapacityLimitBackupCalculator::calcBackupCapacities( const string& aSector,
+                                                          const string& aElectricSector,
+                                                          const string& aResource,
+                                                          const string& aRegion,
+                                                          const double aTechCapacityFactor,
+                                                          const double aReserveMargin,
+                                                          const double aAverageGridCapacityFactor,
+                                                          const int aPeriod,
+                                                          double& aMarginalBackup,
+                                                          double& aAverageBackup ) const
+{
+    // Preconditions
+    assert( !aSector.empty() );
+    assert( !aElectricSector.empty() );
+    assert( !aResource.empty() );
+    assert( !aRegion.empty() );
+    assert( aReserveMargin >= 0 );
+    assert( aAverageGridCapacityFactor > 0 );
+
+    double renewElecShare = std::min( SectorUtils::getTrialSupply( aRegion, aSector, aPeriod ), 1.0 );
+
+    // No backup required for zero share.
+    if( renewElecShare < util::getVerySmallNumber() ){
+        aMarginalBackup = 0;
+        aAverageBackup = 0;
+        return;
+    }
+
+    // Capacity limit must be between 0 and 1 inclusive.
+    assert( mCapacityLimit >= 0 && mCapacityLimit <= 1 );
+
+    double xmid = mCapacityLimit;
+    double capacityRatio = aAverageGridCapacityFactor / aTechCapacityFactor;
+    double capacityShare = renewElecShare * capacityRatio;
+    const double curveExponent = mC * ( xmid - capacityShare ) / mTau;
+    const double curveExp = exp( curveExponent );
+
+    // See getMarginalBackupCapacityFraction and getAverageBackupCapacity for
+    // the derivation of these and their units.
+    double marginalBackup = mFmax / ( 1.0 + curveExp );
+    double totalBackup = mFmax * mTau / mC * ( log ( 1.0 + curveExp ) - curveExponent );
+    double averageBackup = totalBackup / capacityShare;
+
+    aMarginalBackup = SectorUtils::convertEnergyToCapacity( aTechCapacityFactor, marginalBackup );
+    aAverageBackup = SectorUtils::convertEnergyToCapacity( aTechCapacityFactor, averageBackup );
+}
+
 /*!
  * \brief Compute backup required per resource energy output.
  * \details Compute backup required per resource energy output (since energy
@@ -355,6 +355,7 @@ double EnergyFinalDemand::calcFinalDemand( const string& aRegionName,
  
         // Final demand for service adjusted using cummulative technical change.
         if( mFinalEnergyConsumer.get() ){
+            mFinalEnergyConsumer->calibrateAEEI( aRegionName, mServiceDemands[ aPeriod ], aPeriod );
             mServiceDemands[ aPeriod ] /= mFinalEnergyConsumer->calcTechChange( aPeriod );
         }
     }
@@ -443,8 +444,8 @@ void EnergyFinalDemand::acceptDerived( IVisitor* aVisitor,
 //! Write sector output to database.
 void EnergyFinalDemand::csvOutputFile( const string& aRegionName ) const {
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
     
     // function arguments are variable name, double array, db name, table name
     // the function writes all years
@@ -488,6 +489,7 @@ void EnergyFinalDemand::dbOutput( const string& aRegionName ) const {
 
 EnergyFinalDemand::FinalEnergyConsumer::FinalEnergyConsumer( const string& aFinalDemandName ) {
     mTFEMarketName = SectorUtils::createTFEMarketName( aFinalDemandName );
+    mDirectCalibration = false;
 }
 
 double EnergyFinalDemand::PerCapitaGDPDemandFunction::calcDemand(
@@ -591,11 +593,20 @@ void EnergyFinalDemand::FinalEnergyConsumer::completeInit( const string& aRegion
         }
     }
 
+    // When calibrating directly the AEEI is back-calculated in calibrateAEEI
+    // so the TFE markets are not solved, they only report the calibration.
+    mDirectCalibration = Configuration::getInstance()->getBool( "direct-calibration", false, false );
     for( unsigned int i = ( modeltime->getFinalCalibrationPeriod() + 1 );
         i < mCalFinalEnergy.size(); ++i ){
         if( mCalFinalEnergy[ i ].isInited() ){
-            // Solve all initialized periods.
-            marketplace->setMarketToSolve( mTFEMarketName, aRegionName, i );
+            if( mDirectCalibration ) {
+                marketplace->getMarketInfo( mTFEMarketName, aRegionName, i, true )
+                    ->setBoolean( "solved-by-construction", true );
+            }
+            else {
+                // Solve all initialized periods.
+                marketplace->setMarketToSolve( mTFEMarketName, aRegionName, i );
+            }
 
             // Setup the constraint.
             marketplace->addToSupply( mTFEMarketName, aRegionName,
@@ -616,8 +627,8 @@ double EnergyFinalDemand::FinalEnergyConsumer::getCalibratedFinalEnergy( const i
 void EnergyFinalDemand::FinalEnergyConsumer::updateAEEI( const string& aRegionName,
                                                          const int aPeriod )
 {
-    // Do only if mCalFinalEnergy object exists.
-    if( mCalFinalEnergy[ aPeriod ].get() ){
+    // Do only if mCalFinalEnergy object exists and is solved by the market.
+    if( mCalFinalEnergy[ aPeriod ].get() && !mDirectCalibration ){
         const Modeltime* modeltime = scenario->getModeltime();
         Marketplace* marketplace = scenario->getMarketplace();
 
@@ -633,6 +644,42 @@ void EnergyFinalDemand::FinalEnergyConsumer::updateAEEI( const string& aRegionNa
     }
 }
 
+/*!
+ * \brief Back-calculate the AEEI so that the final demand meets the final
+ *        energy to calibrate to.
+ * \details Only done when direct calibration is enabled.  The cumulative
+ *          technical change which scales the service demand before technical
+ *          change to the calibrated final energy is found directly, and the
+ *          AEEI of the period is the part of it not already applied in
+ *          previous periods.  The calibrated value is added to the demand of
+ *          the TFE market, which is not solved, so that it reports the
+ *          calibration as met.
+ * \param aRegionName Region name.
+ * \param aServiceDemand The service demand before technical change.
+ * \param aPeriod Model period.
+ */
+void EnergyFinalDemand::FinalEnergyConsumer::calibrateAEEI( const string& aRegionName,
+                                                            const double aServiceDemand,
+                                                            const int aPeriod )
+{
+    const Modeltime* modeltime = scenario->getModeltime();
+    if( !mDirectCalibration || aPeriod <= modeltime->getFinalCalibrationPeriod()
+        || !mCalFinalEnergy[ aPeriod ].isInited() || mCalFinalEnergy[ aPeriod ] <= 0
+        || aServiceDemand <= 0 )
+    {
+        return;
+    }
+
+    const double totalAEEI = aServiceDemand / mCalFinalEnergy[ aPeriod ]
+                           / calcTechChange( aPeriod - 1 );
+    mAEEI[ aPeriod ] = pow( totalAEEI, 1.0 /
+        static_cast<double>( modeltime->gettimestep( aPeriod ) ) ) - 1;
+
+    Marketplace* marketplace = scenario->getMarketplace();
+    marketplace->setPrice( mTFEMarketName, aRegionName, totalAEEI, aPeriod );
+    marketplace->addToDemand( mTFEMarketName, aRegionName, mCalFinalEnergy[ aPeriod ], aPeriod );
+}
+
 /*!
  * \brief Calculate cummulative technical change up to the current period.
  * \details Calculates the cummulative technical change up to the current
@@ -173,6 +173,9 @@ void NegativeEmissionsFinalDemand::initCalc( const string& aRegionName,
                                   const Demographic* aDemographics,
                                   const int aPeriod )
 {
+    // Locate the markets once since they are accessed on every evaluation.
+    mEmissionsMarket.locateMarket( mName, aRegionName, aPeriod );
+    mPolicyMarket.locateMarket( mPolicyName, aRegionName, aPeriod );
 }
 
 /*! \brief Set the final demand for service into the marketplace after 
@@ -192,22 +195,21 @@ void NegativeEmissionsFinalDemand::setFinalDemand( const string& aRegionName,
                                         const GDP* aGDP,
                                         const int aPeriod )
 {
-    Marketplace* marketplace = scenario->getMarketplace();
-    double co2Price = marketplace->getPrice( mName, aRegionName, aPeriod, false );
+    double co2Price = mEmissionsMarket.getPrice( mName, aRegionName, aPeriod, false );
     if( co2Price == Marketplace::NO_MARKET_PRICE ) {
         // no CO2 policy so the negative emissions policy is inactive too
         // TODO: warn?
         return;
     }
-    double regionalCO2Emiss = marketplace->getDemand( mName, aRegionName, aPeriod );
+    double regionalCO2Emiss = mEmissionsMarket.getDemand( mName, aRegionName, aPeriod );
     double regionalCO2EmissValue = -1.0 * regionalCO2Emiss * co2Price;
     if(regionalCO2EmissValue > 0.0) {
-        double policyPrice = std::min( marketplace->getPrice( mPolicyName, aRegionName, aPeriod ), 1.0 );
+        double policyPrice = std::min( mPolicyMarket.getPrice( mPolicyName, aRegionName, aPeriod ), 1.0 );
         double policyAdj = ( 1.0 - policyPrice );
         regionalCO2EmissValue *= policyAdj;
     }
     mCurrNegEmissValue = regionalCO2EmissValue;
-    marketplace->addToDemand( mPolicyName, aRegionName, mCurrNegEmissValue, aPeriod );
+    mPolicyMarket.addToDemand( mPolicyName, aRegionName, mCurrNegEmissValue, aPeriod );
 }
 
 double NegativeEmissionsFinalDemand::getWeightedEnergyPrice( const string& aRegionName,
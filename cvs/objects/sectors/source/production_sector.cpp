@@ -204,6 +204,9 @@ void ProductionSector::completeInit( const IInfo* aRegionInfo,
     }
 
     mInvestor->completeInit( mRegionName, mName );
+
+    // The subsectors do not change after this point.
+    mInvestableSubsecs = InvestmentUtils::convertToInvestables( mSubsectors );
 }
 
 /*! \brief Initialize the market required by this ProductionSector.
@@ -332,9 +335,8 @@ void ProductionSector::initCalc( NationalAccount* aNationalAccount,
 
     //*************** begin initialize the investment routine ********
     // Calculate and distribute investment to the subsectors of this sector.
-    vector<IInvestable*> investableSubsecs = InvestmentUtils::convertToInvestables( mSubsectors );
     // aNationalAccount is a pointer here, but initCalc needs a reference to aNationalAccount
-    mInvestor->initCalc( investableSubsecs, *aNationalAccount, aDemographics, aPeriod );
+    mInvestor->initCalc( mInvestableSubsecs, *aNationalAccount, aDemographics, aPeriod );
     //*************** end initialize the investment routine ********
 
 }
@@ -407,9 +409,8 @@ void ProductionSector::calcInvestment( const Demographic* aDemographic,
                                        NationalAccount& aNationalAccount,
                                        const int aPeriod )
 {
-    vector<IInvestable*> investableSubsecs = InvestmentUtils::convertToInvestables( mSubsectors );
     // Calculate and distribute investment to the subsectors of this sector.
-    mInvestor->calcAndDistributeInvestment( investableSubsecs, aNationalAccount, aDemographic,
+    mInvestor->calcAndDistributeInvestment( mInvestableSubsecs, aNationalAccount, aDemographic,
         aPeriod );
     // Set efficiency conditions here.
     // Note: efficiency conditions do not change until the next iteration and so setting them 
@@ -417,7 +418,7 @@ void ProductionSector::calcInvestment( const Demographic* aDemographic,
     // output share levelized cost calculator in which case it must be done after the distribution
     // TODO: perhaps we should collapse setEfficiencyConditions back into calcAndDistributeInvestment
     // so that we do not need to worry about ordering issues anymore
-    mInvestor->setEfficiencyConditions( investableSubsecs, aNationalAccount, aDemographic, aPeriod );
+    mInvestor->setEfficiencyConditions( mInvestableSubsecs, aNationalAccount, aDemographic, aPeriod );
 }
 
 /*! \brief Operate the old capital for the sector.
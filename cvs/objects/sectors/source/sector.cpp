@@ -417,15 +417,34 @@ void Sector::calcCosts( const int aPeriod ){
 * \param aPeriod Model period.
 * \return A vector of normalized shares, one per subsector, ordered by subsector.
 */
-const vector<double> Sector::calcSubsectorShares( const GDP* aGDP, const int aPeriod ) const {
-    // Calculate unnormalized shares.
+vector<double> Sector::calcSubsectorShares( const GDP* aGDP, const int aPeriod ) const {
     vector<double> subsecShares( mSubsectors.size() );
-    for( unsigned int i = 0; i < mSubsectors.size(); ++i ){
-        subsecShares[ i ] = mSubsectors[ i ]->calcShare( mDiscreteChoiceModel, aGDP, aPeriod );
-    }
+    pair<double, double> shareSum;
+
+    // Calculate all of the shares with a single call to the discrete choice
+    // function if each subsector shares by it.
+    vector<double> shareWeights( mSubsectors.size() );
+    vector<double> prices( mSubsectors.size() );
+    vector<double> logShareAdjustments( mSubsectors.size() );
+    bool canCalcShares = true;
+    for( unsigned int i = 0; i < mSubsectors.size() && canCalcShares; ++i ){
+        canCalcShares = mSubsectors[ i ]->getShareTerms( aGDP, aPeriod, shareWeights[ i ], prices[ i ],
+                                                         logShareAdjustments[ i ] );
+    }
+    if( canCalcShares ) {
+        shareSum = mDiscreteChoiceModel->calcShares( shareWeights.data(), prices.data(),
+                                                     logShareAdjustments.data(), subsecShares.data(),
+                                                     subsecShares.size(), aPeriod );
+    }
+    else {
+        // Calculate unnormalized shares.
+        for( unsigned int i = 0; i < mSubsectors.size(); ++i ){
+            subsecShares[ i ] = mSubsectors[ i ]->calcShare( mDiscreteChoiceModel, aGDP, aPeriod );
+        }
 
-    // Normalize the shares.  After normalization they will be true shares, not log(shares).
-    pair<double, double> shareSum = SectorUtils::normalizeLogShares( subsecShares );
+        // Normalize the shares.  After normalization they will be true shares, not log(shares).
+        shareSum = SectorUtils::normalizeLogShares( subsecShares );
+    }
     if( shareSum.first == 0.0 && !outputsAllFixed( aPeriod ) ){
         // This should no longer happen, but it's still technically possible.
         ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -584,8 +603,8 @@ void Sector::emission( const int period ) {
 void Sector::csvOutputFile( const GDP* aGDP,
                             const IndirectEmissionsCalculator* aIndirectEmissCalc ) const {
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
 
     // function arguments are variable name, double array, db name, table name
     // the function writes all years
@@ -619,7 +638,7 @@ void Sector::csvOutputFile( const GDP* aGDP,
 * \todo Input change name of this and other methods here to proper capitilization
 * \return fuel consumption map
 */
-map<string, double> Sector::getfuelcons( const int period ) const {
+const map<string, double>& Sector::getfuelcons( const int period ) const {
     return summary[ period ].getfuelcons();
 }
 
@@ -641,7 +660,7 @@ double Sector::getConsByFuel( const int period, const std::string& fuelName ) co
 * \param period Model period
 * \return GHG emissions map
 */
-map<string, double> Sector::getemission( const int period ) const {
+const map<string, double>& Sector::getemission( const int period ) const {
     return summary[ period ].getemission();
 }
 
@@ -653,7 +672,7 @@ map<string, double> Sector::getemission( const int period ) const {
 * \param period Model period
 * \return GHG emissions map
 */
-map<string, double> Sector::getemfuelmap( const int period ) const {
+const map<string, double>& Sector::getemfuelmap( const int period ) const {
     return summary[ period ].getemfuelmap();
 }
 
@@ -51,6 +51,7 @@
 #include "util/base/include/model_time.h"
 #include "containers/include/iinfo.h"
 #include "util/base/include/util.h"
+#include "util/base/include/vector_math.h"
 
 using namespace std;
 
@@ -216,16 +217,32 @@ double SectorUtils::calcFixedOutputScaleFactor( const double aMarketDemand,
  *         calculations using these values in a numerically stable way.
  */
 pair<double, double> SectorUtils::normalizeLogShares( vector<double>& alogShares ){
+    return normalizeLogShares( alogShares.data(), alogShares.size() );
+}
+
+/*!
+ * \brief Normalize an array of log shares.
+ * \details The same as the vector version but for shares held in an array,
+ *          such as one range of the flattened land allocator.  An empty array
+ *          is treated as all of the shares being zero.
+ * \param aLogShares An array of logs of unnormalized shares on input, normalized
+ *                   shares (not logs) on output.
+ * \param aNumShares The number of shares in the array.
+ * \return The unnormalized sum of the shares and a log(adjustment factor) that
+ *         has been factored out of the sum.
+ */
+pair<double, double> SectorUtils::normalizeLogShares( double* aLogShares, const size_t aNumShares ){
     // find the log of the largest unnormalized share
-    double lfac = *max_element(alogShares.begin(), alogShares.end());
+    double lfac = aNumShares > 0 ? *max_element( aLogShares, aLogShares + aNumShares )
+                                 : -numeric_limits<double>::infinity();
     double sum = 0.0;
     
     // check for all zero prices
     if( lfac == -numeric_limits<double>::infinity() ) {
         // In this case, set all shares to zero and return.
         // This is arguably wrong, but the rest of the code seems to expect it.
-        for( size_t i = 0; i < alogShares.size(); ++i ) {
-            alogShares[ i ] = 0.0;
+        for( size_t i = 0; i < aNumShares; ++i ) {
+            aLogShares[ i ] = 0.0;
         }
         return make_pair( 0.0, 0.0 );
     }
@@ -233,17 +250,29 @@ pair<double, double> SectorUtils::normalizeLogShares( vector<double>& alogShares
     // in theory we could check for lfac == +Inf here, but in light of how the log
     // shares are calculated, it would seem like that can't happen.
 
-    // rescale and get normalization sum
-    for( size_t i = 0; i < alogShares.size(); ++i ) {
-        alogShares[ i ] -= lfac;
-        sum += exp( alogShares[ i ] );
+    // rescale and get normalization sum, the exponentials are taken in
+    // batches so that they may be vectorized
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        aLogShares[ i ] -= lfac;
+    }
+    double shares[ VectorMath::BATCH_SIZE ];
+    for( size_t start = 0; start < aNumShares; start += VectorMath::BATCH_SIZE ) {
+        const size_t count = min( VectorMath::BATCH_SIZE, aNumShares - start );
+        copy( aLogShares + start, aLogShares + start + count, shares );
+        VectorMath::exp( shares, count );
+        for( size_t i = 0; i < count; ++i ) {
+            sum += shares[ i ];
+        }
     }
     double unnormAdjustedSum = sum;
     double norm = log( sum );
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        aLogShares[ i ] -= norm;                      // divide by norm constant
+    }
+    VectorMath::exp( aLogShares, aNumShares );       // and unlog
     sum = 0.0;                               // double check the normalization
-    for( size_t i = 0; i < alogShares.size(); ++i ) {
-        alogShares[ i ] = exp( alogShares[ i ] - norm );   // divide by norm constant and unlog
-        sum += alogShares[ i ];                      // accumulate sum of normalized shares 
+    for( size_t i = 0; i < aNumShares; ++i ) {
+        sum += aLogShares[ i ];                      // accumulate sum of normalized shares 
                                                      //   (should be 1.0 when we're done.)
     }
     
@@ -523,8 +552,8 @@ void SectorUtils::setSupplyBehaviorBounds( const string& aGoodName, const string
                                            const double aLowerPriceBound, const double aUpperPriceBound,
                                            const int aPeriod )
 {
-    const string LOWER_BOUND_KEY = "lower-bound-supply-price";
-    const string UPPER_BOUND_KEY = "upper-bound-supply-price";
+    const InfoKeys::Key LOWER_BOUND_KEY = InfoKeys::eLowerBoundSupplyPrice;
+    const InfoKeys::Key UPPER_BOUND_KEY = InfoKeys::eUpperBoundSupplyPrice;
 
     IInfo* sectorInfo = scenario->getMarketplace()->getMarketInfo( aGoodName, aRegionName, aPeriod, true );
 
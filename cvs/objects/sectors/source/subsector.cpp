@@ -632,9 +632,25 @@ double Subsector::getAverageFuelPrice( const GDP* aGDP, const int aPeriod ) cons
 * \param period model period
 * \return A vector of technology shares.
 */
-const vector<double> Subsector::calcTechShares( const GDP* aGDP, const int aPeriod ) const {
+vector<double> Subsector::calcTechShares( const GDP* aGDP, const int aPeriod ) const {
     vector<double> logTechShares ( mTechContainers.size() ); 
 
+    // Calculate all of the shares with a single call to the discrete choice
+    // function if each technology shares by it.
+    vector<double> shareWeights( mTechContainers.size() );
+    vector<double> costs( mTechContainers.size() );
+    vector<double> logShareAdjustments( mTechContainers.size() );
+    bool canCalcShares = true;
+    for( unsigned int i = 0; i < mTechContainers.size() && canCalcShares; ++i ){
+        canCalcShares = mTechContainers[ i ]->getNewVintageTechnology( aPeriod )->
+            getShareTerms( aGDP, aPeriod, shareWeights[ i ], costs[ i ], logShareAdjustments[ i ] );
+    }
+    if( canCalcShares ) {
+        mDiscreteChoiceModel->calcShares( shareWeights.data(), costs.data(), logShareAdjustments.data(),
+                                          logTechShares.data(), logTechShares.size(), aPeriod );
+        return logTechShares;
+    }
+
     for( unsigned int i = 0; i < mTechContainers.size(); ++i ){
         // determine shares based on Technology costs
         double lts = mTechContainers[ i ]->getNewVintageTechnology( aPeriod )->
@@ -683,20 +699,16 @@ void Subsector::calcCost( const int aPeriod ){
  * \sa Technology::calcShare()
 */
 double Subsector::calcShare( const IDiscreteChoice* aChoiceFn, const GDP* aGDP, const int aPeriod ) const {
-    double subsectorPrice = getPrice( aGDP, aPeriod );
-
-    if( boost::math::isnan( subsectorPrice ) ) {
-        // Check for a NaN sentinel value.  If we find it, set the
-        // subsector's share to zero.
-        return -numeric_limits<double>::infinity();
+    double shareWeight;
+    double subsectorPrice;
+    double logShareAdjustment;
+    getShareTerms( aGDP, aPeriod, shareWeight, subsectorPrice, logShareAdjustment );
+    if( logShareAdjustment == -numeric_limits<double>::infinity() ) {
+        return logShareAdjustment;
     }
 
-    
-    double scaledGdpPerCapita = aGDP->getBestScaledGDPperCap( aPeriod );
-    assert( scaledGdpPerCapita > 0.0 );
-
-    double logshare = aChoiceFn->calcUnnormalizedShare( mShareWeights[ aPeriod ], subsectorPrice, aPeriod )
-        + mFuelPrefElasticity[ aPeriod ] * log( scaledGdpPerCapita );
+    double logshare = aChoiceFn->calcUnnormalizedShare( shareWeight, subsectorPrice, aPeriod )
+        + logShareAdjustment;
 
     /*! \post logshare is finite or minus-infinity. */
     // Check for invalid shares.
@@ -709,6 +721,43 @@ double Subsector::calcShare( const IDiscreteChoice* aChoiceFn, const GDP* aGDP,
     return logshare;
 }
 
+/*!
+ * \brief Get the terms from which the subsector share is calculated.
+ * \details Allows the sector to calculate the shares of all of its subsectors
+ *          with a single call to IDiscreteChoice::calcShares.  The share is the
+ *          discrete choice function of the share weight and price with the log
+ *          share adjustment, which is the fuel preference elasticity term, added
+ *          to it.  A subsector which should not receive a share has a log share
+ *          adjustment of negative infinity.
+ * \param aGDP gdp object
+ * \param aPeriod model period
+ * \param aShareWeight The share weight of the subsector.
+ * \param aPrice The price of the subsector.
+ * \param aLogShareAdjustment The term to add to the log share.
+ * \return Whether the share is calculated in this way, otherwise calcShare
+ *         must be used.
+ * \sa Technology::getShareTerms()
+ */
+bool Subsector::getShareTerms( const GDP* aGDP, const int aPeriod, double& aShareWeight,
+                               double& aPrice, double& aLogShareAdjustment ) const
+{
+    aShareWeight = mShareWeights[ aPeriod ];
+    aPrice = getPrice( aGDP, aPeriod );
+
+    if( boost::math::isnan( aPrice ) ) {
+        // Check for a NaN sentinel value.  If we find it, set the
+        // subsector's share to zero.
+        aPrice = 0.0;
+        aLogShareAdjustment = -numeric_limits<double>::infinity();
+        return true;
+    }
+
+    double scaledGdpPerCapita = aGDP->getBestScaledGDPperCap( aPeriod );
+    assert( scaledGdpPerCapita > 0.0 );
+    aLogShareAdjustment = mFuelPrefElasticity[ aPeriod ] * log( scaledGdpPerCapita );
+    return true;
+}
+
 
 /*! \brief Return the total fixed Technology output for this subsector.
 * \details Fixed output may come from vintaged production or exogenously 
@@ -742,7 +791,10 @@ double Subsector::getFixedOutput( const int aPeriod, const double aMarginalReven
  * \brief Apply share weight interpolation rules for the subsector
  * \details Rules will only apply in the first period after calibration.  It
  *          is an error to have uninitialized share weights after rules have
- *          been applied.
+ *          been applied.  The rules fill in the share weights of all of the
+ *          remaining periods at once so that later periods only read them.
+ *          They interpolate from this scenario's calibrated share weights so
+ *          the results can not be reused by other scenarios in a batch.
  * \param aPeriod Current model period.
  */
 void Subsector::interpolateShareWeights( const int aPeriod ) {
@@ -937,8 +989,8 @@ void Subsector::csvOutputFile( const GDP* aGDP,
                                const IndirectEmissionsCalculator* aIndirectEmissCalc ) const {
 
     // function protocol
-    void fileoutput3( string var1name,string var2name,string var3name,
-        string var4name,string var5name,string uname,vector<double> dout);
+    void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+        const string& var4name,const string& var5name,const string& uname,const vector<double>& dout);
     
     const Modeltime* modeltime = scenario->getModeltime();
     const int maxper = modeltime->getmaxper();
@@ -1133,7 +1185,7 @@ void Subsector::MCoutputAllSectors( const GDP* aGDP,
     dboutput4( mRegionName, "CO2 Emiss", mSectorName, mName, "MTC", temp );
 
     typedef map<string,double>::const_iterator CI;
-    map<string,double> temissmap = summary[0].getemission(); // get gas names for period 0
+    const map<string,double>& temissmap = summary[0].getemission(); // get gas names for period 0
     for (CI gmap=temissmap.begin(); gmap!=temissmap.end(); ++gmap) {
         for ( int m= 0;m<maxper;m++) {
             temp[m] = summary[m].get_emissmap_second(gmap->first);
@@ -1315,7 +1367,7 @@ double Subsector::distributeInvestment( const IDistributor* aDistributor,
 * \pre updateSummary
 * \return fuel consumption map
 */
-map<string, double> Subsector::getfuelcons( const int period ) const {
+const map<string, double>& Subsector::getfuelcons( const int period ) const {
     /*! \pre period is less than max period. */
     assert( period < scenario->getModeltime()->getmaxper() );
     
@@ -1328,7 +1380,7 @@ map<string, double> Subsector::getfuelcons( const int period ) const {
 * \param period Model period
 * \return GHG emissions map
 */
-map<string, double> Subsector::getemission( const int period ) const {
+const map<string, double>& Subsector::getemission( const int period ) const {
     return summary[ period ].getemission();
 }
 
@@ -1338,7 +1390,7 @@ map<string, double> Subsector::getemission( const int period ) const {
 * \param period Model period
 * \return map of GHG emissions by fuel
 */
-map<string, double> Subsector::getemfuelmap( const int period ) const {
+const map<string, double>& Subsector::getemfuelmap( const int period ) const {
     return summary[ period ].getemfuelmap();
 }
 
@@ -376,7 +376,7 @@ void SupplySector::dbOutput( const GDP* aGDP,
 
     // Sector fuel consumption by fuel type
     typedef map<string,double>:: const_iterator CI;
-    map<string,double> tfuelmap = summary[0].getfuelcons();
+    const map<string,double>& tfuelmap = summary[0].getfuelcons();
     for (CI fmap=tfuelmap.begin(); fmap!=tfuelmap.end(); ++fmap) {
         for (int m=0;m<maxper;m++) {
             temp[m] = summary[m].get_fmap_second(fmap->first);
@@ -390,7 +390,7 @@ void SupplySector::dbOutput( const GDP* aGDP,
     }
 
     // Sector emissions for all greenhouse gases
-    map<string,double> temissmap = summary[0].getemission(); // get gases for per 0
+    const map<string,double>& temissmap = summary[0].getemission(); // get gases for per 0
     for (CI gmap=temissmap.begin(); gmap!=temissmap.end(); ++gmap) {
         for (int m=0;m<maxper;m++) {
             temp[m] = summary[m].get_emissmap_second(gmap->first);
@@ -183,6 +183,12 @@ void TranSubsector::completeInit( const IInfo* aSectorInfo,
 
     SectorUtils::fillMissingPeriodVectorInterpolated( mSpeed );
     SectorUtils::fillMissingPeriodVectorInterpolated( mTimeValueMult );
+
+    // Set the time value scale for all periods so that it is available
+    // for reporting, initCalc will reset it if the speed is adjusted.
+    for( int per = 0; per < scenario->getModeltime()->getmaxper(); ++per ) {
+        calcTimeValueScale( per );
+    }
 }
 
 /*!
@@ -211,6 +217,7 @@ void TranSubsector::initCalc( NationalAccount* aNationalAccount,
         mainLog << "Speed was zero or negative in subsector: " << mName << " in region "
             << mRegionName << ". Reset to 1." << endl;
     }
+    calcTimeValueScale( aPeriod );
     // time in transit
     // initialize vector to hold population (thousands)
     // TODO: revise access to population to avoid statement below
@@ -244,13 +251,22 @@ double TranSubsector::getPrice( const GDP* aGDP, const int aPeriod ) const {
 * \return The time value.
 */
 double TranSubsector::getTimeValue( const GDP* aGDP, const int aPeriod ) const {
+    // GDP value at this point in the code does not include energy feedback
+    // calculation for this year, so is, therefore, approximate
+    return aGDP->getApproxGDPperCap( aPeriod ) * mTimeValueScale[ aPeriod ];
+}
+
+/*! \brief Calculate the factor which converts GDP per capita into the time value.
+* \details The factor only depends on read in parameters so it is calculated
+*          once rather than each time the price is calculated.
+* \param aPeriod The model period.
+*/
+void TranSubsector::calcTimeValueScale( const int aPeriod ) {
     const double WEEKS_PER_YEAR = 50;
     const double HOURS_PER_WEEK = 40;
     // calculate time value based on hours worked per year Convert GDPperCap
-    // into dollars (instead of 1000's of $'s) GDP value at this point in the
-    // code does not include energy feedback calculation for this year, so is,
-    // therefore, approximate
-    return aGDP->getApproxGDPperCap( aPeriod ) * 1000 * mTimeValueMult[ aPeriod ] / ( HOURS_PER_WEEK * WEEKS_PER_YEAR ) / mSpeed[ aPeriod ];
+    // into dollars (instead of 1000's of $'s)
+    mTimeValueScale[ aPeriod ] = 1000 * mTimeValueMult[ aPeriod ] / ( HOURS_PER_WEEK * WEEKS_PER_YEAR ) / mSpeed[ aPeriod ];
 }
 
 /*! \brief Calculate the generalized service price for the mode that includes time value.
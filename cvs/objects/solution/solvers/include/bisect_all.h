@@ -46,12 +46,15 @@
 * \author Josh Lurz
 */
 #include <string>
+#include <vector>
+#include <set>
 
 class CalcCounter; 
 class Marketplace;
 class World;
 class SolutionInfoSet;
 class ISolutionInfoFilter;
+class IActivity;
 
 /*! 
 * \ingroup Objects
@@ -81,12 +84,28 @@ protected:
     
     //! Max iterations for bracketing
     unsigned int mMaxBracketIterations;
+
+    //! Whether bracketing should first probe unbracketed markets independently
+    //! of each other, several at a time (see SolverLibrary::bracketIndependent).
+    bool mIndependentBracketProbes;
+
+    //! Whether markets which are solved may be left out of the calculation,
+    //! only calculating what the prices which changed affect.
+    bool mFreezeSolvedMarkets;
+
+    //! The largest fraction of the global ordering for which a partial
+    //! calculation is used rather than a complete one.
+    double mMaxPartialCalcFraction;
     
     //! A filter which will be used to determine which SolutionInfos this solver component
     //! will work on.
     std::auto_ptr<ISolutionInfoFilter> mSolutionInfoFilter;
     
     bool areAllBracketsEqual( SolutionInfoSet& aSolutionSet ) const;
+
+    void switchCalcMode( SolutionInfoSet& aSolutionSet, const bool aPartial ) const;
+
+    std::vector<IActivity*> getOrderedCalcList( const std::set<const IActivity*>& aAffected ) const;
 };
 
 #endif // _BISECT_ALL_H_
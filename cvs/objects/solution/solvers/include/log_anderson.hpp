@@ -0,0 +1,132 @@
+#ifndef LOG_ANDERSON_HPP_
+#define LOG_ANDERSON_HPP_
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy ( DOE ). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file log_anderson.hpp
+ * \ingroup objects
+ * \brief Header file for the log Anderson acceleration solver component
+ */
+
+#include <string>
+#include <boost/numeric/ublas/vector.hpp>
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+#include "solution/util/include/edfun.hpp"
+
+#define UBLAS boost::numeric::ublas
+
+class CalcCounter; 
+class Marketplace;
+class World;
+class SolutionInfoSet;
+
+/*!
+ * \ingroup Objects 
+ * \brief SolverComponent based on Anderson acceleration of a
+ *        fixed-point iteration on logarithmic prices.
+ *
+ * \details The underlying iteration is G(x) = x + beta F(x), which
+ * raises the (log) price of each market in proportion to its excess
+ * demand.  Anderson acceleration replaces each plain step with the
+ * combination of the last few steps whose residuals best cancel, in
+ * the least squares sense, which converges far faster than the plain
+ * iteration.  Each iteration costs exactly one model evaluation and no
+ * Jacobian is ever formed, so this component is meant to run before
+ * the Broyden component: periods which start close to their solution
+ * will often solve here without any finite difference derivatives.
+ * The history is discarded whenever the residual grows by more than
+ * restart-factor, and the best point seen is restored on failure so
+ * the next component starts from it.
+ */
+class LogAnderson: public SolverComponent {
+public:
+  LogAnderson(Marketplace *mktplc, World *world, CalcCounter *ccounter, int itmax=50,
+              double ftol=1.0e-4) :
+      SolverComponent(mktplc,world,ccounter), mMaxIter( itmax ), mFTOL( ftol ),
+      mWindow( 5 ), mBeta( 0.5 ), mRestartFactor( 2.0 ) {}
+  virtual ~LogAnderson() {}
+
+  // SolverComponent methods
+  virtual void init() {
+    if(!mSolutionInfoFilter.get())
+      mSolutionInfoFilter.reset(new SolvableNRSolutionInfoFilter());
+  }
+  virtual ReturnCode solve( SolutionInfoSet& aSolutionSet, const int aPeriod );
+  virtual const std::string& getXMLName() const {return SOLVER_NAME;}
+  
+  // IParsable methods
+  virtual bool XMLParse( const xercesc::DOMNode* aNode );
+  
+  static const std::string & getXMLNameStatic( void ) {return SOLVER_NAME;}
+
+protected:
+  //! Perform the accelerated fixed-point iterations.
+  int aasolve(VecFVec<double,double> &F, UBLAS::vector<double> &x, UBLAS::vector<double> &fx,
+              int &neval);
+
+  //! Maximum number of iterations, each of which is one model evaluation
+  unsigned int mMaxIter;
+
+  //! Tolerance for convergence test in root-finding algorithm 
+  //! \warning The SolutionInfo class has its own convergence
+  //! tolerance, which it uses to flag certain markets as "unsolved".
+  //! If that tolerance is different from this one, the SolutionInfo
+  //! might regard a market as unsolved when the solver says it's
+  //! solved, or vice versa.
+  double mFTOL;
+
+  //! Number of previous steps combined in each accelerated step
+  unsigned int mWindow;
+
+  //! Relaxation of the underlying fixed-point iteration
+  double mBeta;
+
+  //! Growth in the residual norm which causes the history to be discarded
+  double mRestartFactor;
+  
+  //! Filter which will be used to determine which markets the solver
+  //! will attempt to solve
+  std::auto_ptr<ISolutionInfoFilter> mSolutionInfoFilter;
+
+private:
+  static std::string SOLVER_NAME;
+};
+
+#undef UBLAS
+
+#endif  // LOG_ANDERSON_HPP_
@@ -0,0 +1,153 @@
+#ifndef LOG_NEWTON_KRYLOV_HPP_
+#define LOG_NEWTON_KRYLOV_HPP_
+
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy ( DOE ). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file log_newton_krylov.hpp
+ * \ingroup objects
+ * \brief Header file for the log Newton-Krylov solver component
+ */
+
+#include <string>
+#include <boost/numeric/ublas/vector.hpp>
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+#include "solution/util/include/edfun.hpp"
+
+#define UBLAS boost::numeric::ublas
+
+class CalcCounter; 
+class Marketplace;
+class World;
+class SolutionInfoSet;
+
+/*!
+ * \ingroup Objects 
+ * \brief SolverComponent based on a Jacobian-free Newton-Krylov
+ *        algorithm using logarithmic prices and EDs.
+ *
+ * \details Each iteration computes the Newton step by solving J . dx =
+ * -F with restarted GMRES.  GMRES only needs the product of the
+ * Jacobian with a vector, which we approximate with a directional
+ * finite difference of F, so the Jacobian is never formed.  This
+ * costs one model evaluation per Krylov iteration rather than one
+ * per market per Jacobian, and the storage required is only a handful
+ * of vectors rather than an N x N matrix, which makes this component
+ * suitable for very large sets of markets.  The Newton step is
+ * followed by the same backtracking line search used by the
+ * Newton-Raphson and Broyden components.
+ *
+ * Optionally, the linear solve can be preconditioned by the diagonal
+ * of the Jacobian, which is computed from one partial derivative
+ * evaluation per market at the start of the solve.
+ */
+class LogNewtonKrylov: public SolverComponent {
+public:
+  LogNewtonKrylov(Marketplace *mktplc, World *world, CalcCounter *ccounter, int itmax=250,
+                  double ftol=1.0e-4) :
+      SolverComponent(mktplc,world,ccounter), mMaxIter( itmax ), mFTOL( ftol ),
+      mKrylovDim( 30 ), mMaxLinearIter( 150 ), mLinearTol( 0.1 ),
+      mLogPricep( true ), mDiagPrecondition( true ) {}
+  virtual ~LogNewtonKrylov() {}
+
+  // SolverComponent methods
+  virtual void init() {
+    if(!mSolutionInfoFilter.get())
+      mSolutionInfoFilter.reset(new SolvableNRSolutionInfoFilter());
+  }
+  virtual ReturnCode solve( SolutionInfoSet& aSolutionSet, const int aPeriod );
+  virtual const std::string& getXMLName() const {return SOLVER_NAME;}
+  
+  // IParsable methods
+  virtual bool XMLParse( const xercesc::DOMNode* aNode );
+  
+  static const std::string & getXMLNameStatic( void ) {return SOLVER_NAME;}
+
+protected:
+  //! Perform the Newton iterations.
+  int nksolve(VecFVec<double,double> &F, UBLAS::vector<double> &x, UBLAS::vector<double> &fx,
+              int &neval);
+  //! Solve J . dx = b for dx using restarted, right-preconditioned GMRES.
+  int gmres(VecFVec<double,double> &F, const UBLAS::vector<double> &x, const UBLAS::vector<double> &fx,
+            const UBLAS::vector<double> &pdiag, const UBLAS::vector<double> &b, double tol,
+            UBLAS::vector<double> &dx, int &neval);
+  //! Approximate J . v with a directional finite difference.
+  void jacvec(VecFVec<double,double> &F, const UBLAS::vector<double> &x, const UBLAS::vector<double> &fx,
+              const UBLAS::vector<double> &v, UBLAS::vector<double> &jv);
+  //! Compute the diagonal of the Jacobian for use as a preconditioner.
+  void jacdiag(VecFVec<double,double> &F, const UBLAS::vector<double> &x, const UBLAS::vector<double> &fx,
+               UBLAS::vector<double> &pdiag);
+
+  //! Maximum number of Newton iterations
+  unsigned int mMaxIter;
+
+  //! Tolerance for convergence test in root-finding algorithm 
+  //! \warning The SolutionInfo class has its own convergence
+  //! tolerance, which it uses to flag certain markets as "unsolved".
+  //! If that tolerance is different from this one, the SolutionInfo
+  //! might regard a market as unsolved when the solver says it's
+  //! solved, or vice versa.
+  double mFTOL;
+
+  //! Number of Krylov vectors kept before GMRES restarts
+  unsigned int mKrylovDim;
+
+  //! Maximum total number of GMRES iterations in a single Newton step
+  unsigned int mMaxLinearIter;
+
+  //! Relative residual required of the GMRES solution (the Newton
+  //! forcing term).  The Newton step need not be solved exactly far
+  //! from the solution, so a loose tolerance saves model evaluations.
+  double mLinearTol;
+  
+  //! Filter which will be used to determine which markets the solver
+  //! will attempt to solve
+  std::auto_ptr<ISolutionInfoFilter> mSolutionInfoFilter;
+
+  bool mLogPricep;              //<! flag indicating whether we should work in price or log-price
+
+  //! Flag indicating whether GMRES should be preconditioned by the
+  //! diagonal of the Jacobian.
+  bool mDiagPrecondition;
+
+private:
+  static std::string SOLVER_NAME;
+};
+
+#undef UBLAS
+
+#endif  // LOG_NEWTON_KRYLOV_HPP_
@@ -46,6 +46,8 @@
  */
 
 #include <string>
+#include <list>
+#include <vector>
 #include <boost/numeric/ublas/matrix.hpp>
 #include "solution/util/include/solvable_nr_solution_info_filter.h"
 #include "solution/util/include/edfun.hpp"
@@ -61,6 +63,7 @@ class CalcCounter;
 class Marketplace;
 class World;
 class SolutionInfoSet;
+struct JacobianColoring;
 
 /*!
  * \ingroup Objects 
@@ -83,7 +86,9 @@ public:
   LogBroyden(Marketplace *mktplc, World *world, CalcCounter *ccounter, int itmax=250,
              double ftol=1.0e-4) :
       SolverComponent(mktplc,world,ccounter), mMaxIter( itmax ), mFTOL( ftol ),
-      mLogPricep( true ) {}
+      mLogPricep( true ), mColoredJacobian( false ), mSparseLinearSolve( false ),
+      mBlockLinearSolve( false ), mReuseJacobian( false ), mLinesearchBatch( 1 ),
+      mMaxPeripheralIter( 20 ) {}
   virtual ~LogBroyden() {}
 
   // SolverComponent methods
@@ -102,7 +107,8 @@ public:
 protected:
   //! Perform the Broyden's method iterations.
   int bsolve(VecFVec<double,double> &F, UBLAS::vector<double> &x, UBLAS::vector<double> &fx,
-             UBMATRIX &B, int &neval);
+             UBMATRIX &B, int &neval, JacobianColoring *aColoring = 0,
+             const bool aIsWarmStart = false);
   //! Additional logging for visualizing solver progress.
   void reportVec(const std::string &aname, const UBLAS::vector<double> &av, const std::vector<int> &amktids,
                  const std::vector<bool> &aissolvable);
@@ -125,6 +131,66 @@ protected:
 
   bool mLogPricep;              //<! flag indicating whether we should work in price or log-price
 
+  //! Flag indicating whether Jacobian resets should perturb groups of
+  //! structurally independent markets together (see fdjacColored).
+  bool mColoredJacobian;
+
+  //! Flag indicating whether the Jacobian should be factored using the
+  //! sparse L-U factorization with Broyden updates applied through
+  //! Sherman-Morrison instead of a dense factorization every iteration.
+  bool mSparseLinearSolve;
+
+  //! Flag indicating whether the Jacobian should be factored by blocks of
+  //! markets coupled through a Schur complement (see BlockSchurLU).  Broyden
+  //! updates are applied through Sherman-Morrison as for mSparseLinearSolve.
+  bool mBlockLinearSolve;
+
+  //! Optional filter selecting the markets which couple the blocks when
+  //! mBlockLinearSolve is set.  If not given they are chosen automatically
+  //! from the structure of the Jacobian.
+  std::auto_ptr<ISolutionInfoFilter> mCouplingFilter;
+
+  //! Flag indicating whether the final Jacobian of each successful solve
+  //! should be saved and used to warm start later periods and scenarios.
+  bool mReuseJacobian;
+
+  //! Number of line search step lengths to evaluate at once once the full
+  //! step has been rejected (see linesearch).  Each is evaluated in its own
+  //! state slot, so setting this to the number of threads available lets
+  //! backtracking use otherwise idle cores.
+  unsigned int mLinesearchBatch;
+
+  //! Optional filter selecting the strongly coupled core markets.  When
+  //! given, the other markets are left out of the Jacobian and instead
+  //! solved one at a time inside each evaluation.
+  std::auto_ptr<ISolutionInfoFilter> mCoreFilter;
+
+  //! Maximum number of steps taken to solve the markets outside the core
+  //! in each evaluation.
+  unsigned int mMaxPeripheralIter;
+
+  /*!
+   * \brief A Jacobian saved at the end of a successful solve.
+   */
+  struct CachedJacobian {
+    //! The model period that was being solved.
+    int mPeriod;
+    //! The market serial numbers corresponding to the rows and columns.
+    std::vector<int> mMarketIDs;
+    //! The Jacobian at the solution with the input and output scaling
+    //! of the LogEDFun removed since that changes from period to period.
+    UBMATRIX mJ;
+  };
+
+  //! Jacobians saved from previous solves.  This is a class variable so
+  //! that it persists across scenarios in a batch run.
+  static std::list<CachedJacobian> mJacobianCache;
+
+  bool getCachedJacobian( LogEDFun &F, const int aPeriod, const std::vector<int> &aMarketIDs,
+                          const UBLAS::vector<double> &x, const UBLAS::vector<double> &fx, UBMATRIX &J ) const;
+  void storeCachedJacobian( const LogEDFun &F, const int aPeriod, const std::vector<int> &aMarketIDs,
+                            const UBMATRIX &J ) const;
+
   // These next two have to be class variables because we sometimes
   // have multiple logbroyden solvers operating.
   static int mLastPer;                 //<! used to detect when the period has changed, so we can reset mPerIter.
@@ -61,6 +61,7 @@ class CalcCounter;
 class Marketplace;
 class World;
 class SolutionInfoSet;
+struct JacobianColoring;
 
 /*! 
 * \ingroup Objects 
@@ -81,7 +82,8 @@ class LogNRbt: public SolverComponent {
 public:
     LogNRbt( Marketplace* mktplc, World* world, CalcCounter* ccounter, int itmax=250,
              double ftol=1.0e-7 ) : SolverComponent(mktplc,world,ccounter),
-                                    mMaxIter(itmax), mFTOL(ftol), mLogPricep(true) {}
+                                    mMaxIter(itmax), mFTOL(ftol), mLogPricep(true),
+                                    mColoredJacobian(false), mSparseLinearSolve(false) {}
     virtual ~LogNRbt() {}
     
     // SolverComponent methods
@@ -99,7 +101,8 @@ public:
   
 protected:
     int nrsolve(VecFVec<double,double> &F, UBLAS::vector<double> &x,
-                UBLAS::vector<double> &fx, UBMATRIX &J, int &neval);
+                UBLAS::vector<double> &fx, UBMATRIX &J, int &neval,
+                JacobianColoring *aColoring = 0);
     //! Max iterations for the Newton-Raphson algorithm 
     unsigned int mMaxIter;
   
@@ -129,6 +132,14 @@ protected:
 
   bool mLogPricep;              //<! flag indicating whether we should work in price or log-price 
 
+    //! Flag indicating whether the Jacobian should be computed by perturbing
+    //! groups of structurally independent markets together (see fdjacColored).
+    bool mColoredJacobian;
+
+    //! Flag indicating whether the Jacobian should be factored using the
+    //! sparse L-U factorization rather than a dense one.
+    bool mSparseLinearSolve;
+
 private:
     static std::string SOLVER_NAME;
 };
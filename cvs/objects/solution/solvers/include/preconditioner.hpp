@@ -69,6 +69,9 @@ class ISolutionInfoFilter;
 *          2) supply > demand:  decrease prices by the decrease-price-increment
 *             until supply changes (probably a decrease) by at least 10% of
 *             its original value, or until demand > supply
+*          3) optionally, for normal markets not caught by the above,
+*             a first pass Newton step in log price using the
+*             elasticity the Broyden solver found at the last solution
 *
 *
 * \author Robert Link
@@ -93,7 +96,11 @@ protected:
     double mPriceDecreaseFac; // default = 0.1
 
     double mLargePrice;         // default = 1e6
-    double mFTOL;                // default = getSmallNumber()
+    double mFTOL;
+
+    //! Whether to step normal markets using the elasticities learned in
+    //! previous periods.
+    bool mUseLearnedElasticity;                // default = getSmallNumber()
     
     //! A filter which will be used to determine which SolutionInfos this solver component
     //! will work on.
@@ -111,7 +111,7 @@ protected:
    std::vector<IterationInfo> mPastIters;
    void addIteration( const std::string& aSolName, const double aRED );
    bool isImproving( const unsigned int aNumIter ) const;
-   void startMethod();
+   void startMethod( const SolutionInfoSet& aSolutionSet );
 };
 
 #endif // _SOLVER_COMPONENT_H_
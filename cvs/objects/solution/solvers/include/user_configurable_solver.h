@@ -77,6 +77,12 @@ class SolutionInfoParamParser;
  *              - \c (any SolverComponent) vector<SolverComponent*> UserConfigurableSolver::mSolverComponents
  *                      Can be any solver component contained in SolverComponentFactory, each one
  *                      being added in order to the list of solver components to use.
+ *                      A component may have a \c handoff-tolerance attribute, a factor of
+ *                      at least one by which the solution tolerances are loosened while it
+ *                      runs so that it hands off to the next component early.  The factors
+ *                      are tightened after each pass through the components in proportion
+ *                      to the reduction in the maximum relative excess demand, and dropped
+ *                      if a pass reduces it by less than half.
  *
  * \author Pralit Patel
  */
@@ -96,6 +102,9 @@ public:
 private:
     //! In order list of solver components to use when trying to solve.
     std::vector<SolverComponent*> mSolverComponents;
+
+    //! The handoff tolerance factor of each component in mSolverComponents.
+    std::vector<double> mHandoffToleranceFactors;
     
     //! Default solution tolerance, this value may be overridden at the SolutionInfo level
     double mDefaultSolutionTolerance;
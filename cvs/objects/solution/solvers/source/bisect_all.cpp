@@ -57,17 +57,26 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_solution_info_filter.h"
+#include "solution/util/include/solver_telemetry.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/manage_state_variables.hpp"
 
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
 
 using namespace std;
 using namespace xercesc;
 
+extern Scenario* scenario;
+
 //! Default Constructor. Constructs the base class. 
 BisectAll::BisectAll( Marketplace* marketplaceIn, World* worldIn, CalcCounter* calcCounterIn ):SolverComponent( marketplaceIn, worldIn, calcCounterIn ),
 mMaxIterations( 30 ),
 mDefaultBracketInterval( 0.4 ),
-mMaxBracketIterations( 40 )
+mMaxBracketIterations( 40 ),
+mIndependentBracketProbes( false ),
+mFreezeSolvedMarkets( false ),
+mMaxPartialCalcFraction( 0.25 )
 {
 }
 
@@ -114,6 +123,15 @@ bool BisectAll::XMLParse( const DOMNode* aNode ) {
         else if( nodeName == "max-bracket-iterations" ) {
             mMaxBracketIterations = XMLHelper<unsigned int>::getValue( curr );
         }
+        else if( nodeName == "parallel-bracket" ) {
+            mIndependentBracketProbes = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "freeze-solved-markets" ) {
+            mFreezeSolvedMarkets = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "max-partial-calc-fraction" ) {
+            mMaxPartialCalcFraction = XMLHelper<double>::getValue( curr );
+        }
         else if( nodeName == "solution-info-filter" ) {
             mSolutionInfoFilter.reset(
                 SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<string>::getValue( curr ) ) );
@@ -145,6 +163,17 @@ bool BisectAll::XMLParse( const DOMNode* aNode ) {
 * A check for that is period-formed each time and the brackets are adjusted accordingly.
 * This check is critical for solution with simultaneously.
 *
+* If freeze-solved-markets is set then once few enough markets are still having
+* their prices moved, such that the activities affected by the prices which
+* changed since the last complete calculation are no more than
+* max-partial-calc-fraction of the global ordering, only those activities are
+* calculated. This is done in the "scratch" state, as for a partial derivative,
+* so the supplies and demands seen are the same as a complete calculation
+* would give. Solved markets are thereby frozen but are still checked and will
+* be bisected again if the other markets move them out of tolerance. A
+* complete calculation is made before returning so the "base" state is
+* consistent with the final prices.
+*
 * Tracking the excess demand is turned on from the logging configuration file.
 * \author Sonny Kim, Josh Lurz, Steve Smith
 * \warning Unless stated otherwise, ED values are normalized (i.e., that 10 == 10% difference).
@@ -165,6 +194,7 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
     ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
     worstMarketLog.setLevel( ILogger::NOTICE );
 
+    GCAM_PROFILE_SCOPE( "bisect-all" );
     Timer& bisectTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::BISECT );
     bisectTimer.start();
     
@@ -173,9 +203,10 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
     solverLog << "Solution set before Bracket: " << endl << aSolutionSet << endl;
     // Currently attempts to bracket but does not necessarily bracket all markets.
     SolverLibrary::bracket( marketplace, world, mDefaultBracketInterval, mMaxBracketIterations,
-                            aSolutionSet, calcCounter, mSolutionInfoFilter.get(), aPeriod );
+                            aSolutionSet, calcCounter, mSolutionInfoFilter.get(), aPeriod,
+                            mIndependentBracketProbes );
     
-    startMethod();
+    startMethod( aSolutionSet );
     ReturnCode code = ORIGINAL_STATE; // code that reports success 1 or failure 0
     
     worstMarketLog << "Policy All, X, XL, XR, ED, EDL, EDR, RED, bracketed, supply, demand" << endl;
@@ -194,6 +225,11 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
 
     unsigned int numIterations = 1; // number of iterations
 
+    // The activities affected by the prices which changed since the last
+    // complete calculation and whether the current state is the "scratch" one.
+    set<const IActivity*> affected;
+    bool isPartial = false;
+
     do {
         solverLog.setLevel( ILogger::NOTICE );
         solverLog << "BisectionAll " << numIterations << endl;
@@ -208,6 +244,7 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
             if( !currSol.isBracketed() ) {
                 continue;
             }
+            const double prevPrice = currSol.getPrice();
             // If not solved.
             if ( !currSol.isWithinTolerance() ) {
                 // Set new trial value to center
@@ -219,14 +256,38 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
             if ( fabs( currSol.getPrice() ) < util::getSmallNumber() && currSol.getED() < 0 ) { 
                 currSol.setPrice( 0 ); 
             } 
+            if( mFreezeSolvedMarkets && currSol.getPrice() != prevPrice ) {
+                affected.insert( currSol.getDependencies().begin(), currSol.getDependencies().end() );
+            }
         }
 
-        marketplace->nullSuppliesAndDemands( aPeriod );
+        const vector<IActivity*> calcList = mFreezeSolvedMarkets ? getOrderedCalcList( affected ) : vector<IActivity*>();
+        if( mFreezeSolvedMarkets && !calcList.empty()
+            && calcList.size() <= mMaxPartialCalcFraction * world->getGlobalOrderingSize() )
+        {
+            // Reset the scratch state, but not the prices, and calculate only the
+            // affected activities.
+            switchCalcMode( aSolutionSet, true );
+            isPartial = true;
 #if GCAM_PARALLEL_ENABLED
-        world->calc( aPeriod, world->getGlobalFlowGraph() );
+            world->calc( aPeriod, 0, &calcList );
 #else
-        world->calc( aPeriod );
+            world->calc( aPeriod, calcList );
 #endif
+        }
+        else {
+            if( isPartial ) {
+                switchCalcMode( aSolutionSet, false );
+                isPartial = false;
+            }
+            affected.clear();
+            marketplace->nullSuppliesAndDemands( aPeriod );
+#if GCAM_PARALLEL_ENABLED
+            world->calc( aPeriod, world->getGlobalFlowGraph() );
+#else
+            world->calc( aPeriod );
+#endif
+        }
         aSolutionSet.updateSolvable( mSolutionInfoFilter.get() );
 
         // Print solution set information to solver log.
@@ -252,12 +313,25 @@ SolverComponent::ReturnCode BisectAll::solve( SolutionInfoSet& aSolutionSet, con
         if( aSolutionSet.getNumSolvable() > 0 ) {
             const SolutionInfo* maxSol = aSolutionSet.getWorstSolutionInfo();
             addIteration( maxSol->getName(), maxSol->getRelativeED() );
+            SolverTelemetry::getInstance().recordIteration( numIterations );
             worstMarketLog << "BisectAll-maxRelED: " << *maxSol << endl;
         }
     } // end do loop        
     while ( ++numIterations <= mMaxIterations 
             && !aSolutionSet.isAllSolved() && !areAllBracketsEqual( aSolutionSet ) );
 
+    // Bring the "base" state up to date with the final prices.
+    if( isPartial ) {
+        switchCalcMode( aSolutionSet, false );
+        marketplace->nullSuppliesAndDemands( aPeriod );
+#if GCAM_PARALLEL_ENABLED
+        world->calc( aPeriod, world->getGlobalFlowGraph() );
+#else
+        world->calc( aPeriod );
+#endif
+        aSolutionSet.updateSolvable( mSolutionInfoFilter.get() );
+    }
+
     // Set the return code. 
     code = ( aSolutionSet.isAllSolved() ? SUCCESS : FAILURE_ITER_MAX_REACHED ); // report success, or failure
 
@@ -296,3 +370,49 @@ bool BisectAll::areAllBracketsEqual( SolutionInfoSet& aSolutionSet ) const {
 	}
 	return true;
 }
+
+/*!
+ * \brief Switch between calculating in the "base" state and in the "scratch"
+ *        state used for partial calculations, keeping the solvable prices.
+ * \details Switching to, or again to, the "scratch" state resets it from the
+ *          "base" state which holds the results of the last complete
+ *          calculation.
+ * \param aSolutionSet The solution set whose solvable prices are kept.
+ * \param aPartial Whether to switch to the "scratch" state.
+ */
+void BisectAll::switchCalcMode( SolutionInfoSet& aSolutionSet, const bool aPartial ) const {
+    vector<double> prices( aSolutionSet.getNumSolvable() );
+    for( unsigned int i = 0; i < aSolutionSet.getNumSolvable(); ++i ) {
+        prices[ i ] = aSolutionSet.getSolvable( i ).getPrice();
+    }
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    if( marketplace->mIsDerivativeCalc != aPartial ) {
+        marketplace->mIsDerivativeCalc = aPartial;
+        stateVars->setPartialDeriv( aPartial );
+    }
+    if( aPartial ) {
+        stateVars->copyState();
+    }
+    for( unsigned int i = 0; i < aSolutionSet.getNumSolvable(); ++i ) {
+        aSolutionSet.getSolvable( i ).setPrice( prices[ i ] );
+    }
+}
+
+/*!
+ * \brief Get the affected activities in the order of the global ordering.
+ * \param aAffected The activities to calculate.
+ * \return The activities ordered so they may be calculated.
+ */
+vector<IActivity*> BisectAll::getOrderedCalcList( const set<const IActivity*>& aAffected ) const {
+    vector<IActivity*> calcList;
+    if( aAffected.empty() ) {
+        return calcList;
+    }
+    const vector<IActivity*>& globalOrdering = world->getGlobalOrdering();
+    for( size_t i = 0; i < globalOrdering.size() && calcList.size() < aAffected.size(); ++i ) {
+        if( aAffected.find( globalOrdering[ i ] ) != aAffected.end() ) {
+            calcList.push_back( globalOrdering[ i ] );
+        }
+    }
+    return calcList;
+}
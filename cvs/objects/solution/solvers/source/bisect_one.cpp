@@ -56,6 +56,7 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_solution_info_filter.h"
+#include "solution/util/include/solver_telemetry.h"
 
 using namespace std;
 using namespace xercesc;
@@ -140,7 +141,7 @@ SolverComponent::ReturnCode BisectOne::solve( SolutionInfoSet& aSolutionSet, con
         return SolverComponent::SUCCESS;
     }
 
-    startMethod();
+    startMethod( aSolutionSet );
 
     // Setup logging.
     ILogger& solverLog = ILogger::getLogger( "solver_log" );
@@ -181,6 +182,7 @@ SolverComponent::ReturnCode BisectOne::solve( SolutionInfoSet& aSolutionSet, con
         // TODO: what is the point in updating
         aSolutionSet.updateSolvable( mSolutionInfoFilter.get() );
         addIteration( worstSol->getName(), worstSol->getRelativeED() );
+        SolverTelemetry::getInstance().recordIteration( numIterations );
         worstMarketLog << "BisectOne-MaxRelED: "  << *worstSol << endl;
         solverLog << "BisectOneWorst-MaxRelED: " << *worstSol << endl;
     } // end do loop        
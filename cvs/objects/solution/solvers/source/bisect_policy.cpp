@@ -57,6 +57,7 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_solution_info_filter.h"
+#include "solution/util/include/solver_telemetry.h"
 
 using namespace std;
 using namespace xercesc;
@@ -136,7 +137,7 @@ bool BisectPolicy::XMLParse( const DOMNode* aNode ) {
 * \param aPeriod Model period.
 */
 SolverComponent::ReturnCode BisectPolicy::solve( SolutionInfoSet& aSolutionSet, const int aPeriod ) {
-    startMethod();
+    startMethod( aSolutionSet );
 
     // If all markets are solved, then return with success code.
     if( aSolutionSet.isAllSolved() ){
@@ -191,6 +192,7 @@ SolverComponent::ReturnCode BisectPolicy::solve( SolutionInfoSet& aSolutionSet,
                 world->calc( aPeriod );
                 aSolutionSet.updateSolvable( mSolutionInfoFilter.get() );
                 addIteration( worstSol->getName(), worstSol->getRelativeED() );
+                SolverTelemetry::getInstance().recordIteration( numIterations );
                 worstMarketLog << "BisectPolicy-MaxRelED: "  << *worstSol << endl;
             } // end do loop        
             while ( isImproving( MAX_ITER_NO_IMPROVEMENT ) &&
@@ -0,0 +1,361 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy ( DOE ). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file log_anderson.cpp
+* \ingroup objects
+* \brief LogAnderson class (Anderson accelerated fixed-point solver) source file
+*/
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <math.h>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+
+#include "solution/solvers/include/solver_component.h"
+#include "solution/solvers/include/log_anderson.hpp"
+#include "solution/util/include/calc_counter.h"
+#include "marketplace/include/marketplace.h"
+#include "containers/include/world.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/solution_info.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/xml_helper.h"
+#include "solution/util/include/solution_info_filter_factory.h"
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+
+#include "solution/util/include/edfun.hpp"
+#include "solution/util/include/dense_lu.hpp"
+#include "solution/util/include/ublas-helpers.hpp"
+#include "solution/util/include/solver_telemetry.h"
+
+#include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
+
+using namespace xercesc;
+
+std::string LogAnderson::SOLVER_NAME = "log-anderson-solver-component";
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+
+
+namespace {
+  // helper function for the std::transform algorithm
+  inline double SI2lgprice (const SolutionInfo &si) {
+    double p = std::max(si.getPrice(), util::getTinyNumber());
+    return log( p );
+  }
+
+  // largest absolute value of the entries in a vector
+  double maxabs(const UBVECTOR &v) {
+    double maxval = 0.0;
+    for(size_t i=0; i<v.size(); ++i) {
+      maxval = std::max(maxval, fabs(v[i]));
+    }
+    return maxval;
+  }
+}
+
+bool LogAnderson::XMLParse( const DOMNode* aNode ) {
+    // assume we were passed a valid node.
+    assert( aNode );
+    
+    // get the children of the node.
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    
+    // loop through the children
+    for ( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        DOMNode* curr = nodeList->item( i );
+        std::string nodeName = XMLHelper<std::string>::safeTranscode( curr->getNodeName() );
+        
+        if( nodeName == "#text" ) {
+            continue;
+        }
+        else if( nodeName == "max-iterations" ) {
+            mMaxIter = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "ftol" ) {
+            mFTOL = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "window" ) {
+            mWindow = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "beta" ) {
+            mBeta = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "restart-factor" ) {
+            mRestartFactor = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "solution-info-filter" ) {
+            mSolutionInfoFilter.reset(
+                                      SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<std::string>::getValue( curr ) ) );
+        }
+        else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
+            mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized text string: " << nodeName << " found while parsing "
+                    << getXMLName() << "." << std::endl;
+        }
+    }
+    return true;
+}
+
+
+/*! \brief Anderson accelerated fixed-point solver.
+ * \details Attempts to solve the selected markets with an accelerated
+ * fixed-point iteration on log prices (see Walker and Ni, "Anderson
+ * Acceleration for Fixed-Point Iterations", SIAM J. Numer. Anal. 49,
+ * 2011).  See aasolve() for details.
+ *
+ * \param solnset An initial set of SolutionInfo objects representing all of the markets we will attempt to solve
+ * \param period Model time period
+ * \return Status code indicating whether the algorithm was successful or not.
+ */
+SolverComponent::ReturnCode LogAnderson::solve(SolutionInfoSet &solnset, int period) {
+    ReturnCode code = SolverComponent::ORIGINAL_STATE;
+
+    // If all markets are solved, then return with success code.
+    if( solnset.isAllSolved() ){
+        return code = SolverComponent::SUCCESS;
+    }
+    
+    startMethod( solnset );
+    
+    // Update the solution vector for the correct markets to solve.
+    // Need to update solvable status before starting solution (Ignore return code)
+    solnset.updateSolvable( mSolutionInfoFilter.get() );
+
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+    solverLog << "Beginning Anderson solution for period " << period << ". "
+              << "Solving " << solnset.getNumSolvable() << " markets.\n";
+    
+    ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
+    worstMarketLog.setLevel( ILogger::DEBUG );
+    ILogger& singleLog = ILogger::getLogger( "single_market_log" );
+    singleLog.setLevel( ILogger::DEBUG );
+    
+    size_t nsolv = solnset.getNumSolvable(); 
+    if( nsolv == 0 ){
+      solverLog << "No markets were assigned to this solver.  Exiting." << std::endl;
+        return SUCCESS;
+    }
+
+    GCAM_PROFILE_SCOPE( "log-anderson" );
+    Timer& solverTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::SOLVER );
+    solverTimer.start();
+    
+    UBVECTOR x( nsolv ), fx( nsolv );
+    int neval = 0;
+
+    // set our initial x from the solutionInfoSet
+    std::vector<SolutionInfo> smkts(solnset.getSolvableSet());
+    std::transform(smkts.begin(), smkts.end(), x.begin(), SI2lgprice);
+
+    // This is the closure that will evaluate the ED function
+    LogEDFun F(solnset, world, marketplace, period, true); 
+
+    // scale the initial guess for use in the solver algorithm
+    F.scaleInitInputs( x );
+    
+    // Call F( x ), store the result in fx
+    F(x,fx);
+    ++neval;
+
+    solverLog.setLevel(ILogger::DEBUG);
+    solverLog << "Initial guess:\n" << x << "\nInitial F( x ):\n" << fx << "\n";
+    solnset.printMarketInfo("Anderson-initial", calcCounter->getPeriodCount(), singleLog);
+
+    // call the solver
+    int aastatus = aasolve(F, x, fx, neval);
+
+    solverTimer.stop(); 
+
+    solverLog.setLevel(ILogger::NOTICE);
+    solverLog << "Anderson solver:  neval= " << neval << "\nResult:  ";
+    if(aastatus == 0) {
+        solverLog << "Anderson solution success.\n";
+        code = SUCCESS;
+    }
+    else if(aastatus == -1) {
+        code = FAILURE_ITER_MAX_REACHED;
+        solverLog << "Anderson solution failed: Iteration max reached.\n";
+    }
+    else {
+        code = FAILURE_UNKNOWN;
+        solverLog << "Anderson solution failed for unknown reason.\n";
+    }
+    if(!solnset.isAllSolved()) {
+        solverLog << "The following markets were not solved:\n";
+        solnset.printUnsolved( solverLog );
+    }
+
+    solverLog << std::endl;
+
+    // log some final debugging info
+    const SolutionInfo* maxred = solnset.getWorstSolutionInfo();
+    addIteration(maxred->getName(), maxred->getRelativeED());
+    worstMarketLog << "###Anderson-end:  " << *maxred << std::endl;
+
+    solnset.printMarketInfo("Anderson-end ", calcCounter->getPeriodCount(), singleLog);
+    singleLog << std::endl;
+
+    return code;
+}
+
+/*!
+ * \brief Anderson accelerated fixed-point iterations
+ * \details With the residual r(x) = G(x) - x = beta F(x) and the
+ * differences between successive iterates and residuals held in the
+ * columns of dX and dR, each iteration finds the coefficients gamma
+ * minimizing |r - dR gamma| and steps to x + r - (dX + dR) gamma.  The
+ * least squares problem only has as many unknowns as the window so it
+ * is solved through its (lightly regularized) normal equations.  With
+ * an empty history this is simply the plain fixed-point step.
+ * \param[in] F: The function to solve
+ * \param[inout] x: On input the initial guess, on output the solution
+ *               or the best point found
+ * \param[inout] fx: On input F(x), on output F at x
+ * \param[inout] neval: running count of function evaluations
+ * \return 0 on success, -1 iteration max
+ */
+int LogAnderson::aasolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
+                         int &neval)
+{
+  using boost::numeric::ublas::inner_prod;
+  ILogger &solverLog = ILogger::getLogger("solver_log");
+  solverLog.setLevel(ILogger::DEBUG);
+
+  const size_t n = x.size();
+  std::deque<UBVECTOR> dX, dR;
+  UBVECTOR r(mBeta * fx);
+  UBVECTOR xbest(x);
+  double fbest = maxabs(fx);
+  double rnorm = norm_2(r);
+  if(fbest <= mFTOL) {
+    return 0;
+  }
+
+  for(unsigned int iter=0; iter<mMaxIter; ++iter) {
+    solverLog << "Anderson iter= " << iter << "\tneval= " << neval
+              << "\thistory= " << dX.size() << "\n";
+
+    UBVECTOR xnew(x + r);
+    const size_t m = dX.size();
+    if(m > 0) {
+      boost::numeric::ublas::matrix<double> A(m, m);
+      UBVECTOR gamma(m);
+      double trace = 0.0;
+      for(size_t i=0; i<m; ++i) {
+        for(size_t j=0; j<=i; ++j) {
+          A(i,j) = A(j,i) = inner_prod(dR[i], dR[j]);
+        }
+        gamma[i] = inner_prod(dR[i], r);
+        trace += A(i,i);
+      }
+      for(size_t i=0; i<m; ++i) {
+        A(i,i) += 1.0e-10 * trace / m;
+      }
+      boost::numeric::ublas::permutation_matrix<std::size_t> perm(m);
+      if(denseLUFactorize(A, perm) == 0) {
+        denseLUSubstitute(A, perm, gamma);
+        for(size_t i=0; i<m; ++i) {
+          xnew -= gamma[i] * (dX[i] + dR[i]);
+        }
+      }
+      else {
+        solverLog << "Singular least squares problem, taking a plain step.\n";
+        dX.clear();
+        dR.clear();
+      }
+    }
+
+    UBVECTOR fxnew(n);
+    F(xnew, fxnew);
+    ++neval;
+    UBVECTOR rnew(mBeta * fxnew);
+    const double rnewnorm = norm_2(rnew);
+    SolverTelemetry::getInstance().recordIteration(iter, norm_2(xnew-x));
+
+    if(rnewnorm > mRestartFactor * rnorm) {
+      // The combination has stopped being useful, start again from
+      // this point with a plain step.
+      solverLog << "Residual grew from " << rnorm << " to " << rnewnorm << ", clearing the history.\n";
+      dX.clear();
+      dR.clear();
+    }
+    else {
+      dX.push_back(xnew - x);
+      dR.push_back(rnew - r);
+      while(dX.size() > mWindow) {
+        dX.pop_front();
+        dR.pop_front();
+      }
+    }
+    x = xnew;
+    fx = fxnew;
+    r = rnew;
+    rnorm = rnewnorm;
+
+    // test for convergence
+    const double maxval = maxabs(fx);
+    solverLog << "Convergence test maxval: " << maxval << "\n";
+    if(maxval <= mFTOL) {
+      solverLog << "Solution successful.\n";
+      return 0;                 // SUCCESS 
+    }
+    if(maxval < fbest) {
+      fbest = maxval;
+      xbest = x;
+    }
+  }
+
+  solverLog << "\n****************Maximum solver iterations exceeded.\nlastx: " << x
+            << "\nlastF: " << fx << "\n";
+  // Leave the model at the best point found for the next solver component.
+  if(maxabs(fx) > fbest) {
+    x = xbest;
+    F(x, fx);
+    ++neval;
+  }
+  return -1;
+}
@@ -0,0 +1,578 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy ( DOE ). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file log_newton_krylov.cpp
+* \ingroup objects
+* \brief LogNewtonKrylov class (Jacobian-free Newton-GMRES solver) source file
+*/
+
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <iomanip>
+#include <math.h>
+#include <xercesc/dom/DOMNode.hpp>
+#include <xercesc/dom/DOMNodeList.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include "solution/solvers/include/solver_component.h"
+#include "solution/solvers/include/log_newton_krylov.hpp"
+#include "solution/util/include/calc_counter.h"
+#include "marketplace/include/marketplace.h"
+#include "containers/include/world.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/solution_info.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/xml_helper.h"
+#include "solution/util/include/solution_info_filter_factory.h"
+#include "solution/util/include/solvable_nr_solution_info_filter.h"
+
+#include "solution/util/include/functor-subs.hpp"
+#include "solution/util/include/linesearch.hpp"
+#include "solution/util/include/edfun.hpp"
+#include "solution/util/include/ublas-helpers.hpp"
+#include "solution/util/include/solver_telemetry.h"
+
+#include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
+
+using namespace xercesc;
+
+std::string LogNewtonKrylov::SOLVER_NAME = "log-newton-krylov-solver-component";
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+
+
+namespace {
+  // helper functions for the std::transform algorithm
+  inline double SI2lgprice (const SolutionInfo &si) {
+    double p = std::max(si.getPrice(), util::getTinyNumber());
+    return log( p );
+  }
+  inline double SI2price (const SolutionInfo &si) {return si.getPrice();}
+}
+
+bool LogNewtonKrylov::XMLParse( const DOMNode* aNode ) {
+    // assume we were passed a valid node.
+    assert( aNode );
+    
+    // get the children of the node.
+    DOMNodeList* nodeList = aNode->getChildNodes();
+    
+    // loop through the children
+    for ( unsigned int i = 0; i < nodeList->getLength(); ++i ){
+        DOMNode* curr = nodeList->item( i );
+        std::string nodeName = XMLHelper<std::string>::safeTranscode( curr->getNodeName() );
+        
+        if( nodeName == "#text" ) {
+            continue;
+        }
+        else if( nodeName == "max-iterations" ) {
+            mMaxIter = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "ftol" ) {
+            mFTOL = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "krylov-dimension" ) {
+            mKrylovDim = std::max( XMLHelper<unsigned int>::getValue( curr ), 1u );
+        }
+        else if( nodeName == "max-linear-iterations" ) {
+            mMaxLinearIter = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "linear-tol" ) {
+            mLinearTol = XMLHelper<double>::getValue( curr );
+        }
+        else if( nodeName == "diagonal-preconditioner" ) {
+            mDiagPrecondition = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "solution-info-filter" ) {
+            mSolutionInfoFilter.reset(
+                                      SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<std::string>::getValue( curr ) ) );
+        }
+        else if(nodeName == "linear-price") {
+          mLogPricep = false;
+        }
+        else if(nodeName == "log-price") {
+          mLogPricep = true;    // not strictly necessary, as this is the default.
+        }
+        else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
+            mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
+        }
+        else {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Unrecognized text string: " << nodeName << " found while parsing "
+                    << getXMLName() << "." << std::endl;
+        }
+    }
+    return true;
+}
+
+
+/*! \brief Jacobian-free Newton-Krylov solver.
+ * \details Attempts to solve the selected markets using Newton's
+ * method with the Newton step computed by GMRES (see Kelley, "Solving
+ * Nonlinear Equations with Newton's Method", ch. 3).  The Jacobian is
+ * never formed explicitly; see nksolve() for details.
+ *
+ * \param solnset An initial set of SolutionInfo objects representing all of the markets we will attempt to solve
+ * \param period Model time period
+ * \return Status code indicating whether the algorithm was successful or not.
+ */
+SolverComponent::ReturnCode LogNewtonKrylov::solve(SolutionInfoSet &solnset, int period) {
+    ReturnCode code = SolverComponent::ORIGINAL_STATE;
+
+    // If all markets are solved, then return with success code.
+    if( solnset.isAllSolved() ){
+        return code = SolverComponent::SUCCESS;
+    }
+    
+    startMethod( solnset );
+    
+    // Update the solution vector for the correct markets to solve.
+    // Need to update solvable status before starting solution (Ignore return code)
+    solnset.updateSolvable( mSolutionInfoFilter.get() );
+
+    ILogger& solverLog = ILogger::getLogger( "solver_log" );
+    solverLog.setLevel( ILogger::NOTICE );
+    solverLog << "Beginning Newton-Krylov solution for period " << period << ". "
+              << "Solving " << solnset.getNumSolvable() << " markets.\n";
+    if( mLogPricep ) {
+      solverLog << "Log price in effect\n";
+    }
+    else {
+      solverLog << "Linear price in effect\n";
+    }
+    
+    ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
+    worstMarketLog.setLevel( ILogger::DEBUG );
+    ILogger& singleLog = ILogger::getLogger( "single_market_log" );
+    singleLog.setLevel( ILogger::DEBUG );
+    
+    size_t nsolv = solnset.getNumSolvable(); 
+    if( nsolv == 0 ){
+      solverLog << "No markets were assigned to this solver.  Exiting." << std::endl;
+        return SUCCESS;
+    }
+
+    GCAM_PROFILE_SCOPE( "log-newton-krylov" );
+    Timer& solverTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::SOLVER );
+    solverTimer.start();
+    
+    UBVECTOR x( nsolv ), fx( nsolv );
+    int neval = 0;
+
+    // set our initial x from the solutionInfoSet
+    std::vector<SolutionInfo> smkts(solnset.getSolvableSet());
+    if( mLogPricep ) {
+      std::transform(smkts.begin(), smkts.end(), x.begin(), SI2lgprice);
+    }
+    else {
+      std::transform(smkts.begin(), smkts.end(), x.begin(), SI2price);
+    }
+
+    // This is the closure that will evaluate the ED function
+    LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+
+    // scale the initial guess for use in the solver algorithm
+    F.scaleInitInputs( x );
+    
+    // Call F( x ), store the result in fx
+    F(x,fx);
+    ++neval;
+
+    solverLog.setLevel(ILogger::DEBUG);
+    solverLog << "Initial guess:\n" << x << "\nInitial F( x ):\n" << fx << "\n";
+    solnset.printMarketInfo("Newton-Krylov-initial", calcCounter->getPeriodCount(), singleLog);
+
+    // call the solver
+    int nkstatus = nksolve(F, x, fx, neval);
+
+    solverTimer.stop(); 
+
+    solverLog.setLevel(ILogger::NOTICE);
+    solverLog << "Newton-Krylov solver:  neval= " << neval << "\nResult:  ";
+    if(nkstatus == 0) {
+        solverLog << "Newton-Krylov solution success.\n";
+        code = SUCCESS;
+    }
+    else if(nkstatus == -1) {
+        code = FAILURE_ITER_MAX_REACHED;
+        solverLog << "Newton-Krylov solution failed: Iteration max reached.\n";
+    }
+    else if(nkstatus == -3) {
+        code = FAILURE_ZERO_GRADIENT;
+        solverLog << "Newton-Krylov solution failed:  Encountered zero gradient in F*F.\n";
+    }
+    else if(nkstatus == -4) {
+        code = FAILURE_POOR_PROGRESS;
+        solverLog << "Newton-Krylov solution failed:  repeated poor progress.\n";
+    }
+    else if(nkstatus > 0) {
+        code = FAILURE_SINGULAR_MATRIX;
+        solverLog << "Newton-Krylov solution failed:  GMRES breakdown.\n";
+    }
+    else {
+        code = FAILURE_UNKNOWN;
+        solverLog << "Newton-Krylov solution failed for unknown reason.\n";
+    }
+    if(!solnset.isAllSolved()) {
+        solverLog << "The following markets were not solved:\n";
+        solnset.printUnsolved( solverLog );
+    }
+
+    solverLog << std::endl;
+
+    // log some final debugging info
+    const SolutionInfo* maxred = solnset.getWorstSolutionInfo();
+    addIteration(maxred->getName(), maxred->getRelativeED());
+    worstMarketLog << "###Newton-Krylov-end:  " << *maxred << std::endl;
+
+    solnset.printMarketInfo("Newton-Krylov-end ", calcCounter->getPeriodCount(), singleLog);
+    singleLog << std::endl;
+
+    return code;
+}
+
+/*!
+ * \brief Newton iterations with the step computed by GMRES
+ * \details At each iteration we approximately solve J . dx = -F, to
+ * a relative residual of mLinearTol, and then backtrack along dx to
+ * ensure that F . F decreases.  The line search needs the directional
+ * derivative of F . F along dx, which is 2 F . (J . dx); we get J . dx
+ * from one more directional difference and hand the line search a
+ * gradient vector parallel to dx that reproduces that value.
+ * \param[in] F: The function to solve
+ * \param[inout] x: On input the initial guess, on output the solution
+ * \param[inout] fx: On input F(x), on output F at the solution
+ * \param[inout] neval: running count of function evaluations
+ * \return 0 on success, -1 iteration max, -3 zero gradient, -4 poor
+ *         progress, >0 GMRES breakdown
+ */
+int LogNewtonKrylov::nksolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
+                             int &neval)
+{
+  using boost::numeric::ublas::inner_prod;
+  ILogger &solverLog = ILogger::getLogger("solver_log");
+  solverLog.setLevel(ILogger::DEBUG);
+  
+  const double FTINY = mFTOL*mFTOL;
+  int n = F.narg();
+
+  UBVECTOR dx(n);
+  UBVECTOR xnew(n);
+  UBVECTOR gx(n);
+  UBVECTOR jdx(n);
+  UBVECTOR pdiag(n);
+  if(F.nrtn() != F.narg() || x.size() != static_cast<size_t>(F.narg()) || fx.size() != static_cast<size_t>(F.nrtn())) {
+    solverLog.setLevel(ILogger::SEVERE);
+    solverLog << "size mismatch:  nrtn= " << F.nrtn()
+              << "  narg= " << F.narg()
+              << "  x.size= " << x.size()
+              << "  fx.size= " << fx.size()
+              << std::endl;
+    abort();
+  }
+
+  // We create a functor that computes f( x ) = F( x )*F( x ).  It also
+  // stores the value of F that it produces as an intermediate.
+  FdotF<double,double> fnorm( F );
+  double f0 = inner_prod(fx,fx);
+  if(f0 < FTINY) {
+    // Guard against F=0 since it can cause a NaN in our solver.
+    return 0;
+  }
+
+  if(mDiagPrecondition) {
+    jacdiag(F, x, fx, pdiag);
+    neval += n;
+    solverLog << "Preconditioner diagonal:\n" << pdiag << "\n";
+  }
+  else {
+    std::fill(pdiag.begin(), pdiag.end(), 1.0);
+  }
+
+  for(unsigned iter=0; iter<mMaxIter; ++iter) {
+    solverLog << "Newton-Krylov iter= " << iter << "\tneval= " << neval << "\n";
+
+    // Newton step
+    int gmerr = gmres(F, x, fx, pdiag, -1.0*fx, mLinearTol, dx, neval);
+    if(gmerr > 0) {
+      solverLog << "GMRES breakdown.\n";
+      return gmerr;
+    }
+    else if(gmerr < 0) {
+      // Not converged to the requested tolerance, but GMRES
+      // minimizes the residual, so dx is still our best guess.
+      solverLog << "GMRES did not converge; using the best available step.\n";
+    }
+
+    // directional derivative for the line search.  
+    jacvec(F, x, fx, dx, jdx);
+    ++neval;
+    double g0dx = inner_prod(fx,jdx);
+    double dxdx = inner_prod(dx,dx);
+    if(dxdx == 0.0 || fabs(g0dx) / (f0+FTINY) < FTINY) {
+      return -3;
+    }
+    gx = (g0dx/dxdx) * dx;
+
+    double fnew;
+    int lserr = linesearch(fnorm, x, f0, gx, dx, xnew, fnew, neval);
+
+    if(lserr != 0) {
+      // See the corresponding comment in LogNRbt::nrsolve.  If we are
+      // nearly converged accept the solution, otherwise give up and
+      // let the next solver component take over.
+      double msf = f0/fx.size();
+      if(msf < mFTOL) {
+        return 0;
+      }
+      solverLog << "linesearch failure\n";
+      return -4;
+    }
+
+    solverLog << "################Return from linesearch\nfold= " << f0 << "\tfnew= " << fnew
+              << "\n";
+    SolverTelemetry::getInstance().recordIteration(iter, norm_2(xnew-x));
+    f0 = fnew;
+    x  = xnew;
+    fnorm.lastF(fx);            // get the last value of big-F
+    solverLog << "\nxnew: " << xnew << "\nfxnew: " << fx << "\n";
+
+    // test for convergence
+    double maxval = 0.0;
+    for(size_t i=0; i<fx.size(); ++i) {
+      double val = fabs(fx[i]);
+      maxval = val>maxval ? val : maxval;
+    }
+
+    solverLog << "Convergence test maxval: " << maxval << "\n";
+    if(maxval <= mFTOL) {
+      solverLog << "Solution successful.\n";
+      return 0;                 // SUCCESS 
+    }
+  }
+
+  // if we get here, then we didn't converge in the number of
+  // iterations allowed us.  Return an error code
+  solverLog << "\n****************Maximum solver iterations exceeded.\nlastx: " << x
+            << "\nlastF: " << fx << "\n";
+  return -1;
+}
+
+/*!
+ * \brief Restarted GMRES with right diagonal preconditioning
+ * \details Solves (J M^-1) y = b, dx = M^-1 y, where M = diag(pdiag),
+ * using at most mKrylovDim Krylov vectors before restarting and at
+ * most mMaxLinearIter iterations in total.  Each iteration costs one
+ * evaluation of F.
+ * \param[in] F: The function whose Jacobian appears in the system
+ * \param[in] x: The point at which the Jacobian is evaluated
+ * \param[in] fx: F(x)
+ * \param[in] pdiag: diagonal of the preconditioner
+ * \param[in] b: right hand side
+ * \param[in] tol: required residual relative to |b|
+ * \param[out] dx: the solution
+ * \param[inout] neval: running count of function evaluations
+ * \return 0 if converged, -1 if the iteration limit was reached, 1 on breakdown
+ */
+int LogNewtonKrylov::gmres(VecFVec<double,double> &F, const UBVECTOR &x, const UBVECTOR &fx,
+                           const UBVECTOR &pdiag, const UBVECTOR &b, double tol,
+                           UBVECTOR &dx, int &neval)
+{
+  using boost::numeric::ublas::inner_prod;
+  using boost::numeric::ublas::norm_2;
+  using boost::numeric::ublas::element_div;
+  ILogger &solverLog = ILogger::getLogger("solver_log");
+
+  int n = b.size();
+  int m = std::min<int>(mKrylovDim, n);
+  std::vector<UBVECTOR> V(m+1, UBVECTOR(n));
+  boost::numeric::ublas::matrix<double> H(m+1, m);
+  UBVECTOR cs(m), sn(m), g(m+1), y(m);
+  UBVECTOR r(n), w(n), z(n);
+
+  double bnorm = norm_2(b);
+  dx.resize(n);
+  std::fill(dx.begin(), dx.end(), 0.0);
+  if(bnorm == 0.0) {
+    return 0;
+  }
+  double rtol = tol * bnorm;
+
+  unsigned nlin = 0;
+  r = b;                        // residual for dx == 0
+  while(nlin < mMaxLinearIter) {
+    double beta = norm_2(r);
+    if(beta <= rtol) {
+      return 0;
+    }
+    V[0] = r / beta;
+    std::fill(g.begin(), g.end(), 0.0);
+    g[0] = beta;
+    H.clear();
+
+    int k;
+    bool converged = false;
+    for(k=0; k<m && nlin < mMaxLinearIter; ++k, ++nlin) {
+      z = element_div(V[k], pdiag);
+      jacvec(F, x, fx, z, w);
+      ++neval;
+
+      // modified Gram-Schmidt orthogonalization
+      for(int i=0; i<=k; ++i) {
+        H(i,k) = inner_prod(w, V[i]);
+        w -= H(i,k) * V[i];
+      }
+      H(k+1,k) = norm_2(w);
+      bool lucky = H(k+1,k) == 0.0;
+      if(!lucky) {
+        V[k+1] = w / H(k+1,k);
+      }
+
+      // apply the previous Givens rotations to the new column
+      for(int i=0; i<k; ++i) {
+        double temp = cs[i]*H(i,k) + sn[i]*H(i+1,k);
+        H(i+1,k) = -sn[i]*H(i,k) + cs[i]*H(i+1,k);
+        H(i,k) = temp;
+      }
+      // compute and apply a new rotation to zero the subdiagonal
+      double denom = sqrt(H(k,k)*H(k,k) + H(k+1,k)*H(k+1,k));
+      if(denom == 0.0) {
+        return 1;
+      }
+      cs[k] = H(k,k) / denom;
+      sn[k] = H(k+1,k) / denom;
+      H(k,k) = denom;
+      H(k+1,k) = 0.0;
+      g[k+1] = -sn[k]*g[k];
+      g[k] = cs[k]*g[k];
+
+      if(fabs(g[k+1]) <= rtol || lucky) {
+        converged = true;
+        ++k;
+        ++nlin;
+        break;
+      }
+    }
+
+    // back substitution for the upper triangular least squares problem
+    for(int i=k-1; i>=0; --i) {
+      double sum = g[i];
+      for(int j=i+1; j<k; ++j) {
+        sum -= H(i,j)*y[j];
+      }
+      y[i] = sum / H(i,i);
+    }
+    std::fill(z.begin(), z.end(), 0.0);
+    for(int i=0; i<k; ++i) {
+      z += y[i] * V[i];
+    }
+    dx += element_div(z, pdiag);
+
+    solverLog << "GMRES iterations= " << nlin << "  residual= " << fabs(g[k]) / bnorm << "\n";
+    if(converged) {
+      return 0;
+    }
+
+    // restart with the true residual
+    jacvec(F, x, fx, dx, w);
+    ++neval;
+    r = b - w;
+  }
+
+  return -1;
+}
+
+/*!
+ * \brief Approximate the Jacobian-vector product J . v
+ * \details J . v ~= (F(x + h v) - F(x)) / h.  The step is sized so
+ * that the perturbation of x is comparable to the one jacol uses for
+ * a single column.
+ */
+void LogNewtonKrylov::jacvec(VecFVec<double,double> &F, const UBVECTOR &x, const UBVECTOR &fx,
+                             const UBVECTOR &v, UBVECTOR &jv)
+{
+  using boost::numeric::ublas::norm_2;
+  const double heps = 1.0e-6;
+  const double TINY = 1.0e-6;
+
+  double vnorm = norm_2(v);
+  jv.resize(fx.size());
+  if(vnorm == 0.0) {
+    std::fill(jv.begin(), jv.end(), 0.0);
+    return;
+  }
+  double h = heps * (norm_2(x)/sqrt(double(x.size())) + TINY) / vnorm;
+
+  UBVECTOR xx(x + h*v);
+  F(xx, jv);
+  jv = (jv - fx) / h;
+}
+
+/*!
+ * \brief Compute the diagonal of the finite difference Jacobian
+ * \details Uses the partial derivative shortcut, so each entry costs
+ * only the part of the model that depends on that market.  Entries
+ * that are too small to be inverted safely are replaced by 1, leaving
+ * those markets unpreconditioned.
+ */
+void LogNewtonKrylov::jacdiag(VecFVec<double,double> &F, const UBVECTOR &x, const UBVECTOR &fx,
+                              UBVECTOR &pdiag)
+{
+  const double heps = 1.0e-6;
+  const double TINY = 1.0e-6;
+  const double DMIN = 1.0e-8;
+  UBVECTOR xx(x);
+  UBVECTOR fxx(fx.size());
+
+  for(size_t j=0; j<x.size(); ++j) {
+    double t = xx[j];
+    double h = heps * (fabs(t)+TINY);
+    xx[j] = t+h;
+    h = xx[j]-t;
+    F.partial(j);
+    F(xx, fxx, j);
+    xx[j] = t;
+
+    double d = (fxx[j] - fx[j]) / h;
+    pdiag[j] = fabs(d) > DMIN ? d : 1.0;
+  }
+  F.partial(-1);
+}
+
+#undef UBVECTOR
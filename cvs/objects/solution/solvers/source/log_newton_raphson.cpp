@@ -57,6 +57,7 @@
 #include "solution/util/include/solution_info_filter_factory.h"
 // TODO: this filter is hard coded here since it is the default, is this ok?
 #include "solution/util/include/solvable_nr_solution_info_filter.h"
+#include "solution/util/include/solver_telemetry.h"
 
 using namespace std;
 using namespace xercesc;
@@ -154,7 +155,7 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
         return code = SolverComponent::SUCCESS;
     }
 
-    startMethod();
+    startMethod( aSolutionSet );
     
     // TODO: is the following necessary
     // Update the solution vector for the correct markets to solve.
@@ -207,6 +208,7 @@ SolverComponent::ReturnCode LogNewtonRaphson::solve( SolutionInfoSet& aSolutionS
             // Add to the iteration list.
             SolutionInfo* currWorstSol = aSolutionSet.getWorstSolutionInfo();
             addIteration( currWorstSol->getName(), currWorstSol->getRelativeED() );
+            SolverTelemetry::getInstance().recordIteration( itnum );
 
             worstMarketLog.setLevel( ILogger::NOTICE );
             worstMarketLog << "NR-maxRelED: " << *currWorstSol << endl;
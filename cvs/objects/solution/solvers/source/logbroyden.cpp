@@ -41,6 +41,7 @@
 #include "util/base/include/definitions.h"
 #include <string>
 #include <algorithm>
+#include <map>
 #include <iomanip>
 #include <math.h>
 #include <xercesc/dom/DOMNode.hpp>
@@ -68,6 +69,10 @@
 #include "solution/util/include/ublas-helpers.hpp"
 #include "util/base/include/fltcmp.hpp"
 #include "solution/util/include/jacobian-precondition.hpp"
+#include "solution/util/include/sparse_lu.hpp"
+#include "solution/util/include/block_schur_lu.hpp"
+#include "solution/util/include/solver_trace.h"
+#include "solution/util/include/solver_telemetry.h"
 
 #if USE_LAPACK
 #include <boost/numeric/bindings/traits/ublas_vector.hpp>
@@ -81,6 +86,7 @@
 #endif 
 
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
 
 using namespace xercesc;
 
@@ -102,6 +108,21 @@ namespace {
   }
   inline double SI2price (const SolutionInfo &si) {return si.getPrice();}
 
+  // filter accepting the markets accepted by both of two filters, used
+  // to restrict the solvable set to the core markets
+  class BothSolutionInfoFilter : public ISolutionInfoFilter {
+  public:
+    BothSolutionInfoFilter(const ISolutionInfoFilter *afirst, const ISolutionInfoFilter *asecond) :
+      mFirst(afirst), mSecond(asecond) {}
+    virtual bool acceptSolutionInfo(const SolutionInfo &asi) const {
+      return mFirst->acceptSolutionInfo(asi) && mSecond->acceptSolutionInfo(asi);
+    }
+    virtual bool XMLParse(const xercesc::DOMNode *anode) {return true;}
+  private:
+    const ISolutionInfoFilter *mFirst;
+    const ISolutionInfoFilter *mSecond;
+  };
+
   // read-only accessor for solutionInfoSet (used to prepare log outputs)
   const SolutionInfoSet *cSolInfo=0;
 
@@ -127,6 +148,7 @@ namespace {
 
 int LogBroyden::mLastPer = 0;
 int LogBroyden::mPerIter = 0;
+std::list<LogBroyden::CachedJacobian> LogBroyden::mJacobianCache;
 
 bool LogBroyden::XMLParse( const DOMNode* aNode ) {
     // assume we were passed a valid node.
@@ -159,6 +181,32 @@ bool LogBroyden::XMLParse( const DOMNode* aNode ) {
         else if(nodeName == "log-price") {
           mLogPricep = true;    // not strictly necessary, as this is the default.
         }
+        else if( nodeName == "colored-jacobian" ) {
+            mColoredJacobian = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "sparse-linear-solve" ) {
+            mSparseLinearSolve = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "block-linear-solve" ) {
+            mBlockLinearSolve = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "coupling-markets" ) {
+            mCouplingFilter.reset(
+                SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<std::string>::getValue( curr ) ) );
+        }
+        else if( nodeName == "reuse-jacobian" ) {
+            mReuseJacobian = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "core-markets" ) {
+            mCoreFilter.reset(
+                SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<std::string>::getValue( curr ) ) );
+        }
+        else if( nodeName == "max-peripheral-iterations" ) {
+            mMaxPeripheralIter = XMLHelper<unsigned int>::getValue( curr );
+        }
+        else if( nodeName == "linesearch-batch-size" ) {
+            mLinesearchBatch = std::max( XMLHelper<unsigned int>::getValue( curr ), 1u );
+        }
         else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
             mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
         }
@@ -209,7 +257,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
         return code = SolverComponent::SUCCESS;
     }
     
-    startMethod();
+    startMethod( solnset );
     if(period != mLastPer) {
         // reset our internal counters
         mPerIter = 0;
@@ -220,6 +268,25 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     // Need to update solvable status before starting solution (Ignore return code)
     solnset.updateSolvable( mSolutionInfoFilter.get() );
 
+    // Leave the markets outside the core, if one was given, to be solved
+    // inside each evaluation.
+    std::vector<SolutionInfo> peripheral;
+    if( mCoreFilter.get() ) {
+        const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
+        for( size_t i = 0; i < solvables.size(); ++i ) {
+            if( !mCoreFilter->acceptSolutionInfo( solvables[ i ] ) ) {
+                peripheral.push_back( solvables[ i ] );
+            }
+        }
+        if( !peripheral.empty() && peripheral.size() < solvables.size() ) {
+            BothSolutionInfoFilter coreFilter( mSolutionInfoFilter.get(), mCoreFilter.get() );
+            solnset.updateSolvable( &coreFilter );
+        }
+        else {
+            peripheral.clear();
+        }
+    }
+
     ILogger& solverLog = ILogger::getLogger( "solver_log" );
     solverLog.setLevel( ILogger::NOTICE );
     solverLog << "Beginning Broyden solution for period " << period
@@ -230,6 +297,12 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     else {
       solverLog << "Linear price in effect\n";
     }
+    if( mLinesearchBatch > 1 ) {
+      solverLog << "Line search will try " << mLinesearchBatch << " step lengths at a time\n";
+    }
+    if( !peripheral.empty() ) {
+      solverLog << peripheral.size() << " markets outside the core will be solved inside each evaluation\n";
+    }
     
     ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
     worstMarketLog.setLevel( ILogger::DEBUG );
@@ -243,7 +316,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     }
     
     solverLog << "Initial market state:\nmkt    \tprice   \tsupply  \tdemand\n";
-    std::vector<SolutionInfo> solvables = solnset.getSolvableSet();
+    const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
     for(size_t i=0; i<solvables.size(); ++i) {
         solverLog << std::setw( 8 ) << i << "\t"
                   << std::setw( 8 ) << solvables[i].getPrice() << "\t"
@@ -252,6 +325,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
                   << "\t\t" << solvables[i].getName() << "\n"; 
     } 
 
+    GCAM_PROFILE_SCOPE( "log-broyden" );
     Timer& solverTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::SOLVER );
     solverTimer.start();
     
@@ -270,6 +344,7 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     
     // This is the closure that will evaluate the ED function
     LogEDFun F(solnset, world, marketplace, period, mLogPricep); 
+    F.setPeripheralMarkets(peripheral, mMaxPeripheralIter);
     // check the assumptions:  narg==nrtn==nsolv
     if(F.narg() != nsolv || F.nrtn() != nsolv) {
       solverLog.setLevel(ILogger::SEVERE);
@@ -293,9 +368,28 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     // Precondition the x values to avoid singular columns in the Jacobian
     solverLog.setLevel(ILogger::DEBUG);
     UBMATRIX J(F.narg(), F.nrtn());
-    fdjac(F, x, fx, J, true);
+    std::vector<int> mktids;
+    solnset.getMarketIDs(mktids, true);
+    bool warmStart = mReuseJacobian && getCachedJacobian(F, period, mktids, x, fx, J);
+    if( warmStart ) {
+      solverLog << ">>>> Main loop jacobian taken from a previous solve.\n";
+    }
+    else {
+      fdjac(F, x, fx, J, true);
+      solverLog << ">>>> Main loop jacobian called.\n";
+    }
+
+    // Use the sparsity of the full Jacobian to find groups of markets
+    // that can share partial derivative evaluations in later resets.
+    // A saved Jacobian has had Broyden updates applied so its sparsity
+    // pattern can not be used.
+    JacobianColoring coloring;
+    if( mColoredJacobian && !warmStart ) {
+      findJacobianColoring(F, J, coloring);
+      solverLog << "Jacobian coloring: " << coloring.nevals() << " groups for "
+                << nsolv << " markets.\n";
+    }
 
-    solverLog << ">>>> Main loop jacobian called.\n";
     int pcfail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
 
     if( pcfail ) {
@@ -310,7 +404,20 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
     cSolInfo = &solnset;        // make available for log outputs
 
     // call the solver
-    int bstatus = bsolve(F, x, fx, J, neval);
+    int bstatus = bsolve(F, x, fx, J, neval, coloring.empty() ? 0 : &coloring, warmStart);
+    if( bstatus == 0 && mReuseJacobian ) {
+      storeCachedJacobian(F, period, mktids, J);
+    }
+    if( bstatus == 0 && mLogPricep ) {
+      // Remember the own price response of the normal markets so that
+      // the preconditioner can use it next period.  Their inputs and
+      // outputs are not rescaled in log price mode.
+      for(size_t i=0; i<nsolv; ++i) {
+        if(smkts[i].getType() == IMarketType::NORMAL && J(i,i) < 0.0 && util::isValidNumber(J(i,i))) {
+          smkts[i].setLearnedElasticity(J(i,i));
+        }
+      }
+    }
     mPerIter++;                 // increment the iteration count.  This should produce a visible gap in the trace plots.
 
     solverTimer.stop(); 
@@ -343,6 +450,14 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
         code = FAILURE_UNKNOWN;
         solverLog << "Broyden solution failed for unknown reason.\n";
     }
+    if( !peripheral.empty() ) {
+        // Restore the markets outside the core to the solvable set.
+        solnset.updateSolvable( mSolutionInfoFilter.get() );
+        if( code == SUCCESS && !solnset.isAllSolved() ) {
+            code = FAILURE_UNKNOWN;
+            solverLog << "Markets outside the core were not solved.\n";
+        }
+    }
     if(!solnset.isAllSolved()) {
         solverLog << "The following markets were not solved:\n";
         solnset.printUnsolved( solverLog );
@@ -367,7 +482,8 @@ SolverComponent::ReturnCode LogBroyden::solve(SolutionInfoSet &solnset, int peri
 }
 
 int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
-                       UBMATRIX & B, int &neval)
+                       UBMATRIX & B, int &neval, JacobianColoring *aColoring,
+                       const bool aIsWarmStart)
 {
 #if !USE_LAPACK
   using boost::numeric::ublas::permutation_matrix;
@@ -377,7 +493,10 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
   using boost::numeric::ublas::axpy_prod;
   using boost::numeric::ublas::inner_prod;
   int nrow = B.size1(), ncol = B.size2();
-  int ageB = 0;   // number of iterations since the last reset on B
+  // number of iterations since the last reset on B.  A Jacobian saved from
+  // a previous solve is treated as already aged so that poor progress will
+  // trigger a finite difference reset rather than giving up.
+  int ageB = aIsWarmStart ? 1 : 0;
   // svd decomposition elements (note nrow == ncol)
 #if USE_LAPACK
   UBMATRIX Usv(nrow,ncol),VTsv(ncol,ncol);
@@ -387,6 +506,20 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
 #endif
 
   UBMATRIX Btmp(nrow, ncol);
+  // sparse factorization of the most recent finite difference jacobian
+  // used when mSparseLinearSolve is set
+  SparseLU sparseB;
+  // block factorization used instead when mBlockLinearSolve is set
+  BlockSchurLU blockB;
+  if(mBlockLinearSolve && mCouplingFilter.get()) {
+    const std::vector<SolutionInfo>& solvables = cSolInfo->getSolvableSet();
+    std::vector<bool> iscoupling(solvables.size());
+    for(size_t i=0; i<solvables.size(); ++i) {
+      iscoupling[i] = mCouplingFilter->acceptSolutionInfo(solvables[i]);
+    }
+    blockB.setCouplingHint(iscoupling);
+  }
+  bool factorSparseB = true;
   ILogger &solverLog = ILogger::getLogger("solver_log");
   ILogger& worstMarketLog = ILogger::getLogger( "worst_market_log" );
   worstMarketLog.setLevel( ILogger::DEBUG );
@@ -450,6 +583,7 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
   }
 
   bool lsfail = false;        // flag indicating whether we have had a line-search failure
+  bool coloredReset = false;  // flag indicating B was reset using the coloring and has not yet made progress
   for(int iter=0; iter<mMaxIter; ++iter) {
     // log some debug info
     
@@ -483,78 +617,120 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     }
 
     Btmp = B;                   // save the jacobian approximant
-#if USE_LAPACK /* Solve using SVD */
-    int ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
-                                                       B,           // input matrix
-                                                       Ssv,Usv,VTsv); // outputs
-    if(ierr>0) {
-      // svd failed.  It's not even clear under what circumstances
-      // this can happen
-      solverLog.setLevel(ILogger::SEVERE);
-      solverLog << "****************SVD failed.  This shouldn't happen.  It can't mean anything good.\n";
-      return ierr;
+    if(mSparseLinearSolve || mBlockLinearSolve) {
+      if(factorSparseB) {
+        int sing = mBlockLinearSolve ? blockB.factorize(B) : sparseB.factorize(B);
+        if(sing > 0) {
+          solverLog << "Salvaging Jacobian.\n";
+          int fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
+          f0 = inner_prod(fx,fx);
+          if(!fail) {
+            sing = mBlockLinearSolve ? blockB.factorize(B) : sparseB.factorize(B);
+          }
+          if(fail || sing > 0) {
+            solverLog.setLevel(ILogger::WARNING);
+            solverLog << "Singular Jacobian:\n" << B << "\n";
+            return sing > 0 ? sing : 1;
+          }
+          Btmp = B;
+        }
+        factorSparseB = false;
+        if(mBlockLinearSolve) {
+          solverLog << "Block Jacobian factorization:  blocks= " << blockB.getNumBlocks()
+                    << "  coupling markets= " << blockB.getNumCoupling()
+                    << "  nnz(B)= " << blockB.getNumNonZero()
+                    << "  nnz(LU)= " << blockB.getNumFactorNonZero() << "\n";
+        }
+        else {
+          solverLog << "Sparse Jacobian factorization:  nnz(B)= " << sparseB.getNumNonZero()
+                    << "  nnz(LU)= " << sparseB.getNumFactorNonZero() << "\n";
+        }
+      }
+      // Any Broyden updates since the factorization are applied by
+      // Sherman-Morrison within the solve.
+      dx = -1.0*fx;
+      if(mBlockLinearSolve) {
+        blockB.solve(dx);
+      }
+      else {
+        sparseB.solve(dx);
+      }
+      solverLog << "dx: " << dx << "\n";
     }
+    else {
+#if USE_LAPACK /* Solve using SVD */
+      int ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
+                                                         B,           // input matrix
+                                                         Ssv,Usv,VTsv); // outputs
+      if(ierr>0) {
+        // svd failed.  It's not even clear under what circumstances
+        // this can happen
+        solverLog.setLevel(ILogger::SEVERE);
+        solverLog << "****************SVD failed.  This shouldn't happen.  It can't mean anything good.\n";
+        return ierr;
+      }
 
-    // At this point, U, S, and VT contain the SVD of the original Jacobian
-    solverLog.setLevel(ILogger::DEBUG);
-    dx = -1.0*fx; 
-    int nsing = svdInvertSolve(Usv,Ssv,VTsv,dx, solverLog);
+      // At this point, U, S, and VT contain the SVD of the original Jacobian
+      solverLog.setLevel(ILogger::DEBUG);
+      dx = -1.0*fx; 
+      int nsing = svdInvertSolve(Usv,Ssv,VTsv,dx, solverLog);
 
-    solverLog << "\nIteration " << iter << "\nf0= " << f0
-              << "\tnsing= " << nsing
-              << "\nx: " << x << "\nF( x ): " << fx << "\ndx: " << dx << "\n";
+      solverLog << "\nIteration " << iter << "\nf0= " << f0
+                << "\tnsing= " << nsing
+                << "\nx: " << x << "\nF( x ): " << fx << "\ndx: " << dx << "\n";
 
 #else /* No USE_LAPACK.  Solve using L-U decomposition */
-    int itrial = 0;
-    /* If the L-U decomposition fails the first time around, we will
-       invoke the jacobian preconditioner and try again.  If it fails
-       a second time, we bail out */
-    do {
-      for(size_t i=0; i<p.size(); ++i) {
-        p[i] = i;
-      }
-      int sing = lu_factorize(B,p);
-      if(sing>0) {
-        int fail=1;
-        B = Btmp;           // restore Jacobian
-        if(itrial == 0) {
-            solverLog << "Salvaging Jacobian.\n";
-            fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
-            f0 = inner_prod(fx,fx);
-
-            // log the diagonal of the new jacobian
-            for(int j=0; j<F.narg(); ++j) {
-                jdiag[j] = B(j,j); 
-            }
-            solverLog << "After jacobian salvage.  diag( B )=\n" << jdiag << "\n";
-
+      int itrial = 0;
+      /* If the L-U decomposition fails the first time around, we will
+         invoke the jacobian preconditioner and try again.  If it fails
+         a second time, we bail out */
+      do {
+        for(size_t i=0; i<p.size(); ++i) {
+          p[i] = i;
         }
+        int sing = lu_factorize(B,p);
+        if(sing>0) {
+          int fail=1;
+          B = Btmp;           // restore Jacobian
+          if(itrial == 0) {
+              solverLog << "Salvaging Jacobian.\n";
+              fail = jacobian_precondition(x, fx, B, F, &solverLog, mLogPricep);
+              f0 = inner_prod(fx,fx);
+
+              // log the diagonal of the new jacobian
+              for(int j=0; j<F.narg(); ++j) {
+                  jdiag[j] = B(j,j); 
+              }
+              solverLog << "After jacobian salvage.  diag( B )=\n" << jdiag << "\n";
+
+          }
         
-        if( fail ) {
-            solverLog.setLevel(ILogger::WARNING);
-            solverLog << "Singular Jacobian:\n" << B << "\n";
-            return sing;
+          if( fail ) {
+              solverLog.setLevel(ILogger::WARNING);
+              solverLog << "Singular Jacobian:\n" << B << "\n";
+              return sing;
+          }
         }
+        else {
+          // L-U decomp was successful.  Continue with the next phase of the algorithm.
+          break;
+        }
+      } while(++itrial < 2);
+    
+      // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
+      dx = -1.0*fx;
+      try {
+        lu_substitute(B,p,dx);    // solve dx = J^-1 F
       }
-      else {
-        // L-U decomp was successful.  Continue with the next phase of the algorithm.
-        break;
+      catch (const boost::numeric::ublas::internal_logic &err) {
+        // This error seems to be thrown when the Jacobian is
+        // ill-conditioned.  We let it go because often the solver will
+        // muddle through to a solution.  If not, then it will
+        // eventually stop with a genuinely singular matrix.
       }
-    } while(++itrial < 2);
-    
-    // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
-    dx = -1.0*fx;
-    try {
-      lu_substitute(B,p,dx);    // solve dx = J^-1 F
-    }
-    catch (const boost::numeric::ublas::internal_logic &err) {
-      // This error seems to be thrown when the Jacobian is
-      // ill-conditioned.  We let it go because often the solver will
-      // muddle through to a solution.  If not, then it will
-      // eventually stop with a genuinely singular matrix.
-    }
-    solverLog << "dx: " << dx << "\n"; 
+      solverLog << "dx: " << dx << "\n"; 
 #endif /* USE_LAPACK */
+    }
 
     // log the proposal step
     solverLog << "Proposal step magnitude dxmag= " << sqrt(inner_prod(dx,dx)) << "\n\n";
@@ -564,7 +740,7 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     // dx now holds the newton step.  Execute the line search along
     // that direction.
     double fnew;
-    int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval, &solverLog);
+    int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval, &solverLog, mLinesearchBatch);
 
     if(lserr != 0) {
       // line search failed.  There are a couple of things that could
@@ -572,13 +748,27 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
 
       // 1) B is not a descent direction.  If this is the first
       // failure starting from this x value, try a finite difference
-      // jacobian
-      if(!lsfail) {
-        solverLog << "**Failed line search. Evaluating fdjac\n";
+      // jacobian.  The line search has rolled the model back to x, if
+      // the undo log is enabled, so the partial derivatives start from
+      // the right state.
+      // If B came from a colored reset the coloring may be missing
+      // entries which are no longer zero so try the full jacobian.
+      if(!lsfail || coloredReset) {
+        if(coloredReset) {
+          solverLog << "**Failed line search after a colored reset. Evaluating full fdjac\n";
+          fdjacRecolor(F,x,fx,B,aColoring);
+          neval += x.size();
+          coloredReset = false;
+        }
+        else {
+          solverLog << "**Failed line search. Evaluating fdjac\n";
+          fdjacColored(F,x,fx,B,aColoring);
+          neval += aColoring ? aColoring->nevals() : x.size();
+          coloredReset = aColoring != 0;
+        }
         lsfail = true;
-        fdjac(F,x,fx,B);
-        neval += x.size();
         ageB = 0;  // reset the age on B
+        factorSparseB = true;
 
         // Log the diagonal of the new jacobian after the failed line search
         for(int j=0; j<F.narg(); ++j) {
@@ -598,6 +788,7 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       if(msf < mFTOL) {
         // basically, we're letting ourselves converge to the sqrt of
         // our intended tolerance.
+        B = Btmp;               // leave the jacobian, not its factorization, for the caller
         return 0;
       }
 
@@ -655,6 +846,7 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       solverLog << "Solution successful.\n";
       x = xnew;
       fx = fxnew;
+      B = Btmp;                 // leave the jacobian, not its factorization, for the caller
       return 0;                 // SUCCESS 
     }
 
@@ -691,6 +883,13 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       fxstep /= dx2;
       B += outer_prod(fxstep, xstep);
       ageB++;                // increment the age of B
+      coloredReset = false;
+      if((mBlockLinearSolve && !blockB.update(fxstep, xstep)) ||
+         (!mBlockLinearSolve && mSparseLinearSolve && !sparseB.update(fxstep, xstep))) {
+        // The update makes B singular so refactor it from the dense
+        // copy, which will trigger the jacobian salvage.
+        factorSparseB = true;
+      }
     }
     else {
       // Progress using the Broyden formula is anemic.  This usually
@@ -698,9 +897,11 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
       // old, try a finite-difference jacobian to get us back on track.
       if(ageB > 0) {
         solverLog << "Insufficient progress with Broyden formula.  Resetting the Jacobian.\n(f0= " << f0 << ", fnew= " << fnew << ")\n";
-        fdjac(F,xnew,fxnew,B);
-        neval += x.size();
+        fdjacColored(F,xnew,fxnew,B,aColoring);
+        neval += aColoring ? aColoring->nevals() : x.size();
         ageB = 0;
+        coloredReset = aColoring != 0;
+        factorSparseB = true;
 
         // Log the results of the Jacobian reset
         for(int j=0; j<F.narg(); ++j) {
@@ -710,6 +911,21 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
         solverLog << "New Jacobian:  diag( B )=\n" << jdiag << "\n";
         
       }
+      else if(coloredReset) {
+        // The reset used the coloring, which may be missing entries that
+        // are no longer zero.  Try again with the full jacobian.
+        solverLog << "Insufficient progress after a colored reset.  Resetting the full Jacobian.\n";
+        fdjacRecolor(F,xnew,fxnew,B,aColoring);
+        neval += x.size();
+        coloredReset = false;
+        factorSparseB = true;
+
+        for(int j=0; j<F.narg(); ++j) {
+            jdiag[j] = B(j,j);
+        }
+
+        solverLog << "New Jacobian:  diag( B )=\n" << jdiag << "\n";
+      }
       else {
         // just did a reset, and it didn't help us.  Probably we've
         // got a very ill-behaved value in one of the variables.  Kick
@@ -726,6 +942,8 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
     reportVec("deltafx", fxnew-fx, mktids_solv, issolvable_solv); // fxstep definitely modified above
     reportVec("diagB", jdiag, mktids_solv, issolvable_solv);
     reportPSD(rptvec_all, mktids_all, issolvable_all);                // report price, supply, and demand.  
+    SolverTrace::getInstance().record(mPerIter, mktids_solv, x, xnew, fxnew);
+    SolverTelemetry::getInstance().recordIteration(mPerIter, norm_2(xnew-x));
     mPerIter++;
 
     // update x, fx, f0 for next iteration
@@ -742,6 +960,121 @@ int LogBroyden::bsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx,
   return -1;
 }
 
+/*!
+ * \brief Fill in the initial Jacobian from one saved by a previous solve.
+ * \details We take the Jacobian saved for the latest period not after
+ *          aPeriod, preferring the one with the most markets in common when
+ *          there are several.  A Jacobian for the same period would have
+ *          come from a previous scenario in a batch run.  Columns for markets
+ *          which were not in the saved Jacobian are calculated by finite
+ *          differences.  The rows for those markets in the remaining columns
+ *          are left at zero for the Broyden updates to fill in.  If fewer
+ *          than half of the markets are in common a warm start is unlikely
+ *          to help and we decline.
+ * \param F The excess demand function which also provides the scaling
+ *          to apply to the saved Jacobian.
+ * \param aPeriod The model period being solved.
+ * \param aMarketIDs The serial numbers of the markets being solved.
+ * \param x The current inputs.
+ * \param fx F( x )
+ * \param J The Jacobian to fill in.
+ * \return True if J was filled in, false if a full Jacobian is required.
+ */
+bool LogBroyden::getCachedJacobian( LogEDFun &F, const int aPeriod, const std::vector<int> &aMarketIDs,
+                                    const UBVECTOR &x, const UBVECTOR &fx, UBMATRIX &J ) const
+{
+  const size_t nsolv = aMarketIDs.size();
+  const CachedJacobian *best = 0;
+  std::vector<int> bestIndex;
+  size_t bestOverlap = 0;
+  for(std::list<CachedJacobian>::const_iterator it = mJacobianCache.begin(); it != mJacobianCache.end(); ++it) {
+    if(it->mPeriod > aPeriod || (best && it->mPeriod < best->mPeriod)) {
+      continue;
+    }
+    std::map<int, int> cachedIndex;
+    for(size_t i=0; i<it->mMarketIDs.size(); ++i) {
+      cachedIndex[it->mMarketIDs[i]] = i;
+    }
+    std::vector<int> index(nsolv, -1);
+    size_t overlap = 0;
+    for(size_t i=0; i<nsolv; ++i) {
+      std::map<int, int>::const_iterator found = cachedIndex.find(aMarketIDs[i]);
+      if(found != cachedIndex.end()) {
+        index[i] = found->second;
+        ++overlap;
+      }
+    }
+    if(!best || it->mPeriod > best->mPeriod || overlap > bestOverlap) {
+      best = &*it;
+      bestIndex.swap(index);
+      bestOverlap = overlap;
+    }
+  }
+  if(!best || 2 * bestOverlap < nsolv) {
+    return false;
+  }
+
+  const UBVECTOR &xscl = F.getInputScale();
+  const UBVECTOR &fxscl = F.getOutputScale();
+  std::vector<int> missing;
+  for(size_t j=0; j<nsolv; ++j) {
+    if(bestIndex[j] < 0) {
+      missing.push_back(j);
+      continue;
+    }
+    for(size_t i=0; i<nsolv; ++i) {
+      J(i,j) = bestIndex[i] < 0 ? 0.0 : best->mJ(bestIndex[i], bestIndex[j]) * fxscl[i] * xscl[j];
+    }
+  }
+  if(!missing.empty()) {
+    scenario->getManageStateVariables()->setPartialDeriv(true);
+    for(size_t k=0; k<missing.size(); ++k) {
+      jacol(F, x, fx, missing[k], J);
+    }
+    F.partial(-1);
+  }
+
+  ILogger &solverLog = ILogger::getLogger("solver_log");
+  solverLog << "Warm starting from the Jacobian saved in period " << best->mPeriod << " with "
+            << missing.size() << " new columns.\n";
+  return true;
+}
+
+/*!
+ * \brief Save the Jacobian at the end of a successful solve.
+ * \details Replaces any Jacobian previously saved for the same period and set
+ *          of markets.  Note that each saved Jacobian is dense so memory
+ *          grows by N^2 per period and distinct set of markets solved.
+ * \param F The excess demand function whose scaling will be removed.
+ * \param aPeriod The model period that was solved.
+ * \param aMarketIDs The serial numbers of the markets that were solved.
+ * \param J The Jacobian at the solution.
+ */
+void LogBroyden::storeCachedJacobian( const LogEDFun &F, const int aPeriod, const std::vector<int> &aMarketIDs,
+                                      const UBMATRIX &J ) const
+{
+  const UBVECTOR &xscl = F.getInputScale();
+  const UBVECTOR &fxscl = F.getOutputScale();
+  UBMATRIX unscaledJ(J);
+  for(size_t i=0; i<J.size1(); ++i) {
+    for(size_t j=0; j<J.size2(); ++j) {
+      unscaledJ(i,j) /= fxscl[i] * xscl[j];
+    }
+  }
+
+  for(std::list<CachedJacobian>::iterator it = mJacobianCache.begin(); it != mJacobianCache.end(); ++it) {
+    if(it->mPeriod == aPeriod && it->mMarketIDs == aMarketIDs) {
+      it->mJ.swap(unscaledJ);
+      return;
+    }
+  }
+  CachedJacobian cached;
+  cached.mPeriod = aPeriod;
+  cached.mMarketIDs = aMarketIDs;
+  mJacobianCache.push_back(cached);
+  mJacobianCache.back().mJ.swap(unscaledJ);
+}
+
 /*! \brief Write a vector into the solver data log
  *
  *  \details We write the solver data log in "long" format; i.e., with
@@ -789,8 +1122,8 @@ void LogBroyden::reportPSD(UBVECTOR &arptvec, const std::vector<int> &amktids, c
         return;
     }
 
-    std::vector<SolutionInfo> solvable = cSolInfo->getSolvableSet();
-    std::vector<SolutionInfo> unsolvable = cSolInfo->getUnsolvableSet();
+    const std::vector<SolutionInfo>& solvable = cSolInfo->getSolvableSet();
+    const std::vector<SolutionInfo>& unsolvable = cSolInfo->getUnsolvableSet();
 
     unsigned int i;
     unsigned int j;
@@ -65,6 +65,8 @@
 #include "solution/util/include/edfun.hpp"
 #include "solution/util/include/ublas-helpers.hpp"
 #include "solution/util/include/jacobian-precondition.hpp" 
+#include "solution/util/include/sparse_lu.hpp"
+#include "solution/util/include/solver_telemetry.h"
 #include "util/base/include/fltcmp.hpp"
 
 #if USE_LAPACK
@@ -79,6 +81,7 @@
 #endif
 
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
 
 using namespace std;
 using namespace xercesc;
@@ -131,6 +134,12 @@ bool LogNRbt::XMLParse( const DOMNode* aNode ) {
         else if(nodeName == "log-price") {
           mLogPricep = true;    // not strictly necessary, as this is the default.
         } 
+        else if( nodeName == "colored-jacobian" ) {
+            mColoredJacobian = XMLHelper<bool>::getValue( curr );
+        }
+        else if( nodeName == "sparse-linear-solve" ) {
+            mSparseLinearSolve = XMLHelper<bool>::getValue( curr );
+        }
         else if( SolutionInfoFilterFactory::hasSolutionInfoFilter( nodeName ) ) {
             mSolutionInfoFilter.reset( SolutionInfoFilterFactory::createAndParseSolutionInfoFilter( nodeName, curr ) );
         }
@@ -168,7 +177,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
         return code = SolverComponent::SUCCESS;
     }
 
-    startMethod();
+    startMethod( solnset );
     
     // Update the solution vector for the correct markets to solve.
     // Need to update solvable status before starting solution (Ignore return code)
@@ -190,7 +199,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
     }
     
     solverLog << "Initial market state:\nmkt\tprice\tsupply\tdemand\n";
-    std::vector<SolutionInfo> solvables = solnset.getSolvableSet();
+    const std::vector<SolutionInfo>& solvables = solnset.getSolvableSet();
     for(size_t i=0; i<solvables.size(); ++i) {
       solverLog << i << "\t" << solvables[i].getPrice()
                 << "\t" << solvables[i].getSupply()
@@ -198,6 +207,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
                 << "\t\t" << solvables[i].getName() << "\n";
     } 
 
+    GCAM_PROFILE_SCOPE( "log-newton-raphson-bt" );
     Timer& solverTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::SOLVER );
     solverTimer.start();
     
@@ -226,6 +236,16 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
     solverLog.setLevel(ILogger::DEBUG);
     UBMATRIX J(F.narg(),F.nrtn());
     fdjac(F, x, fx, J, true);
+
+    // Use the sparsity of the full Jacobian to find groups of markets
+    // that can share partial derivative evaluations in later iterations.
+    JacobianColoring coloring;
+    if(mColoredJacobian) {
+      findJacobianColoring(F, J, coloring);
+      solverLog << "Jacobian coloring: " << coloring.nevals() << " groups for "
+                << nsolv << " markets.\n";
+    }
+
     int pcfail = jacobian_precondition(x,fx,J,F,&solverLog, mLogPricep);
 
     if(pcfail) {
@@ -238,7 +258,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
     }
     
     // call the solver
-    int nrstatus = nrsolve(F, x, fx, J, neval);
+    int nrstatus = nrsolve(F, x, fx, J, neval, mColoredJacobian ? &coloring : 0);
 
 
     solverTimer.stop();
@@ -276,7 +296,7 @@ SolverComponent::ReturnCode LogNRbt::solve( SolutionInfoSet& solnset, int period
 
 
 int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMATRIX &J,
-                     int &neval)
+                     int &neval, JacobianColoring *aColoring)
 {
 #if !USE_LAPACK
   using boost::numeric::ublas::permutation_matrix;
@@ -296,6 +316,7 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
   permutation_matrix<int> p(F.narg()); // permutation vector for pivoting in L-U decomposition
 #endif
   UBMATRIX Jtmp(nrow, ncol);
+  SparseLU sparseJ;           // used when mSparseLinearSolve is set
   
 
   ILogger &solverLog = ILogger::getLogger("solver_log");
@@ -319,6 +340,8 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
   // We create a functor that computes f(x) = F(x)*F(x).  It also
   // stores the value of F that it produces as an intermediate.
   FdotF<double,double> fnorm(F);
+  // whether J was calculated using the coloring rather than in full
+  bool coloredJ = false;
   double f0 = inner_prod(fx,fx); // already have a value of F on input, so no need to call fnorm yet
   if(f0 < FTINY)
     // Guard against F=0 since it can cause a NaN in our solver.  This
@@ -341,102 +364,133 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
 
     Jtmp = J;                   // save the Jacobian, since gesvd destroys it.
 
+    if(mSparseLinearSolve) {
+      int sing = sparseJ.factorize(J);
+      if(sing > 0) {
+        int fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
+        if(!fail) {
+          sing = sparseJ.factorize(J);
+        }
+        if(fail || sing > 0) {
+          solverLog.setLevel(ILogger::WARNING);
+          solverLog << "Singular Jacobian:\n" << Jtmp << "\n";
+          return sing > 0 ? sing : 1;
+        }
+      }
+      solverLog << "Sparse Jacobian factorization:  nnz(J)= " << sparseJ.getNumNonZero()
+                << "  nnz(LU)= " << sparseJ.getNumFactorNonZero() << "\n";
+      dx = -1.0*fx;
+      sparseJ.solve(dx);
+    }
+    else {
 #if USE_LAPACK
-    int ierr =
-      boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
-                                              J,           // input matrix
-                                              Ssv,Usv,VTsv); // output matrices
-    if(ierr != 0) {
-      // svd failed.  It's not even clear under what circumstances
-      // this can happen
-      solverLog.setLevel(ILogger::SEVERE);
-      solverLog << "****************SVD failed.  This shouldn't happen.  It can't mean anything good.\n";
-      return ierr;
-    } 
+      int ierr =
+        boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
+                                                J,           // input matrix
+                                                Ssv,Usv,VTsv); // output matrices
+      if(ierr != 0) {
+        // svd failed.  It's not even clear under what circumstances
+        // this can happen
+        solverLog.setLevel(ILogger::SEVERE);
+        solverLog << "****************SVD failed.  This shouldn't happen.  It can't mean anything good.\n";
+        return ierr;
+      } 
     
-    // At this point, U, S, and VT contain the SVD of the original Jacobian
-    solverLog.setLevel(ILogger::DEBUG);
-    dx = -1.0*fx; 
-    int nsing = svdInvertSolve(Usv,Ssv,VTsv,dx, solverLog);
+      // At this point, U, S, and VT contain the SVD of the original Jacobian
+      solverLog.setLevel(ILogger::DEBUG);
+      dx = -1.0*fx; 
+      int nsing = svdInvertSolve(Usv,Ssv,VTsv,dx, solverLog);
     
-    solverLog.setLevel(ILogger::DEBUG);
-    solverLog << "\n****************Iteration " << iter << "\nf0= " << f0
-              << "\tnsing= " << nsing
-              << "\nx: " << x << "\nF(x): " << fx << "\ndx: " << dx << "\n";
-
-
-    if(nsing > 0) {
-      singcount += nsing;
-      if(singcount < scmax) {
-        // Try to reset the x value using the preconditioner
-        solverLog << "Resetting singular matrix, singcount = " << singcount << "\n";
-        J = Jtmp;
-        int fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
-        if(fail)
-          return nsing;
-
-        // re-evaluate f0 and gx at the new guess
-        double f0 = inner_prod(fx,fx);
-        axpy_prod(fx,J,gx);         // compute the gradient of F*F (= fx^T * J == J^T * fx)
+      solverLog.setLevel(ILogger::DEBUG);
+      solverLog << "\n****************Iteration " << iter << "\nf0= " << f0
+                << "\tnsing= " << nsing
+                << "\nx: " << x << "\nF(x): " << fx << "\ndx: " << dx << "\n";
+
+
+      if(nsing > 0) {
+        singcount += nsing;
+        if(singcount < scmax) {
+          // Try to reset the x value using the preconditioner
+          solverLog << "Resetting singular matrix, singcount = " << singcount << "\n";
+          J = Jtmp;
+          int fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
+          if(fail)
+            return nsing;
+
+          // re-evaluate f0 and gx at the new guess
+          double f0 = inner_prod(fx,fx);
+          axpy_prod(fx,J,gx);         // compute the gradient of F*F (= fx^T * J == J^T * fx)
         
-        // re-solve for dx using the new Jacobian
-        ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
-                                                       J,           // input matrix
-                                                       Ssv,Usv,VTsv); // output matrices
-        if(ierr)
+          // re-solve for dx using the new Jacobian
+          ierr = boost::numeric::bindings::lapack::gesvd('O','A','A', // control parameters
+                                                         J,           // input matrix
+                                                         Ssv,Usv,VTsv); // output matrices
+          if(ierr)
+            return nsing;
+          dx = -1.0*fx;
+          svdInvertSolve(Usv, Ssv, VTsv, dx, solverLog);
+        }
+        else {
           return nsing;
-        dx = -1.0*fx;
-        svdInvertSolve(Usv, Ssv, VTsv, dx, solverLog);
-      }
-      else {
-        return nsing;
+        }
       }
-    }
-    else
-      singcount = 0;
+      else
+        singcount = 0;
 #else  /* No USE_LAPACK.  Use L-U decomposition to do the solution. */
-    int itrial = 0;
-    /* If the L-U decomposition fails the first time around, we will
-       invoke the jacobian preconditioner and try again.  If it fails
-       a second time, we bail out */
-    do {
-      for(size_t i=0; i<p.size(); ++i) p[i] = i;
-      int sing = lu_factorize(J,p);
-      if(sing>0) {
-        int fail=1;
-        if(itrial == 0)
-          fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
+      int itrial = 0;
+      /* If the L-U decomposition fails the first time around, we will
+         invoke the jacobian preconditioner and try again.  If it fails
+         a second time, we bail out */
+      do {
+        for(size_t i=0; i<p.size(); ++i) p[i] = i;
+        int sing = lu_factorize(J,p);
+        if(sing>0) {
+          int fail=1;
+          if(itrial == 0)
+            fail = jacobian_precondition(x, fx, J, F, &solverLog, mLogPricep);
         
-        if(fail) {
-          solverLog.setLevel(ILogger::WARNING);
-          solverLog << "Singular Jacobian:\n" << Jtmp << "\n";
-          return sing;
+          if(fail) {
+            solverLog.setLevel(ILogger::WARNING);
+            solverLog << "Singular Jacobian:\n" << Jtmp << "\n";
+            return sing;
+          }
+        }
+        else {
+          // L-U decomp was successful.  Continue with the next phase of the algorithm.
+          break;
         }
+      } while(++itrial < 2);
+    
+      // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
+      dx = -1.0*fx;
+      try {
+        lu_substitute(J,p,dx);    // solve dx = J^-1 F
       }
-      else {
-        // L-U decomp was successful.  Continue with the next phase of the algorithm.
-        break;
+      catch (const boost::numeric::ublas::internal_logic &err) {
+        // This error seems to be thrown when the Jacobian is
+        // ill-conditioned.  We let it go because often the solver will
+        // muddle through to a solution.  If not, then it will
+        // eventually stop with a genuinely singular matrix.
       }
-    } while(++itrial < 2);
-    
-    // J now holds the L-U decomposition of the Jacobian.  Attempt backsubstitution
-    dx = -1.0*fx;
-    try {
-      lu_substitute(J,p,dx);    // solve dx = J^-1 F
-    }
-    catch (const boost::numeric::ublas::internal_logic &err) {
-      // This error seems to be thrown when the Jacobian is
-      // ill-conditioned.  We let it go because often the solver will
-      // muddle through to a solution.  If not, then it will
-      // eventually stop with a genuinely singular matrix.
-    }
 #endif /* USE_LAPACK */
+    }
     
     // dx now holds the newton step.  Execute the line search along
     // that direction.
     double fnew;
     int lserr = linesearch(fnorm,x,f0,gx,dx, xnew,fnew, neval);
 
+    if(lserr != 0 && coloredJ) {
+      // The coloring may be missing entries of the Jacobian which are
+      // no longer zero, so retry from x with the full Jacobian.  The
+      // line search has rolled the model back to x if the undo log is
+      // enabled.
+      solverLog << "Failed line search with a colored Jacobian.  Evaluating full fdjac.\n";
+      fdjacRecolor(F,x,fx,J,aColoring);
+      neval += x.size();
+      coloredJ = false;
+      continue;
+    }
     if(lserr != 0) {
       // line search failed.  This means that the descent direction
       // for F only extends a very short way (roughly TOL * x0).
@@ -463,6 +517,7 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
     }
 
     UBVECTOR xstep = xnew-x;    // step in x eventually taken
+    SolverTelemetry::getInstance().recordIteration(iter, norm_2(xstep));
     solverLog << "################Return from linesearch\nfold= " << f0 << "\tfnew= " << fnew
               << "\n";
     f0 = fnew;
@@ -484,8 +539,9 @@ int LogNRbt::nrsolve(VecFVec<double,double> &F, UBVECTOR &x, UBVECTOR &fx, UBMAT
       return 0;                 // SUCCESS 
     }
     
-    fdjac(F,x,fx,J);            // calculate finite difference Jacobian for the next iteration
-    neval += x.size();          // N evaluations from calculating the Jacobian
+    fdjacColored(F,x,fx,J,aColoring); // calculate finite difference Jacobian for the next iteration
+    neval += aColoring ? aColoring->nevals() : x.size(); // evaluations from calculating the Jacobian
+    coloredJ = aColoring != 0;
   }
 
   // if we get here, then we didn't converge in the number of
@@ -60,6 +60,7 @@
 #include "solution/util/include/solvable_solution_info_filter.h"
 
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
 
 using namespace std;
 using namespace xercesc;
@@ -71,7 +72,8 @@ Preconditioner::Preconditioner( Marketplace* marketplaceIn, World* worldIn, Calc
   mPriceIncreaseFac(0.25),
   mPriceDecreaseFac(0.1),
   mLargePrice(1.0e6),
-  mFTOL(util::getSmallNumber())
+  mFTOL(util::getSmallNumber()),
+  mUseLearnedElasticity(false)
 {
 }
 
@@ -124,6 +126,9 @@ bool Preconditioner::XMLParse( const DOMNode* aNode ) {
         else if( nodeName == "ftol") {
             mFTOL = XMLHelper<double>::getValue(curr);
         }
+        else if( nodeName == "learned-elasticity-step" ) {
+            mUseLearnedElasticity = XMLHelper<bool>::getValue( curr );
+        }
         else if( nodeName == "solution-info-filter" ) {
             mSolutionInfoFilter.reset(
                 SolutionInfoFilterFactory::createSolutionInfoFilterFromString( XMLHelper<string>::getValue( curr ) ) );
@@ -181,6 +186,7 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
     // for now we'll just record this in the "bisect timer", since
     // this solver is intended as a functional replacement for
     // bisection
+    GCAM_PROFILE_SCOPE( "preconditioner" );
     Timer& bisectTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::BISECT );
     bisectTimer.start();
     
@@ -188,7 +194,7 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
     solverLog << "Solution set before Preconditioning: " << endl << aSolutionSet << endl;
     
     
-    startMethod();
+    startMethod( aSolutionSet );
     
     worstMarketLog << "Market Name, X, XL, XR, ED, EDL, EDR, RED, bracketed, supply, demand" << endl;
     solverLog << "Preconditioning routine starting" << endl; 
@@ -289,6 +295,24 @@ SolverComponent::ReturnCode Preconditioner::solve( SolutionInfoSet& aSolutionSet
                       chg = true;
                       ++nchg;
                     }
+                    else if(mUseLearnedElasticity && pass == 0 && oldprice > 0.0 &&
+                            oldsply > 0.0 && olddmnd > 0.0 &&
+                            solvable[i].getLearnedElasticity() < 0.0 &&
+                            !solvable[i].isWithinTolerance()) {
+                      // The price is in a sensible range so take a
+                      // Newton step in log price using the response
+                      // to price the solver found last period,
+                      // changing the price by at most a factor of
+                      // two.  This is only done on the first pass so
+                      // that it costs a single extra evaluation.
+                      const double maxstep = log(2.0);
+                      double dlogp = -log(olddmnd/oldsply) / solvable[i].getLearnedElasticity();
+                      dlogp = std::max(-maxstep, std::min(dlogp, maxstep));
+                      newprice = oldprice * exp(dlogp);
+                      solvable[i].setPrice(newprice);
+                      chg = true;
+                      ++nchg;
+                    }
                     break; 
                 case IMarketType::TRIAL_VALUE:
                     lb = solvable[i].getLowerBoundSupplyPrice();
@@ -45,6 +45,7 @@
 
 #include "solution/solvers/include/solver_component.h"
 #include "solution/util/include/calc_counter.h"
+#include "solution/util/include/solver_telemetry.h"
 
 using namespace std;
 
@@ -94,9 +95,11 @@ bool SolverComponent::isImproving( const unsigned int aNumIter ) const {
     return( static_cast<double>( numBetter ) / ( aNumIter - 1 ) > 0.25 );
 }
 
-void SolverComponent::startMethod(){
+void SolverComponent::startMethod( const SolutionInfoSet& aSolutionSet ){
     // Set the current calculation method.  
     calcCounter->setCurrentMethod( getXMLName() );
     // Clear the stack.
     mPastIters.clear();
+    // Record the iterations of this method in the telemetry.
+    SolverTelemetry::getInstance().startComponent( getXMLName(), aSolutionSet, calcCounter );
 }
@@ -55,6 +55,8 @@
 #include "solution/solvers/include/bisect_policy.h"
 #include "solution/solvers/include/lognrbt.hpp"
 #include "solution/solvers/include/logbroyden.hpp"
+#include "solution/solvers/include/log_newton_krylov.hpp"
+#include "solution/solvers/include/log_anderson.hpp"
 #include "solution/solvers/include/preconditioner.hpp"
 
 using namespace std;
@@ -77,6 +79,8 @@ bool SolverComponentFactory::hasSolverComponent( const string& aXMLName ) {
         || BisectPolicy::getXMLNameStatic() == aXMLName
         || LogNRbt::getXMLNameStatic() == aXMLName
         || LogBroyden::getXMLNameStatic() == aXMLName
+        || LogNewtonKrylov::getXMLNameStatic() == aXMLName
+        || LogAnderson::getXMLNameStatic() == aXMLName
         || Preconditioner::getXMLNameStatic() == aXMLName;
 }
 
@@ -129,6 +133,12 @@ SolverComponentFactory::createAndParseSolverComponent( const string& aXMLName,
     else if( LogBroyden::getXMLNameStatic() == aXMLName ) {
         retSolverComponent = new LogBroyden( aMarketplace, aWorld, aCalcCounter );
     }
+    else if( LogNewtonKrylov::getXMLNameStatic() == aXMLName ) {
+        retSolverComponent = new LogNewtonKrylov( aMarketplace, aWorld, aCalcCounter );
+    }
+    else if( LogAnderson::getXMLNameStatic() == aXMLName ) {
+        retSolverComponent = new LogAnderson( aMarketplace, aWorld, aCalcCounter );
+    }
     else if( Preconditioner::getXMLNameStatic() == aXMLName ) {
         retSolverComponent = new Preconditioner( aMarketplace, aWorld, aCalcCounter );
     }
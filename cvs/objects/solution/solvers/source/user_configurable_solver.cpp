@@ -126,6 +126,8 @@ bool UserConfigurableSolver::XMLParse( const DOMNode* aNode ) {
             // only add valid solver components
             if( tempSolverComponent ) {
                 mSolverComponents.push_back( tempSolverComponent );
+                // The factor is ignored unless it loosens the tolerance.
+                mHandoffToleranceFactors.push_back( max( XMLHelper<double>::getAttr( curr, "handoff-tolerance" ), 1.0 ) );
             }
         }
         else {
@@ -208,19 +210,33 @@ bool UserConfigurableSolver::solve( const int aPeriod, const SolutionInfoParamPa
         (*it)->init();
     }
     
+    // The handoff tolerance factors in effect for this period.
+    vector<double> handoffFactors = mHandoffToleranceFactors;
+
     // Loop is done at least once.
     do {
         solverLog.setLevel( ILogger::NOTICE );
         solverLog << "Solution() loop. N: " << mCalcCounter->getPeriodCount() << endl;
         solverLog.setLevel( ILogger::DEBUG );
+        const double passStartRED = solution_set.getMaxRelativeExcessDemand();
         
         // try each solver component in the order they were read
-        for( SolverComponentIterator it = mSolverComponents.begin(); it != mSolverComponents.end(); ++it ) {
+        for( size_t i = 0; i < mSolverComponents.size(); ++i ) {
             // Note we are not checking the return code here since even if a solver component was able to
             // solve successfully it is not necessarily working on the entire solution set.
             solverLog << "\n%%%%%%%%%%%%%%%%Solution Set State:\n" << solution_set
                       << "\n%%%%%%%%%%%%%%%%\n";
-            (*it)->solve( solution_set, aPeriod );
+            SolutionInfo::setHandoffToleranceFactor( handoffFactors[ i ] );
+            mSolverComponents[ i ]->solve( solution_set, aPeriod );
+            SolutionInfo::setHandoffToleranceFactor( 1.0 );
+        }
+
+        // Tighten the handoff tolerances by the observed rate of convergence, and
+        // stop loosening them if the pass made poor progress.
+        const double passEndRED = solution_set.getMaxRelativeExcessDemand();
+        const double convergenceRate = passStartRED > 0 ? passEndRED / passStartRED : 0.0;
+        for( size_t i = 0; i < handoffFactors.size(); ++i ) {
+            handoffFactors[ i ] = convergenceRate > 0.5 ? 1.0 : max( handoffFactors[ i ] * convergenceRate, 1.0 );
         }
         
         // Determine if the model has solved. 
@@ -0,0 +1,198 @@
+#ifndef BLOCK_SCHUR_LU_HPP_
+#define BLOCK_SCHUR_LU_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file block_schur_lu.hpp
+ * \ingroup Solution
+ * \brief Block L-U factorization of the solver Jacobians using a Schur complement.
+ */
+
+#include <vector>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+
+#include "solution/util/include/sparse_lu.hpp"
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+#define UBMATRIX boost::numeric::ublas::matrix<double>
+
+/*!
+ * \ingroup Solution
+ * \brief A factorization which exploits clusters of almost independent markets.
+ * \details The markets are partitioned into a small set of "coupling" markets,
+ *          such as global energy trade, and blocks of the remaining markets
+ *          which have no direct interaction with one another once the coupling
+ *          markets are removed.  With the markets ordered by block and the
+ *          coupling markets last the matrix has the bordered block diagonal form
+ *
+ *          [ A_1         E_1 ]
+ *          [     ...     ... ]
+ *          [         A_k E_k ]
+ *          [ F_1 ... F_k  C  ]
+ *
+ *          Each diagonal block A_i is factored on its own, in parallel when
+ *          GCAM_PARALLEL_ENABLED, using SparseLU and the blocks are coupled
+ *          through the dense Schur complement S = C - sum F_i A_i^-1 E_i.
+ *
+ *          The partition is determined from the nonzero structure of the first
+ *          matrix factored and then kept so that Broyden updates, which are
+ *          applied using Sherman-Morrison as in SparseLU, do not need to
+ *          preserve the structure.  A matrix factored later which links two of
+ *          the blocks, such as a Broyden updated matrix being refactored, causes
+ *          the partition to be determined again so that the factorization stays
+ *          exact.
+ */
+class BlockSchurLU {
+public:
+    BlockSchurLU( const double aMaxCouplingFraction = 0.25 );
+
+    void setCouplingHint( const std::vector<bool>& aIsCoupling );
+
+    template<class MatrixType>
+    int factorize( const MatrixType& aMatrix );
+
+    void solve( UBVECTOR& aB ) const;
+
+    bool update( const UBVECTOR& aU, const UBVECTOR& aV );
+
+    void resetPartition();
+
+    //! The number of diagonal blocks in the partition.
+    size_t getNumBlocks() const { return mBlocks.size(); }
+
+    //! The number of coupling markets in the partition.
+    size_t getNumCoupling() const { return mCoupling.size(); }
+
+    //! The number of nonzeros in the diagonal blocks.
+    size_t getNumNonZero() const;
+
+    //! The number of nonzeros in the factors of the diagonal blocks and the Schur complement.
+    size_t getNumFactorNonZero() const;
+
+private:
+    //! The largest fraction of the markets which may be chosen as coupling
+    //! markets when no hint has been given.
+    const double mMaxCouplingFraction;
+
+    //! The dimension of the (square) matrix.
+    int mN;
+
+    //! Markets the user has asked to be treated as coupling markets.
+    std::vector<bool> mCouplingHint;
+
+    //! The market indices in each diagonal block.
+    std::vector<std::vector<int> > mBlocks;
+
+    //! The market indices of the coupling markets.
+    std::vector<int> mCoupling;
+
+    //! The block each market is in, or -1 for the coupling markets.
+    std::vector<int> mBlockOf;
+
+    //! The factorization of each diagonal block.
+    std::vector<SparseLU> mBlockLU;
+
+    //! For each block the coupling of its rows to the coupling markets, E_i.
+    std::vector<UBMATRIX> mE;
+
+    //! For each block the coupling of the coupling market rows to it, F_i.
+    std::vector<UBMATRIX> mF;
+
+    //! For each block A_i^-1 E_i.
+    std::vector<UBMATRIX> mW;
+
+    //! The L-U factorization of the Schur complement and its row permutation.
+    UBMATRIX mSchur;
+    boost::numeric::ublas::permutation_matrix<std::size_t> mSchurPerm;
+
+    //! Sherman-Morrison updates, see SparseLU.
+    std::vector<UBVECTOR> mUpdateZ;
+    std::vector<UBVECTOR> mUpdateV;
+    std::vector<double> mUpdateDenom;
+
+    void partition( const std::vector<std::vector<int> >& aAdjacency );
+
+    bool fitsPartition( const UBMATRIX& aMatrix ) const;
+
+    int factorizeDense( const UBMATRIX& aMatrix );
+
+    void blockSolve( UBVECTOR& aB ) const;
+};
+
+/*!
+ * \brief Factor the given dense matrix.
+ * \details If no partition has been determined yet, or the matrix has a
+ *          nonzero entry linking two different blocks of the existing one, a
+ *          partition is found from the nonzero structure of the matrix.
+ *          Otherwise the existing partition is reused.  Any previously
+ *          accumulated rank-one updates are discarded.
+ * \param aMatrix A square matrix supporting size1(), size2() and operator()(i,j).
+ * \return Zero if successful otherwise one plus the index of a market at which
+ *         the matrix was found to be singular.
+ */
+template<class MatrixType>
+int BlockSchurLU::factorize( const MatrixType& aMatrix ) {
+    const int n = aMatrix.size2();
+    UBMATRIX dense( n, n );
+    for( int j = 0; j < n; ++j ) {
+        for( int i = 0; i < n; ++i ) {
+            dense( i, j ) = aMatrix( i, j );
+        }
+    }
+    if( n != mN || ( mBlocks.empty() && mCoupling.empty() ) || !fitsPartition( dense ) ) {
+        mN = n;
+        std::vector<std::vector<int> > adjacency( n );
+        for( int j = 0; j < n; ++j ) {
+            for( int i = 0; i < n; ++i ) {
+                if( i != j && ( dense( i, j ) != 0.0 || dense( j, i ) != 0.0 ) ) {
+                    adjacency[ i ].push_back( j );
+                }
+            }
+        }
+        partition( adjacency );
+    }
+    return factorizeDense( dense );
+}
+
+#undef UBVECTOR
+#undef UBMATRIX
+
+#endif // BLOCK_SCHUR_LU_HPP_
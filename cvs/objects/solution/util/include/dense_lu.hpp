@@ -0,0 +1,138 @@
+#ifndef DENSE_LU_HPP_
+#define DENSE_LU_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file dense_lu.hpp
+ * \ingroup Solution
+ * \brief L-U factorization and back substitution of dense matrices using
+ *        LAPACK when it is available.
+ * \details When built with USE_LAPACK the factorization is done by LAPACK's
+ *          dgetrf and the substitution by dgetrs, which are blocked and, with
+ *          a threaded library such as MKL or OpenBLAS, multithreaded.
+ *          Otherwise ublas' lu_factorize and lu_substitute are used. The
+ *          permutations produced by the two differ, so a matrix factored with
+ *          denseLUFactorize must be solved with denseLUSubstitute. When also
+ *          built with GCAM_USE_CUSOLVER large matrices are factored on a GPU
+ *          instead, see GPUDenseLU.
+ */
+
+#include <cstddef>
+#include <vector>
+#include <boost/type_traits/is_same.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+
+#include "solution/util/include/gpu_dense_lu.h"
+
+#if GCAM_USE_CUSOLVER && !USE_LAPACK
+#error "GCAM_USE_CUSOLVER requires USE_LAPACK to solve the systems it factors"
+#endif
+
+#if USE_LAPACK
+extern "C" {
+    void dgetrf_( const int* m, const int* n, double* a, const int* lda, int* ipiv, int* info );
+    void dgetrs_( const char* trans, const int* n, const int* nrhs, const double* a, const int* lda,
+                  const int* ipiv, double* b, const int* ldb, int* info );
+}
+#endif
+
+/*!
+ * \ingroup Solution
+ * \brief Factor a square matrix in place using partial pivoting.
+ * \details A row major matrix is passed to LAPACK as its column major
+ *          transpose, which is factored instead and solved transposed.
+ * \param aMatrix The matrix to factor which holds the factors on return.
+ * \param aPerm The permutation, which is resized to the size of the matrix.
+ * \return Zero if the matrix was factored, otherwise the index plus one of the
+ *         first exactly zero pivot, as with ublas::lu_factorize.
+ */
+template<class Matrix, class Perm>
+std::size_t denseLUFactorize( Matrix& aMatrix, Perm& aPerm ) {
+    const std::size_t n = aMatrix.size1();
+#if USE_LAPACK
+    const int size = static_cast<int>( n );
+    std::vector<int> pivots( n );
+    int info = 0;
+    if( n > 0 && !GPUDenseLU::factorize( &aMatrix.data()[ 0 ], size, &pivots[ 0 ], info ) ) {
+        dgetrf_( &size, &size, &aMatrix.data()[ 0 ], &size, &pivots[ 0 ], &info );
+    }
+    aPerm.resize( n, false );
+    for( std::size_t i = 0; i < n; ++i ) {
+        aPerm( i ) = pivots[ i ] - 1;
+    }
+    // A negative info is an illegal argument, which can not happen here.
+    return info > 0 ? static_cast<std::size_t>( info ) : 0;
+#else
+    Perm identity( n );
+    aPerm.resize( n, false );
+    aPerm.assign( identity );
+    return boost::numeric::ublas::lu_factorize( aMatrix, aPerm );
+#endif
+}
+
+/*!
+ * \ingroup Solution
+ * \brief Solve a system using a matrix factored by denseLUFactorize.
+ * \param aLU The factored matrix.
+ * \param aPerm The permutation from the factorization.
+ * \param aB On entry the right hand side, on exit the solution.
+ */
+template<class Matrix, class Perm>
+void denseLUSubstitute( const Matrix& aLU, const Perm& aPerm, boost::numeric::ublas::vector<double>& aB ) {
+#if USE_LAPACK
+    const int size = static_cast<int>( aLU.size1() );
+    if( size == 0 ) {
+        return;
+    }
+    std::vector<int> pivots( aPerm.size() );
+    for( std::size_t i = 0; i < pivots.size(); ++i ) {
+        pivots[ i ] = static_cast<int>( aPerm( i ) ) + 1;
+    }
+    const bool isRowMajor = boost::is_same<typename Matrix::orientation_category,
+                                           boost::numeric::ublas::row_major_tag>::value;
+    const char trans = isRowMajor ? 'T' : 'N';
+    const int nrhs = 1;
+    int info = 0;
+    dgetrs_( &trans, &size, &nrhs, &aLU.data()[ 0 ], &size, &pivots[ 0 ], &aB.data()[ 0 ], &size, &info );
+#else
+    boost::numeric::ublas::lu_substitute( aLU, aPerm, aB );
+#endif
+}
+
+#endif // DENSE_LU_HPP_
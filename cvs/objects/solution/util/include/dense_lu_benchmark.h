@@ -0,0 +1,76 @@
+#ifndef _DENSE_LU_BENCHMARK_H_
+#define _DENSE_LU_BENCHMARK_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file dense_lu_benchmark.h
+* \ingroup Solution
+* \brief The header file for the DenseLUBenchmark class.
+*/
+
+#include <vector>
+
+/*!
+* \ingroup Solution
+* \brief Compares the time to factor and solve dense systems on the host and,
+*        if one is available, on a GPU.
+* \details The benchmark is run before the period given by the
+*          dense-lu-benchmark-year configuration value is solved.  Random
+*          diagonally dominant systems are generated for each of the sizes
+*          listed in dense-lu-benchmark-sizes and for the number of markets
+*          being solved.  Each is factored and solved with LAPACK, or ublas
+*          without USE_LAPACK, and with GPUDenseLU regardless of
+*          gpu-lu-min-size.  The GPU times include copying the matrix to and
+*          from the device so that they are the times the solver would see.
+*          The average time of dense-lu-benchmark-repeats trials and largest
+*          difference between the two solutions are printed to the main log,
+*          from which a suitable gpu-lu-min-size may be chosen.
+*/
+class DenseLUBenchmark {
+public:
+    DenseLUBenchmark();
+
+    void run( const int aNumMarkets ) const;
+private:
+    //! The number of times each measurement is repeated.
+    int mRepeats;
+
+    void benchmarkSize( const int aSize ) const;
+};
+
+#endif // _DENSE_LU_BENCHMARK_H_
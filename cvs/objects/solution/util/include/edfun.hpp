@@ -95,6 +95,46 @@ class LogEDFun : public VecFVec<double,double>
   int period;
   bool mLogPricep;               //!< Flag indicating whether inputs are prices or log-prices
 
+  //! Every activity that depends on the price of at least one of the
+  //! markets being solved, in global calculation order.  Built on the
+  //! first call to batch().
+  std::vector<IActivity*> mAllDependencies;
+
+  //! Markets which are solved one at a time inside each full
+  //! evaluation rather than by the caller (see setPeripheralMarkets).
+  std::vector<SolutionInfo> mPeripheral;
+
+  //! Every activity that depends on the price of at least one of the
+  //! peripheral markets, in global calculation order.
+  std::vector<IActivity*> mPeripheralDependencies;
+
+  //! Maximum number of steps taken to solve the peripheral markets in
+  //! each full evaluation.
+  unsigned int mMaxPeripheralIter;
+
+  //! The ways in which a market's output may be calculated from its
+  //! supply and demand.
+  enum OutputKind {
+    LOG_RATIO,         //!< log(demand/supply), normal markets in log space
+    LINEAR_NORMAL,     //!< demand - supply, normal markets in linear space
+    LINEAR_CONSTRAINT, //!< demand - supply, constraint markets in linear space
+    DIFFERENCE         //!< demand - supply, with no lower bound correction
+  };
+
+  //! The output kind of each market, fixed by its type and mLogPricep.
+  std::vector<OutputKind> mOutputKind;
+
+  //! The lower bound supply price of each market.
+  std::vector<double> mLowerBoundPrice;
+
+  //! Flag indicating that every input scale factor is one, in which case
+  //! the solver's input vectors are used without being copied.
+  bool mUnitInputScale;
+
+  //! Flag indicating that finite difference step sizes are adapted to each
+  //! market's response rather than fixed.
+  bool mAdaptiveStep;
+
   // diagnostic variables
   std::vector<double> mstate;
 public:
@@ -104,7 +144,30 @@ public:
   virtual void operator()(const UBVECTOR<double> &x, UBVECTOR<double> &fx, const int partj=-1);
   virtual void partial(int ip);
   virtual double partialSize(int ip) const;
+  virtual double partialStep(int ip) const;
+  virtual void setPartialStep(int ip, double astep);
+  virtual void partialGroups(const std::vector<std::vector<int> > &arowpattern,
+                             std::vector<std::vector<int> > &agroups) const;
+  virtual void partialGroup(const UBVECTOR<double> &x, UBVECTOR<double> &fx, const std::vector<int> &apartjs);
+  virtual void batch(const std::vector<UBVECTOR<double> > &axs, std::vector<UBVECTOR<double> > &afxs);
+  //! The response of a single market to a change in its own price, see partialSweep.
+  struct SweepPoint {
+    double price;   //!< The (unscaled) price of the market
+    double supply;  //!< The supply of the market at price
+    double demand;  //!< The demand of the market at price
+    double fx;      //!< The (scaled) output of the market at price
+  };
+  void partialSweep(int ip, const UBVECTOR<double> &ax, const std::vector<double> &axj,
+                    std::vector<SweepPoint> &apoints);
+  virtual void checkpoint();
+  virtual bool rollback();
+  virtual void commit();
   void scaleInitInputs(UBVECTOR<double> &ax);
+  void setPeripheralMarkets(const std::vector<SolutionInfo> &aperipheral, const unsigned int amaxiter);
+  //! The scale factors applied to the inputs.
+  const UBVECTOR<double> &getInputScale() const {return mxscl;}
+  //! The scale factors applied to the outputs.
+  const UBVECTOR<double> &getOutputScale() const {return mfxscl;}
 
   // Constants to protect against overflow: 
   static const double PMAX;            //!< Greatest allowable price
@@ -116,6 +179,18 @@ protected:
   // scale factors for input and output
   UBVECTOR<double> mxscl;
   UBVECTOR<double> mfxscl;
+
+  void calcOutputs(const UBVECTOR<double> &x, UBVECTOR<double> &fx);
+  void solvePeripheral();
+
+  const UBVECTOR<double> &scaleInputs(const UBVECTOR<double> &ax, UBVECTOR<double> &x) const;
+  void setPrices(const UBVECTOR<double> &x);
+
+private:
+  template<bool LogPrice>
+  void setPricesImpl(const UBVECTOR<double> &x);
+  template<bool LogPrice>
+  void calcOutputsImpl(const UBVECTOR<double> &x, UBVECTOR<double> &fx);
     
 };  
 
@@ -50,6 +50,7 @@
 #include <boost/numeric/ublas/matrix.hpp>
 #include "functor.hpp"
 #include <iostream>
+#include <vector>
 #include "solution/util/include/ublas-helpers.hpp"
 
 #define UBLAS boost::numeric::ublas
@@ -60,47 +61,201 @@
 #endif
 
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/manage_state_variables.hpp"
+#include "util/logger/include/ilogger.h"
+#include "solution/util/include/jacobian_profiler.h"
+#include "util/base/include/gcam_mpi.h"
 
 extern Scenario* scenario;
 
+//! Relative change in F, below which a finite difference is considered noise
+const double JACOBIAN_NOISE = 1.0e-10;
+//! Relative change in F, above which a finite difference step is considered too large
+const double JACOBIAN_NONLINEAR = 1.0e-1;
+//! Bounds on the adaptive relative step size
+const double JACOBIAN_MIN_STEP = 1.0e-8;
+const double JACOBIAN_MAX_STEP = 1.0e-3;
+//! partialSize below which a noisy column is cheap enough to retry immediately
+const double JACOBIAN_RETRY_SIZE = 0.1;
+
+/*!
+ * Adjust the step size for column j given the largest change dfmax
+ * seen in the function value over a range of magnitude fscale.  A
+ * change that is lost in roundoff means the step was too small to
+ * see the market's response, so it is increased; a very large change
+ * suggests the step is straying out of the linear regime, so it is
+ * decreased.  The new step is saved with F for the next Jacobian,
+ * which a function using a fixed step ignores.
+ * \return Whether the column was below the noise level.
+ */
+template<class FTYPE>
+inline bool adaptPartialStep(VecFVec<FTYPE,FTYPE> &F, int j, FTYPE dfmax, FTYPE fscale)
+{
+  FTYPE heps = F.partialStep(j);
+  bool noisy = dfmax <= JACOBIAN_NOISE * (1.0 + fscale);
+  if(noisy && heps < JACOBIAN_MAX_STEP) {
+    F.setPartialStep(j, std::min<FTYPE>(10.0*heps, JACOBIAN_MAX_STEP));
+  }
+  else if(dfmax > JACOBIAN_NONLINEAR * (1.0 + fscale) && heps > JACOBIAN_MIN_STEP) {
+    F.setPartialStep(j, std::max<FTYPE>(0.1*heps, JACOBIAN_MIN_STEP));
+  }
+  return noisy;
+}
+
 /*!
  * Compute a single column in a Jacobian matrix.  We have broken this
  * out from the fdjac subroutine so that we can easily test a single
  * column for nonsingularity without duplicating any code.
+ * \details The perturbation uses the step size F has recorded for
+ *          column j, which F may adapt after each evaluation (see
+ *          adaptPartialStep).  If the column comes back below the noise
+ *          level and the partial evaluation is cheap it is immediately
+ *          retried with the larger step.
+ * \return Whether the final column was below the noise level.
  */
 template<class FTYPE,class MTRAIT>
-inline void jacol(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+inline bool jacol(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
                   const UBLAS::vector<FTYPE> &fx, int j, 
                   UBLAS::matrix<FTYPE,MTRAIT> &J,
                   bool usepartial=true, std::ostream *diagnostic=NULL) {
-  const FTYPE heps = 1.0e-6;
   const FTYPE TINY = 1.0e-6;
   UBLAS::vector<FTYPE> xx(x); // temporary, so we can respect the const on x
   UBLAS::vector<FTYPE> fxx(fx.size());        // hold the values of F(xx)
   FTYPE t = xx[j];            // store the old value
-  FTYPE h = heps * (fabs(t)+TINY);
+  FTYPE fscale = 0.0;
+  for(size_t i=0; i<fx.size(); ++i) {
+    fscale = std::max<FTYPE>(fscale, fabs(fx[i]));
+  }
+  const bool canRetry = F.partialSize(j) < JACOBIAN_RETRY_SIZE;
+
+  bool noisy;
+  bool retry;
+  FTYPE h;
+  int tries = 0;
+  do {
+    const FTYPE heps = F.partialStep(j);
+    h = heps * (fabs(t)+TINY);
   
-  xx[j] = t+h;
-  h     = xx[j]-t; // reduce roundoff error, since (t+h)-t is not
-                   // necessarily identical to the original h
-  if(diagnostic) {
-      (*diagnostic) << "j= " << j << "\th= " << h << "\nxx:\n" << xx << "\n";
-  } 
-  if(usepartial) {F.partial(j);}    // hint to the function that this is a partial derivative calculation
-    F(xx,fxx, usepartial ? j : -1);       // eval the function
-  xx[j] = t;       // restore the old value
+    xx[j] = t+h;
+    h     = xx[j]-t; // reduce roundoff error, since (t+h)-t is not
+                     // necessarily identical to the original h
+    if(diagnostic) {
+        (*diagnostic) << "j= " << j << "\th= " << h << "\nxx:\n" << xx << "\n";
+    } 
+    if(usepartial) {F.partial(j);}    // hint to the function that this is a partial derivative calculation
+      F(xx,fxx, usepartial ? j : -1);       // eval the function
+    xx[j] = t;       // restore the old value
   
-  if(diagnostic) {
-    (*diagnostic) << "fxx:\n" << fxx << "\n";
-  }
+    if(diagnostic) {
+      (*diagnostic) << "fxx:\n" << fxx << "\n";
+    }
+
+    FTYPE dfmax = 0.0;
+    for(size_t i=0; i<fxx.size(); ++i) {
+      dfmax = std::max<FTYPE>(dfmax, fabs(fxx[i] - fx[i]));
+    }
+    noisy = adaptPartialStep(F, j, dfmax, fscale);
+    // only worth retrying if the step could actually be increased
+    retry = noisy && canRetry && F.partialStep(j) != heps && ++tries < 2;
+  } while(retry);
   
   // compute the finite difference derivatives
   FTYPE hinv = 1.0/h;
   for(size_t i=0; i<fxx.size(); ++i) {
     J(i,j) = (fxx[i] - fx[i]) * hinv;
   } 
+  return noisy;
+}
+
+/*!
+ * Write the columns that were found to be below the noise level
+ * while computing a Jacobian to the solver log.
+ * \param[in] noisy: flag for each column
+ */
+inline void reportNoisyColumns(const std::vector<char> &noisy)
+{
+  std::vector<int> cols;
+  for(size_t j=0; j<noisy.size(); ++j) {
+    if(noisy[j]) {
+      cols.push_back(j);
+    }
+  }
+  if(!cols.empty()) {
+    ILogger& solverLog = ILogger::getLogger("solver_log");
+    solverLog.setLevel(ILogger::DEBUG);
+    solverLog << "Jacobian columns below noise level:";
+    for(size_t k=0; k<cols.size(); ++k) {
+      solverLog << " " << cols[k];
+    }
+    solverLog << std::endl;
+  }
+}
+
+/*!
+ * Share the Jacobian columns computed on each rank (see
+ * GcamMPI::shouldDistributeJacobian) with every other rank.  Along
+ * with the column values the adapted step size and noise flag of each
+ * column are exchanged so that every rank continues from identical
+ * state.
+ * \param[in] owner: the rank which computed each column
+ * \param[in] rows: for each column the rows to exchange, or NULL to
+ *            exchange the entire column.  Rows which are not exchanged
+ *            are set to zero.
+ */
+template<class FTYPE, class MTRAIT>
+void shareJacobianColumns(VecFVec<FTYPE,FTYPE> &F, UBLAS::matrix<FTYPE,MTRAIT> &J,
+                          std::vector<char> &noisy, const std::vector<int> &owner,
+                          const std::vector<const std::vector<int>*> &rows)
+{
+  const int rank = GcamMPI::getRank();
+  std::vector<double> local;
+  for(size_t j=0; j<owner.size(); ++j) {
+    if(owner[j] != rank) {
+      continue;
+    }
+    local.push_back(F.partialStep(j));
+    local.push_back(noisy[j]);
+    if(rows[j]) {
+      for(size_t r=0; r<rows[j]->size(); ++r) {
+        local.push_back(J((*rows[j])[r],j));
+      }
+    }
+    else {
+      for(size_t i=0; i<J.size1(); ++i) {
+        local.push_back(J(i,j));
+      }
+    }
+  }
+
+  std::vector<std::vector<double> > all;
+  GcamMPI::allGather(local, all);
+
+  // columns were packed in order on each rank so unpack them the same way
+  std::vector<size_t> pos(all.size(), 0);
+  for(size_t j=0; j<owner.size(); ++j) {
+    if(owner[j] == rank) {
+      continue;
+    }
+    const std::vector<double> &vals = all[owner[j]];
+    size_t &p = pos[owner[j]];
+    F.setPartialStep(j, vals[p++]);
+    noisy[j] = vals[p++] != 0.0;
+    if(rows[j]) {
+      for(size_t i=0; i<J.size1(); ++i) {
+        J(i,j) = 0.0;
+      }
+      for(size_t r=0; r<rows[j]->size(); ++r) {
+        J((*rows[j])[r],j) = vals[p++];
+      }
+    }
+    else {
+      for(size_t i=0; i<J.size1(); ++i) {
+        J(i,j) = vals[p++];
+      }
+    }
+  }
 }
 
 
@@ -135,7 +290,8 @@ void fdjac(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
  * \param[out] J: The Jacobian of F
  * \param[in] usepartial: (optional) use partial model evaluation for partial derivatives
  * \param[in] diagnostic: (optional) ostream pointer to which to send additional diagnostics
- *
+ * \remark When the Jacobian is distributed over MPI ranks each rank
+ *         computes every size'th column and then the columns are shared.
  */
 template<class FTYPE, class MTRAIT>
 void fdjac(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
@@ -147,13 +303,26 @@ void fdjac(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
         << "\nInitial fx:\n" << fx << "\n";
   }
 
+  GCAM_PROFILE_SCOPE( "jacobian" );
   Timer& jacTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::JACOBIAN );
   jacTimer.start();
     if(usepartial) { scenario->getManageStateVariables()->setPartialDeriv(true); }
+  JacobianProfiler::getInstance().startJacobian();
   
+  std::vector<char> noisy(x.size(), 0);
+  const bool distribute = GcamMPI::shouldDistributeJacobian();
+  const int rank = GcamMPI::getRank();
+  std::vector<int> owner(x.size(), rank);
+  if(distribute) {
+    for(size_t j=0; j<x.size(); ++j) {
+      owner[j] = j % GcamMPI::getSize();
+    }
+  }
 #if !GCAM_PARALLEL_ENABLED
   for(size_t j=0; j<x.size(); ++j) {
-    jacol(F, x, fx, j, J, usepartial, diagnostic);
+    if(owner[j] == rank) {
+      noisy[j] = jacol(F, x, fx, j, J, usepartial, diagnostic);
+    }
   }
 #else
     tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
@@ -161,18 +330,213 @@ void fdjac(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
     threadPool.execute([&](){
         tg.run([&](){
             tbb::parallel_for_each( x, [&]( const FTYPE& j ) {
-                jacol(F, x, fx, (&j - &x[0]), J, usepartial, 0/*diagnostic*/);
+                int col = (&j - &x[0]);
+                if(owner[col] == rank) {
+                    noisy[col] = jacol(F, x, fx, col, J, usepartial, 0/*diagnostic*/);
+                }
             });
         });
     });
     threadPool.execute([&tg](){ tg.wait(); });
 #endif
     if(usepartial) { F.partial(-1); }
+  if(distribute) {
+    shareJacobianColumns(F, J, noisy, owner, std::vector<const std::vector<int>*>(x.size(), 0));
+  }
+  reportNoisyColumns(noisy);
 
   jacTimer.stop();
 }
 
 
+/*!
+ * \brief The column grouping used to compute a finite difference
+ *        Jacobian with fewer function evaluations.
+ * \details The row pattern records, for each column, the rows which were
+ *          found to be nonzero the last time the full Jacobian was
+ *          computed.  Columns in the same group have no rows in common and
+ *          may therefore be perturbed simultaneously, with each column
+ *          recovered from the rows in its own pattern.
+ */
+struct JacobianColoring {
+  //! The rows known to be nonzero for each column.
+  std::vector<std::vector<int> > mRowPattern;
+  //! The groups of columns to perturb together.
+  std::vector<std::vector<int> > mGroups;
+
+  //! Whether a coloring has been computed.
+  bool empty() const {return mGroups.empty();}
+  //! The number of function evaluations needed to compute a Jacobian.
+  size_t nevals() const {return mGroups.size();}
+};
+
+/*!
+ * Find a column grouping for F using the sparsity pattern of a
+ * Jacobian J that has already been computed by finite differences.
+ * Because partial derivative calculations restore all of the model
+ * state not affected by the perturbed market, entries which are
+ * not structurally connected come back as exactly zero.
+ */
+template <class FTYPE, class MTRAIT>
+void findJacobianColoring(const VecFVec<FTYPE,FTYPE> &F, const UBLAS::matrix<FTYPE,MTRAIT> &J,
+                          JacobianColoring &aColoring)
+{
+  aColoring.mRowPattern.clear();
+  aColoring.mRowPattern.resize(J.size2());
+  for(size_t j=0; j<J.size2(); ++j) {
+    for(size_t i=0; i<J.size1(); ++i) {
+      // always include the diagonal since a market's own price feeds
+      // directly into its lower bound supply correction
+      if(J(i,j) != 0.0 || i == j) {
+        aColoring.mRowPattern[j].push_back(i);
+      }
+    }
+  }
+  F.partialGroups(aColoring.mRowPattern, aColoring.mGroups);
+}
+
+/*!
+ * Compute the columns in a Jacobian matrix corresponding to a group
+ * of structurally independent inputs from a single evaluation of F.
+ * Each column uses, and adapts, the step size F has recorded for it;
+ * columns found to be below the noise level are flagged in noisy.
+ */
+template<class FTYPE,class MTRAIT>
+inline void jacolGroup(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                       const UBLAS::vector<FTYPE> &fx, const std::vector<int> &group,
+                       const std::vector<std::vector<int> > &rowpattern,
+                       UBLAS::matrix<FTYPE,MTRAIT> &J, std::vector<char> &noisy)
+{
+  if(group.size() == 1) {
+    noisy[group[0]] = jacol(F, x, fx, group[0], J);
+    return;
+  }
+  const FTYPE TINY = 1.0e-6;
+  UBLAS::vector<FTYPE> xx(x);
+  UBLAS::vector<FTYPE> fxx(fx.size());
+  std::vector<FTYPE> h(group.size());
+  FTYPE fscale = 0.0;
+  for(size_t i=0; i<fx.size(); ++i) {
+    fscale = std::max<FTYPE>(fscale, fabs(fx[i]));
+  }
+  for(size_t k=0; k<group.size(); ++k) {
+    int j = group[k];
+    FTYPE t = xx[j];
+    xx[j] = t + F.partialStep(j) * (fabs(t)+TINY);
+    h[k]  = xx[j]-t;
+  }
+
+  F.partial(group[0]);
+  F.partialGroup(xx, fxx, group);
+
+  for(size_t k=0; k<group.size(); ++k) {
+    int j = group[k];
+    FTYPE hinv = 1.0/h[k];
+    for(size_t i=0; i<fxx.size(); ++i) {
+      J(i,j) = 0.0;
+    }
+    const std::vector<int> &rows = rowpattern[j];
+    FTYPE dfmax = 0.0;
+    for(size_t r=0; r<rows.size(); ++r) {
+      J(rows[r],j) = (fxx[rows[r]] - fx[rows[r]]) * hinv;
+      dfmax = std::max<FTYPE>(dfmax, fabs(fxx[rows[r]] - fx[rows[r]]));
+    }
+    noisy[j] = adaptPartialStep(F, j, dfmax, fscale);
+  }
+}
+
+/*!
+ * Calculate a finite difference Jacobian using a column grouping
+ * obtained from findJacobianColoring.  If no coloring is given the
+ * full Jacobian is computed as usual.
+ */
+template<class FTYPE, class MTRAIT>
+void fdjacColored(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                  const UBLAS::vector<FTYPE> &fx, UBLAS::matrix<FTYPE,MTRAIT> &J,
+                  const JacobianColoring *aColoring)
+{
+  if(!aColoring || aColoring->empty()) {
+    fdjac(F, x, fx, J, true);
+    return;
+  }
+
+  GCAM_PROFILE_SCOPE( "colored jacobian" );
+  Timer& jacTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::JACOBIAN );
+  jacTimer.start();
+  scenario->getManageStateVariables()->setPartialDeriv(true);
+  JacobianProfiler::getInstance().startJacobian();
+
+  std::vector<char> noisy(x.size(), 0);
+  // groups, rather than columns, are divided among the ranks
+  const bool distribute = GcamMPI::shouldDistributeJacobian();
+  const int rank = GcamMPI::getRank();
+  std::vector<int> groupOwner(aColoring->mGroups.size(), rank);
+  if(distribute) {
+    for(size_t g=0; g<aColoring->mGroups.size(); ++g) {
+      groupOwner[g] = g % GcamMPI::getSize();
+    }
+  }
+#if !GCAM_PARALLEL_ENABLED
+  for(size_t g=0; g<aColoring->mGroups.size(); ++g) {
+    if(groupOwner[g] == rank) {
+      jacolGroup(F, x, fx, aColoring->mGroups[g], aColoring->mRowPattern, J, noisy);
+    }
+  }
+#else
+    tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute([&](){
+        tg.run([&](){
+            tbb::parallel_for_each( aColoring->mGroups, [&]( const std::vector<int>& group ) {
+                if(groupOwner[&group - &aColoring->mGroups[0]] == rank) {
+                    jacolGroup(F, x, fx, group, aColoring->mRowPattern, J, noisy);
+                }
+            });
+        });
+    });
+    threadPool.execute([&tg](){ tg.wait(); });
+#endif
+  F.partial(-1);
+  if(distribute) {
+    // single column groups are computed in full (see jacolGroup)
+    std::vector<int> owner(x.size(), rank);
+    std::vector<const std::vector<int>*> rows(x.size(), 0);
+    for(size_t g=0; g<aColoring->mGroups.size(); ++g) {
+      const std::vector<int> &group = aColoring->mGroups[g];
+      for(size_t k=0; k<group.size(); ++k) {
+        owner[group[k]] = groupOwner[g];
+        if(group.size() > 1) {
+          rows[group[k]] = &aColoring->mRowPattern[group[k]];
+        }
+      }
+    }
+    shareJacobianColumns(F, J, noisy, owner, rows);
+  }
+  reportNoisyColumns(noisy);
+
+  jacTimer.stop();
+}
+
+/*!
+ * Calculate the full finite difference Jacobian and, if a coloring is
+ * given, rebuild it from the new sparsity pattern.  The coloring is
+ * found from the exact zeros of a single Jacobian so entries may have
+ * become nonzero since, in which case the colored Jacobian silently
+ * misses them.  Solvers call this when a step fails after a colored
+ * Jacobian reset.
+ */
+template<class FTYPE, class MTRAIT>
+void fdjacRecolor(VecFVec<FTYPE,FTYPE> &F, const UBLAS::vector<FTYPE> &x,
+                  const UBLAS::vector<FTYPE> &fx, UBLAS::matrix<FTYPE,MTRAIT> &J,
+                  JacobianColoring *aColoring)
+{
+  fdjac(F, x, fx, J, true);
+  if(aColoring && !aColoring->empty()) {
+    findJacobianColoring(F, J, *aColoring);
+  }
+}
+
+
 #undef UBLAS
 
 #endif
@@ -66,6 +66,19 @@ public:
     F(x,lstF);
     return inner_prod(lstF,lstF);
   }
+  //! batch evaluations do not update the stored value of F
+  virtual void batch(const std::vector<UBLAS::vector<Ta> > &x, std::vector<Tr> &rvals) {
+    std::vector<UBLAS::vector<Tr> > Fx;
+    F.batch(x,Fx);
+    rvals.resize(x.size());
+    for(size_t k=0; k<x.size(); ++k) {
+      rvals[k] = inner_prod(Fx[k],Fx[k]);
+    }
+  }
+  //! the state is that of the underlying vector function
+  virtual void checkpoint() {F.checkpoint();}
+  virtual bool rollback() {return F.rollback();}
+  virtual void commit() {F.commit();}
   virtual void prn_diagnostic(std::ostream *out) {
     int ifmax=0;
     double fmax=fabs(lstF[0]);
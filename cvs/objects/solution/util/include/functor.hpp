@@ -45,6 +45,7 @@
  */
 
 #include <iostream>
+#include <vector>
 #include <boost/numeric/ublas/vector.hpp> 
 
 #define UBVECTOR boost::numeric::ublas::vector
@@ -110,6 +111,101 @@ public:
    * derivative.
    */
   virtual double partialSize(int ip) const {return 1.0;}
+  /*!
+   * Returns the relative step size to use when computing a finite
+   * difference partial derivative with respect to input element ip.
+   *
+   * Functions that can remember good step sizes from one Jacobian to
+   * the next should override this along with setPartialStep.  The
+   * default is a fixed step.
+   */
+  virtual double partialStep(int ip) const {return 1.0e-6;}
+  /*!
+   * Record the step size that should be used for the next finite
+   * difference partial derivative with respect to ip.  The default
+   * implementation discards it.
+   */
+  virtual void setPartialStep(int ip, double astep) {}
+  /*!
+   * Partition the input elements into groups that may be perturbed together
+   * when computing a finite difference Jacobian.
+   *
+   * Two elements may share a group if no element of the return vector
+   * depends on both of them.  Given such a partition the Jacobian
+   * columns for an entire group can be recovered from a single
+   * function evaluation.  The default implementation has no knowledge
+   * of the structure of the function and so puts every element in a
+   * group of its own.
+   *
+   * \param[in] arowpattern: For each input element, the return vector
+   *            elements known to depend on it.
+   * \param[out] agroups: The groups of input elements.
+   */
+  virtual void partialGroups(const std::vector<std::vector<int> > &arowpattern,
+                             std::vector<std::vector<int> > &agroups) const {
+    agroups.clear();
+    for(int j=0; j<na; ++j) {
+      agroups.push_back(std::vector<int>(1, j));
+    }
+  }
+  /*!
+   * Evaluate the function when all of the input elements in a group
+   * (see partialGroups) have been perturbed at once.
+   *
+   * The caller is responsible for calling partial() before this
+   * method just as it would for a single partial derivative.  The
+   * default implementation falls back to a full evaluation which is
+   * always correct, if not efficient.
+   *
+   * \param[in] arg: argument vector
+   * \param[out] rval: return value vector
+   * \param[in] apartjs: The input elements that have changed.
+   */
+  virtual void partialGroup(const UBVECTOR<Ta> &arg, UBVECTOR<Tr> &rval, const std::vector<int> &apartjs) {
+    (*this)(arg, rval, apartjs.size() == 1 ? apartjs[0] : -1);
+  }
+  /*!
+   * Evaluate the function at several points.
+   *
+   * Subclasses may override this to evaluate the points
+   * concurrently.  The default implementation simply evaluates them
+   * one after another.  Note that an implementation is not required
+   * to leave the function in the state it would have after a normal
+   * call at any of the points, so callers that rely on such state
+   * should make a regular call at the point they finally choose.
+   *
+   * \param[in] args: the argument vectors
+   * \param[out] rvals: the return vectors, one per argument vector
+   */
+  virtual void batch(const std::vector<UBVECTOR<Ta> > &args, std::vector<UBVECTOR<Tr> > &rvals) {
+    rvals.resize(args.size());
+    for(size_t k=0; k<args.size(); ++k) {
+      rvals[k].resize(nr);
+      (*this)(args[k], rvals[k]);
+    }
+  }
+  /*!
+   * Mark the current state of the function, that is the state left by
+   * the last full evaluation, as one that may be returned to with
+   * rollback().
+   *
+   * Functions that keep internal state from their last evaluation
+   * (see the remark on operator()) may use this to restore that state
+   * cheaply once a trial point has been rejected.  The default
+   * implementation does nothing.
+   */
+  virtual void checkpoint() {}
+  /*!
+   * Return to the state marked by the last call to checkpoint() and
+   * discard the checkpoint.
+   * \return Whether the state was restored.  If not (the default) the
+   *         function is left in the state of its last evaluation.
+   */
+  virtual bool rollback() {return false;}
+  /*!
+   * Discard the checkpoint, keeping the state of the last evaluation.
+   */
+  virtual void commit() {}
   /*!
    * Turns on implementation-defined diagnostics (default is no-op)
    */
@@ -154,6 +250,22 @@ public:
    * Returns the length of the argument vector required by the function
    */
   int narg() const {return na;}
+  /*!
+   * Evaluate the function at several points (see VecFVec::batch).
+   * The default implementation evaluates them one after another.
+   */
+  virtual void batch(const std::vector<UBVECTOR<Ta> > &args, std::vector<Tr> &rvals) {
+    rvals.resize(args.size());
+    for(size_t k=0; k<args.size(); ++k) {
+      rvals[k] = (*this)(args[k]);
+    }
+  }
+  //! Mark the current state, see VecFVec::checkpoint
+  virtual void checkpoint() {}
+  //! Return to the marked state, see VecFVec::rollback
+  virtual bool rollback() {return false;}
+  //! Discard the marked state, see VecFVec::commit
+  virtual void commit() {}
   //! diagnostic output does nothing by default
   virtual void prn_diagnostic(std::ostream *out) {}
 };
@@ -0,0 +1,71 @@
+#ifndef _GPU_DENSE_LU_H_
+#define _GPU_DENSE_LU_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file gpu_dense_lu.h
+* \ingroup Solution
+* \brief The header file for the GPUDenseLU class.
+*/
+
+/*!
+* \ingroup Solution
+* \brief Factors large dense matrices on a GPU using cuSOLVER.
+* \details When built with GCAM_USE_CUSOLVER, denseLUFactorize passes matrices
+*          at least as large as the gpu-lu-min-size configuration value to
+*          factorize, which copies them to the first CUDA device, factors
+*          them with cusolverDnDgetrf and copies the factors and pivots back.
+*          The factors and pivots are in the layout produced by LAPACK's
+*          dgetrf so that the system is still solved on the host with dgetrs,
+*          and GCAM_USE_CUSOLVER therefore requires USE_LAPACK.  The cuSOLVER
+*          handle and device buffers are created on first use and reused.  If
+*          no device is found, or any CUDA call fails, factorize returns false
+*          and the caller factors the matrix on the host.  Without
+*          GCAM_USE_CUSOLVER factorize always returns false.
+*/
+class GPUDenseLU {
+public:
+    static bool isAvailable();
+
+    static bool factorize( double* aColumnMajor, const int aSize, int* aPivots, int& aInfo,
+                           const bool aForce = false );
+private:
+    static int getMinSize();
+};
+
+#endif // _GPU_DENSE_LU_H_
@@ -0,0 +1,139 @@
+#ifndef _JACOBIAN_PROFILER_H_
+#define _JACOBIAN_PROFILER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file jacobian_profiler.h
+* \ingroup Solution
+* \brief The header file for the JacobianProfiler class.
+*/
+
+#include <string>
+#include <map>
+#include <set>
+#include <fstream>
+#include <boost/core/noncopyable.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include "tbb/spin_mutex.h"
+#endif
+
+/*!
+* \ingroup Solution
+* \brief Records the cost of each column of the finite difference Jacobians.
+* \details When the "jacobian-profile-file" configuration file is set to
+*          write-output, every partial derivative evaluation records the market
+*          it was taken for, the wall time it took, the number of activities it
+*          had to calculate (the size of the market's dependency ordering from
+*          the MarketDependencyFinder) and the thread which ran it.  Each record
+*          is written as a CSV row to that file, by default next to the solver
+*          log, as soon as it is made and only per market and per node totals
+*          are kept in memory.  At the end of the run a summary of the most
+*          expensive markets is written to the main log.  This makes it easy to spot markets whose
+*          partial derivative graphs are much larger than expected.  Evaluations
+*          of a group of structurally independent columns are recorded once,
+*          under the first column in the group.  When threads are pinned to NUMA
+*          nodes (see ManageStateVariables) the Jacobian throughput of each node
+*          is also summarized.
+*/
+class JacobianProfiler : private boost::noncopyable {
+public:
+    static JacobianProfiler& getInstance();
+
+    bool isEnabled() const;
+    void startJacobian();
+    boost::posix_time::ptime startColumn() const;
+    void stopColumn( const boost::posix_time::ptime& aStartTime, const int aPeriod,
+                     const int aColumn, const std::string& aMarketName,
+                     const size_t aNumActivities );
+    void printReport();
+private:
+    JacobianProfiler();
+
+    //! The totals of the partial derivatives of a single market.
+    struct MarketTotal {
+        MarketTotal():mWallTime( 0 ), mEvaluations( 0 ), mActivities( 0 ) {}
+        //! The total wall time in seconds.
+        double mWallTime;
+        //! The number of evaluations.
+        int mEvaluations;
+        //! The total number of activities calculated.
+        double mActivities;
+    };
+
+    //! The totals of the partial derivatives run on the threads of a NUMA node.
+    struct NodeTotal {
+        NodeTotal():mEvaluations( 0 ), mWallTime( 0 ) {}
+        //! The threads which ran evaluations.
+        std::set<int> mThreads;
+        //! The number of evaluations.
+        int mEvaluations;
+        //! The total wall time in seconds.
+        double mWallTime;
+    };
+
+    //! Whether profiling was requested.
+    bool mEnabled;
+
+    //! The number of Jacobians started so far.
+    int mNumJacobians;
+
+    //! The number of columns recorded so far.
+    size_t mNumColumns;
+
+    //! The profile file which each column is written to.
+    std::ofstream mOut;
+
+    //! The totals by market name.
+    std::map<std::string, MarketTotal> mMarketTotals;
+
+    //! The totals by NUMA node for threads which were pinned.
+    std::map<int, NodeTotal> mNodeTotals;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Protects the file and totals since columns are calculated concurrently.
+    tbb::spin_mutex mRecordLock;
+#endif
+
+    void printSummary( std::ostream& aOut ) const;
+
+    void printNodeThroughput( std::ostream& aOut ) const;
+};
+
+#endif // _JACOBIAN_PROFILER_H_
@@ -48,6 +48,7 @@
 #include <boost/numeric/ublas/vector.hpp>
 #include <algorithm>
 #include <iostream>
+#include <vector>
 
 #define UBLAS boost::numeric::ublas
 
@@ -66,14 +67,25 @@
  * \param[inout]neval: number of function evaluations. The subroutine
  * adds whatever value is passed in, allowing the caller to keep a
  * running total.
+ * \param[in] nbatch: number of step lengths to try at once.  When
+ * greater than one and the full step is rejected, the interpolated
+ * step length and nbatch-1 successive halvings of it are evaluated
+ * together with f.batch() and the longest acceptable one is taken.
+ * This uses more evaluations in total, but when f can evaluate a
+ * batch concurrently it shortens the time spent backtracking.  The
+ * full step is always tried on its own since it is usually accepted.
  * \return : 0= success, anything else= fail
+ * \remark On failure f is rolled back (see SclFVec::rollback) to the
+ *         state it was in for x0, if f supports it, so that the caller
+ *         may continue from x0 without evaluating it again.
  *
  */
 template <class FTYPE> 
 int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
                FTYPE f0, const UBLAS::vector<FTYPE> &g0,
                const UBLAS::vector<FTYPE> &dx, UBLAS::vector<FTYPE> &x,
-               FTYPE &fx, int &neval, std::ostream *solverlog = 0)
+               FTYPE &fx, int &neval, std::ostream *solverlog = 0,
+               const int nbatch = 1)
 {
   const FTYPE lseps = 1.0e-7;   // part of the definition of "sufficient" decrease
   const FTYPE TOLX = 1.0e-6;    // tolerance for x values
@@ -108,8 +120,43 @@ int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
 
   if(solverlog)
     (*solverlog) << "Beginning linesearch: lmin = " << lmin << "  f0 = " << f0 << "\n";
-  
+
+  // f is in the state for x0, which we will return to if no step is
+  // accepted.
+  f.checkpoint();
+
+  bool fullstep = true;
   while(lambda > lmin) {
+    if(nbatch > 1 && !fullstep) {
+      // The full step has been rejected.  Try the next nbatch step
+      // lengths starting from the interpolated one at once.
+      std::vector<UBLAS::vector<FTYPE> > xtrial;
+      std::vector<FTYPE> ltrial, ftrial;
+      for(FTYPE l=lambda; l>lmin && int(ltrial.size())<nbatch; l*=0.5) {
+        ltrial.push_back(l);
+        xtrial.push_back(x0 + l*dx);
+      }
+      f.batch(xtrial, ftrial);
+      neval += ltrial.size();
+
+      for(size_t k=0; k<ltrial.size(); ++k) {
+        if(solverlog)
+          (*solverlog) << "\tlambda = " << ltrial[k] << "  fx = " << ftrial[k] << " (batch)" << std::endl;
+        if(ftrial[k] <= f0 + lseps*ltrial[k]*g0dx) {
+          // SUCCESS.  Evaluate the accepted point normally so that f
+          // (and anything it wraps) is left in the state for x.
+          x  = xtrial[k];
+          fx = f(x);
+          neval++;
+          f.commit();
+          return 0;
+        }
+      }
+      lambda = 0.5*ltrial.back();
+      continue;
+    }
+    fullstep = false;
+
     x  = x0 + lambda*dx;
     fx = f(x);
     neval++;
@@ -126,9 +173,11 @@ int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
     // it specifies a minimum rate of decrease.  lseps is set fairly
     // small, so we're biased toward accepting steps unless their rate
     // of decrease is painfully slow
-    if(fx <= f0 + lseps*lambda*g0dx)
+    if(fx <= f0 + lseps*lambda*g0dx) {
       // SUCCESS
+      f.commit();
       return 0;
+    }
 
     // last step increased or decreased too slowly --- backtrack
     FTYPE tl0 = 0.1*lambda; // never decrease lambda by more than a factor of 10
@@ -151,6 +200,9 @@ int linesearch(SclFVec<FTYPE,FTYPE> &f, const UBLAS::vector<FTYPE> &x0,
   // If we get here, then the line search failed.  Depending on the
   // multidimensional solver we're using, we may just need to refresh
   // the Jacobian.  Otherwise, try starting with a new initial guess.
+  // Either way the caller carries on from x0.
+  if(f.rollback() && solverlog)
+    (*solverlog) << "Restored the state at the start of the linesearch.\n";
   return 1;              
 }
 
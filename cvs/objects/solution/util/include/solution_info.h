@@ -131,6 +131,10 @@ public:
     double getUpperBoundSupplyPrice() const;
     double getForecastPrice() const;
     double getForecastDemand() const;
+    double getJacobianStep() const;
+    void setJacobianStep( const double aJacobianStep );
+    double getLearnedElasticity() const;
+    void setLearnedElasticity( const double aElasticity );
 
     int getSerialNumber( void ) const;
     
@@ -139,6 +143,9 @@ public:
     GcamFlowGraph* getFlowGraph() const;
 #endif
     void printDerivatives( std::ostream& aOut ) const;
+
+    static void setToleranceScale( const double aScale );
+    static void setHandoffToleranceFactor( const double aFactor );
     /*!
     * \brief Binary function used to order SolutionInfo* pointers by decreasing relative excess demand. 
     * \author Josh Lurz
@@ -165,8 +172,9 @@ private:
     std::vector<double> demandElasticities; //!< demand elasticities
     std::vector<double> supplyElasticities; //!< supply elasticities
     //! This activities which need to recalculate if this solution info adjust
-    //! prices
-    std::vector<IActivity*> mDependencies;
+    //! prices, which are owned by the MarketDependencyFinder and shared by
+    //! every copy of this object.
+    const std::vector<IActivity*>* mDependencies;
 
 #if GCAM_PARALLEL_ENABLED
     //! A pointer weak pointer to a flow graph which can be used recalculate if this
@@ -176,6 +184,14 @@ private:
     
     //! Market specific solution tolerance
     double mSolutionTolerance;
+
+    //! A factor applied to the solution tolerance of every SolutionInfo
+    //! initialized after it is set.
+    static double sToleranceScale;
+
+    //! A factor applied to the solution tolerance of every SolutionInfo when
+    //! checking whether it is within tolerance, see setHandoffToleranceFactor.
+    static double sHandoffToleranceFactor;
     
     //! Market specific solution floor
     double mSolutionFloor;
@@ -95,8 +95,8 @@ public:
     double getMaxRelativeExcessDemand() const;
     double getMaxAbsoluteExcessDemand() const;
     bool isAllBracketed() const;
-    const std::vector<double> getDemands() const; // move derivatives and make me private!
-    const std::vector<double> getSupplies() const;
+    std::vector<double> getDemands() const; // move derivatives and make me private!
+    std::vector<double> getSupplies() const;
     unsigned int getNumSolvable() const;
     unsigned int getNumTotal() const;
     const SolutionInfo& getSolvable( unsigned int index ) const;
@@ -104,8 +104,8 @@ public:
     SolutionInfo& getSolvable( unsigned int index );
     const SolutionInfo& getAny( unsigned int index ) const;
     SolutionInfo& getAny( unsigned int index );
-    std::vector<SolutionInfo> getSolvableSet() const;
-    std::vector<SolutionInfo> getUnsolvableSet() const;
+    const std::vector<SolutionInfo>& getSolvableSet() const;
+    const std::vector<SolutionInfo>& getUnsolvableSet() const;
     std::vector<SolutionInfo> getSolvedSet() const;
     std::vector<SolutionInfo> getUnsolvedSet() const;
     bool isAllSolved();
@@ -95,7 +95,8 @@ public:
 
    static bool bracket( Marketplace* aMarketplace, World* aWorld, const double aDefaultBracketInterval,
                         const unsigned int aMaxIterations, SolutionInfoSet& aSolSet, CalcCounter* aCalcCounter,
-                        const ISolutionInfoFilter* aSolutionInfoFilter, const int aPeriod );
+                        const ISolutionInfoFilter* aSolutionInfoFilter, const int aPeriod,
+                        const bool aIndependentProbes = false );
 
 private:
     //! A function object to compare to values and see if they are approximately equal. 
@@ -109,6 +110,10 @@ private:
         }
     };
 
+    static void bracketIndependent( Marketplace* aMarketplace, World* aWorld, const double aDefaultBracketInterval,
+                                    const unsigned int aMaxIterations, SolutionInfoSet& aSolutionSet,
+                                    const int aPeriod );
+
     static std::vector<double> storePrices( const SolutionInfoSet& aSolutionSet );
     static void restorePrices( SolutionInfoSet& aSolutionSet, const std::vector<double>& aPrices );
 };
@@ -0,0 +1,111 @@
+#ifndef _SOLVER_PROFILE_H_
+#define _SOLVER_PROFILE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file solver_profile.h
+* \ingroup Solution
+* \brief The header file for the SolverProfile class.
+*/
+
+#include <string>
+#include <vector>
+#include <map>
+#include <boost/core/noncopyable.hpp>
+
+/*!
+* \ingroup Solution
+* \brief Chooses the solver configuration of each period from the cost of
+*        solving it in previous runs.
+* \details When the "solver-profile" configuration file is set to write-output
+*          one of the solver configurations in the semicolon separated
+*          "profile-solver-configs" files, or the regular solver, is chosen to
+*          solve each period. The number of world calcs each configuration
+*          took to solve a year, and whether it solved, is appended to the
+*          profile file so that it persists between runs. A configuration
+*          which has not yet been tried for the year is chosen first so that
+*          every alternative is eventually recorded, after which the
+*          configuration with the fewest world calcs on average among those
+*          that solved is chosen. Runs of scenarios that differ greatly should
+*          use separate profiles.
+*
+*          The profile is a CSV file with the columns year, solver-config,
+*          world-calcs and solved where the regular solver is recorded with an
+*          empty solver-config.
+*/
+class SolverProfile : private boost::noncopyable {
+public:
+    static SolverProfile& getInstance();
+
+    bool isEnabled() const;
+    const std::vector<std::string>& getAlternatives() const;
+    size_t chooseAlternative( const int aYear ) const;
+    void record( const int aYear, const size_t aAlternative, const int aWorldCalcs,
+                 const bool aSolved );
+private:
+    SolverProfile();
+
+    //! The recorded runs of one configuration in one year.
+    struct Runs {
+        //! The number of runs.
+        int mNumRuns;
+
+        //! The number of runs which solved.
+        int mNumSolved;
+
+        //! The total world calcs of the runs which solved.
+        double mSolvedCalcs;
+
+        Runs();
+    };
+
+    //! Whether solver configurations are being chosen.
+    bool mEnabled;
+
+    //! The name of the profile file.
+    std::string mFileName;
+
+    //! The solver configuration files to choose from, the first of which is
+    //! empty for the regular solver.
+    std::vector<std::string> mAlternatives;
+
+    //! The recorded runs by year and solver configuration file.
+    std::map<std::pair<int, std::string>, Runs> mRuns;
+};
+
+#endif // _SOLVER_PROFILE_H_
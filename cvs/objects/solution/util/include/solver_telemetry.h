@@ -0,0 +1,108 @@
+#ifndef _SOLVER_TELEMETRY_H_
+#define _SOLVER_TELEMETRY_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file solver_telemetry.h
+* \ingroup Solution
+* \brief The header file for the SolverTelemetry class.
+*/
+
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <limits>
+#include <boost/core/noncopyable.hpp>
+
+class SolutionInfoSet;
+class CalcCounter;
+
+/*!
+* \ingroup Solution
+* \brief Writes a structured record of the progress of the solver components
+*        so that convergence may be monitored without parsing the solver log.
+* \details When the "solver-telemetry" configuration file is set to
+*          write-output each iteration of a SolverComponent is written to it as
+*          a line of JSON holding the period, year, component name, iteration,
+*          maximum relative excess demand, number of unsolved markets, number
+*          of world calcs in the period, seconds since the period started and
+*          the size of the step taken.  A solver component calls
+*          startComponent with the solution set it is working on when it
+*          starts and recordIteration at the end of each iteration; the
+*          remaining values are taken from the solution set so that they are
+*          the same for all components.  Values which are not finite, such as
+*          the step of a component which has none, are written as null.
+*/
+class SolverTelemetry : private boost::noncopyable {
+public:
+    static SolverTelemetry& getInstance();
+
+    bool isEnabled() const;
+    void startPeriod( const int aPeriod, const int aYear );
+    void startComponent( const std::string& aName, const SolutionInfoSet& aSolutionSet,
+                         const CalcCounter* aCalcCounter );
+    void recordIteration( const int aIteration,
+                          const double aStepSize = std::numeric_limits<double>::quiet_NaN() );
+private:
+    SolverTelemetry();
+
+    //! Whether iterations are being written.
+    bool mEnabled;
+
+    //! The file the iterations are written to.
+    std::ofstream mFile;
+
+    //! The period being solved.
+    int mPeriod;
+
+    //! The year of the period being solved.
+    int mYear;
+
+    //! The time the period started.
+    std::chrono::steady_clock::time_point mPeriodStart;
+
+    //! The name of the active solver component.
+    std::string mComponentName;
+
+    //! The solution set of the active solver component.
+    const SolutionInfoSet* mSolutionSet;
+
+    //! The world calc counter of the active solver component.
+    const CalcCounter* mCalcCounter;
+};
+
+#endif // _SOLVER_TELEMETRY_H_
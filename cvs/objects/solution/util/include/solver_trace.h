@@ -0,0 +1,113 @@
+#ifndef _SOLVER_TRACE_H_
+#define _SOLVER_TRACE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file solver_trace.h
+* \ingroup Solution
+* \brief The header file for the SolverTrace class.
+*/
+
+#include <string>
+#include <vector>
+#include <boost/core/noncopyable.hpp>
+#include <boost/numeric/ublas/vector.hpp>
+
+/*!
+* \ingroup Solution
+* \brief Keeps a binary record of the most recent solver iterations so that
+*        they may be examined when a period fails to solve.
+* \details Each iteration of the solver records the ids of the markets it is
+*          solving along with their prices, excess demands and price step.  Only
+*          the last "solver-trace-iterations" iterations of the period are kept
+*          in a ring buffer whose storage is reused so recording does not
+*          allocate once the buffer has filled.  To keep the buffer small the
+*          excess demands and steps are stored in single precision while the
+*          prices are kept at full precision.  The trace is only written, to
+*          the "solver-trace-location" directory, when the period fails to
+*          solve which gives much of the information in the solver data log
+*          without the cost of formatting it as text on runs which succeed.
+*
+*          The file holds the identifier GCAMSTRC, a version, the period and
+*          the number of iterations followed by each iteration, oldest first,
+*          as its number, the number of markets then the market ids, prices,
+*          excess demands and steps.
+*/
+class SolverTrace : private boost::noncopyable {
+public:
+    static SolverTrace& getInstance();
+
+    bool isEnabled() const;
+    void startPeriod( const int aPeriod );
+    void record( const int aIteration, const std::vector<int>& aMarketIDs,
+                 const boost::numeric::ublas::vector<double>& aPrevX,
+                 const boost::numeric::ublas::vector<double>& aX,
+                 const boost::numeric::ublas::vector<double>& aFX );
+    bool write( const std::string& aScenarioName, const int aYear ) const;
+private:
+    SolverTrace();
+
+    //! A single recorded solver iteration.
+    struct Iteration {
+        //! The solver's iteration count.
+        int mIteration;
+        //! The ids of the markets being solved.
+        std::vector<int> mMarketIDs;
+        //! The prices (or log prices) at the end of the iteration.
+        std::vector<double> mX;
+        //! The excess demands at the end of the iteration.
+        std::vector<float> mFX;
+        //! The change in prices made by the iteration.
+        std::vector<float> mDX;
+    };
+
+    //! Whether the trace is being recorded.
+    bool mEnabled;
+
+    //! The period being recorded.
+    int mPeriod;
+
+    //! The ring buffer of iterations.
+    std::vector<Iteration> mIterations;
+
+    //! The total number of iterations recorded in the period, the next one is
+    //! stored at mNumRecorded modulo the size of mIterations.
+    size_t mNumRecorded;
+};
+
+#endif // _SOLVER_TRACE_H_
@@ -0,0 +1,168 @@
+#ifndef SPARSE_LU_HPP_
+#define SPARSE_LU_HPP_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file sparse_lu.hpp
+ * \ingroup Solution
+ * \brief Sparse L-U factorization for the solver Jacobians.
+ */
+
+#include <vector>
+#include <boost/numeric/ublas/vector.hpp>
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+
+/*!
+ * \ingroup Solution
+ * \brief A sparse L-U factorization with support for low rank updates.
+ * \details The matrix is stored in compressed sparse column (CSC) format and
+ *          factored using a left-looking (Gilbert-Peierls) algorithm with
+ *          threshold partial pivoting, which is the same basic approach used
+ *          by KLU.  The work to factor the matrix is proportional to the
+ *          number of floating point operations actually required rather than
+ *          N^3 as with a dense factorization, which is a very large savings
+ *          for the GCAM Jacobians since most markets only affect a few others.
+ *
+ *          Broyden's method repeatedly applies rank-one updates to the
+ *          Jacobian which would quickly destroy the sparsity of the matrix.
+ *          Instead of refactoring, the updates are accumulated and applied
+ *          during solve using the Sherman-Morrison formula so that only the
+ *          original sparse factorization is ever needed.
+ */
+class SparseLU {
+public:
+    SparseLU( const double aPivotTol = 0.1 );
+
+    template<class MatrixType>
+    int factorize( const MatrixType& aMatrix );
+
+    void solve( UBVECTOR& aB ) const;
+
+    bool update( const UBVECTOR& aU, const UBVECTOR& aV );
+
+    //! The number of nonzeros in the matrix that was factored.
+    size_t getNumNonZero() const { return mAx.size(); }
+
+    //! The number of nonzeros in the L-U factors including fill-in.
+    size_t getNumFactorNonZero() const { return mLx.size() + mUx.size(); }
+
+    //! The number of rank-one updates applied since the last factorization.
+    size_t getNumUpdates() const { return mUpdateDenom.size(); }
+
+private:
+    //! The threshold relative to the largest candidate pivot at which we will
+    //! still prefer the diagonal element to preserve sparsity.
+    const double mPivotTol;
+
+    //! The dimension of the (square) matrix.
+    int mN;
+
+    //! Column pointers, row indices, and values of the matrix A in CSC format.
+    std::vector<int> mAp;
+    std::vector<int> mAi;
+    std::vector<double> mAx;
+
+    //! Column pointers, row indices, and values of the unit lower triangular
+    //! factor L.  The unit diagonal is stored explicitly as the first entry
+    //! of each column.
+    std::vector<int> mLp;
+    std::vector<int> mLi;
+    std::vector<double> mLx;
+
+    //! Column pointers, row indices, and values of the upper triangular factor
+    //! U.  The diagonal is stored as the last entry of each column.
+    std::vector<int> mUp;
+    std::vector<int> mUi;
+    std::vector<double> mUx;
+
+    //! The inverse row permutation such that mPinv[ i ] is the pivot row of
+    //! row i of A.
+    std::vector<int> mPinv;
+
+    //! For each rank-one update u v^T the vector z = B^-1 u where B is the
+    //! matrix prior to the update.
+    std::vector<UBVECTOR> mUpdateZ;
+
+    //! For each rank-one update u v^T the vector v.
+    std::vector<UBVECTOR> mUpdateV;
+
+    //! For each rank-one update the value 1 + v^T z.
+    std::vector<double> mUpdateDenom;
+
+    int factorize();
+
+    void luSolve( UBVECTOR& aB ) const;
+
+    int reach( const int aCol, std::vector<int>& aStack, std::vector<int>& aPStack,
+               std::vector<int>& aDFSStack, std::vector<char>& aMarked ) const;
+};
+
+/*!
+ * \brief Factor the given dense matrix.
+ * \details The matrix is first converted to CSC format keeping only the
+ *          entries which are exactly nonzero.  Any previously accumulated
+ *          rank-one updates are discarded.
+ * \param aMatrix A square matrix supporting size1(), size2() and operator()(i,j).
+ * \return Zero if successful otherwise one plus the index of the column at
+ *         which the matrix was found to be singular (the same convention
+ *         used by ublas::lu_factorize).
+ */
+template<class MatrixType>
+int SparseLU::factorize( const MatrixType& aMatrix ) {
+    mN = aMatrix.size2();
+    mAp.assign( mN + 1, 0 );
+    mAi.clear();
+    mAx.clear();
+    for( int j = 0; j < mN; ++j ) {
+        for( int i = 0; i < static_cast<int>( aMatrix.size1() ); ++i ) {
+            const double val = aMatrix( i, j );
+            if( val != 0.0 ) {
+                mAi.push_back( i );
+                mAx.push_back( val );
+            }
+        }
+        mAp[ j + 1 ] = mAx.size();
+    }
+    return factorize();
+}
+
+#undef UBVECTOR
+
+#endif // SPARSE_LU_HPP_
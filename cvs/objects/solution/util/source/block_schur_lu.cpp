@@ -0,0 +1,434 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file block_schur_lu.cpp
+ * \ingroup Solution
+ * \brief BlockSchurLU class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cmath>
+#include <algorithm>
+#include <boost/numeric/ublas/vector.hpp>
+#include <boost/numeric/ublas/matrix.hpp>
+#include <boost/numeric/ublas/lu.hpp>
+#include <boost/numeric/ublas/operation.hpp>
+
+#include "solution/util/include/block_schur_lu.hpp"
+#include "solution/util/include/dense_lu.hpp"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
+#include "containers/include/scenario.h"
+#include "util/base/include/manage_state_variables.hpp"
+
+extern Scenario* scenario;
+#endif
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+#define UBMATRIX boost::numeric::ublas::matrix<double>
+
+using namespace std;
+
+/*!
+ * \brief Constructor.
+ * \param aMaxCouplingFraction The largest fraction of the markets which will be
+ *                             chosen as coupling markets when partitioning
+ *                             without a hint.
+ */
+BlockSchurLU::BlockSchurLU( const double aMaxCouplingFraction ):
+mMaxCouplingFraction( aMaxCouplingFraction ),
+mN( 0 ),
+mSchurPerm( 0 )
+{
+}
+
+/*!
+ * \brief Set which markets must be treated as coupling markets.
+ * \details When a hint is given the blocks are simply the connected components
+ *          of the remaining markets and no further coupling markets are chosen.
+ *          The partition will be recomputed on the next factorization.
+ * \param aIsCoupling Flag for each market indicating if it is a coupling market.
+ */
+void BlockSchurLU::setCouplingHint( const vector<bool>& aIsCoupling ) {
+    mCouplingHint = aIsCoupling;
+    resetPartition();
+}
+
+/*!
+ * \brief Discard the current partition so that a new one will be determined
+ *        from the next matrix to be factored.
+ */
+void BlockSchurLU::resetPartition() {
+    mBlocks.clear();
+    mCoupling.clear();
+    mBlockOf.clear();
+}
+
+size_t BlockSchurLU::getNumNonZero() const {
+    size_t nnz = 0;
+    for( size_t b = 0; b < mBlockLU.size(); ++b ) {
+        nnz += mBlockLU[ b ].getNumNonZero();
+    }
+    return nnz;
+}
+
+size_t BlockSchurLU::getNumFactorNonZero() const {
+    size_t nnz = mCoupling.size() * mCoupling.size();
+    for( size_t b = 0; b < mBlockLU.size(); ++b ) {
+        nnz += mBlockLU[ b ].getNumFactorNonZero();
+    }
+    return nnz;
+}
+
+/*!
+ * \brief Partition the markets into blocks and coupling markets.
+ * \details The blocks are the connected components of the structure graph once
+ *          the coupling markets are removed.  Without a hint, coupling markets
+ *          are chosen greedily as the most connected market in the largest
+ *          block until no block is larger than half of the markets or the
+ *          limit on the number of coupling markets is reached.  Since removing
+ *          a market can only split the block it was in, only that block is
+ *          relabeled after each choice and the number of non-coupling
+ *          neighbors of each market is kept up to date as markets are chosen.
+ * \param aAdjacency For each market the markets it is structurally connected to.
+ */
+void BlockSchurLU::partition( const vector<vector<int> >& aAdjacency ) {
+    const bool hasHint = mCouplingHint.size() == static_cast<size_t>( mN );
+    vector<bool> isCoupling = hasHint ? mCouplingHint : vector<bool>( mN, false );
+    const size_t maxCoupling = hasHint ? 0 : static_cast<size_t>( mMaxCouplingFraction * mN );
+    size_t numCoupling = count( isCoupling.begin(), isCoupling.end(), true );
+
+    // label the connected components of the non-coupling markets reached from
+    // the given markets, the first of which may reuse an emptied label
+    vector<int> component( mN, -1 );
+    vector<vector<int> > components;
+    vector<int> stack;
+    auto labelComponents = [&]( const vector<int>& aStarts, int aReuseLabel ) {
+        for( size_t s = 0; s < aStarts.size(); ++s ) {
+            const int start = aStarts[ s ];
+            if( isCoupling[ start ] || component[ start ] >= 0 ) {
+                continue;
+            }
+            int label = aReuseLabel;
+            if( label >= 0 ) {
+                aReuseLabel = -1;
+            }
+            else {
+                label = components.size();
+                components.push_back( vector<int>() );
+            }
+            stack.push_back( start );
+            component[ start ] = label;
+            while( !stack.empty() ) {
+                const int i = stack.back();
+                stack.pop_back();
+                components[ label ].push_back( i );
+                for( size_t k = 0; k < aAdjacency[ i ].size(); ++k ) {
+                    const int j = aAdjacency[ i ][ k ];
+                    if( !isCoupling[ j ] && component[ j ] < 0 ) {
+                        component[ j ] = label;
+                        stack.push_back( j );
+                    }
+                }
+            }
+        }
+    };
+    vector<int> allMarkets( mN );
+    for( int i = 0; i < mN; ++i ) {
+        allMarkets[ i ] = i;
+    }
+    labelComponents( allMarkets, -1 );
+
+    // the number of non-coupling markets each market is connected to
+    vector<size_t> degree( mN, 0 );
+    for( int i = 0; i < mN; ++i ) {
+        for( size_t k = 0; k < aAdjacency[ i ].size(); ++k ) {
+            degree[ i ] += !isCoupling[ aAdjacency[ i ][ k ] ];
+        }
+    }
+
+    while( !components.empty() && numCoupling < maxCoupling ) {
+        size_t largest = 0;
+        for( size_t c = 1; c < components.size(); ++c ) {
+            if( components[ c ].size() > components[ largest ].size() ) {
+                largest = c;
+            }
+        }
+        if( components[ largest ].size() * 2 <= static_cast<size_t>( mN ) ) {
+            break;
+        }
+
+        // move the most connected market in the largest block to the coupling
+        // set, preferring the lowest index among equally connected markets
+        const vector<int> members = components[ largest ];
+        int best = -1;
+        for( size_t k = 0; k < members.size(); ++k ) {
+            const int i = members[ k ];
+            if( best < 0 || degree[ i ] > degree[ best ] || ( degree[ i ] == degree[ best ] && i < best ) ) {
+                best = i;
+            }
+        }
+        if( degree[ best ] == 0 ) {
+            break;
+        }
+        isCoupling[ best ] = true;
+        ++numCoupling;
+        for( size_t k = 0; k < aAdjacency[ best ].size(); ++k ) {
+            --degree[ aAdjacency[ best ][ k ] ];
+        }
+
+        // relabel what remains of the block
+        for( size_t k = 0; k < members.size(); ++k ) {
+            component[ members[ k ] ] = -1;
+        }
+        components[ largest ].clear();
+        labelComponents( members, largest );
+        if( components[ largest ].empty() ) {
+            // no market of the block remains
+            components.erase( components.begin() + largest );
+            for( int i = 0; i < mN; ++i ) {
+                if( component[ i ] > static_cast<int>( largest ) ) {
+                    --component[ i ];
+                }
+            }
+        }
+    }
+
+    // number the blocks in order of their lowest market
+    mCoupling.clear();
+    mBlocks.clear();
+    mBlockOf.assign( mN, -1 );
+    vector<int> blockNumber( components.size(), -1 );
+    for( int i = 0; i < mN; ++i ) {
+        if( isCoupling[ i ] ) {
+            mCoupling.push_back( i );
+        }
+        else {
+            int& block = blockNumber[ component[ i ] ];
+            if( block < 0 ) {
+                block = mBlocks.size();
+                mBlocks.push_back( vector<int>() );
+            }
+            mBlocks[ block ].push_back( i );
+            mBlockOf[ i ] = block;
+        }
+    }
+}
+
+/*!
+ * \brief Check if the matrix has any entries which link two different blocks
+ *        of the current partition and so would be lost by factorizeDense.
+ * \param aMatrix The full matrix.
+ * \return True if the partition can represent the matrix exactly.
+ */
+bool BlockSchurLU::fitsPartition( const UBMATRIX& aMatrix ) const {
+    for( int j = 0; j < mN; ++j ) {
+        if( mBlockOf[ j ] < 0 ) {
+            continue;
+        }
+        for( int i = 0; i < mN; ++i ) {
+            if( mBlockOf[ i ] >= 0 && mBlockOf[ i ] != mBlockOf[ j ] && aMatrix( i, j ) != 0.0 ) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Factor the diagonal blocks and the Schur complement.
+ * \param aMatrix The full matrix.
+ * \return Zero if successful otherwise one plus the index of a market at which
+ *         the matrix was found to be singular.
+ */
+int BlockSchurLU::factorizeDense( const UBMATRIX& aMatrix ) {
+    using boost::numeric::ublas::prod;
+    const size_t nb = mBlocks.size();
+    const size_t m = mCoupling.size();
+    mBlockLU.clear();
+    mBlockLU.resize( nb );
+    mE.resize( nb );
+    mF.resize( nb );
+    mW.resize( nb );
+    mUpdateZ.clear();
+    mUpdateV.clear();
+    mUpdateDenom.clear();
+    vector<int> singular( nb, 0 );
+
+    auto factorBlock = [&]( const size_t b ) {
+        const vector<int>& block = mBlocks[ b ];
+        const size_t nblk = block.size();
+        UBMATRIX A( nblk, nblk );
+        mE[ b ].resize( nblk, m, false );
+        mF[ b ].resize( m, nblk, false );
+        for( size_t j = 0; j < nblk; ++j ) {
+            for( size_t i = 0; i < nblk; ++i ) {
+                A( i, j ) = aMatrix( block[ i ], block[ j ] );
+            }
+            for( size_t c = 0; c < m; ++c ) {
+                mE[ b ]( j, c ) = aMatrix( block[ j ], mCoupling[ c ] );
+                mF[ b ]( c, j ) = aMatrix( mCoupling[ c ], block[ j ] );
+            }
+        }
+        int sing = mBlockLU[ b ].factorize( A );
+        if( sing > 0 ) {
+            singular[ b ] = block[ sing - 1 ] + 1;
+            return;
+        }
+        // W = A^-1 E, one column at a time
+        mW[ b ].resize( nblk, m, false );
+        UBVECTOR col( nblk );
+        for( size_t c = 0; c < m; ++c ) {
+            for( size_t i = 0; i < nblk; ++i ) {
+                col[ i ] = mE[ b ]( i, c );
+            }
+            mBlockLU[ b ].solve( col );
+            for( size_t i = 0; i < nblk; ++i ) {
+                mW[ b ]( i, c ) = col[ i ];
+            }
+        }
+    };
+
+#if !GCAM_PARALLEL_ENABLED
+    for( size_t b = 0; b < nb; ++b ) {
+        factorBlock( b );
+    }
+#else
+    tbb::task_arena& threadPool = scenario->getManageStateVariables()->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute( [&] () {
+        tg.run( [&] () {
+            tbb::parallel_for( size_t( 0 ), nb, factorBlock );
+        } );
+    } );
+    threadPool.execute( [&tg] () { tg.wait(); } );
+#endif
+
+    for( size_t b = 0; b < nb; ++b ) {
+        if( singular[ b ] > 0 ) {
+            return singular[ b ];
+        }
+    }
+
+    if( m > 0 ) {
+        // S = C - sum F_i A_i^-1 E_i
+        mSchur.resize( m, m, false );
+        for( size_t i = 0; i < m; ++i ) {
+            for( size_t j = 0; j < m; ++j ) {
+                mSchur( i, j ) = aMatrix( mCoupling[ i ], mCoupling[ j ] );
+            }
+        }
+        for( size_t b = 0; b < nb; ++b ) {
+            mSchur -= prod( mF[ b ], mW[ b ] );
+        }
+        size_t sing = denseLUFactorize( mSchur, mSchurPerm );
+        if( sing > 0 ) {
+            return mCoupling[ sing - 1 ] + 1;
+        }
+    }
+    return 0;
+}
+
+/*!
+ * \brief Solve using the block factorization without the rank-one updates.
+ * \param aB On entry the right hand side, on exit the solution.
+ */
+void BlockSchurLU::blockSolve( UBVECTOR& aB ) const {
+    using boost::numeric::ublas::prod;
+    const size_t m = mCoupling.size();
+    vector<UBVECTOR> y( mBlocks.size() );
+    UBVECTOR g( m );
+    for( size_t c = 0; c < m; ++c ) {
+        g[ c ] = aB[ mCoupling[ c ] ];
+    }
+    for( size_t b = 0; b < mBlocks.size(); ++b ) {
+        y[ b ].resize( mBlocks[ b ].size() );
+        for( size_t i = 0; i < mBlocks[ b ].size(); ++i ) {
+            y[ b ][ i ] = aB[ mBlocks[ b ][ i ] ];
+        }
+        mBlockLU[ b ].solve( y[ b ] );
+        if( m > 0 ) {
+            g -= prod( mF[ b ], y[ b ] );
+        }
+    }
+    if( m > 0 ) {
+        denseLUSubstitute( mSchur, mSchurPerm, g );
+        for( size_t c = 0; c < m; ++c ) {
+            aB[ mCoupling[ c ] ] = g[ c ];
+        }
+    }
+    for( size_t b = 0; b < mBlocks.size(); ++b ) {
+        if( m > 0 ) {
+            y[ b ] -= prod( mW[ b ], g );
+        }
+        for( size_t i = 0; i < mBlocks[ b ].size(); ++i ) {
+            aB[ mBlocks[ b ][ i ] ] = y[ b ][ i ];
+        }
+    }
+}
+
+/*!
+ * \brief Solve the system with the matrix most recently factored plus any
+ *        rank-one updates applied since (see SparseLU::solve).
+ * \param aB On entry the right hand side, on exit the solution.
+ */
+void BlockSchurLU::solve( UBVECTOR& aB ) const {
+    blockSolve( aB );
+    for( size_t k = 0; k < mUpdateDenom.size(); ++k ) {
+        aB -= ( boost::numeric::ublas::inner_prod( mUpdateV[ k ], aB ) / mUpdateDenom[ k ] ) * mUpdateZ[ k ];
+    }
+}
+
+/*!
+ * \brief Apply the rank-one update B = B + u v^T to the factored matrix.
+ * \param aU The column vector of the update.
+ * \param aV The row vector of the update.
+ * \return False if the updated matrix would be singular in which case the
+ *         update is not applied, true otherwise.
+ */
+bool BlockSchurLU::update( const UBVECTOR& aU, const UBVECTOR& aV ) {
+    UBVECTOR z( aU );
+    solve( z );
+    const double denom = 1.0 + boost::numeric::ublas::inner_prod( aV, z );
+    if( fabs( denom ) < 1.0e-12 ) {
+        return false;
+    }
+    mUpdateZ.push_back( z );
+    mUpdateV.push_back( aV );
+    mUpdateDenom.push_back( denom );
+    return true;
+}
@@ -0,0 +1,199 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file dense_lu_benchmark.cpp
+ * \ingroup Solution
+ * \brief DenseLUBenchmark class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <set>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "solution/util/include/dense_lu_benchmark.h"
+#include "solution/util/include/dense_lu.hpp"
+#include "solution/util/include/gpu_dense_lu.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    typedef chrono::steady_clock Clock;
+    typedef boost::numeric::ublas::matrix<double, boost::numeric::ublas::column_major> ColumnMatrix;
+    typedef boost::numeric::ublas::vector<double> Vector;
+
+    /*!
+     * \brief Factor and solve a system on the host.
+     * \param aMatrix The matrix, which is overwritten.
+     * \param aB The right hand side, which holds the solution on return.
+     */
+    void hostSolve( ColumnMatrix& aMatrix, Vector& aB ) {
+        const int size = static_cast<int>( aMatrix.size1() );
+#if USE_LAPACK
+        vector<int> pivots( size );
+        int info = 0;
+        dgetrf_( &size, &size, &aMatrix.data()[ 0 ], &size, &pivots[ 0 ], &info );
+        const char trans = 'N';
+        const int nrhs = 1;
+        dgetrs_( &trans, &size, &nrhs, &aMatrix.data()[ 0 ], &size, &pivots[ 0 ], &aB.data()[ 0 ], &size, &info );
+#else
+        boost::numeric::ublas::permutation_matrix<size_t> perm( size );
+        boost::numeric::ublas::lu_factorize( aMatrix, perm );
+        boost::numeric::ublas::lu_substitute( aMatrix, perm, aB );
+#endif
+    }
+
+    /*!
+     * \brief Factor a system on the GPU and solve it on the host as the
+     *        solver does.
+     * \param aMatrix The matrix, which is overwritten.
+     * \param aB The right hand side, which holds the solution on return.
+     * \return Whether the GPU factored the matrix.
+     */
+    bool gpuSolve( ColumnMatrix& aMatrix, Vector& aB ) {
+        const int size = static_cast<int>( aMatrix.size1() );
+        vector<int> pivots( size );
+        int info = 0;
+        if( !GPUDenseLU::factorize( &aMatrix.data()[ 0 ], size, &pivots[ 0 ], info, true ) ) {
+            return false;
+        }
+#if USE_LAPACK
+        const char trans = 'N';
+        const int nrhs = 1;
+        dgetrs_( &trans, &size, &nrhs, &aMatrix.data()[ 0 ], &size, &pivots[ 0 ], &aB.data()[ 0 ], &size, &info );
+#endif
+        return true;
+    }
+}
+
+//! Constructor
+DenseLUBenchmark::DenseLUBenchmark():
+mRepeats( max( Configuration::getInstance()->getInt( "dense-lu-benchmark-repeats", 3, false ), 1 ) )
+{
+}
+
+/*!
+ * \brief Run the benchmark for each configured size.
+ * \param aNumMarkets The number of markets being solved, which is also
+ *        benchmarked.
+ */
+void DenseLUBenchmark::run( const int aNumMarkets ) const {
+    const string sizeList = Configuration::getInstance()->getString( "dense-lu-benchmark-sizes",
+                                                                     "500,1000,2000,4000", false );
+    vector<string> sizeNames;
+    boost::split( sizeNames, sizeList, boost::is_any_of( ", " ), boost::token_compress_on );
+    set<int> sizes;
+    if( aNumMarkets > 0 ) {
+        sizes.insert( aNumMarkets );
+    }
+    for( string name : sizeNames ) {
+        boost::trim( name );
+        if( !name.empty() ) {
+            sizes.insert( boost::lexical_cast<int>( name ) );
+        }
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running the dense L-U benchmark with " << mRepeats << " repeats, "
+            << ( GPUDenseLU::isAvailable() ? "with" : "without" ) << " a GPU." << endl;
+    for( int size : sizes ) {
+        if( size > 0 ) {
+            benchmarkSize( size );
+        }
+    }
+}
+
+/*!
+ * \brief Time the host and GPU solutions of one system size and print the
+ *        results.
+ * \param aSize The number of rows and columns of the system.
+ */
+void DenseLUBenchmark::benchmarkSize( const int aSize ) const {
+    // A fixed seed so that runs on different machines time the same systems.
+    mt19937 generator( aSize );
+    uniform_real_distribution<double> distribution( -1.0, 1.0 );
+    ColumnMatrix matrix( aSize, aSize );
+    Vector b( aSize );
+    for( int j = 0; j < aSize; ++j ) {
+        for( int i = 0; i < aSize; ++i ) {
+            matrix( i, j ) = distribution( generator );
+        }
+        matrix( j, j ) += aSize;
+        b( j ) = distribution( generator );
+    }
+
+    double hostTime = 0.0;
+    double gpuTime = 0.0;
+    bool gpuUsed = GPUDenseLU::isAvailable();
+    Vector hostSolution;
+    Vector gpuSolution;
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        ColumnMatrix work( matrix );
+        hostSolution = b;
+        Clock::time_point start = Clock::now();
+        hostSolve( work, hostSolution );
+        hostTime += chrono::duration<double>( Clock::now() - start ).count();
+
+        if( gpuUsed ) {
+            work = matrix;
+            gpuSolution = b;
+            start = Clock::now();
+            gpuUsed = gpuSolve( work, gpuSolution );
+            gpuTime += chrono::duration<double>( Clock::now() - start ).count();
+        }
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Dense L-U benchmark of size " << aSize << ", seconds per solve:\thost: "
+            << hostTime / mRepeats;
+    if( gpuUsed ) {
+        double maxDiff = 0.0;
+        for( int i = 0; i < aSize; ++i ) {
+            maxDiff = max( maxDiff, fabs( hostSolution( i ) - gpuSolution( i ) ) );
+        }
+        mainLog << "\tGPU: " << gpuTime / mRepeats << "\tspeedup: " << hostTime / gpuTime
+                << "\tmax difference: " << maxDiff;
+    }
+    mainLog << endl;
+}
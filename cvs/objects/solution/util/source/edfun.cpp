@@ -33,17 +33,28 @@
 #include <stdlib.h>
 #include <math.h>
 #include <assert.h>
+#include <algorithm>
+#include <map>
 #include <set>
 #include <vector>
 #include "solution/util/include/edfun.hpp"
 #include "util/base/include/fltcmp.hpp"
 #include "containers/include/iactivity.h"
 #include "util/base/include/util.h"
+#include "util/base/include/configuration.h"
 #include "util/logger/include/ilogger.h"
 #include "containers/include/scenario.h"
 #include "util/base/include/manage_state_variables.hpp"
+#include "marketplace/include/market_price_cache.h"
 
 #include "util/base/include/timer.h"
+#include "util/base/include/scope_profiler.h"
+#include "solution/util/include/jacobian_profiler.h"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
+#endif
 
 #define UBVECTOR boost::numeric::ublas::vector 
 
@@ -59,7 +70,10 @@ LogEDFun::LogEDFun(SolutionInfoSet &sisin,
     mkts(sisin.getSolvableSet()),
     solnset(sisin),
     world(w), mktplc(m), period(per),
-    mLogPricep(aLogPricep)
+    mLogPricep(aLogPricep),
+    mMaxPeripheralIter(0),
+    mUnitInputScale(true),
+    mAdaptiveStep(Configuration::getInstance()->getBool("adaptive-jacobian-step", false))
 {
     na=nr=mkts.size();
     mdiagnostic=false;
@@ -104,6 +118,28 @@ LogEDFun::LogEDFun(SolutionInfoSet &sisin,
                 mfxscl[i] = 1.0;
         }
     } 
+
+    // The market types and lower bounds of the markets being solved do not
+    // change over the lifetime of this object so decide once how the output
+    // of each is to be calculated.
+    mOutputKind.resize(na);
+    mLowerBoundPrice.resize(na);
+    for(int i=0; i<na; ++i) {
+        const IMarketType::Type type = mkts[i].getType();
+        if(type == IMarketType::NORMAL) {
+            mOutputKind[i] = mLogPricep ? LOG_RATIO : LINEAR_NORMAL;
+        }
+        else if(!mLogPricep && ( type == IMarketType::RES || type == IMarketType::TAX
+                                 || type == IMarketType::SUBSIDY ) )
+        {
+            mOutputKind[i] = LINEAR_CONSTRAINT;
+        }
+        else {
+            mOutputKind[i] = DIFFERENCE;
+        }
+        mLowerBoundPrice[i] = mkts[i].getLowerBoundSupplyPrice();
+        mUnitInputScale = mUnitInputScale && mxscl[i] == 1.0;
+    }
 }
 
 /*!
@@ -120,8 +156,153 @@ void LogEDFun::scaleInitInputs(UBVECTOR<double> &ax)
 }
 
 
+/*!
+ * \brief Set markets to be solved inside each full evaluation.
+ * \details This reduces the space the caller solves in to the markets
+ *          given in the constructor, which should then not include these.
+ *          Only full evaluations solve the peripheral markets, partial
+ *          derivatives and batch evaluations hold their prices fixed so
+ *          that the Jacobian seen by the caller ignores their response.
+ *          This suits peripheral markets which barely affect the others.
+ * \param aperipheral The markets to solve inside each full evaluation.
+ * \param amaxiter The maximum number of steps to take to solve them.
+ */
+void LogEDFun::setPeripheralMarkets(const std::vector<SolutionInfo> &aperipheral, const unsigned int amaxiter)
+{
+  mPeripheral = aperipheral;
+  mMaxPeripheralIter = amaxiter;
+  mPeripheralDependencies.clear();
+  if(mPeripheral.empty()) {
+    return;
+  }
+  std::set<const IActivity*> deps;
+  for(size_t i=0; i<mPeripheral.size(); ++i) {
+    deps.insert(mPeripheral[i].getDependencies().begin(), mPeripheral[i].getDependencies().end());
+  }
+  const std::vector<IActivity*>& globalOrdering = world->getGlobalOrdering();
+  for(size_t k=0; k<globalOrdering.size(); ++k) {
+    if(deps.find(globalOrdering[k]) != deps.end()) {
+      mPeripheralDependencies.push_back(globalOrdering[k]);
+    }
+  }
+}
+
+/*!
+ * \brief Solve the peripheral markets at the current prices of the
+ *        markets being manipulated.
+ * \details Called after a full evaluation.  Each peripheral market is
+ *          solved on its own by a secant iteration, started with a step
+ *          in the direction of its excess demand, with all of them
+ *          stepped together.  A step may change a price by at most half.
+ *          Only the activities the peripheral markets affect are
+ *          recalculated for each step, in a "scratch" state as for a
+ *          partial derivative, after which a single full evaluation
+ *          brings the "base" state up to date with the new prices.
+ */
+void LogEDFun::solvePeripheral()
+{
+  const size_t np = mPeripheral.size();
+  if(np == 0 || mPeripheralDependencies.empty()) {
+    return;
+  }
+
+  std::vector<double> price(np), prevPrice(np), prevED(np);
+  bool ispartial = false;
+  for(unsigned int iter=0; iter<mMaxPeripheralIter; ++iter) {
+    bool allsolved = true;
+    for(size_t i=0; i<np; ++i) {
+      allsolved = allsolved && mPeripheral[i].isWithinTolerance();
+    }
+    if(allsolved) {
+      break;
+    }
+
+    for(size_t i=0; i<np; ++i) {
+      const double p = mPeripheral[i].getPrice();
+      const double ed = mPeripheral[i].getED();
+      const double maxstep = 0.5*std::max(fabs(p), MINXSCL);
+      double step = 0.0;
+      if(!mPeripheral[i].isWithinTolerance()) {
+        const double dp = p - prevPrice[i];
+        const double slope = iter > 0 && dp != 0.0 ? (ed - prevED[i]) / dp : 0.0;
+        // Excess demand should fall as the price rises, otherwise start over.
+        step = slope < 0.0 ? -ed / slope : (ed > 0.0 ? 0.1 : -0.1) * maxstep;
+        step = std::max(-maxstep, std::min(step, maxstep));
+      }
+      prevPrice[i] = p;
+      prevED[i] = ed;
+      price[i] = p + step;
+    }
+
+    if(!ispartial) {
+      mktplc->mIsDerivativeCalc = true;
+      scenario->mManageStateVars->setPartialDeriv(true);
+      ispartial = true;
+    }
+    scenario->mManageStateVars->copyState();
+    for(size_t i=0; i<np; ++i) {
+      mPeripheral[i].setPrice(price[i]);
+    }
+#if GCAM_PARALLEL_ENABLED
+    world->calc(period, 0, &mPeripheralDependencies);
+#else
+    world->calc(period, mPeripheralDependencies);
+#endif
+  }
+
+  if(ispartial) {
+    for(size_t i=0; i<np; ++i) {
+      price[i] = mPeripheral[i].getPrice();
+    }
+    mktplc->mIsDerivativeCalc = false;
+    scenario->mManageStateVars->setPartialDeriv(false);
+    for(size_t i=0; i<np; ++i) {
+      mPeripheral[i].setPrice(price[i]);
+    }
+    mktplc->nullSuppliesAndDemands(period);
+#if GCAM_PARALLEL_ENABLED
+    world->calc(period, world->getGlobalFlowGraph());
+#else
+    world->calc(period);
+#endif
+  }
+}
+
+/*!
+ * \details The "base" state of the model is kept in an undo log (see
+ *          ManageStateVariables::startUndoLog) so that the model may be
+ *          returned to the last full evaluation without calculating it
+ *          again.
+ */
+void LogEDFun::checkpoint()
+{
+  scenario->mManageStateVars->startUndoLog();
+}
+
+/*!
+ * \details Restores the prices, supplies, demands and every other STATE
+ *          value of the model from the undo log.
+ */
+bool LogEDFun::rollback()
+{
+  const bool rolledBack = scenario->mManageStateVars->rollbackUndoLog();
+  if( rolledBack ) {
+      // The records of the price caches were made from the state which was
+      // just discarded.
+      MarketPriceCache::invalidateAll();
+  }
+  return rolledBack;
+}
+
+void LogEDFun::commit()
+{
+  scenario->mManageStateVars->stopUndoLog();
+}
+
+
 void LogEDFun::partial(int ip)
 {
+    GCAM_PROFILE_SCOPE( "EdFun partial reset" );
     Timer& edfunAnResetTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_AN_RESET );
     edfunAnResetTimer.start();
     if(ip >= 0) {
@@ -145,23 +326,45 @@ double LogEDFun::partialSize(int ip) const
   return double(mkts[ip].getDependencies().size()) / double(world->getGlobalOrderingSize());
 }
 
+/*!
+ * \details If "adaptive-jacobian-step" is set the step size is kept in the
+ *          market being solved so that a step that has been adapted to the
+ *          market's response is reused in later iterations and periods.
+ *          Otherwise, and for markets that do not yet have a step, the usual
+ *          fixed relative step is used.
+ */
+double LogEDFun::partialStep(int ip) const
+{
+  const double FIXED_STEP = 1.0e-6;
+  if(!mAdaptiveStep) {
+    return FIXED_STEP;
+  }
+  double step = mkts[ip].getJacobianStep();
+  return step > 0.0 ? step : FIXED_STEP;
+}
+
+void LogEDFun::setPartialStep(int ip, double astep)
+{
+  if(mAdaptiveStep) {
+    mkts[ip].setJacobianStep(astep);
+  }
+}
+
 void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, const int partj)
 {
   assert(ax.size() == mkts.size());
   assert(fx.size() == mkts.size());
 
+  GCAM_PROFILE_SCOPE( "EdFun" );
   Timer& edfunMiscTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_MISC );
   Timer& edfunPreTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_PRE );
   edfunMiscTimer.start();
   edfunPreTimer.start();
 
-  // copy x so we can scale it without destroying the original.  This
-  // is probably going to incur enough overhead that we will
-  // eventually want to do the scaling inline when we assign the
-  // prices, but this is easier for now.
-  UBVECTOR<double> x(ax.size()); 
-  for(unsigned int i=0; i<x.size(); ++i)
-      x[i] = ax[i]*mxscl[i];
+  // scale a copy of x, if there is anything to scale, so that we don't
+  // destroy the original.
+  UBVECTOR<double> xscaled;
+  const UBVECTOR<double> &x = scaleInputs(ax, xscaled);
   
 
   /**** The way we do this is kind of ugly.  We have two procedures
@@ -180,24 +383,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
 
     /* set prices into the marketplace. If the inputs are log-prices,
        we have to exp() them first*/
-    if(mLogPricep) {
-      /***** In part 3 we make some exceptions for certain market
-       ***** types.  Perhaps we should consider doing that here too.
-       ***** E.g., we could make the inputs for price and demand
-       ***** markets always linear.
-       *****/
-      for(size_t i=0; i<x.size(); ++i) {
-        if(x[i] > ARGMAX)
-          mkts[i].setPrice(PMAX);
-        else
-          mkts[i].setPrice(exp(x[i])); // input vector = log(price)
-      }
-    }
-    else {
-      for(size_t i=0; i<x.size(); ++i) {
-        mkts[i].setPrice(x[i]); // input vector = price
-      }
-    }
+    setPrices(x);
     edfunMiscTimer.stop();
     edfunPreTimer.stop(); 
 
@@ -211,6 +397,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
 #else
     world->calc(period);
 #endif
+    solvePeripheral();
     evalFullTimer.stop();
     // Proceed to part 3 below.
   }
@@ -219,6 +406,8 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
      * 1B Set the model inputs using the solutionInfo objects (partial derivative version)
      ****/ 
     mktplc->mIsDerivativeCalc = true;
+    JacobianProfiler& profiler = JacobianProfiler::getInstance();
+    const boost::posix_time::ptime profileStart = profiler.startColumn();
 
 
     if(mdiagnostic) {
@@ -234,17 +423,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
     // In theory the loop over markets is unnecessary, and we need
     // only to set mkts[partj].  We should try that sometime.
     if(mLogPricep) {            
-      /***** In part 3 we make some exceptions for certain market
-       ***** types.  Perhaps we should consider doing that here too.
-       ***** E.g., we could make the inputs for price and demand
-       ***** markets always linear.
-       *****/
-      for(size_t i=0; i<x.size(); ++i) {
-        if(x[i] > ARGMAX)
-          mkts[i].setPrice(PMAX);
-        else
-          mkts[i].setPrice(exp(x[i])); // input vector = log(price)
-      }
+      setPrices(x);
     }
     else {
         // During a partial calc only the price of the partj'th element should
@@ -269,6 +448,7 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
     // derivative to run is a parallel_for.
     world->calc(period, affectedNodes);
     evalPartTimer.stop();
+    profiler.stopColumn(profileStart, period, partj, mkts[partj].getName(), affectedNodes.size());
 
     if(mdiagnostic) {
       ILogger &solverlog = ILogger::getLogger("solver_log");
@@ -280,7 +460,296 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
     }
   }
 
-  
+
+  calcOutputs(x, fx);
+}
+
+/*!
+ * \brief Evaluate the function with several structurally independent
+ *        prices perturbed at once.
+ * \details The markets in apartjs must have been grouped by partialGroups
+ *          so that their dependencies are disjoint.  The union of their
+ *          dependencies can then be calculated in a single pass, in any
+ *          order relative to one another, and each market's effect on the
+ *          outputs is recovered separately by the caller.
+ * \param ax The (scaled) input vector.
+ * \param fx The output vector.
+ * \param apartjs The indices of the markets whose prices were perturbed.
+ */
+void LogEDFun::partialGroup(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, const std::vector<int> &apartjs)
+{
+  assert(!apartjs.empty());
+  if(apartjs.size() == 1) {
+    (*this)(ax, fx, apartjs[0]);
+    return;
+  }
+
+  GCAM_PROFILE_SCOPE( "EdFun group" );
+  Timer& edfunMiscTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_MISC );
+  Timer& edfunPreTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_PRE );
+  edfunMiscTimer.start();
+  edfunPreTimer.start();
+
+  UBVECTOR<double> xscaled;
+  const UBVECTOR<double> &x = scaleInputs(ax, xscaled);
+
+  mktplc->mIsDerivativeCalc = true;
+  JacobianProfiler& profiler = JacobianProfiler::getInstance();
+  const boost::posix_time::ptime profileStart = profiler.startColumn();
+  if(mLogPricep) {
+    setPrices(x);
+  }
+  else {
+    for(size_t k=0; k<apartjs.size(); ++k) {
+      mkts[apartjs[k]].setPrice(x[apartjs[k]]);
+    }
+  }
+
+  std::vector<IActivity*> affectedNodes;
+  for(size_t k=0; k<apartjs.size(); ++k) {
+    const std::vector<IActivity*>& deps = mkts[apartjs[k]].getDependencies();
+    affectedNodes.insert(affectedNodes.end(), deps.begin(), deps.end());
+  }
+  edfunMiscTimer.stop();
+  edfunPreTimer.stop();
+
+  Timer& evalPartTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EVAL_PART );
+  evalPartTimer.start();
+  world->calc(period, affectedNodes);
+  evalPartTimer.stop();
+  // the group is recorded as a single evaluation under its first column
+  profiler.stopColumn(profileStart, period, apartjs[0], mkts[apartjs[0]].getName(), affectedNodes.size());
+
+  calcOutputs(x, fx);
+}
+
+/*!
+ * \brief Evaluate the function at several points at once.
+ * \details Each point is evaluated in a "scratch" state, as for a partial
+ *          derivative, starting from the "base" state left by the last full
+ *          evaluation and recalculating every activity that depends on any
+ *          of the solvable prices.  Since the activities that are skipped
+ *          only see prices that do not change, the result is the same as a
+ *          full evaluation.  When GCAM_PARALLEL_ENABLED each point is given
+ *          its own thread, and state slot, from the ManageStateVariables
+ *          thread pool.  The "base" state is left untouched so the caller
+ *          must make a regular evaluation at whichever point it selects
+ *          before proceeding from it.
+ * \param axs The (scaled) input vectors.
+ * \param afxs The output vectors, one per input vector.
+ */
+void LogEDFun::batch(const std::vector<UBVECTOR<double> > &axs, std::vector<UBVECTOR<double> > &afxs)
+{
+  afxs.resize(axs.size());
+  if(axs.size() == 1) {
+    afxs[0].resize(nr);
+    (*this)(axs[0], afxs[0]);
+    return;
+  }
+  if(axs.empty()) {
+    return;
+  }
+
+  if(mAllDependencies.empty()) {
+    std::set<const IActivity*> deps;
+    for(size_t j=0; j<mkts.size(); ++j) {
+      deps.insert(mkts[j].getDependencies().begin(), mkts[j].getDependencies().end());
+    }
+    const std::vector<IActivity*>& globalOrdering = world->getGlobalOrdering();
+    for(size_t k=0; k<globalOrdering.size(); ++k) {
+      if(deps.find(globalOrdering[k]) != deps.end()) {
+        mAllDependencies.push_back(globalOrdering[k]);
+      }
+    }
+  }
+
+  ManageStateVariables* stateVars = scenario->getManageStateVariables();
+  mktplc->mIsDerivativeCalc = true;
+  stateVars->setPartialDeriv(true);
+
+  auto evalPoint = [&](const size_t k) {
+    stateVars->copyState();
+    UBVECTOR<double> xscaled;
+    const UBVECTOR<double> &x = scaleInputs(axs[k], xscaled);
+    setPrices(x);
+    world->calc(period, mAllDependencies);
+    afxs[k].resize(nr);
+    calcOutputs(x, afxs[k]);
+  };
+
+  GCAM_PROFILE_SCOPE( "EdFun batch" );
+  Timer& evalFullTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EVAL_FULL );
+  evalFullTimer.start();
+#if !GCAM_PARALLEL_ENABLED
+  for(size_t k=0; k<axs.size(); ++k) {
+    evalPoint(k);
+  }
+#else
+  tbb::task_arena& threadPool = stateVars->mThreadPool;
+  tbb::task_group tg;
+  threadPool.execute([&](){
+      tg.run([&](){
+          tbb::parallel_for(size_t(0), axs.size(), evalPoint);
+      });
+  });
+  threadPool.execute([&tg](){ tg.wait(); });
+#endif
+  evalFullTimer.stop();
+
+  partial(-1);
+}
+
+/*!
+ * \brief Evaluate the response of a single market at several values of its
+ *        own price.
+ * \details This is the partial derivative calculation repeated for each of
+ *          the given prices: each point starts from the "base" state left by
+ *          the last full evaluation, which must have been made at ax, changes
+ *          only the price of market ip and recalculates only the activities
+ *          which depend on it.  When GCAM_PARALLEL_ENABLED the points are
+ *          evaluated concurrently, each in its own state slot, from the
+ *          ManageStateVariables thread pool.  The "base" state is left
+ *          untouched.
+ * \param ip The index of the market to vary.
+ * \param ax The (scaled) input vector of the last full evaluation.
+ * \param axj The (scaled) prices of market ip at which to evaluate.
+ * \param apoints The price, supply, demand and output of market ip at each
+ *                of the prices in axj.
+ */
+void LogEDFun::partialSweep(int ip, const UBVECTOR<double> &ax, const std::vector<double> &axj,
+                            std::vector<SweepPoint> &apoints)
+{
+  assert(ip >= 0 && ip < static_cast<int>(mkts.size()));
+  apoints.resize(axj.size());
+  if(axj.empty()) {
+    return;
+  }
+
+  const std::vector<IActivity*>& affectedNodes = mkts[ip].getDependencies();
+  ManageStateVariables* stateVars = scenario->getManageStateVariables();
+  mktplc->mIsDerivativeCalc = true;
+  stateVars->setPartialDeriv(true);
+
+  auto evalPoint = [&](const size_t k) {
+    stateVars->copyState();
+    UBVECTOR<double> axk(ax);
+    axk[ip] = axj[k];
+    UBVECTOR<double> xscaled;
+    const UBVECTOR<double> &x = scaleInputs(axk, xscaled);
+    setPrices(x);
+    if(!affectedNodes.empty()) {
+      world->calc(period, affectedNodes);
+    }
+    UBVECTOR<double> fx(nr);
+    calcOutputs(x, fx);
+    apoints[k].price = mkts[ip].getPrice();
+    apoints[k].supply = mkts[ip].getSupply();
+    apoints[k].demand = mkts[ip].getDemand();
+    apoints[k].fx = fx[ip];
+  };
+
+  GCAM_PROFILE_SCOPE( "EdFun sweep" );
+  Timer& evalPartTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EVAL_PART );
+  evalPartTimer.start();
+#if !GCAM_PARALLEL_ENABLED
+  for(size_t k=0; k<axj.size(); ++k) {
+    evalPoint(k);
+  }
+#else
+  tbb::task_arena& threadPool = stateVars->mThreadPool;
+  tbb::task_group tg;
+  threadPool.execute([&](){
+      tg.run([&](){
+          tbb::parallel_for(size_t(0), axj.size(), evalPoint);
+      });
+  });
+  threadPool.execute([&tg](){ tg.wait(); });
+#endif
+  evalPartTimer.stop();
+
+  partial(-1);
+}
+
+/*!
+ * \brief Group markets which may be perturbed simultaneously when computing
+ *        a finite difference Jacobian.
+ * \details Markets are placed in the same group only if they share no
+ *          activities in their dependencies and no rows in the given sparsity
+ *          pattern.  The first condition guarantees that no calculation sees
+ *          more than one of the perturbed prices and the second that each
+ *          changed output can be attributed to exactly one market.  Groups
+ *          are filled greedily taking the markets with the largest
+ *          dependency lists first, which tends to give fewer colors.
+ * \param arowpattern For each market the outputs known to depend on its price.
+ * \param agroups The resulting groups of market indices.
+ */
+void LogEDFun::partialGroups(const std::vector<std::vector<int> > &arowpattern,
+                             std::vector<std::vector<int> > &agroups) const
+{
+  assert(arowpattern.size() == mkts.size());
+  agroups.clear();
+
+  // Assign each activity a dense index so that group membership can be
+  // checked with bit vectors.
+  std::map<const IActivity*, size_t> activityIndex;
+  for(size_t j=0; j<mkts.size(); ++j) {
+    const std::vector<IActivity*>& deps = mkts[j].getDependencies();
+    for(size_t k=0; k<deps.size(); ++k) {
+      activityIndex.insert(std::make_pair(deps[k], activityIndex.size()));
+    }
+  }
+
+  std::vector<int> order(mkts.size());
+  for(size_t j=0; j<order.size(); ++j) {
+    order[j] = j;
+  }
+  std::stable_sort(order.begin(), order.end(), [this](const int aLHS, const int aRHS) {
+    return mkts[aLHS].getDependencies().size() > mkts[aRHS].getDependencies().size();
+  });
+
+  std::vector<std::vector<bool> > groupRows;
+  std::vector<std::vector<bool> > groupActivities;
+  for(size_t o=0; o<order.size(); ++o) {
+    const int j = order[o];
+    const std::vector<IActivity*>& deps = mkts[j].getDependencies();
+    size_t g = 0;
+    for(; g<agroups.size(); ++g) {
+      bool conflict = false;
+      for(size_t r=0; r<arowpattern[j].size() && !conflict; ++r) {
+        conflict = groupRows[g][arowpattern[j][r]];
+      }
+      for(size_t k=0; k<deps.size() && !conflict; ++k) {
+        conflict = groupActivities[g][activityIndex[deps[k]]];
+      }
+      if(!conflict) {
+        break;
+      }
+    }
+    if(g == agroups.size()) {
+      agroups.push_back(std::vector<int>());
+      groupRows.push_back(std::vector<bool>(nr, false));
+      groupActivities.push_back(std::vector<bool>(activityIndex.size(), false));
+    }
+    agroups[g].push_back(j);
+    for(size_t r=0; r<arowpattern[j].size(); ++r) {
+      groupRows[g][arowpattern[j][r]] = true;
+    }
+    for(size_t k=0; k<deps.size(); ++k) {
+      groupActivities[g][activityIndex[deps[k]]] = true;
+    }
+  }
+}
+
+/*!
+ * \brief Collect the supplies and demands from the solvable markets and
+ *        convert them into the (scaled) function outputs.
+ * \param x The unscaled input vector which was used to set prices.
+ * \param fx The output vector to fill.
+ */
+void LogEDFun::calcOutputs(const UBVECTOR<double> &x, UBVECTOR<double> &fx)
+{
+  GCAM_PROFILE_SCOPE( "EdFun outputs" );
+  Timer& edfunMiscTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_MISC );
   edfunMiscTimer.start();
   Timer& edfunPostTimer = TimerRegistry::getInstance().getTimer( TimerRegistry::EDFUN_POST );
   edfunPostTimer.start();
@@ -289,20 +758,103 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
    * 3 Collect the outputs from the solutionInfo objects and repack them in the
    *   output vector
    ****/
+  if(mLogPricep) {
+    calcOutputsImpl<true>(x, fx);
+  }
+  else {
+    calcOutputsImpl<false>(x, fx);
+  }
   
-  // at this point we've recalculated all the supplies and demands.
-  // Retrieve them, calculate output according to market type, and
-  // store them in fx
-  for(size_t i=0; i<mkts.size(); ++i) {
-    const double TINY = util::getTinyNumber();
-    if(mLogPricep && mkts[i].getType() == IMarketType::NORMAL) { // LOG CASE (NORMAL markets only)
+  edfunPostTimer.stop();
+
+  edfunMiscTimer.stop();
+}
+
+/*!
+ * \brief Apply the input scale factors to a vector of solver inputs.
+ * \details When every scale factor is one, as is always the case for log
+ *          prices, the solver's vector is used as it is rather than copied.
+ * \param ax The (scaled) input vector from the solver.
+ * \param x Space for the unscaled inputs, which is resized and filled only
+ *          if there are scale factors to apply.
+ * \return The unscaled inputs, either ax or x.
+ */
+const UBVECTOR<double> &LogEDFun::scaleInputs(const UBVECTOR<double> &ax, UBVECTOR<double> &x) const
+{
+  if(mUnitInputScale) {
+    return ax;
+  }
+  const size_t n = ax.size();
+  x.resize(n, false);
+  if(n == 0) {
+    return x;
+  }
+  const double* in = &ax[0];
+  const double* scl = &mxscl[0];
+  double* out = &x[0];
+  for(size_t i=0; i<n; ++i) {
+    out[i] = in[i]*scl[i];
+  }
+  return x;
+}
+
+/*!
+ * \brief Set the prices of all of the markets being solved.
+ * \details If the inputs are log-prices they are exp()'d first, limiting the
+ *          price to PMAX.
+ *
+ *          In calcOutputs we make some exceptions for certain market types.
+ *          Perhaps we should consider doing that here too.  E.g., we could
+ *          make the inputs for price and demand markets always linear.
+ * \param x The unscaled input vector.
+ */
+void LogEDFun::setPrices(const UBVECTOR<double> &x)
+{
+  if(mLogPricep) {
+    setPricesImpl<true>(x);
+  }
+  else {
+    setPricesImpl<false>(x);
+  }
+}
+
+template<bool LogPrice>
+void LogEDFun::setPricesImpl(const UBVECTOR<double> &x)
+{
+  for(size_t i=0; i<x.size(); ++i) {
+    if(!LogPrice)
+      mkts[i].setPrice(x[i]); // input vector = price
+    else if(x[i] > ARGMAX)
+      mkts[i].setPrice(PMAX);
+    else
+      mkts[i].setPrice(exp(x[i])); // input vector = log(price)
+  }
+}
+
+/*!
+ * \brief Calculate the (scaled) outputs of all of the markets being solved.
+ * \details Each output is computed from the supply and demand of the
+ *          market, read directly from its state, according to the output
+ *          kind fixed for the market in the constructor.  Only the output
+ *          kinds valid for the given price space are considered.
+ * \param x The unscaled input vector which was used to set prices.
+ * \param fx The output vector to fill.
+ */
+template<bool LogPrice>
+void LogEDFun::calcOutputsImpl(const UBVECTOR<double> &x, UBVECTOR<double> &fx)
+{
+  const size_t n = mkts.size();
+  const double TINY = util::getTinyNumber();
+  for(size_t i=0; i<n; ++i) {
+    const double d = mkts[i].getDemand();
+    const double s = mkts[i].getSupply();
+    const double p0 = mLowerBoundPrice[i];
+    double fxi;
+    if(LogPrice && mOutputKind[i] == LOG_RATIO) {
       // for normal markets, output log(demand/supply), if we are using log prices
-      double d = std::max(mkts[i].getDemand(), TINY);
-      double s = std::max(mkts[i].getSupply(), TINY);
-      double p0 = mkts[i].getLowerBoundSupplyPrice();
-      double p  = x[i]>=ARGMAX ? PMAX : exp(x[i]);
-      double c  = std::max(0.0, p0-p);
-      double fxi = log(d/s);
+      const double p = x[i]>=ARGMAX ? PMAX : exp(x[i]);
+      const double c = std::max(0.0, p0-p);
+      fxi = log(std::max(d, TINY)/std::max(s, TINY));
       if(c>0.0) {
         ILogger &solverlog = ILogger::getLogger("solver_log");
         solverlog.setLevel(ILogger::DEBUG);
@@ -310,70 +862,48 @@ void LogEDFun::operator()(const UBVECTOR<double> &ax, UBVECTOR<double> &fx, cons
                   << "  p0= " << p0 << "  c= " << c
                   << "  unmodified fx= " << fxi << "  modified fx= " << fxi+c
                   << "\n";
-      }      
-      fx[i] = log(d/s)+c;
+      }
+      fxi += c;
     }
-    else if(mkts[i].getType() == IMarketType::NORMAL) { // LINEAR CASE (NORMAL markets only)
-        double d = mkts[i].getDemand();
-        double s = mkts[i].getSupply();
-
-        // generate a correction if the input price is less than the
-        // supply curve lower bound.  This is most effective if we transform the
-        // price correction from it's price scale into a scale relevant for the demands.
-        // Note that the lower bound limit is an estimate
-        // and in some cases may not be exact, thus we will only apply the correction
-        // if the supply was indeed zero.  If the actual lower bound price is significantly
-        // different than the estimated this may generate a discontinuity.
-        double p0 = mkts[i].getLowerBoundSupplyPrice();
-        double c = s == 0 ? std::max(0.0, (p0-x[i])/mfxscl[i]/mxscl[i]) : 0;
-        // give difference as a fraction of demand
-        fx[i] = d - s + c;          // == d-(s-c); i.e., the correction subtracts from supply
-        if(c>0.0) {
-          ILogger &solverlog = ILogger::getLogger("solver_log");
-          solverlog.setLevel(ILogger::DEBUG);
-          solverlog << "\t\tAdding supply correction: i= " << i << "  p= " << x[i]
-                    << "  p0= " << p0 << "  c= " << c << "  modified supply= " << s-c
-                    << "\n";
-        }
+    else if(!LogPrice && mOutputKind[i] == LINEAR_NORMAL) {
+      // generate a correction if the input price is less than the
+      // supply curve lower bound.  This is most effective if we transform the
+      // price correction from it's price scale into a scale relevant for the demands.
+      // Note that the lower bound limit is an estimate
+      // and in some cases may not be exact, thus we will only apply the correction
+      // if the supply was indeed zero.  If the actual lower bound price is significantly
+      // different than the estimated this may generate a discontinuity.
+      const double c = s == 0 ? std::max(0.0, (p0-x[i])/mfxscl[i]/mxscl[i]) : 0;
+      // give difference as a fraction of demand
+      fxi = d - s + c;          // == d-(s-c); i.e., the correction subtracts from supply
+      if(c>0.0) {
+        ILogger &solverlog = ILogger::getLogger("solver_log");
+        solverlog.setLevel(ILogger::DEBUG);
+        solverlog << "\t\tAdding supply correction: i= " << i << "  p= " << x[i]
+                  << "  p0= " << p0 << "  c= " << c << "  modified supply= " << s-c
+                  << "\n";
+      }
     }
-    else if(!mLogPricep && ( mkts[i].getType() == IMarketType::RES  // LINEAR CASE (constraint type markets only)
-            || mkts[i].getType() == IMarketType::TAX
-            || mkts[i].getType() == IMarketType::SUBSIDY ) )
-    {
-        double d = mkts[i].getDemand();
-        double s = mkts[i].getSupply();
-
-        // generate a correction if the input price is less than the
-        // supply curve lower bound.  This is most effective if we transform the
-        // price correction from it's price scale into a scale relevant for the demands.
-        // Note that for constraint type markets this lower bound is the price (typically
-        // zero) below which the policy is considered non-binding in which case the correction
-        // is essentially adding extra demand to meet the constraint.
-        double p0 = mkts[i].getLowerBoundSupplyPrice();
-        double c = std::max(0.0, (p0-x[i])/mfxscl[i]/mxscl[i]);
-        // give difference as a fraction of demand
-        fx[i] = d - s + c;          // == d-(s-c); i.e., the correction subtracts from supply
-        if(c>0.0) {
-          ILogger &solverlog = ILogger::getLogger("solver_log");
-          solverlog.setLevel(ILogger::DEBUG);
-          solverlog << "\t\tAdding supply correction: i= " << i << "  p= " << x[i]
-                    << "  p0= " << p0 << "  c= " << c << "  s= " << s << " d= " << d << " modified F(x)= " << fx[i]
-                    << "\n";
-        }
+    else if(!LogPrice && mOutputKind[i] == LINEAR_CONSTRAINT) {
+      // Note that for constraint type markets the lower bound is the price (typically
+      // zero) below which the policy is considered non-binding in which case the correction
+      // is essentially adding extra demand to meet the constraint.
+      const double c = std::max(0.0, (p0-x[i])/mfxscl[i]/mxscl[i]);
+      fxi = d - s + c;
+      if(c>0.0) {
+        ILogger &solverlog = ILogger::getLogger("solver_log");
+        solverlog.setLevel(ILogger::DEBUG);
+        solverlog << "\t\tAdding supply correction: i= " << i << "  p= " << x[i]
+                  << "  p0= " << p0 << "  c= " << c << "  s= " << s << " d= " << d << " modified F(x)= " << fxi
+                  << "\n";
+      }
     }
-    else {                      // Markets that are neither normal nor constraint types.
+    else {
       // for other types of markets (mostly price, demand, and
       // trial-value), output fractional demand - supply
-        fx[i] = mkts[i].getDemand() - mkts[i].getSupply();
+      fxi = d - s;
     }
+    // Do the scaling for fx
+    fx[i] = fxi * mfxscl[i];
   }
-
-  // Do the scaling for fx
-  for(unsigned i=0; i<fx.size(); ++i)
-      fx[i] *= mfxscl[i];
-  
-  edfunPostTimer.stop();
-
-  edfunMiscTimer.stop();
 }
-
@@ -0,0 +1,230 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+ * \file gpu_dense_lu.cpp
+ * \ingroup Solution
+ * \brief GPUDenseLU class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+
+#include "solution/util/include/gpu_dense_lu.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+#if GCAM_USE_CUSOLVER
+#include <mutex>
+#include <vector>
+#include <algorithm>
+#include <cuda_runtime.h>
+#include <cusolverDn.h>
+#endif
+
+using namespace std;
+
+#if GCAM_USE_CUSOLVER
+namespace {
+    /*!
+     * \brief The cuSOLVER handle and the device buffers, which are grown as
+     *        needed and kept for the rest of the run.
+     */
+    struct DeviceState {
+        DeviceState():mInitialized( false ), mAvailable( false ), mHandle( 0 ),
+            mMatrix( 0 ), mMatrixSize( 0 ), mWork( 0 ), mWorkSize( 0 ), mPivots( 0 ), mInfo( 0 ) {}
+
+        //! Mutex serializing use of the device.
+        mutex mMutex;
+        //! Whether initialization has been attempted.
+        bool mInitialized;
+        //! Whether a device was found and the last use succeeded.
+        bool mAvailable;
+        cusolverDnHandle_t mHandle;
+        double* mMatrix;
+        size_t mMatrixSize;
+        double* mWork;
+        int mWorkSize;
+        int* mPivots;
+        int* mInfo;
+    };
+
+    DeviceState& getDeviceState() {
+        static DeviceState state;
+        return state;
+    }
+
+    /*!
+     * \brief Create the cuSOLVER handle if there is a device, must be called
+     *        while holding the mutex.
+     */
+    void initialize( DeviceState& aState ) {
+        if( aState.mInitialized ) {
+            return;
+        }
+        aState.mInitialized = true;
+        int numDevices = 0;
+        if( cudaGetDeviceCount( &numDevices ) != cudaSuccess || numDevices == 0 ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::NOTICE );
+            mainLog << "No CUDA device was found, dense matrices will be factored on the host." << endl;
+            return;
+        }
+        aState.mAvailable = cusolverDnCreate( &aState.mHandle ) == CUSOLVER_STATUS_SUCCESS &&
+            cudaMalloc( reinterpret_cast<void**>( &aState.mInfo ), sizeof( int ) ) == cudaSuccess;
+    }
+
+    /*!
+     * \brief Stop using the device for the rest of the run after a failure.
+     * \param aWhat The call which failed.
+     */
+    void disable( DeviceState& aState, const char* aWhat ) {
+        aState.mAvailable = false;
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << aWhat << " failed, dense matrices will be factored on the host." << endl;
+    }
+}
+#endif
+
+/*!
+ * \brief Whether matrices may be factored on a GPU.
+ * \return True if built with GCAM_USE_CUSOLVER and a usable CUDA device was
+ *         found.
+ */
+bool GPUDenseLU::isAvailable() {
+#if GCAM_USE_CUSOLVER
+    DeviceState& state = getDeviceState();
+    lock_guard<mutex> lock( state.mMutex );
+    initialize( state );
+    return state.mAvailable;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief Factor a square column major matrix on the GPU.
+ * \details The arguments and results are those of LAPACK's dgetrf.
+ * \param aColumnMajor The matrix, which holds the L-U factors on return.
+ * \param aSize The number of rows and columns.
+ * \param aPivots The one based row interchanges, of length aSize.
+ * \param aInfo Set to zero, or to the one based index of the first zero pivot.
+ * \param aForce Whether to factor the matrix even if it is smaller than
+ *        gpu-lu-min-size.
+ * \return Whether the matrix was factored, if false the arguments are
+ *         untouched and it must be factored on the host.
+ */
+bool GPUDenseLU::factorize( double* aColumnMajor, const int aSize, int* aPivots, int& aInfo,
+                            const bool aForce )
+{
+#if GCAM_USE_CUSOLVER
+    if( aSize == 0 || ( !aForce && aSize < getMinSize() ) ) {
+        return false;
+    }
+    DeviceState& state = getDeviceState();
+    lock_guard<mutex> lock( state.mMutex );
+    initialize( state );
+    if( !state.mAvailable ) {
+        return false;
+    }
+
+    const size_t numElements = static_cast<size_t>( aSize ) * aSize;
+    if( numElements > state.mMatrixSize ) {
+        cudaFree( state.mMatrix );
+        cudaFree( state.mPivots );
+        state.mMatrixSize = 0;
+        if( cudaMalloc( reinterpret_cast<void**>( &state.mMatrix ), numElements * sizeof( double ) ) != cudaSuccess ||
+            cudaMalloc( reinterpret_cast<void**>( &state.mPivots ), aSize * sizeof( int ) ) != cudaSuccess )
+        {
+            disable( state, "cudaMalloc" );
+            return false;
+        }
+        state.mMatrixSize = numElements;
+    }
+    int workSize = 0;
+    if( cusolverDnDgetrf_bufferSize( state.mHandle, aSize, aSize, state.mMatrix, aSize, &workSize )
+        != CUSOLVER_STATUS_SUCCESS )
+    {
+        disable( state, "cusolverDnDgetrf_bufferSize" );
+        return false;
+    }
+    if( workSize > state.mWorkSize ) {
+        cudaFree( state.mWork );
+        state.mWorkSize = 0;
+        if( cudaMalloc( reinterpret_cast<void**>( &state.mWork ), workSize * sizeof( double ) ) != cudaSuccess ) {
+            disable( state, "cudaMalloc" );
+            return false;
+        }
+        state.mWorkSize = workSize;
+    }
+
+    if( cudaMemcpy( state.mMatrix, aColumnMajor, numElements * sizeof( double ), cudaMemcpyHostToDevice ) != cudaSuccess ) {
+        disable( state, "cudaMemcpy" );
+        return false;
+    }
+    if( cusolverDnDgetrf( state.mHandle, aSize, aSize, state.mMatrix, aSize, state.mWork,
+                          state.mPivots, state.mInfo ) != CUSOLVER_STATUS_SUCCESS )
+    {
+        disable( state, "cusolverDnDgetrf" );
+        return false;
+    }
+    // Nothing is copied back unless the factorization succeeded so that the
+    // host matrix is intact if it has to be factored there instead.
+    int info = 0;
+    vector<int> pivots( aSize );
+    if( cudaMemcpy( &info, state.mInfo, sizeof( int ), cudaMemcpyDeviceToHost ) != cudaSuccess ||
+        cudaMemcpy( &pivots[ 0 ], state.mPivots, aSize * sizeof( int ), cudaMemcpyDeviceToHost ) != cudaSuccess ||
+        cudaMemcpy( aColumnMajor, state.mMatrix, numElements * sizeof( double ), cudaMemcpyDeviceToHost ) != cudaSuccess )
+    {
+        disable( state, "cudaMemcpy" );
+        return false;
+    }
+    copy( pivots.begin(), pivots.end(), aPivots );
+    aInfo = info;
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*!
+ * \brief The smallest matrix which is factored on the GPU, below which the
+ *        cost of copying it to and from the device outweighs the faster
+ *        factorization.
+ * \return The gpu-lu-min-size configuration value.
+ */
+int GPUDenseLU::getMinSize() {
+    static const int minSize = Configuration::getInstance()->getInt( "gpu-lu-min-size", 1000, false );
+    return minSize;
+}
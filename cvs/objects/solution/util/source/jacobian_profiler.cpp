@@ -0,0 +1,218 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file jacobian_profiler.cpp
+* \ingroup Solution
+* \brief JacobianProfiler class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <vector>
+#include <algorithm>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_arena.h>
+#endif
+
+#include "solution/util/include/jacobian_profiler.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/manage_state_variables.hpp"
+
+using namespace std;
+using namespace boost::posix_time;
+
+//! Constructor
+JacobianProfiler::JacobianProfiler():
+mEnabled( Configuration::getInstance()->shouldWriteFile( "jacobian-profile-file", false, false ) ),
+mNumJacobians( 0 ),
+mNumColumns( 0 )
+{
+    if( mEnabled ) {
+        const string fileName = Configuration::getInstance()->getFile( "jacobian-profile-file",
+                                                                         "logs/jacobian_profile.csv" );
+        mOut.open( fileName.c_str() );
+        if( !mOut ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not open Jacobian profile file " << fileName << endl;
+        }
+        else {
+            mOut << "period,jacobian,column,market,activities,wall-time,thread,numa-node" << endl;
+        }
+    }
+}
+
+/*!
+ * \brief Get the singleton instance of the JacobianProfiler.
+ * \return The JacobianProfiler.
+ */
+JacobianProfiler& JacobianProfiler::getInstance() {
+    static JacobianProfiler JACOBIAN_PROFILER;
+    return JACOBIAN_PROFILER;
+}
+
+/*!
+ * \brief Whether Jacobian columns should be recorded.
+ * \return True if the Jacobian profile file is to be written.
+ */
+bool JacobianProfiler::isEnabled() const {
+    return mEnabled;
+}
+
+/*!
+ * \brief Notify the profiler that a new Jacobian is about to be calculated so
+ *        that the columns which follow may be grouped together.
+ */
+void JacobianProfiler::startJacobian() {
+    if( mEnabled ) {
+        ++mNumJacobians;
+    }
+}
+
+/*!
+ * \brief Get the time at which a column's evaluation started.
+ * \return The current time if profiling is enabled.
+ */
+ptime JacobianProfiler::startColumn() const {
+    return mEnabled ? microsec_clock::universal_time() : ptime();
+}
+
+/*!
+ * \brief Record the cost of a single partial derivative evaluation.
+ * \details This may be called concurrently from the threads calculating the
+ *          Jacobian.
+ * \param aStartTime The time returned by startColumn when the evaluation began.
+ * \param aPeriod The model period being solved.
+ * \param aColumn The index of the market perturbed.
+ * \param aMarketName The name of the market perturbed.
+ * \param aNumActivities The number of activities which were calculated.
+ */
+void JacobianProfiler::stopColumn( const ptime& aStartTime, const int aPeriod,
+                                   const int aColumn, const string& aMarketName,
+                                   const size_t aNumActivities )
+{
+    if( !mEnabled ) {
+        return;
+    }
+    time_duration diff = microsec_clock::universal_time() - aStartTime;
+
+    const double wallTime = diff.total_microseconds() * 1.0e-6;
+#if GCAM_PARALLEL_ENABLED
+    const int thread = tbb::this_task_arena::current_thread_index();
+    const int node = ManageStateVariables::getThreadNumaNode( thread );
+    tbb::spin_mutex::scoped_lock lock( mRecordLock );
+#else
+    const int thread = 0;
+    const int node = -1;
+#endif
+    ++mNumColumns;
+    if( mOut ) {
+        mOut << aPeriod << ',' << mNumJacobians << ',' << aColumn << ',' << aMarketName << ','
+             << aNumActivities << ',' << wallTime << ',' << thread << ',' << node << '\n';
+    }
+    MarketTotal& marketTotal = mMarketTotals[ aMarketName ];
+    marketTotal.mWallTime += wallTime;
+    ++marketTotal.mEvaluations;
+    marketTotal.mActivities += aNumActivities;
+    if( node >= 0 ) {
+        NodeTotal& nodeTotal = mNodeTotals[ node ];
+        nodeTotal.mThreads.insert( thread );
+        ++nodeTotal.mEvaluations;
+        nodeTotal.mWallTime += wallTime;
+    }
+}
+
+/*!
+ * \brief Flush the profile file and write a summary of the most expensive
+ *        markets to the main log.
+ */
+void JacobianProfiler::printReport() {
+    if( !mEnabled ) {
+        return;
+    }
+    mOut.flush();
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::DEBUG );
+    printSummary( mainLog );
+    printNodeThroughput( mainLog );
+}
+
+/*!
+ * \brief Print the markets with the greatest total partial derivative time
+ *        along with their average activity counts.
+ * \param aOut The stream to write to.
+ */
+void JacobianProfiler::printSummary( ostream& aOut ) const {
+    const size_t NUM_TO_PRINT = 20;
+
+    vector<pair<double, string> > byTime;
+    for( map<string, MarketTotal>::const_iterator it = mMarketTotals.begin(); it != mMarketTotals.end(); ++it ) {
+        byTime.push_back( make_pair( it->second.mWallTime, it->first ) );
+    }
+    sort( byTime.rbegin(), byTime.rend() );
+
+    aOut << "Jacobian profile: " << mNumColumns << " partial derivatives in "
+         << mNumJacobians << " Jacobians." << endl;
+    aOut << "Most expensive markets (total seconds, evaluations, mean activities):" << endl;
+    for( size_t i = 0; i < min( NUM_TO_PRINT, byTime.size() ); ++i ) {
+        const MarketTotal& total = mMarketTotals.find( byTime[ i ].second )->second;
+        aOut << byTime[ i ].second << ", " << total.mWallTime << ", " << total.mEvaluations << ", "
+             << total.mActivities / total.mEvaluations << endl;
+    }
+}
+
+/*!
+ * \brief Print the partial derivative throughput of the threads on each NUMA
+ *        node.
+ * \details The throughput of a node is the number of partial derivatives per
+ *          second of wall time assuming all of the node's threads were busy
+ *          concurrently, which allows the scaling from one socket to the next
+ *          to be compared.  Nothing is printed if threads were not pinned.
+ * \param aOut The stream to write to.
+ */
+void JacobianProfiler::printNodeThroughput( ostream& aOut ) const {
+    if( mNodeTotals.empty() ) {
+        return;
+    }
+
+    aOut << "Jacobian throughput by NUMA node (node, threads, evaluations, evaluations per second):" << endl;
+    for( map<int, NodeTotal>::const_iterator it = mNodeTotals.begin(); it != mNodeTotals.end(); ++it ) {
+        const size_t numThreads = it->second.mThreads.size();
+        const NodeTotal& total = it->second;
+        aOut << it->first << ", " << numThreads << ", " << total.mEvaluations << ", "
+             << ( total.mWallTime > 0 ? total.mEvaluations * numThreads / total.mWallTime : 0.0 ) << endl;
+    }
+}
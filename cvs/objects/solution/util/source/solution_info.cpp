@@ -51,7 +51,13 @@
 
 using namespace std;
 
-//! Constructor
+/*!
+ * \brief Constructor.
+ * \param aLinkedMarket The market to solve.
+ * \param aDependencies The activities to recalculate when the price of the
+ *                      market changes, which are referenced rather than copied
+ *                      and so must outlive this object and all of its copies.
+ */
 #if GCAM_PARALLEL_ENABLED
 SolutionInfo::SolutionInfo( Market* aLinkedMarket, const vector<IActivity*>& aDependencies, GcamFlowGraph* aFlowGraph )
 #else
@@ -65,7 +71,7 @@ XL( 0 ),
 XR( 0 ),
 EDL( 0 ),
 EDR( 0 ),
-mDependencies( const_cast<vector<IActivity*>&>( aDependencies ) ),
+mDependencies( &aDependencies ),
 #if GCAM_PARALLEL_ENABLED
 mFlowGraph( aFlowGraph ),
 #endif
@@ -89,6 +95,34 @@ bool SolutionInfo::operator!=( const SolutionInfo& rhs ) const {
     return !( *this == rhs );
 }
 
+double SolutionInfo::sToleranceScale = 1.0;
+
+/*!
+ * \brief Set a factor by which the solution tolerance of every SolutionInfo
+ *        initialized from now on is multiplied.
+ * \details This is used to solve a period only approximately, for instance
+ *          when it is only used to start the next period speculatively.
+ * \param aScale The factor, one to use the configured tolerances.
+ */
+void SolutionInfo::setToleranceScale( const double aScale ) {
+    sToleranceScale = aScale;
+}
+
+double SolutionInfo::sHandoffToleranceFactor = 1.0;
+
+/*!
+ * \brief Set a factor by which the solution tolerance of every SolutionInfo
+ *        is multiplied when checking whether it is within tolerance.
+ * \details Unlike setToleranceScale this applies immediately to every
+ *          SolutionInfo already initialized.  It is used to let a solver
+ *          component hand off to the next once the markets are within a
+ *          looser tolerance and must be reset to one afterwards.
+ * \param aFactor The factor, one to use the configured tolerances.
+ */
+void SolutionInfo::setHandoffToleranceFactor( const double aFactor ) {
+    sHandoffToleranceFactor = aFactor;
+}
+
 /*!
  * \brief Initialize the SolutionInfo.
  * \details Initializes X, supply, and demand from the linked market.  We will use the solution info
@@ -110,8 +144,8 @@ void SolutionInfo::init( const double aDefaultSolutionTolerance, const double aD
     resetBrackets();
     
     // Initialize parameters from the solution info values if they are set
-    mSolutionTolerance = aSolutionInfoValues.mSolutionTolerance == 0 ?
-        aDefaultSolutionTolerance : aSolutionInfoValues.mSolutionTolerance;
+    mSolutionTolerance = sToleranceScale * ( aSolutionInfoValues.mSolutionTolerance == 0 ?
+        aDefaultSolutionTolerance : aSolutionInfoValues.mSolutionTolerance );
     mSolutionFloor = aSolutionInfoValues.mSolutionFloor == 0 ?
         aDefaultSolutionFloor : aSolutionInfoValues.mSolutionFloor;
     mBracketInterval = aSolutionInfoValues.mBracketInterval;
@@ -275,7 +309,7 @@ double SolutionInfo::getRelativeED() const {
 * \return Whether the market is within the solution tolerance. 
 */
 bool SolutionInfo::isWithinTolerance() const {
-    return ( getRelativeED() < mSolutionTolerance );
+    return ( getRelativeED() < mSolutionTolerance * sHandoffToleranceFactor );
 }
 
 //! Determine whether a SolutionInfo is solvable for the current method.
@@ -565,7 +599,7 @@ void SolutionInfo::printDerivatives( ostream& aOut ) const {
  * \return A list of items to recalculate when this solution info's price changes.
  */
 const vector<IActivity*>& SolutionInfo::getDependencies() const {
-    return mDependencies;
+    return *mDependencies;
 }
 
 /*!
@@ -600,17 +634,15 @@ double SolutionInfo::getUpperBoundSupplyPrice() const
 
 double SolutionInfo::getLowerBoundSupplyPriceInternal() const
 {
-    const string LOWER_BOUND_KEY = "lower-bound-supply-price";
-    return linkedMarket->getMarketInfo()->hasValue( LOWER_BOUND_KEY ) ?
-        linkedMarket->getMarketInfo()->getDouble( LOWER_BOUND_KEY, true ) :
+    return linkedMarket->getMarketInfo()->hasValue( InfoKeys::eLowerBoundSupplyPrice ) ?
+        linkedMarket->getMarketInfo()->getDouble( InfoKeys::eLowerBoundSupplyPrice, true ) :
         -util::getLargeNumber();
 }
 
 double SolutionInfo::getUpperBoundSupplyPriceInternal() const
 {
-    const string UPPER_BOUND_KEY = "upper-bound-supply-price";
-    return linkedMarket->getMarketInfo()->hasValue( UPPER_BOUND_KEY ) ?
-        linkedMarket->getMarketInfo()->getDouble( UPPER_BOUND_KEY, true ) :
+    return linkedMarket->getMarketInfo()->hasValue( InfoKeys::eUpperBoundSupplyPrice ) ?
+        linkedMarket->getMarketInfo()->getDouble( InfoKeys::eUpperBoundSupplyPrice, true ) :
         util::getLargeNumber();
 }
 
@@ -624,6 +656,48 @@ double SolutionInfo::getForecastDemand() const
     return linkedMarket->getForecastDemand();
 }
 
+/*!
+ * \brief Get the relative step size to use when computing finite difference
+ *        derivatives with respect to this market's price.
+ * \details The value is stored in the market so that it carries over between
+ *          iterations and periods.
+ * \return The step size, or zero if none has been chosen yet.
+ */
+double SolutionInfo::getJacobianStep() const
+{
+    return linkedMarket->getJacobianStep();
+}
+
+/*!
+ * \brief Set the relative finite difference step size for this market.
+ * \param aJacobianStep The new step size.
+ */
+void SolutionInfo::setJacobianStep( const double aJacobianStep )
+{
+    linkedMarket->setJacobianStep( aJacobianStep );
+}
+
+/*!
+ * \brief Get the derivative of log( demand / supply ) with respect to the
+ *        log of this market's price learned from the last solution.
+ * \details The value is stored in the market so that it carries over between
+ *          periods.
+ * \return The elasticity, or zero if none has been learned yet.
+ */
+double SolutionInfo::getLearnedElasticity() const
+{
+    return linkedMarket->getLearnedElasticity();
+}
+
+/*!
+ * \brief Set the learned elasticity of excess demand for this market.
+ * \param aElasticity The new elasticity.
+ */
+void SolutionInfo::setLearnedElasticity( const double aElasticity )
+{
+    linkedMarket->setLearnedElasticity( aElasticity );
+}
+
 int SolutionInfo::getSerialNumber( void ) const
 {
     return linkedMarket->getSerialNumber();
@@ -40,6 +40,8 @@
 #include "util/base/include/definitions.h"
 #include <cassert>
 #include <algorithm>
+#include <utility>
+#include <iterator>
 #include "util/base/include/util.h"
 #include "solution/util/include/solution_info_set.h"
 #include "solution/util/include/solution_info.h"
@@ -54,6 +56,11 @@
 
 using namespace std;
 
+namespace {
+    //! The activities to calculate for markets which are not solvable.
+    const vector<IActivity*> NO_DEPENDENCIES;
+}
+
 //! Constructor
 SolutionInfoSet::SolutionInfoSet( Marketplace* aMarketplace ):
 period( 0 ),
@@ -98,7 +105,7 @@ void SolutionInfoSet::init( const unsigned int aPeriod, const double aDefaultSol
     for( ConstMarketIterator iter = marketsToSolve.begin(); iter != marketsToSolve.end(); ++iter ){
         const bool isSolvable = (*iter)->isSolvable();
         const int marketNumber = iter - marketsToSolve.begin();
-        const vector<IActivity*> partialList = isSolvable ? depFinder->getOrdering( marketNumber ) : vector<IActivity*>();
+        const vector<IActivity*>& partialList = isSolvable ? depFinder->getOrdering( marketNumber ) : NO_DEPENDENCIES;
 #if GCAM_PARALLEL_ENABLED
         // TODO: As it turns out the extra time generating these graphs does not typically
         // get paid back in terms of time saved while calculating partial derivatives.  At
@@ -113,10 +120,10 @@ void SolutionInfoSet::init( const unsigned int aPeriod, const double aDefaultSol
                        aSolutionInfoParamParser->getSolutionInfoValuesForMarket( (*iter)->getGoodName(), (*iter)->getRegionName(),
                                                                                  currInfo.getTypeName(), period ) );
         if( currInfo.shouldSolve( false ) ){
-            solvable.push_back( currInfo );
+            solvable.push_back( std::move( currInfo ) );
         }
         else {
-            unsolvable.push_back( currInfo );
+            unsolvable.push_back( std::move( currInfo ) );
         }
     }
 }
@@ -131,38 +138,39 @@ SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfo
     solverLog.setLevel( ILogger::DEBUG );
     solverLog << "Updating the solvable set." << endl;
 
+    // Partition the markets in a single pass over each set, moving rather than
+    // copying each SolutionInfo and preserving the order of both sets.  Markets
+    // which became solvable are added after the markets which remain solvable,
+    // and markets which became unsolvable after those which remain unsolvable.
+    vector<SolutionInfo> newSolvable;
+    vector<SolutionInfo> newUnsolvable;
+    vector<SolutionInfo> removed;
+    newSolvable.reserve( solvable.size() + unsolvable.size() );
+    newUnsolvable.reserve( solvable.size() + unsolvable.size() );
+
     // Iterate through the solvable markets and determine if any are now unsolvable.
-    for( SetIterator iter = solvable.begin(); iter != solvable.end(); ){
+    for( SetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ){
         // If it should not be solved for the current method, move it to the unsolvable vector.
         if( !aSolutionInfoFilter->acceptSolutionInfo( *iter ) ){
-            unsolvable.push_back( *iter );
-
             // Print a debugging log message.
             solverLog << iter->getName() << " was removed from the solvable set." << endl;
-
-            // After the erase, iter will point to the next element in the array
-            iter = solvable.erase( iter );
+            removed.push_back( std::move( *iter ) );
 
             // Update the return code.
             code = REMOVED;
         }
         else{
-            // If we don't erase an element, we need to increment iter
-            ++iter;
+            newSolvable.push_back( std::move( *iter ) );
         }
     }
 
     // Loop through the unsolvable set to see if they should be added to the solved. 
-    // This will double check markets that were just added, slightly inefficient.
-    for( SetIterator iter = unsolvable.begin(); iter != unsolvable.end(); ){
+    for( SetIterator iter = unsolvable.begin(); iter != unsolvable.end(); ++iter ){
         // If it should be solved for the current method, move it to the solvable vector.
         if( aSolutionInfoFilter->acceptSolutionInfo( *iter ) ){
-            solvable.push_back( *iter );
             // Print a debugging log message.
             solverLog << iter->getName() << " was added to the solvable set." << endl;
-
-            // After the erase, iter will point to the next element in the array
-            iter = unsolvable.erase( iter );
+            newSolvable.push_back( std::move( *iter ) );
 
             // Update return code.
             if( code == UNCHANGED || ADDED ){
@@ -173,10 +181,13 @@ SolutionInfoSet::UpdateCode SolutionInfoSet::updateSolvable( const ISolutionInfo
             }
         }
         else{
-            // If we don't erase an element, we need to increment iter
-            ++iter;
+            newUnsolvable.push_back( std::move( *iter ) );
         }
     }
+    std::move( removed.begin(), removed.end(), back_inserter( newUnsolvable ) );
+
+    solvable.swap( newSolvable );
+    unsolvable.swap( newUnsolvable );
     return code;
 }
 
@@ -349,7 +360,7 @@ bool SolutionInfoSet::isAllBracketed() const {
 }
 
 //! Return the demands of all SolutionInfo's.
-const vector<double> SolutionInfoSet::getDemands() const {
+vector<double> SolutionInfoSet::getDemands() const {
     vector<double> demands;
     for( ConstSetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ){
         demands.push_back( iter->getDemand() );
@@ -361,7 +372,7 @@ const vector<double> SolutionInfoSet::getDemands() const {
 }
 
 //! Return the supplies of all SolutionInfo's.
-const vector<double> SolutionInfoSet::getSupplies() const {
+vector<double> SolutionInfoSet::getSupplies() const {
     vector<double> supplies;
     for( ConstSetIterator iter = solvable.begin(); iter != solvable.end(); ++iter ){
         supplies.push_back( iter->getSupply() );
@@ -389,12 +400,12 @@ const SolutionInfo& SolutionInfoSet::getSolvable( unsigned int index ) const {
 }
 
 //! Get the solvable set (may not be solved).
-vector<SolutionInfo> SolutionInfoSet::getSolvableSet() const{
+const vector<SolutionInfo>& SolutionInfoSet::getSolvableSet() const{
     return solvable;
 }
 
 //! Get the unsolvable set
-vector<SolutionInfo> SolutionInfoSet::getUnsolvableSet() const {
+const vector<SolutionInfo>& SolutionInfoSet::getUnsolvableSet() const {
     return unsolvable;
 }
 
@@ -61,10 +61,20 @@
 #include "solution/util/include/calc_counter.h"
 #include "util/logger/include/ilogger.h"
 #include "solution/util/include/ublas-helpers.hpp"
+#include "solution/util/include/dense_lu.hpp"
 #include "containers/include/iactivity.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/manage_state_variables.hpp"
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/parallel_for.h>
+#endif
 
 using namespace std;
 
+extern Scenario* scenario;
+
 #define NO_REGIONAL_DERIVATIVES 0
 
 /*! \brief Calculate and return a relative excess demand.
@@ -227,9 +237,9 @@ bool SolverLibrary::calculateNewPricesLogNR( SolutionInfoSet& aSolutionSet, Matr
     
     
     // to solve JF(Xn) * ( Xn+1 - Xn ) = -F(Xn) we use lu substitution which
-    // is favorable to calculating the inverse of JF.  lu_substitue will leave
+    // is favorable to calculating the inverse of JF.  denseLUSubstitute will leave
     // us with ( Xn+1 - Xn ) stored in KDS
-    lu_substitute( JFLUFactorized, aPermMatrix, KDS );
+    denseLUSubstitute( JFLUFactorized, aPermMatrix, KDS );
     solverLog << "dx: " << KDS << "\n";
     
     // To calculate the new price Xn+1 we do Xn+1 = Xn + KDS
@@ -281,7 +291,7 @@ bool SolverLibrary::calculateNewPricesLogNR( SolutionInfoSet& aSolutionSet, Matr
 /*! \brief Calculate the LU factorization of a matrix using partial pivoting.
  * \author Pralit Patel
  * \details This function changes an input matrix to an LU factorizated version and also
- *          produces a permutation matrix. This can be used in conjunction with lu_substitue
+ *          produces a permutation matrix. This can be used in conjunction with denseLUSubstitute
  *          to solve a set of equations of the form Ax=b and is less computationaly intensive
  *          than finding the inverse of A and multiplying that by b.
  *          This function also checks if the matrix is singular in which case garbage may
@@ -293,15 +303,10 @@ bool SolverLibrary::calculateNewPricesLogNR( SolutionInfoSet& aSolutionSet, Matr
  *          is singular in which case the contents of the matrix and permutation matrix will be garbage.
  */
 bool SolverLibrary::luFactorizeMatrix( Matrix& aInputMatrix, PermutationMatrix& aPermMatrix ) {
-    using namespace boost::numeric::ublas;
-    
-    // need to reset the permutation matrix
-    PermutationMatrix tempPerm( aInputMatrix.size1() );
-    aPermMatrix.assign( tempPerm );
-    
-    // do the LU-factorization, the return value is the singular row + 1
-    // and so if the return value is 0 there were no singularities
-    return lu_factorize( aInputMatrix, aPermMatrix ) != 0;
+    // do the LU-factorization, using LAPACK if it is available. The return
+    // value is the singular row + 1 and so if the return value is 0 there were
+    // no singularities
+    return denseLUFactorize( aInputMatrix, aPermMatrix ) != 0;
 }
 
 /*! \brief Bracket a set of markets.
@@ -317,11 +322,15 @@ bool SolverLibrary::luFactorizeMatrix( Matrix& aInputMatrix, PermutationMatrix&
 * \param aSolutionSet Vector of market solution information
 * \param aCalcCounter The calculation counter.
 * \param aPeriod Model period
+* \param aIndependentProbes Whether to first expand the bracket of each unbracketed
+*                           market independently of the others, several markets at
+*                           a time, using bracketIndependent.
 * \return Whether bracketing of all markets completed successfully.
 */
 bool SolverLibrary::bracket( Marketplace* aMarketplace, World* aWorld, const double aDefaultBracketInterval,
                              const unsigned int aMaxIterations, SolutionInfoSet& aSolutionSet, CalcCounter* aCalcCounter,
-                             const ISolutionInfoFilter* aSolutionInfoFilter, const int aPeriod )
+                             const ISolutionInfoFilter* aSolutionInfoFilter, const int aPeriod,
+                             const bool aIndependentProbes )
 {
     bool code = false;
     static const double LOWER_BOUND = util::getVerySmallNumber();
@@ -351,6 +360,27 @@ bool SolverLibrary::bracket( Marketplace* aMarketplace, World* aWorld, const dou
         return true;
     }
 
+    if( aIndependentProbes ) {
+        bracketIndependent( aMarketplace, aWorld, aDefaultBracketInterval, aMaxIterations,
+                            aSolutionSet, aPeriod );
+        // The probes did not account for the interactions between markets so
+        // recalculate at the new prices and let the loop below check them.
+        aMarketplace->nullSuppliesAndDemands( aPeriod );
+#if GCAM_PARALLEL_ENABLED
+        aWorld->calc( aPeriod, aWorld->getGlobalFlowGraph() );
+#else
+        aWorld->calc( aPeriod );
+#endif
+        aSolutionSet.updateSolvable( aSolutionInfoFilter );
+        solverLog.setLevel( ILogger::NOTICE );
+        solverLog << "Completed independent bracketing probes." << endl;
+        solverLog.setLevel( ILogger::DEBUG );
+        solverLog << aSolutionSet << endl;
+        if( aSolutionSet.isAllBracketed() ) {
+            return true;
+        }
+    }
+
     ILogger& singleLog = ILogger::getLogger( "single_market_log" );
 
     // Loop is done at least once.
@@ -466,6 +496,123 @@ bool SolverLibrary::bracket( Marketplace* aMarketplace, World* aWorld, const dou
     return code;
 }
 
+/*!
+ * \brief Expand the brackets of each unbracketed market holding all other
+ *        prices fixed, probing several markets at once.
+ * \details Each probe changes the price of a single market and so only needs
+ *          to recalculate the activities which depend on that market, exactly
+ *          as for a partial derivative.  The probes are therefore run in the
+ *          "scratch" state space managed by ManageStateVariables and, when
+ *          GCAM_PARALLEL_ENABLED, each market is probed on its own thread with
+ *          its own state slot.  The bracket expansion for a market follows the
+ *          same rules as in bracket, but continues until that market is
+ *          bracketed or aMaxIterations probes have been made.  On return the
+ *          "base" state prices have been set to the final trial price of each
+ *          market; the caller is responsible for recalculating the model at
+ *          those prices since the brackets found ignore the effect markets
+ *          have on one another.
+ * \param aMarketplace Marketplace reference.
+ * \param aWorld World reference.
+ * \param aDefaultBracketInterval The default bracket interval.
+ * \param aMaxIterations The maximum number of probes for each market.
+ * \param aSolutionSet Vector of market solution information which is assumed
+ *                     to be up to date with the "base" state.
+ * \param aPeriod Model period
+ */
+void SolverLibrary::bracketIndependent( Marketplace* aMarketplace, World* aWorld, const double aDefaultBracketInterval,
+                                        const unsigned int aMaxIterations, SolutionInfoSet& aSolutionSet,
+                                        const int aPeriod )
+{
+    static const double LOWER_BOUND = util::getVerySmallNumber();
+
+    vector<SolutionInfo*> unbracketed;
+    for( unsigned int i = 0; i < aSolutionSet.getNumSolvable(); ++i ) {
+        SolutionInfo& currSol = aSolutionSet.getSolvable( i );
+        if( !currSol.isBracketed() && !currSol.getDependencies().empty() ) {
+            unbracketed.push_back( &currSol );
+        }
+    }
+    if( unbracketed.empty() ) {
+        return;
+    }
+
+    vector<double> trialPrices( unbracketed.size() );
+    ManageStateVariables* stateVars = scenario->getManageStateVariables();
+    aMarketplace->mIsDerivativeCalc = true;
+    stateVars->setPartialDeriv( true );
+
+    auto probeMarket = [&]( const size_t aIndex ) {
+        SolutionInfo* currSol = unbracketed[ aIndex ];
+        const double currBracketInterval = currSol->getBracketInterval( aDefaultBracketInterval );
+
+        // Start from the "base" state in this thread's scratch space.
+        stateVars->copyState();
+        unsigned int numProbes = 0;
+        do {
+            // Same special case as in bracket.
+            if( fabs( currSol->getSupply() ) < util::getSmallNumber() &&
+                fabs( currSol->getDemand() ) < util::getSmallNumber() )
+            {
+                currSol->setBracketed();
+                break;
+            }
+            if ( util::sign( currSol->getED() ) == util::sign( currSol->getEDLeft() ) ) {
+                if ( currSol->getED() < 0 ) {
+                    currSol->moveRightBracketToX();
+                    currSol->decreaseX( currBracketInterval, LOWER_BOUND );
+                }
+                else {
+                    currSol->moveLeftBracketToX();
+                    currSol->increaseX( currBracketInterval, LOWER_BOUND );
+                }
+            }
+            else {
+                if ( currSol->getED() < 0 ) {
+                    currSol->moveRightBracketToX();
+                }
+                else {
+                    currSol->moveLeftBracketToX();
+                }
+            }
+            if( currSol->isCurrentlyBracketed() ){
+                currSol->setBracketed();
+                break;
+            }
+
+            // Reset the scratch space and calculate only the activities affected
+            // by this market at the new trial price.
+            const double trialPrice = currSol->getPrice();
+            stateVars->copyState();
+            currSol->setPrice( trialPrice );
+            aWorld->calc( aPeriod, currSol->getDependencies() );
+        } while( ++numProbes < aMaxIterations );
+
+        trialPrices[ aIndex ] = currSol->getPrice();
+    };
+
+#if !GCAM_PARALLEL_ENABLED
+    for( size_t i = 0; i < unbracketed.size(); ++i ) {
+        probeMarket( i );
+    }
+#else
+    tbb::task_arena& threadPool = stateVars->mThreadPool;
+    tbb::task_group tg;
+    threadPool.execute( [&] () {
+        tg.run( [&] () {
+            tbb::parallel_for( size_t( 0 ), unbracketed.size(), probeMarket );
+        } );
+    } );
+    threadPool.execute( [&tg] () { tg.wait(); } );
+#endif
+
+    // Switch back to the "base" state and set the trial prices into it.
+    aMarketplace->mIsDerivativeCalc = false;
+    stateVars->setPartialDeriv( false );
+    for( size_t i = 0; i < unbracketed.size(); ++i ) {
+        unbracketed[ i ]->setPrice( trialPrices[ i ] );
+    }
+}
+
 /*
  * \brief Function finds bracket interval for a single market.
  * \author Josh Lurz
@@ -581,6 +728,7 @@ bool SolverLibrary::bracketOne( Marketplace* aMarketplace, World* aWorld, const
 */
 vector<double> SolverLibrary::storePrices( const SolutionInfoSet& aSolutionSet ){
     vector<double> storedPrices;
+    storedPrices.reserve( aSolutionSet.getNumTotal() );
     for( unsigned int i = 0; i < aSolutionSet.getNumTotal(); ++i ){
         storedPrices.push_back( aSolutionSet.getAny( i ).getPrice() );
     }
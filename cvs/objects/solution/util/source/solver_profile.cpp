@@ -0,0 +1,202 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file solver_profile.cpp
+* \ingroup Solution
+* \brief SolverProfile class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+
+#include "solution/util/include/solver_profile.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+//! Constructor
+SolverProfile::Runs::Runs():
+mNumRuns( 0 ),
+mNumSolved( 0 ),
+mSolvedCalcs( 0 )
+{
+}
+
+//! Constructor
+SolverProfile::SolverProfile():
+mEnabled( false )
+{
+    const Configuration* conf = Configuration::getInstance();
+    if( !conf->shouldWriteFile( "solver-profile", false, false ) ) {
+        return;
+    }
+    mFileName = conf->getFile( "solver-profile" );
+
+    // The regular solver is always one of the alternatives.
+    mAlternatives.push_back( "" );
+    const string configList = conf->getFile( "profile-solver-configs", "", false );
+    vector<string> configFiles;
+    boost::split( configFiles, configList, boost::is_any_of( ";" ), boost::token_compress_on );
+    for( vector<string>::const_iterator fileIt = configFiles.begin(); fileIt != configFiles.end(); ++fileIt ) {
+        const string configFile = boost::trim_copy( *fileIt );
+        if( !configFile.empty() ) {
+            mAlternatives.push_back( configFile );
+        }
+    }
+    mEnabled = true;
+
+    // Read the runs recorded so far, a missing file is an empty profile.
+    ifstream in( mFileName.c_str() );
+    string line;
+    int numInvalid = 0;
+    while( getline( in, line ) ) {
+        vector<string> columns;
+        boost::split( columns, line, boost::is_any_of( "," ) );
+        if( columns.size() != 4 || columns[ 0 ] == "year" ) {
+            continue;
+        }
+        try {
+            Runs& runs = mRuns[ make_pair( boost::lexical_cast<int>( columns[ 0 ] ), columns[ 1 ] ) ];
+            ++runs.mNumRuns;
+            if( columns[ 3 ] == "1" ) {
+                ++runs.mNumSolved;
+                runs.mSolvedCalcs += boost::lexical_cast<double>( columns[ 2 ] );
+            }
+        }
+        catch( const boost::bad_lexical_cast& ) {
+            ++numInvalid;
+        }
+    }
+    if( numInvalid > 0 ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Skipped " << numInvalid << " invalid lines of the solver profile " << mFileName << "." << endl;
+    }
+}
+
+/*!
+ * \brief Get the singleton instance of the SolverProfile.
+ * \return The SolverProfile.
+ */
+SolverProfile& SolverProfile::getInstance() {
+    static SolverProfile SOLVER_PROFILE;
+    return SOLVER_PROFILE;
+}
+
+/*!
+ * \brief Whether solver configurations are being chosen from the profile.
+ * \return True if the solver profile is enabled.
+ */
+bool SolverProfile::isEnabled() const {
+    return mEnabled;
+}
+
+/*!
+ * \brief Get the solver configuration files to choose from.
+ * \return The configuration files, the first of which is empty for the
+ *         regular solver.
+ */
+const vector<string>& SolverProfile::getAlternatives() const {
+    return mAlternatives;
+}
+
+/*!
+ * \brief Choose the solver configuration to solve a year with.
+ * \details The first configuration with no recorded runs for the year is
+ *          chosen, otherwise the one which solved with fewest world calcs on
+ *          average. If none has ever solved the year the regular solver is
+ *          used.
+ * \param aYear The year to solve.
+ * \return The index of the chosen configuration in getAlternatives.
+ */
+size_t SolverProfile::chooseAlternative( const int aYear ) const {
+    size_t best = 0;
+    double bestCalcs = -1;
+    for( size_t i = 0; i < mAlternatives.size(); ++i ) {
+        map<pair<int, string>, Runs>::const_iterator runsIt = mRuns.find( make_pair( aYear, mAlternatives[ i ] ) );
+        if( runsIt == mRuns.end() ) {
+            return i;
+        }
+        if( runsIt->second.mNumSolved > 0 ) {
+            const double meanCalcs = runsIt->second.mSolvedCalcs / runsIt->second.mNumSolved;
+            if( bestCalcs < 0 || meanCalcs < bestCalcs ) {
+                best = i;
+                bestCalcs = meanCalcs;
+            }
+        }
+    }
+    return best;
+}
+
+/*!
+ * \brief Record a run of a solver configuration in the profile.
+ * \details The run is appended to the profile file immediately so that it is
+ *          kept even if the model does not finish.
+ * \param aYear The year which was solved.
+ * \param aAlternative The index of the configuration in getAlternatives.
+ * \param aWorldCalcs The number of world calcs the solve took.
+ * \param aSolved Whether the year solved.
+ */
+void SolverProfile::record( const int aYear, const size_t aAlternative, const int aWorldCalcs,
+                            const bool aSolved )
+{
+    if( !mEnabled || aAlternative >= mAlternatives.size() ) {
+        return;
+    }
+    Runs& runs = mRuns[ make_pair( aYear, mAlternatives[ aAlternative ] ) ];
+    ++runs.mNumRuns;
+    if( aSolved ) {
+        ++runs.mNumSolved;
+        runs.mSolvedCalcs += aWorldCalcs;
+    }
+
+    ifstream existing( mFileName.c_str() );
+    const bool writeHeader = !existing.good() || existing.peek() == ifstream::traits_type::eof();
+    existing.close();
+    ofstream out( mFileName.c_str(), ios::out | ios::app );
+    if( !out.is_open() ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write to the solver profile " << mFileName << "." << endl;
+        return;
+    }
+    if( writeHeader ) {
+        out << "year,solver-config,world-calcs,solved" << endl;
+    }
+    out << aYear << ',' << mAlternatives[ aAlternative ] << ',' << aWorldCalcs << ','
+        << ( aSolved ? 1 : 0 ) << endl;
+}
@@ -0,0 +1,162 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file solver_telemetry.cpp
+* \ingroup Solution
+* \brief SolverTelemetry class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cmath>
+
+#include "solution/util/include/solver_telemetry.h"
+#include "solution/util/include/solution_info_set.h"
+#include "solution/util/include/solution_info.h"
+#include "solution/util/include/calc_counter.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    /*!
+     * \brief Write a number as a JSON value, null if it is not finite.
+     */
+    void writeJSONNumber( ostream& aOut, const double aValue ) {
+        if( std::isfinite( aValue ) ) {
+            aOut << aValue;
+        }
+        else {
+            aOut << "null";
+        }
+    }
+}
+
+//! Constructor
+SolverTelemetry::SolverTelemetry():
+mEnabled( false ),
+mPeriod( -1 ),
+mYear( -1 ),
+mSolutionSet( 0 ),
+mCalcCounter( 0 )
+{
+    const Configuration* conf = Configuration::getInstance();
+    if( conf->shouldWriteFile( "solver-telemetry", false, false ) ) {
+        const string& fileName = conf->getFile( "solver-telemetry" );
+        mFile.open( fileName.c_str() );
+        mEnabled = mFile.is_open();
+        if( !mEnabled ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not open the solver telemetry file " << fileName << "." << endl;
+        }
+        mFile.precision( 8 );
+    }
+}
+
+/*!
+ * \brief Get the singleton instance of the SolverTelemetry.
+ * \return The SolverTelemetry.
+ */
+SolverTelemetry& SolverTelemetry::getInstance() {
+    static SolverTelemetry SOLVER_TELEMETRY;
+    return SOLVER_TELEMETRY;
+}
+
+/*!
+ * \brief Whether solver iterations are being written.
+ * \return True if the telemetry file is open.
+ */
+bool SolverTelemetry::isEnabled() const {
+    return mEnabled;
+}
+
+/*!
+ * \brief Start timing a new period.
+ * \param aPeriod The model period about to be solved.
+ * \param aYear The year of the period.
+ */
+void SolverTelemetry::startPeriod( const int aPeriod, const int aYear ) {
+    mPeriod = aPeriod;
+    mYear = aYear;
+    mPeriodStart = chrono::steady_clock::now();
+    mSolutionSet = 0;
+    mCalcCounter = 0;
+}
+
+/*!
+ * \brief Set the solver component whose iterations will be recorded.
+ * \param aName The name of the component.
+ * \param aSolutionSet The solution set the component is solving which must
+ *        remain valid until the next call.
+ * \param aCalcCounter The world calc counter.
+ */
+void SolverTelemetry::startComponent( const string& aName, const SolutionInfoSet& aSolutionSet,
+                                      const CalcCounter* aCalcCounter )
+{
+    mComponentName = aName;
+    mSolutionSet = &aSolutionSet;
+    mCalcCounter = aCalcCounter;
+}
+
+/*!
+ * \brief Write an iteration of the active solver component.
+ * \param aIteration The component's iteration count.
+ * \param aStepSize The size of the step taken in the iteration, NaN if the
+ *        component does not take steps.
+ */
+void SolverTelemetry::recordIteration( const int aIteration, const double aStepSize ) {
+    if( !mEnabled || !mSolutionSet ) {
+        return;
+    }
+    unsigned int numUnsolved = 0;
+    for( unsigned int i = 0; i < mSolutionSet->getNumSolvable(); ++i ) {
+        if( !mSolutionSet->getSolvable( i ).isSolved() ) {
+            ++numUnsolved;
+        }
+    }
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - mPeriodStart;
+
+    mFile << "{ \"period\": " << mPeriod
+          << ", \"year\": " << mYear
+          << ", \"component\": \"" << mComponentName << "\""
+          << ", \"iteration\": " << aIteration
+          << ", \"max-relative-ed\": ";
+    writeJSONNumber( mFile, mSolutionSet->getMaxRelativeExcessDemand() );
+    mFile << ", \"unsolved\": " << numUnsolved
+          << ", \"world-calcs\": " << ( mCalcCounter ? mCalcCounter->getPeriodCount() : 0 )
+          << ", \"elapsed-seconds\": " << elapsed.count()
+          << ", \"step\": ";
+    writeJSONNumber( mFile, aStepSize );
+    mFile << " }" << endl;
+}
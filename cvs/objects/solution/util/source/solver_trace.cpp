@@ -0,0 +1,177 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file solver_trace.cpp
+* \ingroup Solution
+* \brief SolverTrace class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <algorithm>
+#include <cstdint>
+
+#include "solution/util/include/solver_trace.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+//! The identifier at the start of each trace file.
+static const char TRACE_MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'S', 'T', 'R', 'C' };
+
+//! The version of the trace file format.
+static const uint32_t TRACE_VERSION = 1;
+
+//! Constructor
+SolverTrace::SolverTrace():
+mEnabled( false ),
+mPeriod( -1 ),
+mNumRecorded( 0 )
+{
+    const Configuration* conf = Configuration::getInstance();
+    const int numIterations = conf->getInt( "solver-trace-iterations", 32 );
+    mEnabled = numIterations > 0 && conf->shouldWriteFile( "solver-trace-location", false, false );
+    if( mEnabled ) {
+        mIterations.resize( numIterations );
+    }
+}
+
+/*!
+ * \brief Get the singleton instance of the SolverTrace.
+ * \return The SolverTrace.
+ */
+SolverTrace& SolverTrace::getInstance() {
+    static SolverTrace SOLVER_TRACE;
+    return SOLVER_TRACE;
+}
+
+/*!
+ * \brief Whether solver iterations are being recorded.
+ * \return True if the trace is to be written for failed periods.
+ */
+bool SolverTrace::isEnabled() const {
+    return mEnabled;
+}
+
+/*!
+ * \brief Discard the iterations recorded so far and start recording a new
+ *        period.
+ * \param aPeriod The model period about to be solved.
+ */
+void SolverTrace::startPeriod( const int aPeriod ) {
+    mPeriod = aPeriod;
+    mNumRecorded = 0;
+}
+
+/*!
+ * \brief Record a solver iteration, replacing the oldest one if the buffer
+ *        is full.
+ * \param aIteration The solver's iteration count.
+ * \param aMarketIDs The ids of the markets being solved.
+ * \param aPrevX The prices at the start of the iteration.
+ * \param aX The prices at the end of the iteration.
+ * \param aFX The excess demands at aX.
+ */
+void SolverTrace::record( const int aIteration, const vector<int>& aMarketIDs,
+                          const boost::numeric::ublas::vector<double>& aPrevX,
+                          const boost::numeric::ublas::vector<double>& aX,
+                          const boost::numeric::ublas::vector<double>& aFX )
+{
+    if( !mEnabled ) {
+        return;
+    }
+    Iteration& iteration = mIterations[ mNumRecorded % mIterations.size() ];
+    ++mNumRecorded;
+
+    // Assigning keeps the capacity of the vectors so that once the buffer has
+    // wrapped around nothing is allocated.
+    const size_t size = aX.size();
+    iteration.mIteration = aIteration;
+    iteration.mMarketIDs.assign( aMarketIDs.begin(), aMarketIDs.end() );
+    iteration.mX.assign( aX.begin(), aX.end() );
+    iteration.mFX.resize( size );
+    iteration.mDX.resize( size );
+    for( size_t i = 0; i < size; ++i ) {
+        iteration.mFX[ i ] = static_cast<float>( aFX[ i ] );
+        iteration.mDX[ i ] = static_cast<float>( aX[ i ] - aPrevX[ i ] );
+    }
+}
+
+/*!
+ * \brief Write the recorded iterations of the period to
+ *        <solver-trace-location>/<scenario>.<year>.solver-trace.
+ * \param aScenarioName The name of the scenario.
+ * \param aYear The year of the period which was recorded.
+ * \return Whether the trace was written.
+ */
+bool SolverTrace::write( const string& aScenarioName, const int aYear ) const {
+    if( !mEnabled ) {
+        return false;
+    }
+    const string fileName = Configuration::getInstance()->getFile( "solver-trace-location" )
+                            + "/" + aScenarioName + "." + util::toString( aYear ) + ".solver-trace";
+    ofstream out( fileName.c_str(), ios::out | ios::binary | ios::trunc );
+
+    const size_t numIterations = min( mNumRecorded, mIterations.size() );
+    const int32_t period = mPeriod;
+    const uint32_t numStored = static_cast<uint32_t>( numIterations );
+    out.write( TRACE_MAGIC, sizeof( TRACE_MAGIC ) );
+    out.write( reinterpret_cast<const char*>( &TRACE_VERSION ), sizeof( TRACE_VERSION ) );
+    out.write( reinterpret_cast<const char*>( &period ), sizeof( period ) );
+    out.write( reinterpret_cast<const char*>( &numStored ), sizeof( numStored ) );
+    for( size_t i = mNumRecorded - numIterations; i < mNumRecorded; ++i ) {
+        const Iteration& iteration = mIterations[ i % mIterations.size() ];
+        const int32_t iterationNum = iteration.mIteration;
+        const uint32_t size = static_cast<uint32_t>( iteration.mX.size() );
+        out.write( reinterpret_cast<const char*>( &iterationNum ), sizeof( iterationNum ) );
+        out.write( reinterpret_cast<const char*>( &size ), sizeof( size ) );
+        for( size_t j = 0; j < size; ++j ) {
+            const int32_t id = j < iteration.mMarketIDs.size() ? iteration.mMarketIDs[ j ] : -1;
+            out.write( reinterpret_cast<const char*>( &id ), sizeof( id ) );
+        }
+        out.write( reinterpret_cast<const char*>( iteration.mX.data() ), sizeof( double ) * size );
+        out.write( reinterpret_cast<const char*>( iteration.mFX.data() ), sizeof( float ) * size );
+        out.write( reinterpret_cast<const char*>( iteration.mDX.data() ), sizeof( float ) * size );
+    }
+    out.close();
+    const bool success = !out.fail();
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( success ? ILogger::NOTICE : ILogger::ERROR );
+    mainLog << ( success ? "Wrote the last " : "Failed to write the last " ) << numIterations
+            << " solver iterations to " << fileName << "." << endl;
+    return success;
+}
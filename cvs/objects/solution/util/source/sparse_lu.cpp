@@ -0,0 +1,282 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*!
+ * \file sparse_lu.cpp
+ * \ingroup Solution
+ * \brief SparseLU class source file.
+ */
+
+#include <cmath>
+#include <boost/numeric/ublas/vector.hpp>
+
+#include "solution/util/include/sparse_lu.hpp"
+
+#define UBVECTOR boost::numeric::ublas::vector<double>
+
+using namespace std;
+
+/*!
+ * \brief Constructor.
+ * \param aPivotTol The threshold relative to the largest candidate pivot at
+ *                  which the diagonal will still be chosen as the pivot.  A
+ *                  value of one gives conventional partial pivoting.
+ */
+SparseLU::SparseLU( const double aPivotTol ):
+mPivotTol( aPivotTol ),
+mN( 0 )
+{
+}
+
+/*!
+ * \brief Find the nonzero pattern of L \ A(:,aCol).
+ * \details Performs a depth first search through the graph of the partially
+ *          computed L starting from each nonzero in column aCol of A.  The
+ *          result is left in aStack[ top ] to aStack[ mN - 1 ] in topological
+ *          order so that the triangular solve may be done in a single pass.
+ * \param aCol The column of A.
+ * \param aStack Output stack of size mN.
+ * \param aPStack Working space of size mN.
+ * \param aDFSStack Working space of size mN.
+ * \param aMarked Working space of size mN which must be all zero on entry and
+ *                will be reset to zero on exit.
+ * \return The position of the top of aStack.
+ */
+int SparseLU::reach( const int aCol, vector<int>& aStack, vector<int>& aPStack,
+                     vector<int>& aDFSStack, vector<char>& aMarked ) const
+{
+    int top = mN;
+    for( int p = mAp[ aCol ]; p < mAp[ aCol + 1 ]; ++p ) {
+        if( aMarked[ mAi[ p ] ] ) {
+            continue;
+        }
+        int head = 0;
+        aDFSStack[ 0 ] = mAi[ p ];
+        while( head >= 0 ) {
+            const int node = aDFSStack[ head ];
+            // Rows which have not yet been chosen as a pivot have no column in L.
+            const int col = mPinv[ node ];
+            if( !aMarked[ node ] ) {
+                aMarked[ node ] = 1;
+                aPStack[ head ] = col < 0 ? 0 : mLp[ col ];
+            }
+            bool done = true;
+            const int pEnd = col < 0 ? 0 : mLp[ col + 1 ];
+            for( int pL = aPStack[ head ]; pL < pEnd; ++pL ) {
+                const int row = mLi[ pL ];
+                if( aMarked[ row ] ) {
+                    continue;
+                }
+                // Suspend the search at this node and descend to the next.
+                aPStack[ head ] = pL;
+                aDFSStack[ ++head ] = row;
+                done = false;
+                break;
+            }
+            if( done ) {
+                --head;
+                aStack[ --top ] = node;
+            }
+        }
+    }
+    for( int p = top; p < mN; ++p ) {
+        aMarked[ aStack[ p ] ] = 0;
+    }
+    return top;
+}
+
+/*!
+ * \brief Factor the matrix currently stored in mAp, mAi, and mAx.
+ * \details Left-looking L-U factorization with threshold partial pivoting.
+ *          Columns are processed in their natural order which for the
+ *          Jacobians we are interested in, with large diagonal entries and
+ *          mostly local coupling, keeps fill-in low.
+ * \return Zero if successful, otherwise one plus the index of the column at
+ *         which the matrix was found to be singular.
+ */
+int SparseLU::factorize() {
+    mUpdateZ.clear();
+    mUpdateV.clear();
+    mUpdateDenom.clear();
+
+    mLp.assign( mN + 1, 0 );
+    mUp.assign( mN + 1, 0 );
+    mLi.clear();
+    mLx.clear();
+    mUi.clear();
+    mUx.clear();
+    mPinv.assign( mN, -1 );
+
+    // guess the fill-in to avoid repeated reallocation
+    mLi.reserve( 2 * mAx.size() + mN );
+    mLx.reserve( 2 * mAx.size() + mN );
+    mUi.reserve( 2 * mAx.size() + mN );
+    mUx.reserve( 2 * mAx.size() + mN );
+
+    vector<double> x( mN, 0.0 );
+    vector<int> stack( mN );
+    vector<int> pstack( mN );
+    vector<int> dfsStack( mN );
+    vector<char> marked( mN, 0 );
+    for( int k = 0; k < mN; ++k ) {
+        mLp[ k ] = mLx.size();
+        mUp[ k ] = mUx.size();
+
+        // Sparse triangular solve x = L \ A(:,k)
+        const int top = reach( k, stack, pstack, dfsStack, marked );
+        for( int p = mAp[ k ]; p < mAp[ k + 1 ]; ++p ) {
+            x[ mAi[ p ] ] = mAx[ p ];
+        }
+        for( int px = top; px < mN; ++px ) {
+            const int j = stack[ px ];
+            const int col = mPinv[ j ];
+            if( col < 0 ) {
+                continue;
+            }
+            for( int p = mLp[ col ] + 1; p < mLp[ col + 1 ]; ++p ) {
+                x[ mLi[ p ] ] -= mLx[ p ] * x[ j ];
+            }
+        }
+
+        // Split x into the U part for rows already pivoted and search the
+        // remaining rows for the largest pivot.
+        int ipiv = -1;
+        double maxAbs = -1.0;
+        for( int px = top; px < mN; ++px ) {
+            const int i = stack[ px ];
+            if( mPinv[ i ] < 0 ) {
+                if( fabs( x[ i ] ) > maxAbs ) {
+                    maxAbs = fabs( x[ i ] );
+                    ipiv = i;
+                }
+            }
+            else {
+                mUi.push_back( mPinv[ i ] );
+                mUx.push_back( x[ i ] );
+            }
+        }
+        if( ipiv == -1 || maxAbs <= 0.0 ) {
+            for( int px = top; px < mN; ++px ) {
+                x[ stack[ px ] ] = 0.0;
+            }
+            return k + 1;
+        }
+        // prefer the diagonal if it is large enough
+        if( mPinv[ k ] < 0 && fabs( x[ k ] ) >= maxAbs * mPivotTol ) {
+            ipiv = k;
+        }
+
+        const double pivot = x[ ipiv ];
+        mUi.push_back( k );
+        mUx.push_back( pivot );
+        mPinv[ ipiv ] = k;
+        mLi.push_back( ipiv );
+        mLx.push_back( 1.0 );
+        for( int px = top; px < mN; ++px ) {
+            const int i = stack[ px ];
+            if( mPinv[ i ] < 0 ) {
+                mLi.push_back( i );
+                mLx.push_back( x[ i ] / pivot );
+            }
+            x[ i ] = 0.0;
+        }
+    }
+    mLp[ mN ] = mLx.size();
+    mUp[ mN ] = mUx.size();
+
+    // Row indices of L were kept in the original ordering while factoring
+    // so that the depth first search could follow them, convert them now.
+    for( size_t p = 0; p < mLi.size(); ++p ) {
+        mLi[ p ] = mPinv[ mLi[ p ] ];
+    }
+    return 0;
+}
+
+/*!
+ * \brief Solve A x = b using the L-U factors of A only.
+ * \param aB On entry the right hand side, on exit the solution.
+ */
+void SparseLU::luSolve( UBVECTOR& aB ) const {
+    UBVECTOR y( mN );
+    for( int i = 0; i < mN; ++i ) {
+        y[ mPinv[ i ] ] = aB[ i ];
+    }
+    for( int j = 0; j < mN; ++j ) {
+        for( int p = mLp[ j ] + 1; p < mLp[ j + 1 ]; ++p ) {
+            y[ mLi[ p ] ] -= mLx[ p ] * y[ j ];
+        }
+    }
+    for( int j = mN - 1; j >= 0; --j ) {
+        y[ j ] /= mUx[ mUp[ j + 1 ] - 1 ];
+        for( int p = mUp[ j ]; p < mUp[ j + 1 ] - 1; ++p ) {
+            y[ mUi[ p ] ] -= mUx[ p ] * y[ j ];
+        }
+    }
+    aB.swap( y );
+}
+
+/*!
+ * \brief Solve B x = b where B is the factored matrix plus all rank-one
+ *        updates applied since it was factored.
+ * \details Uses the Sherman-Morrison formula recursively:
+ *          B_k^-1 b = B_{k-1}^-1 b - z_k ( v_k^T B_{k-1}^-1 b ) / ( 1 + v_k^T z_k )
+ *          with z_k = B_{k-1}^-1 u_k stored when the update was made.
+ * \param aB On entry the right hand side, on exit the solution.
+ */
+void SparseLU::solve( UBVECTOR& aB ) const {
+    luSolve( aB );
+    for( size_t k = 0; k < mUpdateDenom.size(); ++k ) {
+        aB -= ( boost::numeric::ublas::inner_prod( mUpdateV[ k ], aB ) / mUpdateDenom[ k ] ) * mUpdateZ[ k ];
+    }
+}
+
+/*!
+ * \brief Apply the rank-one update B = B + u v^T to the factored matrix.
+ * \param aU The column vector of the update.
+ * \param aV The row vector of the update.
+ * \return False if the updated matrix would be singular in which case the
+ *         update is not applied, true otherwise.
+ */
+bool SparseLU::update( const UBVECTOR& aU, const UBVECTOR& aV ) {
+    UBVECTOR z( aU );
+    solve( z );
+    const double denom = 1.0 + boost::numeric::ublas::inner_prod( aV, z );
+    if( fabs( denom ) < 1.0e-12 ) {
+        return false;
+    }
+    mUpdateZ.push_back( z );
+    mUpdateV.push_back( aV );
+    mUpdateDenom.push_back( denom );
+    return true;
+}
@@ -0,0 +1,112 @@
+#ifndef _KSECTER_H_
+#define _KSECTER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file ksecter.h
+ * \ingroup Objects
+ * \brief The Ksecter class header file.
+ */
+
+#include <vector>
+
+class ITarget;
+
+/*! \brief Object which performs k-section on a given target until it reaches
+ *          a tolerance.
+ * \details Each round of the search returns several trial values which may be
+ *          evaluated independently of one another. Until the solution is
+ *          bracketed the trials increase (or decrease) geometrically from the
+ *          closest known value, after which they split the bracket into equal
+ *          parts. The status of the target after running each trial must be
+ *          recorded with recordStatus before the next round is requested.
+ */
+class Ksecter {
+public:
+    Ksecter( const ITarget* aTarget,
+             const double aTolerance,
+             const double aInitialPrice,
+             const double aInitialValue,
+             const double aPriceChange,
+             const unsigned int aNumTrials,
+             const int aYear );
+
+    std::pair<std::vector<double>, bool> getNextValues();
+
+    void recordStatus( const unsigned int aTrial );
+
+    bool isSolved() const;
+
+    unsigned int getIterations() const;
+private:
+    //! The target.
+    const ITarget* mTarget;
+
+    //! The tolerance of the target.
+    const double mTolerance;
+
+    //! The percentage change between trials until the solution is bracketed.
+    const double mPriceChange;
+
+    //! The number of trials in each round.
+    const unsigned int mNumTrials;
+
+    //! The largest price known to be below the solution.
+    double mLowerBound;
+
+    //! The smallest price known to be above the solution.
+    double mUpperBound;
+
+    //! The price which is on target if one has been found.
+    double mSolution;
+
+    //! The trial prices of the current round.
+    std::vector<double> mTrials;
+
+    //! The target status of each trial of the current round.
+    std::vector<double> mStatus;
+
+    //! The number of rounds returned.
+    unsigned int mIterations;
+
+    //! Year in which the solver is operating.
+    unsigned int mYear;
+
+    void updateBounds( const double aPrice, const double aStatus );
+};
+
+#endif // _KSECTER_H_
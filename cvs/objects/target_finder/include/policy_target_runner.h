@@ -46,11 +46,13 @@
 
 #include <memory>
 #include <vector>
+#include <map>
 #include "containers/include/iscenario_runner.h"
 #include "util/base/include/value.h"
 
 class Timer;
 class TotalPolicyCostCalculator;
+class TrialCache;
 class SingleScenarioRunner;
 class ITarget;
 class Modeltime;
@@ -83,6 +85,14 @@ class Modeltime;
  *       to changes signs, which defeats the bisection solution mechanism.  Using
  *       the Secant method should work.
  *
+ * \note The initial tax of the Hotelling path can not be solved as an extra
+ *       market within each period. A cumulative or peak target depends on the
+ *       emissions of every period, while the model solves one period at a
+ *       time and the periods after the one being solved do not exist yet. The
+ *       initial tax is therefore found by the outer search over full runs,
+ *       which only re-solves the periods a trial tax changes and starts each
+ *       solve from the prices of nearby trials.
+ *
  *          <b>XML specification for PolicyTargetRunner</b>
  *          - XML name: \c policy-target-runner
  *          - Contained by: None or BatchRunner.
@@ -110,6 +120,16 @@ class Modeltime;
  *                   (optional) Set the initial target year to the value of the
  *                   year attribute or the last model year if that attribute is
  *                   not specified.
+ *              - \c trials-per-round PolicyTargetRunner::mNumTrialsPerRound
+ *                   (optional) The number of trial taxes in each round of the
+ *                   k-section search for the initial target. The default is 1
+ *                   which searches with the secant method instead.
+ *
+ *          If the boolean configuration value "climate-emulator" is set the
+ *          target is searched for using a ClimateEmulator calibrated around the
+ *          current path in place of the full climate model.  The full climate
+ *          model is then run to validate the path found and the search is
+ *          repeated with a recalibrated emulator if it is not within tolerance.
  *
  * \author Josh Lurz
  * \author Pralit Patel
@@ -203,6 +223,21 @@ private:
     //! solve.
     double mMaxTax;
 
+    //! The number of trial taxes to run in each round of the search for the
+    //! initial target. The secant method is used if this is one.
+    unsigned int mNumTrialsPerRound;
+
+    //! The taxes with which the currently valid model periods were
+    //! calculated, empty if no run has been performed yet.
+    std::vector<double> mCalculatedTaxes;
+
+    //! The solved prices of each period by the tax in that period, used to
+    //! interpolate the initial prices of later trials.
+    std::vector<std::map<double, std::vector<double> > > mSolvedPrices;
+
+    //! The results of the trials run while finding the current target path.
+    std::auto_ptr<TrialCache> mTrialCache;
+
     void
         calculateHotellingPath( const double aIntialTax,
                                 const double aHotellingRate,
@@ -212,6 +247,18 @@ private:
                                 std::vector<double>& aTaxes );
 
     void setTrialTaxes( const std::vector<double> aTaxes );
+
+    bool runTrialTaxes( const std::vector<double>& aTaxes,
+                        const int aLastPeriod,
+                        Timer& aTimer,
+                        const bool aUseCache = true );
+
+    bool interpolateSolvedPrices( const int aPeriod,
+                                  const double aTax,
+                                  std::vector<double>& aPrices ) const;
+
+    void storeSolvedPrices( const int aPeriod,
+                            const double aTax );
     
     bool solveInitialTarget( std::vector<double>& aTaxes,
                              const ITarget* aPolicyTarget,
@@ -233,6 +280,20 @@ private:
                            const int aFirstSkippedPeriod,
                            const int aPeriod,
                            Timer& aTimer );
+    bool findTargetPath( std::vector<double>& aTaxes,
+                         const ITarget* aPolicyTarget,
+                         Timer& aTimer );
+
+    bool isOnTarget( const ITarget* aPolicyTarget,
+                     const double aTolerance ) const;
+
+    //! The maximum number of times to search for the target with the climate
+    //! emulator before falling back to the full climate model.
+    static const unsigned int MAX_CLIMATE_EMULATOR_PASSES;
+
+    //! The maximum number of solved prices to keep for each period.
+    static const unsigned int MAX_SOLVED_PRICES;
+
     PolicyTargetRunner();
     static const std::string& getXMLNameStatic();
     void logRunID();
@@ -62,6 +62,7 @@ class Modeltime;
 class TargetFactory { 
 public:
     static bool isOfType( const std::string& aType );
+    static bool canUseClimateEmulator( const std::string& aType );
     static std::auto_ptr<ITarget> create( const std::string& aType,
                                           const IClimateModel* aClimateModel,
                                           double aTargetValue,
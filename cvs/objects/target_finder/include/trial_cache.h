@@ -0,0 +1,112 @@
+#ifndef _TRIAL_CACHE_H_
+#define _TRIAL_CACHE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file trial_cache.h
+ * \ingroup Objects
+ * \brief The TrialCache class header file.
+ */
+
+#include <vector>
+#include <map>
+#include <list>
+#include "target_finder/include/itarget.h"
+
+/*!
+ * \brief A target which remembers its status after each tax path that was run
+ *        so that a repeated trial does not need to be run again.
+ * \details The trials are keyed by the taxes up to the last period calculated,
+ *          rounded to single precision so that nearly identical paths share an
+ *          entry. After a trial has been stored the status is read from the
+ *          wrapped target as usual. After a trial has been found the status is
+ *          answered from the stored entry instead, although the model itself
+ *          is still in the state of the last trial which was run. Only the
+ *          years stored with the trial can be checked.
+ */
+class TrialCache: public ITarget {
+public:
+    explicit TrialCache( const ITarget* aTarget );
+
+    bool find( const std::vector<double>& aTaxes, const int aLastPeriod, bool& aSuccess );
+
+    void store( const std::vector<double>& aTaxes, const int aLastPeriod, const bool aSuccess,
+                const std::list<int>& aYears, const bool aStoreYearOfMax );
+
+    unsigned int getNumHits() const;
+
+    unsigned int getNumLookups() const;
+
+    // ITarget methods
+    virtual double getStatus( const int aYear ) const;
+
+    virtual int getYearOfMaxTargetValue() const;
+private:
+    //! The results of a trial.
+    struct Trial {
+        //! Whether the trial solved.
+        bool mSuccess;
+
+        //! The status of the target by year.
+        std::map<int, double> mStatus;
+
+        //! The year of the maximum target value, or -1 if it was not stored.
+        int mYearOfMax;
+    };
+
+    typedef std::map<std::vector<float>, Trial> TrialMap;
+
+    //! The wrapped target.
+    const ITarget* mTarget;
+
+    //! The stored trials by rounded tax path.
+    TrialMap mTrials;
+
+    //! The trial which was last found, null if the model is in the state of
+    //! the last trial run.
+    const Trial* mCurrent;
+
+    //! The number of successful lookups.
+    unsigned int mNumHits;
+
+    //! The number of lookups.
+    unsigned int mNumLookups;
+
+    static std::vector<float> createKey( const std::vector<double>& aTaxes, const int aLastPeriod );
+};
+
+#endif // _TRIAL_CACHE_H_
@@ -0,0 +1,198 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file ksecter.cpp
+ * \ingroup Objects
+ * \brief Ksecter class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include <cmath>
+#include "util/logger/include/ilogger.h"
+#include "target_finder/include/ksecter.h"
+#include "target_finder/include/itarget_solver.h"
+#include "target_finder/include/itarget.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+/*!
+ * \brief Construct the Ksecter.
+ * \param aTarget The policy target.
+ * \param aTolerance Solution tolerance.
+ * \param aInitialPrice The initial guess.
+ * \param aInitialValue The solution status of the initial guess.
+ * \param aPriceChange The percentage change between consecutive trials while
+ *                     the solution is not yet bracketed.
+ * \param aNumTrials The number of trials to return in each round.
+ * \param aYear Year to check the solution status in.
+ */
+Ksecter::Ksecter( const ITarget* aTarget,
+                  const double aTolerance,
+                  const double aInitialPrice,
+                  const double aInitialValue,
+                  const double aPriceChange,
+                  const unsigned int aNumTrials,
+                  const int aYear ) :
+mTarget( aTarget ),
+mTolerance( aTolerance ),
+mPriceChange( aPriceChange ),
+mNumTrials( max( aNumTrials, 1u ) ),
+mLowerBound( ITargetSolver::undefined() ),
+mUpperBound( ITargetSolver::undefined() ),
+mSolution( ITargetSolver::undefined() ),
+mIterations( 0 ),
+mYear( aYear )
+{
+    updateBounds( aInitialPrice, aInitialValue );
+
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    targetLog << "Constructing a Ksecter with " << mNumTrials << " trials per round."
+              << " Initial point: (" << aInitialPrice << ", " << aInitialValue << ")" << endl;
+}
+
+/*!
+ * \brief Get the trial values of the next round.
+ * \details Updates the bracket with the statuses recorded for the trials of
+ *          the previous round. If one of them was on target it is returned
+ *          as the only value.
+ * \return A pair of the trial values to run next and whether the search has
+ *         finished, either because the target was found or because the
+ *         bracket is too small to contain it.
+ */
+pair<vector<double>, bool> Ksecter::getNextValues() {
+    for( unsigned int i = 0; i < mTrials.size(); ++i ) {
+        updateBounds( mTrials[ i ], mStatus[ i ] );
+    }
+
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    targetLog << "The lower bound is " << mLowerBound << " and upper bound is "
+              << mUpperBound << "." << endl;
+
+    mTrials.clear();
+    if( isSolved() ) {
+        targetLog << "Found solution " << mSolution << "." << endl;
+        mTrials.push_back( mSolution );
+        return make_pair( mTrials, true );
+    }
+
+    const double lowerBound = mLowerBound == ITargetSolver::undefined() ? 0 : mLowerBound;
+    if( mUpperBound == ITargetSolver::undefined() ) {
+        // Increase from the lower bound until the solution is bracketed.
+        double trial = lowerBound;
+        for( unsigned int i = 0; i < mNumTrials; ++i ) {
+            trial = trial == 0 ? mPriceChange + 1 : trial * ( mPriceChange + 1 );
+            mTrials.push_back( trial );
+        }
+    }
+    else if( mUpperBound - lowerBound < mTolerance ) {
+        targetLog << "Failed to solve because the bracket width is empty." << endl;
+        return make_pair( mTrials, true );
+    }
+    else if( mLowerBound == ITargetSolver::undefined() ) {
+        // Decrease from the upper bound until the solution is bracketed, the
+        // smallest trial drops to zero if the bracket is still not found.
+        double trial = mUpperBound;
+        for( unsigned int i = 0; i + 1 < mNumTrials; ++i ) {
+            trial /= mPriceChange + 1;
+            mTrials.push_back( trial );
+        }
+        mTrials.push_back( 0 );
+    }
+    else {
+        // Split the bracket into equal parts.
+        for( unsigned int i = 1; i <= mNumTrials; ++i ) {
+            mTrials.push_back( mLowerBound + ( mUpperBound - mLowerBound ) * i / ( mNumTrials + 1 ) );
+        }
+    }
+    mStatus.assign( mTrials.size(), ITargetSolver::undefined() );
+
+    ++mIterations;
+    targetLog << "Attempting to solve target. Iteration: " << mIterations << endl;
+    return make_pair( mTrials, false );
+}
+
+/*!
+ * \brief Record the status of the target after running a trial of the current
+ *        round.
+ * \param aTrial The index of the trial within the current round.
+ */
+void Ksecter::recordStatus( const unsigned int aTrial ) {
+    assert( aTrial < mStatus.size() );
+    mStatus[ aTrial ] = mTarget->getStatus( mYear );
+
+    ILogger& mainLog = ILogger::getLogger( "target_finder_log" );
+    mainLog.setLevel( ILogger::WARNING );
+    mainLog << "Trial " << mTrials[ aTrial ] << " status is " << mStatus[ aTrial ] << endl;
+}
+
+/*!
+ * \brief Whether a trial has been found which is on target.
+ * \return True if the solution has been found.
+ */
+bool Ksecter::isSolved() const {
+    return mSolution != ITargetSolver::undefined();
+}
+
+/*! \brief Get the current number of rounds performed.
+ * \return The current number of rounds performed.
+ */
+unsigned int Ksecter::getIterations() const {
+    return mIterations;
+}
+
+/*!
+ * \brief Narrow the bracket with the status of a single trial.
+ * \details A trial for which the climate model failed, which is likely a
+ *          failure to solve, is treated as being too high.
+ * \param aPrice The trial price.
+ * \param aStatus The status of the target for the trial.
+ */
+void Ksecter::updateBounds( const double aPrice, const double aStatus ) {
+    if( !util::isValidNumber( aStatus ) || aStatus < -mTolerance ) {
+        if( mUpperBound == ITargetSolver::undefined() || aPrice < mUpperBound ) {
+            mUpperBound = aPrice;
+        }
+    }
+    else if( aStatus > mTolerance ) {
+        if( mLowerBound == ITargetSolver::undefined() || aPrice > mLowerBound ) {
+            mLowerBound = aPrice;
+        }
+    }
+    else if( !isSolved() ) {
+        mSolution = aPrice;
+    }
+}
@@ -42,6 +42,7 @@
 #include <cassert>
 #include <string>
 #include <cmath>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/base/include/xml_helper.h"
@@ -50,6 +51,8 @@
 #include "target_finder/include/itarget_solver.h"
 #include "target_finder/include/bisecter.h"
 #include "target_finder/include/secanter.h"
+#include "target_finder/include/ksecter.h"
+#include "target_finder/include/trial_cache.h"
 #include "target_finder/include/itarget.h"
 #include "containers/include/scenario_runner_factory.h"
 #include "util/base/include/configuration.h"
@@ -61,6 +64,8 @@
 #include "policy/include/policy_ghg.h"
 #include "util/base/include/util.h"
 #include "marketplace/include/marketplace.h"
+#include "containers/include/world.h"
+#include "climate/include/climate_emulator.h"
 
 using namespace std;
 using namespace xercesc;
@@ -69,6 +74,10 @@ extern void closeDB();
 extern ofstream outFile;
 extern void createMCvarid();
 
+const unsigned int PolicyTargetRunner::MAX_CLIMATE_EMULATOR_PASSES = 3;
+
+const unsigned int PolicyTargetRunner::MAX_SOLVED_PRICES = 8;
+
 /*!
  * \brief Constructor.
  */
@@ -81,7 +90,8 @@ mHasParsedConfig( false ),
 mRunID( 0 ),
 mNumForwardLooking( 0 ),
 mNumBackwardsLook( 0 ),
-mMaxTax( 4999 )
+mMaxTax( 4999 ),
+mNumTrialsPerRound( 1 )
 {
 }
 
@@ -167,6 +177,9 @@ bool PolicyTargetRunner::XMLParse( const xercesc::DOMNode* aRoot ){
         else if( nodeName == "initial-tax-guess" ) {
             mInitialTaxGuess = XMLHelper<double>::getValue( curr );
         }
+        else if( nodeName == "trials-per-round" ) {
+            mNumTrialsPerRound = XMLHelper<unsigned int>::getValue( curr );
+        }
         // Handle unknown nodes.
         else {
             ILogger& mainLog = ILogger::getLogger( "main_log" );
@@ -268,6 +281,8 @@ bool PolicyTargetRunner::runScenarios( const int aSinglePeriod,
     logRunID();
     bool success = mSingleScenario->runScenarios( Scenario::RUN_ALL_PERIODS,
                                                   true, aTimer );
+    mCalculatedTaxes.clear();
+    mSolvedPrices.clear();
     
     // Allow the use of an existing tax, note that taxes after mFirstTaxYear will
     // be overridden.
@@ -300,10 +315,115 @@ bool PolicyTargetRunner::runScenarios( const int aSinglePeriod,
         return false;
     }
     
+    // The target is searched for against an emulator of the climate model
+    // if requested so that the climate model only needs to be run to
+    // calibrate the emulator and to validate the path which was found.
+    auto_ptr<ClimateEmulator> climateEmulator;
+    auto_ptr<ITarget> emulatedTarget;
+    if( Configuration::getInstance()->getBool( "climate-emulator" ) ) {
+        if( TargetFactory::canUseClimateEmulator( mTargetType + "-target" ) ) {
+            climateEmulator.reset( new ClimateEmulator() );
+            emulatedTarget = TargetFactory::create( mTargetType + "-target",
+                climateEmulator.get(), mTargetValue, mFirstTaxYear );
+        }
+        else {
+            targetLog.setLevel( ILogger::WARNING );
+            targetLog << "The climate emulator can not be used for target type "
+                      << mTargetType << ", running the full climate model." << endl;
+        }
+    }
+
+    World* world = getInternalScenario()->getWorld();
+    for( unsigned int pass = 1; ; ++pass ) {
+        if( !climateEmulator.get() ) {
+            success = findTargetPath( taxes, policyTarget.get(), aTimer );
+            break;
+        }
+
+        // The climate model currently has the emissions of the last run.
+        world->setClimateModelEmulator( 0 );
+        if( !climateEmulator->calibrate( world->getClimateModel() ) ) {
+            targetLog.setLevel( ILogger::WARNING );
+            targetLog << "Could not calibrate the climate emulator, running the"
+                      << " full climate model." << endl;
+            climateEmulator.reset( 0 );
+            continue;
+        }
+
+        targetLog.setLevel( ILogger::NOTICE );
+        targetLog << "Searching for the target using the climate emulator, pass "
+                  << pass << "." << endl;
+        world->setClimateModelEmulator( climateEmulator.get() );
+        success = findTargetPath( taxes, emulatedTarget.get(), aTimer );
+
+        // Validate the path with the full climate model.
+        world->setClimateModelEmulator( 0 );
+        world->runClimateModel();
+        if( !success || isOnTarget( policyTarget.get(), mTolerance ) ) {
+            break;
+        }
+        else if( pass >= MAX_CLIMATE_EMULATOR_PASSES ) {
+            targetLog.setLevel( ILogger::WARNING );
+            targetLog << "The path found with the climate emulator was not within"
+                      << " tolerance of the target after " << pass << " passes,"
+                      << " running the full climate model." << endl;
+            climateEmulator.reset( 0 );
+        }
+    }
+    
+    targetLog.setLevel( ILogger::NOTICE );
+    targetLog << "Target finding for all years completed with status "
+              << success << "." << endl;
+
+    // Print the output before the total cost calculator modifies the scenario.
+    mSingleScenario->printOutput( aTimer, false );
+
+    // Initialize the total policy cost calculator if the user requested that
+    // total costs should be calculated.
+    if( success && Configuration::getInstance()->getBool( "createCostCurve" ) ){
+        mPolicyCostCalculator.reset(
+            new TotalPolicyCostCalculator( mSingleScenario.get() ) );
+
+        success &= mPolicyCostCalculator->calculateAbatementCostCurve();
+    }
+
+    // Return whether the initial run and all data point calculations completed
+    // successfully.
+    return success;
+}
+
+void PolicyTargetRunner::cleanup() {
+    mSingleScenario->cleanup();
+    mPolicyCostCalculator.reset( 0 );
+}
+
+/*!
+ * \brief Find the tax path which meets the target.
+ * \details Solves the initial target and then the target in each period past
+ *          the target period.  The current tax vector is used as the starting
+ *          point and is updated with the taxes found.
+ * \param aTaxes The current tax vector which should be updated.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \return Whether the target was met successfully.
+ */
+bool PolicyTargetRunner::findTargetPath( vector<double>& aTaxes,
+                                         const ITarget* aPolicyTarget,
+                                         Timer& aTimer )
+{
+    const Modeltime* modeltime = getInternalScenario()->getModeltime();
+
+    // Remember the status after each trial so that repeated tax paths are not
+    // run again. The solvers check the target through the cache.
+    mTrialCache.reset( new TrialCache( aPolicyTarget ) );
+    const ITarget* policyTarget = mTrialCache.get();
+
     // Find the initial target.
-    success = solveInitialTarget( taxes, policyTarget.get(),
-                                  mMaxIterations, mTolerance,
-                                  aTimer );
+    bool success = solveInitialTarget( aTaxes, policyTarget,
+                                       mMaxIterations, mTolerance,
+                                       aTimer );
     if( success ) {
         // For all years following the stabilization year adjust the tax to stay
         // on the target.
@@ -335,7 +455,7 @@ bool PolicyTargetRunner::runScenarios( const int aSinglePeriod,
             assert( numForwardLooking >= 0 );
 
             if( numForwardLooking == 0 ) {
-                success &= solveFutureTarget( taxes, policyTarget.get(),
+                success &= solveFutureTarget( aTaxes, policyTarget,
                                               mMaxIterations, mTolerance, period,
                                               aTimer );
             }
@@ -343,37 +463,49 @@ bool PolicyTargetRunner::runScenarios( const int aSinglePeriod,
                 const int periodsToSkip = period + numForwardLooking < modeltime->getmaxper() ?
                     numForwardLooking :
                     modeltime->getmaxper() - period - 1;
-                success &= skipFuturePeriod( taxes, policyTarget.get(), mMaxIterations,
+                success &= skipFuturePeriod( aTaxes, policyTarget, mMaxIterations,
                                              mTolerance, period, period + periodsToSkip,
                                              aTimer );
             }
         }
     }
-    
-    targetLog.setLevel( ILogger::NOTICE );
-    targetLog << "Target finding for all years completed with status "
-              << success << "." << endl;
-
-    // Print the output before the total cost calculator modifies the scenario.
-    mSingleScenario->printOutput( aTimer, false );
-
-    // Initialize the total policy cost calculator if the user requested that
-    // total costs should be calculated.
-    if( success && Configuration::getInstance()->getBool( "createCostCurve" ) ){
-        mPolicyCostCalculator.reset(
-            new TotalPolicyCostCalculator( mSingleScenario.get() ) );
-
-        success &= mPolicyCostCalculator->calculateAbatementCostCurve();
-    }
 
-    // Return whether the initial run and all data point calculations completed
-    // successfully.
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::NOTICE );
+    targetLog << "Reused the results of " << mTrialCache->getNumHits() << " of "
+              << mTrialCache->getNumLookups() << " trials." << endl;
+    mTrialCache.reset( 0 );
     return success;
 }
 
-void PolicyTargetRunner::cleanup() {
-    mSingleScenario->cleanup();
-    mPolicyCostCalculator.reset( 0 );
+/*!
+ * \brief Check whether the target is currently met.
+ * \details The target must be met in the initial target year and in every
+ *          model period after it.
+ * \param aPolicyTarget Object which detects if the policy target has been
+ *        reached.
+ * \param aTolerance The tolerance of the solution.
+ * \return Whether the target is met within tolerance.
+ */
+bool PolicyTargetRunner::isOnTarget( const ITarget* aPolicyTarget,
+                                     const double aTolerance ) const
+{
+    if( fabs( aPolicyTarget->getStatus( mInitialTargetYear ) ) > aTolerance ) {
+        return false;
+    }
+
+    const Modeltime* modeltime = getInternalScenario()->getModeltime();
+    const int targetYear = mInitialTargetYear == ITarget::getUseMaxTargetYearFlag() ?
+        aPolicyTarget->getYearOfMaxTargetValue() : mInitialTargetYear;
+    for( int period = modeltime->getyr_to_per( mFirstTaxYear ); period < modeltime->getmaxper();
+         ++period )
+    {
+        const int year = modeltime->getper_to_yr( period );
+        if( year > targetYear && fabs( aPolicyTarget->getStatus( year ) ) > aTolerance ) {
+            return false;
+        }
+    }
+    return true;
 }
 
 /*!
@@ -408,12 +540,12 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     const double initialTax = aTaxes[ firstTaxPeriod ];
     
     const int finalModelYear = getInternalScenario()->getModeltime()->getEndYear();
+    const int finalPeriod = getInternalScenario()->getModeltime()->getmaxper() - 1;
 
     // Run the model without a tax target once to get a baseline for the
     // solver and to calculate the initial non-tax periods.
     logRunID();
-    bool success = mSingleScenario->runScenarios( Scenario::RUN_ALL_PERIODS,
-                                                  false, aTimer );
+    bool success = runTrialTaxes( aTaxes, finalPeriod, aTimer );
     
     // If we are already below the target at a zero tax then we won't be able to
     // get to the target.
@@ -430,53 +562,117 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     
     // Increment is 1+ this number, which is used to increase the initial trial price
     const double INCREASE_INCREMENT = mInitialTaxGuess - 1;
-    auto_ptr<ITargetSolver> solver;
-    
-    solver.reset( new Secanter( aPolicyTarget,
-                       aTolerance,
-                       initialTax,
-                       aPolicyTarget->getStatus( mInitialTargetYear ),
-                       INCREASE_INCREMENT,
-                       mInitialTargetYear ) );
-    
+    unsigned int iterations;
+    if( mNumTrialsPerRound > 1 ) {
+        // Search with several trial taxes per round. The trials of a round do
+        // not depend on one another.
+        Ksecter solver( aPolicyTarget,
+                        aTolerance,
+                        initialTax,
+                        aPolicyTarget->getStatus( mInitialTargetYear ),
+                        INCREASE_INCREMENT,
+                        mNumTrialsPerRound,
+                        mInitialTargetYear );
+        while( solver.getIterations() < aLimitIterations ) {
+            pair<vector<double>, bool> trials = solver.getNextValues();
+
+            // Check for solution.
+            if( trials.second ){
+                if( !solver.isSolved() ) {
+                    targetLog.setLevel( ILogger::ERROR );
+                    targetLog << "Failed because the solution could not be bracketed." << endl;
+                    return false;
+                }
+
+                // Leave the model at the solution if it was not the last trial run.
+                calculateHotellingPath( trials.first.front(),
+                                        mPathDiscountRate,
+                                        getInternalScenario()->getModeltime(),
+                                        mFirstTaxYear,
+                                        finalModelYear,
+                                        aTaxes );
+                if( aTaxes != mCalculatedTaxes ) {
+                    logRunID();
+                    success = runTrialTaxes( aTaxes, finalPeriod, aTimer, false );
+                }
+                break;
+            }
 
-    while( solver->getIterations() < aLimitIterations ) {
-        pair<double, bool> trial = solver->getNextValue();
+            for( unsigned int i = 0; i < trials.first.size(); ++i ) {
+                targetLog << "Iteration " << solver.getIterations() << " trial " << i
+                          << " value = " << trials.first[ i ] << endl;
 
-        // Check for solution.
-        if( trial.second ){
-            break;
-        }
-        
-        if( !util::isValidNumber( trial.first ) ) {
-            targetLog.setLevel( ILogger::ERROR );
-            targetLog << "Failed due to invalid trial price generated by solver." << endl;
-            return false;
+                calculateHotellingPath( trials.first[ i ],
+                                        mPathDiscountRate,
+                                        getInternalScenario()->getModeltime(),
+                                        mFirstTaxYear,
+                                        finalModelYear,
+                                        aTaxes );
+
+                // TODO: If the run failed to solve then the target status may be unreliable.
+                logRunID();
+                success = runTrialTaxes( aTaxes, finalPeriod, aTimer );
+                solver.recordStatus( i );
+
+                targetLog << "Scenario run complete.  Return status = " << success << endl;
+            }
         }
+        iterations = solver.getIterations();
+    }
+    else {
+        auto_ptr<ITargetSolver> solver;
+        solver.reset( new Secanter( aPolicyTarget,
+                           aTolerance,
+                           initialTax,
+                           aPolicyTarget->getStatus( mInitialTargetYear ),
+                           INCREASE_INCREMENT,
+                           mInitialTargetYear ) );
 
-        
-        targetLog << "Iteration " << solver->getIterations() << " trial value = "
-                  << trial.first << endl;
 
-        // Set the trial tax.
-        calculateHotellingPath( trial.first,
-                                         mPathDiscountRate,
-                                         getInternalScenario()->getModeltime(),
-                                         mFirstTaxYear,
-                                         finalModelYear,
-                                         aTaxes );
+        while( solver->getIterations() < aLimitIterations ) {
+            pair<double, bool> trial = solver->getNextValue();
 
-        setTrialTaxes( aTaxes );
+            // Check for solution.
+            if( trial.second ){
+                break;
+            }
 
-        // Run the scenario at the trial tax.
-        // TODO: If the run failed to solve then the target status may be unreliable.
-        logRunID();
-        success = mSingleScenario->runScenarios( Scenario::RUN_ALL_PERIODS, false, aTimer );
+            if( !util::isValidNumber( trial.first ) ) {
+                targetLog.setLevel( ILogger::ERROR );
+                targetLog << "Failed due to invalid trial price generated by solver." << endl;
+                return false;
+            }
+
+
+            targetLog << "Iteration " << solver->getIterations() << " trial value = "
+                      << trial.first << endl;
+
+            // Set the trial tax.
+            calculateHotellingPath( trial.first,
+                                             mPathDiscountRate,
+                                             getInternalScenario()->getModeltime(),
+                                             mFirstTaxYear,
+                                             finalModelYear,
+                                             aTaxes );
+
+            // Run the scenario at the trial tax. Only the periods from the first
+            // tax period on are recalculated.
+            // TODO: If the run failed to solve then the target status may be unreliable.
+            logRunID();
+            success = runTrialTaxes( aTaxes, finalPeriod, aTimer );
 
-        targetLog << "Scenario run complete.  Return status = " << success << endl;
+            targetLog << "Scenario run complete.  Return status = " << success << endl;
+        }
+        iterations = solver->getIterations();
+
+        // Leave the model at the last trial if its results were reused.
+        if( aTaxes != mCalculatedTaxes ) {
+            logRunID();
+            success = runTrialTaxes( aTaxes, finalPeriod, aTimer, false );
+        }
     }
 
-    if( solver->getIterations() >= aLimitIterations ){
+    if( iterations >= aLimitIterations ){
         targetLog.setLevel( ILogger::ERROR );
         targetLog << "Exiting target finding search as the iterations limit was"
                   << " reached." << endl;
@@ -505,7 +701,7 @@ bool PolicyTargetRunner::solveInitialTarget( vector<double>& aTaxes,
     if( success ) {
         targetLog.setLevel( ILogger::NOTICE );
         targetLog << "Target value was found by search algorithm in "
-                  << solver->getIterations() << " iterations." << endl;
+                  << iterations << " iterations." << endl;
     }
     return success;
 }
@@ -540,9 +736,8 @@ bool PolicyTargetRunner::solveFutureTarget( vector<double>& aTaxes,
     // period which is likely closer to than that which was rising on the hotelling
     // path.
     aTaxes[ aPeriod ] = aTaxes[ aPeriod - 1 ];
-    setTrialTaxes( aTaxes );
     logRunID();
-    bool success = mSingleScenario->runScenarios( aPeriod, false, aTimer );
+    bool success = runTrialTaxes( aTaxes, aPeriod, aTimer );
 
     // Construct a solver which has an initial trial equal to the current tax.
     const Modeltime* modeltime = getInternalScenario()->getModeltime();
@@ -577,13 +772,16 @@ bool PolicyTargetRunner::solveFutureTarget( vector<double>& aTaxes,
         assert( static_cast<unsigned int>( aPeriod ) < aTaxes.size() );
         aTaxes[ aPeriod ] = trial.first;
 
-        // Set the trial taxes.
-        setTrialTaxes( aTaxes );
-
         // Run the base scenario.
         // TODO: If the run failed to solve then the target status may be unreliable.
         logRunID();
-        success = mSingleScenario->runScenarios( aPeriod, false, aTimer );
+        success = runTrialTaxes( aTaxes, aPeriod, aTimer );
+    }
+
+    // Leave the model at the last trial if its results were reused.
+    if( aTaxes != mCalculatedTaxes ) {
+        logRunID();
+        success = runTrialTaxes( aTaxes, aPeriod, aTimer, false );
     }
 
     if( solver->getIterations() >= aLimitIterations ){
@@ -656,11 +854,9 @@ bool PolicyTargetRunner::skipFuturePeriod( vector<double>& aTaxes,
         aTaxes[ period ] = util::linearInterpolateY( year, lastTaxYear, currYear,
                                                      aTaxes[ aFirstSkippedPeriod - 1 ],
                                                      aTaxes[ aPeriod ] );
-        getInternalScenario()->invalidatePeriod( period );
     }
-    setTrialTaxes( aTaxes );
     logRunID();
-    bool success = mSingleScenario->runScenarios( lastPeriodToCalc, false, aTimer );
+    bool success = runTrialTaxes( aTaxes, lastPeriodToCalc, aTimer );
     
     // Construct a solver which has an initial trial equal to the current tax.
     auto_ptr<ITargetSolver> solver;
@@ -703,16 +899,18 @@ bool PolicyTargetRunner::skipFuturePeriod( vector<double>& aTaxes,
             aTaxes[ period ] = util::linearInterpolateY( year, lastTaxYear, currYear,
                                                          aTaxes[ aFirstSkippedPeriod - 1 ],
                                                          aTaxes[ aPeriod ] );
-            getInternalScenario()->invalidatePeriod( period );
         }
         
-        // Set the trial taxes.
-        setTrialTaxes( aTaxes );
-        
         // Run the base scenario.
         // TODO: If the run failed to solve then the target status may be unreliable.
         logRunID();
-        success = mSingleScenario->runScenarios( lastPeriodToCalc, false, aTimer );
+        success = runTrialTaxes( aTaxes, lastPeriodToCalc, aTimer );
+    }
+
+    // Leave the model at the last trial if its results were reused.
+    if( aTaxes != mCalculatedTaxes ) {
+        logRunID();
+        success = runTrialTaxes( aTaxes, lastPeriodToCalc, aTimer, false );
     }
     
     if( solver->getIterations() >= aLimitIterations ){
@@ -831,6 +1029,157 @@ void PolicyTargetRunner::setTrialTaxes( const vector<double> aTaxes ) {
     mSingleScenario->getInternalScenario()->setTax( &tax );
 }
 
+/*!
+ * \brief Set a vector of taxes into the model and run the periods they affect.
+ * \details Only the periods from the first period in which the taxes differ
+ *          from those of the previous run are recalculated, the periods before
+ *          it are reused as is. All periods are calculated if there has been no
+ *          previous run at known taxes. The recalculated periods start from
+ *          prices interpolated from the previous trials at the nearest taxes
+ *          rather than from those of the last trial.
+ *
+ *          While a target path is being found the results of each trial are
+ *          stored in the trial cache and a repeated trial is not run again.
+ *          The model then remains at the last trial which was run.
+ * \param aTaxes Vector of taxes to set into the model. Must contain one value
+ *        for each model period.
+ * \param aLastPeriod The last model period to calculate. The periods past it
+ *        are no longer valid after the run.
+ * \param aTimer The timer used to print out the amount of time spent performing
+ *        operations.
+ * \param aUseCache Whether the results of an identical trial may be reused.
+ * \return Whether the run was successful and all periods up to aLastPeriod,
+ *         including those which were reused, are solved.
+ */
+bool PolicyTargetRunner::runTrialTaxes( const vector<double>& aTaxes,
+                                        const int aLastPeriod,
+                                        Timer& aTimer,
+                                        const bool aUseCache )
+{
+    bool success;
+    if( aUseCache && mTrialCache.get() && mTrialCache->find( aTaxes, aLastPeriod, success ) ) {
+        return success;
+    }
+
+    setTrialTaxes( aTaxes );
+
+    Scenario* scenario = getInternalScenario();
+    const Modeltime* modeltime = scenario->getModeltime();
+    int firstPeriod = 0;
+    int lastPeriod = modeltime->getmaxper() - 1;
+    if( mCalculatedTaxes.empty() ) {
+        success = mSingleScenario->runScenarios( Scenario::RUN_ALL_PERIODS, false, aTimer );
+    }
+    else {
+        // The taxes only affect the period they apply to and those after it.
+        firstPeriod = aLastPeriod;
+        lastPeriod = aLastPeriod;
+        for( int period = 0; period < aLastPeriod; ++period ) {
+            if( aTaxes[ period ] != mCalculatedTaxes[ period ] ) {
+                firstPeriod = period;
+                break;
+            }
+        }
+        for( int period = firstPeriod; period <= aLastPeriod; ++period ) {
+            vector<double> prices;
+            if( interpolateSolvedPrices( period, aTaxes[ period ], prices ) ) {
+                scenario->setInitialPrices( period, prices );
+            }
+            if( period < aLastPeriod ) {
+                scenario->invalidatePeriod( period );
+            }
+        }
+        success = mSingleScenario->runScenarios( aLastPeriod, false, aTimer );
+        success &= scenario->getUnsolvedPeriods().empty();
+    }
+    mCalculatedTaxes = aTaxes;
+
+    const vector<int>& unsolvedPeriods = scenario->getUnsolvedPeriods();
+    for( int period = firstPeriod; period <= lastPeriod; ++period ) {
+        if( find( unsolvedPeriods.begin(), unsolvedPeriods.end(), period ) == unsolvedPeriods.end() ) {
+            storeSolvedPrices( period, aTaxes[ period ] );
+        }
+    }
+
+    // Store the status in each year which only depends on the periods up to
+    // the last one calculated.
+    if( mTrialCache.get() ) {
+        list<int> years;
+        for( int period = 0; period <= aLastPeriod; ++period ) {
+            years.push_back( modeltime->getper_to_yr( period ) );
+        }
+        const bool isFinalPeriod = aLastPeriod == modeltime->getmaxper() - 1;
+        if( isFinalPeriod ) {
+            years.push_back( mInitialTargetYear );
+            years.push_back( ITarget::getUseMaxTargetYearFlag() );
+        }
+        mTrialCache->store( aTaxes, aLastPeriod, success, years, isFinalPeriod );
+    }
+    return success;
+}
+
+/*!
+ * \brief Interpolate the prices of a period at a tax from the solved prices of
+ *        previous trials.
+ * \details The prices are interpolated linearly between the trials with the
+ *          nearest taxes on either side, or copied from the nearest trial if
+ *          there is none on one side.
+ * \param aPeriod The model period.
+ * \param aTax The trial tax in the period.
+ * \param aPrices The vector to store the interpolated prices in.
+ * \return Whether any solved prices were available.
+ */
+bool PolicyTargetRunner::interpolateSolvedPrices( const int aPeriod,
+                                                  const double aTax,
+                                                  vector<double>& aPrices ) const
+{
+    if( static_cast<int>( mSolvedPrices.size() ) <= aPeriod || mSolvedPrices[ aPeriod ].empty() ) {
+        return false;
+    }
+
+    const map<double, vector<double> >& solvedPrices = mSolvedPrices[ aPeriod ];
+    map<double, vector<double> >::const_iterator upper = solvedPrices.lower_bound( aTax );
+    if( upper == solvedPrices.end() ) {
+        aPrices = solvedPrices.rbegin()->second;
+    }
+    else if( upper == solvedPrices.begin() || upper->first == aTax ) {
+        aPrices = upper->second;
+    }
+    else {
+        map<double, vector<double> >::const_iterator lower = upper;
+        --lower;
+        const double weight = ( aTax - lower->first ) / ( upper->first - lower->first );
+        aPrices = lower->second;
+        for( unsigned int i = 0; i < aPrices.size() && i < upper->second.size(); ++i ) {
+            aPrices[ i ] += weight * ( upper->second[ i ] - aPrices[ i ] );
+        }
+    }
+    return true;
+}
+
+/*!
+ * \brief Store the solved prices of a period for the tax they were solved at.
+ * \details At most MAX_SOLVED_PRICES are kept for each period, the trial with
+ *          the tax furthest from the current one is dropped first.
+ * \param aPeriod The model period which has just been solved.
+ * \param aTax The tax in the period.
+ */
+void PolicyTargetRunner::storeSolvedPrices( const int aPeriod,
+                                            const double aTax )
+{
+    if( static_cast<int>( mSolvedPrices.size() ) <= aPeriod ) {
+        mSolvedPrices.resize( getInternalScenario()->getModeltime()->getmaxper() );
+    }
+
+    map<double, vector<double> >& solvedPrices = mSolvedPrices[ aPeriod ];
+    solvedPrices[ aTax ] = getInternalScenario()->getMarketplace()->getPrices( aPeriod );
+    if( solvedPrices.size() > MAX_SOLVED_PRICES ) {
+        map<double, vector<double> >::iterator lowest = solvedPrices.begin();
+        map<double, vector<double> >::iterator highest = --solvedPrices.end();
+        solvedPrices.erase( aTax - lowest->first > highest->first - aTax ? lowest : highest );
+    }
+}
+
 /*!
  * \brief Write a unique identifier into each of several log files
  */
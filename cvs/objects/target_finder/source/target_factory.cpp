@@ -44,6 +44,7 @@
 
 #include "target_finder/include/target_factory.h"
 #include "util/logger/include/ilogger.h"
+#include "util/base/include/configuration.h"
 
 // Add new types here.
 #include "target_finder/include/concentration_target.h"
@@ -72,6 +73,24 @@ bool TargetFactory::isOfType( const string& aType ) {
         || ( aType == EmissionsStabalizationTarget::getXMLNameStatic() ) );
 }
 
+/*!
+* \brief Return whether a type of target can be searched for using a
+*        ClimateEmulator.
+* \details The emulator only estimates CO2 driven quantities and so can not be
+*          used for targets which depend on other gases or on carbon uptake.
+* \param aType Type of target.
+* \return Whether the target may use the emulator.
+*/
+bool TargetFactory::canUseClimateEmulator( const string& aType ) {
+    const string concentrationGas = Configuration::getInstance()->getString(
+        "concentration-target-gas", "CO2" );
+    return ( ( aType == ConcentrationTarget::getXMLNameStatic() && concentrationGas == "CO2" )
+        || ( aType == ForcingTarget::getXMLNameStatic() )
+        || ( aType == RCPForcingTarget::getXMLNameStatic() )
+        || ( aType == TemperatureTarget::getXMLNameStatic() )
+        || ( aType == CumulativeEmissionsTarget::getXMLNameStatic() ) );
+}
+
 /*!
  * \brief Return a new instance of a component of the requested type.
  * \param aType Type of ITarget to return.
@@ -0,0 +1,150 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+ * \file trial_cache.cpp
+ * \ingroup Objects
+ * \brief TrialCache class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+#include "target_finder/include/trial_cache.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+/*!
+ * \brief Construct the TrialCache.
+ * \param aTarget The target to read the status of run trials from.
+ */
+TrialCache::TrialCache( const ITarget* aTarget ):
+mTarget( aTarget ),
+mCurrent( 0 ),
+mNumHits( 0 ),
+mNumLookups( 0 )
+{
+}
+
+/*!
+ * \brief Look up the results of a tax path.
+ * \details If the path was stored the status is answered from it until the
+ *          next trial is stored.
+ * \param aTaxes The taxes by period.
+ * \param aLastPeriod The last period the trial calculates.
+ * \param aSuccess Set to whether the trial solved if it was found.
+ * \return Whether the trial was found.
+ */
+bool TrialCache::find( const vector<double>& aTaxes, const int aLastPeriod, bool& aSuccess ) {
+    ++mNumLookups;
+    TrialMap::const_iterator trial = mTrials.find( createKey( aTaxes, aLastPeriod ) );
+    if( trial == mTrials.end() ) {
+        return false;
+    }
+    ++mNumHits;
+    mCurrent = &trial->second;
+    aSuccess = trial->second.mSuccess;
+
+    ILogger& targetLog = ILogger::getLogger( "target_finder_log" );
+    targetLog.setLevel( ILogger::DEBUG );
+    targetLog << "Reusing the results of an identical trial." << endl;
+    return true;
+}
+
+/*!
+ * \brief Store the results of a trial which was just run.
+ * \details The status of the wrapped target is read for each of the given
+ *          years, which must not depend on periods after the last period.
+ * \param aTaxes The taxes by period.
+ * \param aLastPeriod The last period the trial calculated.
+ * \param aSuccess Whether the trial solved.
+ * \param aYears The years to store the status of.
+ * \param aStoreYearOfMax Whether to store the year of the maximum target value
+ *        which depends on all periods.
+ */
+void TrialCache::store( const vector<double>& aTaxes, const int aLastPeriod, const bool aSuccess,
+                        const list<int>& aYears, const bool aStoreYearOfMax )
+{
+    mCurrent = 0;
+    Trial& trial = mTrials[ createKey( aTaxes, aLastPeriod ) ];
+    trial.mSuccess = aSuccess;
+    trial.mStatus.clear();
+    for( list<int>::const_iterator year = aYears.begin(); year != aYears.end(); ++year ) {
+        trial.mStatus[ *year ] = mTarget->getStatus( *year );
+    }
+    trial.mYearOfMax = aStoreYearOfMax ? mTarget->getYearOfMaxTargetValue() : -1;
+}
+
+//! Get the number of lookups which found a stored trial.
+unsigned int TrialCache::getNumHits() const {
+    return mNumHits;
+}
+
+//! Get the number of lookups.
+unsigned int TrialCache::getNumLookups() const {
+    return mNumLookups;
+}
+
+double TrialCache::getStatus( const int aYear ) const {
+    if( mCurrent ) {
+        map<int, double>::const_iterator status = mCurrent->mStatus.find( aYear );
+        /*!
+         * \pre The status must have been stored for the year.
+         */
+        assert( status != mCurrent->mStatus.end() );
+        if( status != mCurrent->mStatus.end() ) {
+            return status->second;
+        }
+    }
+    return mTarget->getStatus( aYear );
+}
+
+int TrialCache::getYearOfMaxTargetValue() const {
+    if( mCurrent && mCurrent->mYearOfMax != -1 ) {
+        return mCurrent->mYearOfMax;
+    }
+    return mTarget->getYearOfMaxTargetValue();
+}
+
+/*!
+ * \brief Create the key of a tax path.
+ * \param aTaxes The taxes by period.
+ * \param aLastPeriod The last period calculated, later taxes are ignored.
+ * \return The taxes up to the last period rounded to single precision.
+ */
+vector<float> TrialCache::createKey( const vector<double>& aTaxes, const int aLastPeriod ) {
+    vector<float> key;
+    for( int period = 0; period <= aLastPeriod && period < static_cast<int>( aTaxes.size() ); ++period ) {
+        key.push_back( static_cast<float>( aTaxes[ period ] ) );
+    }
+    return key;
+}
@@ -52,6 +52,7 @@
 
 #include <xercesc/dom/DOMNode.hpp>
 #include "technologies/include/technology.h"
+#include "marketplace/include/cached_market_vector.h"
 
 // Forward declaration
 class Tabs;
@@ -90,6 +91,12 @@ public:
     virtual double calcShare( const IDiscreteChoice* aChoiceFn,
                               const GDP* aGDP,
                               int aPeriod ) const; 
+
+    virtual bool getShareTerms( const GDP* aGDP,
+                                const int aPeriod,
+                                double& aShareWeight,
+                                double& aCost,
+                                double& aLogShareAdjustment ) const;
     
     virtual void production( const std::string& aRegionName,
                              const std::string& aSectorName, 
@@ -137,6 +144,14 @@ protected:
     //! Weak pointer to the land leaf which corresponds to this technology
     //! used to save time finding it over and over
     ALandAllocatorItem* mProductLeaf;
+
+    //! The market for the product located during initCalc so that the
+    //! profit rate calculation does not need to search for it.
+    CachedMarketVector mProductMarket;
+
+    //! The subsidy on the product in each period, read from the market info
+    //! during initCalc since it is fixed for the period.
+    objects::PeriodVector<Value> mSubsidy;
     
     void copy( const AgProductionTechnology& aOther );
 
@@ -62,7 +62,7 @@ class Tabs;
  *       abstract functions in Technology. DefaultTechnology's implementations
  *       of those abstract functions call the Technology implementations.
  */
-class DefaultTechnology: public Technology
+class DefaultTechnology final: public Technology
 {
 public:
 	DefaultTechnology( const std::string& aName,
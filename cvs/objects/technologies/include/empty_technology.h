@@ -106,6 +106,12 @@ public:
     virtual double calcShare( const IDiscreteChoice* aChoiceFn,
                               const GDP *aGDP,
                               int aPeriod ) const;
+
+    virtual bool getShareTerms( const GDP* aGDP,
+                                const int aPeriod,
+                                double& aShareWeight,
+                                double& aCost,
+                                double& aLogShareAdjustment ) const;
     
     virtual void calcCost( const std::string& aRegionName,
                           const std::string& aSectorName,
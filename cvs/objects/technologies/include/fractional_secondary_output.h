@@ -53,6 +53,7 @@ class Tabs;
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
 #include "util/curves/include/cost_curve.h"
+#include "marketplace/include/cached_market_vector.h"
 
 /*! 
  * \ingroup Objects
@@ -77,7 +78,7 @@ class Tabs;
  *          
  * \author Pralit Patel
  */
-class FractionalSecondaryOutput: public IOutput
+class FractionalSecondaryOutput final: public IOutput
 {
     friend class OutputFactory;
 public:
@@ -206,6 +207,10 @@ protected:
         //! the current region is assumed.
         DEFINE_VARIABLE( SIMPLE, "market-name", mMarketName, std::string )
     )
+
+    //! Pre-located markets which have been cached from the marketplace in each
+    //! period to add supply to and get the price of.
+    CachedMarketVector mCachedMarket;
 };
 
 #endif // _FRACTIONAL_SECONDARY_OUTPUT_H_
@@ -65,7 +65,7 @@ class Tabs;
  *
  * \author Kate Calvin
  */
-class GenericOutput : public PrimaryOutput {
+class GenericOutput final : public PrimaryOutput {
 public:
     /*
      * \brief Constructor
@@ -61,6 +61,14 @@ class ITechnologyContainer;
  *         getTechnology method.  The global technologies are categorized by sector
  *         and subsector names to avoid technology name collisions.
  *
+ *         The database is not modified once parsing has finished, each
+ *         StubTechnologyContainer clones the technology it refers to and
+ *         applies its own adjustments to the clone.  When batch scenarios
+ *         share their parsed inputs (batch-share-parsed-inputs) the database
+ *         is parsed once before the workers are forked so that all of them
+ *         read the same pages, and a scenario whose inputs adjust a global
+ *         technology only gets private copies of the pages it changes.
+ *
  *          <b>XML specification for GlobalTechnologyDatabase</b>
  *          - XML name: -c GlobalTechnologyDatabase::getXMLNameStatic()
  *          - Contained by: World
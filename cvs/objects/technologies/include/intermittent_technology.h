@@ -126,6 +126,8 @@ public:
                            const int aPeriod );
 protected:
     typedef std::vector<IInput*>::iterator InputIterator;
+
+    virtual bool canCacheCost() const;
     
     // Define data such that introspection utilities can process the data from this
     // subclass together with the data members of the parent classes.
@@ -185,6 +187,7 @@ protected:
 
     void setCoefficients( const std::string& aRegionName,
                           const std::string& aSectorName,
+                          const double aAverageBackupCapacity,
                           const int aPeriod );
 
     virtual double getResourceToEnergyRatio( const std::string& aRegionName,
@@ -195,21 +198,17 @@ protected:
                                              const std::string& aSectorName,
                                              const int aPeriod ) const;
 
-    double getMarginalBackupCapCost( const std::string& aRegionName,
-                                     const std::string& aSectorName,
-                                     const int aPeriod ) const;
+    double getMarginalBackupCapCost( const double aMarginalBackupCapacity ) const;
 
     void initializeInputLocations( const std::string& aRegionName,
                                    const std::string& aSectorName,
                                    const int aPeriod );
 
-    double getMarginalBackupCapacity( const std::string& aRegionName,
-                                      const std::string& aSectorName,
-                                      const int aPeriod ) const;
-
-    double getAverageBackupCapacity( const std::string& aRegionName,
-                                     const std::string& aSectorName,
-                                     const int aPeriod ) const;
+    void calcBackupCapacities( const std::string& aRegionName,
+                               const std::string& aSectorName,
+                               const int aPeriod,
+                               double& aMarginalBackupCapacity,
+                               double& aAverageBackupCapacity ) const;
 
     double calcEnergyFromBackup() const;
 
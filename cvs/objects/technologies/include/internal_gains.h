@@ -79,7 +79,7 @@ class Tabs;
  * \author Pralit Patel
  * \author Jiyong Eom
  */
-class InternalGains : public IOutput {
+class InternalGains final : public IOutput {
     friend class OutputFactory;
 public:
 
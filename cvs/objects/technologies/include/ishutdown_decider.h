@@ -113,6 +113,16 @@ public:
                                      const int aInitialTechYear,
                                      const int aPeriod ) const = 0;
 
+    /*!
+     * \brief Whether the shutdown coefficient depends on the profit rate.
+     * \details Coefficients which do not depend on it only depend on the age
+     *          of the vintage and the parameters of the decider, so they may be
+     *          calculated once per period rather than at every production
+     *          calculation.
+     * \return Whether calcShutdownCoef uses the profit rate.
+     */
+    virtual bool isProfitDependent() const = 0;
+
     /*!
      * \brief Return a constant to represent a state where the profit rate has
      *        not yet been calculated.
@@ -158,6 +158,12 @@ public:
     virtual double calcShare( const IDiscreteChoice* aChoiceFn,
                               const GDP* aGDP,
                               int aPeriod ) const = 0;
+
+    virtual bool getShareTerms( const GDP* aGDP,
+                                const int aPeriod,
+                                double& aShareWeight,
+                                double& aCost,
+                                double& aLogShareAdjustment ) const = 0;
     
     virtual void calcCost( const std::string& aRegionName,
                            const std::string& aSectorName,
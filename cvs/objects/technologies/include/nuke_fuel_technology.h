@@ -58,7 +58,7 @@ class GDP;
 * \author Sonny Kim
 */
 
-class NukeFuelTechnology : public Technology
+class NukeFuelTechnology final : public Technology
 {
 public:
     NukeFuelTechnology( const std::string& aName, const int aYear );
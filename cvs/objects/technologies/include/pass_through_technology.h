@@ -57,7 +57,7 @@ class IVisitor;
  *
  * \author Pralit Patel
  */
-class PassThroughTechnology: public Technology
+class PassThroughTechnology final: public Technology
 {
 public:
     PassThroughTechnology( const std::string& aName, const int aYear );
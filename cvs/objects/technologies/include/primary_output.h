@@ -48,11 +48,11 @@
 #include <xercesc/dom/DOMNode.hpp>
 
 class Tabs;
-class CachedMarket;
 
 #include "technologies/include/ioutput.h"
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 /*! 
  * \ingroup Objects
@@ -173,8 +173,8 @@ protected:
         DEFINE_VARIABLE( SIMPLE, "co2-coef", mCachedCO2Coef, Value )
     )
     
-    //! A pre-located market which has been cached from the marketplace to add supply to.
-    std::auto_ptr<CachedMarket> mCachedMarket;
+    //! Pre-located markets which have been cached from the marketplace in each period to add supply to.
+    CachedMarketVector mCachedMarket;
     
     void copy( const PrimaryOutput& aOther );
 };
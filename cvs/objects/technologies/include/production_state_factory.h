@@ -46,9 +46,10 @@
  */
 
 #include <string>
-#include <memory>
+#include <vector>
 
 class IProductionState;
+class IShutdownDecider;
 
 /*! 
  * \ingroup Objects
@@ -58,15 +59,25 @@ class IProductionState;
  *          states so that the Technology does not need to be aware of all
  *          types. This simplifies adding new types and also minimizes
  *          recompilation.
+ *
+ *          The retired state has no data, and most technologies are retired in
+ *          most periods, so a single retired state is shared by all
+ *          technologies rather than allocating one per technology per period.
+ *          States must therefore be released with destroy rather than deleted.
  * \author Josh Lurz
  */
 class ProductionStateFactory { 
 public:
-    static std::auto_ptr<IProductionState> create( const int aInvestYear,
-                                                   const int aLifetimeYears,
-                                                   const double aFixedOutput,
-                                                   const double aInitialOutput,
-                                                   const int aPeriod );
+    static IProductionState* create( const int aInvestYear,
+                                     const int aLifetimeYears,
+                                     const double aFixedOutput,
+                                     const double aInitialOutput,
+                                     const std::vector<IShutdownDecider*>& aShutdownDeciders,
+                                     const int aPeriod );
+
+    static void destroy( IProductionState* aState );
+private:
+    static IProductionState* getRetiredState();
 };
 
 #endif // _PRODUCTION_STATE_FACTORY_H_
@@ -109,6 +109,8 @@ public:
                                      const std::string& aSectorName,
                                      const int aInitialTechYear,
                                      const int aPeriod ) const;
+
+    virtual bool isProfitDependent() const;
 protected:
     ProfitShutdownDecider();
     
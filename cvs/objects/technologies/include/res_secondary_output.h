@@ -72,7 +72,7 @@
  *          
  * \author Josh Lurz, Patrick Luckow
  */
-class RESSecondaryOutput: public SecondaryOutput
+class RESSecondaryOutput final: public SecondaryOutput
 {
     friend class OutputFactory;
 public:
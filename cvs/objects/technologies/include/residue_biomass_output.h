@@ -38,6 +38,7 @@
 #include "util/base/include/value.h"
 #include "util/curves/include/cost_curve.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 class Curve;
 class ALandAllocatorItem;
@@ -73,7 +74,7 @@ class ALandAllocatorItem;
  * \date $ Date $
  * \version $ Revision $
  */
-class ResidueBiomassOutput : public IOutput
+class ResidueBiomassOutput final : public IOutput
 {
 public :
    typedef IOutput parent;
@@ -192,6 +193,10 @@ protected :
     //! Weak pointer to the land leaf which corresponds to this biomass output
     //! used to save time finding it over and over
     ALandAllocatorItem* mProductLeaf;
+
+    //! Pre-located markets which have been cached from the marketplace in each
+    //! period to add supply to and get the price of.
+    CachedMarketVector mCachedMarket;
     
     void copy( const ResidueBiomassOutput& aOther );
 };
@@ -52,6 +52,7 @@ class Tabs;
 #include "technologies/include/ioutput.h"
 #include "util/base/include/value.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/cached_market_vector.h"
 
 /*! 
  * \ingroup Objects
@@ -202,6 +203,10 @@ protected:
         //! the current region is assumed.
         DEFINE_VARIABLE( SIMPLE, "market-name", mMarketName, std::string )
     )
+
+    //! Pre-located markets which have been cached from the marketplace in each
+    //! period to add to and get the price of.
+    CachedMarketVector mCachedMarket;
     
     void copy( const SecondaryOutput& aOther );
 };
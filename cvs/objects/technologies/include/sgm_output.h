@@ -49,10 +49,10 @@
 #include <xercesc/dom/DOMNode.hpp>
 
 class Tabs;
-class CachedMarket;
 
 #include "technologies/include/ioutput.h"
 #include "util/base/include/value.h"
+#include "marketplace/include/cached_market_vector.h"
 
 /*! 
  * \ingroup Objects
@@ -177,8 +177,8 @@ protected:
     //! Stored region for this good used to get the price of the good
     std::string mRegionName;
 
-    //! A pre-located market which has been cached from the marketplace to add supply to.
-    std::auto_ptr<CachedMarket> mCachedMarket;
+    //! Pre-located markets which have been cached from the marketplace in each period to add supply to.
+    CachedMarketVector mCachedMarket;
 };
 
 #endif // _SGM_OUTPUT_H_
@@ -81,7 +81,7 @@
  * \date $ Date $
  * \version $ Revision $
  */
-class SolarTechnology : public IntermittentTechnology
+class SolarTechnology final : public IntermittentTechnology
 {
 public :
 
@@ -58,6 +58,7 @@
 #include "util/base/include/iround_trippable.h"
 #include "technologies/include/itechnology.h"
 #include "util/base/include/time_vector.h"
+#include "marketplace/include/market_price_cache.h"
 
 // Forward declaration
 class AGHG;
@@ -199,6 +200,12 @@ public:
     virtual double calcShare( const IDiscreteChoice* aChoiceFn,
                               const GDP* aGDP,
                               int aPeriod ) const;
+
+    virtual bool getShareTerms( const GDP* aGDP,
+                                const int aPeriod,
+                                double& aShareWeight,
+                                double& aCost,
+                                double& aLogShareAdjustment ) const;
     
     virtual void calcCost( const std::string& aRegionName,
                            const std::string& aSectorName,
@@ -365,6 +372,18 @@ protected:
     //! this information to the profit shutdown decider.
     mutable double mMarginalRevenue;
 
+    //! The market prices read by calcCost so that it may skip recalculating
+    //! the cost if none of them have changed.  Only created by initCalc when
+    //! the cache-technology-costs configuration option is set.
+    std::auto_ptr<MarketPriceCache> mCostCache;
+
+    //! The market prices read and the supplies and demands added by the last
+    //! production of a vintage so that they may be added again if neither
+    //! its output nor those prices have changed.
+    MarketPriceCache mVintageCache;
+
+    virtual bool canCacheCost() const;
+
     static double getFixedOutputDefault();
 
     void setProductionState( const int aPeriod );
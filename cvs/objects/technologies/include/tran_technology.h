@@ -56,7 +56,7 @@ class IInfo;
 * \author Sonny Kim, Josh Lurz, Steve Smith
 */
 
-class TranTechnology : public Technology
+class TranTechnology final : public Technology
 {
     friend class XMLDBOutputter;
 public:
@@ -110,6 +110,10 @@ protected:
         //! Vehicle load factor.
         DEFINE_VARIABLE( SIMPLE, "loadFactor", mLoadFactor, double )
     )
+
+    //! The unit conversion applied to the price of each input in mInputs
+    //! when calculating the total input cost, set in initCalc.
+    std::vector<double> mInputCostConversion;
     
     void copy( const TranTechnology& aOther );
 
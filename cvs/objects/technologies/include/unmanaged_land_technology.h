@@ -68,7 +68,7 @@ class Tabs;
 * \author Steve Smith, Kate Calvin
 */
 
-class UnmanagedLandTechnology : public AgProductionTechnology {
+class UnmanagedLandTechnology final : public AgProductionTechnology {
 public:
     UnmanagedLandTechnology( const std::string& aName,
                                 const int aYear );
@@ -112,11 +112,21 @@ protected:
      */
     VintageProductionState();
 
+    void initShutdownCoefficient( const std::vector<IShutdownDecider*>& aShutdownDeciders,
+                                  const int aPeriod );
+
     double calcShutdownCoefficient( const std::string& aRegionName,
 								    const std::string& aSectorName,
                                     const std::vector<IShutdownDecider*>& aShutdownDeciders,
                                     const MarginalProfitCalculator* aMarginalProfitCalc,
                                     const int aPeriod ) const;
+
+    //! The product of the shutdown coefficients which only depend on the age
+    //! of the vintage, see initShutdownCoefficient.
+    double mAgeShutdownCoef;
+
+    //! Whether any of the shutdown deciders depend on the profit rate.
+    bool mHasProfitDeciders;
 };
 
 #endif // _VINTAGE_PRODUCTION_STATE_H_
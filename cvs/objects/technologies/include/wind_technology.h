@@ -75,7 +75,7 @@
  * \date $ Date $
  * \version $ Revision $
  */
-class WindTechnology : public IntermittentTechnology
+class WindTechnology final : public IntermittentTechnology
 {
 public :
 
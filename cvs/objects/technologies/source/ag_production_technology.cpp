@@ -191,6 +191,12 @@ void AgProductionTechnology::initCalc( const string& aRegionName,
   
     const Modeltime* modeltime = scenario->getModeltime();
 
+    // Locate the product market and store the subsidy once for the period
+    // since they are needed each time the profit rate is calculated.
+    mProductMarket.locateMarket( aSectorName, aRegionName, aPeriod );
+    mSubsidy[ aPeriod ].set( mProductMarket.getMarketInfo( aSectorName, aRegionName, aPeriod, true )
+                             ->getDouble( aRegionName + "subsidy", true ) );
+
     // Only do tech changes if this is the initial year of the
     // technology.
     if( !mProductionState[ aPeriod ]->isNewInvestment() ){
@@ -252,7 +258,7 @@ void AgProductionTechnology::initCalc( const string& aRegionName,
     // If yield is GCal/kHa and prices are $/GCal, then rental rate is $/kHa
     // And this is what is now passed in ($/kHa)
     double profitRate = calcProfitRate( aRegionName, aSectorName, aPeriod );
-    mLandAllocator->setProfitRate( aRegionName, mName, profitRate, aPeriod );
+    mProductLeaf->setProfitRate( aRegionName, mName, profitRate, aPeriod );
 
     // TODO: it may be useful to inform the solver about the minimum price required
     // to have some supply however we can not know that information for sure due to
@@ -395,6 +401,17 @@ double AgProductionTechnology::calcShare( const IDiscreteChoice* aChoiceFn,
     return 0.0;
 }
 
+bool AgProductionTechnology::getShareTerms( const GDP* aGDP,
+                                            const int aPeriod,
+                                            double& aShareWeight,
+                                            double& aCost,
+                                            double& aLogShareAdjustment ) const
+{
+    // The share is not calculated from the discrete choice function so
+    // calcShare must be used.
+    return false;
+}
+
 
 /* agTechnologies are not shared on cost, so this calCost method is overwritten
    by a calculation of technology profit which is passed to the land allocator
@@ -483,19 +500,17 @@ double AgProductionTechnology::calcProfitRate( const string& aRegionName,
                                                const string& aProductName,
                                                const int aPeriod ) const
 {
-    // Calculate profit rate.
-    const Marketplace* marketplace = scenario->getMarketplace();
-
     // TODO: consider adding the residue biomass value to crop value
     // First, need to change residue biomass output as per unit of land
     // in order to prevent a simultaneity.  Then, we can include this value.
     double secondaryValue = calcSecondaryValue( aRegionName, aPeriod );
 
     // nonlandvariable cost units are now assumed to be in $/kg
-    double price = marketplace->getPrice( aProductName, aRegionName, aPeriod );
+    double price = mProductMarket.getPrice( aProductName, aRegionName, aPeriod );
 
 	// subsidy in $/kg
-    double subsidy = marketplace->getMarketInfo( aProductName, aRegionName, aPeriod, true )->getDouble( aRegionName+"subsidy", true );
+    double subsidy = mSubsidy[ aPeriod ].isInited() ? mSubsidy[ aPeriod ].get() :
+        scenario->getMarketplace()->getMarketInfo( aProductName, aRegionName, aPeriod, true )->getDouble( aRegionName+"subsidy", true );
 
     // Compute cost of variable inputs (such as water and fertilizer)
     double inputCosts = getTotalInputCost( aRegionName, aProductName, aPeriod );
@@ -120,6 +120,18 @@ double EmptyTechnology::calcShare( const IDiscreteChoice* aChoiceFn,
     return -numeric_limits<double>::infinity();
 }
 
+bool EmptyTechnology::getShareTerms( const GDP* aGDP,
+                                     const int aPeriod,
+                                     double& aShareWeight,
+                                     double& aCost,
+                                     double& aLogShareAdjustment ) const
+{
+    aShareWeight = 0.0;
+    aCost = 0.0;
+    aLogShareAdjustment = -numeric_limits<double>::infinity();
+    return true;
+}
+
 double EmptyTechnology::getFixedOutput( const string& aRegionName,
                                   const string& aSectorName,
                                   const bool aHasRequiredInput,
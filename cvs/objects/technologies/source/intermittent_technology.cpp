@@ -411,18 +411,19 @@ void IntermittentTechnology::production( const string& aRegionName,
 /*! \brief Set tech shares based on backup energy needs for an intermittent
 *          resource.
 * \author Marshall Wise
+* \param aAverageBackupCapacity Average backup capacity per unit output.
 * \param aPeriod Model period.
 */
 void IntermittentTechnology::setCoefficients( const string& aRegionName,
                                               const string& aSectorName,
+                                              const double aAverageBackupCapacity,
                                               const int aPeriod )
 {
     // Convert backup capacity per unit of resource energy to energy required
     // (in EJ) per unit of resource energy (in EJ) using backup capacity factor.
     // Based on average backup capacity as this is multiplied by sector output
     // to get total backup electricity.
-    double backupEnergyFraction = getAverageBackupCapacity( aRegionName, aSectorName,
-                                  aPeriod ) * calcEnergyFromBackup();
+    double backupEnergyFraction = aAverageBackupCapacity * calcEnergyFromBackup();
 
     /*! \invariant Backup energy fraction must be positive. */
     assert( util::isValidNumber( backupEnergyFraction ) &&
@@ -471,14 +472,21 @@ void IntermittentTechnology::calcCost( const string& aRegionName,
                                        const string& aSectorName,
                                        const int aPeriod )
 {
+    // The marginal and average backup both depend on the same trial share so
+    // they are calculated together.
+    double marginalBackupCapacity;
+    double averageBackupCapacity;
+    calcBackupCapacities( aRegionName, mTrialMarketName, aPeriod, marginalBackupCapacity,
+                          averageBackupCapacity );
+
     // Set marginal cost for backup to the input object set asside for this
     ( *mBackupCapCostInput )->setPrice( aRegionName, 
-                              getMarginalBackupCapCost( aRegionName, mTrialMarketName, aPeriod ), 
+                              getMarginalBackupCapCost( marginalBackupCapacity ), 
                               aPeriod );
    
     // Set the coefficients for energy and backup in the production function.
     // Must call this after costs for backup capital and technology have been set.
-    setCoefficients( aRegionName, mTrialMarketName, aPeriod );
+    setCoefficients( aRegionName, mTrialMarketName, averageBackupCapacity, aPeriod );
 
     // Calculate the base technology cost. This will use the standard leontief
     // production function with updated coefficients for the fuel and the
@@ -486,75 +494,63 @@ void IntermittentTechnology::calcCost( const string& aRegionName,
     Technology::calcCost( aRegionName, aSectorName, aPeriod );
 }
 
+/*!
+ * \brief The cost can not be cached since the backup coefficients and price are
+ *        set in calcCost from the trial market and backup parameters.
+ * \return False.
+ */
+bool IntermittentTechnology::canCacheCost() const {
+    return false;
+}
+
 /*! \brief Returns marginal cost for backup capacity
 * \author Marshall Wise, Steve Smith
-* \param aSectorName Sector name.
-* \param aRegionName Region name.
-* \param aPeriod Model period.
+* \param aMarginalBackupCapacity Marginal backup capacity per unit of energy
+*        output.
 */
-double IntermittentTechnology::getMarginalBackupCapCost( const string& aRegionName,
-                                                         const string& aSectorName,
-                                                         const int aPeriod ) const
+double IntermittentTechnology::getMarginalBackupCapCost( const double aMarginalBackupCapacity ) const
 {
     // Add per unit cost of backup capacity to subsector price backup capacity
     // is in GW/EJ, so have to convert to kW/GJ (multiply numerator by 1E6 and
     // denominator by 1E9 to get * 1/1000) to make consistent with market price
     // which is in $/GJ. BackupCost is in $/kw/yr.
-    double backupCost = getMarginalBackupCapacity( aRegionName, aSectorName, aPeriod )
-                        / 1000 * mBackupCapitalCost;   
+    double backupCost = aMarginalBackupCapacity / 1000 * mBackupCapitalCost;   
    return backupCost;
 }
 
 /*!
- * \brief Get the marginal backup capacity required per unit of energy output.
- * \details Uses the internal backup calculator to determine the marginal backup
+ * \brief Get the marginal and average backup capacity required per unit of
+ *        energy output.
+ * \details Uses the internal backup calculator to determine the backup
  *          capacity per unit output. If a backup calculator was not read-in,
- *          this is assumed to be zero. 
+ *          both are assumed to be zero.
  * \author Marshall Wise, Steve Smith, Sonny Kim
+ * \param aRegionName Region name.
+ * \param aSectorName The name of the trial market sector.
  * \param aPeriod Model period.
- * \return Marginal backup capacity per unit of energy output.
+ * \param aMarginalBackupCapacity [out] Marginal backup capacity per unit of
+ *        energy output.
+ * \param aAverageBackupCapacity [out] Average backup capacity per unit output.
  */
-double IntermittentTechnology::getMarginalBackupCapacity( const string& aRegionName,
-                                                          const string& aSectorName,
-                                                          const int aPeriod ) const {
-    double backupCapacity = 0;
-    if( mBackupCalculator && mResourceInput != mInputs.end() ){
-        const string& resourceName = ( *mResourceInput )->getName();
-        backupCapacity = mBackupCalculator->getMarginalBackupCapacity( aSectorName,
-                         mElectricSectorName, resourceName, aRegionName,
-                         mCapacityFactor, mElecReserveMargin, mAveGridCapacityFactor, aPeriod );
-    }
-
-    /*! \post Backup capacity is a valid number and positive. */
-    assert( backupCapacity >= 0 && util::isValidNumber( backupCapacity ) );
-    return backupCapacity;
-}
-
-/*!
- * \brief Get the average backup capacity per unit output for the intermittent
- *        subsector.
- * \details Uses the internal backup calculator to determine the average backup
- *          capacity per unit output. If a backup calculator was not read-in,
- *          this is assumed to be zero.
- * \author Marshall Wise, Steve Smith, Sonny Kim
- * \param aPeriod Model period.
- * \return Average backup capacity per unit output.
- */
-double IntermittentTechnology::getAverageBackupCapacity( const string& aRegionName,
-                                                         const string& aSectorName,
-                                                         const int aPeriod ) const
+void IntermittentTechnology::calcBackupCapacities( const string& aRegionName,
+                                                   const string& aSectorName,
+                                                   const int aPeriod,
+                                                   double& aMarginalBackupCapacity,
+                                                   double& aAverageBackupCapacity ) const
 {
-    double backupCapacity = 0;
-    if( mBackupCalculator ){
+    aMarginalBackupCapacity = 0;
+    aAverageBackupCapacity = 0;
+    if( mBackupCalculator && mResourceInput != mInputs.end() ){
         const string& resourceName = ( *mResourceInput )->getName();
-        backupCapacity = mBackupCalculator->getAverageBackupCapacity( aSectorName,
-                         mElectricSectorName, resourceName, aRegionName,
-                         mCapacityFactor, mElecReserveMargin, mAveGridCapacityFactor, aPeriod );
+        mBackupCalculator->calcBackupCapacities( aSectorName, mElectricSectorName, resourceName,
+                                                 aRegionName, mCapacityFactor, mElecReserveMargin,
+                                                 mAveGridCapacityFactor, aPeriod,
+                                                 aMarginalBackupCapacity, aAverageBackupCapacity );
     }
 
-    /*! \post Backup capacity is a valid number and positive. */
-    assert( backupCapacity >= 0 && util::isValidNumber( backupCapacity ) );
-    return backupCapacity;
+    /*! \post Backup capacities are valid numbers and positive. */
+    assert( aMarginalBackupCapacity >= 0 && util::isValidNumber( aMarginalBackupCapacity ) );
+    assert( aAverageBackupCapacity >= 0 && util::isValidNumber( aAverageBackupCapacity ) );
 }
 
 /*! 
@@ -160,3 +160,7 @@ double PhasedShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* aF
     // Exponentially shutdown the production with the function 1/(rate)^years active.
     return 1 / pow( 1 + mShutdownRate, ( modeltime->getper_to_yr( aPeriod ) - aInitialTechYear ) );
 }
+
+bool PhasedShutdownDecider::isProfitDependent() const {
+    return false;
+}
@@ -47,7 +47,7 @@
 #include "marketplace/include/marketplace.h"
 #include "util/base/include/ivisitor.h"
 #include "functions/include/function_utils.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 
 using namespace std;
 using namespace xercesc;
@@ -141,7 +141,7 @@ void PrimaryOutput::initCalc( const string& aRegionName,
     // Initialize the cached CO2 coefficient.
     mCachedCO2Coef.set( FunctionUtils::getCO2Coef( aRegionName, aSectorName, aPeriod ) );
     
-    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, aRegionName, aPeriod );
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
 }
 
 void PrimaryOutput::postCalc( const string& aRegionName,
@@ -176,7 +176,7 @@ void PrimaryOutput::setPhysicalOutput( const double aPrimaryOutput,
     mPhysicalOutputs[ aPeriod ] = aPrimaryOutput;
 
     // Add the primary output to the marketplace.
-    mCachedMarket->addToSupply( mName, aRegionName, mPhysicalOutputs[ aPeriod ], aPeriod, false );
+    mCachedMarket.addToSupply( mName, aRegionName, mPhysicalOutputs[ aPeriod ], aPeriod, false );
 }
 
 double PrimaryOutput::getPhysicalOutput( const int aPeriod ) const {
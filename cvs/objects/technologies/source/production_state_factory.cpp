@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <memory>
 #include "technologies/include/production_state_factory.h"
 #include "util/base/include/model_time.h"
 #include "containers/include/scenario.h"
@@ -75,13 +76,17 @@ using namespace std;
 * \param aInitialOutput The output in the initial operating period of the
 *        technology, or IProductionState::fixedOutputDefault if it cannot be
 *        calculated.
+* \param aShutdownDeciders The shutdown deciders of the Technology, the age
+*        dependent coefficients of which a vintaged state calculates up front.
 * \param aPeriod Model period.
+* \return The new production state which must be released with destroy.
 */
-auto_ptr<IProductionState> ProductionStateFactory::create( const int aInvestYear,
-                                                           const int aLifetimeYears,
-                                                           const double aFixedOutput,
-                                                           const double aInitialOutput,
-                                                           const int aPeriod )
+IProductionState* ProductionStateFactory::create( const int aInvestYear,
+                                                  const int aLifetimeYears,
+                                                  const double aFixedOutput,
+                                                  const double aInitialOutput,
+                                                  const vector<IShutdownDecider*>& aShutdownDeciders,
+                                                  const int aPeriod )
 {
     // Initialize the production state.
     auto_ptr<IProductionState> newState;
@@ -104,15 +109,36 @@ auto_ptr<IProductionState> ProductionStateFactory::create( const int aInvestYear
     else if( ( currYear > aInvestYear ) &&
         ( aInvestYear + aLifetimeYears > currYear ) ){
         assert( aPeriod > 0 );
-        newState.reset( new VintageProductionState );
+        VintageProductionState* vintageState = new VintageProductionState;
+        newState.reset( vintageState );
         // Set the base level of output to the output in the initial investment
         // year.
-        newState->setBaseOutput( aInitialOutput, aInvestYear );
+        vintageState->setBaseOutput( aInitialOutput, aInvestYear );
+        vintageState->initShutdownCoefficient( aShutdownDeciders, aPeriod );
     }
     // Otherwise it is retired. This may occur if the technology has not been
     // created yet as well.
     else {
-        newState.reset( new RetiredProductionState );
+        return getRetiredState();
     }
-    return newState;
+    return newState.release();
+}
+
+/*!
+ * \brief Release a production state returned by create.
+ * \param aState The production state to release, may be null.
+ */
+void ProductionStateFactory::destroy( IProductionState* aState ) {
+    if( aState != getRetiredState() ) {
+        delete aState;
+    }
+}
+
+/*!
+ * \brief Get the retired production state shared by all technologies.
+ * \return The shared retired production state.
+ */
+IProductionState* ProductionStateFactory::getRetiredState() {
+    static RetiredProductionState sRetiredState;
+    return &sRetiredState;
 }
@@ -202,3 +202,7 @@ double ProfitShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* aF
     assert( scaleFactor >= 0 && scaleFactor <= 1 );
     return scaleFactor;
 }
+
+bool ProfitShutdownDecider::isProfitDependent() const {
+    return true;
+}
@@ -146,8 +146,7 @@ IOutput::OutputList ResidueBiomassOutput::calcPhysicalOutput( const double aPrim
         return outputList;
     }
 
-    const Marketplace* marketplace = scenario->getMarketplace();
-    double price = marketplace->getPrice( getName(), aRegionName, aPeriod, true );
+    double price = mCachedMarket.getPrice( getName(), aRegionName, aPeriod, true );
 
     // If there is no market price, return
     if ( price == Marketplace::NO_MARKET_PRICE ) {
@@ -300,6 +299,8 @@ void ResidueBiomassOutput::initCalc( const std::string& aRegionName, const std::
     const IInfo* productInfo = marketplace->getMarketInfo( getName(), aRegionName, aPeriod, false );
 
     mCachedCO2Coef.set( productInfo ? productInfo->getDouble( "CO2Coef", false ) : 0 );
+
+    mCachedMarket.locateMarket( getName(), aRegionName, aPeriod );
 }
 
 void ResidueBiomassOutput::postCalc( const std::string& aRegionName, const int aPeriod )
@@ -328,8 +329,7 @@ void ResidueBiomassOutput::setPhysicalOutput( const double aPrimaryOutput, const
     mPhysicalOutputs[ aPeriod ].set( outputList.front().second );
 
     // Add output to the supply
-    Marketplace* marketplace = scenario->getMarketplace();
-    marketplace->addToSupply( getName(), aRegionName, mPhysicalOutputs[ aPeriod ],
+    mCachedMarket.addToSupply( getName(), aRegionName, mPhysicalOutputs[ aPeriod ],
             aPeriod, true );
 }
 
@@ -169,3 +169,7 @@ double S_CurveShutdownDecider::calcShutdownCoef( const ProductionFunctionInfo* a
     // All remaining vintage is cut off at the read in lifetime
     return 1 / ( 1 + exp( mSteepness*( (modeltime->getper_to_yr( aPeriod ) - aInstallationYear) - mHalfLife ) ) );
 }
+
+bool S_CurveShutdownDecider::isProfitDependent() const {
+    return false;
+}
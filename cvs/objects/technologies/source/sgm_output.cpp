@@ -48,7 +48,7 @@
 #include "containers/include/iinfo.h"
 #include "util/base/include/xml_helper.h"
 #include "functions/include/function_utils.h"
-#include "marketplace/include/cached_market.h"
+#include "marketplace/include/cached_market_vector.h"
 
 extern Scenario* scenario;
 
@@ -173,12 +173,12 @@ void SGMOutput::initCalc( const string& aRegionName,
     // Make sure the sgm output has a name.
     assert( !mName.empty() );
 
-    mCachedMarket = scenario->getMarketplace()->locateMarket( mName, aRegionName, aPeriod );
+    mCachedMarket.locateMarket( mName, aRegionName, aPeriod );
 
     // Initialize the cached CO2 coefficient.  If this output IsPrimaryEnergyGood
     // then we want to use a co2 coef of zero since emissions of fuels are accounted
     // for by use instead of production.
-    const IInfo* marketInfo = mCachedMarket->getMarketInfo( aSectorName,
+    const IInfo* marketInfo = mCachedMarket.getMarketInfo( aSectorName,
         aRegionName, aPeriod, false );
     if( marketInfo && marketInfo->getBoolean( "IsPrimaryEnergyGood", false ) ){
         mCachedCO2Coef.set( 0 );
@@ -223,7 +223,7 @@ void SGMOutput::setPhysicalOutput( const double aSGMOutput,
     // note that this does not make sense for consumers
     // and so we say that the market does not need to exist
     if( aSGMOutput > util::getSmallNumber() ) {
-        mCachedMarket->addToSupply( mName, aRegionName, mPhysicalOutputs[ aPeriod ], aPeriod, false );
+        mCachedMarket.addToSupply( mName, aRegionName, mPhysicalOutputs[ aPeriod ], aPeriod, false );
     }
 }
 
@@ -248,7 +248,7 @@ double SGMOutput::getCurrencyOutput( const int aPeriod ) const {
     // physical to currency
     // note that this will get the full currency demand including any production taxes
     // which is why we just the price rather than price recieved
-    double priceRecieved = mCachedMarket->getPrice( getName(), mRegionName, aPeriod, false );
+    double priceRecieved = mCachedMarket.getPrice( getName(), mRegionName, aPeriod, false );
     if( priceRecieved == Marketplace::NO_MARKET_PRICE ) {
         priceRecieved = 1;
     }
@@ -160,7 +160,8 @@ double StandardTechnicalChangeCalc::calcAndAdjustForTechChange( vector<IInput*>&
     // Allow the production function to adjust for technical change given the
     // read-in energy and material technical change. Note that the inputs have
     // already been adjusted for previous technical change by copying the
-    // coeffients forward.
+    // coeffients forward. Since those coefficients may have been calibrated
+    // the cumulative change can not be tabulated from the read-in rates alone.
     TechChange techChange( mMaterialTechChange, mEnergyTechChange, mHicksNeutralTechChange );
     return aProductionFunc->applyTechnicalChange( aInputs, techChange, aRegionName,
                                                   aSectorName, aPeriod,
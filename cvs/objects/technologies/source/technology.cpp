@@ -114,7 +114,9 @@ typedef vector<IInput*>::const_iterator CInputIterator;
  * \param aName Technology name.
  * \param aYear Technology year.
  */
-Technology::Technology( const string& aName, const int aYear ) {
+Technology::Technology( const string& aName, const int aYear ):
+mVintageCache( false )
+{
     mName = aName;
     mYear = aYear;
     init();
@@ -187,7 +189,7 @@ void Technology::clear()
         delete *iter;
     }
     for( ProductionStateIterator iter = mProductionState.begin(); iter != mProductionState.end(); ++iter ) {
-        delete *iter;
+        ProductionStateFactory::destroy( *iter );
     }
     for( OutputIterator iter = mOutputs.begin(); iter != mOutputs.end(); ++iter ) {
         delete *iter;
@@ -318,7 +320,7 @@ void Technology::completeInit( const string& aRegionName,
     mTechnologyInfo.reset( InfoFactory::constructInfo( aSubsectorInfo, mName ) );
 
     // include technology capacity factor in info object for available use by inputs, outputs and other components
-    mTechnologyInfo->setDouble( "tech-capacity-factor", mCapacityFactor );
+    mTechnologyInfo->setDouble( InfoKeys::eTechCapacityFactor, mCapacityFactor );
 
     /*! \pre There must be at least one input. */
    // assert( !mInputs.empty() ); //sjs remove this for now since ag techs don't have any inputs at present
@@ -653,7 +655,7 @@ void Technology::initCalc( const string& aRegionName,
     }
     
     mTechnologyInfo->setBoolean( "new-vintage-tech", mProductionState[ aPeriod ]->isNewInvestment() );
-    mTechnologyInfo->setBoolean( "is-tech-operating", mProductionState[ aPeriod ]->isOperating() );
+    mTechnologyInfo->setBoolean( InfoKeys::eIsTechOperating, mProductionState[ aPeriod ]->isOperating() );
 
     for( unsigned int i = 0; i < mGHG.size(); i++ ) {
         mGHG[ i ]->initCalc( aRegionName, mTechnologyInfo.get(), aPeriod );
@@ -701,6 +703,17 @@ void Technology::initCalc( const string& aRegionName,
                      aSectorName, aPeriod );
     }
 
+    // The inputs may have changed so the cost and production must be
+    // recalculated.
+    static const bool cacheCosts = Configuration::getInstance()->getBool( "cache-technology-costs", false );
+    if( cacheCosts && !mCostCache.get() && canCacheCost() ) {
+        mCostCache.reset( new MarketPriceCache() );
+    }
+    if( mCostCache.get() ) {
+        mCostCache->invalidate();
+    }
+    mVintageCache.invalidate();
+
     // If Calibration is Active, reinitialize share weights for calibration.
     if( Configuration::getInstance()->getBool( "CalibrationActive" ) ){
         // For new technology vintages up to and including final calibration period.
@@ -743,10 +756,8 @@ void Technology::setProductionState( const int aPeriod ){
     // Check that the state for this period has not already been initialized.
     // Note that this is the case when the same scenario is run multiple times
     // for instance when doing the policy cost calculation.  In which case
-    // we must delete the memory to avoid a memory leak.
-    if( mProductionState[ aPeriod ] ) {
-        delete mProductionState[ aPeriod ];
-    }
+    // we must release the memory to avoid a memory leak.
+    ProductionStateFactory::destroy( mProductionState[ aPeriod ] );
     
     double initialOutput = 0;
     const Modeltime* modeltime = scenario->getModeltime();
@@ -754,7 +765,7 @@ void Technology::setProductionState( const int aPeriod ){
     
     mProductionState[ aPeriod ] =
         ProductionStateFactory::create( mYear, mLifetimeYears, mFixedOutput,
-                                        initialOutput, aPeriod ).release();
+                                        initialOutput, mShutdownDeciders, aPeriod );
 }
 
 /*!
@@ -850,29 +861,70 @@ double Technology::calcShare( const IDiscreteChoice* aChoiceFn,
 {
     const double mininf = -numeric_limits<double>::infinity();
 
+    double shareWeight;
+    double cost;
+    double logShareAdjustment;
+    getShareTerms( aGDP, aPeriod, shareWeight, cost, logShareAdjustment );
+    if( logShareAdjustment == mininf ) {
+        return mininf;
+    }
+
+    double logshare = aChoiceFn->calcUnnormalizedShare( shareWeight, cost, aPeriod )
+                      + logShareAdjustment;
+    assert( util::isValidNumber( logshare ) || logshare == mininf );
+    return logshare;
+}
+
+/*!
+ * \brief Get the terms from which the technology share is calculated.
+ * \details Allows the subsector to calculate the shares of all of its
+ *          technologies with a single call to IDiscreteChoice::calcShares.
+ *          The share is the discrete choice function of the share weight and
+ *          cost with the log share adjustment, which is the fuel preference
+ *          elasticity term, added to it.  A technology which should not receive
+ *          a share has a log share adjustment of negative infinity.
+ * \param aGDP Regional GDP container.
+ * \param aPeriod Model period.
+ * \param aShareWeight The share weight of the technology.
+ * \param aCost The cost of the technology.
+ * \param aLogShareAdjustment The term to add to the log share.
+ * \return Whether the share is calculated in this way, otherwise calcShare
+ *         must be used.
+ */
+bool Technology::getShareTerms( const GDP* aGDP,
+                                const int aPeriod,
+                                double& aShareWeight,
+                                double& aCost,
+                                double& aLogShareAdjustment ) const
+{
+    const double mininf = -numeric_limits<double>::infinity();
+    aShareWeight = 0.0;
+    aCost = 0.0;
+    aLogShareAdjustment = mininf;
+
     // A Technology which is not operating does not have a share.
     if( !mProductionState[ aPeriod ] || !mProductionState[ aPeriod ]->isOperating() ){
-        return mininf;
+        return true;
     } 
     // Vintages and fixed output technologies should never have a share.
     if( !mProductionState[ aPeriod ]->isNewInvestment() ||
         mFixedOutput != IProductionState::fixedOutputDefault() )
     {
-        return mininf;
+        return true;
     }
 
     /* Calculation for regular cases */
-    double cost = getCost( aPeriod ); 
-    double logshare = aChoiceFn->calcUnnormalizedShare( mShareWeight, cost, aPeriod );
+    aShareWeight = mShareWeight;
+    aCost = getCost( aPeriod ); 
+    aLogShareAdjustment = 0.0;
 
     double fuelPrefElasticity = calcFuelPrefElasticity( aPeriod );
     if( fuelPrefElasticity != 0 ) {
         double scaledGdpPerCapita = aGDP->getBestScaledGDPperCap( aPeriod );
         assert( scaledGdpPerCapita > 0.0) ;
-        logshare += fuelPrefElasticity * log( scaledGdpPerCapita );
+        aLogShareAdjustment = fuelPrefElasticity * log( scaledGdpPerCapita );
     }
-    assert( util::isValidNumber( logshare ) || logshare == mininf );
-    return logshare;
+    return true;
 }
 
 /*! \brief Return true if technology is fixed for no output or input
@@ -1000,11 +1052,34 @@ void Technology::production( const string& aRegionName,
                                                      mShutdownDeciders,
                                                      aPeriod );
 
-    // Calculate input demand.
-    mProductionFunction->calcDemand( mInputs, primaryOutput, aRegionName, aSectorName,
-                                     1, aPeriod, 0, mAlphaZero );
+    // The input demands, outputs and emissions of a vintage only depend on
+    // its output and the market prices read while calculating them.  If none
+    // of those have changed since the last full calculation the state already
+    // holds the same values so only the market supplies and demands need to
+    // be added again.  Partial derivatives are always calculated as they add
+    // the differences from the base state and each thread has its own copy of
+    // the state.
+    const bool canFreeze = !Marketplace::isDerivativeCalc() &&
+        !mProductionState[ aPeriod ]->isNewInvestment() && canCacheCost();
+    if( canFreeze && mVintageCache.isValid( aPeriod, primaryOutput ) ) {
+        mVintageCache.addRecordedQuantities();
+        return;
+    }
+
+    if( canFreeze ) {
+        MarketPriceCache::Scope cacheScope( mVintageCache, aPeriod );
+        mProductionFunction->calcDemand( mInputs, primaryOutput, aRegionName, aSectorName,
+                                         1, aPeriod, 0, mAlphaZero );
+        calcEmissionsAndOutputs( aRegionName, primaryOutput, aGDP, aPeriod );
+        mVintageCache.setValue( primaryOutput );
+    }
+    else {
+        // Calculate input demand.
+        mProductionFunction->calcDemand( mInputs, primaryOutput, aRegionName, aSectorName,
+                                         1, aPeriod, 0, mAlphaZero );
 
-    calcEmissionsAndOutputs( aRegionName, primaryOutput, aGDP, aPeriod );
+        calcEmissionsAndOutputs( aRegionName, primaryOutput, aGDP, aPeriod );
+    }
 }
 
 /*!
@@ -1421,14 +1496,46 @@ void Technology::calcCost( const string& aRegionName,
         assert( !util::isValidNumber( mCosts[ aPeriod ] ) );
     }
     else {
+        // The cost only depends on the market prices read by the inputs and
+        // outputs once initCalc has been called so if none of those have
+        // changed neither has the cost.
+        const bool canCache = mCostCache.get() && canCacheCost();
+        if( canCache && mCostCache->isValid( aPeriod, mCosts[ aPeriod ] ) ) {
+            // Optionally recalculate the cost anyway to check that the cache
+            // did not miss a dependency.
+            static const bool verifyCache = Configuration::getInstance()->getBool( "verify-price-caches" );
+            if( verifyCache ) {
+                const double cost = getTotalInputCost( aRegionName, aSectorName, aPeriod )
+                    * mPMultiplier -
+                    calcSecondaryValue( aRegionName, aPeriod );
+                if( !util::isEqual( cost, mCosts[ aPeriod ].get() ) ) {
+                    ILogger& mainLog = ILogger::getLogger( "main_log" );
+                    mainLog.setLevel( ILogger::WARNING );
+                    mainLog << "Cached cost " << mCosts[ aPeriod ] << " of technology " << mName
+                            << " in sector " << aSectorName << " and region " << aRegionName
+                            << " differs from the recalculated cost " << cost << "." << endl;
+                }
+            }
+            return;
+        }
+
         // Note we now allow costs in any sector to be <= 0.  If,
         // however, you are using the relative cost logit, costs will be
         // clamped on the low end for market share purposes (not for
         // other purposes, though).
-        
-        double cost = getTotalInputCost( aRegionName, aSectorName, aPeriod )
-            * mPMultiplier -
-            calcSecondaryValue( aRegionName, aPeriod );
+        double cost;
+        if( canCache ) {
+            MarketPriceCache::Scope cacheScope( *mCostCache, aPeriod );
+            cost = getTotalInputCost( aRegionName, aSectorName, aPeriod )
+                * mPMultiplier -
+                calcSecondaryValue( aRegionName, aPeriod );
+            mCostCache->setValue( cost );
+        }
+        else {
+            cost = getTotalInputCost( aRegionName, aSectorName, aPeriod )
+                * mPMultiplier -
+                calcSecondaryValue( aRegionName, aPeriod );
+        }
 
         mCosts[ aPeriod ] = cost;
         
@@ -1436,6 +1543,28 @@ void Technology::calcCost( const string& aRegionName,
     } 
 }
 
+/*!
+ * \brief Whether calcCost may skip recalculating the cost when none of the
+ *        market prices it read have changed.
+ * \details This is the case when the cost depends only on market prices and
+ *          the parameters set in initCalc.  Subclasses which change input
+ *          prices or coefficients in calcCost based on anything else, such as
+ *          the backup and resource calculations of IntermittentTechnology and
+ *          so of WindTechnology and SolarTechnology, must return false.  So
+ *          must any new subclass whose getTotalInputCost or
+ *          calcSecondaryValue reads market information or supplies rather
+ *          than prices.  AgProductionTechnology, UnmanagedLandTechnology and
+ *          TranTechnology override calcCost entirely and so never use the
+ *          cost cache.  The same applies to skipping the production of
+ *          vintages as the input demands then also depend on what calcCost
+ *          changed.  The cost cache is additionally only used when the
+ *          cache-technology-costs configuration option is set.
+ * \return Whether the cost may be cached.
+ */
+bool Technology::canCacheCost() const {
+    return true;
+}
+
 /*!
 * \brief Get the total cost of the technology for a period.
 * \details Returns the previously calculated cost for a period.
@@ -1496,15 +1625,10 @@ const vector<string> Technology::getGHGNames() const
 }
 
 /*! \brief returns the number of ghg objects.
-*
-* Calcuation is done using length of GHG string to be consistant with use of ghg names to access GHG information.
-*
-*
 * \author Steve Smith
 */
 int Technology::getNumbGHGs()  const {
-    vector<string> ghgNames = getGHGNames();
-    return static_cast<int>( ghgNames.size() ); 
+    return static_cast<int>( mGHG.size() ); 
 }
 
 
@@ -132,14 +132,40 @@ void TranTechnology::initCalc( const string& aRegionName,
         mainLog.setLevel( ILogger::ERROR );
         mainLog << "LoadFactor was zero in technology: " << mName << ". Reset to 1." << endl;
     }
+
+    // The input types do not change during the period so determine the unit
+    // conversion of each input once rather than in every cost calculation.
+    // See getEnergyCost and getNonEnergyCost.
+    const double CVRT90 = 2.212; // 1975 $ to 1990 $
+    const double JPERBTU = 1055; // 1055 Joules per BTU
+    const double GIGA = 1.0E9; // for getting price per GJ
+    mInputCostConversion.resize( mInputs.size() );
+    for( unsigned int i = 0; i < mInputs.size(); ++i ) {
+        mInputCostConversion[ i ] = mInputs[ i ]->hasTypeFlag( IInput::ENERGY ) ?
+            JPERBTU / GIGA * CVRT90 : 1.0;
+    }
 }
 
 double TranTechnology::getTotalInputCost( const string& aRegionName,
                                           const string& aSectorName,
                                           const int aPeriod ) const
 {
-    return getEnergyCost( aRegionName, aSectorName, aPeriod) + 
-           getNonEnergyCost( aRegionName, aSectorName, aPeriod);
+    // Fall back to the separate energy and non-energy costs if the conversions
+    // have not been set up.
+    if( mInputCostConversion.size() != mInputs.size() ) {
+        return getEnergyCost( aRegionName, aSectorName, aPeriod) + 
+               getNonEnergyCost( aRegionName, aSectorName, aPeriod);
+    }
+
+    // Sum the energy and non-energy costs in a single pass over the inputs.
+    // TODO: Leontief assumption.
+    double cost = 0;
+    for( unsigned int i = 0; i < mInputs.size(); ++i ) {
+        cost += mInputs[ i ]->getPrice( aRegionName, aPeriod )
+                * mInputs[ i ]->getCoefficient( aPeriod )
+                * mInputCostConversion[ i ];
+    }
+    return cost / mAlphaZero;
 }
 
 /*! \brief This function calculates the sum of the Carbon Values for all GHG's
@@ -47,7 +47,9 @@
 
 using namespace std;
 
-VintageProductionState::VintageProductionState()
+VintageProductionState::VintageProductionState():
+mAgeShutdownCoef( 1 ),
+mHasProfitDeciders( false )
 {
     mInitialYear = -1;
 }
@@ -56,6 +58,8 @@ VintageProductionState* VintageProductionState::clone() const {
     VintageProductionState* clone = new VintageProductionState();
     clone->mBaseOutput = mBaseOutput;
     clone->mInitialYear = mInitialYear;
+    clone->mAgeShutdownCoef = mAgeShutdownCoef;
+    clone->mHasProfitDeciders = mHasProfitDeciders;
     return clone;
 }
 
@@ -124,12 +128,12 @@ double VintageProductionState::calcShutdownCoefficient( const string& aRegionNam
                                                        const MarginalProfitCalculator* aMarginalProfitCalc,
                                                        const int aPeriod ) const
 {
-    // Loop through the shutdown decision makers and calculate the product of
-    // their coefficients.
-    double shutdownCoef = 1;
+    // Start from the product of the coefficients which only depend on age and
+    // multiply in those of the shutdown decision makers which use the profit rate.
+    double shutdownCoef = mAgeShutdownCoef;
 
-    // Avoid expensive marginal profit calculation if there are no shutdown deciders.
-    if( aShutdownDeciders.empty() ){
+    // Avoid expensive marginal profit calculation if no shutdown deciders need it.
+    if( !mHasProfitDeciders ){
         return shutdownCoef;
     }
 
@@ -138,12 +142,41 @@ double VintageProductionState::calcShutdownCoefficient( const string& aRegionNam
         aPeriod );
 
     for( unsigned int i = 0; i < aShutdownDeciders.size(); ++i ){
-        shutdownCoef *= aShutdownDeciders[ i ]->calcShutdownCoef( 0, marginalProfit, aRegionName,
-            aSectorName, mInitialYear, aPeriod );
+        if( aShutdownDeciders[ i ]->isProfitDependent() ){
+            shutdownCoef *= aShutdownDeciders[ i ]->calcShutdownCoef( 0, marginalProfit, aRegionName,
+                aSectorName, mInitialYear, aPeriod );
+        }
     }
     return shutdownCoef;
 }
 
+/*!
+* \brief Calculate the product of the shutdown coefficients which only depend on
+*        the age of the vintage.
+* \details The state is created for a single period so these coefficients are
+*          fixed for its lifetime and calcShutdownCoefficient only needs to
+*          evaluate the deciders which depend on the profit rate.  Must be
+*          called after setBaseOutput so that the initial year is known.
+* \param aShutdownDeciders Set of shutdown decision makers.
+* \param aPeriod Model period.
+*/
+void VintageProductionState::initShutdownCoefficient( const vector<IShutdownDecider*>& aShutdownDeciders,
+                                                      const int aPeriod )
+{
+    mAgeShutdownCoef = 1;
+    mHasProfitDeciders = false;
+    for( unsigned int i = 0; i < aShutdownDeciders.size(); ++i ){
+        if( aShutdownDeciders[ i ]->isProfitDependent() ){
+            mHasProfitDeciders = true;
+        }
+        else {
+            // The region and sector names are not used by age based deciders.
+            mAgeShutdownCoef *= aShutdownDeciders[ i ]->calcShutdownCoef( 0, 0, "", "",
+                mInitialYear, aPeriod );
+        }
+    }
+}
+
 void VintageProductionState::setBaseOutput( const double aBaseOutput,
                                            const int aBaseYear )
 {
@@ -0,0 +1,133 @@
+#ifndef _ACTIVITY_PROFILER_H_
+#define _ACTIVITY_PROFILER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file activity_profiler.h
+* \ingroup Objects
+* \brief Header file for the ActivityProfiler class.
+*/
+
+#include <map>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <boost/core/noncopyable.hpp>
+
+class IActivity;
+
+/*!
+* \ingroup Objects
+* \brief Measures the number of calls to and the time taken by each IActivity
+*        of the global ordering, split into full and partial evaluations.
+* \details The profiler is turned on by the profile-activities configuration
+*          bool.  World::calc and the flow graph record each call to an
+*          activity as a full evaluation if the whole model is being
+*          calculated and as a partial evaluation otherwise.  At the end of
+*          each period reportPeriod prints the activities which took the most
+*          time to the main log, appends all of them, slowest first, to the
+*          optional "activity-profile" file and resets the counts for the next
+*          period.  The full evaluation times of the whole run are kept so that
+*          ActivityCostModel may write them to the parallel cost file.
+* \note The counts are updated atomically as the partial derivatives may
+*       calculate the same activity on several threads at once.
+*/
+class ActivityProfiler : private boost::noncopyable {
+public:
+    //! The clock used to time the activities.
+    typedef std::chrono::steady_clock Clock;
+
+    //! The calls to and time taken by a single activity.
+    struct Counts {
+        Counts();
+
+        //! The number of calls during full evaluations.
+        std::atomic<uint64_t> mFullCalls;
+
+        //! The time taken by full evaluations in nanoseconds.
+        std::atomic<uint64_t> mFullNanoseconds;
+
+        //! The number of calls during partial evaluations.
+        std::atomic<uint64_t> mPartialCalls;
+
+        //! The time taken by partial evaluations in nanoseconds.
+        std::atomic<uint64_t> mPartialNanoseconds;
+    };
+
+    //! The full evaluation calls and time of an activity over the whole run.
+    struct RunCost {
+        RunCost() : mCalls( 0 ), mSeconds( 0.0 ) {}
+
+        //! The number of calls.
+        uint64_t mCalls;
+
+        //! The total time in seconds.
+        double mSeconds;
+    };
+
+    static ActivityProfiler& getInstance();
+
+    bool isEnabled() const;
+
+    void setActivities( const std::vector<IActivity*>& aActivities );
+
+    Counts* getCounts( const IActivity* aActivity );
+
+    static void record( Counts* aCounts, const bool aIsFullCalc, const Clock::time_point aStart );
+
+    void reportPeriod( const int aYear );
+
+    const std::map<const IActivity*, RunCost>& getRunCosts() const;
+private:
+    ActivityProfiler();
+
+    //! Whether activities should be timed.
+    bool mEnabled;
+
+    //! Whether the activity profile file has been started during this run.
+    bool mStartedFile;
+
+    //! The counts of the current period by activity, the elements of which do
+    //! not move once created so that callers may hold on to them.
+    std::map<const IActivity*, Counts> mCounts;
+
+    //! The full evaluation costs of previous periods by activity.
+    std::map<const IActivity*, RunCost> mRunCosts;
+};
+
+#endif // _ACTIVITY_PROFILER_H_
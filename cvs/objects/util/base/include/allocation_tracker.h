@@ -0,0 +1,91 @@
+#ifndef _ALLOCATION_TRACKER_H_
+#define _ALLOCATION_TRACKER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file allocation_tracker.h
+* \ingroup Objects
+* \brief Header file for the AllocationTracker class.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_TRACK_ALLOCATIONS
+#include <iosfwd>
+#include <cstdint>
+
+class IActivity;
+
+/*!
+* \ingroup Objects
+* \brief Counts the heap allocations made by the model.
+* \details When GCAM_TRACK_ALLOCATIONS is set the global operator new is
+*          replaced so that every allocation is counted, both for the
+*          allocating thread and for the process as a whole.  Each Timer
+*          records the allocations made between its start and stop so that
+*          the TimerRegistry report includes the allocations of each solver
+*          phase.  World::calc and the flow graph record the allocations made
+*          by each IActivity which are reported, most allocations first, after
+*          the timers at the end of the scenario.
+* \note The process counts include the allocations of all threads so the
+*       counts of a phase include any other work done concurrently.
+*/
+class AllocationTracker {
+public:
+    //! A number of allocations and the bytes requested by them.
+    struct Counts {
+        //! The number of allocations.
+        uint64_t mAllocations;
+
+        //! The total bytes requested.
+        uint64_t mBytes;
+    };
+
+    static Counts getThreadCounts();
+
+    static Counts getTotalCounts();
+
+    static void recordActivity( const IActivity* aActivity, const Counts& aStart );
+
+    static void printActivities( std::ostream& aOut );
+
+    static void clearActivities();
+};
+
+#endif // GCAM_TRACK_ALLOCATIONS
+
+#endif // _ALLOCATION_TRACKER_H_
@@ -48,6 +48,9 @@
 #include <boost/shared_ptr.hpp>
 #include <boost/noncopyable.hpp>
 #include <memory>
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
 
 // Forward declare the HashMap.
 template <class T, class U> class HashMap;
@@ -76,7 +79,10 @@ namespace objects {
     *          of their constructors. Registered atoms are kept for the entire
     *          lifetime of the model. They may be fetched using the findAtom
     *          function which searches the internal hashmap to find the requested
-    *          Atom.
+    *          Atom, or interned with the getAtom function which will create the
+    *          Atom if it does not already exist. Atoms should be created while
+    *          the model is being read in and initialized as concurrent lookups
+    *          are only safe once all Atoms have been created.
     * \author Josh Lurz
     */
     class AtomRegistry: boost::noncopyable {
@@ -85,6 +91,7 @@ namespace objects {
 		~AtomRegistry();
 		static AtomRegistry* getInstance();
 		const Atom* findAtom( const std::string& aID ) const;
+		const Atom* getAtom( const std::string& aID );
 	private:
 		AtomRegistry();
 		bool registerAtom( Atom* aAtom );
@@ -109,6 +116,10 @@ namespace objects {
 		*          resize operation.
         */
 		std::auto_ptr<AtomMap> mAtoms;
+#if GCAM_PARALLEL_ENABLED
+		//! Lock which serializes the creation of Atoms in getAtom.
+		tbb::spin_mutex mCreateLock;
+#endif
 	};
 }
 
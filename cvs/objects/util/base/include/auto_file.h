@@ -52,10 +52,21 @@
 #include "util/base/include/configuration.h"
 #include "util/base/include/util.h"
 
+#if GCAM_GZIP_INPUT
+#include <boost/iostreams/filter/gzip.hpp>
+#endif
+
+#if GCAM_PARALLEL_ENABLED
+#include <boost/shared_ptr.hpp>
+#include "reporting/include/async_output_sink.h"
+#endif
+
 /*!
 * \ingroup util
 * \brief A class which wraps a file stream so that it is automatically opened
 *        and closed. 
+* \details Files with names ending in .gz are gzip compressed if the model
+*          was built with GCAM_GZIP_INPUT.
 * \author Josh Lurz
 */
 class AutoOutputFile {
@@ -69,10 +80,15 @@ public:
     * \param aDefaultName Filename to use if the variable is not found.
     * \param aShouldWriteOverride If we should not write the file even if the user
     *                             specified they want it, i.e. when target finding.
+    * \param aWriteInBackground Whether the compression, if any, and the writes
+    *                           to the file should be done on a separate thread
+    *                           so that they overlap producing the output.  This
+    *                           is ignored without GCAM_PARALLEL_ENABLED.
     */
     AutoOutputFile( const std::string& aConfVariableName,
                     const std::string& aDefaultName,
-                    const bool aShouldWriteOverride = true )
+                    const bool aShouldWriteOverride = true,
+                    const bool aWriteInBackground = false )
         :mShouldWrite( aShouldWriteOverride && Configuration::getInstance()->shouldWriteFile( aConfVariableName ) )
     {
         const Configuration* conf = Configuration::getInstance();
@@ -81,9 +97,21 @@ public:
             if( conf->shouldAppendScnToFile( aConfVariableName ) ) {
                 fileName = util::appendScenarioToFileName( fileName );
             }
-            boost::iostreams::file_sink fileBuffer( fileName );
-            mWrappedFile.push( fileBuffer );
-            util::checkIsOpen( fileBuffer, fileName );
+#if GCAM_PARALLEL_ENABLED
+            if( aWriteInBackground ) {
+                // The writer thread owns the file stream and closes it, which
+                // finishes any compression, once the last data is written.
+                boost::shared_ptr<boost::iostreams::filtering_ostream> fileStream( new boost::iostreams::filtering_ostream() );
+                pushFile( *fileStream, fileName );
+                mWrappedFile.push( AsyncOutputSink( [fileStream]( const char* aData, std::streamsize aLength ) {
+                                                        fileStream->write( aData, aLength );
+                                                    },
+                                                    [fileStream]() { fileStream->reset(); },
+                                                    BACKGROUND_CHUNK_SIZE, BACKGROUND_MAX_CHUNKS ) );
+                return;
+            }
+#endif
+            pushFile( mWrappedFile, fileName );
         }
         else {
             mWrappedFile.push( boost::iostreams::null_sink() );
@@ -99,9 +127,7 @@ public:
     explicit AutoOutputFile( const std::string& aFileName )
         :mShouldWrite( true )
     {
-        boost::iostreams::file_sink fileBuffer( aFileName );
-        mWrappedFile.push( fileBuffer );
-        util::checkIsOpen( fileBuffer, aFileName );
+        pushFile( mWrappedFile, aFileName );
     }
 
     /*! \brief Destructor which closes the internal file stream.*/
@@ -133,6 +159,36 @@ public:
         return mWrappedFile;
     }
 protected:
+    /*! \brief Complete a stream with a compressor if needed and the file.
+    * \param aStream The stream to complete.
+    * \param aFileName Name of the file to open.
+    */
+    static void pushFile( boost::iostreams::filtering_ostream& aStream, const std::string& aFileName ) {
+        const std::string GZIP_EXTENSION = ".gz";
+        if( aFileName.size() > GZIP_EXTENSION.size() &&
+            aFileName.compare( aFileName.size() - GZIP_EXTENSION.size(), GZIP_EXTENSION.size(), GZIP_EXTENSION ) == 0 )
+        {
+#if GCAM_GZIP_INPUT
+            aStream.push( boost::iostreams::gzip_compressor() );
+#else
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Writing " << aFileName << " uncompressed as gzip support was not enabled when the model was built." << std::endl;
+#endif
+        }
+        boost::iostreams::file_sink fileBuffer( aFileName );
+        aStream.push( fileBuffer );
+        util::checkIsOpen( fileBuffer, aFileName );
+    }
+
+#if GCAM_PARALLEL_ENABLED
+    //! The size of the blocks of data handed to the writer thread.
+    static const std::streamsize BACKGROUND_CHUNK_SIZE = 1024 * 1024;
+
+    //! The number of blocks which may wait for the writer thread.
+    static const size_t BACKGROUND_MAX_CHUNKS = 8;
+#endif
+
     //! The wrapped file/null stream.
     boost::iostreams::filtering_ostream mWrappedFile;
 
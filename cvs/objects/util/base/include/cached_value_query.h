@@ -0,0 +1,97 @@
+#ifndef _CACHED_VALUE_QUERY_H_
+#define _CACHED_VALUE_QUERY_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+* \file cached_value_query.h
+* \ingroup Objects
+* \brief Header file for the CachedValueQuery class.
+*/
+
+#include <string>
+#include <vector>
+
+class Scenario;
+class Value;
+struct FilterStep;
+
+/*!
+* \ingroup Objects
+* \brief A GCAMFusion query for Value Data which is resolved once and then
+*        reused until it is invalidated.
+* \details The query string is parsed into FilterSteps when the object is
+*          created, which among other things compiles any regular expressions,
+*          and the steps are kept for the life of the object.  The first call
+*          to getValues searches the model and stores a pointer to every Value
+*          matched, where a matched array contributes each of its elements.
+*          Later calls return the stored pointers directly without searching
+*          the model again so repeatedly reading or setting the same Values is
+*          no more expensive than iterating a vector.  Data of any type other
+*          than Value is ignored.
+* \warning The pointers are only valid while the containers holding the Values
+*          are neither added nor removed.  The owner must call invalidate if the
+*          model structure may have changed, for instance after new input has
+*          been parsed.
+*/
+class CachedValueQuery {
+public:
+    explicit CachedValueQuery( const std::string& aQuery );
+    ~CachedValueQuery();
+
+    const std::vector<Value*>& getValues( Scenario* aScenario );
+
+    void invalidate();
+
+    // Templated callback for GCAMFusion
+    template<typename DataType>
+    void processData( DataType& aData );
+private:
+    //! The parsed steps of the query.
+    std::vector<FilterStep*> mFilterSteps;
+
+    //! The Values matched by the query when it was last resolved.
+    std::vector<Value*> mValues;
+
+    //! Whether mValues is up to date.
+    bool mIsResolved;
+
+    // Not copyable since the filter steps are owned.
+    CachedValueQuery( const CachedValueQuery& );
+    CachedValueQuery& operator=( const CachedValueQuery& );
+};
+
+#endif // _CACHED_VALUE_QUERY_H_
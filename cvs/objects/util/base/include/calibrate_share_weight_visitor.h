@@ -72,6 +72,8 @@ public:
 
     CalibrateShareWeightVisitor( const std::string& aRegionName, const GDP* aGDP );
 
+    void calibrateSector( const Sector* aSector, const int aPeriod );
+
     // Documentation for visitor methods is inherited.
     virtual void startVisitSector( const Sector* aSector,
                                    const int aPeriod );
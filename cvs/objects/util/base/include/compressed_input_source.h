@@ -0,0 +1,76 @@
+#ifndef _COMPRESSED_INPUT_SOURCE_H_
+#define _COMPRESSED_INPUT_SOURCE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file compressed_input_source.h
+* \ingroup Objects
+* \brief Header file for the CompressedInputSource class.
+*/
+
+#include <string>
+#include <xercesc/sax/InputSource.hpp>
+
+/*!
+* \ingroup Objects
+* \brief A Xerces input source which decompresses a gzip or zstd compressed
+*        XML file as it is read.
+* \details The compressed file is opened when the parser asks for a stream and
+*          is decompressed in small blocks as the parser consumes it so that the
+*          uncompressed document is never held in memory or written to disk.
+*          Files are recognized as compressed by their extension, ".gz" for
+*          gzip and ".zst" for zstd, and any other file is left to the parser to
+*          open directly.  Support for each format is compiled in only when
+*          GCAM_GZIP_INPUT or GCAM_ZSTD_INPUT is set since they require linking
+*          against Boost.Iostreams and the compression library.  Attempting to
+*          read a compressed file without that support is reported as an error.
+*/
+class CompressedInputSource : public xercesc::InputSource {
+public:
+    explicit CompressedInputSource( const std::string& aFileName );
+    virtual ~CompressedInputSource();
+
+    static bool isCompressed( const std::string& aFileName );
+    
+    virtual xercesc::BinInputStream* makeStream() const;
+private:
+    //! The name of the compressed file.
+    const std::string mFileName;
+};
+
+#endif // _COMPRESSED_INPUT_SOURCE_H_
@@ -0,0 +1,75 @@
+#ifndef _CONCURRENT_XML_PARSER_H_
+#define _CONCURRENT_XML_PARSER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file concurrent_xml_parser.h
+* \ingroup Objects
+* \brief Header file for the ConcurrentXMLParser class.
+*/
+
+#include <string>
+#include <list>
+
+class IParsable;
+
+/*!
+* \ingroup Objects
+* \brief Reads a list of XML input files concurrently while parsing them into
+*        the model one at a time in order.
+* \details Building the DOM for an input file with Xerces is CPU bound and
+*          independent of any other file, while parsing the DOM into the model
+*          must be done in the configured order to keep the add and delete
+*          semantics of the files.  This class therefore reads up to a window
+*          of files ahead on TBB worker threads, each with its own DOM parser,
+*          while the calling thread passes each completed document to XMLParse
+*          in order and releases it.  The window bounds how many documents are
+*          held in memory at once.  In builds without TBB the files are simply
+*          read and parsed one after another.
+*
+*          This is used for the scenario input files when the boolean
+*          configuration value "parallel-xml-parse" is set.  The window is set
+*          by the integer value "parallel-xml-parse-window" and defaults to the
+*          number of threads.
+*/
+class ConcurrentXMLParser {
+public:
+    static bool parseXMLFiles( const std::list<std::string>& aXMLFiles, IParsable* aModelElement );
+};
+
+#endif // _CONCURRENT_XML_PARSER_H_
@@ -0,0 +1,105 @@
+#ifndef _CSV_OUTPUT_BUFFER_H_
+#define _CSV_OUTPUT_BUFFER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file csv_output_buffer.h
+* \ingroup Objects
+* \brief CSVOutputBuffer class header file.
+*/
+
+#include <string>
+#include <vector>
+#include <iosfwd>
+#include <boost/core/noncopyable.hpp>
+
+/*!
+ * \ingroup Objects
+ * \brief Assembles the rows of the CSV output file in memory and writes them
+ *        in large blocks.
+ * \details The legacy csvOutputFile methods write each row through fileoutput3
+ *          which appends to the buffer made current for the calling thread by
+ *          a CSVOutputBuffer::Scope.  Each row is built in full, numbers
+ *          formatted as the stream would by default, and the buffer is only
+ *          written once it reaches FLUSH_SIZE or is destroyed.  A buffer
+ *          created without a stream only collects rows, which allows the rows
+ *          of each region to be assembled concurrently and then appended in
+ *          order to the buffer of the file.
+ */
+class CSVOutputBuffer : private boost::noncopyable {
+public:
+    /*!
+     * \brief Makes a buffer current for the calling thread for the lifetime of
+     *        the scope, restoring the previous one afterwards.
+     */
+    class Scope : private boost::noncopyable {
+    public:
+        explicit Scope( CSVOutputBuffer& aBuffer );
+        ~Scope();
+    private:
+        //! The buffer which was current before this scope.
+        CSVOutputBuffer* mPrevious;
+    };
+
+    //! The size at which the rows are written to the stream.
+    static const size_t FLUSH_SIZE = 1 << 20;
+
+    CSVOutputBuffer();
+
+    explicit CSVOutputBuffer( std::ostream& aOut );
+
+    ~CSVOutputBuffer();
+
+    static CSVOutputBuffer* getCurrent();
+
+    void appendRow( const std::string& aVar1, const std::string& aVar2, const std::string& aVar3,
+                    const std::string& aVar4, const std::string& aVar5, const std::string& aUnit,
+                    const std::vector<double>& aValues );
+
+    void append( CSVOutputBuffer& aOther );
+
+    void flush();
+private:
+    //! The stream the rows are written to, null if they are only collected.
+    std::ostream* mOut;
+
+    //! The rows which have not yet been written.
+    std::string mRows;
+};
+
+#endif // _CSV_OUTPUT_BUFFER_H_
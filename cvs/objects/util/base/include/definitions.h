@@ -71,6 +71,51 @@
 #define __HAVE_JAVA__ 1
 #endif
 
+//! A flag which turns on or off the compilation of the MPI code.
+#ifndef GCAM_USE_MPI
+#define GCAM_USE_MPI 0
+#endif
+
+//! A flag which turns on or off reading gzip compressed input files.
+#ifndef GCAM_GZIP_INPUT
+#define GCAM_GZIP_INPUT 0
+#endif
+
+//! A flag which turns on or off reading zstd compressed input files.
+#ifndef GCAM_ZSTD_INPUT
+#define GCAM_ZSTD_INPUT 0
+#endif
+
+//! A flag which turns on or off using the SLEEF vectorized math library for
+//! batched exp and log in the share calculations.
+#ifndef GCAM_USE_SLEEF
+#define GCAM_USE_SLEEF 0
+#endif
+
+//! A flag which turns on or off factoring large dense matrices on a GPU with
+//! cuSOLVER, see GPUDenseLU.
+#ifndef GCAM_USE_CUSOLVER
+#define GCAM_USE_CUSOLVER 0
+#endif
+
+//! A flag which turns on or off counting heap allocations by timer and by
+//! activity, see AllocationTracker.
+#ifndef GCAM_TRACK_ALLOCATIONS
+#define GCAM_TRACK_ALLOCATIONS 0
+#endif
+
+//! A flag which turns on or off timing the nested scopes marked with
+//! GCAM_PROFILE_SCOPE, see ScopeProfiler.
+#ifndef GCAM_PROFILE_SCOPES
+#define GCAM_PROFILE_SCOPES 0
+#endif
+
+//! A flag which turns on or off reading the Linux CPU performance counters
+//! when timers start and stop, see HardwareCounters.
+#ifndef GCAM_USE_PERF_COUNTERS
+#define GCAM_USE_PERF_COUNTERS 0
+#endif
+
 //! A flag which turns on or off the compilation of the hector climate model code.
 #ifndef USE_HECTOR
 #define USE_HECTOR 1
@@ -0,0 +1,118 @@
+#ifndef _DETERMINISTIC_REDUCTION_H_
+#define _DETERMINISTIC_REDUCTION_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file deterministic_reduction.h
+* \ingroup Objects
+* \brief Header file for the DeterministicReduction class.
+*/
+
+#include <vector>
+
+class IActivity;
+
+/*!
+* \ingroup Objects
+* \brief Makes the market supplies and demands accumulated by the flow graph
+*        independent of the order in which activities happen to run.
+* \details When GCAM_PARALLEL_ENABLED the activities of the flow graph add to
+*          the supply and demand of shared markets from several threads at
+*          once and Value::addConcurrent sums the quantities in whatever order
+*          they arrive.  Floating point addition is not associative, so the
+*          totals, and so the prices found, differ slightly from run to run and
+*          with the number of threads.  When the deterministic-reduction
+*          configuration bool is set the flow graph calculation instead records
+*          each quantity along with the position of the activity adding it in
+*          the global ordering and the number of quantities that activity has
+*          already added.  A total is then always the value it started the
+*          calculation with plus its quantities added one at a time in that
+*          order, which is exactly the sum a serial calculation of the global
+*          ordering would find.  The total is kept up to date as quantities are
+*          added so that activities which read it later in the calculation see
+*          the same value as they would in serial.
+* \note Only the flow graph calculation needs this.  Calculations of a list of
+*       activities are done in order on a single thread even if several run at
+*       once on different states.
+* \warning Quantities which arrive out of order require the partial sums of
+*          the quantities after them to be redone, so this mode is slower than
+*          the normal atomic additions.
+*/
+class DeterministicReduction {
+public:
+    static void setEnabled( const bool aEnabled );
+
+    static void setActivities( const std::vector<IActivity*>& aActivities );
+
+    static void beginCalc();
+
+    static void endCalc();
+
+    /*!
+     * \brief Whether a flow graph calculation with deterministic reduction is
+     *        in progress.
+     * \return True if additions should go through add.
+     */
+    static bool isActive() {
+        return sActive;
+    }
+
+    static void add( double& aTotal, const double aValue );
+
+    /*!
+     * \brief Identifies the activity on the calling thread for as long as the
+     *        object is in scope.
+     * \details Does nothing unless a deterministic calculation is active.
+     */
+    class ScopedActivity {
+    public:
+        explicit ScopedActivity( const IActivity* aActivity );
+        ~ScopedActivity();
+    private:
+        //! Whether this object set the activity of the thread.
+        bool mIsSet;
+    };
+private:
+    //! Whether the mode is turned on in the configuration.
+    static bool sEnabled;
+
+    //! Whether a flow graph calculation is using the mode right now.
+    static bool sActive;
+};
+
+#endif // _DETERMINISTIC_REDUCTION_H_
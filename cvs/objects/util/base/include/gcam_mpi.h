@@ -0,0 +1,131 @@
+#ifndef _GCAM_MPI_H_
+#define _GCAM_MPI_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+* \file gcam_mpi.h
+* \ingroup Objects
+* \brief Header file for the GcamMPI class.
+*/
+
+#include <string>
+#include <vector>
+
+/*!
+* \ingroup Objects
+* \brief A thin wrapper around the MPI calls used by GCAM.
+* \details GCAM may optionally be built with MPI by setting GCAM_USE_MPI.  In
+*          that case several copies of the model may be launched with mpirun
+*          and they cooperate in one of two ways:
+*          - In batch mode the BatchRunner on rank 0 hands out scenarios to
+*            the other ranks as they become free and gathers their batch CSV
+*            results.
+*          - Otherwise, if the boolean configuration value
+*            "mpi-distribute-jacobian" is set, every rank runs the same
+*            scenario and the columns of each finite difference Jacobian are
+*            divided among the ranks.  Since each rank holds a full copy of the
+*            model they all follow identical solution paths.
+*
+*          Log files and the XML database location are given a rank suffix on
+*          ranks other than zero so that the ranks do not clobber each other.
+*          Batch worker processes forked by BatchRunner on a single rank are
+*          likewise given a worker suffix (see setBatchWorker).
+*          When GCAM is built without MPI all of these methods behave as a
+*          single rank and the messaging methods must not be called.
+*/
+class GcamMPI {
+public:
+    /*!
+     * \brief Initializes MPI on construction and finalizes it on destruction.
+     * \details A single Session should be created at the very start of main.
+     */
+    class Session {
+    public:
+        Session( int& aArgc, char**& aArgv );
+        ~Session();
+    private:
+        //! Private undefined copy constructor to prevent copying.
+        Session( const Session& );
+        //! Private undefined assignment operator to prevent copying.
+        Session& operator=( const Session& );
+    };
+
+    static int getRank();
+
+    static int getSize();
+
+    static bool isRoot();
+
+    static std::string getRankFileName( const std::string& aFileName );
+
+    static void setBatchWorker( const int aWorker );
+
+    static bool shouldDistributeJacobian();
+
+    static void setDistributeJacobian( const bool aDistribute );
+
+    static void allGather( const std::vector<double>& aLocal,
+                           std::vector<std::vector<double> >& aAll );
+
+    static void sendInts( const int aDest, const int aTag, const std::vector<int>& aValues );
+
+    static int recvInts( const int aSource, const int aTag, std::vector<int>& aValues );
+
+    static void sendString( const int aDest, const int aTag, const std::string& aValue );
+
+    static void recvString( const int aSource, const int aTag, std::string& aValue );
+
+    //! Source value that matches a message from any rank.
+    static const int ANY_SOURCE = -1;
+
+private:
+    //! The rank of this process, cached so that it may be read from any thread.
+    static int sRank;
+
+    //! The number of ranks.
+    static int sSize;
+
+    //! Whether the Jacobian should be distributed, -1 if not yet determined.
+    static int sDistributeJacobian;
+
+    //! The index of the batch worker this process is, -1 if it is not one.
+    static int sBatchWorker;
+};
+
+#endif // _GCAM_MPI_H_
@@ -0,0 +1,90 @@
+#ifndef _HARDWARE_COUNTERS_H_
+#define _HARDWARE_COUNTERS_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file hardware_counters.h
+* \ingroup Objects
+* \brief Header file for the HardwareCounters class.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_USE_PERF_COUNTERS
+#include <cstdint>
+
+/*!
+* \ingroup Objects
+* \brief Reads the CPU performance counters of the current thread.
+* \details When GCAM_USE_PERF_COUNTERS is set each thread which reads the
+*          counters opens a group of Linux perf_event counters for itself the
+*          first time it does so, counting the cycles, instructions, last level
+*          cache misses and branch misses of user space code.  Each Timer reads
+*          the counters when it starts and stops so that the TimerRegistry
+*          report and the period performance file show for each solver phase
+*          whether it is limited by memory or by computation.  If the counters
+*          can not be opened, for instance because of the perf_event_paranoid
+*          setting, a warning is logged once and all counts are zero.
+* \note Only the work of the thread which starts and stops a timer is counted,
+*       so the counts of a phase exclude work done by the flow graph's worker
+*       threads.  The counts are scaled if the kernel had to multiplex them.
+*/
+class HardwareCounters {
+public:
+    //! The values of the counters.
+    struct Counts {
+        //! The number of CPU cycles.
+        uint64_t mCycles;
+
+        //! The number of instructions retired.
+        uint64_t mInstructions;
+
+        //! The number of last level cache misses.
+        uint64_t mCacheMisses;
+
+        //! The number of mispredicted branches.
+        uint64_t mBranchMisses;
+    };
+
+    static Counts read();
+
+    static void accumulate( Counts& aTotal, const Counts& aStart, const Counts& aEnd );
+};
+
+#endif // GCAM_USE_PERF_COUNTERS
+
+#endif // _HARDWARE_COUNTERS_H_
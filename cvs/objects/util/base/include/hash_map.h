@@ -36,7 +36,6 @@
 *
 */
 
-
 /*! 
 * \file hash_map.h  
 * \ingroup Objects
@@ -46,10 +45,11 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cassert>
+#include <functional>
 
 #include "util/base/include/atom.h"
 #include <boost/functional/hash/hash.hpp>
-#include <boost/shared_ptr.hpp>
 
 //! Turn on hash map tuning. This imposes a slight overhead.
 #define TUNING_STATS 0
@@ -60,6 +60,33 @@
 #if TUNING_STATS
 #include <iostream>
 #endif
+
+/*!
+* \ingroup Objects
+* \brief The hash function used by HashMap.
+* \details This is the boost hash function, which uses the precomputed hash
+*          codes of Atoms, except for strings which use the standard library
+*          hash function. The boost string hash combines a single character at
+*          a time and is several times slower for names of the length used in
+*          the model, which dominates the time of a lookup.
+*/
+template<class Key>
+struct HashMapHash : public boost::hash<Key> {
+};
+
+//! String specialization of the HashMap hash function.
+template<>
+struct HashMapHash<std::string> {
+    size_t operator()( const std::string& aKey ) const {
+        return std::hash<std::string>()( aKey );
+    }
+};
+
+//! Constant string specialization of the HashMap hash function.
+template<>
+struct HashMapHash<const std::string> : public HashMapHash<std::string> {
+};
+
 /*!
 * \ingroup Objects
 * \brief A template object which implements a mapping of key to value using a
@@ -70,43 +97,39 @@
 *          key into a pseudo-random value distributed over the range of the
 *          internal storage array. If the hash function converts two distinct
 *          keys into the same value, a collision occurs which the map must
-*          handle. The hash map is implemented as a list of buckets, accessed by
-*          an integer index. Each bucket can contain a single key-value pairing,
-*          or a chain of pairings implemented as a linked list. If there are no
-*          collisions, then each bucket only contains a single key-value pair.
-*          When a collision does occur, the collided values are placed in the
-*          bucket's chain. As a result of this design, access to a value given a
-*          key can occur in constant time unless there is a collision on the
-*          key. To minimize collisions, the hashmap automatically increases its
-*          size to prevent the map from reaching over 40 percent of its
-*          capacity.
+*          handle. The hash map is implemented with open addressing: a single
+*          array of slots, the size of which is a power of two, is indexed by
+*          the low bits of the hash code and a collision is resolved by probing
+*          the following slots in turn until the key or an empty slot is found.
+*          Each slot records the full hash code of its key so that keys are
+*          only compared when the hash codes match, and so that growing the
+*          array never requires hashing a key again. The key-value pairs
+*          themselves are stored contiguously in insertion order in a separate
+*          vector so iteration does not have to skip empty slots. To keep
+*          probe sequences short the slot array is doubled in size whenever
+*          the map would become more than half full.
 * \note This is not currently a complete map implementation, it only allows for
 *       getting and setting individual values. There is currently not a way to
-*       iterate over the key-value set or remove keys from the map.
+*       remove keys from the map.
+* \note Keys with a precomputed hash code, such as interned Atoms, are not
+*       hashed again by the map. A caller which looks up the same key many
+*       times may also compute its hash code once with getHashCode and pass it
+*       to find.
+* \warning Adding a key may move the existing key-value pairs, which
+*          invalidates references and pointers to them but not iterators.
 * \note The Value type is required to implement the no-argument constructor.
 *       This condition must be true for standard library containers as well.
-* \note Do not use auto_ptrs as Values as they may be accidentally deleted during
-*       resizes. This is true of standard library containers as well.
 * \author Josh Lurz
 */
 
 template <class Key, class Value>
 class HashMap {
-private:
-	// Forward declare the Item so the interface is easier to read.
-	struct Item;
-
-    //! Typedef which defines the type of a pair containing pointer to an Item
-    //! and it's position in the bucket vector.
-    typedef std::pair<Item*,size_t> ItemPair;
-    typedef std::pair<const Item*, size_t> CItemPair;
 public:
 	/*! \brief Constant iterator to a HashMap. */
 	class const_iterator {
 	public:
         const_iterator();
-		explicit const_iterator( const Item* aCurrentItem,
-                                 const size_t aBucketPosition,
+		explicit const_iterator( const size_t aPosition,
                                  const HashMap* aParent );
 
 		bool operator==( const const_iterator& aOther ) const;
@@ -116,9 +139,8 @@ public:
         const_iterator& operator++();    // prefix ++
         const_iterator operator++(int); // postfix ++
 	protected:
-        //! The current item at which the iterator is pointing and it's bucket
-        //! spot.
-        CItemPair mCurrentItem;
+        //! The position in insertion order of the current item.
+        size_t mPosition;
 
         //! Pointer to the parent hashmap of the iterator.
         const HashMap* mParent;
@@ -129,8 +151,7 @@ public:
     class iterator: public const_iterator {
 	public:
         iterator();
-		explicit iterator( Item* aCurrentItem,
-                           const size_t aBucketPosition,
+		explicit iterator( const size_t aPosition,
                            const HashMap* aParent );
 
 		bool operator==( const iterator& aOther ) const;
@@ -147,52 +168,40 @@ public:
     size_t size() const;
 	std::pair<iterator, bool> insert( const std::pair<Key, Value> aKeyValuePair );
     Value& operator[]( const Key& aKey );
+    size_t getHashCode( const Key& aKey ) const;
 	const_iterator find( const Key& aKey ) const;
 	iterator find( const Key& aKey );
+	const_iterator find( const Key& aKey, const size_t aHashCode ) const;
+	iterator find( const Key& aKey, const size_t aHashCode );
 	const_iterator begin() const;
 	iterator begin();
 	const_iterator end() const;
 	iterator end();
 private:
-	void resize( const size_t aNewSize );
-    
-    CItemPair getFirstItem() const;
-    CItemPair getNextItem( const CItemPair& aItemPair ) const;
-    
-    ItemPair getFirstItem();
-    ItemPair getNextItem( const ItemPair& aItemPair );
+    /*! \brief A slot in the open addressing array.
+    * \details A slot refers to a key-value pair by its position in mEntries.
+    */
+    struct Slot {
+        //! The full hash code of the key.
+        size_t mHashCode;
 
-	//! The internal storage for the buckets.
-	std::vector<boost::shared_ptr<Item> > mBuckets;
+        //! One more than the position of the key-value pair in mEntries, or
+        //! zero if the slot is empty.
+        size_t mEntry;
+    };
 
-	//! Current size of the storage vector, which is greater than the number of
-    //! values.
-	size_t mSize;
+    size_t findSlot( const Key& aKey, const size_t aHashCode ) const;
 
-	//! Number of entries.
-	size_t mNumEntries;
+	void resize( const size_t aNewSize );
 
-	//! The hashmap's hash function
-	boost::hash<Key> mHashFunction;
+    //! The key-value pairs in insertion order.
+    std::vector<std::pair<Key, Value> > mEntries;
 
-	/*! \brief An item stores a key value pairing together.
-	* \details The Item structure stores the key value pairing, along with a
-	*          pointer to the next item in the bucket to allow chaining.
-    */
-	struct Item {
-		inline Item( const std::pair<Key, Value>& aKeyValuePair );
-		/*! \brief The key value pair.
-        */
-		std::pair<Key, Value> mKeyValuePair;
-
-		/*! \brief A pointer to the next Item in the bucket, null if it is the
-		*          last item in the bucket.
-		* \note The use of a smart pointer allows for an entire chain to be
-        *       deleted by deleting the head of the chain, which induces a
-        *       cascading deletion.
-        */
-		boost::shared_ptr<Item> mNext;
-	};
+	//! The open addressing array, the size of which is always a power of two.
+	std::vector<Slot> mSlots;
+
+	//! The hashmap's hash function
+	HashMapHash<Key> mHashFunction;
 
 #if( TUNING_STATS )
 	//! Number of collisions if TUNING_STATS is on.
@@ -205,21 +214,26 @@ private:
 
 /*! \brief Constructor
 * \details Construct a hashmap with a specified size.
-* \param aSize The initial size of the map. The map may grow from this size if
-*        enough entries are added.
+* \param aSize The initial size of the map, which is rounded up to a power of
+*        two. The map may grow from this size if enough entries are added.
 */
 template <class Key, class Value>
-HashMap<Key, Value>::HashMap( const size_t aSize ):
-mBuckets( aSize ), mSize( aSize ), mNumEntries( 0 )
+HashMap<Key, Value>::HashMap( const size_t aSize )
 #if( TUNING_STATS )
-, mNumCollisions( 0 ),
+: mNumCollisions( 0 ),
 mNumResizes( 0 )
 #endif
 {
+    size_t numSlots = 1;
+    while( numSlots < aSize ){
+        numSlots *= 2;
+    }
+    Slot emptySlot = { 0, 0 };
+    mSlots.assign( numSlots, emptySlot );
 }
 
 /*! \brief Destructor
-* \details All memory deallocation is performed by the smart pointers, the
+* \details All memory deallocation is performed by the containers, the
 *          destructor is only responsible for printing hash map statistics(if
 *          TUNING_STATS is compiled on).
 * \warning Deleting the map will not delete any allocated memory the user
@@ -229,10 +243,10 @@ mNumResizes( 0 )
 template <class Key, class Value>
 HashMap<Key, Value>::~HashMap(){
 #if( TUNING_STATS )
-	std::cout << "Hashmap stats - Size: " << static_cast<unsigned int>( mSize ) 
-		<< " Number of entries: " << static_cast<unsigned int>( mNumEntries )
+	std::cout << "Hashmap stats - Size: " << static_cast<unsigned int>( mSlots.size() ) 
+		<< " Number of entries: " << static_cast<unsigned int>( size() )
 		<< " Collisions: " << mNumCollisions << " Percent full : " 
-		<< static_cast<double>( mNumEntries ) / mSize * 100 
+		<< static_cast<double>( size() ) / mSlots.size() * 100 
 		<< " Number of resizes: " << mNumResizes << std::endl;
 #endif
 }
@@ -243,7 +257,7 @@ HashMap<Key, Value>::~HashMap(){
 template <class Key, class Value>
 bool
 HashMap<Key, Value>::empty() const {
-    return mNumEntries == 0;
+    return mEntries.empty();
 }
 
 /*! \brief Return the number of items in the hashmap.
@@ -252,18 +266,15 @@ HashMap<Key, Value>::empty() const {
 template <class Key, class Value>
 size_t
 HashMap<Key, Value>::size() const {
-    return mNumEntries;
+    return mEntries.size();
 }
 
 /*! \brief Insert a key-value pair to the map.
 * \details This function takes a key value pairing and adds it to the hashmap.
 *          To do this, it first calls the hash function on the key to determine
-*          which bucket the item should reside in. If the bucket is currently
-*          empty, the item is added as the first item in the bucket. Otherwise
-*          the linked list is traversed to see if the item already exists. If it
-*          does, the value is updated and the function will return true.
-*          Otherwise an item is added to the end of the list for this key-value
-*          pairing.
+*          which slot to start searching from. If the key is found the value
+*          is updated. Otherwise the pair is added after the existing pairs
+*          and the empty slot at which the search ended is set to refer to it.
 * \param aKeyValuePair The key value pair to add to the hashmap.
 * \return A pair consisting of the iterator where the value was found and a bool
 *         representing whether the insert was a new value.
@@ -271,93 +282,35 @@ HashMap<Key, Value>::size() const {
 template <class Key, class Value>
 std::pair<typename HashMap<Key, Value>::iterator, bool>
 HashMap<Key, Value>::insert( const std::pair<Key, Value> aKeyValuePair ){
-	// First find the hash value and use the modulo function to reduce it to
-	// within the size of the bucket vector.
-	const size_t bucketSpot = mHashFunction( aKeyValuePair.first ) % mSize;
-
-	// We now know which bucket to either add the value to or update. Begin the
-    // search.
-	Item* curr = mBuckets[ bucketSpot ].get();
-	Item* prev = 0;   
-
-	// If the head of the chain is null, avoid attempting to search. Keep
-	// searching until we find the correct Item or the end of the chain. Track
-	// the previous position in the chain so that we can add to the end if the
-	// key is not found.
-	bool update = false;
-	while( curr ){
-		// Check if this is the correct spot.
-		if( curr->mKeyValuePair.first == aKeyValuePair.first ){
-			// Stop the search here as this is the postion to update.
-			update = true;
-			break;
-		}
-
-		// Move to the next item in the chain, which may be null.
-		prev = curr;
-
-		/*! \invariant Ensure that a pointer is not being assigned a reference
-        *              to itself. 
-        */
-		assert( curr != curr->mNext.get() );
-
-		curr = curr->mNext.get();
-	}
-
-	// If we found a spot to update, curr will not be null as the loop will have
-	// been exited by the successful match. Update the value and return that the
-	// value existed.
-	if( update ){
-		curr->mKeyValuePair.second = aKeyValuePair.second;
-		return std::make_pair( iterator( curr, bucketSpot, this ), false );
-	}
-
-	// We are not updating, so a new value must be added.
-	boost::shared_ptr<Item> newValue( new Item( aKeyValuePair ) );
-	++mNumEntries;
-
-	// Add the entry as the first item in the bucket if there is not a previous
-    // pairing.
-	if( !prev ){
-		mBuckets[ bucketSpot ] = newValue;
+    const size_t hashCode = getHashCode( aKeyValuePair.first );
+    size_t slot = findSlot( aKeyValuePair.first, hashCode );
+
+	// If the slot is filled the key already exists so update the value and
+	// return that the value existed.
+	if( mSlots[ slot ].mEntry ){
+        const size_t position = mSlots[ slot ].mEntry - 1;
+		mEntries[ position ].second = aKeyValuePair.second;
+		return std::make_pair( iterator( position, this ), false );
 	}
-	else {
-		/*! \invariant Ensure that a loop is not created. */
-		assert( prev != newValue.get() );
 
-		// Add the new item to the end of the chain.
-		prev->mNext = newValue;
-#if( TUNING_STATS )
-		// Record the collision.
-		++mNumCollisions;
-#endif
-	}
-	// The ratio of entries to the maximum size of the map at which to increase
-	// the map size. This is currently a low threshold as the maps are adjusted
-    // for performance not size. This may need to be adjusted for small maps.
-	const double CAPACITY_THRESHHOLD = 0.4;
-
-	// The multiple of the current size to which to set the new size.
-	const unsigned int RESIZE_MULTIPLE = 3;
-
-	// An additional size increment which helps performance for small maps where
-    // resizing by the above factor would not be enough.
-	const unsigned int ADDITIONAL_INCREMENT = 5;
-
-	// Check if the size of the bucket vector should be increased for
-	// performance. This should be done if the ratio of full to total buckets
-	// exceeds CAPACITY_THRESHHOLD.
-	if( static_cast<double>( mNumEntries ) / mSize > CAPACITY_THRESHHOLD ){
-		// Resize to three times the number of current entries plus several
-		// extra to handle small hashmaps. The bucket was empty, so add it as
-		// the first value.
+	// Check if the slot array should be increased for performance. This should
+    // be done if it would become more than half full, in which case the empty
+    // slot for the key will have moved.
+	if( 2 * ( size() + 1 ) > mSlots.size() ){
 #if( TUNING_STATS )
 		++mNumResizes;
 #endif
-		resize( mNumEntries * RESIZE_MULTIPLE + ADDITIONAL_INCREMENT );
+		resize( 2 * mSlots.size() );
+        slot = findSlot( aKeyValuePair.first, hashCode );
 	}
+
+	// We are not updating, so a new value must be added.
+	mEntries.push_back( aKeyValuePair );
+    mSlots[ slot ].mHashCode = hashCode;
+    mSlots[ slot ].mEntry = size();
+
 	// Return that an add and not an update occurred.
-	return std::make_pair( iterator( newValue.get(), bucketSpot, this ), true );
+	return std::make_pair( iterator( size() - 1, this ), true );
 }
 
 /*!
@@ -389,6 +342,18 @@ HashMap<Key, Value>::operator[]( const Key& aKey ){
     return newPair.first->second;
 }
 
+/*! \brief Calculate the hash code the map uses for a key.
+* \details The result may be passed to find to avoid hashing a key which is
+*          looked up repeatedly.
+* \param aKey Key for which to calculate the hash code.
+* \return The hash code of the key.
+*/
+template <class Key, class Value>
+size_t
+HashMap<Key, Value>::getHashCode( const Key& aKey ) const {
+    return mHashFunction( aKey );
+}
+
 /*! \brief Returns a mutable iterator for a given key.
 * \details
 * \param aKey Key for which to return the value.
@@ -398,24 +363,9 @@ HashMap<Key, Value>::operator[]( const Key& aKey ){
 template <class Key, class Value>
 typename HashMap<Key, Value>::iterator
 HashMap<Key, Value>::find( const Key& aKey ){
-	// First find the hash value and use the modulus function to reduce it to
-	// within the size of the bucket vector.
-	const size_t bucketSpot = mHashFunction( aKey ) % mSize;
-
-	// We now know which bucket the key resides in if it exists.
-	Item* curr = mBuckets[ bucketSpot ].get();
-
-	// Keep searching until we find the correct Item or the end of the chain.
-	while( curr ){
-		// Check if this is the correct spot.
-		if( curr->mKeyValuePair.first == aKey ){
-			return iterator( curr, bucketSpot, this );
-		}
-		// Move to the next item in the chain, which may be null.
-		curr = curr->mNext.get();
-	}
-	// Return the end iterator is the key was not found.
-	return end();
+    const size_t entry = mSlots[ findSlot( aKey, getHashCode( aKey ) ) ].mEntry;
+	// Return the end iterator if the key was not found.
+    return entry ? iterator( entry - 1, this ) : end();
 }
 
 /*! \brief Returns an immutable value for a given key.
@@ -427,24 +377,43 @@ HashMap<Key, Value>::find( const Key& aKey ){
 template <class Key, class Value>
 typename HashMap<Key, Value>::const_iterator
 HashMap<Key, Value>::find( const Key& aKey ) const {
-	// First find the hash value and use the mod function to reduce it to within
-	// the size of the bucket vector.
-	const size_t bucketSpot = mHashFunction( aKey ) % mSize;
-
-	// We now know which bucket the key resides in if it exists.
-	const Item* curr = mBuckets[ bucketSpot ].get();
-
-	// Keep searching until we find the correct Item or the end of the chain.
-	while( curr ){
-		// Check if this is the correct spot.
-		if( curr->mKeyValuePair.first == aKey ){
-			return const_iterator( curr, bucketSpot, this );
-		}
-		// Move to the next item in the chain, which may be null.
-		curr = curr->mNext.get();
-	}
-	// Return the end iterator is the key was not found.
-	return end();
+    const size_t entry = mSlots[ findSlot( aKey, getHashCode( aKey ) ) ].mEntry;
+	// Return the end iterator if the key was not found.
+    return entry ? const_iterator( entry - 1, this ) : end();
+}
+
+/*! \brief Returns a mutable iterator for a given key with a known hash code.
+* \param aKey Key for which to return the value.
+* \param aHashCode The hash code of the key as returned by getHashCode.
+* \return An iterator to the requested value or the end iterator if the key was
+*         not found.
+*/
+template <class Key, class Value>
+typename HashMap<Key, Value>::iterator
+HashMap<Key, Value>::find( const Key& aKey, const size_t aHashCode ){
+    /*! \pre The hash code is that of the key. */
+    assert( aHashCode == getHashCode( aKey ) );
+
+    const size_t entry = mSlots[ findSlot( aKey, aHashCode ) ].mEntry;
+	// Return the end iterator if the key was not found.
+    return entry ? iterator( entry - 1, this ) : end();
+}
+
+/*! \brief Returns an immutable value for a given key with a known hash code.
+* \param aKey Key for which to return the value.
+* \param aHashCode The hash code of the key as returned by getHashCode.
+* \return A constant iterator to the result or the end iterator if the key is
+*         not found.
+*/
+template <class Key, class Value>
+typename HashMap<Key, Value>::const_iterator
+HashMap<Key, Value>::find( const Key& aKey, const size_t aHashCode ) const {
+    /*! \pre The hash code is that of the key. */
+    assert( aHashCode == getHashCode( aKey ) );
+
+    const size_t entry = mSlots[ findSlot( aKey, aHashCode ) ].mEntry;
+	// Return the end iterator if the key was not found.
+    return entry ? const_iterator( entry - 1, this ) : end();
 }
 
 /*! \brief Return the begin iterator.
@@ -454,8 +423,7 @@ HashMap<Key, Value>::find( const Key& aKey ) const {
 template<class Key, class Value>
 typename HashMap<Key, Value>::iterator
 HashMap<Key, Value>::begin() {
-    ItemPair itemPair = getFirstItem();
-	return iterator( itemPair.first, itemPair.second, this );
+	return iterator( 0, this );
 }
 
 /*! \brief Return the constant begin iterator.
@@ -465,8 +433,7 @@ HashMap<Key, Value>::begin() {
 template<class Key, class Value>
 typename HashMap<Key, Value>::const_iterator
 HashMap<Key, Value>::begin() const {
-    CItemPair itemPair = getFirstItem();
-	return const_iterator( itemPair.first, itemPair.second, this );
+	return const_iterator( 0, this );
 }
 
 /*! \brief Return the end iterator.
@@ -476,7 +443,7 @@ HashMap<Key, Value>::begin() const {
 template<class Key, class Value>
 typename HashMap<Key, Value>::iterator
 HashMap<Key, Value>::end() {
-	return iterator( 0, 0, 0 );
+	return iterator( size(), this );
 }
 
 /*! \brief Return the constant end iterator.
@@ -486,238 +453,58 @@ HashMap<Key, Value>::end() {
 template<class Key, class Value>
 typename HashMap<Key, Value>::const_iterator
 HashMap<Key, Value>::end() const {
-	return const_iterator( 0, 0, 0 );
+	return const_iterator( size(), this );
 }
 
-/*! \brief Resize the bucket vector. 
-* \details To resize the vector, the function first walks the hashmap to store
-*          the list of all items in the map. It then resizes the bucket vector
-*          and reinserts all the values into the map.
-* \warning This operation is very slow as it requires rehashing all entries.
-* \param aNewSize New size of the bucket vector.
+/*! \brief Find the slot which refers to a key or the empty slot where it would
+*          be added.
+* \details The search starts at the slot given by the low bits of the hash code
+*          and continues through the following slots, wrapping around at the
+*          end. Keys are only compared when the full hash codes match. The
+*          array is never more than half full so an empty slot always exists.
+* \param aKey The key to search for.
+* \param aHashCode The hash code of the key.
+* \return The index of the slot.
 */
 template<class Key, class Value>
-void HashMap<Key, Value>::resize( const size_t aNewSize ){
-	// Check if the new and old size are the same to avoid resizing.
-	if( aNewSize == mSize ){
-		return;
-	}
-
-	// Walk the hashmap and create a list of all items in the tree. Create a
-	// temporary vector to hold all the entries.
-	std::vector<boost::shared_ptr<Item> > temporaryList;
-
-	// Iterate over the buckets.
-	for( unsigned int i = 0; i < mSize; ++i ){
-		// Set a pointer to the first item in the bucket.
-		boost::shared_ptr<Item> curr = mBuckets[ i ];
-		// Add all items in the chain to the temporary list.
-		while( curr.get() ){
-			temporaryList.push_back( curr );
-			
-			/*! \invariant Ensure that no pointer refers to itself. */
-			assert( curr.get() != curr->mNext.get() );
-
-			// Move to the next item in the chain.
-			curr = curr->mNext;
-		}
-	}
-	// Check that the temporary list contains all entries.
-	assert( temporaryList.size() == mNumEntries );
-
-	// Resize the bucket vector.
-	mSize = aNewSize;
-	// Clear the bucket vector before resizing so all pointers are null, not
-	// pointing at old values.
-	mBuckets.clear();
-	mBuckets.resize( mSize );
-
-#if( TUNING_STATS )
-	// Reset the collision count.
-	mNumCollisions = 0;
-#endif
-	// Now add each item back to the list. Can't use the add function as we
-	// already have allocated items and we don't want to change the count of the
-	// number of entries.
-	for( unsigned int i = 0; i < temporaryList.size(); ++i ){
-		/*! \invariant Every position in the temporary list has a valid pointer. */
-		assert( temporaryList[ i ].get() );
-		
-		/*! \invariant There is a second reference to the item pointed to by the
-        *              next pointer. 
-        */
-		assert( !temporaryList[ i ]->mNext.unique() );
-		
-		// Clear out the next pointer as it is no longer valid. The temporary
-		// list is holding a reference to all items in the list, so this cannot
-        // cause a deallocation.
-		temporaryList[ i ]->mNext.reset();
-
-		// Add a single item to the map. Find the hash value and use the mod
-        // function to reduce it to within the size of the bucket vector.
-		const size_t bucketSpot = mHashFunction( temporaryList[ i ]->mKeyValuePair.first ) % mSize;
-
-		// We now know which bucket the key resides in if it exists.
-		Item* curr = mBuckets[ bucketSpot ].get();
-
-		// If the spot is null, add this item as the head of the bucket's chain.
-		if( !curr ){
-			mBuckets[ bucketSpot ] = temporaryList[ i ];
-		}
-		// Otherwise we need to search for the end of the current bucket's
-        // chain.
-		else {
-			while( curr->mNext.get() ){
-				/*! \invariant Ensure that no pointer refers to itself. */
-				assert( curr != curr->mNext.get() );
-				
-				curr = curr->mNext.get();
-			}
-			// Curr now points to the last item in the chain, add the current
-			// item as the end of the chain.
-			/*! \invariant Ensure that no pointer refers to itself. */
-			assert( curr != temporaryList[ i ].get() );
-
-			curr->mNext = temporaryList[ i ];
+size_t HashMap<Key, Value>::findSlot( const Key& aKey, const size_t aHashCode ) const {
+    const size_t mask = mSlots.size() - 1;
+    for( size_t slot = aHashCode & mask; ; slot = ( slot + 1 ) & mask ){
+        const Slot& curr = mSlots[ slot ];
+        if( !curr.mEntry || ( curr.mHashCode == aHashCode && mEntries[ curr.mEntry - 1 ].first == aKey ) ){
+            return slot;
+        }
 #if( TUNING_STATS )
-			// Record the collision.
-			++mNumCollisions;
+        // Record the collision.
+        ++const_cast<HashMap*>( this )->mNumCollisions;
 #endif
-		}
-	}
-}
-
-/*! \brief Find the first item in the hashmap.
-* \details This function is used to initialize the constant begin iterator. It
-*          returns a pair containing a constant pointer to the first item and
-*          the position of the item in the bucket vector.
-* \return A pair containing a constant pointer to the first item and its
-*         position in the bucket vector. If the vector is empty this will return
-*         a pair containing null and zero.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::CItemPair
-HashMap<Key, Value>::getFirstItem() const {
-    // Check for empty hashmap first to avoid a slow unsuccessful search.
-    if( empty() ){
-        return CItemPair( static_cast<Item*>( 0 ), 0 );
-    }
-
-    // Search starting at the beginning of the bucket vector to find the first
-    // item.
-    for( unsigned int i = 0; i < mBuckets.size(); i++ ){
-        if( mBuckets[ i ] ){
-            return CItemPair( mBuckets[ i ].get() , i );
-        }
     }
-
-    /*! \post An item must have been found because this function initially
-    *         checks for an empty list. 
-    */
-    assert( false );
-    
-    // Make the compiler happy.
-    return CItemPair( static_cast<Item*>( 0 ), 0 );
 }
 
-/*! \brief Return the next item in the hashmap.
-* \details This function is used by the iterator to find the next value in the
-*          hashmap.
-* \param aItemPair A pair containing the current item and its bucket position.
-* \return A pair containing the next item and its bucket position or the end
-*         iterator if it was the last item.
+/*! \brief Resize the slot array. 
+* \details The filled slots are placed in the new array using their stored hash
+*          codes so that no keys are hashed or compared.
+* \param aNewSize New size of the slot array, which must be a power of two.
 */
 template<class Key, class Value>
-typename HashMap<Key, Value>::CItemPair
-HashMap<Key, Value>::getNextItem( const CItemPair& aItemPair ) const {
-    // First check if there is a next item in the current item's chain.
-    if( aItemPair.first->mNext ){
-        // Return a pair containing the next item and the current bucket spot
-        // since the item is in the same chain.
-        return CItemPair( aItemPair.first->mNext.get(), aItemPair.second );
-    }
-
-    // Otherwise search forward in the bucket vector starting at the current position.
-    for( size_t i = aItemPair.second + 1; i < mBuckets.size(); ++i ){
-        // If there is an item at this bucket position return it.
-        if( mBuckets[ i ] ){
-            return CItemPair( mBuckets[ i ].get(), i );
-        }
-    }
-
-    // The end of the bucket vector was reached so there is not a next item.
-    return CItemPair( static_cast<Item*>( 0 ), 0 );
-}
-
-/*! \brief Find the first item in the hashmap.
-* \details This function is used to initialize the begin iterator. It returns a
-*          pair containing a pointer to the first item and the position of the
-*          item in the bucket vector.
-* \return A pair containing a pointer to the first item and its position in the
-*         bucket vector. If the vector is empty this will return a pair
-*         containing null and zero.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::ItemPair HashMap<Key, Value>::getFirstItem() {
-    // Check for empty hashmap first to avoid a slow unsuccessful search.
-    if( empty() ){
-        return ItemPair( static_cast<Item*>( 0 ), 0 );
-    }
-
-    // Search starting at the beginning of the bucket vector to find the first
-    // item.
-    for( unsigned int i = 0; i < mBuckets.size(); i++ ){
-        if( mBuckets[ i ] ){
-            return ItemPair( mBuckets[ i ].get(), i );
-        }
-    }
-
-    /*! \post An item must have been found because this function initially
-    *         checks for an empty list. 
-    */
-    assert( false );
-    
-    // Make the compiler happy.
-    return ItemPair( static_cast<Item*>( 0 ), 0 );
-}
-
-/*! \brief Return the next item in the hashmap.
-* \details This function is used by the iterator to find the next value in the
-*          hashmap.
-* \param aItemPair A pair containing the current item and its bucket position.
-* \return A pair containing the next item and its bucket position or the end
-*         iterator if it was the last item.
-*/
-template<class Key, class Value>
-typename HashMap<Key, Value>::ItemPair
-HashMap<Key, Value>::getNextItem( const ItemPair& aItemPair ) {
-    // First check if there is a next item in the current item's chain.
-    if( aItemPair.first->mNext ){
-        // Return a pair containing the next item and the current bucket spot
-        // since the item is in the same chain.
-        return ItemPair( aItemPair.first->mNext, aItemPair.second );
-    }
-
-    // Otherwise search forward in the bucket vector starting at the current position.
-    for( size_t i = aItemPair.second + 1; i < mBuckets.size(); ++i ){
-        // If there is an item at this bucket position return it.
-        if( mBuckets[ i ] ){
-            return ItemPair( mBuckets[ i ], i );
+void HashMap<Key, Value>::resize( const size_t aNewSize ){
+    /*! \pre The new size is a power of two large enough to hold every entry. */
+    assert( aNewSize > size() && ( aNewSize & ( aNewSize - 1 ) ) == 0 );
+
+    Slot emptySlot = { 0, 0 };
+    std::vector<Slot> oldSlots( aNewSize, emptySlot );
+    oldSlots.swap( mSlots );
+
+    const size_t mask = mSlots.size() - 1;
+    for( typename std::vector<Slot>::const_iterator iter = oldSlots.begin(); iter != oldSlots.end(); ++iter ){
+        if( iter->mEntry ){
+            size_t slot = iter->mHashCode & mask;
+            while( mSlots[ slot ].mEntry ){
+                slot = ( slot + 1 ) & mask;
+            }
+            mSlots[ slot ] = *iter;
         }
     }
-
-    // The end of the bucket vector was reached so there is not a next item.
-    return end();
-}
-
-// ItemPair getNextItem( const ItemPair& aItemPair );
-/*! \brief Item structure constructor.
-* \param aKey The key.
-* \param aValue The value.
-*/
-template<class Key, class Value>
-HashMap<Key, Value>::Item::Item( const std::pair<Key, Value>& aKeyValuePair ):
-mKeyValuePair( aKeyValuePair ){
 }
 
 /*! \brief iterator constructor which sets the internal pointer to null.
@@ -726,20 +513,17 @@ template<class Key, class Value>
 HashMap<Key, Value>::iterator::iterator(){}
 
 /*! \brief iterator constructor.
-* \param aCurrentItem The current Item.
-* \param aBucketPosition The position of the Item in the bucket vector.
+* \param aPosition The position of the current item in insertion order.
 * \param aParent A pointer to the parent hashmap.
 */
 template<class Key, class Value>
-HashMap<Key, Value>::iterator::iterator( Item* aCurrentItem,
-                                         const size_t aBucketPosition,
+HashMap<Key, Value>::iterator::iterator( const size_t aPosition,
                                          const HashMap* aParent ):
-const_iterator( aCurrentItem, aBucketPosition, aParent ){
+const_iterator( aPosition, aParent ){
 }
 
 /*! \brief Equals operator
-* \param aKey The key.
-* \param aValue The value.
+* \param aOther The iterator to compare with.
 */
 template<class Key, class Value>
 bool HashMap<Key, Value>::iterator::operator ==( const typename HashMap<Key, Value>::iterator& aOther ) const {
@@ -747,8 +531,7 @@ bool HashMap<Key, Value>::iterator::operator ==( const typename HashMap<Key, Val
 }
 
 /*! \brief Not-equals operator
-* \param aKey The key.
-* \param aValue The value.
+* \param aOther The iterator to compare with.
 */
 template<class Key, class Value>
 bool HashMap<Key, Value>::iterator::operator !=( const typename HashMap<Key, Value>::iterator& aOther ) const {
@@ -760,12 +543,9 @@ bool HashMap<Key, Value>::iterator::operator !=( const typename HashMap<Key, Val
 */
 template<class Key, class Value>
 std::pair<Key, Value>* HashMap<Key, Value>::iterator::operator->(){
-	/*! \pre The current item pointer must be non-null. */
-	assert( const_iterator::mCurrentItem.first != 0 );
-
-    // The mCurrentItem is inherited from const_iterator and must be cast so
-    // that the return value is mutable.
-	return const_cast<std::pair<Key, Value>*>( &const_iterator::mCurrentItem.first->mKeyValuePair );
+    // The parent is constant in the const_iterator and must be cast so that
+    // the return value is mutable.
+	return const_cast<std::pair<Key, Value>*>( const_iterator::operator->() );
 }
 
 /*! \brief Dereference operator
@@ -773,12 +553,9 @@ std::pair<Key, Value>* HashMap<Key, Value>::iterator::operator->(){
 */
 template<class Key, class Value>
 std::pair<Key, Value>& HashMap<Key, Value>::iterator::operator*() {
-	/*! \pre The current item pointer must be non-null. */
-	assert( const_iterator::mCurrentItem.first != 0 );
-
-    // The mCurrentItem is inherited from const_iterator and must be cast so
-    // that the return value is mutable.
-	return const_cast<std::pair<Key, Value>&>( const_iterator::mCurrentItem.first->mKeyValuePair );
+    // The parent is constant in the const_iterator and must be cast so that
+    // the return value is mutable.
+	return const_cast<std::pair<Key, Value>&>( const_iterator::operator*() );
 }
 
 /*! \brief Prefix increment operator.
@@ -787,10 +564,7 @@ std::pair<Key, Value>& HashMap<Key, Value>::iterator::operator*() {
 template<class Key, class Value>
 typename HashMap<Key, Value>::iterator&
 HashMap<Key, Value>::iterator::operator++(){
-    /*! \pre Need a non-null parent hashmap. */
-    assert( const_iterator::mParent );
-
-    const_iterator::mCurrentItem = const_iterator::mParent->getNextItem( const_iterator::mCurrentItem );
+    const_iterator::operator++();
     return *this;
 }
 
@@ -809,34 +583,30 @@ HashMap<Key, Value>::iterator::operator++ (int){
 */
 template<class Key, class Value>
 HashMap<Key, Value>::const_iterator::const_iterator():
-mCurrentItem( 0, 0 ),
+mPosition( 0 ),
 mParent( 0 ){}
 
 /*! \brief const_iterator constructor.
-* \param aCurrentItem The current Item.
-* \param aBucketPosition The position of the current Item within the bucket
-*        vector.
+* \param aPosition The position of the current item in insertion order.
+* \param aParent A pointer to the parent hashmap.
 */
 template<class Key, class Value>
-HashMap<Key, Value>::const_iterator::const_iterator( const Item* aCurrentItem,
-                                                     const size_t aBucketPosition,
+HashMap<Key, Value>::const_iterator::const_iterator( const size_t aPosition,
                                                      const HashMap* aParent )
-:mCurrentItem( aCurrentItem, aBucketPosition ),
+:mPosition( aPosition ),
 mParent( aParent ){
 }
 
 /*! \brief Equals operator
-* \param aKey The key.
-* \param aValue The value.
+* \param aOther The iterator to compare with.
 */
 template<class Key, class Value>
 bool HashMap<Key, Value>::const_iterator::operator ==( const typename HashMap<Key, Value>::const_iterator& aOther ) const {
-	return ( mCurrentItem == aOther.mCurrentItem );
+	return mPosition == aOther.mPosition && mParent == aOther.mParent;
 }
 
 /*! \brief Not-equals operator
-* \param aKey The key.
-* \param aValue The value.
+* \param aOther The iterator to compare with.
 */
 template<class Key, class Value>
 bool HashMap<Key, Value>::const_iterator::operator !=( const typename HashMap<Key, Value>::const_iterator& aOther ) const {
@@ -848,9 +618,9 @@ bool HashMap<Key, Value>::const_iterator::operator !=( const typename HashMap<Ke
 */
 template<class Key, class Value>
 const std::pair<Key, Value>* HashMap<Key, Value>::const_iterator::operator->() const {
-	/*! \pre The current item pointer must be non-null. */
-	assert( mCurrentItem.first != 0 );
-	return &mCurrentItem.first->mKeyValuePair;
+	/*! \pre The iterator refers to an item. */
+	assert( mParent && mPosition < mParent->size() );
+	return &mParent->mEntries[ mPosition ];
 }
 
 /*! \brief Prefix increment operator.
@@ -862,7 +632,7 @@ HashMap<Key, Value>::const_iterator::operator++(){
     /*! \pre Need a non-null parent hashmap. */
     assert( mParent );
 
-    mCurrentItem = mParent->getNextItem( mCurrentItem );
+    ++mPosition;
     return *this;
 }
 
@@ -882,9 +652,9 @@ HashMap<Key, Value>::const_iterator::operator++ (int){
 */
 template<class Key, class Value>
 const std::pair<Key, Value>& HashMap<Key, Value>::const_iterator::operator*() const {
-	/*! \pre The current item pointer must be non-null. */
-	assert( mCurrentItem.first != 0 );
-	return mCurrentItem.first->mKeyValuePair;
+	/*! \pre The iterator refers to an item. */
+	assert( mParent && mPosition < mParent->size() );
+	return mParent->mEntries[ mPosition ];
 }
 
 #endif // _HASH_MAP_H_
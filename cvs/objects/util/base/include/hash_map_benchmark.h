@@ -0,0 +1,105 @@
+#ifndef _HASH_MAP_BENCHMARK_H_
+#define _HASH_MAP_BENCHMARK_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*!
+* \file hash_map_benchmark.h
+* \ingroup Objects
+* \brief Header file for the HashMapBenchmark class.
+*/
+
+#include <string>
+#include <vector>
+#include <utility>
+
+#include "util/base/include/default_visitor.h"
+
+class Marketplace;
+class MarketLocator;
+
+namespace objects {
+    class Atom;
+}
+
+/*!
+* \ingroup Objects
+* \brief Compares the lookup times of HashMap with the standard library maps
+*        using the keys that occur in the model.
+* \details The benchmark is run for the period given by the
+*          hash-map-benchmark-year configuration value before the period is
+*          solved.  Two sets of keys are gathered from the markets of the
+*          period.  The first is the region and good names, which are looked up
+*          once for each market in marketplace order as they are when the model
+*          interns names and finds markets.  The second is the names of the
+*          registered Info properties, which are each looked up once for every
+*          market.  For both sets of keys lookups in HashMap, with and without
+*          precomputed hash codes, std::unordered_map and std::map are timed,
+*          as are lookups of keys which are missing.  The MarketLocator of
+*          the marketplace is then timed looking up the market of each good in
+*          each region the market contains, by name and by interned name, and
+*          compared with a std::map keyed by the pair of names.  Each
+*          measurement is repeated hash-map-benchmark-repeats times and the
+*          average time per lookup is printed to the main log.
+*/
+class HashMapBenchmark : public DefaultVisitor {
+public:
+    HashMapBenchmark();
+
+    void run( const Marketplace* aMarketplace, const int aPeriod );
+
+    virtual void startVisitMarket( const Market* aMarket, const int aPeriod );
+private:
+    //! The region and good names in the order they are used by the markets.
+    std::vector<std::string> mMarketNames;
+
+    //! The interned region and good name of each good in each region
+    //! contained by the markets in marketplace order.
+    std::vector<std::pair<const objects::Atom*, const objects::Atom*> > mRegionGoods;
+
+    //! The number of markets visited.
+    int mNumMarkets;
+
+    //! The number of times each measurement is repeated.
+    int mRepeats;
+
+    void benchmarkKeys( const std::string& aKeySetName,
+                        const std::vector<std::string>& aLookups ) const;
+
+    void benchmarkMarketLocator( const MarketLocator& aMarketLocator ) const;
+};
+
+#endif // _HASH_MAP_BENCHMARK_H_
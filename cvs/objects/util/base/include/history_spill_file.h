@@ -0,0 +1,118 @@
+#ifndef _HISTORY_SPILL_FILE_H_
+#define _HISTORY_SPILL_FILE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*!
+* \file history_spill_file.h
+* \ingroup Objects
+* \brief Header file for the HistorySpillFile class.
+*/
+
+#include <string>
+#include <fstream>
+#include <boost/core/noncopyable.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
+/*!
+* \ingroup Objects
+* \brief A scratch file to which data of periods which have been solved may be
+*        moved out of memory.
+* \details Some objects keep large arrays for every model period which are
+*          only needed again if a period is recalculated, for instance by a
+*          policy target finder.  When the "history-spill-file" configuration
+*          file is set and written those objects write the arrays of periods before the
+*          one being calculated to this file as packed doubles and free them,
+*          and read them back only if the period is initialized again.  Reads
+*          map just the requested range of the file so that nothing else is
+*          paged in.  Each object rewrites the same range of the file when
+*          a period is spilled again so the file does not grow past the size
+*          of the data.
+*
+*          The process id is appended to the configured name so that several
+*          instances, such as the workers of a batch run, may share a
+*          configuration.  The file is created when data is first written,
+*          which is after any worker processes have been forked, and removed on
+*          exit.  If the file can not be created the data are kept in memory.
+*/
+class HistorySpillFile : private boost::noncopyable {
+public:
+    static HistorySpillFile& getInstance();
+
+    bool isEnabled() const;
+
+    bool write( const double* aData, const size_t aCount, size_t& aOffset );
+
+    void read( const size_t aOffset, double* aData, const size_t aCount );
+
+    //! The offset of data which has not yet been written.
+    static const size_t NOT_WRITTEN;
+private:
+    HistorySpillFile();
+    ~HistorySpillFile();
+
+    bool open();
+
+    //! The name of the file, empty if spilling is not enabled.
+    std::string mFileName;
+
+    //! The file being written, opened on the first write.
+    std::fstream mFile;
+
+    //! Whether opening the file has been attempted.
+    bool mOpenAttempted;
+
+    //! The number of bytes written to the end of the file.
+    size_t mSize;
+
+    //! The mapping used to read back from the file, created on the first read.
+    boost::interprocess::file_mapping mMapping;
+
+    //! Whether mMapping has been created.
+    bool mIsMapped;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Guards the file since regions may be initialized concurrently.
+    tbb::spin_mutex mMutex;
+#endif
+};
+
+#endif // _HISTORY_SPILL_FILE_H_
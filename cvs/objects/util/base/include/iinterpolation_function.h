@@ -43,6 +43,7 @@
  * \brief Header file for the IInterpolationFunction interface.
  * \author Pralit Patel
  */
+#include <vector>
 #include <boost/core/noncopyable.hpp>
 
 #include "util/base/include/iparsable.h"
@@ -85,6 +86,21 @@ public:
     virtual double interpolate( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
         const double aXValue ) const = 0;
 
+    /*!
+     * \brief Interpolate y-values at a number of x-values that are between the
+     *        given left and right data points.
+     * \details This is equivalent to calling interpolate for each x-value.
+     *          Subclasses may override it to compute the terms which only depend
+     *          on the data points once.
+     * \param aLeftPoint The left data point to bracket this interpolation.
+     * \param aRightPoint The right data point to bracket this interpolation.
+     * \param aXValues The x values at which we want to interpolate.
+     * \param aYValues The interpolated y-values, resized to the number of
+     *                 x-values.
+     */
+    inline virtual void interpolateValues( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
+        const std::vector<double>& aXValues, std::vector<double>& aYValues ) const;
+
     /*!
      * \brief The the XML element name which will be shared by interpolation
      *        functions.
@@ -113,4 +129,13 @@ protected:
 IInterpolationFunction::~IInterpolationFunction(){
 }
 
+void IInterpolationFunction::interpolateValues( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
+    const std::vector<double>& aXValues, std::vector<double>& aYValues ) const
+{
+    aYValues.resize( aXValues.size() );
+    for( size_t i = 0; i < aXValues.size(); ++i ) {
+        aYValues[ i ] = interpolate( aLeftPoint, aRightPoint, aXValues[ i ] );
+    }
+}
+
 #endif // _IINTERPOLATION_FUNCTION_H_
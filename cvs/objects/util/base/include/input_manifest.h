@@ -0,0 +1,81 @@
+#ifndef _INPUT_MANIFEST_H_
+#define _INPUT_MANIFEST_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file input_manifest.h
+* \ingroup Objects
+* \brief Header file for the InputManifest class.
+*/
+
+#include <string>
+#include <list>
+
+class Modeltime;
+
+/*!
+* \ingroup Objects
+* \brief Records the contents of the input files of a run so that a later run
+*        can determine which of the checkpointed periods its inputs affect.
+* \details The manifest holds a hash of each input file, in the order they are
+*          parsed, along with the earliest year found in any of its year
+*          attributes, such as year, from-year or final-calibration-year. A
+*          file which is added, removed or whose contents changed is assumed
+*          to affect the periods from the earliest of those years in either
+*          its old or new contents, and a file with no year attributes at all
+*          is assumed to affect every period. The periods before the earliest
+*          affected period of any file may then be restored from checkpoints
+*          instead of being solved again.
+* \note Only the input files are compared. Changes to the configuration or to
+*       the model itself are not detected.
+*/
+class InputManifest {
+public:
+    static int getNumUnchangedPeriods( const std::string& aManifestFile,
+                                       const std::list<std::string>& aInputFiles,
+                                       const Modeltime* aModeltime );
+
+    static bool write( const std::string& aManifestFile,
+                       const std::list<std::string>& aInputFiles,
+                       const int aNumPeriods );
+private:
+    //! The manifest format version which must be changed whenever the
+    //! format is.
+    static const unsigned int VERSION = 1;
+};
+
+#endif // _INPUT_MANIFEST_H_
@@ -0,0 +1,100 @@
+#ifndef _INPUT_SNAPSHOT_H_
+#define _INPUT_SNAPSHOT_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file input_snapshot.h
+* \ingroup Objects
+* \brief Header file for the InputSnapshot class.
+*/
+
+#include <string>
+#include <list>
+#include <vector>
+#include <iosfwd>
+#include <xercesc/util/XercesDefs.hpp>
+
+class IParsable;
+
+/*!
+* \ingroup Objects
+* \brief Stores the XML input files of a scenario in a compact pre-tokenized
+*        binary form which can be parsed into the model without the cost of
+*        reading and checking the XML again.
+* \details The snapshot holds, for each input file in the order they are
+*          parsed, the sequence of elements, attributes and non-whitespace text
+*          it contains with element and attribute names stored once in a shared
+*          table.  Reading the snapshot replays these documents through an
+*          XMLStreamParser so the model is built by the usual XMLParse methods
+*          with the same add and delete semantics as the original files.
+*
+*          The header records a version, the byte order, and the name, size and
+*          modification time of each input file.  A snapshot whose version or
+*          byte order differs or whose input files have changed is ignored.
+*          Snapshots are controlled by the "input-snapshot" configuration file:
+*          an up to date snapshot is always used and, when write-output is set,
+*          a new one is written after the XML files have been parsed.
+*
+*          The same records may instead be kept in memory for each input file
+*          with parseCached, so that the scenarios of a batch which share input
+*          files parse each of them from XML only once.
+* \note Scenario::completeInit is still run after reading a snapshot.  Storing
+*       the fully initialized model would require serializing the many cross
+*       object pointers set up there.
+*/
+class InputSnapshot {
+public:
+    static bool isCurrent( const std::string& aSnapshotFile, const std::list<std::string>& aInputFiles );
+
+    static bool write( const std::string& aSnapshotFile, const std::list<std::string>& aInputFiles );
+
+    static bool read( const std::string& aSnapshotFile, IParsable* aModelElement );
+
+    static bool parseCached( const std::string& aInputFile, IParsable* aModelElement );
+
+    static void clearCache();
+private:
+    //! The snapshot format version which must be changed whenever the
+    //! format is.
+    static const unsigned int VERSION = 1;
+
+    static bool replayDocument( std::istream& aIn, const std::string& aFileName, IParsable* aModelElement,
+                                std::vector<std::basic_string<XMLCh> >& aNames );
+};
+
+#endif // _INPUT_SNAPSHOT_H_
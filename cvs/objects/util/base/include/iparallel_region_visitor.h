@@ -0,0 +1,93 @@
+#ifndef _IPARALLEL_REGION_VISITOR_H_
+#define _IPARALLEL_REGION_VISITOR_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file iparallel_region_visitor.h
+* \ingroup Objects
+* \brief Header file for the IParallelRegionVisitor interface.
+*/
+
+class IVisitor;
+
+/*!
+* \ingroup Objects
+* \brief An interface to a visitor which may visit the regions of the World
+*        concurrently.
+* \details A visitor which implements this interface in addition to IVisitor
+*          tells World::accept that it may split the visit of the regions.
+*          World::accept then creates one region visitor per region, visits
+*          the regions with them concurrently and merges the region visitors
+*          back into this visitor strictly in region order so that the result
+*          is the same as a serial visit.  Anything the visitor does before or
+*          after the regions, such as visiting the marketplace, stays with
+*          this visitor.
+*
+*          Region visitors must not share any state which is changed while
+*          visiting, and nothing they read from the model may be changed by
+*          visiting.  Regions are only visited concurrently when the
+*          "parallel-visit" configuration flag is set in a parallel build.
+*/
+class IParallelRegionVisitor {
+public:
+    //! Virtual destructor so that instances of the interface may be deleted
+    //! correctly through a pointer to the interface.
+    inline virtual ~IParallelRegionVisitor();
+
+    /*!
+     * \brief Create a visitor which will visit a single region.
+     * \details The region visitor should be in the state this visitor is in
+     *          when it is about to visit a region.
+     * \return A new region visitor which the caller owns.
+     */
+    virtual IVisitor* createRegionVisitor() const = 0;
+
+    /*!
+     * \brief Merge the result of a region visitor into this visitor.
+     * \details This is called once for each region visitor after its region
+     *          was visited, in region order and never concurrently.
+     * \param aRegionVisitor A visitor created by createRegionVisitor.
+     */
+    virtual void mergeRegionVisitor( IVisitor* aRegionVisitor ) = 0;
+};
+
+// Inline function definitions.
+IParallelRegionVisitor::~IParallelRegionVisitor(){
+}
+
+#endif // _IPARALLEL_REGION_VISITOR_H_
@@ -44,10 +44,15 @@
  */
 
 #include <cassert>
-#include <forward_list>
+#include <iosfwd>
+#include <map>
+#include <vector>
 #include "util/base/include/definitions.h"
 
 class Value;
+#if GCAM_PARALLEL_ENABLED
+class NumaThreadPinner;
+#endif
 
 #if GCAM_PARALLEL_ENABLED
 #include <tbb/task_arena.h>
@@ -66,6 +71,34 @@ class Value;
  *          developers do not need to worry about any of this.  All they have to do
  *          is ensure they appropriately tag their STATE Data.
  *
+ *          The state of Markets is placed first in mStateData, ordered by market,
+ *          so that the prices, supplies and demands of all markets form a single
+ *          contiguous block.
+ *
+ *          When GCAM_PARALLEL_ENABLED and the boolean configuration value
+ *          "parallel-numa-pinning" is set the threads in mThreadPool are pinned
+ *          to the CPUs of a NUMA node, filling one node before moving on to the
+ *          next, and each thread always uses the same "scratch" state which is
+ *          allocated and first touched by that thread so that it resides on the
+ *          thread's own node.
+ *
+ *          When the boolean configuration value "partial-derivative-delta-copy"
+ *          is set every Value records which block of its state it modifies so
+ *          that copyState only needs to restore the blocks touched by the
+ *          previous partial derivative rather than the entire state.
+ *
+ *          While an undo log is kept, see startUndoLog, each block of the
+ *          "base" state is saved the first time it is modified so that
+ *          rollbackUndoLog can return the model to the point the log was
+ *          started from without recalculating it.  This may be switched off
+ *          with the boolean configuration value "solver-undo-log".
+ *
+ *          When the boolean configuration value "report-unchanged-state" is
+ *          set the number of collected values which were left unchanged by the
+ *          end of the period is logged for each kind of STATE Data.  These are
+ *          candidates to no longer be tagged as STATE which would shrink every
+ *          "scratch" state.
+ *
  * \author Pralit Patel
  */
 class ManageStateVariables {
@@ -76,6 +109,22 @@ public:
     void copyState();
     
     void setPartialDeriv( const bool aIsPartialDeriv );
+
+    void startUndoLog();
+
+    bool rollbackUndoLog();
+
+    void stopUndoLog();
+
+    static int getThreadNumaNode( const int aThreadIndex );
+
+    void writeState( std::ostream& aOut ) const;
+
+    bool readState( std::istream& aIn );
+
+    int getNumAllocatedStates() const;
+
+    size_t getStateBytes() const;
     
 #if GCAM_PARALLEL_ENABLED
     //! A tbb task arena which is the closest tbb comes to a thread pool which we
@@ -95,6 +144,43 @@ private:
     //! will be as many as the max_concurrency the thread pool allows on the system
     //! running the code.
     double** mStateData;
+
+    //! The number of states allocated in mStateData.
+    int mNumStates;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Pins the threads in mThreadPool to NUMA nodes, null if pinning is not
+    //! enabled.
+    NumaThreadPinner* mThreadPinner;
+#endif
+
+    //! Whether copyState should only restore the blocks of a "scratch" state
+    //! which were modified since it last copied the "base" state.
+    const bool mUseDeltaCopy;
+
+    //! Whether to report the collected values which were not changed by the
+    //! end of the period.
+    const bool mReportUnchanged;
+
+    //! Whether startUndoLog should keep an undo log.
+    const bool mUseUndoLog;
+
+    //! The saved blocks of the "base" state while an undo log is kept, allocated
+    //! the first time one is started.
+    double* mUndoLog;
+
+    //! A copy of the "base" state as it was collected, only kept if
+    //! mReportUnchanged is set.
+    std::vector<double> mInitialState;
+
+    //! The kind of Data each collected value belongs to, indexed as the state
+    //! and only kept if mReportUnchanged is set.
+    std::vector<const char*> mStateKinds;
+
+    //! Incremented each time partial derivatives are started, at which point
+    //! the "base" state may have changed.  Each "scratch" state records the
+    //! generation it was last completely copied in.
+    unsigned int mStateGeneration;
     
     //! The period this state was collected for.
     int mPeriodToCollect;
@@ -112,17 +198,27 @@ private:
     size_t mNumCollected;
     
     //! The list of individual Values flagged as STATE that could possibly be
-    //! changed during World.calc( mPeriodToCollect ).  We store them in a list
-    //! since searching via GCAMFusion is a relatively expensive operation and we
-    //! will need to take three passes at them:
+    //! changed during World.calc( mPeriodToCollect ), in the order of their index
+    //! into mStateData.  We store them in a vector since searching via GCAMFusion
+    //! is a relatively expensive operation and we will need to take three passes
+    //! at them:
     //! - Figure out how many we have so what we can allocate enough memory for mStateData.
     //! - Copy the actual data from each Value to initialize the "base" state.
     //! - When we are done with this period copy the "base" state back into each Value.
-    std::forward_list<Value*> mStateValues;
+    std::vector<Value*> mStateValues;
+
+    //! The STATE Values found within active Markets which are collected
+    //! separately so that they can be placed in a single block at the front of
+    //! mStateData, in market order, rather than interleaved with the rest of the
+    //! model.  The market prices, supplies and demands which the solver reads
+    //! and writes are then stored contiguously.
+    std::vector<Value*> mMarketStateValues;
     
     void collectState();
     
     void resetState();
+
+    void reportUnchangedState() const;
     
     /*!
      * \brief A helper struct to provide a call back to GCAMFusion as it searches
@@ -142,6 +238,20 @@ private:
         //! current period.  This flag gets reset when the corresponding popFilterStep
         //! is found.
         bool mIgnoreCurrValue = false;
+
+        //! A state variable while processing GCAMFusion which when set indicates
+        //! we are in a Market that is active in the current period.
+        bool mInCurrMarket = false;
+
+        //! A state variable while processing GCAMFusion which when set indicates
+        //! we are in a Technology that is operating in the current period.
+        bool mInCurrTechnology = false;
+
+        //! The kind of Data each collected value belongs to, only filled if
+        //! mParentClass->mReportUnchanged is set.
+        std::map<const Value*, const char*> mValueKinds;
+
+        void addValue( Value* aValue, const char* aKind );
         
         // Templated callbacks for GCAMFusion
         template<typename DataType>
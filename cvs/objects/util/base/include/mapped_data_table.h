@@ -0,0 +1,140 @@
+#ifndef _MAPPED_DATA_TABLE_H_
+#define _MAPPED_DATA_TABLE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file mapped_data_table.h
+* \ingroup Objects
+* \brief Header file for the MappedDataTable class.
+*/
+
+#include <string>
+#include <map>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/core/noncopyable.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
+/*!
+* \ingroup Objects
+* \brief A read-only table of yearly data columns which is memory mapped from a
+*        binary side file rather than parsed from XML.
+* \details Large historical tables such as land use histories are otherwise read
+*          from XML into a map owned by each object.  The table file instead
+*          stores each column as a sorted array of years followed by an array of
+*          values, and objects which find their column keep a view directly into
+*          the mapped file.  Since the mapping is read only the operating system
+*          shares the physical pages between all model processes reading the
+*          same file, for instance the workers of a batch run.
+*
+*          The file starts with a header holding a magic string, the format
+*          version, a byte order mark and the number of columns.  A directory of
+*          column records follows, each giving the offset and length of the key,
+*          the number of rows and the offset of the data.  All data arrays are
+*          eight byte aligned.  A file with an unexpected version or byte order
+*          is rejected and objects then use the values from their XML.
+*
+*          The table is written by the model itself: when the
+*          "mapped-data-table" configuration file has write-output set each
+*          object adds its parsed data with a key unique within the scenario
+*          during completeInit and the file is written once initialization is
+*          done.  Otherwise an existing file is mapped before completeInit so
+*          that input files may omit the data.
+*/
+class MappedDataTable : private boost::noncopyable {
+public:
+    /*!
+     * \brief A view of a single column of the mapped table.
+     * \details The pointers are into the mapped file and remain valid for the
+     *          lifetime of the program.
+     */
+    struct Column {
+        Column();
+
+        //! The sorted years of the column.
+        const unsigned int* mYears;
+
+        //! The value for each year.
+        const double* mValues;
+
+        //! The number of rows in the column.
+        unsigned int mSize;
+    };
+
+    static MappedDataTable& getInstance();
+
+    bool open( const std::string& aFileName );
+
+    bool isOpen() const;
+
+    bool getColumn( const std::string& aKey, Column& aColumn ) const;
+
+    void setCollecting( const bool aIsCollecting );
+
+    bool isCollecting() const;
+
+    void addColumn( const std::string& aKey, const std::map<unsigned int, double>& aData );
+
+    bool write( const std::string& aFileName ) const;
+private:
+    MappedDataTable();
+
+    //! The table format version which must be changed whenever the format is.
+    static const unsigned int VERSION = 1;
+
+    //! The mapped file if one has been opened.
+    boost::interprocess::mapped_region mRegion;
+
+    //! The columns of the mapped file by key.
+    std::map<std::string, Column> mColumns;
+
+    //! Whether columns are being collected to write a new table.
+    bool mIsCollecting;
+
+    //! The columns collected to write a new table by key.
+    std::map<std::string, std::map<unsigned int, double> > mPendingColumns;
+
+#if GCAM_PARALLEL_ENABLED
+    //! Guards the pending columns since regions may be initialized concurrently.
+    tbb::spin_mutex mPendingMutex;
+#endif
+};
+
+#endif // _MAPPED_DATA_TABLE_H_
@@ -0,0 +1,106 @@
+#ifndef _MEMORY_REPORT_H_
+#define _MEMORY_REPORT_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file memory_report.h
+* \ingroup Objects
+* \brief Header file for the MemoryReport class.
+*/
+
+#include <map>
+#include <string>
+#include <vector>
+
+class Scenario;
+class ILogger;
+
+/*!
+* \ingroup Objects
+* \brief Estimates the memory retained by each class of GCAM object.
+* \details The report uses GCAMFusion to visit all of the Data declared by the
+*          containers reachable from the Scenario.  The bytes of each Data,
+*          including the heap storage of strings, vectors, maps and time
+*          vectors, are attributed to the class of the container which
+*          declares it.  Memory which is not
+*          declared as Data is not seen, the owner may add an estimate of it
+*          with addUsage such as the Scenario does for the STATE scratch slots
+*          and the flow graph.  The result is therefore a lower bound which is
+*          mostly useful for comparing the relative sizes of classes.
+*/
+class MemoryReport {
+public:
+    MemoryReport();
+
+    void collect( Scenario* aScenario );
+
+    void addUsage( const std::string& aName, const size_t aObjects, const size_t aBytes );
+
+    void print( ILogger& aLog, const std::string& aWhen ) const;
+
+    // Templated callbacks for GCAMFusion
+    template<typename DataType>
+    void processData( DataType& aData );
+    template<typename DataType>
+    void pushFilterStep( const DataType& aData );
+    template<typename DataType>
+    void popFilterStep( const DataType& aData );
+private:
+    //! The memory attributed to a single class.
+    struct Usage {
+        Usage() : mObjects( 0 ), mBytes( 0 ) {}
+
+        //! The number of objects of the class.
+        size_t mObjects;
+
+        //! The estimated bytes retained by the objects.
+        size_t mBytes;
+    };
+
+    //! The usage of each class by name.
+    std::map<std::string, Usage> mUsage;
+
+    //! The class names of the containers currently being visited, the last of
+    //! which any Data found is attributed to.
+    std::vector<std::string> mContainerStack;
+
+    //! Whether containers should be counted as they are visited, only set for
+    //! the first of the GCAMFusion passes.
+    bool mCountObjects;
+};
+
+#endif // _MEMORY_REPORT_H_
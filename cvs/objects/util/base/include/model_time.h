@@ -47,6 +47,7 @@
 
 #include <vector>
 #include <map>
+#include <cassert>
 #include "util/base/include/iparsable.h"
 #include "util/base/include/iround_trippable.h"
 /*! 
@@ -77,8 +78,10 @@ private:
     //! Model period to year.
     std::vector<int> mPeriodToYear;
 
-    //! Year to model period map object.
-    std::map<int,int> mYearToPeriod;
+    //! Model period of each year from the start year to the end year
+    //! inclusive, indexed by the offset from the start year.  Years which are
+    //! not model years have the period of the next model year.
+    std::vector<int> mYearToPeriod;
     
     //! Debugging flag to make sure the modeltime params have been
     //! set before attempting to get the modeltime attributes.
@@ -86,6 +89,8 @@ private:
 
     // member functions
     void initMembers( const std::map<int, int>& aYearToTimeStep );
+    int reportInvalidPeriod( const int aPeriod ) const;
+    int reportInvalidYear( const int aYear ) const;
     
     //! Private constructor to prevent creating a Modeltime.
     Modeltime();
@@ -94,6 +99,33 @@ private:
     //! Private undefined assign operator to prevent creating another Modeltime.
     Modeltime& operator=( const Modeltime& aModelTime );
 public:
+    /*!
+     * \brief A lightweight view of the year and period mappings which may be
+     *        kept by callers that convert many years or periods.
+     * \details The conversions do no error checking, callers must ensure the
+     *          year is within the model years, see hasYear, or the period is
+     *          a valid model period.  The view does not own the mappings and
+     *          is valid for as long as the Modeltime.
+     */
+    class YearPeriodTable {
+    public:
+        YearPeriodTable(): mStartYear( 0 ), mNumYears( 0 ), mYearToPeriod( 0 ), mPeriodToYear( 0 ) {}
+        //! Whether the year is between the start and end year inclusive.
+        bool hasYear( const int aYear ) const {
+            return static_cast<unsigned int>( aYear - mStartYear ) < mNumYears;
+        }
+        //! The period containing a year within the model years.
+        int getPeriod( const int aYear ) const { return mYearToPeriod[ aYear - mStartYear ]; }
+        //! The year of a model period.
+        int getYear( const int aPeriod ) const { return mPeriodToYear[ aPeriod ]; }
+    private:
+        friend class Modeltime;
+        int mStartYear;
+        unsigned int mNumYears;
+        const int* mYearToPeriod;
+        const int* mPeriodToYear;
+    };
+
     static const Modeltime* getInstance();
     
     // IParsable methods
@@ -112,8 +144,35 @@ public:
     int gettimestep( const int aPeriod ) const { return mPeriodToTimeStep[ aPeriod ]; } // years from last to current per
     int getmaxper() const { return mMaxPeriod; }  // max modeling periods
 
-    int getper_to_yr( const int aPeriod ) const;
-    int getyr_to_per( const int aYear ) const;
+    /*!
+    * \brief Convert a period into a year.
+    * \details Converts the period into a year if it is valid. If it is not a valid
+    *          year the function will print a warning and return 0.
+    * \param aPeriod Model period.
+    * \return The first year of the period, 0 if the year is invalid.
+    */
+    int getper_to_yr( const int aPeriod ) const {
+        assert( mIsInitialized );
+        return static_cast<size_t>( aPeriod ) < mPeriodToYear.size()
+            ? mPeriodToYear[ aPeriod ] : reportInvalidPeriod( aPeriod );
+    }
+
+    /*!
+    * \brief Convert a year to a period.
+    * \details Years which are not model years are in the period of the next
+    *          model year.  If the year is outside of the model years the
+    *          function will print a warning and return 0.
+    * \param aYear The year to convert.
+    * \return The period containing the year, 0 if the year is invalid.
+    */
+    int getyr_to_per( const int aYear ) const {
+        assert( mIsInitialized );
+        const size_t yearIndex = static_cast<size_t>( static_cast<unsigned int>( aYear - mStartYear ) );
+        return yearIndex < mYearToPeriod.size()
+            ? mYearToPeriod[ yearIndex ] : reportInvalidYear( aYear );
+    }
+
+    YearPeriodTable getYearPeriodTable() const;
 
     bool isModelYear( const int aYear ) const;
 
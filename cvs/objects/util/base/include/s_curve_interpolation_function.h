@@ -91,6 +91,9 @@ public:
     
     virtual double interpolate( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
         const double aXValue ) const;
+
+    virtual void interpolateValues( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
+        const std::vector<double>& aXValues, std::vector<double>& aYValues ) const;
     
     // IParsable methods
     virtual bool XMLParse( const xercesc::DOMNode* aNode );
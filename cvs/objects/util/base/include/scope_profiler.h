@@ -0,0 +1,101 @@
+#ifndef _SCOPE_PROFILER_H_
+#define _SCOPE_PROFILER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file scope_profiler.h
+* \ingroup Objects
+* \brief Header file for the ScopeProfiler class and the GCAM_PROFILE_SCOPE
+*        macro.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_PROFILE_SCOPES
+#include <vector>
+#include <chrono>
+
+/*!
+* \ingroup Objects
+* \brief A hierarchical profiler of the time spent in nested scopes.
+* \details Code marks a scope to profile with GCAM_PROFILE_SCOPE( "name" ) which
+*          times the rest of the enclosing block.  Each thread keeps its own
+*          tree of the scopes it has entered, keyed by the address of the name,
+*          so entering a scope takes no locks.  At the end of each model period
+*          reportPeriod merges the trees of all threads by name, prints the
+*          merged tree with the total time and number of calls of each scope to
+*          the main log and, if the "scope-profile" configuration file has
+*          write-output set, appends the self time of each scope in
+*          microseconds as folded stacks which flame graph tools can read.  The
+*          counts are then reset for the next period.
+* \note Scopes entered by a worker thread appear under the root of that thread
+*       rather than under the scope which started the parallel work.  When
+*       GCAM_PROFILE_SCOPES is not set the macro compiles to nothing.
+*/
+class ScopeProfiler {
+    struct Node;
+public:
+    //! A time node entered with its creation and left with its destruction.
+    class Scope {
+    public:
+        explicit Scope( const char* aName );
+        ~Scope();
+    private:
+        //! The node for this scope in the tree of the current thread.
+        Node* mNode;
+
+        //! The time the scope was entered.
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    static void reportPeriod( const int aYear );
+private:
+    struct ThreadTree;
+
+    static ThreadTree& getThreadTree();
+
+    static std::vector<ThreadTree*>& getThreadTrees();
+};
+
+#define GCAM_PROFILE_SCOPE_CONCAT_( aPrefix, aLine ) aPrefix ## aLine
+#define GCAM_PROFILE_SCOPE_CONCAT( aPrefix, aLine ) GCAM_PROFILE_SCOPE_CONCAT_( aPrefix, aLine )
+#define GCAM_PROFILE_SCOPE( aName ) ScopeProfiler::Scope GCAM_PROFILE_SCOPE_CONCAT( profileScope, __LINE__ )( aName )
+#else
+#define GCAM_PROFILE_SCOPE( aName )
+#endif // GCAM_PROFILE_SCOPES
+
+#endif // _SCOPE_PROFILER_H_
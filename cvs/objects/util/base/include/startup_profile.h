@@ -0,0 +1,113 @@
+#ifndef _STARTUP_PROFILE_H_
+#define _STARTUP_PROFILE_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file startup_profile.h
+* \ingroup Objects
+* \brief Header file for the StartupProfile class.
+*/
+
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <boost/core/noncopyable.hpp>
+
+class Timer;
+
+/*!
+* \ingroup Objects
+* \brief Records the time taken by and the memory in use after each named phase
+*        of model startup.
+* \details Phases such as parsing each input file, completeInit, creating the
+*          market dependency ordering and building the flow graph are bracketed
+*          with startPhase and endPhase.  The time is kept in a TimerRegistry
+*          timer named after the phase so a phase which is entered several
+*          times accumulates its total.  When a phase ends the resident set
+*          size and the peak resident set size of the process are recorded.
+*          Phases are reported in the order they were first started, both in
+*          the main log and, if the "startup-profile" configuration file has
+*          write-output set, as JSON for scripts comparing input loading
+*          changes.
+* \note Memory is read from /proc/self/status where available.  On other
+*       platforms only the peak resident size from getrusage is reported, or
+*       neither on Windows.
+*/
+class StartupProfile : private boost::noncopyable {
+public:
+    static StartupProfile& getInstance();
+
+    void startPhase( const std::string& aPhase );
+
+    void endPhase( const std::string& aPhase );
+
+    void print( std::ostream& aOut ) const;
+
+    bool writeJSON( const std::string& aFileName ) const;
+
+    void report() const;
+
+    static void getMemoryUsage( double& aResident, double& aPeakResident );
+private:
+    StartupProfile();
+
+    //! The measurements of a single named phase.
+    struct Phase {
+        //! The name of the phase.
+        std::string mName;
+
+        //! The registry timer holding the total time of the phase.
+        Timer* mTimer;
+
+        //! The number of times the phase was entered.
+        int mCount;
+
+        //! The resident memory in MB when the phase last ended.
+        double mResidentMemory;
+
+        //! The peak resident memory in MB when the phase last ended.
+        double mPeakResidentMemory;
+    };
+
+    Phase& getPhase( const std::string& aPhase );
+
+    //! The phases in the order they were first started.
+    std::vector<Phase> mPhases;
+};
+
+#endif // _STARTUP_PROFILE_H_
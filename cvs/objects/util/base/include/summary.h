@@ -69,6 +69,8 @@ private:
     SummaryItem emission;  //!< map of ghg emissions
     SummaryItem emissfuel;  //!< map of ghg emissions implicit in fuel
     SummaryItem sequesteredAmount;  //!< map of sequestered amount of emissions
+
+    static void addItems( SummaryItem& aTarget, const SummaryItem& aSource );
 public:
     Summary(); // default constructor
     void initfuelcons( const std::string& fname, const double value );
@@ -40,6 +40,7 @@
 #include <cassert>
 #include <algorithm>
 #include <vector>
+#include <type_traits>
 #include <boost/iterator/iterator_adaptor.hpp>
 
 // TODO: Reduce these includes
@@ -154,12 +155,22 @@ namespace objects {
         iterator last();
         typedef T value_type;
     protected:
-        //! Dynamic array containing the data.
+        TimeVectorBase( const unsigned int aSize, const T aDefaultValue,
+                        T* aInlineData, const size_t aInlineCapacity );
+
+        //! Array containing the data, either allocated or in mInlineData.
         T* mData;
 
         //! Size of the array.
         size_t mSize;
     private:
+        //! Uninitialized storage owned by the derived class which is used
+        //! instead of allocating when the size fits, or null if there is none.
+        T* mInlineData;
+
+        //! The number of elements which fit in mInlineData.
+        size_t mInlineCapacity;
+
         void init( const unsigned int aSize,
                    const T aDefaultValue );
 
@@ -176,6 +187,32 @@ namespace objects {
     template<class T>
         TimeVectorBase<T>::TimeVectorBase( const unsigned int aSize,
                                            const T aDefaultValue )
+        :mInlineData( 0 ),
+         mInlineCapacity( 0 )
+    {
+            init( aSize, aDefaultValue );
+    }
+
+    /*!
+     * \brief Constructor which places the data in storage provided by the
+     *        derived class if it is large enough.
+     * \details The storage must be uninitialized, suitably aligned for T, and
+     *          must outlive this object.  The elements are constructed in and
+     *          destroyed from the storage but it is never deallocated here.  If
+     *          the size exceeds the capacity of the storage the array is
+     *          allocated as usual.
+     * \param aSize Size of the TimeVectorBase.
+     * \param aDefaultValue Default for all values.
+     * \param aInlineData The storage to use.
+     * \param aInlineCapacity The number of elements which fit in the storage.
+     */
+    template<class T>
+        TimeVectorBase<T>::TimeVectorBase( const unsigned int aSize,
+                                           const T aDefaultValue,
+                                           T* aInlineData,
+                                           const size_t aInlineCapacity )
+        :mInlineData( aInlineData ),
+         mInlineCapacity( aInlineCapacity )
     {
             init( aSize, aDefaultValue );
     }
@@ -193,7 +230,14 @@ namespace objects {
      */
    template<class T>
        void TimeVectorBase<T>::clear(){
-            delete[] mData;
+            if( mData == mInlineData ) {
+                for( size_t i = 0; i < mSize; ++i ) {
+                    mData[ i ].~T();
+                }
+            }
+            else {
+                delete[] mData;
+            }
        }
 
    /*! 
@@ -207,7 +251,7 @@ namespace objects {
                                      const T aDefaultValue )
    {
            mSize = aSize;
-           mData = new T[ mSize ];
+           mData = mSize <= mInlineCapacity ? mInlineData : new T[ mSize ];
 
            // Initialize the data to the default value.
            std::uninitialized_fill( &mData[ 0 ], &mData[ 0 ] + mSize, aDefaultValue );
@@ -218,7 +262,10 @@ namespace objects {
      * \param aOther TimeVectorBase to copy.
      */
     template<class T>
-        TimeVectorBase<T>::TimeVectorBase( const TimeVectorBase<T>& aOther ){
+        TimeVectorBase<T>::TimeVectorBase( const TimeVectorBase<T>& aOther )
+        :mInlineData( 0 ),
+         mInlineCapacity( 0 )
+        {
             init( aOther.mSize, T() );
             std::copy( aOther.begin(), aOther.end(), begin() );
         }
@@ -233,8 +280,11 @@ namespace objects {
         TimeVectorBase<T>& TimeVectorBase<T>::operator=( const TimeVectorBase<T>& aOther ){
             // Check for self-assignment.
             if( this != &aOther ){
-                clear();
-                init( aOther.size(), T() );
+                // Reuse the existing array when the sizes match.
+                if( size() != aOther.size() ) {
+                    clear();
+                    init( aOther.size(), T() );
+                }
                 std::copy( aOther.begin(), aOther.end(), begin() );
             }
             return *this;
@@ -372,6 +422,11 @@ namespace objects {
                     const unsigned int aEndYear,
                     const T aDefaultValue = T() );
 
+        YearVector( const unsigned int aStartYear,
+                    const unsigned int aEndYear,
+                    T* aStorage,
+                    const T aDefaultValue = T() );
+
         const YearVector& operator=( const YearVector& aOther );
 
         virtual T& operator[]( const size_t aIndex );
@@ -413,6 +468,30 @@ namespace objects {
     {
     }
 
+    /*!
+     * \brief Constructor which places the data in storage owned by the caller.
+     * \details This allows many year vectors to share a single contiguous
+     *          allocation.  The storage must be uninitialized, have room for
+     *          every year from the start year to the end year, and must outlive
+     *          the vector.
+     * \param aStartYear First year of the array.
+     * \param aEndYear End year of the array.
+     * \param aStorage The storage in which to construct the data.
+     * \param aDefaultValue Default value for each year.
+     */
+    template<class T>
+    YearVector<T>::YearVector( const unsigned int aStartYear,
+                               const unsigned int aEndYear,
+                               T* aStorage,
+                               const T aDefaultValue )
+                               : TimeVectorBase<T>( aEndYear - aStartYear + 1,
+                                                    aDefaultValue, aStorage,
+                                                    aEndYear - aStartYear + 1 ),
+                                 mStartYear( aStartYear ),
+                                 mEndYear( aEndYear )
+    {
+    }
+
     /*!
      * \brief Assignment operator.
      * \param aOther YearVector to copy.
@@ -512,6 +591,27 @@ namespace objects {
             return mEndYear;
         }
 
+    /*!
+     * \brief The number of periods a PeriodVector can hold without allocating.
+     * \details This covers the periods of the standard model time with some
+     *          room to spare.  Larger model times fall back to allocating.
+     */
+    const size_t PERIOD_VECTOR_INLINE_SIZE = 24;
+
+    /*!
+     * \brief Uninitialized storage for the data of a PeriodVector.
+     * \details This is a separate base class of PeriodVector so that it is
+     *          created before the TimeVectorBase which places its data there.
+     */
+    template<class T>
+    struct PeriodVectorStorage {
+        typename std::aligned_storage<sizeof( T ), alignof( T )>::type mInlineStorage[ PERIOD_VECTOR_INLINE_SIZE ];
+
+        T* getInlineData() {
+            return reinterpret_cast<T*>( mInlineStorage );
+        }
+    };
+
     /*!
      * \brief Array which when constructed automatically sizes to the maximum
      *          number of periods.
@@ -519,9 +619,13 @@ namespace objects {
      *          per period as defined by the Modeltime object.
      * \note This class is especially useful when using arrays by period within
      *       maps, since maps automatically construct their elements.
+     * \note The data is kept inline rather than allocated when the number of
+     *       periods is no more than PERIOD_VECTOR_INLINE_SIZE so that the many
+     *       short arrays on technologies and inputs are laid out with the
+     *       objects which hold them.
      */
     template<class T>
-    class PeriodVector: public TimeVectorBase<T> {
+    class PeriodVector: private PeriodVectorStorage<T>, public TimeVectorBase<T> {
     public:
         using typename TimeVectorBase<T>::const_iterator;
         using typename TimeVectorBase<T>::iterator;
@@ -532,6 +636,8 @@ namespace objects {
         using TimeVectorBase<T>::assign;
 
         PeriodVector( const T aDefaultValue = T() );
+        PeriodVector( const PeriodVector& aOther );
+        PeriodVector& operator=( const PeriodVector& aOther );
         virtual T& operator[]( const size_t aIndex );
         virtual const T& operator[]( const size_t aIndex ) const;
     protected:
@@ -550,10 +656,37 @@ namespace objects {
     template<class T>
         PeriodVector<T>::PeriodVector( const T aDefaultValue )
         :TimeVectorBase<T>( scenario->getModeltime()->getmaxper(),
-                            aDefaultValue )
+                            aDefaultValue,
+                            PeriodVectorStorage<T>::getInlineData(),
+                            PERIOD_VECTOR_INLINE_SIZE )
+    {
+    }
+
+    /*!
+     * \brief Copy constructor which places the copy in its own inline storage.
+     * \param aOther PeriodVector to copy.
+     */
+    template<class T>
+        PeriodVector<T>::PeriodVector( const PeriodVector<T>& aOther )
+        :PeriodVectorStorage<T>(),
+         TimeVectorBase<T>( aOther.size(), T(),
+                            PeriodVectorStorage<T>::getInlineData(),
+                            PERIOD_VECTOR_INLINE_SIZE )
     {
+        std::copy( aOther.begin(), aOther.end(), begin() );
     }
 
+    /*!
+     * \brief Assignment operator which copies the data only.
+     * \param aOther PeriodVector to copy.
+     * \return This PeriodVector by reference (for chaining assignment).
+     */
+    template<class T>
+        PeriodVector<T>& PeriodVector<T>::operator=( const PeriodVector<T>& aOther ){
+            TimeVectorBase<T>::operator=( aOther );
+            return *this;
+        }
+
     /*!
      * \brief Operator which references data in the array.
      * \param aIndex Index of the value to return.
@@ -47,6 +47,8 @@
 
 #include <iosfwd>
 #include <string>
+#include <vector>
+#include <map>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/core/noncopyable.hpp>
 
@@ -54,6 +56,9 @@
 #include <tbb/spin_mutex.h>
 #endif
 
+#include "util/base/include/allocation_tracker.h"
+#include "util/base/include/hardware_counters.h"
+
 /*!
 * \ingroup Objects
 * \brief A very basic class which times and prints events.
@@ -65,6 +70,12 @@ public:
     void start();
     void stop();
     double getTotalTimeDifference() const;
+#if GCAM_TRACK_ALLOCATIONS
+    const AllocationTracker::Counts& getAllocations() const;
+#endif
+#if GCAM_USE_PERF_COUNTERS
+    const HardwareCounters::Counts& getCounters() const;
+#endif
     void print( std::ostream& aOut, const std::string& aTitle = "Time: " ) const;
 private:
     //! Time the timer started
@@ -79,6 +90,22 @@ private:
     
     //! The total time measured by this timer between all starts and stops.
     double mTotalTime;
+
+#if GCAM_TRACK_ALLOCATIONS
+    //! The allocations made by the process when the timer was started.
+    AllocationTracker::Counts mStartAllocations;
+
+    //! The allocations made between all starts and stops.
+    AllocationTracker::Counts mAllocations;
+#endif
+
+#if GCAM_USE_PERF_COUNTERS
+    //! The hardware counters of the starting thread when the timer was started.
+    HardwareCounters::Counts mStartCounters;
+
+    //! The hardware counts between all starts and stops.
+    HardwareCounters::Counts mCounters;
+#endif
 };
 
 /*!
@@ -119,6 +146,8 @@ public:
     Timer& getTimer( const PredefinedTimers aTimerName );
     
     void printAllTimers( std::ostream& aOut ) const;
+
+    bool writeJSON( const std::string& aFileName ) const;
 private:
     //! Private constructor to prevent multiple registries
     TimerRegistry();
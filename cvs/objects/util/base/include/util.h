@@ -470,6 +470,10 @@ namespace objects {
     
     std::string replaceSpaces( const std::string& aString );
 
+    bool isDebugRegion( const std::string& aRegionName );
+
+    bool isDebugYear( const int aYear );
+
     /*! \brief Static function which returns SMALL_NUM. 
     * \details This is a static function which is used to find the value of the
     *          constant SMALL_NUM. This avoids the initialization problems of
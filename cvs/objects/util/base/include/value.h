@@ -49,7 +49,9 @@
 #include "util/base/include/util.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <atomic>
 #include <tbb/enumerable_thread_specific.h>
+#include "util/base/include/deterministic_reduction.h"
 #endif
 
 /*! 
@@ -101,6 +103,8 @@ public:
     operator double() const;
     double get() const;
     double getDiff() const;
+    void addConcurrent( const double aValue );
+    double getConcurrent() const;
     bool isInited() const;
     Value& operator+=( const Value& aValue );
     Value& operator-=( const Value& aValue );
@@ -113,6 +117,38 @@ public:
     Value& operator/=( const double& aValue );
     Value& operator=( const double& aDblValue );
 
+    //! The number of bytes reserved by ManageStateVariables directly in front
+    //! of each state, before which the dirty flags are stored.
+    static const int STATE_HEADER_SIZE = 64;
+    //! The log2 of the number of consecutive values that share a dirty flag.
+    static const int DIRTY_BLOCK_SHIFT = 6;
+
+    /*!
+     * \brief Binds the calling thread's state to a raw pointer for the
+     *        lifetime of this object.
+     * \details When GCAM_PARALLEL_ENABLED every access of a STATE Value must
+     *          otherwise find the calling thread's slot of sCentralValue.  The
+     *          drivers of IActivity::calc create one of these before a run of
+     *          activities on a thread so that the accesses within it are a
+     *          single load of a thread local pointer plus the index.  Bindings
+     *          may be nested and the previous binding is restored on
+     *          destruction.  Without GCAM_PARALLEL_ENABLED this does nothing.
+     * \warning ManageStateVariables::setPartialDeriv must not be called while a
+     *          binding exists as the bound pointer would not follow it.
+     */
+    class ScopedStateBinding {
+    public:
+        ScopedStateBinding();
+        ~ScopedStateBinding();
+        static void setEnabled( const bool aEnabled );
+        static bool isEnabled();
+    private:
+#if GCAM_PARALLEL_ENABLED
+        //! The binding of this thread when this object was created.
+        double* mPrevious;
+#endif
+    };
+
     // XML Function here.
 private:
     void print( std::ostream& aOutputStream ) const;
@@ -120,8 +156,6 @@ private:
 
     //! The actual underly value of this class.
     double mValue;
-    //! A flag to indicate if this Value has been set to any value besides the default.
-    bool mIsInit;
 #if !GCAM_PARALLEL_ENABLED
     typedef double* CentralValueType;
 #else
@@ -138,8 +172,34 @@ private:
     //! A static reference into the "base" state of ManageStateVariables::mStateData
     //! mostly for convenience.
     static double* sBaseCentralValue;
+    //! A flag to indicate if writes to the central state should be recorded so
+    //! that ManageStateVariables::copyState only needs to restore what changed.
+    static bool sTrackDirty;
+
+    //! The state whose blocks are saved to sUndoLog before they are first
+    //! modified, null when ManageStateVariables is not keeping an undo log.
+    static double* sUndoState;
+
+    //! The copy of each block of sUndoState as it was when the undo log was
+    //! started, only valid for the blocks flagged as saved.
+    static double* sUndoLog;
+
+    //! The number of values in sUndoState.
+    static size_t sUndoSize;
+#if GCAM_PARALLEL_ENABLED
+    //! The state bound to this thread by a ScopedStateBinding or null if
+    //! sCentralValue must be consulted.
+    static thread_local double* sBoundState;
+    //! Whether ScopedStateBinding should bind states, set from the
+    //! bind-activity-state configuration value.
+    static bool sBindState;
+#endif
     //! The index into sCentralValue that contains the data for this instance.
     unsigned int mCentralValueIndex;
+    //! A flag to indicate if this Value has been set to any value besides the default.
+    //! Note the flags are declared after mCentralValueIndex so that they share
+    //! its padding and a Value takes up just two doubles.
+    bool mIsInit;
     //! A flag to indicate if this instance of Value has been identified as active
     //! state.  If so it can assume that mCentralValueIndex has been appropriately
     //! set and mValue gets copied in/out of sBaseCentralValue at the appropriate
@@ -151,8 +211,13 @@ private:
 #endif
     double& getInternal();
     const double& getInternal() const;
+    static void markDirty( double* aState, const unsigned int aIndex );
+
+    static void saveUndoBlock( unsigned char* aFlag, const unsigned int aIndex );
 };
 
+static_assert( sizeof( Value ) <= 2 * sizeof( double ), "Value should not take up more than two doubles" );
+
 inline Value::Value(): mValue( 0 ), mIsInit( false ), mIsStateCopy( false ){
 }
 
@@ -184,13 +249,48 @@ inline void Value::init( const double aNewValue ){
  * \return A reference the the appropriate value represented by this class.
  */
 inline double& Value::getInternal() {
-    return mIsStateCopy ?
+    if( !mIsStateCopy ) {
+        return mValue;
+    }
 #if !GCAM_PARALLEL_ENABLED
-        sCentralValue[mCentralValueIndex]
+    double* state = sCentralValue;
 #else
-        sCentralValue.local()[mCentralValueIndex]
+    double* state = sBoundState ? sBoundState : sCentralValue.local();
 #endif
-        : mValue;
+    // The non-const accessor is only used to modify the value.
+    if( sTrackDirty ) {
+        markDirty( state, mCentralValueIndex );
+    }
+    return state[mCentralValueIndex];
+}
+
+/*!
+ * \brief Flag the block of state containing the given value as modified.
+ * \details The flags are stored in front of each state by ManageStateVariables
+ *          in reverse order of block such that the flag for the first block
+ *          immediately precedes the state's header.  If an undo log is being
+ *          kept for the state the block is saved to it first.
+ * \param aState The state being modified.
+ * \param aIndex The index of the value in the state.
+ */
+inline void Value::markDirty( double* aState, const unsigned int aIndex ) {
+    unsigned char* flag = reinterpret_cast<unsigned char*>( aState ) - STATE_HEADER_SIZE - 1
+        - static_cast<int>( aIndex >> DIRTY_BLOCK_SHIFT );
+    if( aState != sUndoState ) {
+#if GCAM_PARALLEL_ENABLED
+        // Several threads may mark the same block of a shared state.
+        reinterpret_cast<std::atomic<unsigned char>*>( flag )->store( 1, std::memory_order_relaxed );
+#else
+        *flag = 1;
+#endif
+    }
+#if GCAM_PARALLEL_ENABLED
+    else if( reinterpret_cast<std::atomic<unsigned char>*>( flag )->load( std::memory_order_acquire ) != 1 ) {
+#else
+    else if( *flag != 1 ) {
+#endif
+        saveUndoBlock( flag, aIndex );
+    }
 }
 
 /*!
@@ -204,11 +304,54 @@ inline const double& Value::getInternal() const {
 #if !GCAM_PARALLEL_ENABLED
         sCentralValue[mCentralValueIndex]
 #else
-        sCentralValue.local()[mCentralValueIndex]
+        ( sBoundState ? sBoundState : sCentralValue.local() )[mCentralValueIndex]
 #endif
         : mValue;
 }
 
+//! Bind the calling thread's state if binding is enabled.
+inline Value::ScopedStateBinding::ScopedStateBinding()
+#if GCAM_PARALLEL_ENABLED
+:mPrevious( sBoundState )
+{
+    if( sBindState ) {
+        sBoundState = sCentralValue.local();
+    }
+}
+#else
+{
+}
+#endif
+
+//! Restore the previous binding of the calling thread.
+inline Value::ScopedStateBinding::~ScopedStateBinding() {
+#if GCAM_PARALLEL_ENABLED
+    sBoundState = mPrevious;
+#endif
+}
+
+/*!
+ * \brief Set whether bindings created from now on bind the thread's state.
+ * \param aEnabled Whether to bind states.
+ */
+inline void Value::ScopedStateBinding::setEnabled( const bool aEnabled ) {
+#if GCAM_PARALLEL_ENABLED
+    sBindState = aEnabled;
+#endif
+}
+
+/*!
+ * \brief Get whether bindings bind the thread's state.
+ * \return Whether states are bound, always false without GCAM_PARALLEL_ENABLED.
+ */
+inline bool Value::ScopedStateBinding::isEnabled() {
+#if GCAM_PARALLEL_ENABLED
+    return sBindState;
+#else
+    return false;
+#endif
+}
+
 //! Set the value.
 inline void Value::set( const double aNewValue ){
     assert( util::isValidNumber( aNewValue ) );
@@ -233,6 +376,58 @@ inline double Value::getDiff() const {
     return getInternal() - sBaseCentralValue[ mCentralValueIndex ];
 }
 
+/*!
+ * \brief Increment the value when other threads may be doing the same.
+ * \details When GCAM_PARALLEL_ENABLED the addition is done with an atomic
+ *          compare and swap so that concurrent adds to the same value, such as
+ *          to the supply or demand of a market from several parts of the flow
+ *          graph, do not need a lock.  Note the value must be read with
+ *          getConcurrent while other threads may be adding to it.  During a
+ *          flow graph calculation with deterministic reduction the addition is
+ *          instead ordered by DeterministicReduction.
+ * \param aValue The amount to add.
+ */
+inline void Value::addConcurrent( const double aValue ) {
+#if GCAM_PARALLEL_ENABLED
+    static_assert( sizeof( std::atomic<double> ) == sizeof( double ), "An atomic double must have the layout of a double" );
+    static_assert( sizeof( std::atomic<bool> ) == sizeof( bool ), "An atomic bool must have the layout of a bool" );
+    // Only the first add to a value needs to set the flag, so avoid having
+    // every thread write it.
+    std::atomic<bool>& isInit = reinterpret_cast<std::atomic<bool>&>( mIsInit );
+    if( !isInit.load( std::memory_order_relaxed ) ) {
+        isInit.store( true, std::memory_order_relaxed );
+    }
+    if( DeterministicReduction::isActive() ) {
+        DeterministicReduction::add( getInternal(), aValue );
+    }
+    else {
+        std::atomic<double>& value = reinterpret_cast<std::atomic<double>&>( getInternal() );
+        double curr = value.load( std::memory_order_relaxed );
+        while( !value.compare_exchange_weak( curr, curr + aValue, std::memory_order_relaxed ) ) {
+        }
+    }
+#else
+    mIsInit = true;
+    getInternal() += aValue;
+#endif
+#if DEBUG_STATE
+    doStateCheck();
+#endif
+}
+
+/*!
+ * \brief Get the value when other threads may be adding to it with
+ *        addConcurrent.
+ * \return The value.
+ */
+inline double Value::getConcurrent() const {
+#if GCAM_PARALLEL_ENABLED
+    return reinterpret_cast<const std::atomic<double>&>( getInternal() ).load( std::memory_order_relaxed );
+#else
+    return getInternal();
+#endif
+}
+
 //! Get the value.
 inline Value::operator double() const {
     return getInternal();
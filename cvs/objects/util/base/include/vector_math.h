@@ -0,0 +1,113 @@
+#ifndef _VECTOR_MATH_H_
+#define _VECTOR_MATH_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file vector_math.h
+* \ingroup Objects
+* \brief Batched math functions for arrays of doubles.
+*/
+
+#include <cmath>
+#include <cstddef>
+
+#if GCAM_USE_SLEEF
+#include <immintrin.h>
+#include <sleef.h>
+#endif
+
+/*!
+ * \ingroup Objects
+ * \brief Math functions applied in place to whole arrays.
+ * \details When GCAM_USE_SLEEF is set the SLEEF vectorized math library is
+ *          used to process several values at once with functions accurate to
+ *          1.0 ULP.  This allows results to differ from the standard library
+ *          in the last digit.  Otherwise the standard library functions are
+ *          called on each value so results match calling them directly.
+ */
+namespace VectorMath {
+    /*!
+     * \brief Replace each value with its natural log.
+     * \param aValues The values.
+     * \param aNumValues The number of values.
+     */
+    inline void log( double* aValues, const size_t aNumValues ) {
+        size_t i = 0;
+#if GCAM_USE_SLEEF
+#if defined(__AVX__)
+        for( ; i + 4 <= aNumValues; i += 4 ) {
+            _mm256_storeu_pd( aValues + i, Sleef_logd4_u10( _mm256_loadu_pd( aValues + i ) ) );
+        }
+#endif
+        for( ; i + 2 <= aNumValues; i += 2 ) {
+            _mm_storeu_pd( aValues + i, Sleef_logd2_u10( _mm_loadu_pd( aValues + i ) ) );
+        }
+#endif
+        for( ; i < aNumValues; ++i ) {
+            aValues[ i ] = std::log( aValues[ i ] );
+        }
+    }
+
+    /*!
+     * \brief Replace each value with its exponential.
+     * \param aValues The values.
+     * \param aNumValues The number of values.
+     */
+    inline void exp( double* aValues, const size_t aNumValues ) {
+        size_t i = 0;
+#if GCAM_USE_SLEEF
+#if defined(__AVX__)
+        for( ; i + 4 <= aNumValues; i += 4 ) {
+            _mm256_storeu_pd( aValues + i, Sleef_expd4_u10( _mm256_loadu_pd( aValues + i ) ) );
+        }
+#endif
+        for( ; i + 2 <= aNumValues; i += 2 ) {
+            _mm_storeu_pd( aValues + i, Sleef_expd2_u10( _mm_loadu_pd( aValues + i ) ) );
+        }
+#endif
+        for( ; i < aNumValues; ++i ) {
+            aValues[ i ] = std::exp( aValues[ i ] );
+        }
+    }
+
+    //! The number of values to batch when an algorithm needs scratch space
+    //! on the stack to use the functions above.
+    const size_t BATCH_SIZE = 32;
+}
+
+#endif // _VECTOR_MATH_H_
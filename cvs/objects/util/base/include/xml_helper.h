@@ -71,6 +71,8 @@
 #include <map>
 #include <memory>
 #include <typeinfo>
+#include <limits>
+#include <cstdlib>
 
 #include <xercesc/parsers/XercesDOMParser.hpp>
 #include <xercesc/dom/DOMNode.hpp>
@@ -91,6 +93,8 @@
 #include "util/base/include/iparsable.h"
 #include "util/base/include/time_vector.h"
 #include "util/base/include/value.h"
+#include "util/base/include/compressed_input_source.h"
+#include "util/base/include/xml_write_buffer.h"
 
 /*!
  * \ingroup Objects
@@ -135,17 +139,21 @@ public:
     * \return void
     */
    void writeTabs( std::ostream& out ) const {
+      std::string& buffer = XMLWriteBuffer::start();
+      appendTabs( buffer );
+      XMLWriteBuffer::write( buffer, out );
+   }
+
+   /*! Append the contained number of tabs to a buffer.
+    *
+    * \param aBuffer The buffer to append to.
+    */
+   void appendTabs( std::string& aBuffer ) const {
       if ( mUseTabs ) {
-         for ( int i = 0; i != mNumTabs; ++i ) {
-            out << "\t";
-         }
+         aBuffer.append( mNumTabs, '\t' );
       }
-      else if ( mTabWidth ) {
-         std::string::size_type  n = mTabWidth * mNumTabs;
-         if ( n ) {
-            std::string spaces( n, ' ' );
-            out << spaces;
-         }
+      else {
+         aBuffer.append( mTabWidth * mNumTabs, ' ' );
       }
    }
 };
@@ -183,6 +191,11 @@ public:
    static void serializeNode( const xercesc::DOMNode* aNode, std::ostream& aOut, Tabs* aTabs,
                               const bool aDeep );
 private:
+    static T convertValue( const XMLCh* aValue );
+    template<class U>
+    static bool fastConvertValue( const XMLCh* aValue, U& aResult );
+    static bool fastConvertValue( const XMLCh* aValue, double& aResult );
+    static bool fastConvertValue( const XMLCh* aValue, int& aResult );
     static xercesc::XercesDOMParser** getParserPointerInternal();
     static xercesc::ErrorHandler** getErrorHandlerPointerInternal();
     static void initParser();
@@ -214,21 +227,34 @@ T XMLHelper<T>::getValue( const xercesc::DOMNode* node ){
       return T();
    }
 
-   // Attempt to convert the XML string to the appropriate type. This uses the
-   // boost library lexical_cast operation, which is similar to the C++
-   // static_cast, but allows conversion from a string into its numerical value.
-   // This operation will fail if the string cannot be converted into the
-   // expected type, in which case this function will return the default value
-   // of the type.
+   return convertValue( curr->getNodeValue() );
+}
+
+/*! \brief Convert the text of a node or attribute to the requested type.
+* \details Attempts to convert the XML string to the appropriate type. This uses
+* the boost library lexical_cast operation, which is similar to the C++
+* static_cast, but allows conversion from a string into its numerical value.
+* This operation will fail if the string cannot be converted into the expected
+* type, in which case this function will return the default value of the type.
+* Numeric types first try fastConvertValue which avoids transcoding the value.
+* \param aValue The XML string to convert.
+* \return The converted value or the default value of the type on failure.
+*/
+template<class T>
+T XMLHelper<T>::convertValue( const XMLCh* aValue ){
+   T returnValue;
+   if( fastConvertValue( aValue, returnValue ) ){
+       return returnValue;
+   }
    try {
-       T returnValue = boost::lexical_cast<T>( safeTranscode( curr->getNodeValue() ) );
+       returnValue = boost::lexical_cast<T>( safeTranscode( aValue ) );
        return returnValue;
    }
    catch( boost::bad_lexical_cast& ) {
        try {
            // Cast the value to a string to print a more useful error message.
            // This cast should not fail because the value is read as a string.
-           const std::string valueAsString = boost::lexical_cast<std::string>( safeTranscode( curr->getNodeValue() ) );
+           const std::string valueAsString = boost::lexical_cast<std::string>( safeTranscode( aValue ) );
            std::cout << "Cast of node with value " << valueAsString << " to return type failed." << std::endl;
        }
        catch( boost::bad_lexical_cast& ){
@@ -241,6 +267,89 @@ T XMLHelper<T>::getValue( const xercesc::DOMNode* node ){
    }
 }
 
+/*! \brief Convert an XML string directly without creating a temporary string.
+* \details There is no fast conversion for most types, however double and int
+* have overloads.  A fast conversion only accepts values it is certain to
+* convert as lexical_cast would, in all other cases it returns false so that
+* convertValue falls back to lexical_cast which also reports any failure.
+* \param aValue The XML string to convert.
+* \param aResult Set to the converted value if conversion succeeded.
+* \return Whether the fast conversion succeeded.
+*/
+template<class T>
+template<class U>
+bool XMLHelper<T>::fastConvertValue( const XMLCh* aValue, U& aResult ){
+   return false;
+}
+
+/*! \brief Convert an XML string to a double without transcoding it.
+* \details Only plain decimal numbers with an optional exponent which fit in a
+* small buffer are handled, they are converted with strtod in the C locale
+* which rounds correctly.
+* \param aValue The XML string to convert.
+* \param aResult Set to the converted value if conversion succeeded.
+* \return Whether the fast conversion succeeded.
+*/
+template<class T>
+bool XMLHelper<T>::fastConvertValue( const XMLCh* aValue, double& aResult ){
+   const int MAX_LENGTH = 64;
+   char buffer[ MAX_LENGTH ];
+   int length = 0;
+   for( ; aValue[ length ] != 0; ++length ){
+      const XMLCh curr = aValue[ length ];
+      if( length == MAX_LENGTH - 1 || !( ( curr >= '0' && curr <= '9' ) || curr == '.' ||
+          curr == '-' || curr == '+' || curr == 'e' || curr == 'E' ) )
+      {
+         return false;
+      }
+      buffer[ length ] = static_cast<char>( curr );
+   }
+   if( length == 0 ){
+      return false;
+   }
+   buffer[ length ] = 0;
+   char* end;
+   aResult = strtod( buffer, &end );
+   return end == buffer + length;
+}
+
+/*! \brief Convert an XML string to an int without transcoding it.
+* \details Accepts an optional sign followed by digits, anything else or a value
+* which does not fit is left to lexical_cast.
+* \param aValue The XML string to convert.
+* \param aResult Set to the converted value if conversion succeeded.
+* \return Whether the fast conversion succeeded.
+*/
+template<class T>
+bool XMLHelper<T>::fastConvertValue( const XMLCh* aValue, int& aResult ){
+   int pos = 0;
+   const bool isNegative = aValue[ 0 ] == '-';
+   if( isNegative || aValue[ 0 ] == '+' ){
+      ++pos;
+   }
+   if( aValue[ pos ] == 0 ){
+      return false;
+   }
+   long long value = 0;
+   for( ; aValue[ pos ] != 0; ++pos ){
+      if( aValue[ pos ] < '0' || aValue[ pos ] > '9' ){
+         return false;
+      }
+      value = value * 10 + ( aValue[ pos ] - '0' );
+      if( value > static_cast<long long>( std::numeric_limits<int>::max() ) + 1 ){
+         return false;
+      }
+   }
+   if( isNegative ){
+      value = -value;
+   }
+   if( value > std::numeric_limits<int>::max() || value < std::numeric_limits<int>::min() ){
+      return false;
+   }
+   aResult = static_cast<int>( value );
+   return true;
+}
+
 /*! Returns the requested attribute of the element node passed to the function.
 * \details This function searches for the attribute with name attrName of the argument node.
 * It then converts it to type T and returns the value. If the function is not passed an element
@@ -274,31 +383,7 @@ T XMLHelper<T>::getAttr( const xercesc::DOMNode* node, const std::string attrNam
       return T();
    }
 
-   // Attempt to convert the XML string to the appropriate type. This uses the
-   // boost library lexical_cast operation, which is similar to the C++
-   // static_cast, but allows conversion from a string into its numerical value.
-   // This operation will fail if the string cannot be converted into the
-   // expected type, in which case this function will return the default value
-   // of the type.
-   try {
-       T returnValue = boost::lexical_cast<T>( safeTranscode( nameAttr->getValue() ) );
-       return returnValue;
-   }
-   catch( boost::bad_lexical_cast& ) {
-       try {
-           // Cast the value to a string to print a more useful error message.
-           // This cast should not fail because the value is read as a string.
-           const std::string valueAsString = boost::lexical_cast<std::string>( safeTranscode( nameAttr->getValue() ) );
-           std::cout << "Cast of node with value " << valueAsString << " to return type failed." << std::endl;
-       }
-       catch( boost::bad_lexical_cast& ){
-           // The cast to a string should never fail because a string is read
-           // in.
-           assert( false );
-       }
-       // Set the return value to the default value.
-       return T();
-   }
+   return convertValue( nameAttr->getValue() );
 }
 
 /*!
@@ -539,27 +624,35 @@ std::string XMLHelper<T>::safeTranscode( const XMLCh* toTranscode ) {
 * \param fillout Optional attribute which specifies the value should be applied to all following time periods.
 */
 template<class T>
-void XMLWriteElement( const T value, const std::string elementName, std::ostream& out, const Tabs* tabs, const int year = 0, const std::string name = "", const bool fillout = false ) {
-
-   tabs->writeTabs( out );
+void XMLWriteElement( const T& value, const std::string& elementName, std::ostream& out, const Tabs* tabs, const int year = 0, const std::string& name = "", const bool fillout = false ) {
+   std::string& buffer = XMLWriteBuffer::start();
+   tabs->appendTabs( buffer );
 
-   out << "<" << elementName;
+   buffer += '<';
+   buffer += elementName;
 
-   if ( name != "" ) {
-      out << " name=\"" << name << "\"";
+   if ( !name.empty() ) {
+      buffer += " name=\"";
+      buffer += name;
+      buffer += '"';
    }
 
    if( year != 0 ){
-      out << " year=\"" << year << "\"";
+      buffer += " year=\"";
+      XMLWriteBuffer::appendValue( buffer, year, out );
+      buffer += '"';
    }
    if( fillout ){
-       out << " fillout=\"" << 1 << "\"";
+       buffer += " fillout=\"1\"";
    }
-   out << ">";
+   buffer += '>';
 
-   out << value;
+   XMLWriteBuffer::appendValue( buffer, value, out );
 
-   out << "</" << elementName << ">" << std::endl;
+   buffer += "</";
+   buffer += elementName;
+   buffer += ">\n";
+   XMLWriteBuffer::write( buffer, out );
 }
 //! Function to write the argument element to xml with a integer attribute in proper format.
 /*!
@@ -572,17 +665,28 @@ void XMLWriteElement( const T value, const std::string elementName, std::ostream
 * \param aAttrs Map of attribute name to attribute value.
 */
 template<class T, class U>
-void XMLWriteElementWithAttributes( const T value, const std::string elementName,
+void XMLWriteElementWithAttributes( const T& value, const std::string& elementName,
                                    std::ostream& out, const Tabs* tabs,
-                                   const std::map<std::string, U> aAttrs )
+                                   const std::map<std::string, U>& aAttrs )
 {
-    tabs->writeTabs( out );
-    out << "<" << elementName;
+    std::string& buffer = XMLWriteBuffer::start();
+    tabs->appendTabs( buffer );
+    buffer += '<';
+    buffer += elementName;
     typedef typename std::map<std::string, U>::const_iterator MapIterator;
     for( MapIterator entry = aAttrs.begin(); entry != aAttrs.end(); ++entry ){
-        out << " " << entry->first <<"=\"" << entry->second << "\"";
+        buffer += ' ';
+        buffer += entry->first;
+        buffer += "=\"";
+        XMLWriteBuffer::appendValue( buffer, entry->second, out );
+        buffer += '"';
     }
-    out << ">" << value << "</" << elementName << ">" << std::endl;
+    buffer += '>';
+    XMLWriteBuffer::appendValue( buffer, value, out );
+    buffer += "</";
+    buffer += elementName;
+    buffer += ">\n";
+    XMLWriteBuffer::write( buffer, out );
 }
 
 /*! \brief Write an element XML tag.
@@ -641,20 +745,28 @@ inline void XMLWriteCloseElementTag( std::string& elementName, std::ostream& out
 * \param type Optional type name to print as an attribute.
 */
 inline void XMLWriteOpeningTag( const std::string& elementName, std::ostream& out, Tabs* tabs, const std::string& name = "", const int year = 0, const std::string& type = "" ) {
-
-    tabs->writeTabs( out );
-    out << "<" << elementName;
+    std::string& buffer = XMLWriteBuffer::start();
+    tabs->appendTabs( buffer );
+    buffer += '<';
+    buffer += elementName;
 
     if( year ){
-        out << " year=\"" << year << "\"";
+        buffer += " year=\"";
+        XMLWriteBuffer::appendValue( buffer, year, out );
+        buffer += '"';
     }
-    if ( name != "" ){
-        out << " name=\"" << name << "\"";
+    if ( !name.empty() ){
+        buffer += " name=\"";
+        buffer += name;
+        buffer += '"';
     }
-    if( type != "" ){
-        out << " type=\"" << type << "\"";
+    if( !type.empty() ){
+        buffer += " type=\"";
+        buffer += type;
+        buffer += '"';
     }
-    out << ">" << std::endl;
+    buffer += ">\n";
+    XMLWriteBuffer::write( buffer, out );
     tabs->increaseIndent();
 }
 
@@ -667,11 +779,13 @@ inline void XMLWriteOpeningTag( const std::string& elementName, std::ostream& ou
 * \param tabs The number of tabs to print before the element.
 */
 inline void XMLWriteClosingTag( const std::string& elementName, std::ostream& out, Tabs* tabs ) {
-
     tabs->decreaseIndent();
-    tabs->writeTabs( out );
-    out << "</" << elementName;
-    out << ">" << std::endl;
+    std::string& buffer = XMLWriteBuffer::start();
+    tabs->appendTabs( buffer );
+    buffer += "</";
+    buffer += elementName;
+    buffer += ">\n";
+    XMLWriteBuffer::write( buffer, out );
 }
 
 //! Function to write the argument element to xml in proper format if it is not equal to the default value for the element..
@@ -688,7 +802,7 @@ inline void XMLWriteClosingTag( const std::string& elementName, std::ostream& ou
 * \param fillout Optional boolean whether to add the fillout attribute with a true value.
 */
 template<class T>
-void XMLWriteElementCheckDefault( const T value, const std::string elementName, std::ostream& out, const Tabs* tabs, const T defaultValue = T(), const int year = 0, const std::string name = "", const bool fillout = false ) {
+void XMLWriteElementCheckDefault( const T& value, const std::string& elementName, std::ostream& out, const Tabs* tabs, const T defaultValue = T(), const int year = 0, const std::string& name = "", const bool fillout = false ) {
    if( !util::isEqual( value, defaultValue ) ) {
        XMLWriteElement( value, elementName, out, tabs, year, name, fillout );
    }
@@ -858,7 +972,13 @@ bool XMLHelper<T>::parseXML( const std::string& aXMLFile, IParsable* aModelEleme
     ++numParses;
     xercesc::XercesDOMParser* parser = XMLHelper<T>::getParser();
     try {
-        parser->parse( aXMLFile.c_str() );
+        if( CompressedInputSource::isCompressed( aXMLFile ) ) {
+            CompressedInputSource source( aXMLFile );
+            parser->parse( source );
+        }
+        else {
+            parser->parse( aXMLFile.c_str() );
+        }
     } catch ( const xercesc::XMLException& toCatch ) {
         std::string message = XMLHelper<std::string>::safeTranscode( toCatch.getMessage() );
         std::cout << "ERROR: XML Read Exception message is:" << std::endl << message << std::endl;
@@ -0,0 +1,137 @@
+#ifndef _XML_STREAM_PARSER_H_
+#define _XML_STREAM_PARSER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file xml_stream_parser.h
+* \ingroup Objects
+* \brief Header file for the XMLStreamParser class.
+*/
+
+#include <string>
+#include <vector>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+
+class IParsable;
+
+/*!
+* \ingroup Objects
+* \brief Parses an XML input file with SAX into a series of small DOM trees so
+*        that the whole document never needs to be held in memory.
+* \details The XMLParse methods of the model operate on DOM nodes and merge
+*          what they are given into the existing objects, which is what allows
+*          add-on files to modify a scenario.  This parser relies on that to
+*          stream a file: elements deeper than the chunk depth are built into a
+*          DOM as usual, but as soon as an element at the chunk depth closes the
+*          tree consisting of it and a copy of its ancestors, with their
+*          attributes, is passed to XMLParse and then discarded.  With the
+*          default chunk depth of two a scenario file is parsed one region (or
+*          other child of world) at a time which gives the same result as if
+*          each region were in its own add-on file.  Ancestors which carry a
+*          delete attribute are never split since the delete would be repeated
+*          for each chunk.
+*
+*          Streaming is used for the scenario input files when the boolean
+*          configuration value "stream-xml-input" is set, the chunk depth may be
+*          changed with the integer value "xml-stream-chunk-depth".
+*/
+class XMLStreamParser : public xercesc::DefaultHandler {
+    // The input snapshot replays its stored documents through the parser.
+    friend class InputSnapshot;
+public:
+    static bool parseInput( const std::string& aXMLFile, IParsable* aModelElement );
+
+    static bool parseXML( const std::string& aXMLFile, IParsable* aModelElement, const int aChunkDepth );
+
+    virtual ~XMLStreamParser();
+
+    // DefaultHandler methods
+    virtual void startElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                               const XMLCh* const aQName, const xercesc::Attributes& aAttrs );
+
+    virtual void endElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                             const XMLCh* const aQName );
+
+    virtual void characters( const XMLCh* const aChars, const XMLSize_t aLength );
+
+private:
+    XMLStreamParser( const std::string& aXMLFile, IParsable* aModelElement, const int aChunkDepth );
+
+    //! Private undefined copy constructor to prevent copying.
+    XMLStreamParser( const XMLStreamParser& );
+    //! Private undefined assignment operator to prevent copying.
+    XMLStreamParser& operator=( const XMLStreamParser& );
+
+    xercesc::DOMElement* beginElement( const XMLCh* aName );
+
+    void addAttribute( xercesc::DOMElement* aElement, const XMLCh* aName, const XMLCh* aValue );
+
+    void dispatchChunk( xercesc::DOMNode* aChunk );
+
+    //! The object to pass each chunk to.
+    IParsable* mModelElement;
+
+    //! The depth of the elements which are parsed one at a time, the document
+    //! element has depth zero.
+    const int mChunkDepth;
+
+    //! The document holding the chunk currently being built.
+    xercesc::DOMDocument* mDocument;
+
+    //! The element currently being built.
+    xercesc::DOMNode* mCurrent;
+
+    //! For each open element whether any chunk has been dispatched from
+    //! within it, in which case it only remains as an ancestor for its later
+    //! children.
+    std::vector<bool> mIsSplit;
+
+    //! The depth of the open element with a delete attribute which is kept
+    //! whole or -1 if there is none.
+    int mWholeDepth;
+
+    //! Whether all XMLParse calls succeeded.
+    bool mSuccess;
+
+    //! The number of chunks passed to XMLParse.
+    int mNumChunks;
+};
+
+#endif // _XML_STREAM_PARSER_H_
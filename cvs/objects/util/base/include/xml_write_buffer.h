@@ -0,0 +1,110 @@
+#ifndef _XML_WRITE_BUFFER_H_
+#define _XML_WRITE_BUFFER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file xml_write_buffer.h
+* \ingroup Objects
+* \brief XMLWriteBuffer class header file.
+*/
+
+#include <string>
+#include <iosfwd>
+#include <ostream>
+#include "util/base/include/value.h"
+
+/*!
+ * \ingroup Objects
+ * \brief Static helpers used by the XML writing functions to build each
+ *        element in a reusable buffer.
+ * \details Writing an element piece by piece through an ostream pays for the
+ *          stream sentry, locale lookups and any temporary strings for every
+ *          piece.  Instead the XML writing functions append the whole element
+ *          to a per thread buffer which keeps its capacity between elements
+ *          and write it to the stream in one call.
+ *
+ *          Numbers are formatted exactly as the stream would format them by
+ *          default, honoring its precision.  A stream with a precision of
+ *          FULL_PRECISION or more instead gets the shortest of 15, 16 or 17
+ *          significant digits which reads back as the same double.  A stream
+ *          with any other formatting flags, a width, or values of other types
+ *          fall back to the stream itself.
+ */
+class XMLWriteBuffer {
+public:
+    //! The stream precision which requests values that read back exactly.
+    static const int FULL_PRECISION = 17;
+
+    static std::string& start();
+
+    static void write( std::string& aBuffer, std::ostream& aOut );
+
+    static void appendValue( std::string& aBuffer, const double aValue, std::ostream& aOut );
+
+    static void appendValue( std::string& aBuffer, const int aValue, std::ostream& aOut );
+
+    static void appendValue( std::string& aBuffer, const bool aValue, std::ostream& aOut );
+
+    static void appendValue( std::string& aBuffer, const std::string& aValue, std::ostream& aOut );
+
+    static void appendValue( std::string& aBuffer, const char* aValue, std::ostream& aOut );
+
+    static void appendValue( std::string& aBuffer, const Value& aValue, std::ostream& aOut );
+
+    template<class T>
+    static void appendValue( std::string& aBuffer, const T& aValue, std::ostream& aOut );
+
+    static int formatRoundTrip( const double aValue, char* aString );
+};
+
+/*!
+ * \brief Append a value of a type with no fast formatting by writing it to
+ *        the stream directly.
+ * \details The buffered part of the element is written first to keep the
+ *          order.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+template<class T>
+void XMLWriteBuffer::appendValue( std::string& aBuffer, const T& aValue, std::ostream& aOut ) {
+    write( aBuffer, aOut );
+    aOut << aValue;
+}
+
+#endif // _XML_WRITE_BUFFER_H_
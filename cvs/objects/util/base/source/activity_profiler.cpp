@@ -0,0 +1,217 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file activity_profiler.cpp
+* \ingroup Objects
+* \brief ActivityProfiler class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <fstream>
+#include <algorithm>
+
+#include "util/base/include/activity_profiler.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+#include "containers/include/iactivity.h"
+
+using namespace std;
+
+namespace {
+    //! The number of activities to print to the main log each period.
+    const size_t NUM_ACTIVITIES_TO_LOG = 20;
+
+    //! The counts of one activity copied out at the end of a period.
+    struct PeriodCounts {
+        const IActivity* mActivity;
+        uint64_t mFullCalls;
+        double mFullSeconds;
+        uint64_t mPartialCalls;
+        double mPartialSeconds;
+    };
+}
+
+/*!
+ * \brief Constructor which zeros the counts.
+ */
+ActivityProfiler::Counts::Counts()
+:mFullCalls( 0 ),
+mFullNanoseconds( 0 ),
+mPartialCalls( 0 ),
+mPartialNanoseconds( 0 )
+{
+}
+
+/*!
+ * \brief Constructor which checks the configuration to see if profiling is on.
+ */
+ActivityProfiler::ActivityProfiler()
+:mStartedFile( false )
+{
+    mEnabled = Configuration::getInstance()->getBool( "profile-activities", false );
+}
+
+/*!
+ * \brief Get the singleton instance of the ActivityProfiler.
+ * \return The ActivityProfiler.
+ */
+ActivityProfiler& ActivityProfiler::getInstance() {
+    static ActivityProfiler ACTIVITY_PROFILER;
+    return ACTIVITY_PROFILER;
+}
+
+/*!
+ * \brief Whether activity calls should be timed.
+ * \return True if profile-activities is set.
+ */
+bool ActivityProfiler::isEnabled() const {
+    return mEnabled;
+}
+
+/*!
+ * \brief Create the counts for each activity of the model.
+ * \details This must be called before the model is calculated so that the
+ *          counts may be updated concurrently without changing the map.
+ * \param aActivities The global ordering of activities.
+ */
+void ActivityProfiler::setActivities( const vector<IActivity*>& aActivities ) {
+    if( !mEnabled ) {
+        return;
+    }
+    for( const IActivity* activity : aActivities ) {
+        mCounts[ activity ];
+    }
+}
+
+/*!
+ * \brief Get the place to accumulate the calls to an activity.
+ * \param aActivity The activity to be timed.
+ * \return The counts of the activity or null if it is not in the global
+ *         ordering or the profiler is off.
+ */
+ActivityProfiler::Counts* ActivityProfiler::getCounts( const IActivity* aActivity ) {
+    map<const IActivity*, Counts>::iterator it = mCounts.find( aActivity );
+    return it != mCounts.end() ? &it->second : 0;
+}
+
+/*!
+ * \brief Record a call to an activity which started at the given time and
+ *        has just finished.
+ * \param aCounts The counts of the activity, if null nothing is recorded.
+ * \param aIsFullCalc Whether the whole model was being calculated.
+ * \param aStart The time the call started.
+ */
+void ActivityProfiler::record( Counts* aCounts, const bool aIsFullCalc, const Clock::time_point aStart ) {
+    if( !aCounts ) {
+        return;
+    }
+    const uint64_t nanoseconds = chrono::duration_cast<chrono::nanoseconds>( Clock::now() - aStart ).count();
+    if( aIsFullCalc ) {
+        aCounts->mFullCalls.fetch_add( 1, memory_order_relaxed );
+        aCounts->mFullNanoseconds.fetch_add( nanoseconds, memory_order_relaxed );
+    }
+    else {
+        aCounts->mPartialCalls.fetch_add( 1, memory_order_relaxed );
+        aCounts->mPartialNanoseconds.fetch_add( nanoseconds, memory_order_relaxed );
+    }
+}
+
+/*!
+ * \brief Report the activity times of a period and reset them for the next
+ *        one.
+ * \details The activities which took the most time in total are printed to the
+ *          main log and all of the activities which were called are appended
+ *          to the "activity-profile" file if it is set to be written.  The file
+ *          is truncated the first time it is written in a run.
+ * \param aYear The year of the period which just finished.
+ */
+void ActivityProfiler::reportPeriod( const int aYear ) {
+    if( !mEnabled ) {
+        return;
+    }
+    vector<PeriodCounts> periodCounts;
+    for( map<const IActivity*, Counts>::iterator it = mCounts.begin(); it != mCounts.end(); ++it ) {
+        PeriodCounts curr;
+        curr.mActivity = it->first;
+        curr.mFullCalls = it->second.mFullCalls.exchange( 0 );
+        curr.mFullSeconds = it->second.mFullNanoseconds.exchange( 0 ) * 1.0e-9;
+        curr.mPartialCalls = it->second.mPartialCalls.exchange( 0 );
+        curr.mPartialSeconds = it->second.mPartialNanoseconds.exchange( 0 ) * 1.0e-9;
+        if( curr.mFullCalls > 0 || curr.mPartialCalls > 0 ) {
+            periodCounts.push_back( curr );
+            RunCost& runCost = mRunCosts[ it->first ];
+            runCost.mCalls += curr.mFullCalls;
+            runCost.mSeconds += curr.mFullSeconds;
+        }
+    }
+    sort( periodCounts.begin(), periodCounts.end(), [] ( const PeriodCounts& aLHS, const PeriodCounts& aRHS ) {
+        return aLHS.mFullSeconds + aLHS.mPartialSeconds > aRHS.mFullSeconds + aRHS.mPartialSeconds;
+    } );
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Slowest activities in " << aYear << " (full calls, full seconds, partial calls, partial seconds):" << endl;
+    for( size_t i = 0; i < min( periodCounts.size(), NUM_ACTIVITIES_TO_LOG ); ++i ) {
+        const PeriodCounts& curr = periodCounts[ i ];
+        mainLog << curr.mActivity->getDescription() << ": " << curr.mFullCalls << ", " << curr.mFullSeconds
+                << ", " << curr.mPartialCalls << ", " << curr.mPartialSeconds << endl;
+    }
+
+    const Configuration* conf = Configuration::getInstance();
+    if( conf->shouldWriteFile( "activity-profile", false, false ) ) {
+        const string& profileFile = conf->getFile( "activity-profile" );
+        ofstream out( profileFile.c_str(), mStartedFile ? ios::app : ios::out );
+        if( !mStartedFile ) {
+            out << "year,activity,full-calls,full-seconds,partial-calls,partial-seconds" << '\n';
+            mStartedFile = true;
+        }
+        for( const PeriodCounts& curr : periodCounts ) {
+            out << aYear << ',' << curr.mActivity->getDescription() << ',' << curr.mFullCalls << ','
+                << curr.mFullSeconds << ',' << curr.mPartialCalls << ',' << curr.mPartialSeconds << '\n';
+        }
+        if( !out ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not write the activity profile to " << profileFile << "." << endl;
+        }
+    }
+}
+
+/*!
+ * \brief Get the full evaluation calls and time of each activity over the
+ *        periods reported so far.
+ * \return The run costs by activity.
+ */
+const map<const IActivity*, ActivityProfiler::RunCost>& ActivityProfiler::getRunCosts() const {
+    return mRunCosts;
+}
@@ -0,0 +1,213 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file allocation_tracker.cpp
+* \ingroup Objects
+* \brief AllocationTracker class source file.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_TRACK_ALLOCATIONS
+#include <cstdlib>
+#include <new>
+#include <atomic>
+#include <map>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
+#include "util/base/include/allocation_tracker.h"
+#include "containers/include/iactivity.h"
+
+using namespace std;
+
+namespace {
+    //! The allocations made by the current thread.
+    thread_local AllocationTracker::Counts tThreadCounts = { 0, 0 };
+
+    //! The allocations made by all threads.
+    atomic<uint64_t> sTotalAllocations( 0 );
+    atomic<uint64_t> sTotalBytes( 0 );
+
+    //! The number of activities to print in the report.
+    const size_t NUM_ACTIVITIES_TO_PRINT = 100;
+
+    typedef map<const IActivity*, AllocationTracker::Counts> ActivityCountsMap;
+
+    ActivityCountsMap& getActivityCounts() {
+        static ActivityCountsMap sActivityCounts;
+        return sActivityCounts;
+    }
+
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex& getActivityMutex() {
+        static tbb::spin_mutex sActivityMutex;
+        return sActivityMutex;
+    }
+#endif
+
+    void* trackedAllocate( const size_t aSize ) {
+        ++tThreadCounts.mAllocations;
+        tThreadCounts.mBytes += aSize;
+        sTotalAllocations.fetch_add( 1, memory_order_relaxed );
+        sTotalBytes.fetch_add( aSize, memory_order_relaxed );
+        return malloc( aSize == 0 ? 1 : aSize );
+    }
+}
+
+void* operator new( size_t aSize ) {
+    void* ptr = trackedAllocate( aSize );
+    if( !ptr ) {
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[]( size_t aSize ) {
+    void* ptr = trackedAllocate( aSize );
+    if( !ptr ) {
+        throw bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new( size_t aSize, const nothrow_t& ) noexcept {
+    return trackedAllocate( aSize );
+}
+
+void* operator new[]( size_t aSize, const nothrow_t& ) noexcept {
+    return trackedAllocate( aSize );
+}
+
+void operator delete( void* aPtr ) noexcept {
+    free( aPtr );
+}
+
+void operator delete[]( void* aPtr ) noexcept {
+    free( aPtr );
+}
+
+void operator delete( void* aPtr, size_t ) noexcept {
+    free( aPtr );
+}
+
+void operator delete[]( void* aPtr, size_t ) noexcept {
+    free( aPtr );
+}
+
+void operator delete( void* aPtr, const nothrow_t& ) noexcept {
+    free( aPtr );
+}
+
+void operator delete[]( void* aPtr, const nothrow_t& ) noexcept {
+    free( aPtr );
+}
+
+/*!
+ * \brief Get the allocations made so far by the calling thread.
+ * \return The allocations of the calling thread.
+ */
+AllocationTracker::Counts AllocationTracker::getThreadCounts() {
+    return tThreadCounts;
+}
+
+/*!
+ * \brief Get the allocations made so far by all threads.
+ * \return The allocations of the process.
+ */
+AllocationTracker::Counts AllocationTracker::getTotalCounts() {
+    Counts counts = { sTotalAllocations.load( memory_order_relaxed ),
+                      sTotalBytes.load( memory_order_relaxed ) };
+    return counts;
+}
+
+/*!
+ * \brief Add the allocations made by the calling thread since aStart to the
+ *        total for an activity.
+ * \param aActivity The activity which was calculated.
+ * \param aStart The thread counts from before the activity was calculated.
+ */
+void AllocationTracker::recordActivity( const IActivity* aActivity, const Counts& aStart ) {
+    // Take the difference before updating the map which may itself allocate.
+    const Counts end = tThreadCounts;
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( getActivityMutex() );
+#endif
+    // Value initialization zeros the counts of a new activity.
+    Counts& counts = getActivityCounts()[ aActivity ];
+    counts.mAllocations += end.mAllocations - aStart.mAllocations;
+    counts.mBytes += end.mBytes - aStart.mBytes;
+}
+
+/*!
+ * \brief Print the activities which made the most allocations along with the
+ *        totals for all activities.
+ * \details The activities must still exist as their descriptions are looked up.
+ * \param aOut The stream to print to.
+ */
+void AllocationTracker::printActivities( ostream& aOut ) {
+    vector<pair<AllocationTracker::Counts, const IActivity*> > activities;
+    AllocationTracker::Counts total = { 0, 0 };
+    for( auto activity : getActivityCounts() ) {
+        activities.push_back( make_pair( activity.second, activity.first ) );
+        total.mAllocations += activity.second.mAllocations;
+        total.mBytes += activity.second.mBytes;
+    }
+    sort( activities.begin(), activities.end(),
+          []( const pair<AllocationTracker::Counts, const IActivity*>& aLHS,
+              const pair<AllocationTracker::Counts, const IActivity*>& aRHS )
+          { return aLHS.first.mAllocations > aRHS.first.mAllocations; } );
+
+    aOut << "Allocations during calc by all activities: " << total.mAllocations
+         << " allocations, " << total.mBytes << " bytes." << endl;
+    for( size_t i = 0; i < activities.size() && i < NUM_ACTIVITIES_TO_PRINT; ++i ) {
+        aOut << activities[ i ].second->getDescription() << ": " << activities[ i ].first.mAllocations
+             << " allocations, " << activities[ i ].first.mBytes << " bytes." << endl;
+    }
+}
+
+/*!
+ * \brief Forget the recorded activities, which should be done before they
+ *        are destroyed.
+ */
+void AllocationTracker::clearActivities() {
+    getActivityCounts().clear();
+}
+
+#endif // GCAM_TRACK_ALLOCATIONS
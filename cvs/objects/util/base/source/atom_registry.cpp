@@ -89,6 +89,29 @@ namespace objects {
 		return ( iter != mAtoms->end() ) ? iter->second.get() : 0;
 	}
 
+	/*! \brief Get the unique Atom for a name, creating it if necessary.
+	* \details Interns the given name so that all objects which refer to the same
+	*          name share a single Atom which may be compared by pointer and
+	*          hashed using its precomputed hash code. The Atom is created and
+	*          registered if it does not already exist.
+	* \param aID The string identifier of the atom.
+	* \return The unique atom with the ID aID.
+	*/
+	const objects::Atom* AtomRegistry::getAtom( const string& aID ){
+#if GCAM_PARALLEL_ENABLED
+		tbb::spin_mutex::scoped_lock lock( mCreateLock );
+#endif
+		const Atom* atom = findAtom( aID );
+		// Could be the first request for this name. Note the atom registry will
+		// manage this memory.
+		if( !atom ){
+			atom = new Atom( aID );
+		}
+		/*! \post The ID of the atom is the same as the requested ID. */
+		assert( atom->getID() == aID );
+		return atom;
+	}
+
 	/*! \brief Register an atom with the Atom registry so that it can be fetched
 	*          throughout the model and automatically deallocated.
 	* \details This method registers an Atom with the registry. The atom list is
@@ -0,0 +1,119 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+ * \file cached_value_query.cpp
+ * \ingroup Objects
+ * \brief CachedValueQuery class source file.
+ */
+
+#include "util/base/include/definitions.h"
+
+#include "util/base/include/cached_value_query.h"
+#include "containers/include/scenario.h"
+#include "util/base/include/gcam_fusion.hpp"
+#include "util/base/include/gcam_data_containers.h"
+
+using namespace std;
+
+/*!
+ * \brief Constructor which parses the query.
+ * \param aQuery The query in the format accepted by parseFilterString.
+ */
+CachedValueQuery::CachedValueQuery( const string& aQuery ):
+mFilterSteps( parseFilterString( aQuery ) ),
+mIsResolved( false )
+{
+}
+
+//! Destructor
+CachedValueQuery::~CachedValueQuery() {
+    for( auto filterStep : mFilterSteps ) {
+        delete filterStep;
+    }
+}
+
+template<>
+void CachedValueQuery::processData<Value>( Value& aData ) {
+    mValues.push_back( &aData );
+}
+
+template<>
+void CachedValueQuery::processData<objects::PeriodVector<Value> >( objects::PeriodVector<Value>& aData ) {
+    for( auto& curr : aData ) {
+        mValues.push_back( &curr );
+    }
+}
+
+template<>
+void CachedValueQuery::processData<objects::YearVector<Value> >( objects::YearVector<Value>& aData ) {
+    for( auto& curr : aData ) {
+        mValues.push_back( &curr );
+    }
+}
+
+template<>
+void CachedValueQuery::processData<vector<Value> >( vector<Value>& aData ) {
+    for( auto& curr : aData ) {
+        mValues.push_back( &curr );
+    }
+}
+
+template<typename DataType>
+void CachedValueQuery::processData( DataType& aData ) {
+    // Only Value Data is collected.
+}
+
+/*!
+ * \brief Get the Values matched by the query, searching the model only if the
+ *        query has not been resolved since it was created or last invalidated.
+ * \param aScenario The scenario to search.
+ * \return The matched Values.
+ */
+const vector<Value*>& CachedValueQuery::getValues( Scenario* aScenario ) {
+    if( !mIsResolved ) {
+        mValues.clear();
+        GCAMFusion<CachedValueQuery> findValues( *this, mFilterSteps );
+        findValues.startFilter( aScenario );
+        mIsResolved = true;
+    }
+    return mValues;
+}
+
+/*!
+ * \brief Discard the matched Values so that the next call to getValues will
+ *        search the model again.
+ */
+void CachedValueQuery::invalidate() {
+    mIsResolved = false;
+    vector<Value*>().swap( mValues );
+}
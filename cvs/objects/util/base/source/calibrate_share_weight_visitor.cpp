@@ -65,6 +65,24 @@ CalibrateShareWeightVisitor::CalibrateShareWeightVisitor( const string& aRegionN
 {
 }
 
+/*!
+ * \brief Calibrate the share weights of a sector and its subsectors.
+ * \details This is equivalent to aSector->accept( this, aPeriod ) as this
+ *          visitor only acts on sectors and subsectors, however it does not
+ *          walk the technologies, inputs, outputs and emissions below the
+ *          subsectors.  It is called every time the sector prices are
+ *          calculated in a calibration period so that walk is significant.
+ * \param aSector The sector to calibrate.
+ * \param aPeriod The model period.
+ */
+void CalibrateShareWeightVisitor::calibrateSector( const Sector* aSector, const int aPeriod ) {
+    startVisitSector( aSector, aPeriod );
+    for( unsigned int i = 0; i < aSector->mSubsectors.size(); ++i ) {
+        startVisitSubsector( aSector->mSubsectors[ i ], aPeriod );
+    }
+    endVisitSector( aSector, aPeriod );
+}
+
 void CalibrateShareWeightVisitor::startVisitSector( const Sector* aSector, const int aPeriod ) {
     mCurrentSectorName = aSector->getName();
 }
@@ -0,0 +1,186 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file compressed_input_source.cpp
+* \ingroup Objects
+* \brief CompressedInputSource class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <xercesc/util/BinInputStream.hpp>
+#include <xercesc/util/XMLString.hpp>
+
+#if GCAM_GZIP_INPUT || GCAM_ZSTD_INPUT
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/device/file.hpp>
+#endif
+#if GCAM_GZIP_INPUT
+#include <boost/iostreams/filter/gzip.hpp>
+#endif
+#if GCAM_ZSTD_INPUT
+#include <boost/iostreams/filter/zstd.hpp>
+#endif
+
+#include "util/base/include/compressed_input_source.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+    //! The extension of gzip compressed files.
+    const string GZIP_EXTENSION = ".gz";
+
+    //! The extension of zstd compressed files.
+    const string ZSTD_EXTENSION = ".zst";
+
+    /*!
+     * \brief Check if a file name ends with the given extension.
+     * \param aFileName The file name.
+     * \param aExtension The extension including the leading dot.
+     * \return Whether the file name ends with the extension.
+     */
+    bool hasExtension( const string& aFileName, const string& aExtension ) {
+        return aFileName.size() > aExtension.size() &&
+            aFileName.compare( aFileName.size() - aExtension.size(), aExtension.size(), aExtension ) == 0;
+    }
+
+#if GCAM_GZIP_INPUT || GCAM_ZSTD_INPUT
+    /*!
+     * \brief A Xerces stream which reads from a decompressing Boost.Iostreams
+     *        filter chain.
+     */
+    class DecompressingInputStream : public BinInputStream {
+    public:
+        DecompressingInputStream( const string& aFileName ):
+        mBytesRead( 0 )
+        {
+#if GCAM_GZIP_INPUT
+            if( hasExtension( aFileName, GZIP_EXTENSION ) ) {
+                mStream.push( boost::iostreams::gzip_decompressor() );
+            }
+#endif
+#if GCAM_ZSTD_INPUT
+            if( hasExtension( aFileName, ZSTD_EXTENSION ) ) {
+                mStream.push( boost::iostreams::zstd_decompressor() );
+            }
+#endif
+            mStream.push( boost::iostreams::file_source( aFileName, ios_base::in | ios_base::binary ) );
+        }
+
+        virtual XMLFilePos curPos() const {
+            return mBytesRead;
+        }
+
+        virtual XMLSize_t readBytes( XMLByte* const aToFill, const XMLSize_t aMaxToRead ) {
+            mStream.read( reinterpret_cast<char*>( aToFill ), aMaxToRead );
+            const XMLSize_t numRead = static_cast<XMLSize_t>( mStream.gcount() );
+            mBytesRead += numRead;
+            return numRead;
+        }
+
+        virtual const XMLCh* getContentType() const {
+            return 0;
+        }
+    private:
+        //! The filter chain which decompresses the file.
+        boost::iostreams::filtering_istream mStream;
+
+        //! The number of uncompressed bytes given to the parser so far.
+        XMLFilePos mBytesRead;
+    };
+#endif
+}
+
+/*!
+ * \brief Constructor.
+ * \param aFileName The name of the compressed file to read.
+ */
+CompressedInputSource::CompressedInputSource( const string& aFileName ):
+mFileName( aFileName )
+{
+    // The system id is used by the parser to report errors and to resolve
+    // relative references such as the schema location.
+    XMLCh* systemId = XMLString::transcode( aFileName.c_str() );
+    setSystemId( systemId );
+    XMLString::release( &systemId );
+}
+
+//! Destructor.
+CompressedInputSource::~CompressedInputSource() {
+}
+
+/*!
+ * \brief Check if a file should be read through a CompressedInputSource.
+ * \details The check is only on the extension of the file name so that the
+ *          same configuration may refer to compressed or uncompressed files
+ *          regardless of how the model was built.
+ * \param aFileName The file name.
+ * \return Whether the file is gzip or zstd compressed.
+ */
+bool CompressedInputSource::isCompressed( const string& aFileName ) {
+    return hasExtension( aFileName, GZIP_EXTENSION ) || hasExtension( aFileName, ZSTD_EXTENSION );
+}
+
+/*!
+ * \brief Create the stream the parser will read the uncompressed document
+ *        from.
+ * \details The parser adopts the returned stream.  If the file does not exist
+ *          or the model was not built with support for its compression format
+ *          no stream is created in which case the parser will raise an error.
+ * \return A new decompressing stream or null if one could not be created.
+ */
+BinInputStream* CompressedInputSource::makeStream() const {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( !ifstream( mFileName.c_str(), ios_base::in | ios_base::binary ) ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Could not open compressed input file " << mFileName << "." << endl;
+        return 0;
+    }
+    
+    const bool isGzip = hasExtension( mFileName, GZIP_EXTENSION );
+    if( ( isGzip && !GCAM_GZIP_INPUT ) || ( !isGzip && !GCAM_ZSTD_INPUT ) ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Unable to read " << mFileName << " since support for "
+                << ( isGzip ? "gzip" : "zstd" ) << " compressed input was not enabled when the model was built." << endl;
+        return 0;
+    }
+
+#if GCAM_GZIP_INPUT || GCAM_ZSTD_INPUT
+    return new DecompressingInputStream( mFileName );
+#else
+    return 0;
+#endif
+}
@@ -0,0 +1,197 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file concurrent_xml_parser.cpp
+* \ingroup Objects
+* \brief ConcurrentXMLParser class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <vector>
+#include <memory>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/parsers/XercesDOMParser.hpp>
+#include <xercesc/sax/HandlerBase.hpp>
+#include <xercesc/dom/DOMDocument.hpp>
+#include <xercesc/dom/DOMException.hpp>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/task_group.h>
+#include <tbb/task_arena.h>
+#endif
+
+#include "util/base/include/concurrent_xml_parser.h"
+#include "util/base/include/compressed_input_source.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/iparsable.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+    /*!
+     * \brief A document being read along with the parser which owns it.
+     */
+    struct DocumentSlot {
+        DocumentSlot():mFailed( false ) {}
+
+        //! The parser which owns the document once it has been read.
+        unique_ptr<XercesDOMParser> mParser;
+
+        //! The error handler for mParser.
+        unique_ptr<HandlerBase> mErrorHandler;
+
+        //! Whether reading the document failed.
+        bool mFailed;
+
+        //! The reason reading the document failed.
+        string mError;
+
+#if GCAM_PARALLEL_ENABLED
+        //! The task reading the document.
+        tbb::task_group mTask;
+#endif
+    };
+
+    /*!
+     * \brief Read an XML file into a DOM with a parser of its own.
+     * \param aSlot The slot to hold the parser and any error.
+     * \param aXMLFile The file to read.
+     */
+    void readDocument( DocumentSlot& aSlot, const string& aXMLFile ) {
+        // Match the settings of XMLHelper::initParser.
+        aSlot.mParser.reset( new XercesDOMParser() );
+        aSlot.mParser->setValidationScheme( XercesDOMParser::Val_Always );
+        aSlot.mParser->setDoNamespaces( false );
+        aSlot.mParser->setDoSchema( true );
+        aSlot.mParser->setCreateCommentNodes( false );
+        aSlot.mParser->setIncludeIgnorableWhitespace( false );
+        aSlot.mErrorHandler.reset( new HandlerBase() );
+        aSlot.mParser->setErrorHandler( aSlot.mErrorHandler.get() );
+        try {
+            if( CompressedInputSource::isCompressed( aXMLFile ) ) {
+                CompressedInputSource source( aXMLFile );
+                aSlot.mParser->parse( source );
+            }
+            else {
+                aSlot.mParser->parse( aXMLFile.c_str() );
+            }
+        } catch ( const XMLException& toCatch ) {
+            aSlot.mFailed = true;
+            aSlot.mError = XMLHelper<string>::safeTranscode( toCatch.getMessage() );
+        } catch ( const DOMException& toCatch ) {
+            aSlot.mFailed = true;
+            aSlot.mError = XMLHelper<string>::safeTranscode( toCatch.msg );
+        } catch ( const SAXException& toCatch ){
+            aSlot.mFailed = true;
+            aSlot.mError = XMLHelper<string>::safeTranscode( toCatch.getMessage() );
+        } catch (...) {
+            aSlot.mFailed = true;
+        }
+    }
+}
+
+/*!
+ * \brief Parse each of the given files into the model in order, reading them
+ *        concurrently.
+ * \details Parsing stops at the first file which fails.
+ * \param aXMLFiles The files to parse in the order they must be parsed.
+ * \param aModelElement Element to call XMLParse on for each file.
+ * \return Whether parsing was successful.
+ */
+bool ConcurrentXMLParser::parseXMLFiles( const list<string>& aXMLFiles, IParsable* aModelElement ) {
+    const vector<string> files( aXMLFiles.begin(), aXMLFiles.end() );
+#if GCAM_PARALLEL_ENABLED
+    int window = Configuration::getInstance()->getInt( "parallel-xml-parse-window", 0 );
+    if( window <= 0 ) {
+        window = tbb::this_task_arena::max_concurrency();
+    }
+#else
+    const int window = 1;
+#endif
+
+    XMLPlatformUtils::Initialize();
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    vector<unique_ptr<DocumentSlot> > slots( files.size() );
+    size_t numStarted = 0;
+    bool success = true;
+    for( size_t fileIndex = 0; success && fileIndex < files.size(); ++fileIndex ) {
+        // Keep up to a window of files being read ahead.
+        for( ; numStarted < files.size() && numStarted < fileIndex + static_cast<size_t>( window ); ++numStarted ) {
+            slots[ numStarted ].reset( new DocumentSlot() );
+#if GCAM_PARALLEL_ENABLED
+            DocumentSlot* slot = slots[ numStarted ].get();
+            const string* file = &files[ numStarted ];
+            slot->mTask.run( [slot, file] { readDocument( *slot, *file ); } );
+#endif
+        }
+
+        DocumentSlot& slot = *slots[ fileIndex ];
+#if GCAM_PARALLEL_ENABLED
+        slot.mTask.wait();
+#else
+        readDocument( slot, files[ fileIndex ] );
+#endif
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Parsing " << files[ fileIndex ] << " scenario component." << endl;
+        if( slot.mFailed ) {
+            if( slot.mError.empty() ) {
+                cout << "ERROR:Unexpected XML Read Exception." << endl;
+            }
+            else {
+                cout << "ERROR: XML Read Exception message is:" << endl << slot.mError << endl;
+            }
+            success = false;
+        }
+        else {
+            success = aModelElement->XMLParse( slot.mParser->getDocument()->getDocumentElement() );
+        }
+        // Release the document now that it has been parsed.
+        slots[ fileIndex ].reset();
+    }
+
+#if GCAM_PARALLEL_ENABLED
+    // Files may still be being read if parsing stopped early.
+    for( size_t fileIndex = 0; fileIndex < numStarted; ++fileIndex ) {
+        if( slots[ fileIndex ] ) {
+            slots[ fileIndex ]->mTask.wait();
+        }
+    }
+#endif
+    slots.clear();
+    XMLPlatformUtils::Terminate();
+    return success;
+}
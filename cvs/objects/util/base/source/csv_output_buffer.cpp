@@ -0,0 +1,154 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file csv_output_buffer.cpp
+* \ingroup Objects
+* \brief CSVOutputBuffer class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <sstream>
+
+#include "util/base/include/csv_output_buffer.h"
+#include "util/base/include/xml_write_buffer.h"
+
+using namespace std;
+
+//! The buffer rows written by the calling thread are appended to.
+static thread_local CSVOutputBuffer* tCurrentBuffer = 0;
+
+/*!
+ * \brief Get a stream with the default formatting which is used as the
+ *        reference for how numbers are formatted.
+ * \return The stream.
+ */
+static ostream& getFormatStream() {
+    static thread_local ostringstream FORMAT_STREAM;
+    return FORMAT_STREAM;
+}
+
+/*!
+ * \brief Constructor which makes aBuffer current for the calling thread.
+ * \param aBuffer The buffer to make current.
+ */
+CSVOutputBuffer::Scope::Scope( CSVOutputBuffer& aBuffer ):
+mPrevious( tCurrentBuffer )
+{
+    tCurrentBuffer = &aBuffer;
+}
+
+//! Destructor which restores the previously current buffer.
+CSVOutputBuffer::Scope::~Scope() {
+    tCurrentBuffer = mPrevious;
+}
+
+//! Constructor for a buffer which only collects rows.
+CSVOutputBuffer::CSVOutputBuffer():
+mOut( 0 )
+{
+}
+
+/*!
+ * \brief Constructor for a buffer which writes to a stream.
+ * \param aOut The stream to write the rows to.
+ */
+CSVOutputBuffer::CSVOutputBuffer( ostream& aOut ):
+mOut( &aOut )
+{
+    mRows.reserve( FLUSH_SIZE );
+}
+
+//! Destructor which writes any remaining rows.
+CSVOutputBuffer::~CSVOutputBuffer() {
+    flush();
+}
+
+/*!
+ * \brief Get the buffer which is current for the calling thread.
+ * \return The current buffer, or null if none is.
+ */
+CSVOutputBuffer* CSVOutputBuffer::getCurrent() {
+    return tCurrentBuffer;
+}
+
+/*!
+ * \brief Append a single row of the names, unit and a value for each period.
+ * \details Each column, including the last value, is followed by a comma.
+ * \param aVar1 The first name column, typically the region.
+ * \param aVar2 The second name column.
+ * \param aVar3 The third name column.
+ * \param aVar4 The fourth name column.
+ * \param aVar5 The fifth name column, typically the variable.
+ * \param aUnit The units.
+ * \param aValues The values.
+ */
+void CSVOutputBuffer::appendRow( const string& aVar1, const string& aVar2, const string& aVar3,
+                                 const string& aVar4, const string& aVar5, const string& aUnit,
+                                 const vector<double>& aValues )
+{
+    mRows.append( aVar1 ).append( 1, ',' ).append( aVar2 ).append( 1, ',' )
+         .append( aVar3 ).append( 1, ',' ).append( aVar4 ).append( 1, ',' )
+         .append( aVar5 ).append( 1, ',' ).append( aUnit ).append( 1, ',' );
+    ostream& format = getFormatStream();
+    for( vector<double>::const_iterator it = aValues.begin(); it != aValues.end(); ++it ) {
+        XMLWriteBuffer::appendValue( mRows, *it, format );
+        mRows.append( 1, ',' );
+    }
+    mRows.append( 1, '\n' );
+    if( mOut && mRows.size() >= FLUSH_SIZE ) {
+        flush();
+    }
+}
+
+/*!
+ * \brief Move the rows collected by another buffer to the end of this one.
+ * \param aOther The buffer to take the rows from.
+ */
+void CSVOutputBuffer::append( CSVOutputBuffer& aOther ) {
+    mRows.append( aOther.mRows );
+    aOther.mRows.clear();
+    if( mOut && mRows.size() >= FLUSH_SIZE ) {
+        flush();
+    }
+}
+
+/*!
+ * \brief Write the rows to the stream, if there is one.
+ */
+void CSVOutputBuffer::flush() {
+    if( mOut && !mRows.empty() ) {
+        mOut->write( mRows.data(), mRows.size() );
+        mRows.clear();
+    }
+}
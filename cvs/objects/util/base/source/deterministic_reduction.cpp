@@ -0,0 +1,224 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file deterministic_reduction.cpp
+* \ingroup Objects
+* \brief DeterministicReduction class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <unordered_map>
+#include <algorithm>
+#include <atomic>
+
+#if GCAM_PARALLEL_ENABLED
+#include <tbb/spin_mutex.h>
+#endif
+
+#include "util/base/include/deterministic_reduction.h"
+
+using namespace std;
+
+bool DeterministicReduction::sEnabled = false;
+bool DeterministicReduction::sActive = false;
+
+namespace {
+    //! A single quantity added to a total.
+    struct Entry {
+        //! The position in the global ordering of the activity which added it.
+        int mRank;
+
+        //! The number of quantities the activity added before this one.
+        unsigned int mSequence;
+
+        //! The quantity.
+        double mValue;
+
+        //! The total after adding this quantity.
+        double mTotal;
+
+        bool operator<( const Entry& aOther ) const {
+            return mRank < aOther.mRank || ( mRank == aOther.mRank && mSequence < aOther.mSequence );
+        }
+    };
+
+    //! The quantities added to one total during the current calculation.
+    struct Record {
+        Record():mGeneration( 0 ), mBase( 0.0 ) {}
+
+        //! The calculation during which the entries were added.
+        unsigned int mGeneration;
+
+        //! The value of the total before any quantities were added.
+        double mBase;
+
+        //! The entries sorted by rank and then by sequence.
+        vector<Entry> mEntries;
+    };
+
+    //! The position of each activity in the global ordering.
+    unordered_map<const IActivity*, int> gRanks;
+
+    //! The number of the current calculation, so that records left from
+    //! earlier calculations may be recognized and restarted.
+    unsigned int gGeneration = 0;
+
+    //! The rank of the activity being calculated on this thread or -1 if none.
+    thread_local int tRank = -1;
+
+    //! The number of quantities the current activity on this thread has added.
+    thread_local unsigned int tSequence = 0;
+
+#if GCAM_PARALLEL_ENABLED
+    //! The records are split over a number of separately locked tables so that
+    //! threads adding to different totals rarely wait on each other.
+    const size_t NUM_SHARDS = 64;
+
+    struct Shard {
+        tbb::spin_mutex mMutex;
+        unordered_map<const double*, Record> mRecords;
+    };
+
+    Shard gShards[ NUM_SHARDS ];
+#endif
+}
+
+/*!
+ * \brief Turn the mode on or off.
+ * \param aEnabled Whether flow graph calculations should reduce
+ *        deterministically.
+ */
+void DeterministicReduction::setEnabled( const bool aEnabled ) {
+    sEnabled = aEnabled;
+}
+
+/*!
+ * \brief Set the ordering which ranks the activities.
+ * \param aActivities The global ordering of the activities.
+ */
+void DeterministicReduction::setActivities( const vector<IActivity*>& aActivities ) {
+    gRanks.clear();
+    for( size_t i = 0; i < aActivities.size(); ++i ) {
+        gRanks[ aActivities[ i ] ] = static_cast<int>( i );
+    }
+}
+
+/*!
+ * \brief Start a flow graph calculation.
+ * \details Quantities recorded by earlier calculations are discarded the next
+ *          time their total is added to.
+ */
+void DeterministicReduction::beginCalc() {
+#if GCAM_PARALLEL_ENABLED
+    if( sEnabled ) {
+        ++gGeneration;
+        sActive = true;
+    }
+#endif
+}
+
+/*!
+ * \brief Finish a flow graph calculation.
+ */
+void DeterministicReduction::endCalc() {
+    sActive = false;
+}
+
+/*!
+ * \brief Add a quantity to a total in the order of the activity adding it.
+ * \details The quantity is placed amongst those already added to the total
+ *          this calculation and the running sums from that point on are
+ *          redone.  As activities mostly finish in order the quantity usually
+ *          goes at the end and only one addition is needed.
+ * \param aTotal The total, which other threads may be reading with
+ *        Value::getConcurrent.
+ * \param aValue The quantity to add.
+ */
+void DeterministicReduction::add( double& aTotal, const double aValue ) {
+#if GCAM_PARALLEL_ENABLED
+    std::atomic<double>& total = reinterpret_cast<std::atomic<double>&>( aTotal );
+    Shard& shard = gShards[ ( reinterpret_cast<size_t>( &aTotal ) / sizeof( double ) ) % NUM_SHARDS ];
+    tbb::spin_mutex::scoped_lock lock( shard.mMutex );
+    Record& record = shard.mRecords[ &aTotal ];
+    if( record.mGeneration != gGeneration ) {
+        record.mGeneration = gGeneration;
+        record.mBase = total.load( std::memory_order_relaxed );
+        record.mEntries.clear();
+    }
+
+    Entry entry;
+    entry.mRank = tRank;
+    entry.mSequence = tSequence++;
+    entry.mValue = aValue;
+    vector<Entry>& entries = record.mEntries;
+    size_t pos = entries.size();
+    if( !entries.empty() && entry < entries.back() ) {
+        pos = upper_bound( entries.begin(), entries.end(), entry ) - entries.begin();
+    }
+    entries.insert( entries.begin() + pos, entry );
+    double sum = pos == 0 ? record.mBase : entries[ pos - 1 ].mTotal;
+    for( size_t i = pos; i < entries.size(); ++i ) {
+        sum += entries[ i ].mValue;
+        entries[ i ].mTotal = sum;
+    }
+    total.store( sum, std::memory_order_relaxed );
+#else
+    aTotal += aValue;
+#endif
+}
+
+/*!
+ * \brief Constructor which marks the start of the activity on this thread.
+ * \param aActivity The activity about to be calculated.
+ */
+DeterministicReduction::ScopedActivity::ScopedActivity( const IActivity* aActivity )
+:mIsSet( false )
+{
+    if( sActive ) {
+        unordered_map<const IActivity*, int>::const_iterator it = gRanks.find( aActivity );
+        tRank = it != gRanks.end() ? it->second : -1;
+        tSequence = 0;
+        mIsSet = true;
+    }
+}
+
+/*!
+ * \brief Destructor which marks the end of the activity on this thread.
+ */
+DeterministicReduction::ScopedActivity::~ScopedActivity() {
+    if( mIsSet ) {
+        tRank = -1;
+        tSequence = 0;
+    }
+}
@@ -0,0 +1,267 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file gcam_mpi.cpp
+* \ingroup Objects
+* \brief GcamMPI class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cassert>
+
+#if GCAM_USE_MPI
+#include <mpi.h>
+#endif
+
+#include "util/base/include/gcam_mpi.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+int GcamMPI::sRank = 0;
+int GcamMPI::sSize = 1;
+int GcamMPI::sDistributeJacobian = -1;
+int GcamMPI::sBatchWorker = -1;
+
+/*!
+ * \brief Constructor which initializes MPI.
+ * \details Only the main thread makes MPI calls, the TBB worker threads are
+ *          kept away from them.
+ * \param aArgc The argument count passed to main.
+ * \param aArgv The arguments passed to main.
+ */
+GcamMPI::Session::Session( int& aArgc, char**& aArgv ) {
+#if GCAM_USE_MPI
+    int provided;
+    MPI_Init_thread( &aArgc, &aArgv, MPI_THREAD_FUNNELED, &provided );
+    MPI_Comm_rank( MPI_COMM_WORLD, &sRank );
+    MPI_Comm_size( MPI_COMM_WORLD, &sSize );
+#endif
+}
+
+//! Destructor which finalizes MPI.
+GcamMPI::Session::~Session() {
+#if GCAM_USE_MPI
+    MPI_Finalize();
+#endif
+}
+
+/*!
+ * \brief Get the rank of this process.
+ * \return The rank, zero if MPI is not in use.
+ */
+int GcamMPI::getRank() {
+    return sRank;
+}
+
+/*!
+ * \brief Get the number of ranks.
+ * \return The number of ranks, one if MPI is not in use.
+ */
+int GcamMPI::getSize() {
+    return sSize;
+}
+
+/*!
+ * \brief Whether this is the root rank which is responsible for collecting
+ *        results.
+ * \return True for rank zero.
+ */
+bool GcamMPI::isRoot() {
+    return sRank == 0;
+}
+
+/*!
+ * \brief Get the name of a file to write which is unique to this rank.
+ * \details The rank is inserted before the extension on ranks other than zero
+ *          so that the root rank writes to the usual location.  In a batch
+ *          worker process the worker index is inserted as well.
+ * \param aFileName The file name to modify.
+ * \return The file name for this rank.
+ */
+string GcamMPI::getRankFileName( const string& aFileName ) {
+    if( isRoot() && sBatchWorker < 0 ) {
+        return aFileName;
+    }
+    string suffix = isRoot() ? "" : "_rank" + util::toString( sRank );
+    if( sBatchWorker >= 0 ) {
+        suffix += "_worker" + util::toString( sBatchWorker );
+    }
+    size_t dotPos = aFileName.find_last_of( '.' );
+    size_t slashPos = aFileName.find_last_of( "/\\" );
+    string modifiedFileName( aFileName );
+    if( dotPos == string::npos || ( slashPos != string::npos && dotPos < slashPos ) ) {
+        modifiedFileName.append( suffix );
+    }
+    else {
+        modifiedFileName.insert( dotPos, suffix );
+    }
+    return modifiedFileName;
+}
+
+/*!
+ * \brief Mark this process as a batch worker forked by BatchRunner so that the
+ *        files it writes are given a worker suffix by getRankFileName.
+ * \param aWorker The index of the worker.
+ */
+void GcamMPI::setBatchWorker( const int aWorker ) {
+    sBatchWorker = aWorker;
+}
+
+/*!
+ * \brief Whether the columns of finite difference Jacobians should be divided
+ *        among the ranks.
+ * \details This is controlled by the configuration value
+ *          "mpi-distribute-jacobian" and requires more than one rank.
+ * \return True if the Jacobian should be distributed.
+ */
+bool GcamMPI::shouldDistributeJacobian() {
+    if( sDistributeJacobian == -1 ) {
+        sDistributeJacobian = Configuration::getInstance()->getBool( "mpi-distribute-jacobian", false ) ? 1 : 0;
+    }
+    return sSize > 1 && sDistributeJacobian == 1;
+}
+
+/*!
+ * \brief Set whether Jacobians should be distributed.
+ * \details This must be turned off when the ranks are not all running the same
+ *          scenario, such as when distributing a batch.
+ * \param aDistribute Whether to distribute Jacobians.
+ */
+void GcamMPI::setDistributeJacobian( const bool aDistribute ) {
+    sDistributeJacobian = aDistribute ? 1 : 0;
+}
+
+/*!
+ * \brief Gather a vector of values from every rank onto every rank.
+ * \details The vectors may have a different length on each rank.  This must be
+ *          called by every rank.
+ * \param aLocal The values from this rank.
+ * \param aAll The values from each rank indexed by rank.
+ */
+void GcamMPI::allGather( const vector<double>& aLocal, vector<vector<double> >& aAll ) {
+    aAll.resize( sSize );
+#if GCAM_USE_MPI
+    int localSize = static_cast<int>( aLocal.size() );
+    vector<int> sizes( sSize );
+    MPI_Allgather( &localSize, 1, MPI_INT, &sizes[ 0 ], 1, MPI_INT, MPI_COMM_WORLD );
+    vector<int> offsets( sSize, 0 );
+    for( int rank = 1; rank < sSize; ++rank ) {
+        offsets[ rank ] = offsets[ rank - 1 ] + sizes[ rank - 1 ];
+    }
+    vector<double> allValues( offsets[ sSize - 1 ] + sizes[ sSize - 1 ] + 1 );
+    MPI_Allgatherv( const_cast<double*>( aLocal.empty() ? &allValues[ 0 ] : &aLocal[ 0 ] ), localSize, MPI_DOUBLE,
+                    &allValues[ 0 ], &sizes[ 0 ], &offsets[ 0 ], MPI_DOUBLE, MPI_COMM_WORLD );
+    for( int rank = 0; rank < sSize; ++rank ) {
+        aAll[ rank ].assign( allValues.begin() + offsets[ rank ],
+                             allValues.begin() + offsets[ rank ] + sizes[ rank ] );
+    }
+#else
+    aAll[ 0 ] = aLocal;
+#endif
+}
+
+/*!
+ * \brief Send a vector of integers to another rank.
+ * \param aDest The rank to send to.
+ * \param aTag The message tag.
+ * \param aValues The values to send.
+ */
+void GcamMPI::sendInts( const int aDest, const int aTag, const vector<int>& aValues ) {
+#if GCAM_USE_MPI
+    MPI_Send( const_cast<int*>( aValues.empty() ? 0 : &aValues[ 0 ] ), static_cast<int>( aValues.size() ),
+              MPI_INT, aDest, aTag, MPI_COMM_WORLD );
+#else
+    assert( false );
+#endif
+}
+
+/*!
+ * \brief Receive a vector of integers from another rank.
+ * \param aSource The rank to receive from or ANY_SOURCE.
+ * \param aTag The message tag.
+ * \param aValues The received values.
+ * \return The rank the message was received from.
+ */
+int GcamMPI::recvInts( const int aSource, const int aTag, vector<int>& aValues ) {
+#if GCAM_USE_MPI
+    MPI_Status status;
+    MPI_Probe( aSource == ANY_SOURCE ? MPI_ANY_SOURCE : aSource, aTag, MPI_COMM_WORLD, &status );
+    int count;
+    MPI_Get_count( &status, MPI_INT, &count );
+    aValues.resize( count );
+    MPI_Recv( count > 0 ? &aValues[ 0 ] : 0, count, MPI_INT, status.MPI_SOURCE, aTag,
+              MPI_COMM_WORLD, MPI_STATUS_IGNORE );
+    return status.MPI_SOURCE;
+#else
+    assert( false );
+    return 0;
+#endif
+}
+
+/*!
+ * \brief Send a string to another rank.
+ * \param aDest The rank to send to.
+ * \param aTag The message tag.
+ * \param aValue The string to send.
+ */
+void GcamMPI::sendString( const int aDest, const int aTag, const string& aValue ) {
+#if GCAM_USE_MPI
+    MPI_Send( const_cast<char*>( aValue.data() ), static_cast<int>( aValue.size() ), MPI_CHAR,
+              aDest, aTag, MPI_COMM_WORLD );
+#else
+    assert( false );
+#endif
+}
+
+/*!
+ * \brief Receive a string from another rank.
+ * \param aSource The rank to receive from.
+ * \param aTag The message tag.
+ * \param aValue The received string.
+ */
+void GcamMPI::recvString( const int aSource, const int aTag, string& aValue ) {
+#if GCAM_USE_MPI
+    MPI_Status status;
+    MPI_Probe( aSource, aTag, MPI_COMM_WORLD, &status );
+    int count;
+    MPI_Get_count( &status, MPI_CHAR, &count );
+    vector<char> buffer( count + 1 );
+    MPI_Recv( &buffer[ 0 ], count, MPI_CHAR, aSource, aTag, MPI_COMM_WORLD, MPI_STATUS_IGNORE );
+    aValue.assign( buffer.begin(), buffer.begin() + count );
+#else
+    assert( false );
+#endif
+}
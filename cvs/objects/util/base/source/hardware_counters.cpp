@@ -0,0 +1,151 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file hardware_counters.cpp
+* \ingroup Objects
+* \brief HardwareCounters class source file.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_USE_PERF_COUNTERS
+#include <cstring>
+#include <atomic>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+#include "util/base/include/hardware_counters.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    //! The number of counters in the group.
+    const int NUM_COUNTERS = 4;
+
+    //! The layout of a read of the group with the enabled and running times.
+    struct GroupRead {
+        uint64_t mNumCounters;
+        uint64_t mTimeEnabled;
+        uint64_t mTimeRunning;
+        uint64_t mValues[ NUM_COUNTERS ];
+    };
+
+    //! Whether the failure to open the counters has been logged.
+    atomic<bool> sLoggedFailure( false );
+
+    /*!
+     * \brief Open a single counter of the current thread.
+     * \param aType The perf event type.
+     * \param aConfig The event within the type.
+     * \param aGroupFd The group leader or -1 to open the leader.
+     * \return The file descriptor or -1 on failure.
+     */
+    int openCounter( const uint32_t aType, const uint64_t aConfig, const int aGroupFd ) {
+        perf_event_attr attr;
+        memset( &attr, 0, sizeof( attr ) );
+        attr.size = sizeof( attr );
+        attr.type = aType;
+        attr.config = aConfig;
+        attr.disabled = aGroupFd == -1 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>( syscall( __NR_perf_event_open, &attr, 0, -1, aGroupFd, 0 ) );
+    }
+
+    /*!
+     * \brief Open and start the group of counters of the current thread.
+     * \return The file descriptor of the group leader or -1 on failure.
+     */
+    int openGroup() {
+        const int leader = openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES, -1 );
+        if( leader != -1 &&
+            openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS, leader ) != -1 &&
+            openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES, leader ) != -1 &&
+            openCounter( PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES, leader ) != -1 )
+        {
+            ioctl( leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+            ioctl( leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+            return leader;
+        }
+        // The members of a partially opened group are left open, which is
+        // harmless as it only happens once per thread.
+        if( !sLoggedFailure.exchange( true ) ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not open the hardware performance counters, they will be reported as zero." << endl;
+        }
+        return -1;
+    }
+}
+
+/*!
+ * \brief Read the counters of the current thread, opening them if this is the
+ *        first read by the thread.
+ * \return The counts since the counters were opened, all zero if they could not
+ *         be opened.
+ */
+HardwareCounters::Counts HardwareCounters::read() {
+    thread_local int tGroupFd = openGroup();
+    Counts counts = { 0, 0, 0, 0 };
+    GroupRead groupRead;
+    if( tGroupFd == -1 || ::read( tGroupFd, &groupRead, sizeof( groupRead ) ) != sizeof( groupRead ) ) {
+        return counts;
+    }
+    // Scale up the counts if they were not counting the whole time.
+    const double scale = groupRead.mTimeRunning > 0 && groupRead.mTimeRunning < groupRead.mTimeEnabled ?
+        static_cast<double>( groupRead.mTimeEnabled ) / groupRead.mTimeRunning : 1.0;
+    counts.mCycles = static_cast<uint64_t>( groupRead.mValues[ 0 ] * scale );
+    counts.mInstructions = static_cast<uint64_t>( groupRead.mValues[ 1 ] * scale );
+    counts.mCacheMisses = static_cast<uint64_t>( groupRead.mValues[ 2 ] * scale );
+    counts.mBranchMisses = static_cast<uint64_t>( groupRead.mValues[ 3 ] * scale );
+    return counts;
+}
+
+/*!
+ * \brief Add the counts between two reads to a total.
+ * \param aTotal The total to add to.
+ * \param aStart The counts at the start.
+ * \param aEnd The counts at the end.
+ */
+void HardwareCounters::accumulate( Counts& aTotal, const Counts& aStart, const Counts& aEnd ) {
+    aTotal.mCycles += aEnd.mCycles - aStart.mCycles;
+    aTotal.mInstructions += aEnd.mInstructions - aStart.mInstructions;
+    aTotal.mCacheMisses += aEnd.mCacheMisses - aStart.mCacheMisses;
+    aTotal.mBranchMisses += aEnd.mBranchMisses - aStart.mBranchMisses;
+}
+
+#endif // GCAM_USE_PERF_COUNTERS
@@ -0,0 +1,285 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+ * \file hash_map_benchmark.cpp
+ * \ingroup Objects
+ * \brief HashMapBenchmark class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <chrono>
+
+#include "util/base/include/hash_map_benchmark.h"
+#include "util/base/include/hash_map.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+#include "marketplace/include/marketplace.h"
+#include "marketplace/include/market.h"
+#include "marketplace/include/market_locator.h"
+#include "util/base/include/atom.h"
+#include "util/base/include/atom_registry.h"
+#include "containers/include/info_keys.h"
+
+using namespace std;
+using namespace objects;
+
+namespace {
+    typedef chrono::steady_clock Clock;
+
+    /*!
+     * \brief Time lookups of a list of keys in a map.
+     * \param aMap The map to search, in which every key maps to one.
+     * \param aLookups The keys to look up.
+     * \param aRepeats The number of times to look up the list.
+     * \param aNumFound Incremented by the number of keys found so that the
+     *        lookups can not be optimized away.
+     * \return The average time per lookup in nanoseconds.
+     */
+    template<class MapType>
+    double timeLookups( const MapType& aMap, const vector<string>& aLookups, const int aRepeats, int& aNumFound ) {
+        const Clock::time_point start = Clock::now();
+        for( int repeat = 0; repeat < aRepeats; ++repeat ) {
+            for( const auto& key : aLookups ) {
+                typename MapType::const_iterator iter = aMap.find( key );
+                if( iter != aMap.end() ) {
+                    aNumFound += iter->second;
+                }
+            }
+        }
+        const chrono::duration<double, nano> elapsed = Clock::now() - start;
+        return elapsed.count() / ( static_cast<double>( aRepeats ) * aLookups.size() );
+    }
+
+    /*!
+     * \brief Time lookups in a HashMap of a list of keys with precomputed hash
+     *        codes as is possible for interned keys.
+     * \param aMap The map to search, in which every key maps to one.
+     * \param aLookups The keys to look up.
+     * \param aRepeats The number of times to look up the list.
+     * \param aNumFound Incremented by the number of keys found.
+     * \return The average time per lookup in nanoseconds.
+     */
+    double timeHashedLookups( const HashMap<const string, int>& aMap, const vector<string>& aLookups,
+                              const int aRepeats, int& aNumFound )
+    {
+        vector<size_t> hashCodes;
+        hashCodes.reserve( aLookups.size() );
+        for( const auto& key : aLookups ) {
+            hashCodes.push_back( aMap.getHashCode( key ) );
+        }
+        const Clock::time_point start = Clock::now();
+        for( int repeat = 0; repeat < aRepeats; ++repeat ) {
+            for( size_t i = 0; i < aLookups.size(); ++i ) {
+                HashMap<const string, int>::const_iterator iter = aMap.find( aLookups[ i ], hashCodes[ i ] );
+                if( iter != aMap.end() ) {
+                    aNumFound += iter->second;
+                }
+            }
+        }
+        const chrono::duration<double, nano> elapsed = Clock::now() - start;
+        return elapsed.count() / ( static_cast<double>( aRepeats ) * aLookups.size() );
+    }
+}
+
+//! Constructor
+HashMapBenchmark::HashMapBenchmark():
+mNumMarkets( 0 ),
+mRepeats( max( Configuration::getInstance()->getInt( "hash-map-benchmark-repeats", 100, false ), 1 ) )
+{
+}
+
+/*!
+ * \brief Gather the keys from the markets and run the benchmark.
+ * \param aMarketplace The marketplace to take the keys from.
+ * \param aPeriod The period of the markets.
+ */
+void HashMapBenchmark::run( const Marketplace* aMarketplace, const int aPeriod ) {
+    mMarketNames.clear();
+    mRegionGoods.clear();
+    mNumMarkets = 0;
+    aMarketplace->accept( this, aPeriod );
+
+    vector<string> infoNames;
+    for( int market = 0; market < mNumMarkets; ++market ) {
+        for( int key = 0; key < InfoKeys::eNumKeys; ++key ) {
+            infoNames.push_back( InfoKeys::getName( static_cast<InfoKeys::Key>( key ) ) );
+        }
+    }
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Running the hash map benchmark with the keys of " << mNumMarkets << " markets." << endl;
+    benchmarkKeys( "region and good names", mMarketNames );
+    benchmarkKeys( "info property names", infoNames );
+    benchmarkMarketLocator( *aMarketplace->mMarketLocator );
+}
+
+void HashMapBenchmark::startVisitMarket( const Market* aMarket, const int aPeriod ) {
+    mMarketNames.push_back( aMarket->getRegionName() );
+    mMarketNames.push_back( aMarket->getGoodName() );
+    // The good names were interned when the markets were added.
+    const Atom* good = AtomRegistry::getInstance()->findAtom( aMarket->getGoodName() );
+    for( const Atom* region : aMarket->getContainedRegions() ) {
+        mRegionGoods.push_back( make_pair( region, good ) );
+    }
+    ++mNumMarkets;
+}
+
+/*!
+ * \brief Time the maps for a single set of keys and print the results.
+ * \details Each distinct key is inserted into every map.  The lookups are then
+ *          timed in their original order, which includes repeated keys in
+ *          the proportion they occur in the model, and again with a suffix
+ *          added to each key so that none of them are found.
+ * \param aKeySetName The name of the set of keys to print.
+ * \param aLookups The keys to look up.
+ */
+void HashMapBenchmark::benchmarkKeys( const string& aKeySetName, const vector<string>& aLookups ) const {
+    if( aLookups.empty() ) {
+        return;
+    }
+    HashMap<const string, int> hashMap;
+    unordered_map<string, int> unorderedMap;
+    map<string, int> orderedMap;
+    for( const auto& key : aLookups ) {
+        hashMap.insert( make_pair( key, 1 ) );
+        unorderedMap.insert( make_pair( key, 1 ) );
+        orderedMap.insert( make_pair( key, 1 ) );
+    }
+    vector<string> missingLookups;
+    missingLookups.reserve( aLookups.size() );
+    for( const auto& key : aLookups ) {
+        missingLookups.push_back( key + "-missing" );
+    }
+
+    int numFound = 0;
+    const double hashMapTime = timeLookups( hashMap, aLookups, mRepeats, numFound );
+    const double hashedTime = timeHashedLookups( hashMap, aLookups, mRepeats, numFound );
+    const double unorderedTime = timeLookups( unorderedMap, aLookups, mRepeats, numFound );
+    const double orderedTime = timeLookups( orderedMap, aLookups, mRepeats, numFound );
+    const double hashMapMissTime = timeLookups( hashMap, missingLookups, mRepeats, numFound );
+    const double unorderedMissTime = timeLookups( unorderedMap, missingLookups, mRepeats, numFound );
+    const double orderedMissTime = timeLookups( orderedMap, missingLookups, mRepeats, numFound );
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Hash map benchmark of " << aKeySetName << ": " << hashMap.size() << " keys, "
+            << aLookups.size() << " lookups, nanoseconds per lookup found / missing:" << endl
+            << "\tHashMap: " << hashMapTime << " / " << hashMapMissTime
+            << "\tprecomputed hash: " << hashedTime << endl
+            << "\tstd::unordered_map: " << unorderedTime << " / " << unorderedMissTime << endl
+            << "\tstd::map: " << orderedTime << " / " << orderedMissTime << endl;
+
+    /*! \post Every key in the original lookups was found by every search. */
+    assert( numFound == 4 * mRepeats * static_cast<int>( aLookups.size() ) );
+}
+
+/*!
+ * \brief Time the market lookups of the MarketLocator and print the results.
+ * \details The markets are looked up in marketplace order, region and good
+ *          names as strings and interned, then with a suffix added to each good
+ *          name so that none of them are found.  A std::map from the pair of
+ *          names to the market number is timed with the same lookups.
+ * \param aMarketLocator The locator of the marketplace.
+ */
+void HashMapBenchmark::benchmarkMarketLocator( const MarketLocator& aMarketLocator ) const {
+    if( mRegionGoods.empty() ) {
+        return;
+    }
+    vector<pair<string, string> > nameLookups;
+    vector<pair<string, string> > missingLookups;
+    map<pair<string, string>, int> orderedMap;
+    nameLookups.reserve( mRegionGoods.size() );
+    missingLookups.reserve( mRegionGoods.size() );
+    for( const auto& regionGood : mRegionGoods ) {
+        nameLookups.push_back( make_pair( regionGood.first->getID(), regionGood.second->getID() ) );
+        missingLookups.push_back( make_pair( regionGood.first->getID(), regionGood.second->getID() + "-missing" ) );
+        orderedMap.insert( make_pair( nameLookups.back(), 1 ) );
+    }
+
+    int numFound = 0;
+    Clock::time_point start = Clock::now();
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        for( const auto& names : nameLookups ) {
+            numFound += aMarketLocator.getMarketNumber( names.first, names.second ) != MarketLocator::MARKET_NOT_FOUND;
+        }
+    }
+    chrono::duration<double, nano> elapsed = Clock::now() - start;
+    const double lookups = static_cast<double>( mRepeats ) * nameLookups.size();
+    const double nameTime = elapsed.count() / lookups;
+
+    start = Clock::now();
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        for( const auto& regionGood : mRegionGoods ) {
+            numFound += aMarketLocator.getMarketNumber( regionGood.first, regionGood.second ) != MarketLocator::MARKET_NOT_FOUND;
+        }
+    }
+    elapsed = Clock::now() - start;
+    const double atomTime = elapsed.count() / lookups;
+
+    start = Clock::now();
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        for( const auto& names : missingLookups ) {
+            numFound += aMarketLocator.getMarketNumber( names.first, names.second ) != MarketLocator::MARKET_NOT_FOUND;
+        }
+    }
+    elapsed = Clock::now() - start;
+    const double missTime = elapsed.count() / lookups;
+
+    start = Clock::now();
+    for( int repeat = 0; repeat < mRepeats; ++repeat ) {
+        for( const auto& names : nameLookups ) {
+            map<pair<string, string>, int>::const_iterator iter = orderedMap.find( names );
+            if( iter != orderedMap.end() ) {
+                numFound += iter->second;
+            }
+        }
+    }
+    elapsed = Clock::now() - start;
+    const double orderedTime = elapsed.count() / lookups;
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Market locator benchmark: " << nameLookups.size()
+            << " region and good lookups, nanoseconds per lookup:" << endl
+            << "\tMarketLocator by name: " << nameTime << " / missing: " << missTime
+            << "\tby interned name: " << atomTime << endl
+            << "\tstd::map of name pairs: " << orderedTime << endl;
+
+    /*! \post Every market was found by every search other than of missing goods. */
+    assert( numFound == 3 * mRepeats * static_cast<int>( nameLookups.size() ) );
+}
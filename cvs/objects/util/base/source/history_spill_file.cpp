@@ -0,0 +1,187 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*!
+ * \file history_spill_file.cpp
+ * \ingroup Objects
+ * \brief HistorySpillFile class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <boost/lexical_cast.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+#include "util/base/include/history_spill_file.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+const size_t HistorySpillFile::NOT_WRITTEN = static_cast<size_t>( -1 );
+
+//! Constructor.
+HistorySpillFile::HistorySpillFile():
+mOpenAttempted( false ),
+mSize( 0 ),
+mIsMapped( false )
+{
+    const Configuration* conf = Configuration::getInstance();
+    const string fileName = conf->getFile( "history-spill-file", "", false );
+    if( !fileName.empty() && conf->shouldWriteFile( "history-spill-file", false, false ) ) {
+#if defined(_WIN32)
+        const int pid = _getpid();
+#else
+        const int pid = getpid();
+#endif
+        mFileName = fileName + "." + boost::lexical_cast<string>( pid );
+    }
+}
+
+//! Destructor which removes the file.
+HistorySpillFile::~HistorySpillFile() {
+    if( mFile.is_open() ) {
+        mFile.close();
+        remove( mFileName.c_str() );
+    }
+}
+
+/*!
+ * \brief Get the file shared by all objects of the model.
+ * \return The single file instance.
+ */
+HistorySpillFile& HistorySpillFile::getInstance() {
+    static HistorySpillFile sInstance;
+    return sInstance;
+}
+
+/*!
+ * \brief Whether data should be spilled to the file.
+ * \return Whether the file was configured and, if it has been created, that
+ *         creating it succeeded.
+ */
+bool HistorySpillFile::isEnabled() const {
+    return !mFileName.empty() && ( !mOpenAttempted || mFile.is_open() );
+}
+
+/*!
+ * \brief Write data to the file.
+ * \param aData The data to write.
+ * \param aCount The number of values to write.
+ * \param aOffset The offset at which the same number of values were previously
+ *        written or NOT_WRITTEN, set to the offset written at on return.
+ * \return Whether the data were written, if not the caller must keep them.
+ */
+bool HistorySpillFile::write( const double* aData, const size_t aCount, size_t& aOffset ) {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    if( !mOpenAttempted ) {
+        open();
+    }
+    if( !mFile.is_open() ) {
+        return false;
+    }
+    const size_t offset = aOffset == NOT_WRITTEN ? mSize : aOffset;
+    mFile.seekp( offset );
+    mFile.write( reinterpret_cast<const char*>( aData ), aCount * sizeof( double ) );
+    if( !mFile ) {
+        mFile.clear();
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write to " << mFileName << ", data will be kept in memory." << endl;
+        return false;
+    }
+    if( aOffset == NOT_WRITTEN ) {
+        mSize += aCount * sizeof( double );
+        aOffset = offset;
+    }
+    return true;
+}
+
+/*!
+ * \brief Read back data previously written to the file.
+ * \details The file is flushed and only the range of the file holding the
+ *          data is mapped.  The model can not continue without the data so
+ *          failing to read it is fatal.
+ * \param aOffset The offset returned by write.
+ * \param aData The storage to read into.
+ * \param aCount The number of values to read.
+ */
+void HistorySpillFile::read( const size_t aOffset, double* aData, const size_t aCount ) {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mMutex );
+#endif
+    try {
+        mFile.flush();
+        if( !mIsMapped ) {
+            boost::interprocess::file_mapping( mFileName.c_str(), boost::interprocess::read_only ).swap( mMapping );
+            mIsMapped = true;
+        }
+        boost::interprocess::mapped_region region( mMapping, boost::interprocess::read_only,
+                                                   aOffset, aCount * sizeof( double ) );
+        memcpy( aData, region.get_address(), aCount * sizeof( double ) );
+    }
+    catch( const boost::interprocess::interprocess_exception& aException ) {
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::SEVERE );
+        mainLog << "Could not read back from " << mFileName << ": " << aException.what() << endl;
+        abort();
+    }
+}
+
+/*!
+ * \brief Create the file, must be called while holding the mutex.
+ * \return Whether the file was created.
+ */
+bool HistorySpillFile::open() {
+    mOpenAttempted = true;
+    mFile.open( mFileName.c_str(), ios::in | ios::out | ios::binary | ios::trunc );
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( !mFile.is_open() ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not create " << mFileName << ", solved period data will be kept in memory." << endl;
+        return false;
+    }
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Moving the data of solved periods to " << mFileName << "." << endl;
+    return true;
+}
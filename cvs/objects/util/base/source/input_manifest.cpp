@@ -0,0 +1,248 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file input_manifest.cpp
+* \ingroup Objects
+* \brief InputManifest class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <boost/cstdint.hpp>
+
+#include "util/base/include/input_manifest.h"
+#include "util/base/include/model_time.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    //! Identifies a manifest file.
+    const string MAGIC = "gcam-input-manifest";
+
+    //! The recorded state of a single input file.
+    struct FileEntry {
+        //! The path of the file as listed in the configuration.
+        string mPath;
+
+        //! The FNV-1a hash of the contents of the file.
+        boost::uint64_t mHash;
+
+        //! The earliest year attribute in the file, -1 if there are none.
+        int mFirstYear;
+    };
+
+    /*!
+     * \brief Hash the contents of a file and find its earliest year attribute.
+     * \param aPath The path of the file.
+     * \param aEntry The entry to fill in.
+     * \return Whether the file could be read.
+     */
+    bool scanFile( const string& aPath, FileEntry& aEntry ) {
+        ifstream in( aPath.c_str(), ios::in | ios::binary );
+        if( !in ) {
+            return false;
+        }
+        aEntry.mPath = aPath;
+        aEntry.mHash = 14695981039346656037ULL;
+        aEntry.mFirstYear = -1;
+        string line;
+        while( getline( in, line ) ) {
+            line += '\n';
+            for( string::const_iterator ch = line.begin(); ch != line.end(); ++ch ) {
+                aEntry.mHash = ( aEntry.mHash ^ static_cast<unsigned char>( *ch ) ) * 1099511628211ULL;
+            }
+            // Find any attribute whose name ends in year.
+            for( size_t pos = line.find( "year=" ); pos != string::npos; pos = line.find( "year=", pos + 1 ) ) {
+                const size_t valueStart = pos + 6;
+                if( valueStart < line.size() && ( line[ pos + 5 ] == '"' || line[ pos + 5 ] == '\'' ) ) {
+                    const int year = atoi( line.c_str() + valueStart );
+                    if( year > 0 && ( aEntry.mFirstYear == -1 || year < aEntry.mFirstYear ) ) {
+                        aEntry.mFirstYear = year;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /*!
+     * \brief Get the first period affected by a change to a file.
+     * \param aFirstYear The earliest year attribute in the file, -1 if none.
+     * \param aModeltime The model time.
+     * \return The first period which ends in or after the year.
+     */
+    int getFirstAffectedPeriod( const int aFirstYear, const Modeltime* aModeltime ) {
+        if( aFirstYear == -1 ) {
+            return 0;
+        }
+        int period = 0;
+        while( period < aModeltime->getmaxper() && aModeltime->getper_to_yr( period ) < aFirstYear ) {
+            ++period;
+        }
+        return period;
+    }
+}
+
+/*!
+ * \brief Determine how many leading periods of a previous run are unaffected
+ *        by the differences between its input files and the current ones.
+ * \param aManifestFile The manifest written by the previous run.
+ * \param aInputFiles The current input files in the order they are parsed.
+ * \param aModeltime The model time.
+ * \return The number of periods which do not need to be solved again, zero
+ *         if there is no usable manifest.
+ */
+int InputManifest::getNumUnchangedPeriods( const string& aManifestFile,
+                                           const list<string>& aInputFiles,
+                                           const Modeltime* aModeltime )
+{
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    ifstream in( aManifestFile.c_str() );
+    string magic;
+    unsigned int version = 0;
+    int numPeriods = 0;
+    in >> magic >> version >> numPeriods;
+    if( !in || magic != MAGIC || version != VERSION ) {
+        mainLog << "No usable input manifest " << aManifestFile << " was found, solving all periods." << endl;
+        return 0;
+    }
+
+    // Each entry holds the hash and first year followed by the path which
+    // takes the rest of the line.
+    vector<FileEntry> oldEntries;
+    FileEntry entry;
+    while( in >> hex >> entry.mHash >> dec >> entry.mFirstYear && getline( in >> ws, entry.mPath ) ) {
+        oldEntries.push_back( entry );
+    }
+
+    int unchanged = min( numPeriods, aModeltime->getmaxper() );
+    map<string, const FileEntry*> oldByPath;
+    for( vector<FileEntry>::const_iterator it = oldEntries.begin(); it != oldEntries.end(); ++it ) {
+        oldByPath[ it->mPath ] = &*it;
+    }
+    list<string> commonOrder;
+    for( list<string>::const_iterator it = aInputFiles.begin(); it != aInputFiles.end(); ++it ) {
+        if( !scanFile( *it, entry ) ) {
+            mainLog << "Could not read input file " << *it << ", solving all periods." << endl;
+            return 0;
+        }
+        map<string, const FileEntry*>::iterator oldEntry = oldByPath.find( *it );
+        int firstPeriod = unchanged;
+        if( oldEntry == oldByPath.end() ) {
+            firstPeriod = getFirstAffectedPeriod( entry.mFirstYear, aModeltime );
+        }
+        else {
+            if( oldEntry->second->mHash != entry.mHash ) {
+                firstPeriod = min( getFirstAffectedPeriod( entry.mFirstYear, aModeltime ),
+                                   getFirstAffectedPeriod( oldEntry->second->mFirstYear, aModeltime ) );
+            }
+            commonOrder.push_back( *it );
+            oldByPath.erase( oldEntry );
+        }
+        if( firstPeriod < unchanged ) {
+            mainLog << "Input file " << *it << " changed from period " << firstPeriod << "." << endl;
+            unchanged = firstPeriod;
+        }
+    }
+    for( map<string, const FileEntry*>::const_iterator it = oldByPath.begin(); it != oldByPath.end(); ++it ) {
+        const int firstPeriod = getFirstAffectedPeriod( it->second->mFirstYear, aModeltime );
+        if( firstPeriod < unchanged ) {
+            mainLog << "Input file " << it->first << " was removed from period " << firstPeriod << "." << endl;
+            unchanged = firstPeriod;
+        }
+    }
+
+    // Later files override earlier ones so reordering them may change any
+    // period.
+    list<string>::const_iterator common = commonOrder.begin();
+    for( vector<FileEntry>::const_iterator it = oldEntries.begin(); it != oldEntries.end() && unchanged > 0; ++it ) {
+        if( find( commonOrder.begin(), commonOrder.end(), it->mPath ) != commonOrder.end() ) {
+            if( *common != it->mPath ) {
+                mainLog << "The order of the input files changed." << endl;
+                unchanged = 0;
+            }
+            ++common;
+        }
+    }
+
+    mainLog << "Restoring " << unchanged << " periods which are unaffected by changes to the input files." << endl;
+    return unchanged;
+}
+
+/*!
+ * \brief Write the manifest of the input files of a run.
+ * \details The manifest is written to a temporary file which is then renamed
+ *          so that a later run never reads a partially written one.
+ * \param aManifestFile The manifest file name.
+ * \param aInputFiles The input files in the order they were parsed.
+ * \param aNumPeriods The number of periods the run calculated.
+ * \return Whether the manifest was written.
+ */
+bool InputManifest::write( const string& aManifestFile,
+                           const list<string>& aInputFiles,
+                           const int aNumPeriods )
+{
+    const string tempFileName = aManifestFile + ".tmp";
+    bool success = true;
+    {
+        ofstream out( tempFileName.c_str(), ios::out | ios::trunc );
+        out << MAGIC << ' ' << VERSION << ' ' << aNumPeriods << '\n';
+        FileEntry entry;
+        for( list<string>::const_iterator it = aInputFiles.begin(); success && it != aInputFiles.end(); ++it ) {
+            success = scanFile( *it, entry );
+            out << hex << entry.mHash << dec << ' ' << entry.mFirstYear << ' ' << entry.mPath << '\n';
+        }
+        out.close();
+        success = success && !out.fail();
+    }
+    if( success ) {
+        // Renaming onto an existing file fails on Windows.
+        remove( aManifestFile.c_str() );
+        success = rename( tempFileName.c_str(), aManifestFile.c_str() ) == 0;
+    }
+    if( !success ) {
+        remove( tempFileName.c_str() );
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not write the input manifest to " << aManifestFile << "." << endl;
+    }
+    return success;
+}
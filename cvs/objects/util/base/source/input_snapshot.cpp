@@ -0,0 +1,482 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file input_snapshot.cpp
+* \ingroup Objects
+* \brief InputSnapshot class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <map>
+#include <memory>
+#include <cstring>
+#include <sys/stat.h>
+#include <boost/cstdint.hpp>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/sax2/DefaultHandler.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+
+#include "util/base/include/input_snapshot.h"
+#include "util/base/include/xml_stream_parser.h"
+#include "util/base/include/compressed_input_source.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+namespace {
+    typedef basic_string<XMLCh> XMLString16;
+
+    //! Identifies a snapshot file.
+    const char MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'S', 'N', 'A', 'P' };
+
+    //! Written in host order to detect a snapshot from a different byte order.
+    const boost::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    //! Record tags.
+    enum Record { NAME = 'N', START = 'S', TEXT = 'T', END = 'E', DOCUMENT = 'D', DOCUMENT_END = 'Z' };
+
+    void writeUInt( ostream& aOut, const boost::uint32_t aValue ) {
+        aOut.write( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+    }
+
+    boost::uint32_t readUInt( istream& aIn ) {
+        boost::uint32_t value = 0;
+        aIn.read( reinterpret_cast<char*>( &value ), sizeof( value ) );
+        return value;
+    }
+
+    void writeInt64( ostream& aOut, const boost::int64_t aValue ) {
+        aOut.write( reinterpret_cast<const char*>( &aValue ), sizeof( aValue ) );
+    }
+
+    boost::int64_t readInt64( istream& aIn ) {
+        boost::int64_t value = 0;
+        aIn.read( reinterpret_cast<char*>( &value ), sizeof( value ) );
+        return value;
+    }
+
+    void writeString( ostream& aOut, const string& aValue ) {
+        writeUInt( aOut, aValue.size() );
+        aOut.write( aValue.data(), aValue.size() );
+    }
+
+    string readString( istream& aIn ) {
+        string value( readUInt( aIn ), '\0' );
+        aIn.read( &value[ 0 ], value.size() );
+        return value;
+    }
+
+    void writeXMLString( ostream& aOut, const XMLCh* aValue, const size_t aLength ) {
+        writeUInt( aOut, aLength );
+        aOut.write( reinterpret_cast<const char*>( aValue ), aLength * sizeof( XMLCh ) );
+    }
+
+    XMLString16 readXMLString( istream& aIn ) {
+        XMLString16 value( readUInt( aIn ), XMLCh( 0 ) );
+        aIn.read( reinterpret_cast<char*>( &value[ 0 ] ), value.size() * sizeof( XMLCh ) );
+        return value;
+    }
+
+    /*!
+     * \brief The size and modification time of an input file.
+     * \param aFile The file name.
+     * \param aSize Set to the file size.
+     * \param aModified Set to the modification time.
+     * \return Whether the file exists.
+     */
+    bool getFileStamp( const string& aFile, boost::int64_t& aSize, boost::int64_t& aModified ) {
+        struct stat fileStat;
+        if( stat( aFile.c_str(), &fileStat ) != 0 ) {
+            return false;
+        }
+        aSize = fileStat.st_size;
+        aModified = fileStat.st_mtime;
+        return true;
+    }
+
+    /*!
+     * \brief A SAX handler which writes the events of a document as snapshot
+     *        records.
+     */
+    class SnapshotEncoder : public DefaultHandler {
+    public:
+        explicit SnapshotEncoder( ostream& aOut ):mOut( aOut ) {}
+
+        virtual void startElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                                   const XMLCh* const aQName, const Attributes& aAttrs )
+        {
+            flushText();
+            const boost::uint32_t nameId = getNameId( aQName );
+            vector<boost::uint32_t> attrIds( aAttrs.getLength() );
+            for( XMLSize_t attrIndex = 0; attrIndex < aAttrs.getLength(); ++attrIndex ) {
+                attrIds[ attrIndex ] = getNameId( aAttrs.getQName( attrIndex ) );
+            }
+            mOut.put( START );
+            writeUInt( mOut, nameId );
+            writeUInt( mOut, attrIds.size() );
+            for( XMLSize_t attrIndex = 0; attrIndex < aAttrs.getLength(); ++attrIndex ) {
+                const XMLCh* value = aAttrs.getValue( attrIndex );
+                writeUInt( mOut, attrIds[ attrIndex ] );
+                writeXMLString( mOut, value, XMLString::stringLen( value ) );
+            }
+        }
+
+        virtual void endElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                                 const XMLCh* const aQName )
+        {
+            flushText();
+            mOut.put( END );
+        }
+
+        virtual void characters( const XMLCh* const aChars, const XMLSize_t aLength ) {
+            mText.append( aChars, aLength );
+        }
+    private:
+        //! The snapshot being written.
+        ostream& mOut;
+
+        //! The ids of the names written so far.
+        map<XMLString16, boost::uint32_t> mNameIds;
+
+        //! The text collected since the last element event.
+        XMLString16 mText;
+
+        /*!
+         * \brief Get the id of a name, writing it to the name table if it is
+         *        new.
+         * \param aName The element or attribute name.
+         * \return The id of the name.
+         */
+        boost::uint32_t getNameId( const XMLCh* aName ) {
+            const XMLString16 name( aName );
+            map<XMLString16, boost::uint32_t>::const_iterator it = mNameIds.find( name );
+            if( it != mNameIds.end() ) {
+                return it->second;
+            }
+            const boost::uint32_t id = mNameIds.size();
+            mNameIds[ name ] = id;
+            mOut.put( NAME );
+            writeXMLString( mOut, name.data(), name.size() );
+            return id;
+        }
+
+        //! Write the collected text unless it is only whitespace between
+        //! elements which XMLParse skips.
+        void flushText() {
+            for( size_t i = 0; i < mText.size(); ++i ) {
+                if( mText[ i ] != ' ' && mText[ i ] != '\t' && mText[ i ] != '\n' && mText[ i ] != '\r' ) {
+                    mOut.put( TEXT );
+                    writeXMLString( mOut, mText.data(), mText.size() );
+                    break;
+                }
+            }
+            mText.clear();
+        }
+    };
+
+    //! An input file held in the batch cache.
+    struct CachedInput {
+        //! The size of the file when it was encoded.
+        boost::int64_t mSize;
+
+        //! The modification time of the file when it was encoded.
+        boost::int64_t mModified;
+
+        //! The records of the document, including its own name table.
+        string mRecords;
+    };
+
+    //! The cached input files by file name.
+    map<string, CachedInput> gInputCache;
+}
+
+/*!
+ * \brief Parse the records of one document into the model.
+ * \details The DOCUMENT record and file name must already have been read.
+ * \param aIn The stream positioned at the first record of the document.
+ * \param aFileName The name of the document used in error messages.
+ * \param aModelElement Element to call XMLParse on.
+ * \param aNames The name table which is extended by any NAME records.
+ * \return Whether parsing was successful.
+ */
+bool InputSnapshot::replayDocument( istream& aIn, const string& aFileName, IParsable* aModelElement,
+                                    vector<basic_string<XMLCh> >& aNames )
+{
+    const int chunkDepth = Configuration::getInstance()->getInt( "xml-stream-chunk-depth", 2 );
+    XMLStreamParser parser( aFileName, aModelElement, chunkDepth );
+    try {
+        for( int tag = aIn.get(); tag != DOCUMENT_END; tag = aIn.get() ) {
+            if( tag == NAME ) {
+                aNames.push_back( readXMLString( aIn ) );
+            }
+            else if( tag == START ) {
+                const boost::uint32_t nameId = readUInt( aIn );
+                const boost::uint32_t numAttrs = readUInt( aIn );
+                DOMElement* element = parser.beginElement( aNames.at( nameId ).c_str() );
+                for( boost::uint32_t attr = 0; attr < numAttrs; ++attr ) {
+                    const boost::uint32_t attrId = readUInt( aIn );
+                    const XMLString16 value = readXMLString( aIn );
+                    parser.addAttribute( element, aNames.at( attrId ).c_str(), value.c_str() );
+                }
+            }
+            else if( tag == TEXT ) {
+                const XMLString16 text = readXMLString( aIn );
+                parser.characters( text.c_str(), text.size() );
+            }
+            else if( tag == END ) {
+                parser.endElement( 0, 0, 0 );
+            }
+            else {
+                // Truncated or corrupt records.
+                return false;
+            }
+        }
+    } catch( ... ) {
+        return false;
+    }
+    return parser.mSuccess;
+}
+
+/*!
+ * \brief Check whether a snapshot exists and was written from the given input
+ *        files as they are now.
+ * \param aSnapshotFile The snapshot file name.
+ * \param aInputFiles The input files in the order they are parsed.
+ * \return Whether the snapshot may be used in place of the input files.
+ */
+bool InputSnapshot::isCurrent( const string& aSnapshotFile, const list<string>& aInputFiles ) {
+    ifstream in( aSnapshotFile.c_str(), ios::in | ios::binary );
+    if( !in ) {
+        return false;
+    }
+    char magic[ sizeof( MAGIC ) ];
+    in.read( magic, sizeof( magic ) );
+    if( !in || memcmp( magic, MAGIC, sizeof( MAGIC ) ) != 0 || readUInt( in ) != BYTE_ORDER_MARK
+        || readUInt( in ) != VERSION || readUInt( in ) != aInputFiles.size() )
+    {
+        return false;
+    }
+    for( list<string>::const_iterator it = aInputFiles.begin(); it != aInputFiles.end(); ++it ) {
+        boost::int64_t size, modified;
+        if( readString( in ) != *it || !getFileStamp( *it, size, modified )
+            || readInt64( in ) != size || readInt64( in ) != modified )
+        {
+            return false;
+        }
+    }
+    return static_cast<bool>( in );
+}
+
+/*!
+ * \brief Write a snapshot of the given input files.
+ * \details The files are read again with a SAX parser so this should only be
+ *          called once they have been parsed successfully.
+ * \param aSnapshotFile The snapshot file name.
+ * \param aInputFiles The input files in the order they are parsed.
+ * \return Whether the snapshot was written.
+ */
+bool InputSnapshot::write( const string& aSnapshotFile, const list<string>& aInputFiles ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    ofstream out( aSnapshotFile.c_str(), ios::out | ios::binary | ios::trunc );
+    if( !out ) {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Could not open input snapshot " << aSnapshotFile << " for writing." << endl;
+        return false;
+    }
+    out.write( MAGIC, sizeof( MAGIC ) );
+    writeUInt( out, BYTE_ORDER_MARK );
+    writeUInt( out, VERSION );
+    writeUInt( out, aInputFiles.size() );
+    for( list<string>::const_iterator it = aInputFiles.begin(); it != aInputFiles.end(); ++it ) {
+        boost::int64_t size = -1, modified = -1;
+        getFileStamp( *it, size, modified );
+        writeString( out, *it );
+        writeInt64( out, size );
+        writeInt64( out, modified );
+    }
+
+    bool success = true;
+    XMLPlatformUtils::Initialize();
+    {
+        auto_ptr<SAX2XMLReader> reader( XMLReaderFactory::createXMLReader() );
+        reader->setFeature( XMLUni::fgSAX2CoreNameSpaces, false );
+        SnapshotEncoder encoder( out );
+        reader->setContentHandler( &encoder );
+        reader->setErrorHandler( &encoder );
+        for( list<string>::const_iterator it = aInputFiles.begin(); success && it != aInputFiles.end(); ++it ) {
+            out.put( DOCUMENT );
+            writeString( out, *it );
+            try {
+                reader->parse( it->c_str() );
+            } catch( ... ) {
+                success = false;
+            }
+            out.put( DOCUMENT_END );
+        }
+    }
+    XMLPlatformUtils::Terminate();
+
+    success = success && static_cast<bool>( out );
+    out.close();
+    if( !success ) {
+        // Do not leave a snapshot which looks current but is not complete.
+        remove( aSnapshotFile.c_str() );
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Failed to write input snapshot " << aSnapshotFile << "." << endl;
+        return false;
+    }
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Wrote input snapshot " << aSnapshotFile << "." << endl;
+    return true;
+}
+
+/*!
+ * \brief Parse all of the documents stored in a snapshot into the model.
+ * \details The caller should first check the snapshot with isCurrent.
+ * \param aSnapshotFile The snapshot file name.
+ * \param aModelElement Element to call XMLParse on, as with the input files.
+ * \return Whether parsing was successful.
+ */
+bool InputSnapshot::read( const string& aSnapshotFile, IParsable* aModelElement ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    ifstream in( aSnapshotFile.c_str(), ios::in | ios::binary );
+    // Skip the header which has already been checked.
+    in.seekg( sizeof( MAGIC ) + 2 * sizeof( boost::uint32_t ) );
+    const boost::uint32_t numFiles = readUInt( in );
+    for( boost::uint32_t i = 0; i < numFiles; ++i ) {
+        readString( in );
+        readInt64( in );
+        readInt64( in );
+    }
+
+    vector<XMLString16> names;
+    bool success = true;
+    XMLPlatformUtils::Initialize();
+    for( boost::uint32_t doc = 0; success && doc < numFiles; ++doc ) {
+        if( in.get() != DOCUMENT ) {
+            success = false;
+            break;
+        }
+        const string fileName = readString( in );
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Parsing " << fileName << " from the input snapshot." << endl;
+        success = replayDocument( in, fileName, aModelElement, names );
+    }
+    XMLPlatformUtils::Terminate();
+
+    if( !success ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Failed to read input snapshot " << aSnapshotFile << "." << endl;
+    }
+    return success;
+}
+
+/*!
+ * \brief Parse an input file into the model through the batch input cache.
+ * \details The first time a file is parsed it is read with a SAX parser into
+ *          the same records a snapshot holds, which are kept in memory and
+ *          then parsed into the model.  Later calls for the same file, for
+ *          instance by the next scenario of a batch, parse the kept records
+ *          without reading the XML again so long as the size and modification
+ *          time of the file are unchanged.  If the file can not be encoded
+ *          it is parsed normally so that the usual errors are reported.
+ * \param aInputFile The input file name.
+ * \param aModelElement Element to call XMLParse on.
+ * \return Whether parsing was successful.
+ */
+bool InputSnapshot::parseCached( const string& aInputFile, IParsable* aModelElement ) {
+    boost::int64_t size = -1, modified = -1;
+    if( !getFileStamp( aInputFile, size, modified ) ) {
+        return XMLStreamParser::parseInput( aInputFile, aModelElement );
+    }
+
+    map<string, CachedInput>::iterator cached = gInputCache.find( aInputFile );
+    if( cached == gInputCache.end() || cached->second.mSize != size || cached->second.mModified != modified ) {
+        ostringstream out( ios::out | ios::binary );
+        bool encoded = true;
+        XMLPlatformUtils::Initialize();
+        {
+            auto_ptr<SAX2XMLReader> reader( XMLReaderFactory::createXMLReader() );
+            reader->setFeature( XMLUni::fgSAX2CoreNameSpaces, false );
+            SnapshotEncoder encoder( out );
+            reader->setContentHandler( &encoder );
+            reader->setErrorHandler( &encoder );
+            try {
+                if( CompressedInputSource::isCompressed( aInputFile ) ) {
+                    CompressedInputSource source( aInputFile );
+                    reader->parse( source );
+                }
+                else {
+                    reader->parse( aInputFile.c_str() );
+                }
+            } catch( ... ) {
+                encoded = false;
+            }
+            out.put( DOCUMENT_END );
+        }
+        XMLPlatformUtils::Terminate();
+        if( !encoded ) {
+            gInputCache.erase( aInputFile );
+            return XMLStreamParser::parseInput( aInputFile, aModelElement );
+        }
+        CachedInput& entry = gInputCache[ aInputFile ];
+        entry.mSize = size;
+        entry.mModified = modified;
+        entry.mRecords = out.str();
+        cached = gInputCache.find( aInputFile );
+    }
+
+    istringstream in( cached->second.mRecords, ios::in | ios::binary );
+    vector<XMLString16> names;
+    XMLPlatformUtils::Initialize();
+    const bool success = replayDocument( in, aInputFile, aModelElement, names );
+    XMLPlatformUtils::Terminate();
+    return success;
+}
+
+/*!
+ * \brief Release all of the input files held in the batch input cache.
+ */
+void InputSnapshot::clearCache() {
+    gInputCache.clear();
+}
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <vector>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -348,28 +349,37 @@ void InterpolationRule::applyInterpolations( PeriodVector<Value>& aValuesToInter
     // increment one to interpolate or set the terminal period for the fixed function.
     if( mIsFixedFunction ){ ++toPer; } 
 
+    // find the periods which may be set and interpolate them all at once
+    vector<int> periods;
+    vector<double> years;
     for( int per = fromPer + 1; per < toPer; ++per ) {
         // determine if we can set a value in this period
         if( !aValuesToInterpolate[ per ].isInited() // no value as been set yet
             || ( mOverwritePolicy == INTERPOLATED && !aParsedValues[ per ].isInited() ) // can overwrite interpolated
             || mOverwritePolicy == ALWAYS // always overwrite
             ) {
-                // interpolate a new value for the current period
-                const double newValue = mInterpolationFunction->interpolate(
-                    &leftBracket, &rightBracket, modeltime->getper_to_yr( per ) );
-
-                // print a warning if the flag was set and we are indeed overwriting
-                // a value
-                if( aValuesToInterpolate[ per ].isInited() && mWarnWhenOverwritting ) {
-                    ILogger& mainLog = ILogger::getLogger( "main_log" );
-                    mainLog.setLevel( ILogger::WARNING );
-                    mainLog << "Overwriting value " << aValuesToInterpolate[ per ] << " with interpolated value "
-                        << newValue << " in year " << modeltime->getper_to_yr( per ) << endl;
-                    // TODO: be able to say where we are.
-                }
-                aValuesToInterpolate[ per ].set( newValue );
+                periods.push_back( per );
+                years.push_back( modeltime->getper_to_yr( per ) );
         }
     }
+    vector<double> newValues;
+    mInterpolationFunction->interpolateValues( &leftBracket, &rightBracket, years, newValues );
+
+    for( size_t i = 0; i < periods.size(); ++i ) {
+        const int per = periods[ i ];
+        const double newValue = newValues[ i ];
+
+        // print a warning if the flag was set and we are indeed overwriting
+        // a value
+        if( aValuesToInterpolate[ per ].isInited() && mWarnWhenOverwritting ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Overwriting value " << aValuesToInterpolate[ per ] << " with interpolated value "
+                << newValue << " in year " << modeltime->getper_to_yr( per ) << endl;
+            // TODO: be able to say where we are.
+        }
+        aValuesToInterpolate[ per ].set( newValue );
+    }
 }
 
 /*!
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <vector>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -118,3 +119,19 @@ double LinearInterpolationFunction::interpolate( const DataPoint* aLeftPoint, co
         * ( aRightPoint->getY() - aLeftPoint->getY() ) / ( aRightPoint->getX() - aLeftPoint->getX() )
         + aLeftPoint->getY();
 }
+
+void LinearInterpolationFunction::interpolateValues( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
+                                                     const vector<double>& aXValues, vector<double>& aYValues ) const
+{
+    // The line is the same for every x value so only find the differences
+    // once. The operations are otherwise ordered as in interpolate so that the
+    // results are identical.
+    const double leftX = aLeftPoint->getX();
+    const double leftY = aLeftPoint->getY();
+    const double yDiff = aRightPoint->getY() - leftY;
+    const double xDiff = aRightPoint->getX() - leftX;
+    aYValues.resize( aXValues.size() );
+    for( size_t i = 0; i < aXValues.size(); ++i ) {
+        aYValues[ i ] = ( aXValues[ i ] - leftX ) * yDiff / xDiff + leftY;
+    }
+}
@@ -39,6 +39,9 @@
  */
 
 #include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
 
 #include "util/base/include/manage_state_variables.hpp"
 #include "util/base/include/value.h"
@@ -46,10 +49,20 @@
 #include "util/logger/include/ilogger.h"
 #include "util/base/include/gcam_fusion.hpp"
 #include "util/base/include/gcam_data_containers.h"
+#include "util/base/include/configuration.h"
+#include "util/base/include/scope_profiler.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <fstream>
+#include <sstream>
+#include <atomic>
+#include <boost/shared_ptr.hpp>
 #include <tbb/concurrent_queue.h>
 #include <tbb/task_scheduler_init.h>
+#include <tbb/task_scheduler_observer.h>
+#if defined(__linux__)
+#include <sched.h>
+#endif
 #endif
 
 using namespace std;
@@ -61,6 +74,14 @@ extern Scenario* scenario;
 // ManageStateVariables it seems appropriate to initialize them to NULL here.
 Value::CentralValueType Value::sCentralValue( (double*)0 );
 double* Value::sBaseCentralValue( 0 );
+bool Value::sTrackDirty( false );
+double* Value::sUndoState( 0 );
+double* Value::sUndoLog( 0 );
+size_t Value::sUndoSize( 0 );
+#if GCAM_PARALLEL_ENABLED
+thread_local double* Value::sBoundState( 0 );
+bool Value::sBindState( true );
+#endif
 
 #if GCAM_PARALLEL_ENABLED
 #define NUM_STATES tbb::task_scheduler_init::default_num_threads()+1
@@ -68,13 +89,161 @@ double* Value::sBaseCentralValue( 0 );
 #define NUM_STATES 2
 #endif
 
+/*!
+ * \brief Bookkeeping stored in the Value::STATE_HEADER_SIZE bytes in front of
+ *        each state in ManageStateVariables::mStateData.
+ */
+struct StateHeader {
+    //! The offset in bytes from the start of the allocation to the state.
+    size_t mOffset;
+
+    //! The value ManageStateVariables::mStateGeneration had when the state was
+    //! last completely copied from the "base" state.
+    unsigned int mGeneration;
+};
+static_assert( sizeof( StateHeader ) <= Value::STATE_HEADER_SIZE, "StateHeader does not fit in front of a state" );
+
+/*!
+ * \brief Get the header of a state allocated with allocateState.
+ * \param aState The state.
+ * \return The header.
+ */
+static StateHeader* getStateHeader( double* aState ) {
+    return reinterpret_cast<StateHeader*>( reinterpret_cast<char*>( aState ) - Value::STATE_HEADER_SIZE );
+}
+
+/*!
+ * \brief Allocate a state to hold aNumValues along with the header and the
+ *        dirty flags, one for every block of values, in front of it.
+ * \param aNumValues The number of values in the state.
+ * \return The new state.
+ */
+static double* allocateState( const size_t aNumValues ) {
+    const size_t numBlocks = ( aNumValues >> Value::DIRTY_BLOCK_SHIFT ) + 1;
+    // Round the flags up to a multiple of the header size so that the state
+    // keeps the alignment of the allocation.
+    const size_t flagBytes = ( ( numBlocks + Value::STATE_HEADER_SIZE - 1 ) / Value::STATE_HEADER_SIZE )
+        * Value::STATE_HEADER_SIZE;
+    const size_t offset = flagBytes + Value::STATE_HEADER_SIZE;
+    char* buffer = new char[ offset + sizeof( double ) * aNumValues ];
+    memset( buffer, 0, offset );
+    double* state = reinterpret_cast<double*>( buffer + offset );
+    getStateHeader( state )->mOffset = offset;
+    return state;
+}
+
+/*!
+ * \brief Free a state allocated with allocateState.
+ * \param aState The state to free, may be null.
+ */
+static void freeState( double* aState ) {
+    if( aState ) {
+        delete[] ( reinterpret_cast<char*>( aState ) - getStateHeader( aState )->mOffset );
+    }
+}
+
 #if GCAM_PARALLEL_ENABLED
+//! The number of threads in the pool if they are pinned to NUMA nodes, zero if
+//! threads are not pinned.
+static int sPinnedConcurrency = 0;
+
+/*!
+ * \brief Read the CPUs which belong to each NUMA node on this system.
+ * \details This information is read from /sys/devices/system/node which is only
+ *          available on Linux.  Other systems are treated as having no NUMA
+ *          nodes.
+ * \return The CPUs of each node.
+ */
+static vector<vector<int> > readNumaNodeCPUs() {
+    vector<vector<int> > nodeCPUs;
+    for( int node = 0; ; ++node ) {
+        ostringstream fileName;
+        fileName << "/sys/devices/system/node/node" << node << "/cpulist";
+        ifstream cpuList( fileName.str().c_str() );
+        if( !cpuList.is_open() ) {
+            break;
+        }
+        // The list is formatted as comma separated ranges such as 0-7,16-23
+        vector<int> cpus;
+        string range;
+        while( getline( cpuList, range, ',' ) ) {
+            int first, last;
+            char dash;
+            istringstream rangeStream( range );
+            if( !( rangeStream >> first ) ) {
+                continue;
+            }
+            last = ( rangeStream >> dash >> last ) ? last : first;
+            for( int cpu = first; cpu <= last; ++cpu ) {
+                cpus.push_back( cpu );
+            }
+        }
+        nodeCPUs.push_back( cpus );
+    }
+    return nodeCPUs;
+}
+
+/*!
+ * \brief Get the CPUs which belong to each NUMA node on this system.
+ * \return The CPUs of each node.
+ */
+static const vector<vector<int> >& getNumaNodeCPUs() {
+    static const vector<vector<int> > NODE_CPUS = readNumaNodeCPUs();
+    return NODE_CPUS;
+}
+
+/*!
+ * \brief A task scheduler observer which pins each thread that joins
+ *        ManageStateVariables::mThreadPool to the CPUs of the NUMA node
+ *        assigned to its slot in the arena by getThreadNumaNode.
+ * \details Note that this includes the calling thread when it enters the
+ *          arena, which remains pinned after it leaves.
+ */
+class NumaThreadPinner : public tbb::task_scheduler_observer {
+public:
+    //! Constructor which starts observing aArena.
+    NumaThreadPinner( tbb::task_arena& aArena ):tbb::task_scheduler_observer( aArena ) {
+        observe( true );
+    }
+
+    //! Destructor
+    ~NumaThreadPinner() {
+        observe( false );
+    }
+
+    //! Pin the thread entering the arena.
+    virtual void on_scheduler_entry( bool aIsWorker ) {
+        const int node = ManageStateVariables::getThreadNumaNode( tbb::this_task_arena::current_thread_index() );
+        if( node < 0 ) {
+            return;
+        }
+#if defined(__linux__)
+        cpu_set_t cpus;
+        CPU_ZERO( &cpus );
+        const vector<int>& nodeCPUs = getNumaNodeCPUs()[ node ];
+        for( size_t i = 0; i < nodeCPUs.size(); ++i ) {
+            CPU_SET( nodeCPUs[ i ], &cpus );
+        }
+        sched_setaffinity( 0, sizeof( cpus ), &cpus );
+#endif
+    }
+};
+
 /*!
  * \brief A helper functor to assign a state slot in ManageStateVariables::mStateData
  *        to each worker thread in ManageStateVariables::mThreadPool.  This functor
  *        will get called the first time a new thread accesses the thread local
  *        storage Value::sCentralValue that provides access to mStateData by thread
  *        from with in the Value class.
+ * \details When threads are pinned to NUMA nodes each thread in the pool
+ *          prefers the slot following its index in the arena, so that it may
+ *          reuse the memory it first touched, and the last slot is left for a
+ *          thread from outside of the pool.  Arena indices are not fixed to an
+ *          operating system thread, a worker which leaves and rejoins the arena
+ *          may be given another index, so each slot is claimed atomically and a
+ *          thread whose preferred slot was already claimed takes any other free
+ *          slot.  Slots which have not yet been allocated are allocated by the
+ *          thread which gets them.
  */
 struct AssignThreadStateFun {
     //! A reference to ManageStateVariables::mStateData.
@@ -82,17 +251,33 @@ struct AssignThreadStateFun {
     
     //! The maximum number of states that have been allocated in mStateData.
     const int mMaxStates;
+
+    //! The number of values in each state.
+    const size_t mNumValues;
+
+    //! Whether threads in the pool get a fixed slot.
+    const bool mUseFixedSlots;
     
     //! A thread safe queue that will have as values each index into mStateData
     //! and as each new thread consumes it's next value implies that thread gets
     //! assigned that state slot.
     tbb::concurrent_queue<int> mThreadStateIndex;
+
+    //! Whether each fixed slot has been claimed by a thread, shared by every
+    //! copy of this functor.
+    boost::shared_ptr<std::vector<std::atomic<bool> > > mSlotClaimed;
     
     //! Constructor
-    AssignThreadStateFun( double** aArr, const int aMaxStates ):mArr( aArr ), mMaxStates( aMaxStates ) {
+    AssignThreadStateFun( double** aArr, const int aMaxStates, const size_t aNumValues ):
+    mArr( aArr ), mMaxStates( aMaxStates ), mNumValues( aNumValues ), mUseFixedSlots( sPinnedConcurrency > 0 ),
+    mSlotClaimed( new std::vector<std::atomic<bool> >( aMaxStates ) )
+    {
+        for( int i = 0; i < mMaxStates; ++i ) {
+            (*mSlotClaimed)[ i ].store( false );
+        }
         // initialize the state index slots starting from 1 as 0 is always the
         // "base" state.
-        for( int i = 1; i < mMaxStates; ++i ) {
+        for( int i = mUseFixedSlots ? mMaxStates - 1 : 1; i < mMaxStates; ++i ) {
             mThreadStateIndex.push( i );
         }
     }
@@ -106,20 +291,66 @@ struct AssignThreadStateFun {
      *         free from interference from any other thread.
      */
     double* operator()() {
-        int nextState;
-        bool gotState = mThreadStateIndex.try_pop( nextState );
+        int nextState = -1;
+        bool gotState = false;
+        if( mUseFixedSlots ) {
+            // Slots 1 to mMaxStates - 2 are fixed, try the preferred one first.
+            const int threadIndex = tbb::this_task_arena::current_thread_index();
+            if( threadIndex >= 0 && threadIndex < mMaxStates - 2 ) {
+                gotState = claimSlot( threadIndex + 1 );
+                nextState = threadIndex + 1;
+            }
+            for( int slot = 1; !gotState && slot < mMaxStates - 1; ++slot ) {
+                gotState = claimSlot( slot );
+                nextState = slot;
+            }
+        }
+        if( !gotState ) {
+            gotState = mThreadStateIndex.try_pop( nextState );
+        }
         if( !gotState ) {
             ILogger& mainLog = ILogger::getLogger( "main_log" );
             mainLog.setLevel( ILogger::SEVERE );
             mainLog << "Failed to get an unused state to assign to a worker thread." << endl;
             abort();
         }
-        
+
+        if( !mArr[ nextState ] ) {
+            // Touch the new state from this thread so that it is placed on the
+            // NUMA node this thread is pinned to.
+            mArr[ nextState ] = allocateState( mNumValues );
+            memset( mArr[ nextState ], 0, sizeof( double ) * mNumValues );
+        }
         return mArr[ nextState ];
     }
+
+    /*!
+     * \brief Claim a fixed slot for the calling thread.
+     * \param aSlot The slot to claim.
+     * \return Whether the slot was free and is now claimed by this thread.
+     */
+    bool claimSlot( const int aSlot ) {
+        bool expected = false;
+        return (*mSlotClaimed)[ aSlot ].compare_exchange_strong( expected, true );
+    }
 };
 #endif
 
+#if GCAM_PARALLEL_ENABLED
+/*!
+ * \brief Get the number of threads the thread pool should be created with.
+ * \details The parallel-threads configuration value limits the number of
+ *          threads, it may only reduce the threads from the number available
+ *          on the system since a "scratch" state is allocated for each of those.
+ * \return The concurrency to create the thread pool with.
+ */
+static int getThreadPoolConcurrency() {
+    const int threads = Configuration::getInstance()->getInt( "parallel-threads", 0, false );
+    return threads > 0 ? min( threads, tbb::task_scheduler_init::default_num_threads() )
+                       : static_cast<int>( tbb::task_arena::automatic );
+}
+#endif
+
 /*!
  * \brief Constructor which calls collectState() to begin the process to find all
  *        state data during the given model period and allocate memory to hold
@@ -128,16 +359,40 @@ struct AssignThreadStateFun {
  */
 ManageStateVariables::ManageStateVariables( const int aPeriod ):
 #if !GCAM_PARALLEL_ENABLED
-mStateData( new double*[ NUM_STATES ] ),
+mStateData( 0 ),
+mNumStates( NUM_STATES ),
 #else
-mThreadPool(),
-mStateData( new double*[ NUM_STATES ] ),
+mThreadPool( getThreadPoolConcurrency() ),
+mStateData( 0 ),
+mNumStates( NUM_STATES ),
+mThreadPinner( 0 ),
 #endif
+mUseDeltaCopy( Configuration::getInstance()->getBool( "partial-derivative-delta-copy", false ) ),
+mReportUnchanged( Configuration::getInstance()->getBool( "report-unchanged-state", false ) ),
+mUseUndoLog( Configuration::getInstance()->getBool( "solver-undo-log", true, false ) ),
+mUndoLog( 0 ),
+mStateGeneration( 1 ),
 mPeriodToCollect( aPeriod ),
 mYearToCollect( scenario->getModeltime()->getper_to_yr( aPeriod ) ),
 mCCStartYear( mYearToCollect - scenario->getModeltime()->gettimestep( aPeriod ) + 1 ),
 mNumCollected( 0 )
 {
+#if GCAM_PARALLEL_ENABLED
+    if( Configuration::getInstance()->getBool( "parallel-numa-pinning", false ) ) {
+        if( getNumaNodeCPUs().empty() ) {
+            ILogger& mainLog = ILogger::getLogger( "main_log" );
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not determine the NUMA nodes on this system, threads will not be pinned." << endl;
+        }
+        else {
+            // An extra state is required for threads from outside of the pool
+            // since the pool's threads each get a fixed state.
+            sPinnedConcurrency = tbb::task_scheduler_init::default_num_threads();
+            ++mNumStates;
+            mThreadPinner = new NumaThreadPinner( mThreadPool );
+        }
+    }
+#endif
     collectState();
 }
 
@@ -146,9 +401,18 @@ mNumCollected( 0 )
  *        "base" state back into the Value objects before we deallocate that memory.
  */
 ManageStateVariables::~ManageStateVariables() {
+    if( mReportUnchanged ) {
+        reportUnchangedState();
+    }
+    stopUndoLog();
     resetState();
-    for( size_t stateInd = 0; stateInd < NUM_STATES; ++stateInd ) {
-        delete[] mStateData[ stateInd ];
+    delete[] mUndoLog;
+#if GCAM_PARALLEL_ENABLED
+    delete mThreadPinner;
+    sPinnedConcurrency = 0;
+#endif
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        freeState( mStateData[ stateInd ] );
     }
     delete[] mStateData;
 #if !GCAM_PARALLEL_ENABLED
@@ -157,6 +421,7 @@ ManageStateVariables::~ManageStateVariables() {
     Value::sCentralValue.clear();
 #endif
     Value::sBaseCentralValue = 0;
+    Value::sTrackDirty = false;
 }
 
 /*!
@@ -181,15 +446,33 @@ void ManageStateVariables::collectState() {
     GCAMFusion<DoCollect, true, true, true> gatherState( doCollectProc, collectStateSteps );
     gatherState.startFilter( scenario );
     
-    // DoCollect has now gathered all active state into the mStateValues list to
+    // DoCollect has now gathered all active state into the mStateValues vector to
     // allow faster/easier processing for the remaining tasks at hand.
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::DEBUG );
     mainLog << "Number of active state values: " << mNumCollected << endl;
-    // Allocate space for each active state value for each state slot.
-    for( size_t stateInd = 0; stateInd < NUM_STATES; ++stateInd ) {
-        mStateData[ stateInd ] = new double[ mNumCollected ];
+
+    // Place the market state at the front of the state data.
+    mMarketStateValues.insert( mMarketStateValues.end(), mStateValues.begin(), mStateValues.end() );
+    mStateValues.swap( mMarketStateValues );
+    vector<Value*>().swap( mMarketStateValues );
+    // Allocate space for each active state value for each state slot.  When
+    // threads are pinned to NUMA nodes the "scratch" states are left for the
+    // thread which will use them to allocate.
+    mStateData = new double*[ mNumStates ];
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+#if GCAM_PARALLEL_ENABLED
+        if( stateInd > 0 && mThreadPinner ) {
+            mStateData[ stateInd ] = 0;
+            continue;
+        }
+#endif
+        mStateData[ stateInd ] = allocateState( mNumCollected );
     }
+    Value::sTrackDirty = mUseDeltaCopy;
+#if GCAM_PARALLEL_ENABLED
+    Value::ScopedStateBinding::setEnabled( Configuration::getInstance()->getBool( "bind-activity-state", true, false ) );
+#endif
     
     // We can now initialize the static Value references into mStateData for fast
     // access from within each Value object.
@@ -203,8 +486,14 @@ void ManageStateVariables::collectState() {
         currValue->mIsStateCopy = true;
         currValue->mCentralValueIndex = mNumCollected;
         currValue->sBaseCentralValue[ mNumCollected ] = currValue->mValue;
+        if( mReportUnchanged ) {
+            mStateKinds.push_back( doCollectProc.mValueKinds[ currValue ] );
+        }
         ++mNumCollected;
     }
+    if( mReportUnchanged ) {
+        mInitialState.assign( mStateData[ 0 ], mStateData[ 0 ] + mNumCollected );
+    }
     
     // clean up GCAMFusion related memory
     for( auto filterStep : collectStateSteps ) {
@@ -233,6 +522,31 @@ void ManageStateVariables::resetState() {
     }
 }
 
+/*!
+ * \brief Log the number of collected values of each kind which are the same in
+ *        the "base" state as when they were collected.
+ * \details Values which are never changed by World.calc do not need to be
+ *          managed as state.  Note a value which was changed and then set back
+ *          to the value it was collected with is also counted.
+ */
+void ManageStateVariables::reportUnchangedState() const {
+    map<string, pair<size_t, size_t> > counts;
+    for( size_t i = 0; i < mNumCollected; ++i ) {
+        pair<size_t, size_t>& currCount = counts[ mStateKinds[ i ] ];
+        ++currCount.second;
+        if( memcmp( &mStateData[ 0 ][ i ], &mInitialState[ i ], sizeof( double ) ) == 0 ) {
+            ++currCount.first;
+        }
+    }
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Unchanged state values in period " << mPeriodToCollect << ":" << endl;
+    for( auto currCount : counts ) {
+        mainLog << currCount.first << ": " << currCount.second.first << " of "
+                << currCount.second.second << endl;
+    }
+}
+
 /*!
  * \brief Copies the "base" state over the "scratch" space.
  * \details This method is typically called before starting a partial derivative
@@ -241,10 +555,122 @@ void ManageStateVariables::resetState() {
  *          as the one assigned to the calling thread via the thread local Value::sCentralValue.
  */
 void ManageStateVariables::copyState() {
+    GCAM_PROFILE_SCOPE( "copy state" );
 #if !GCAM_PARALLEL_ENABLED
-    memcpy( mStateData[1], mStateData[0], (sizeof( double)) * mNumCollected );
+    double* scratch = mStateData[1];
+#else
+    double* scratch = Value::sCentralValue.local();
+#endif
+    StateHeader* header = getStateHeader( scratch );
+    if( !mUseDeltaCopy || header->mGeneration != mStateGeneration ) {
+        memcpy( scratch, mStateData[0], (sizeof( double)) * mNumCollected );
+        if( mUseDeltaCopy ) {
+            // Everything now matches the "base" state so start tracking changes
+            // from here.
+            const size_t numBlocks = ( mNumCollected >> Value::DIRTY_BLOCK_SHIFT ) + 1;
+            memset( reinterpret_cast<unsigned char*>( header ) - numBlocks, 0, numBlocks );
+            header->mGeneration = mStateGeneration;
+        }
+        return;
+    }
+
+    // The "base" state has not changed since the last complete copy into this
+    // scratch state so only the blocks modified since then need to be restored.
+    unsigned char* dirtyFlags = reinterpret_cast<unsigned char*>( header ) - 1;
+    const size_t blockSize = size_t( 1 ) << Value::DIRTY_BLOCK_SHIFT;
+    for( size_t block = 0, start = 0; start < mNumCollected; ++block, start += blockSize ) {
+        if( *( dirtyFlags - block ) ) {
+            *( dirtyFlags - block ) = 0;
+            memcpy( scratch + start, mStateData[0] + start,
+                    (sizeof( double)) * min( blockSize, mNumCollected - start ) );
+        }
+    }
+}
+
+/*!
+ * \brief Start keeping an undo log of the "base" state.
+ * \details From now on each block of the "base" state is copied to the log
+ *          before it is first modified so that rollbackUndoLog can restore
+ *          the state as it is now.  An undo log which was already being kept
+ *          is restarted from the current state.  This does nothing if the
+ *          "solver-undo-log" configuration value is switched off.
+ */
+void ManageStateVariables::startUndoLog() {
+    if( !mUseUndoLog ) {
+        return;
+    }
+    if( !mUndoLog ) {
+        mUndoLog = new double[ max( mNumCollected, size_t( 1 ) ) ];
+    }
+    // The flags of the "base" state are otherwise unused and now record which
+    // blocks have been saved.
+    const size_t numBlocks = ( mNumCollected >> Value::DIRTY_BLOCK_SHIFT ) + 1;
+    memset( reinterpret_cast<unsigned char*>( getStateHeader( mStateData[ 0 ] ) ) - numBlocks, 0, numBlocks );
+    Value::sUndoLog = mUndoLog;
+    Value::sUndoSize = mNumCollected;
+    Value::sUndoState = mStateData[ 0 ];
+    Value::sTrackDirty = true;
+}
+
+/*!
+ * \brief Restore the "base" state to what it was when the undo log was started
+ *        and stop keeping the log.
+ * \details Only the blocks which were modified since are copied back.
+ * \return Whether the state was restored, false if no undo log was being kept
+ *         in which case the model is left as it is.
+ */
+bool ManageStateVariables::rollbackUndoLog() {
+    if( !Value::sUndoState ) {
+        return false;
+    }
+    GCAM_PROFILE_SCOPE( "rollback state" );
+    unsigned char* savedFlags = reinterpret_cast<unsigned char*>( getStateHeader( mStateData[ 0 ] ) ) - 1;
+    const size_t blockSize = size_t( 1 ) << Value::DIRTY_BLOCK_SHIFT;
+    for( size_t block = 0, start = 0; start < mNumCollected; ++block, start += blockSize ) {
+        if( *( savedFlags - block ) ) {
+            memcpy( mStateData[ 0 ] + start, mUndoLog + start,
+                    (sizeof( double)) * min( blockSize, mNumCollected - start ) );
+        }
+    }
+    stopUndoLog();
+    return true;
+}
+
+/*!
+ * \brief Stop keeping an undo log, if one is being kept, leaving the "base"
+ *        state as it is.
+ */
+void ManageStateVariables::stopUndoLog() {
+    Value::sUndoState = 0;
+    Value::sTrackDirty = mUseDeltaCopy;
+}
+
+/*!
+ * \brief Copy a block of the state an undo log is being kept for to the log
+ *        before it is first modified.
+ * \details When GCAM_PARALLEL_ENABLED several threads may modify the same block
+ *          at once.  The first to claim the flag copies the block while any
+ *          others wait for it to finish.
+ * \param aFlag The flag of the block which is set once it has been saved.
+ * \param aIndex The index of the value about to be modified.
+ */
+void Value::saveUndoBlock( unsigned char* aFlag, const unsigned int aIndex ) {
+    const size_t blockSize = size_t( 1 ) << DIRTY_BLOCK_SHIFT;
+    const size_t start = ( size_t( aIndex ) >> DIRTY_BLOCK_SHIFT ) << DIRTY_BLOCK_SHIFT;
+#if GCAM_PARALLEL_ENABLED
+    // The flag is 2 while the block is being copied.
+    std::atomic<unsigned char>* flag = reinterpret_cast<std::atomic<unsigned char>*>( aFlag );
+    unsigned char expected = 0;
+    if( !flag->compare_exchange_strong( expected, 2, std::memory_order_acq_rel ) ) {
+        while( flag->load( std::memory_order_acquire ) != 1 ) {
+        }
+        return;
+    }
+    memcpy( sUndoLog + start, sUndoState + start, sizeof( double ) * min( blockSize, sUndoSize - start ) );
+    flag->store( 1, std::memory_order_release );
 #else
-    memcpy( Value::sCentralValue.local(), mStateData[0], (sizeof( double)) * mNumCollected );
+    memcpy( sUndoLog + start, sUndoState + start, sizeof( double ) * min( blockSize, sUndoSize - start ) );
+    *aFlag = 1;
 #endif
 }
 
@@ -256,6 +682,11 @@ void ManageStateVariables::copyState() {
  *                        derivative or not as set from the solution algorithm.
  */
 void ManageStateVariables::setPartialDeriv( const bool aIsPartialDeriv ) {
+    if( aIsPartialDeriv ) {
+        // The "base" state may have changed since the last partial derivatives
+        // which means the scratch states must be completely copied again.
+        ++mStateGeneration;
+    }
 #if !GCAM_PARALLEL_ENABLED
     Value::sCentralValue = mStateData[ aIsPartialDeriv ? 1 : 0 ];
 #else
@@ -266,9 +697,94 @@ void ManageStateVariables::setPartialDeriv( const bool aIsPartialDeriv ) {
     else {
         // Use the AssignThreadStateFun helper functor to uniquely assign a state
         // slot to each worker thread.
-        Value::sCentralValue = Value::CentralValueType( AssignThreadStateFun( mStateData, NUM_STATES ) );
+        Value::sCentralValue = Value::CentralValueType( AssignThreadStateFun( mStateData, mNumStates, mNumCollected ) );
+    }
+#endif
+}
+
+/*!
+ * \brief Get the NUMA node the thread with the given index in mThreadPool is
+ *        pinned to.
+ * \details The threads are assigned to nodes in order of their index so that
+ *          each node is filled before moving on to the next.
+ * \param aThreadIndex The index of the thread in the task arena.
+ * \return The NUMA node, or -1 if threads are not being pinned.
+ */
+int ManageStateVariables::getThreadNumaNode( const int aThreadIndex ) {
+#if GCAM_PARALLEL_ENABLED
+    if( sPinnedConcurrency > 0 && aThreadIndex >= 0 ) {
+        const int numNodes = static_cast<int>( getNumaNodeCPUs().size() );
+        return min( aThreadIndex * numNodes / sPinnedConcurrency, numNodes - 1 );
     }
 #endif
+    return -1;
+}
+
+/*!
+ * \brief Write the "base" state in binary so that it may later be restored
+ *        with readState.
+ * \details The values are written in the order they were collected which
+ *          only depends on the structure of the model so that the state is
+ *          only valid for the same inputs and period it was written for.
+ * \param aOut The binary stream to write to.
+ */
+void ManageStateVariables::writeState( ostream& aOut ) const {
+    const uint64_t numValues = mNumCollected;
+    aOut.write( reinterpret_cast<const char*>( &numValues ), sizeof( numValues ) );
+    aOut.write( reinterpret_cast<const char*>( mStateData[ 0 ] ), sizeof( double ) * mNumCollected );
+}
+
+/*!
+ * \brief Read a state written by writeState into the "base" state.
+ * \details The "base" state is left unchanged if the number of values does
+ *          not match the number collected for this period.
+ * \param aIn The binary stream to read from.
+ * \return Whether the state was read.
+ */
+bool ManageStateVariables::readState( istream& aIn ) {
+    uint64_t numValues = 0;
+    aIn.read( reinterpret_cast<char*>( &numValues ), sizeof( numValues ) );
+    if( !aIn || numValues != mNumCollected ) {
+        return false;
+    }
+    vector<double> values( mNumCollected );
+    aIn.read( reinterpret_cast<char*>( values.data() ), sizeof( double ) * mNumCollected );
+    if( !aIn ) {
+        return false;
+    }
+    memcpy( mStateData[ 0 ], values.data(), sizeof( double ) * mNumCollected );
+    return true;
+}
+
+/*!
+ * \brief Get the number of states which have been allocated so far.
+ * \details The "scratch" states of threads pinned to NUMA nodes are only
+ *          allocated once the thread first uses them.
+ * \return The number of allocated states.
+ */
+int ManageStateVariables::getNumAllocatedStates() const {
+    int numAllocated = 0;
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        if( mStateData[ stateInd ] ) {
+            ++numAllocated;
+        }
+    }
+    return numAllocated;
+}
+
+/*!
+ * \brief Get the bytes retained by the allocated states, including their
+ *        headers and dirty flags, along with the collected Value pointers.
+ * \return The bytes retained for the state.
+ */
+size_t ManageStateVariables::getStateBytes() const {
+    size_t bytes = mStateValues.capacity() * sizeof( Value* );
+    for( int stateInd = 0; stateInd < mNumStates; ++stateInd ) {
+        if( mStateData[ stateInd ] ) {
+            bytes += getStateHeader( mStateData[ stateInd ] )->mOffset + sizeof( double ) * mNumCollected;
+        }
+    }
+    return bytes;
 }
 
 #if DEBUG_STATE
@@ -292,13 +808,25 @@ void ManageStateVariables::DoCollect::processData( DataType& aData ) {
 #endif
 }
 
+/*!
+ * \brief Collect a single active state value.
+ * \param aValue The value to collect.
+ * \param aKind A description of the Data the value belongs to for reporting.
+ */
+void ManageStateVariables::DoCollect::addValue( Value* aValue, const char* aKind ) {
+    ( mInCurrMarket ? mParentClass->mMarketStateValues : mParentClass->mStateValues ).push_back( aValue );
+    ++mParentClass->mNumCollected;
+    if( mParentClass->mReportUnchanged ) {
+        mValueKinds[ aValue ] = mInCurrMarket ? "market" : mInCurrTechnology ? "technology" : aKind;
+    }
+}
+
 template<>
 void ManageStateVariables::DoCollect::processData<Value>( Value& aData ) {
     // Any SINGLE value that is tagged is considered active so long as it is not
     // contained in a retired technology for instance.
     if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData );
-        ++mParentClass->mNumCollected;
+        addValue( &aData, "single value" );
     }
 }
 
@@ -307,8 +835,7 @@ void ManageStateVariables::DoCollect::processData<objects::PeriodVector<Value> >
     // When an ARRAY of values are tagged only the Value in [ mPeriodToCollect] is
     // considered active.
     if( !mIgnoreCurrValue ) {
-        mParentClass->mStateValues.push_front( &aData[ mParentClass->mPeriodToCollect ] );
-        ++mParentClass->mNumCollected;
+        addValue( &aData[ mParentClass->mPeriodToCollect ], "period array" );
     }
 }
 
@@ -324,8 +851,7 @@ void ManageStateVariables::DoCollect::processData<objects::PeriodVector<objects:
     if( !mIgnoreCurrValue && mParentClass->mPeriodToCollect > 0 ) {
         objects::YearVector<Value>& currEmiss = *aData[ mParentClass->mPeriodToCollect ];
         for( int year = mParentClass->mCCStartYear; year <= mParentClass->mYearToCollect; ++year ) {
-            mParentClass->mStateValues.push_front( &currEmiss[ year ] );
-            ++mParentClass->mNumCollected;
+            addValue( &currEmiss[ year ], "land-use change emissions" );
         }
     }
 }
@@ -337,8 +863,7 @@ void ManageStateVariables::DoCollect::processData<objects::YearVector<Value> >(
     // to be from [mCCStartYear, mYearToCollect])
     if( !mIgnoreCurrValue ) {
         for( int year = std::max( mParentClass->mCCStartYear, aData.getStartYear() ); year <= mParentClass->mYearToCollect; ++year ) {
-            mParentClass->mStateValues.push_front( &aData[ year ] );
-            ++mParentClass->mNumCollected;
+            addValue( &aData[ year ], "year array" );
         }
     }
 }
@@ -360,12 +885,16 @@ void ManageStateVariables::DoCollect::pushFilterStep<ITechnology*>( ITechnology*
     if( !aData->isOperating( mParentClass->mPeriodToCollect ) ) {
         mIgnoreCurrValue = true;
     }
+    else {
+        mInCurrTechnology = true;
+    }
 }
 
 template<>
 void ManageStateVariables::DoCollect::popFilterStep<ITechnology*>( ITechnology* const& aData ) {
-    // Moving out of the current Technology so reset the ignore flag.
+    // Moving out of the current Technology so reset the ignore flags.
     mIgnoreCurrValue = false;
+    mInCurrTechnology = false;
 }
 
 template<>
@@ -374,11 +903,15 @@ void ManageStateVariables::DoCollect::pushFilterStep<Market*>( Market* const& aD
     if( aData->getYear() != mParentClass->mYearToCollect ) {
         mIgnoreCurrValue = true;
     }
+    else {
+        mInCurrMarket = true;
+    }
 }
 
 template<>
 void ManageStateVariables::DoCollect::popFilterStep<Market*>( Market* const& aData ) {
-    // Moving out of the current Market so reset the ignore flag.
+    // Moving out of the current Market so reset the ignore flags.
     mIgnoreCurrValue = false;
+    mInCurrMarket = false;
 }
 
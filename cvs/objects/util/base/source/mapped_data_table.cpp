@@ -0,0 +1,302 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file mapped_data_table.cpp
+* \ingroup Objects
+* \brief MappedDataTable class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <fstream>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <boost/interprocess/file_mapping.hpp>
+
+#include "util/base/include/mapped_data_table.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+namespace {
+    //! The magic string identifying a table file.
+    const char MAGIC[ 8 ] = { 'G', 'C', 'A', 'M', 'T', 'B', 'L', '\0' };
+
+    //! A value written in native byte order to detect files from other hosts.
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+    //! The header at the start of the file.
+    struct FileHeader {
+        char mMagic[ 8 ];
+        uint32_t mVersion;
+        uint32_t mByteOrder;
+        uint64_t mNumColumns;
+    };
+
+    //! The directory record for a single column.
+    struct ColumnRecord {
+        uint64_t mKeyOffset;
+        uint32_t mKeyLength;
+        uint32_t mSize;
+        uint64_t mDataOffset;
+    };
+
+    /*!
+     * \brief Round an offset up to the alignment of the data arrays.
+     * \param aOffset The offset.
+     * \return The aligned offset.
+     */
+    uint64_t align( const uint64_t aOffset ) {
+        return ( aOffset + 7 ) & ~static_cast<uint64_t>( 7 );
+    }
+
+    /*!
+     * \brief Get the size in bytes of the data of a column.
+     * \param aSize The number of rows.
+     * \return The size of the aligned year array followed by the values.
+     */
+    uint64_t columnBytes( const uint64_t aSize ) {
+        return align( aSize * sizeof( uint32_t ) ) + aSize * sizeof( double );
+    }
+}
+
+//! Constructor.
+MappedDataTable::Column::Column():
+mYears( 0 ),
+mValues( 0 ),
+mSize( 0 )
+{
+}
+
+//! Constructor.
+MappedDataTable::MappedDataTable():
+mIsCollecting( false )
+{
+}
+
+/*!
+ * \brief Get the table shared by all objects of the model.
+ * \return The single table instance.
+ */
+MappedDataTable& MappedDataTable::getInstance() {
+    static MappedDataTable sInstance;
+    return sInstance;
+}
+
+/*!
+ * \brief Map a table file into memory.
+ * \details The directory is read and checked when the file is opened, the data
+ *          itself is only paged in as the columns are used.  Any previously
+ *          opened table remains mapped if the file could not be used.
+ * \param aFileName The table file.
+ * \return Whether the file was mapped.
+ */
+bool MappedDataTable::open( const string& aFileName ) {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    boost::interprocess::mapped_region region;
+    try {
+        boost::interprocess::file_mapping file( aFileName.c_str(), boost::interprocess::read_only );
+        boost::interprocess::mapped_region( file, boost::interprocess::read_only ).swap( region );
+    }
+    catch( const boost::interprocess::interprocess_exception& aException ) {
+        // The configuration may name a table which has not been written yet.
+        mainLog.setLevel( ILogger::NOTICE );
+        mainLog << "Could not map data table " << aFileName << ": " << aException.what() << endl;
+        return false;
+    }
+
+    const char* data = static_cast<const char*>( region.get_address() );
+    const uint64_t fileSize = region.get_size();
+    const FileHeader* header = reinterpret_cast<const FileHeader*>( data );
+    if( fileSize < sizeof( FileHeader ) || memcmp( header->mMagic, MAGIC, sizeof( MAGIC ) ) != 0
+        || header->mVersion != VERSION || header->mByteOrder != BYTE_ORDER_MARK
+        || header->mNumColumns > ( fileSize - sizeof( FileHeader ) ) / sizeof( ColumnRecord ) )
+    {
+        mainLog.setLevel( ILogger::WARNING );
+        mainLog << "Data table " << aFileName << " has an unexpected format and will be ignored." << endl;
+        return false;
+    }
+
+    map<string, Column> columns;
+    const ColumnRecord* records = reinterpret_cast<const ColumnRecord*>( data + sizeof( FileHeader ) );
+    for( uint64_t i = 0; i < header->mNumColumns; ++i ) {
+        const ColumnRecord& record = records[ i ];
+        if( record.mKeyOffset + record.mKeyLength > fileSize || record.mDataOffset % 8 != 0
+            || record.mDataOffset + columnBytes( record.mSize ) > fileSize )
+        {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Data table " << aFileName << " is truncated and will be ignored." << endl;
+            return false;
+        }
+        Column column;
+        column.mYears = reinterpret_cast<const unsigned int*>( data + record.mDataOffset );
+        column.mValues = reinterpret_cast<const double*>( data + record.mDataOffset
+                                                          + align( record.mSize * sizeof( uint32_t ) ) );
+        column.mSize = record.mSize;
+        columns[ string( data + record.mKeyOffset, record.mKeyLength ) ] = column;
+    }
+
+    mRegion.swap( region );
+    mColumns.swap( columns );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Mapped " << mColumns.size() << " columns from data table " << aFileName << "." << endl;
+    return true;
+}
+
+/*!
+ * \brief Check if a table file has been mapped.
+ * \return Whether a table is open.
+ */
+bool MappedDataTable::isOpen() const {
+    return mRegion.get_address() != 0;
+}
+
+/*!
+ * \brief Find a column of the mapped table.
+ * \param aKey The key of the column.
+ * \param aColumn The view to set to the column if it was found.
+ * \return Whether the column was found.
+ */
+bool MappedDataTable::getColumn( const string& aKey, Column& aColumn ) const {
+    map<string, Column>::const_iterator found = mColumns.find( aKey );
+    if( found == mColumns.end() ) {
+        return false;
+    }
+    aColumn = found->second;
+    return true;
+}
+
+/*!
+ * \brief Set whether objects should add their data to be written to a new
+ *        table.
+ * \param aIsCollecting Whether columns are being collected.
+ */
+void MappedDataTable::setCollecting( const bool aIsCollecting ) {
+    mIsCollecting = aIsCollecting;
+}
+
+/*!
+ * \brief Check if objects should add their data to be written to a new table.
+ * \return Whether columns are being collected.
+ */
+bool MappedDataTable::isCollecting() const {
+    return mIsCollecting;
+}
+
+/*!
+ * \brief Add a column to be written to a new table.
+ * \details This may be called concurrently.  A column added more than once
+ *          keeps the last data given.
+ * \param aKey The key of the column which must be unique in the scenario.
+ * \param aData The value by year.
+ */
+void MappedDataTable::addColumn( const string& aKey, const map<unsigned int, double>& aData ) {
+#if GCAM_PARALLEL_ENABLED
+    tbb::spin_mutex::scoped_lock lock( mPendingMutex );
+#endif
+    mPendingColumns[ aKey ] = aData;
+}
+
+/*!
+ * \brief Write the collected columns to a table file.
+ * \param aFileName The file to write.
+ * \return Whether the file was written successfully.
+ */
+bool MappedDataTable::write( const string& aFileName ) const {
+    FileHeader header;
+    memcpy( header.mMagic, MAGIC, sizeof( MAGIC ) );
+    header.mVersion = VERSION;
+    header.mByteOrder = BYTE_ORDER_MARK;
+    header.mNumColumns = mPendingColumns.size();
+
+    // Lay out the directory, then the keys and then the aligned data.
+    vector<ColumnRecord> records;
+    records.reserve( mPendingColumns.size() );
+    uint64_t offset = sizeof( FileHeader ) + mPendingColumns.size() * sizeof( ColumnRecord );
+    typedef map<string, map<unsigned int, double> >::const_iterator PendingIterator;
+    for( PendingIterator it = mPendingColumns.begin(); it != mPendingColumns.end(); ++it ) {
+        ColumnRecord record;
+        record.mKeyOffset = offset;
+        record.mKeyLength = static_cast<uint32_t>( it->first.size() );
+        record.mSize = static_cast<uint32_t>( it->second.size() );
+        offset += record.mKeyLength;
+        records.push_back( record );
+    }
+    for( vector<ColumnRecord>::iterator it = records.begin(); it != records.end(); ++it ) {
+        offset = align( offset );
+        it->mDataOffset = offset;
+        offset += columnBytes( it->mSize );
+    }
+
+    ofstream out( aFileName.c_str(), ios_base::out | ios_base::binary | ios_base::trunc );
+    out.write( reinterpret_cast<const char*>( &header ), sizeof( header ) );
+    if( !records.empty() ) {
+        out.write( reinterpret_cast<const char*>( &records[ 0 ] ), records.size() * sizeof( ColumnRecord ) );
+    }
+    for( PendingIterator it = mPendingColumns.begin(); it != mPendingColumns.end(); ++it ) {
+        out.write( it->first.data(), it->first.size() );
+    }
+    const char padding[ 8 ] = { 0 };
+    uint64_t written = records.empty() ? sizeof( FileHeader ) : records.back().mKeyOffset + records.back().mKeyLength;
+    vector<ColumnRecord>::const_iterator record = records.begin();
+    for( PendingIterator it = mPendingColumns.begin(); it != mPendingColumns.end(); ++it, ++record ) {
+        out.write( padding, record->mDataOffset - written );
+        vector<uint32_t> years;
+        vector<double> values;
+        years.reserve( it->second.size() );
+        values.reserve( it->second.size() );
+        for( map<unsigned int, double>::const_iterator row = it->second.begin(); row != it->second.end(); ++row ) {
+            years.push_back( row->first );
+            values.push_back( row->second );
+        }
+        const uint64_t yearBytes = years.size() * sizeof( uint32_t );
+        if( !years.empty() ) {
+            out.write( reinterpret_cast<const char*>( &years[ 0 ] ), yearBytes );
+            out.write( padding, align( yearBytes ) - yearBytes );
+            out.write( reinterpret_cast<const char*>( &values[ 0 ] ), values.size() * sizeof( double ) );
+        }
+        written = record->mDataOffset + columnBytes( record->mSize );
+    }
+    out.close();
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    if( !out ) {
+        mainLog.setLevel( ILogger::ERROR );
+        mainLog << "Failed to write data table " << aFileName << "." << endl;
+        return false;
+    }
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Wrote " << mPendingColumns.size() << " columns to data table " << aFileName << "." << endl;
+    return true;
+}
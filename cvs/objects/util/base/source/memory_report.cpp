@@ -0,0 +1,221 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+ * \file memory_report.cpp
+ * \ingroup Objects
+ * \brief MemoryReport class source file.
+ */
+
+#include "util/base/include/definitions.h"
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <typeinfo>
+#include <boost/core/demangle.hpp>
+
+#include "util/base/include/memory_report.h"
+#include "containers/include/scenario.h"
+#include "util/logger/include/ilogger.h"
+#include "util/base/include/gcam_fusion.hpp"
+#include "util/base/include/gcam_data_containers.h"
+
+using namespace std;
+
+namespace {
+    //! The approximate bytes used by a node of a std::map beyond its value.
+    const size_t MAP_NODE_BYTES = 4 * sizeof( void* );
+
+    // The heap bytes of the kinds of Data declared by the containers, the
+    // inline bytes are counted with sizeof by the caller.
+    template<typename T>
+    size_t getHeapBytes( const T& aData );
+    size_t getHeapBytes( const string& aData );
+    template<typename T>
+    size_t getHeapBytes( const vector<T>& aData );
+    template<typename K, typename V>
+    size_t getHeapBytes( const pair<K, V>& aData );
+    template<typename K, typename V, typename C, typename A>
+    size_t getHeapBytes( const map<K, V, C, A>& aData );
+    template<typename T>
+    size_t getHeapBytes( const objects::PeriodVector<T>& aData );
+    template<typename T>
+    size_t getHeapBytes( const objects::YearVector<T>& aData );
+    template<typename T>
+    size_t getHeapBytes( objects::YearVector<T>* const& aData );
+
+    template<typename T>
+    size_t getHeapBytes( const T& aData ) {
+        // Pointers to other containers are attributed to their own class.
+        return 0;
+    }
+
+    size_t getHeapBytes( const string& aData ) {
+        // Short strings are stored inline.
+        return aData.capacity() > 15 ? aData.capacity() + 1 : 0;
+    }
+
+    template<typename T>
+    size_t getHeapBytes( const vector<T>& aData ) {
+        size_t bytes = aData.capacity() * sizeof( T );
+        for( const auto& curr : aData ) {
+            bytes += getHeapBytes( curr );
+        }
+        return bytes;
+    }
+
+    template<typename K, typename V>
+    size_t getHeapBytes( const pair<K, V>& aData ) {
+        return getHeapBytes( aData.first ) + getHeapBytes( aData.second );
+    }
+
+    template<typename K, typename V, typename C, typename A>
+    size_t getHeapBytes( const map<K, V, C, A>& aData ) {
+        size_t bytes = aData.size() * ( MAP_NODE_BYTES + sizeof( typename map<K, V, C, A>::value_type ) );
+        for( const auto& curr : aData ) {
+            bytes += getHeapBytes( curr );
+        }
+        return bytes;
+    }
+
+    template<typename T>
+    size_t getHeapBytes( const objects::PeriodVector<T>& aData ) {
+        size_t bytes = aData.size() * sizeof( T );
+        for( const auto& curr : aData ) {
+            bytes += getHeapBytes( curr );
+        }
+        return bytes;
+    }
+
+    template<typename T>
+    size_t getHeapBytes( const objects::YearVector<T>& aData ) {
+        size_t bytes = aData.size() * sizeof( T );
+        for( const auto& curr : aData ) {
+            bytes += getHeapBytes( curr );
+        }
+        return bytes;
+    }
+
+    template<typename T>
+    size_t getHeapBytes( objects::YearVector<T>* const& aData ) {
+        // Unlike containers the year vectors are owned by the pointer.
+        return aData ? sizeof( *aData ) + getHeapBytes( *aData ) : 0;
+    }
+}
+
+//! Constructor
+MemoryReport::MemoryReport():
+mCountObjects( false )
+{
+}
+
+/*!
+ * \brief Estimate the memory retained by each class of object reachable from
+ *        the given scenario.
+ * \param aScenario The scenario to search.
+ */
+void MemoryReport::collect( Scenario* aScenario ) {
+    const string scenarioName = "Scenario";
+    mContainerStack.assign( 1, scenarioName );
+    ++mUsage[ scenarioName ].mObjects;
+
+    // Back to back descendant steps are not allowed so rather than matching any
+    // Data in a single search the SIMPLE and ARRAY Data are found in separate
+    // searches, only the first of which counts the containers.
+    const int dataFlags[] = { DataFlags::SIMPLE, DataFlags::ARRAY };
+    for( size_t search = 0; search < sizeof( dataFlags ) / sizeof( dataFlags[ 0 ] ); ++search ) {
+        vector<FilterStep*> memorySteps( 2, 0 );
+        memorySteps[ 0 ] = new FilterStep( "" );
+        memorySteps[ 1 ] = new FilterStep( "", dataFlags[ search ] );
+        mCountObjects = search == 0;
+        GCAMFusion<MemoryReport, true, true, true> findMemory( *this, memorySteps );
+        findMemory.startFilter( aScenario );
+        for( auto filterStep : memorySteps ) {
+            delete filterStep;
+        }
+    }
+    mContainerStack.clear();
+}
+
+/*!
+ * \brief Add memory which is not declared as Data to the report.
+ * \param aName The name to report the memory under.
+ * \param aObjects The number of objects which retain the memory.
+ * \param aBytes The estimated bytes retained.
+ */
+void MemoryReport::addUsage( const string& aName, const size_t aObjects, const size_t aBytes ) {
+    Usage& usage = mUsage[ aName ];
+    usage.mObjects += aObjects;
+    usage.mBytes += aBytes;
+}
+
+/*!
+ * \brief Print the usage of each class, largest first, along with the total.
+ * \param aLog The log to print to.
+ * \param aWhen A description of the point in the run the report was made.
+ */
+void MemoryReport::print( ILogger& aLog, const string& aWhen ) const {
+    vector<pair<string, Usage> > sortedUsage( mUsage.begin(), mUsage.end() );
+    sort( sortedUsage.begin(), sortedUsage.end(), []( const pair<string, Usage>& aLHS, const pair<string, Usage>& aRHS ) {
+        return aLHS.second.mBytes > aRHS.second.mBytes;
+    } );
+
+    const double bytesPerMB = 1024.0 * 1024.0;
+    size_t totalBytes = 0;
+    aLog.setLevel( ILogger::NOTICE );
+    aLog << "Estimated memory usage " << aWhen << " (class, objects, MB):" << endl;
+    for( const auto& curr : sortedUsage ) {
+        aLog << curr.first << ": " << curr.second.mObjects << ", " << curr.second.mBytes / bytesPerMB << endl;
+        totalBytes += curr.second.mBytes;
+    }
+    aLog << "Total: " << totalBytes / bytesPerMB << endl;
+}
+
+template<typename DataType>
+void MemoryReport::processData( DataType& aData ) {
+    mUsage[ mContainerStack.back() ].mBytes += sizeof( DataType ) + getHeapBytes( aData );
+}
+
+template<typename DataType>
+void MemoryReport::pushFilterStep( const DataType& aData ) {
+    // Containers are always stepped into through a pointer to them.
+    mContainerStack.push_back( boost::core::demangle( typeid( *aData ).name() ) );
+    if( mCountObjects ) {
+        ++mUsage[ mContainerStack.back() ].mObjects;
+    }
+}
+
+template<typename DataType>
+void MemoryReport::popFilterStep( const DataType& aData ) {
+    mContainerStack.pop_back();
+}
@@ -251,6 +251,7 @@ void Modeltime::initMembers( const map<int, int>& aYearToTimeStep ) {
     
     // start processing not to say no more errors are possible however
     mMaxPeriod = 0;
+    mYearToPeriod.assign( mEndYear - mStartYear + 1, 0 );
     // the timesteps are shifted by one and so the time step in period 0 does not make sense
     // note that the 15 is arbitrary here but a valid timestep is necessary for period 0
     mPeriodToTimeStep.push_back( 15 );
@@ -269,19 +270,19 @@ void Modeltime::initMembers( const map<int, int>& aYearToTimeStep ) {
             int offsetYear = currYear + periodOffset * currTimeStep;
             mPeriodToYear.push_back( offsetYear );
             mPeriodToTimeStep.push_back( currTimeStep );
-            mYearToPeriod[ offsetYear ] = mMaxPeriod++;
+            mYearToPeriod[ offsetYear - mStartYear ] = mMaxPeriod++;
         }
     }
     
     // add info for the end year
     mPeriodToYear.push_back( mEndYear );
-    mYearToPeriod[ mEndYear ] = mMaxPeriod++;
+    mYearToPeriod[ mEndYear - mStartYear ] = mMaxPeriod++;
     
-    // Fill non-model years in 1 year timesteps into the year to period map with the period of the next
+    // Fill non-model years in 1 year timesteps into the year to period table with the period of the next
     // model year. Required for the carbon box model.
     for( int currPeriod = 1; currPeriod < mMaxPeriod; ++currPeriod ) {
         for( int inBetweenYear = mPeriodToYear[ currPeriod - 1 ] + 1; inBetweenYear < mPeriodToYear[ currPeriod ]; ++inBetweenYear ) {
-            mYearToPeriod[ inBetweenYear ] = currPeriod;
+            mYearToPeriod[ inBetweenYear - mStartYear ] = currPeriod;
         }
     }
     
@@ -311,38 +312,42 @@ int Modeltime::getEndYear() const {
 }
 
 /*!
-* \brief Convert a period into a year.
-* \details Converts the period into a year if it is valid. If it is not a valid
-*          year the function will print a warning and return 0.
-* \param aPeriod Model period.
-* \return The first year of the period, 0 if the year is invalid.
-*/
-int Modeltime::getper_to_yr( const int aPeriod ) const {
-    assert( mIsInitialized );
-    
-    if( aPeriod >= 0 && aPeriod < static_cast<int>( mPeriodToYear.size() ) ){
-        return mPeriodToYear[ aPeriod ];
-    }
-
+ * \brief Log an invalid period passed to getper_to_yr.
+ * \param aPeriod The invalid period.
+ * \return Zero which is returned by getper_to_yr for an invalid period.
+ */
+int Modeltime::reportInvalidPeriod( const int aPeriod ) const {
     ILogger& mainLog = ILogger::getLogger( "main_log" );
     mainLog.setLevel( ILogger::ERROR );
     mainLog << "Invalid period " << aPeriod << " passed to Modeltime::getper_to_yr." << endl;
     return 0;
 }
 
-//! Convert a year to a period.
-int Modeltime::getyr_to_per( const int aYear ) const {
+/*!
+ * \brief Log an invalid year passed to getyr_to_per.
+ * \param aYear The invalid year.
+ * \return Zero which is returned by getyr_to_per for an invalid year.
+ */
+int Modeltime::reportInvalidYear( const int aYear ) const {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::ERROR );
+    mainLog << "Invalid year: " << aYear << " passed to Modeltime::getyr_to_per. " << endl;
+    return 0;
+}
+
+/*!
+ * \brief Get a view of the year and period mappings.
+ * \return The view which is valid for the lifetime of the Modeltime.
+ */
+Modeltime::YearPeriodTable Modeltime::getYearPeriodTable() const {
     assert( mIsInitialized );
-    
-    map<int,int>::const_iterator iter = mYearToPeriod.find( aYear );
-    // Check for an invalid time period.
-    if( iter == mYearToPeriod.end() ){
-        ILogger& mainLog = ILogger::getLogger( "main_log" );
-        mainLog.setLevel( ILogger::ERROR );
-        mainLog << "Invalid year: " << aYear << " passed to Modeltime::getyr_to_per. " << endl;
-        return 0;
-    }
-    return iter->second; 
+
+    YearPeriodTable table;
+    table.mStartYear = mStartYear;
+    table.mNumYears = static_cast<unsigned int>( mYearToPeriod.size() );
+    table.mYearToPeriod = &mYearToPeriod[ 0 ];
+    table.mPeriodToYear = &mPeriodToYear[ 0 ];
+    return table;
 }
 
 /*!
@@ -353,13 +358,13 @@ int Modeltime::getyr_to_per( const int aYear ) const {
 bool Modeltime::isModelYear( const int aYear ) const {
     assert( mIsInitialized );
     
-    // Note that simply checking the year to period map will not work as intended.
-    // This is due to values being filled into the mYearToPeriod map for in between
+    // Note that simply checking the year to period table will not work as intended.
+    // This is due to values being filled into the mYearToPeriod table for in between
     // years.  A work around is to convert the year to a period and back again to
     // make sure that year is the same as aYear.
-    map<int, int>::const_iterator lookupYearIter = mYearToPeriod.find( aYear );
-    return lookupYearIter != mYearToPeriod.end()
-        && mPeriodToYear[ (*lookupYearIter).second ] == aYear;
+    const size_t yearIndex = static_cast<size_t>( static_cast<unsigned int>( aYear - mStartYear ) );
+    return yearIndex < mYearToPeriod.size()
+        && mPeriodToYear[ mYearToPeriod[ yearIndex ] ] == aYear;
 }
 
 /*!
@@ -40,6 +40,8 @@
 
 #include "util/base/include/definitions.h"
 #include <string>
+#include <vector>
+#include <cmath>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 
@@ -145,3 +147,22 @@ double SCurveInterpolationFunction::interpolate( const DataPoint* aLeftPoint, co
     return aRightPoint->getY() - ( aRightPoint->getY() - aLeftPoint->getY() )
         / ( 1.0 + exp( mSteepness * ( ( aXValue - medianX ) / ( aRightPoint->getX() - aLeftPoint->getX() ) ) ) );
 }
+
+void SCurveInterpolationFunction::interpolateValues( const DataPoint* aLeftPoint, const DataPoint* aRightPoint,
+                                                     const vector<double>& aXValues, vector<double>& aYValues ) const
+{
+    // The median and the ranges only depend on the data points so compute them
+    // once. The operations are otherwise ordered as in interpolate so that the
+    // results are identical.
+    double medianX = mMedianXValue;
+    if( mMedianXValue < aLeftPoint->getX() || mMedianXValue > aRightPoint->getX() ) {
+        medianX = ( aRightPoint->getX() - aLeftPoint->getX() ) / 2 + aLeftPoint->getX();
+    }
+    const double rightY = aRightPoint->getY();
+    const double yRange = rightY - aLeftPoint->getY();
+    const double xRange = aRightPoint->getX() - aLeftPoint->getX();
+    aYValues.resize( aXValues.size() );
+    for( size_t i = 0; i < aXValues.size(); ++i ) {
+        aYValues[ i ] = rightY - yRange / ( 1.0 + exp( mSteepness * ( ( aXValues[ i ] - medianX ) / xRange ) ) );
+    }
+}
@@ -0,0 +1,288 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file scope_profiler.cpp
+* \ingroup Objects
+* \brief ScopeProfiler class source file.
+*/
+
+#include "util/base/include/definitions.h"
+
+#if GCAM_PROFILE_SCOPES
+#include <string>
+#include <vector>
+#include <mutex>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+
+#include "util/base/include/scope_profiler.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+/*!
+ * \brief A scope entered by one thread under a particular chain of parents.
+ */
+struct ScopeProfiler::Node {
+    //! The name of the scope.
+    const char* mName;
+
+    //! The enclosing scope, null for the root of a thread.
+    Node* mParent;
+
+    //! The scopes entered from within this one which are owned by this node.
+    vector<Node*> mChildren;
+
+    //! The total time spent in the scope in seconds.
+    double mSeconds;
+
+    //! The number of times the scope was entered.
+    unsigned long mCalls;
+};
+
+/*!
+ * \brief The tree of scopes entered by a single thread.
+ */
+struct ScopeProfiler::ThreadTree {
+    //! An unnamed node which holds the outermost scopes.
+    Node mRoot;
+
+    //! The scope the thread is currently in.
+    Node* mCurrent;
+};
+
+namespace {
+    /*!
+     * \brief The times of a scope merged across all threads.
+     */
+    struct MergedNode {
+        string mName;
+        double mSeconds;
+        unsigned long mCalls;
+        vector<MergedNode> mChildren;
+    };
+
+    //! The lock which guards the list of thread trees.
+    mutex& getThreadTreesMutex() {
+        static mutex sThreadTreesMutex;
+        return sThreadTreesMutex;
+    }
+}
+
+/*!
+ * \brief Get the trees of all threads which have entered a scope.
+ * \return The list of thread trees, guarded by getThreadTreesMutex.
+ */
+vector<ScopeProfiler::ThreadTree*>& ScopeProfiler::getThreadTrees() {
+    static vector<ThreadTree*> sThreadTrees;
+    return sThreadTrees;
+}
+
+/*!
+ * \brief Get the tree of the current thread, creating and registering it the
+ *        first time the thread enters a scope.
+ * \details The trees are never deleted as the threads which own them last for
+ *          the whole model run.
+ * \return The scope tree of the current thread.
+ */
+ScopeProfiler::ThreadTree& ScopeProfiler::getThreadTree() {
+    thread_local ThreadTree* tTree = 0;
+    if( !tTree ) {
+        tTree = new ThreadTree();
+        tTree->mRoot.mName = "";
+        tTree->mRoot.mParent = 0;
+        tTree->mRoot.mSeconds = 0;
+        tTree->mRoot.mCalls = 0;
+        tTree->mCurrent = &tTree->mRoot;
+        lock_guard<mutex> lock( getThreadTreesMutex() );
+        getThreadTrees().push_back( tTree );
+    }
+    return *tTree;
+}
+
+/*!
+ * \brief Enter a scope.
+ * \param aName The name of the scope which must remain valid for the whole run,
+ *        generally a string literal.
+ */
+ScopeProfiler::Scope::Scope( const char* aName ) {
+    ThreadTree& tree = getThreadTree();
+    Node* parent = tree.mCurrent;
+    mNode = 0;
+    for( Node* child : parent->mChildren ) {
+        if( child->mName == aName ) {
+            mNode = child;
+            break;
+        }
+    }
+    if( !mNode ) {
+        mNode = new Node();
+        mNode->mName = aName;
+        mNode->mParent = parent;
+        mNode->mSeconds = 0;
+        mNode->mCalls = 0;
+        parent->mChildren.push_back( mNode );
+    }
+    tree.mCurrent = mNode;
+    mStart = chrono::steady_clock::now();
+}
+
+/*!
+ * \brief Leave the scope adding the time spent in it to its node.
+ */
+ScopeProfiler::Scope::~Scope() {
+    const chrono::duration<double> elapsed = chrono::steady_clock::now() - mStart;
+    mNode->mSeconds += elapsed.count();
+    ++mNode->mCalls;
+    getThreadTree().mCurrent = mNode->mParent;
+}
+
+namespace {
+    /*!
+     * \brief Add the times of a node and its children to the merged tree and
+     *        reset them.
+     * \param aNode The node of a thread tree.
+     * \param aMerged The merged node with the same chain of names.
+     */
+    template<typename NodeType>
+    void mergeAndReset( NodeType* aNode, MergedNode& aMerged ) {
+        aMerged.mSeconds += aNode->mSeconds;
+        aMerged.mCalls += aNode->mCalls;
+        aNode->mSeconds = 0;
+        aNode->mCalls = 0;
+        for( NodeType* child : aNode->mChildren ) {
+            auto mergedChild = find_if( aMerged.mChildren.begin(), aMerged.mChildren.end(),
+                                        [child] ( const MergedNode& aCurr ) {
+                                            return aCurr.mName == child->mName;
+                                        } );
+            if( mergedChild == aMerged.mChildren.end() ) {
+                MergedNode newChild = { child->mName, 0, 0, vector<MergedNode>() };
+                aMerged.mChildren.push_back( newChild );
+                mergedChild = aMerged.mChildren.end() - 1;
+            }
+            mergeAndReset( child, *mergedChild );
+        }
+    }
+
+    /*!
+     * \brief Print a merged node and its children indented by depth, slowest
+     *        first.
+     */
+    void printTree( const MergedNode& aNode, const int aDepth, ostream& aOut ) {
+        if( aNode.mCalls == 0 ) {
+            return;
+        }
+        aOut << string( 2 * aDepth, ' ' ) << aNode.mName << ": " << aNode.mSeconds
+             << " seconds, " << aNode.mCalls << " calls" << endl;
+        vector<const MergedNode*> children;
+        for( const MergedNode& child : aNode.mChildren ) {
+            children.push_back( &child );
+        }
+        sort( children.begin(), children.end(), [] ( const MergedNode* aLHS, const MergedNode* aRHS ) {
+            return aLHS->mSeconds > aRHS->mSeconds;
+        } );
+        for( const MergedNode* child : children ) {
+            printTree( *child, aDepth + 1, aOut );
+        }
+    }
+
+    /*!
+     * \brief Write the self time of a merged node and its children as folded
+     *        stacks, one line per scope of the form "a;b;c microseconds".
+     */
+    void writeFolded( const MergedNode& aNode, const string& aStack, ostream& aOut ) {
+        if( aNode.mCalls == 0 ) {
+            return;
+        }
+        const string stack = aStack + ";" + aNode.mName;
+        double selfSeconds = aNode.mSeconds;
+        for( const MergedNode& child : aNode.mChildren ) {
+            selfSeconds -= child.mSeconds;
+            writeFolded( child, stack, aOut );
+        }
+        const long long selfMicroseconds = static_cast<long long>( max( selfSeconds, 0.0 ) * 1e6 );
+        if( selfMicroseconds > 0 ) {
+            aOut << stack << ' ' << selfMicroseconds << '\n';
+        }
+    }
+}
+
+/*!
+ * \brief Report the scope times of a period and reset them for the next one.
+ * \details The times of all threads are merged by the chain of scope names,
+ *          printed to the main log and, if the "scope-profile" file is set to
+ *          be written, appended to it as folded stacks rooted at the year.  The
+ *          file is truncated the first time it is written in a run.
+ * \warning Must be called while no other thread is inside a scope.
+ * \param aYear The year of the period which just finished.
+ */
+void ScopeProfiler::reportPeriod( const int aYear ) {
+    const string yearName = "period-" + to_string( aYear );
+    MergedNode merged = { yearName, 0, 0, vector<MergedNode>() };
+    {
+        lock_guard<mutex> lock( getThreadTreesMutex() );
+        for( ThreadTree* tree : getThreadTrees() ) {
+            mergeAndReset( &tree->mRoot, merged );
+        }
+    }
+    // The root is not a real scope so give it the time of its children.
+    for( const MergedNode& child : merged.mChildren ) {
+        merged.mSeconds += child.mSeconds;
+    }
+    merged.mCalls = 1;
+
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    mainLog << "Scope profile:" << endl;
+    printTree( merged, 0, mainLog );
+
+    const Configuration* conf = Configuration::getInstance();
+    if( conf->shouldWriteFile( "scope-profile", false, false ) ) {
+        static bool sIsFirstWrite = true;
+        const string& profileFile = conf->getFile( "scope-profile" );
+        ofstream out( profileFile.c_str(), sIsFirstWrite ? ios::out : ios::app );
+        sIsFirstWrite = false;
+        // The root has no time of its own so start the stacks at its children.
+        for( const MergedNode& child : merged.mChildren ) {
+            writeFolded( child, merged.mName, out );
+        }
+        if( !out ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not write the scope profile to " << profileFile << "." << endl;
+        }
+    }
+}
+
+#endif // GCAM_PROFILE_SCOPES
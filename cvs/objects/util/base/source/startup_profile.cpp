@@ -0,0 +1,210 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file startup_profile.cpp
+* \ingroup Objects
+* \brief StartupProfile class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+
+#if !defined( _WIN32 )
+#include <sys/resource.h>
+#endif
+
+#include "util/base/include/startup_profile.h"
+#include "util/base/include/timer.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+
+//! Constructor.
+StartupProfile::StartupProfile() {
+}
+
+/*!
+ * \brief Get the profile shared by the whole model.
+ * \return The single profile instance.
+ */
+StartupProfile& StartupProfile::getInstance() {
+    static StartupProfile sInstance;
+    return sInstance;
+}
+
+/*!
+ * \brief Start timing a phase.
+ * \param aPhase The name of the phase.
+ */
+void StartupProfile::startPhase( const string& aPhase ) {
+    Phase& phase = getPhase( aPhase );
+    ++phase.mCount;
+    phase.mTimer->start();
+}
+
+/*!
+ * \brief Stop timing a phase and take a snapshot of the memory in use.
+ * \param aPhase The name of the phase.
+ */
+void StartupProfile::endPhase( const string& aPhase ) {
+    Phase& phase = getPhase( aPhase );
+    phase.mTimer->stop();
+    getMemoryUsage( phase.mResidentMemory, phase.mPeakResidentMemory );
+}
+
+/*!
+ * \brief Print a table of the phases.
+ * \param aOut The stream to print to.
+ */
+void StartupProfile::print( ostream& aOut ) const {
+    aOut << "Startup phases (seconds, resident MB, peak resident MB):" << endl;
+    for( vector<Phase>::const_iterator it = mPhases.begin(); it != mPhases.end(); ++it ) {
+        aOut << "    " << left << setw( 40 ) << it->mName << right
+             << fixed << setprecision( 3 ) << setw( 10 ) << it->mTimer->getTotalTimeDifference()
+             << setprecision( 1 ) << setw( 10 ) << it->mResidentMemory
+             << setw( 10 ) << it->mPeakResidentMemory;
+        if( it->mCount > 1 ) {
+            aOut << "  (" << it->mCount << " times)";
+        }
+        aOut << endl;
+    }
+    aOut.unsetf( ios_base::floatfield );
+}
+
+/*!
+ * \brief Write the phases as a JSON array of objects.
+ * \param aFileName The file to write.
+ * \return Whether the file could be written.
+ */
+bool StartupProfile::writeJSON( const string& aFileName ) const {
+    ofstream out( aFileName.c_str() );
+    out << "[" << endl;
+    for( vector<Phase>::const_iterator it = mPhases.begin(); it != mPhases.end(); ++it ) {
+        // File names are the only phase names which could need escaping.
+        string name;
+        for( string::const_iterator c = it->mName.begin(); c != it->mName.end(); ++c ) {
+            if( *c == '"' || *c == '\\' ) {
+                name += '\\';
+            }
+            name += *c;
+        }
+        out << "  { \"phase\": \"" << name << "\", \"count\": " << it->mCount
+            << ", \"seconds\": " << it->mTimer->getTotalTimeDifference()
+            << ", \"resident-mb\": " << it->mResidentMemory
+            << ", \"peak-resident-mb\": " << it->mPeakResidentMemory << " }"
+            << ( it + 1 != mPhases.end() ? "," : "" ) << endl;
+    }
+    out << "]" << endl;
+    return static_cast<bool>( out );
+}
+
+/*!
+ * \brief Print the phases to the main log and write them to the
+ *        "startup-profile" file if it is enabled.
+ */
+void StartupProfile::report() const {
+    ILogger& mainLog = ILogger::getLogger( "main_log" );
+    mainLog.setLevel( ILogger::NOTICE );
+    print( mainLog );
+
+    const Configuration* conf = Configuration::getInstance();
+    if( conf->shouldWriteFile( "startup-profile", false, false ) ) {
+        const string& profileFile = conf->getFile( "startup-profile" );
+        if( !writeJSON( profileFile ) ) {
+            mainLog.setLevel( ILogger::WARNING );
+            mainLog << "Could not write the startup profile to " << profileFile << "." << endl;
+        }
+    }
+}
+
+/*!
+ * \brief Find a phase by name, adding it if it is new.
+ * \param aPhase The name of the phase.
+ * \return The phase.
+ */
+StartupProfile::Phase& StartupProfile::getPhase( const string& aPhase ) {
+    for( vector<Phase>::iterator it = mPhases.begin(); it != mPhases.end(); ++it ) {
+        if( it->mName == aPhase ) {
+            return *it;
+        }
+    }
+    Phase phase;
+    phase.mName = aPhase;
+    phase.mTimer = &TimerRegistry::getInstance().getTimer( "startup: " + aPhase );
+    phase.mCount = 0;
+    phase.mResidentMemory = 0;
+    phase.mPeakResidentMemory = 0;
+    mPhases.push_back( phase );
+    return mPhases.back();
+}
+
+/*!
+ * \brief Get the current and peak resident memory of the process.
+ * \details Values which are not available on this platform are set to zero.
+ * \param aResident The current resident set size in MB.
+ * \param aPeakResident The peak resident set size in MB.
+ */
+void StartupProfile::getMemoryUsage( double& aResident, double& aPeakResident ) {
+    aResident = 0;
+    aPeakResident = 0;
+    ifstream status( "/proc/self/status" );
+    if( status ) {
+        string line;
+        while( getline( status, line ) ) {
+            // The values are given in kB.
+            double* value = line.compare( 0, 6, "VmRSS:" ) == 0 ? &aResident :
+                            line.compare( 0, 6, "VmHWM:" ) == 0 ? &aPeakResident : 0;
+            if( value ) {
+                istringstream( line.substr( 6 ) ) >> *value;
+                *value /= 1024.0;
+            }
+        }
+        return;
+    }
+#if !defined( _WIN32 )
+    struct rusage usage;
+    if( getrusage( RUSAGE_SELF, &usage ) == 0 ) {
+#if defined( __APPLE__ )
+        // Reported in bytes on OS X rather than kB.
+        aPeakResident = usage.ru_maxrss / ( 1024.0 * 1024.0 );
+#else
+        aPeakResident = usage.ru_maxrss / 1024.0;
+#endif
+    }
+#endif
+}
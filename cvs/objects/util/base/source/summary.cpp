@@ -57,6 +57,28 @@ extern Scenario* scenario;
 Summary::Summary() {
 }
 
+/*! \brief Add each value of one map to the value with the same name in another.
+* \details Both maps are ordered by name so they are merged in a single pass,
+*  inserting missing names at the position already found rather than searching
+*  the target map for each name.
+* \param aTarget The map to add to.
+* \param aSource The map of values to add.
+*/
+void Summary::addItems( SummaryItem& aTarget, const SummaryItem& aSource ) {
+    SummaryIterator targetIter = aTarget.begin();
+    for( CSummaryIterator sourceIter = aSource.begin(); sourceIter != aSource.end(); ++sourceIter ) {
+        while( targetIter != aTarget.end() && targetIter->first < sourceIter->first ) {
+            ++targetIter;
+        }
+        if( targetIter == aTarget.end() || targetIter->first != sourceIter->first ) {
+            targetIter = aTarget.insert( targetIter, *sourceIter );
+        }
+        else {
+            targetIter->second += sourceIter->second;
+        }
+    }
+}
+
 /*! \brief Initialize the fuel consumption map.
 * \details Adds fuel consumption to the existing consumption and
 *  adds to total.
@@ -153,10 +175,8 @@ The iterator fmap is used to traverse the fuelinfo map.
 */
 void Summary::updatefuelcons( const list<string>& aPrimaryFuelList, const SummaryItem& fuelinfo ) {
     // map all primary and secondary fuel consumption
-    for (CSummaryIterator fmap=fuelinfo.begin(); fmap!=fuelinfo.end(); ++fmap) {    // iterate to one less than the end
-        fuelcons[fmap->first] += fmap->second; // Add values from the passed map to fuelcons
-        // Don't need a zTotal b/c the fuels are not comparable. 
-    }
+    // Don't need a zTotal b/c the fuels are not comparable.
+    addItems( fuelcons, fuelinfo );
 
     // map primary fuel list only.
     for( list<string>::const_iterator fuelIter = aPrimaryFuelList.begin();
@@ -174,34 +194,26 @@ void Summary::updatefuelcons( const list<string>& aPrimaryFuelList, const Summar
 void Summary::updatepetrade() {
     // map all primary and secondary fuel consumption
     for ( CSummaryIterator fmap = peprod.begin(); fmap != peprod.end(); ++fmap ) {
-        petrade[ fmap->first ] = peprod[ fmap->first ] - pecons[ fmap->first ];
+        petrade[ fmap->first ] = fmap->second - pecons[ fmap->first ];
     }
 }
 
 //! Update and add to GHG emissions from passed in GHG emissions map.
 //! param ghginfo Map of GHG emissions.
 void Summary::updateemiss( const SummaryItem& ghginfo ) {
-    // map all primary and secondary fuel consumption
-    for ( CSummaryIterator fmap = ghginfo.begin(); fmap != ghginfo.end(); ++fmap){
-        emission[ fmap->first ] += fmap->second;
-    }
+    addItems( emission, ghginfo );
 }
 
 //! Update and add to GHG emissions by fuel from passed in GHG emissions map.
 //! param ghginfo Map of GHG emissions.
 void Summary::updateemfuelmap( const SummaryItem& ghginfo ) {
-    // map all primary and secondary fuel consumption
-    for ( CSummaryIterator fmap = ghginfo.begin(); fmap != ghginfo.end(); ++fmap ) {
-        emissfuel[ fmap->first ] += fmap->second;
-    }
+    addItems( emissfuel, ghginfo );
 }
 
 //! update the map of sequestered amount of emissions
 void Summary::updateSequesteredAmountMap( const SummaryItem& ghginfo ) {
     // map sequestered amount of CO2 for secondary fuels and zTotal
-    for ( CSummaryIterator fmap = ghginfo.begin(); fmap != ghginfo.end(); ++fmap ) {
-        sequesteredAmount[ fmap->first ] += fmap->second;
-    }
+    addItems( sequesteredAmount, ghginfo );
 }
 
 //! Clear fuel consumption and primary energy consumption maps.
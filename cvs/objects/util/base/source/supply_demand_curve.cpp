@@ -74,9 +74,9 @@ SupplyDemandCurve::~SupplyDemandCurve() {
 *
 * This function first determines a series of price ratios to use to determine the prices to 
 * create SupplyDemandPoints for. It then saves the original marketplace information, and perturbs the price
-* as specified by the price ratios. Using this new perturbed price, it call World::Calc to determine supply and 
-* demand for the market. It saves that point for printing later, and continues to perform this process for each price.
-* Finally it restores the original market information.
+* as specified by the price ratios. Using this new perturbed price, it recalculates the activities which depend
+* on the market to determine supply and demand for the market, starting each point from the same base state so that
+* the points may be calculated concurrently (see LogEDFun::partialSweep). It saves the points for printing later.
 *
 * \param aNumPoints The number of points to calculate.
 * \param aSolnSet The solution set to interact with markets through.
@@ -123,27 +123,25 @@ void SupplyDemandCurve::calculatePoints( const int aNumPoints, SolutionInfoSet&
     
     // Call F( x ), store the result in fx
     F(x,fx);
-    // Have the state manage save the current state as a "clean" state.
-    scenario->getManageStateVariables()->setPartialDeriv(true);
 
-    // iterate through the points and determine supply and demand.
+    // Evaluate each point from the state left by the full evaluation,
+    // recalculating only what depends on this market.  The points are
+    // independent of one another so LogEDFun may evaluate them concurrently.
+    // Note x is a scaled price
+    // x[ mMarketNumber ] = priceMults[ pointNumber2 ] * basePrice;
+    vector<double> pointPrices( aNumPoints );
     for ( int pointNumber2 = 0; pointNumber2 < aNumPoints; pointNumber2++ ) {
-        
-        F.partial(mMarketNumber);
-        // Note x is a scaled price
-        // x[ mMarketNumber ] = priceMults[ pointNumber2 ] * basePrice;
-        x[ mMarketNumber ] = pointNumber2 * ( double( 10 ) / double( aNumPoints - 1 ) );
-        F(x, fx, mMarketNumber);
-
-        mPoints.push_back( new SupplyDemandPoint( aSolnSet.getSolvable( mMarketNumber ).getPrice(),
-                                                  aSolnSet.getSolvable( mMarketNumber ).getDemand(),
-                                                  aSolnSet.getSolvable( mMarketNumber ).getSupply(),
-                                                  fx[ mMarketNumber ] ) );
-
-    } // Completed iterating through all price points.
-
-    // restore state information for summary.
-    F.partial(-1);
+        pointPrices[ pointNumber2 ] = pointNumber2 * ( double( 10 ) / double( aNumPoints - 1 ) );
+    }
+    vector<LogEDFun::SweepPoint> sweep;
+    F.partialSweep( mMarketNumber, x, pointPrices, sweep );
+
+    for( size_t pointNumber2 = 0; pointNumber2 < sweep.size(); ++pointNumber2 ) {
+        mPoints.push_back( new SupplyDemandPoint( sweep[ pointNumber2 ].price,
+                                                  sweep[ pointNumber2 ].demand,
+                                                  sweep[ pointNumber2 ].supply,
+                                                  sweep[ pointNumber2 ].fx ) );
+    }
 }
 
 /*! \brief Print the supply demand curve.
@@ -40,6 +40,7 @@
 
 #include "util/base/include/definitions.h"
 #include <iostream>
+#include <fstream>
 #include "util/base/include/timer.h"
 
 using namespace std;
@@ -49,6 +50,14 @@ using namespace boost::posix_time;
 Timer::Timer():mTotalTime( 0 ),
 mRunning( 0 )
 {
+#if GCAM_TRACK_ALLOCATIONS
+    mStartAllocations.mAllocations = mStartAllocations.mBytes = 0;
+    mAllocations.mAllocations = mAllocations.mBytes = 0;
+#endif
+#if GCAM_USE_PERF_COUNTERS
+    mStartCounters.mCycles = mStartCounters.mInstructions = mStartCounters.mCacheMisses = mStartCounters.mBranchMisses = 0;
+    mCounters = mStartCounters;
+#endif
 }
 
 /*! \brief Start the timer.
@@ -62,6 +71,12 @@ void Timer::start(){
 #endif
     if( ++mRunning == 1 ) {
         mStartTime = microsec_clock::universal_time();
+#if GCAM_TRACK_ALLOCATIONS
+        mStartAllocations = AllocationTracker::getTotalCounts();
+#endif
+#if GCAM_USE_PERF_COUNTERS
+        mStartCounters = HardwareCounters::read();
+#endif
     }
 }
 
@@ -78,6 +93,14 @@ void Timer::stop(){
     if( --mRunning == 0 ) {
         time_duration diff = microsec_clock::universal_time() - mStartTime;
         mTotalTime += diff.total_seconds() + pow( 10.0, -time_duration::num_fractional_digits() ) * diff.fractional_seconds();
+#if GCAM_TRACK_ALLOCATIONS
+        const AllocationTracker::Counts currAllocations = AllocationTracker::getTotalCounts();
+        mAllocations.mAllocations += currAllocations.mAllocations - mStartAllocations.mAllocations;
+        mAllocations.mBytes += currAllocations.mBytes - mStartAllocations.mBytes;
+#endif
+#if GCAM_USE_PERF_COUNTERS
+        HardwareCounters::accumulate( mCounters, mStartCounters, HardwareCounters::read() );
+#endif
     }
     // guard against excessive stops
     mRunning = std::max( mRunning, 0 );
@@ -91,6 +114,27 @@ double Timer::getTotalTimeDifference() const {
     return mTotalTime;
 }
 
+#if GCAM_TRACK_ALLOCATIONS
+/*!
+ * \brief Get the allocations made between all starts and stops.
+ * \return The allocations measured by this timer.
+ */
+const AllocationTracker::Counts& Timer::getAllocations() const {
+    return mAllocations;
+}
+#endif
+
+#if GCAM_USE_PERF_COUNTERS
+/*!
+ * \brief Get the hardware counts of the threads which started the timer
+ *        between all starts and stops.
+ * \return The hardware counts measured by this timer.
+ */
+const HardwareCounters::Counts& Timer::getCounters() const {
+    return mCounters;
+}
+#endif
+
 /*! \brief Print the accumulated time.
  * \details This function prints the accumulated time on the timer.
  *          It *can* be called on a running timer to print a split.
@@ -110,6 +154,15 @@ void Timer::print( std::ostream& aOut, const string& aLabel ) const {
         
     if( tottime > 0 ) {
         aOut << aLabel << " " << tottime << " seconds. " << endl;
+#if GCAM_TRACK_ALLOCATIONS
+        aOut << aLabel << " " << mAllocations.mAllocations << " allocations, "
+             << mAllocations.mBytes << " bytes." << endl;
+#endif
+#if GCAM_USE_PERF_COUNTERS
+        aOut << aLabel << " " << mCounters.mCycles << " cycles, " << mCounters.mInstructions
+             << " instructions, " << mCounters.mCacheMisses << " cache misses, "
+             << mCounters.mBranchMisses << " branch misses." << endl;
+#endif
     }
 }
 
@@ -155,57 +208,110 @@ Timer& TimerRegistry::getTimer( const string& aTimerName ) {
     return mNamedTimers[ aTimerName ];
 }
 
+namespace {
+    /*!
+     * \brief Get the label to use for a predefined timer.
+     * \param aTimer The predefined timer.
+     * \return The label of the timer.
+     */
+    const char* getPredefinedTimerName( const int aTimer ) {
+        switch( aTimer ) {
+            case TimerRegistry::FULLSCENARIO:
+                return "Full Scenario";
+            case TimerRegistry::BISECT:
+                return "Bisection solver";
+            case TimerRegistry::SOLVER:
+                return "Broyden Solver";
+            case TimerRegistry::JACOBIAN:
+                return "Jacobian calcs";
+            case TimerRegistry::EVAL_PART:
+                return "Partial function evaluations";
+            case TimerRegistry::EVAL_FULL:
+                return "Full function evaluations";
+            case TimerRegistry::JAC_PRE:
+                return "Jacobian Preconditioner (overlaps with Jacobian)";
+            case TimerRegistry::JAC_PRE_JAC:
+                return "Jacobian Preconditioner Jacobian overlap";
+            case TimerRegistry::EDFUN_MISC:
+                return "EDFUN miscellaneous";
+            case TimerRegistry::EDFUN_PRE:
+                return "EDFUN before world->calc";
+            case TimerRegistry::EDFUN_POST:
+                return "EDFUN after world->calc";
+            case TimerRegistry::EDFUN_AN_RESET:
+                return "EDFUN affected nodes reset";
+            default: return "Predefined timer";
+        }
+    }
+
+    /*!
+     * \brief Write a single timer as a JSON object.
+     * \param aOut The stream to write to.
+     * \param aName The name of the timer which will be escaped.
+     * \param aTimer The timer.
+     */
+    void writeTimerJSON( ostream& aOut, const string& aName, const Timer& aTimer ) {
+        string name;
+        for( string::const_iterator c = aName.begin(); c != aName.end(); ++c ) {
+            if( *c == '"' || *c == '\\' ) {
+                name += '\\';
+            }
+            name += *c;
+        }
+        aOut << "  { \"timer\": \"" << name << "\", \"seconds\": " << aTimer.getTotalTimeDifference();
+#if GCAM_TRACK_ALLOCATIONS
+        aOut << ", \"allocations\": " << aTimer.getAllocations().mAllocations
+             << ", \"bytes\": " << aTimer.getAllocations().mBytes;
+#endif
+#if GCAM_USE_PERF_COUNTERS
+        aOut << ", \"cycles\": " << aTimer.getCounters().mCycles
+             << ", \"instructions\": " << aTimer.getCounters().mInstructions
+             << ", \"cache-misses\": " << aTimer.getCounters().mCacheMisses
+             << ", \"branch-misses\": " << aTimer.getCounters().mBranchMisses;
+#endif
+        aOut << " }";
+    }
+}
+
 /*!
  * \brief Have all registered timers print their current times using their names
  *        as a label.
  */
 void TimerRegistry::printAllTimers( ostream& aOut ) const {
     for( int timer = 0; timer < END; ++timer ) {
-        string timerName;
-        switch( timer ) {
-            case FULLSCENARIO:
-                timerName = "Full Scenario";
-                break;
-            case BISECT:
-                timerName = "Bisection solver";
-                break;
-            case SOLVER:
-                timerName = "Broyden Solver";
-                break;
-            case JACOBIAN:
-                timerName = "Jacobian calcs";
-                break;
-            case EVAL_PART:
-                timerName = "Partial function evaluations";
-                break;
-            case EVAL_FULL:
-                timerName = "Full function evaluations";
-                break;
-            case JAC_PRE:
-                timerName = "Jacobian Preconditioner (overlaps with Jacobian)";
-                break;
-            case JAC_PRE_JAC:
-                timerName = "Jacobian Preconditioner Jacobian overlap";
-                break;
-            case EDFUN_MISC:
-                timerName = "EDFUN miscellaneous";
-                break;
-            case EDFUN_PRE:
-                timerName = "EDFUN before world->calc";
-                break;
-            case EDFUN_POST:
-                timerName = "EDFUN after world->calc";
-                break;
-            case EDFUN_AN_RESET:
-                timerName = "EDFUN affected nodes reset";
-                break;
-                
-            default: timerName = "Predefined timer";
-        }
-        mPredefinedTimers[ timer ].print( aOut, timerName );
+        mPredefinedTimers[ timer ].print( aOut, getPredefinedTimerName( timer ) );
     }
     
     for( map<string, Timer>::const_iterator it = mNamedTimers.begin(); it != mNamedTimers.end(); ++it ) {
         (*it).second.print( aOut, (*it).first );
     }
 }
+
+/*!
+ * \brief Write the total time of every timer which has run to a JSON file.
+ * \details The file contains an array with an object for each timer, giving
+ *          its name and total seconds, so that scripts can compare runs.
+ * \param aFileName The name of the file to write.
+ * \return Whether the file was written.
+ */
+bool TimerRegistry::writeJSON( const string& aFileName ) const {
+    ofstream out( aFileName.c_str() );
+    out << "[";
+    bool isFirst = true;
+    for( int timer = 0; timer < END; ++timer ) {
+        if( mPredefinedTimers[ timer ].getTotalTimeDifference() > 0 ) {
+            out << ( isFirst ? "" : "," ) << endl;
+            writeTimerJSON( out, getPredefinedTimerName( timer ), mPredefinedTimers[ timer ] );
+            isFirst = false;
+        }
+    }
+    for( map<string, Timer>::const_iterator it = mNamedTimers.begin(); it != mNamedTimers.end(); ++it ) {
+        if( (*it).second.getTotalTimeDifference() > 0 ) {
+            out << ( isFirst ? "" : "," ) << endl;
+            writeTimerJSON( out, (*it).first, (*it).second );
+            isFirst = false;
+        }
+    }
+    out << endl << "]" << endl;
+    return static_cast<bool>( out );
+}
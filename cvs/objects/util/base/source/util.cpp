@@ -41,9 +41,12 @@
 #include "util/base/include/definitions.h"
 #include "util/base/include/util.h"
 #include "containers/include/scenario.h"
+#include "util/base/include/configuration.h"
 
 #include <string>
 #include <ctime>
+#include <set>
+#include <boost/algorithm/string.hpp>
 
 using namespace std;
 
@@ -118,6 +121,56 @@ namespace objects {
         return result;
     }
 
+    /*!
+     * \brief Check whether the debugging output should include a region.
+     * \details The regions are the semicolon separated list in the
+     *          debug-regions configuration string, or if that is not set the
+     *          single debug-region which defaults to USA.
+     * \param aRegionName The name of the region.
+     * \return Whether the region is written to the debugging output.
+     */
+    bool isDebugRegion( const string& aRegionName ) {
+        const static set<string> debugRegions = [] {
+            const Configuration* conf = Configuration::getInstance();
+            string regions = conf->getString( "debug-regions", "", false );
+            if( regions.empty() ) {
+                regions = conf->getString( "debug-region", "USA" );
+            }
+            vector<string> names;
+            boost::split( names, regions, boost::is_any_of( ";" ), boost::token_compress_on );
+            set<string> result;
+            for( vector<string>::const_iterator it = names.begin(); it != names.end(); ++it ) {
+                result.insert( boost::trim_copy( *it ) );
+            }
+            return result;
+        }();
+        return debugRegions.find( aRegionName ) != debugRegions.end();
+    }
+
+    /*!
+     * \brief Check whether the debugging output should be written for a year.
+     * \details The years are the semicolon separated list in the debug-years
+     *          configuration string.  If it is not set every year is written.
+     * \param aYear The model year.
+     * \return Whether the year is written to the debugging output.
+     */
+    bool isDebugYear( const int aYear ) {
+        const static set<int> debugYears = [] {
+            const string years = Configuration::getInstance()->getString( "debug-years", "", false );
+            vector<string> values;
+            boost::split( values, years, boost::is_any_of( ";" ), boost::token_compress_on );
+            set<int> result;
+            for( vector<string>::const_iterator it = values.begin(); it != values.end(); ++it ) {
+                const string year = boost::trim_copy( *it );
+                if( !year.empty() ) {
+                    result.insert( boost::lexical_cast<int>( year ) );
+                }
+            }
+            return result;
+        }();
+        return debugYears.empty() || debugYears.find( aYear ) != debugYears.end();
+    }
+
     /*! \brief Create a Minicam style run identifier.
     * \details Creates a run identifier by combining the current date and time,
     *          including the number of seconds so that is is always unique.
@@ -0,0 +1,285 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+/*! 
+* \file xml_stream_parser.cpp
+* \ingroup Objects
+* \brief XMLStreamParser class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <memory>
+#include <xercesc/util/PlatformUtils.hpp>
+#include <xercesc/util/XMLString.hpp>
+#include <xercesc/util/XMLUni.hpp>
+#include <xercesc/dom/DOMImplementation.hpp>
+#include <xercesc/dom/DOMImplementationRegistry.hpp>
+#include <xercesc/dom/DOMElement.hpp>
+#include <xercesc/dom/DOMText.hpp>
+#include <xercesc/dom/DOMException.hpp>
+#include <xercesc/sax2/SAX2XMLReader.hpp>
+#include <xercesc/sax2/XMLReaderFactory.hpp>
+#include <xercesc/sax2/Attributes.hpp>
+
+#include "util/base/include/xml_stream_parser.h"
+#include "util/base/include/compressed_input_source.h"
+#include "util/base/include/xml_helper.h"
+#include "util/base/include/iparsable.h"
+#include "util/base/include/configuration.h"
+#include "util/logger/include/ilogger.h"
+
+using namespace std;
+using namespace xercesc;
+
+/*!
+ * \brief Parse a scenario input file, streaming it if configured to.
+ * \details This is a drop in replacement for XMLHelper::parseXML for files
+ *          whose root is parsed by the Scenario.
+ * \param aXMLFile The name of the file to parse.
+ * \param aModelElement Element to call XMLParse on.
+ * \return Whether parsing was successful.
+ */
+bool XMLStreamParser::parseInput( const string& aXMLFile, IParsable* aModelElement ) {
+    const Configuration* conf = Configuration::getInstance();
+    if( !conf->getBool( "stream-xml-input", false ) ) {
+        return XMLHelper<void>::parseXML( aXMLFile, aModelElement );
+    }
+    return parseXML( aXMLFile, aModelElement, conf->getInt( "xml-stream-chunk-depth", 2 ) );
+}
+
+/*!
+ * \brief Parse an XML file a chunk at a time.
+ * \details Unlike XMLHelper::parseXML an error later in the file is only found
+ *          once the chunks before it have already been parsed into the model.
+ * \param aXMLFile The name of the file to parse.
+ * \param aModelElement Element to call XMLParse on for each chunk.
+ * \param aChunkDepth The depth of the elements to parse one at a time.
+ * \return Whether parsing was successful.
+ */
+bool XMLStreamParser::parseXML( const string& aXMLFile, IParsable* aModelElement, const int aChunkDepth ) {
+    // The platform is reference counted so this is safe to do even though it
+    // has already been initialized for the DOM parser.
+    XMLPlatformUtils::Initialize();
+    bool success = false;
+    {
+        auto_ptr<SAX2XMLReader> reader( XMLReaderFactory::createXMLReader() );
+        // Match the settings of the DOM parser.
+        reader->setFeature( XMLUni::fgSAX2CoreNameSpaces, false );
+        reader->setFeature( XMLUni::fgSAX2CoreValidation, true );
+        reader->setFeature( XMLUni::fgXercesDynamic, false );
+        reader->setFeature( XMLUni::fgXercesSchema, true );
+
+        XMLStreamParser handler( aXMLFile, aModelElement, aChunkDepth );
+        reader->setContentHandler( &handler );
+        reader->setErrorHandler( &handler );
+        try {
+            if( CompressedInputSource::isCompressed( aXMLFile ) ) {
+                CompressedInputSource source( aXMLFile );
+                reader->parse( source );
+            }
+            else {
+                reader->parse( aXMLFile.c_str() );
+            }
+            success = handler.mSuccess;
+        } catch ( const XMLException& toCatch ) {
+            string message = XMLHelper<string>::safeTranscode( toCatch.getMessage() );
+            cout << "ERROR: XML Read Exception message is:" << endl << message << endl;
+        } catch ( const DOMException& toCatch ) {
+            string message = XMLHelper<string>::safeTranscode( toCatch.msg );
+            cout << "ERROR: XML Read Exception message is:" << endl << message << endl;
+        } catch ( const SAXException& toCatch ){
+            string message = XMLHelper<string>::safeTranscode( toCatch.getMessage() );
+            cout << "ERROR: XML Read Exception message is:" << endl << message << endl;
+        } catch (...) {
+            cout << "ERROR:Unexpected XML Read Exception." << endl;
+        }
+
+        ILogger& mainLog = ILogger::getLogger( "main_log" );
+        mainLog.setLevel( ILogger::DEBUG );
+        mainLog << "Streamed " << aXMLFile << " in " << handler.mNumChunks << " chunks." << endl;
+    }
+    XMLPlatformUtils::Terminate();
+    return success;
+}
+
+/*!
+ * \brief Constructor.
+ * \param aXMLFile The name of the file being parsed.
+ * \param aModelElement Element to call XMLParse on for each chunk.
+ * \param aChunkDepth The depth of the elements to parse one at a time.
+ */
+XMLStreamParser::XMLStreamParser( const string& aXMLFile, IParsable* aModelElement, const int aChunkDepth )
+:mModelElement( aModelElement ),
+mChunkDepth( aChunkDepth ),
+mWholeDepth( -1 ),
+mSuccess( true ),
+mNumChunks( 0 )
+{
+    XMLCh* features = XMLString::transcode( "Core" );
+    mDocument = DOMImplementationRegistry::getDOMImplementation( features )->createDocument();
+    XMLString::release( &features );
+
+    // The file name is used by XMLHelper::printXMLTrace.
+    XMLCh* fileName = XMLString::transcode( aXMLFile.c_str() );
+    mDocument->setDocumentURI( fileName );
+    XMLString::release( &fileName );
+    mCurrent = mDocument;
+}
+
+//! Destructor
+XMLStreamParser::~XMLStreamParser() {
+    mDocument->release();
+}
+
+/*!
+ * \brief Add a new element to the chunk being built.
+ * \param aURI Unused.
+ * \param aLocalName Unused.
+ * \param aQName The element name.
+ * \param aAttrs The attributes of the element.
+ */
+void XMLStreamParser::startElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                                    const XMLCh* const aQName, const Attributes& aAttrs )
+{
+    DOMElement* element = beginElement( aQName );
+    for( XMLSize_t attrIndex = 0; attrIndex < aAttrs.getLength(); ++attrIndex ) {
+        addAttribute( element, aAttrs.getQName( attrIndex ), aAttrs.getValue( attrIndex ) );
+    }
+}
+
+/*!
+ * \brief Create a new element as a child of the current element and make it
+ *        the current element.
+ * \param aName The element name.
+ * \return The new element to which attributes may be added.
+ */
+DOMElement* XMLStreamParser::beginElement( const XMLCh* aName ) {
+    DOMElement* element = mDocument->createElement( aName );
+    mCurrent->appendChild( element );
+    mCurrent = element;
+    mIsSplit.push_back( false );
+    return element;
+}
+
+/*!
+ * \brief Add an attribute to the element just begun.
+ * \details A delete attribute above the chunk depth causes the element to be
+ *          kept whole.
+ * \param aElement The element returned by beginElement.
+ * \param aName The attribute name.
+ * \param aValue The attribute value.
+ */
+void XMLStreamParser::addAttribute( DOMElement* aElement, const XMLCh* aName, const XMLCh* aValue ) {
+    aElement->setAttribute( aName, aValue );
+    const int depth = mIsSplit.size() - 1;
+    if( mWholeDepth < 0 && depth < mChunkDepth && XMLHelper<string>::safeTranscode( aName ) == "delete" ) {
+        mWholeDepth = depth;
+    }
+}
+
+/*!
+ * \brief Finish an element, parsing it if it completes a chunk.
+ * \param aURI Unused.
+ * \param aLocalName Unused.
+ * \param aQName Unused.
+ */
+void XMLStreamParser::endElement( const XMLCh* const aURI, const XMLCh* const aLocalName,
+                                  const XMLCh* const aQName )
+{
+    const int depth = mIsSplit.size() - 1;
+    const bool isSplit = mIsSplit.back();
+    mIsSplit.pop_back();
+    DOMNode* element = mCurrent;
+    mCurrent = element->getParentNode();
+
+    // Elements below the chunk depth are simply left in the tree.
+    if( depth > mChunkDepth || ( mWholeDepth >= 0 && depth > mWholeDepth ) ) {
+        return;
+    }
+    if( depth == mWholeDepth ) {
+        mWholeDepth = -1;
+    }
+
+    // If nothing has been parsed from within this element then the element
+    // is complete and must be parsed itself.  Otherwise it was only kept as an
+    // ancestor to the chunks.
+    if( !isSplit ) {
+        dispatchChunk( element );
+    }
+    if( depth > 0 ) {
+        mCurrent->removeChild( element )->release();
+        mIsSplit.back() = true;
+    }
+}
+
+/*!
+ * \brief Add text to the current element.
+ * \details Text which arrives in pieces is merged into a single node as
+ *          XMLHelper::getValue only reads the first child.
+ * \param aChars The text.
+ * \param aLength The length of the text.
+ */
+void XMLStreamParser::characters( const XMLCh* const aChars, const XMLSize_t aLength ) {
+    if( mCurrent == mDocument ) {
+        return;
+    }
+    const basic_string<XMLCh> text( aChars, aLength );
+    DOMNode* last = mCurrent->getLastChild();
+    if( last && last->getNodeType() == DOMNode::TEXT_NODE ) {
+        static_cast<DOMText*>( last )->appendData( text.c_str() );
+    }
+    else {
+        mCurrent->appendChild( mDocument->createTextNode( text.c_str() ) );
+    }
+}
+
+/*!
+ * \brief Parse the current tree which ends with the given chunk.
+ * \details Text in the ancestors of the chunk, which is only whitespace
+ *          between the chunks, is dropped first so that it does not build up.
+ * \param aChunk The element which completes the chunk.
+ */
+void XMLStreamParser::dispatchChunk( DOMNode* aChunk ) {
+    for( DOMNode* ancestor = aChunk->getParentNode(); ancestor != mDocument; ancestor = ancestor->getParentNode() ) {
+        DOMNode* child = ancestor->getFirstChild();
+        while( child ) {
+            DOMNode* next = child->getNextSibling();
+            if( child->getNodeType() == DOMNode::TEXT_NODE ) {
+                ancestor->removeChild( child )->release();
+            }
+            child = next;
+        }
+    }
+    ++mNumChunks;
+    mSuccess &= mModelElement->XMLParse( mDocument->getDocumentElement() );
+}
@@ -0,0 +1,201 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file xml_write_buffer.cpp
+* \ingroup Objects
+* \brief XMLWriteBuffer class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <cstdio>
+#include <cstdlib>
+
+#include "util/base/include/xml_write_buffer.h"
+
+using namespace std;
+
+namespace {
+    /*!
+     * \brief Whether the stream formats numbers in the default way so that
+     *        they may be formatted without it.
+     * \param aOut The stream.
+     * \return Whether the stream uses default number formatting.
+     */
+    bool hasDefaultFormat( const ostream& aOut ) {
+        const ios_base::fmtflags special = ios_base::floatfield | ios_base::showpoint | ios_base::showpos
+            | ios_base::uppercase | ( ios_base::basefield & ~ios_base::dec ) | ios_base::boolalpha;
+        return ( aOut.flags() & special ) == 0 && aOut.width() == 0;
+    }
+}
+
+/*!
+ * \brief Get the buffer for the calling thread, cleared and ready for a new
+ *        element.
+ * \return The buffer.
+ */
+string& XMLWriteBuffer::start() {
+    static thread_local string buffer;
+    buffer.clear();
+    return buffer;
+}
+
+/*!
+ * \brief Write the buffer to the stream and clear it.
+ * \param aBuffer The element buffer.
+ * \param aOut The stream to write to.
+ */
+void XMLWriteBuffer::write( string& aBuffer, ostream& aOut ) {
+    aOut.write( aBuffer.data(), aBuffer.size() );
+    aBuffer.clear();
+}
+
+/*!
+ * \brief Append a double formatted as the stream would.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+void XMLWriteBuffer::appendValue( string& aBuffer, const double aValue, ostream& aOut ) {
+    if( !hasDefaultFormat( aOut ) ) {
+        write( aBuffer, aOut );
+        aOut << aValue;
+        return;
+    }
+    char number[ 32 ];
+    const int precision = static_cast<int>( aOut.precision() );
+    const int length = precision >= FULL_PRECISION ? formatRoundTrip( aValue, number )
+                       : snprintf( number, sizeof( number ), "%.*g", precision, aValue );
+    aBuffer.append( number, length );
+}
+
+/*!
+ * \brief Append an integer.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+void XMLWriteBuffer::appendValue( string& aBuffer, const int aValue, ostream& aOut ) {
+    if( !hasDefaultFormat( aOut ) ) {
+        write( aBuffer, aOut );
+        aOut << aValue;
+        return;
+    }
+    // Fill in the digits backwards, using an unsigned value so that the most
+    // negative int does not overflow.
+    char digits[ 12 ];
+    char* curr = digits + sizeof( digits );
+    unsigned int magnitude = aValue < 0 ? 0u - static_cast<unsigned int>( aValue ) : aValue;
+    do {
+        *--curr = static_cast<char>( '0' + magnitude % 10 );
+        magnitude /= 10;
+    } while( magnitude );
+    if( aValue < 0 ) {
+        *--curr = '-';
+    }
+    aBuffer.append( curr, digits + sizeof( digits ) - curr );
+}
+
+/*!
+ * \brief Append a boolean as 1 or 0.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+void XMLWriteBuffer::appendValue( string& aBuffer, const bool aValue, ostream& aOut ) {
+    if( !hasDefaultFormat( aOut ) ) {
+        write( aBuffer, aOut );
+        aOut << aValue;
+        return;
+    }
+    aBuffer += aValue ? '1' : '0';
+}
+
+/*!
+ * \brief Append a string.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+void XMLWriteBuffer::appendValue( string& aBuffer, const string& aValue, ostream& aOut ) {
+    if( aOut.width() != 0 ) {
+        write( aBuffer, aOut );
+        aOut << aValue;
+        return;
+    }
+    aBuffer += aValue;
+}
+
+/*!
+ * \brief Append a C string.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+void XMLWriteBuffer::appendValue( string& aBuffer, const char* aValue, ostream& aOut ) {
+    if( aOut.width() != 0 ) {
+        write( aBuffer, aOut );
+        aOut << aValue;
+        return;
+    }
+    aBuffer += aValue;
+}
+
+/*!
+ * \brief Append a Value which prints as its double.
+ * \param aBuffer The element buffer.
+ * \param aValue The value to write.
+ * \param aOut The stream the element is written to.
+ */
+void XMLWriteBuffer::appendValue( string& aBuffer, const Value& aValue, ostream& aOut ) {
+    appendValue( aBuffer, static_cast<double>( aValue ), aOut );
+}
+
+/*!
+ * \brief Format a double with the fewest of 15, 16 or 17 significant digits
+ *        which read back as the same value.
+ * \details Fifteen digits are enough for any decimal which was read from the
+ *          input files and seventeen for any double at all.
+ * \param aValue The value to format.
+ * \param aString A buffer of at least 32 chars to format into.
+ * \return The length of the formatted value.
+ */
+int XMLWriteBuffer::formatRoundTrip( const double aValue, char* aString ) {
+    for( int precision = 15; precision < FULL_PRECISION; ++precision ) {
+        const int length = snprintf( aString, 32, "%.*g", precision, aValue );
+        // A NaN never compares equal so stop at once.
+        if( strtod( aString, 0 ) == aValue || aValue != aValue ) {
+            return length;
+        }
+    }
+    return snprintf( aString, 32, "%.*g", FULL_PRECISION, aValue );
+}
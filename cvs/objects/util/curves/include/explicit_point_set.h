@@ -52,6 +52,7 @@
 #include <cfloat>
 #include <xercesc/dom/DOMNode.hpp>
 #include "util/curves/include/point_set.h"
+#include "util/curves/include/piecewise_linear_function.h"
 
 class Tabs;
 class DataPoint;
@@ -95,6 +96,7 @@ public:
     void toInputXML( std::ostream& out, Tabs* tabs ) const;
     void XMLParse( const xercesc::DOMNode* node );
     void invertAxises();
+    const PiecewiseLinearFunction& getPiecewiseLinearFunction() const;
 protected:
     
     // Define data such that introspection utilities can process the data from this
@@ -105,11 +107,16 @@ protected:
         DEFINE_VARIABLE( ARRAY, "points", points, std::vector<DataPoint*> )
     )
 
+    //! The points sorted by x value in contiguous storage which is kept up
+    //! to date as the points are changed.
+    PiecewiseLinearFunction mSortedPoints;
+
     typedef std::vector<DataPoint*>::iterator DataPointIterator;
     typedef std::vector<DataPoint*>::const_iterator DataPointConstIterator;
 	const std::string& getXMLName() const;
 	void copy( const ExplicitPointSet& rhs );
     void clear();
+    void updateSortedPoints();
 	const DataPoint* findX( const double xValue ) const;
     DataPoint* findX( const double xValue );
     const DataPoint* findY( const double yValue ) const;
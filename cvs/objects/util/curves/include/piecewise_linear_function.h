@@ -0,0 +1,86 @@
+#ifndef _PIECEWISE_LINEAR_FUNCTION_H_
+#define _PIECEWISE_LINEAR_FUNCTION_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file piecewise_linear_function.h
+* \ingroup Util
+* \brief The PiecewiseLinearFunction class header file.
+*/
+
+#include <vector>
+#include <cstddef>
+
+/*!
+* \ingroup Util
+* \brief A function which linearly interpolates between a set of points sorted
+*        by x value and stored contiguously.
+* \details This is the evaluation used by PointSetCurve::getY.  A value at the
+*          x value of a point is the y value of that point, a value between two
+*          points is interpolated linearly and a value beyond the first or last
+*          point is extrapolated linearly from the first or last two points.  If
+*          there is only a single point its y value is returned everywhere and
+*          if there are none -DBL_MAX is returned.  Only the first of several
+*          points with the same x value is kept.
+*
+*          Finding the bracketing points is a binary search.  Evaluating many
+*          x values at once with the batch version of getY is cheaper still
+*          when they are in increasing order as the search then continues from
+*          the previous bracket.
+*/
+class PiecewiseLinearFunction {
+public:
+    void setPoints( const std::vector<std::pair<double, double> >& aPoints );
+
+    double getY( const double aXValue ) const;
+
+    void getY( const std::vector<double>& aXValues, std::vector<double>& aYValues ) const;
+
+    size_t size() const;
+private:
+    //! The x values of the points in increasing order.
+    std::vector<double> mX;
+
+    //! The y values of the points in the same order as mX.
+    std::vector<double> mY;
+
+    size_t findSegment( const double aXValue ) const;
+
+    double evaluate( const double aXValue, const size_t aSegment ) const;
+};
+
+#endif // _PIECEWISE_LINEAR_FUNCTION_H_
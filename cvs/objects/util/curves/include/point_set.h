@@ -57,6 +57,7 @@
 
 class Tabs;
 class DataPoint;
+class PiecewiseLinearFunction;
 
 // Need to forward declare the subclasses as well.
 class ExplicitPointSet;
@@ -102,6 +103,7 @@ public:
     virtual double getNearestYAbove( const double x ) const = 0;
     virtual void toInputXML( std::ostream& out, Tabs* tabs ) const = 0;
     virtual void invertAxises() = 0;
+    virtual const PiecewiseLinearFunction& getPiecewiseLinearFunction() const = 0;
 protected:
     
     DEFINE_DATA(
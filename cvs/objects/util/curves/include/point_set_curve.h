@@ -76,6 +76,7 @@ public:
     void toInputXMLDerived( std::ostream& out, Tabs* tabs ) const;
     bool XMLParseDerived( const xercesc::DOMNode* node );
     double getY( const double xValue ) const;
+    void getY( const std::vector<double>& aXValues, std::vector<double>& aYValues ) const;
     double getX( const double yValue ) const;
     bool setY( const double xValue, const double yValue );
     bool setX( const double yValue, const double xValue );
@@ -39,6 +39,7 @@
 
 #include <vector>
 #include <string>
+#include <boost/shared_ptr.hpp>
 
 /*!
  * \file spline.hpp
@@ -69,7 +70,16 @@
  *                         fitting procedures to compute an
  *                         interpolated y-value for an input x.  For
  *                         convenience, this function is aliased to
- *                         operator(). 
+ *                         operator().  Versions are provided which
+ *                         evaluate a sorted vector of inputs, or
+ *                         start the search for the interval from a
+ *                         caller-held hint, without a bisection
+ *                         search per input.
+ *
+ *          The fitted table is never modified once made, so copies of
+ *          a spline share it.  Objects which use the same tabulated
+ *          data should fit a spline once and copy it rather than
+ *          refitting it.
  * \note In theory one might want to fit a "mixed" spline; i.e., one
  *       with a natural boundary condition at one end and a specified
  *       derivative at the other.  It wouldn't be too hard to add a
@@ -77,19 +87,24 @@
  *       seems unlikely to crop up in GCAM.
  */
 class Spline {
-    //! tabulated x values
-    std::vector<double> x;
-    //! tabulated y values
-    std::vector<double> y;
-    //! y'' values (computed in fit()
-    std::vector<double> ypp;
-
+    //! The tabulated values and the y'' values computed by a fit.
+    struct Table {
+        //! tabulated x values
+        std::vector<double> x;
+        //! tabulated y values
+        std::vector<double> y;
+        //! y'' values (computed in fit_internal)
+        std::vector<double> ypp;
+    };
+    //! The fitted table, shared by copies of this spline.
+    boost::shared_ptr<const Table> mTable;
     //! portion of the fitting procedure that is common to natural and
     //  boundary fits.
-    void fit_internal(std::vector<double> &u);
+    static void fit_internal(Table &t, std::vector<double> &u);
+    //! evaluate the spline in the interval starting at ilo
+    double eval_interval(int ilo, double ax) const;
     //! write an error to main_log and abort
     void log_and_abort(const std::string &msg) const;
-
 public:
     //! Default constructor does nothing
     Spline() {}
@@ -97,11 +112,12 @@ public:
     Spline(const std::vector<double> &ax, const std::vector<double> &ay);
     //! Constructor with input table (boundary spline)
     Spline(const std::vector<double> &ax, const std::vector<double> &ay, double yp0, double ypn);
-
     void fit_natural(const std::vector<double> &ax, const std::vector<double> &ay);
     void fit_boundary(const std::vector<double> &ax, const std::vector<double> &ay,
                       double yp0, double ypn);
     double interpolate(double ax) const;
+    double interpolate(double ax, int &ailo) const;
+    void interpolate(const std::vector<double> &ax, std::vector<double> &ay) const;
     //! alias for interpolate
     double operator()(double ax) const {return interpolate(ax);}
     //! minimum allowable x-value
@@ -109,10 +125,9 @@ public:
     //! maximum allowable x-value
     double xmax(void) const;
     //! indicate whether or not the spline is valid
-    bool isValid(void) const {return x.size() >= 2;}
+    bool isValid(void) const {return mTable && mTable->x.size() >= 2;}
     //! clear the fitted values.  After this the spline will be invalid
-    void clear(void) {x.clear(); y.clear(); ypp.clear();}
+    void clear(void) {mTable.reset();}
 };
 
-
 #endif
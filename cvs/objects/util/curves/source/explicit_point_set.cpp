@@ -83,6 +83,8 @@ void ExplicitPointSet::clear() {
     for( DataPointIterator delIter = points.begin(); delIter != points.end(); ++delIter ){
         delete *delIter;
     }
+    points.clear();
+    updateSortedPoints();
 }
 
 //! Helper function which copies into a new object.
@@ -91,6 +93,7 @@ void ExplicitPointSet::copy( const ExplicitPointSet& rhs ){
     for( unsigned int i = 0; i < rhs.points.size(); ++i ){
         points.push_back( rhs.points[ i ]->clone() );
     }
+    updateSortedPoints();
 }
 
 //! Static function to return the name of the XML element associated with this object.
@@ -117,6 +120,7 @@ bool ExplicitPointSet::addPoint( DataPoint* pointIn ) {
     
     if( !foundPoint ){
         points.push_back( pointIn );
+        updateSortedPoints();
     }
     
     return !foundPoint;
@@ -140,6 +144,7 @@ bool ExplicitPointSet::setY( const double xValue, const double yValue ){
     // If the point was found.
     if( point ){
         point->setY( yValue );
+        updateSortedPoints();
     }
     return ( point != 0 );
 }
@@ -150,6 +155,7 @@ bool ExplicitPointSet::setX( const double yValue, const double xValue ){
     // If the point was found.
     if( point ){
         point->setX( xValue );
+        updateSortedPoints();
     }
     return ( point != 0 );
 }
@@ -162,6 +168,7 @@ bool ExplicitPointSet::removePointFindX( const double xValue ){
 		assert( delIter != points.end() );
 		delete point;
 		points.erase( delIter );
+        updateSortedPoints();
     }
 
     return ( point != 0 );
@@ -175,6 +182,7 @@ bool ExplicitPointSet::removePointFindY( const double yValue ){
         assert( delIter != points.end() );
 		delete point;
 		points.erase( delIter );
+        updateSortedPoints();
     }
 
     return ( point != 0 );
@@ -359,6 +367,24 @@ void ExplicitPointSet::invertAxises(){
     for( DataPointIterator pointsIter = points.begin(); pointsIter != points.end(); pointsIter++ ){
         ( *pointsIter )->invertAxises();
     }
+    updateSortedPoints();
+}
+
+/*! \brief Get the points as a function sorted by x value for fast evaluation.
+* \return The sorted points.
+*/
+const PiecewiseLinearFunction& ExplicitPointSet::getPiecewiseLinearFunction() const {
+    return mSortedPoints;
+}
+
+//! Helper function which copies the points into mSortedPoints after a change.
+void ExplicitPointSet::updateSortedPoints() {
+    vector<pair<double, double> > xyPoints;
+    xyPoints.reserve( points.size() );
+    for( DataPointConstIterator pointsIter = points.begin(); pointsIter != points.end(); ++pointsIter ){
+        xyPoints.push_back( make_pair( ( *pointsIter )->getX(), ( *pointsIter )->getY() ) );
+    }
+    mSortedPoints.setPoints( xyPoints );
 }
 
 //! Const helper function which returns the point with a given x value.
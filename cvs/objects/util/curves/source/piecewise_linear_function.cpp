@@ -0,0 +1,164 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+/*! 
+* \file piecewise_linear_function.cpp
+* \ingroup Util
+* \brief PiecewiseLinearFunction class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <vector>
+#include <algorithm>
+#include <cfloat>
+#include <cassert>
+
+#include "util/curves/include/piecewise_linear_function.h"
+#include "util/base/include/util.h"
+
+using namespace std;
+
+namespace {
+    //! Order points by their x values.
+    bool lesserX( const pair<double, double>& aLeft, const pair<double, double>& aRight ) {
+        return aLeft.first < aRight.first;
+    }
+}
+
+/*!
+* \brief Set the points of the function.
+* \param aPoints The (x, y) points in any order.
+*/
+void PiecewiseLinearFunction::setPoints( const vector<pair<double, double> >& aPoints ) {
+    // Use a stable sort so that the first of several points with the same x
+    // value is the one which is kept.
+    vector<pair<double, double> > sortedPoints = aPoints;
+    stable_sort( sortedPoints.begin(), sortedPoints.end(), lesserX );
+
+    mX.clear();
+    mY.clear();
+    mX.reserve( sortedPoints.size() );
+    mY.reserve( sortedPoints.size() );
+    for( const auto& point : sortedPoints ) {
+        if( mX.empty() || !util::isEqual( point.first, mX.back() ) ) {
+            mX.push_back( point.first );
+            mY.push_back( point.second );
+        }
+    }
+}
+
+/*!
+* \brief Get the number of distinct points.
+* \return The number of points.
+*/
+size_t PiecewiseLinearFunction::size() const {
+    return mX.size();
+}
+
+/*!
+* \brief Evaluate the function at a single x value.
+* \param aXValue The x value.
+* \return The y value.
+*/
+double PiecewiseLinearFunction::getY( const double aXValue ) const {
+    if( mX.size() < 2 ) {
+        return mX.empty() ? -DBL_MAX : mY[ 0 ];
+    }
+    return evaluate( aXValue, findSegment( aXValue ) );
+}
+
+/*!
+* \brief Evaluate the function at a number of x values.
+* \details The bracketing points of each x value are first searched for from
+*          those of the previous one so that increasing x values, as in a grid,
+*          are found in constant time.
+* \param aXValues The x values.
+* \param aYValues The y value at each x value, resized as needed.
+*/
+void PiecewiseLinearFunction::getY( const vector<double>& aXValues, vector<double>& aYValues ) const {
+    aYValues.resize( aXValues.size() );
+    if( mX.size() < 2 ) {
+        fill( aYValues.begin(), aYValues.end(), mX.empty() ? -DBL_MAX : mY[ 0 ] );
+        return;
+    }
+    const size_t lastSegment = mX.size() - 2;
+    size_t segment = 0;
+    for( size_t i = 0; i < aXValues.size(); ++i ) {
+        const double x = aXValues[ i ];
+        if( x < mX[ segment ] && segment > 0 ) {
+            segment = findSegment( x );
+        }
+        else {
+            while( segment < lastSegment && x >= mX[ segment + 1 ] ) {
+                ++segment;
+            }
+        }
+        aYValues[ i ] = evaluate( x, segment );
+    }
+}
+
+/*!
+* \brief Find the segment to use to evaluate an x value.
+* \details Segment i connects points i and i + 1.  Values below the first point
+*          use the first segment and values above the last point use the last.
+* \param aXValue The x value.
+* \return The index of the segment.
+* \pre There are at least two points.
+*/
+size_t PiecewiseLinearFunction::findSegment( const double aXValue ) const {
+    assert( mX.size() >= 2 );
+
+    // Find the first point strictly greater than the value, the segment is the
+    // one which ends there.
+    const size_t upper = upper_bound( mX.begin() + 1, mX.end() - 1, aXValue ) - mX.begin();
+    return upper - 1;
+}
+
+/*!
+* \brief Evaluate the function on a segment.
+* \details The y value of a point is returned exactly for an x value equal to
+*          that of the point.
+* \param aXValue The x value.
+* \param aSegment The segment to evaluate.
+* \return The y value.
+*/
+double PiecewiseLinearFunction::evaluate( const double aXValue, const size_t aSegment ) const {
+    const double x1 = mX[ aSegment ];
+    const double x2 = mX[ aSegment + 1 ];
+    if( util::isEqual( aXValue, x1 ) ) {
+        return mY[ aSegment ];
+    }
+    if( util::isEqual( aXValue, x2 ) ) {
+        return mY[ aSegment + 1 ];
+    }
+    return ( aXValue - x1 ) * ( mY[ aSegment + 1 ] - mY[ aSegment ] ) / ( x2 - x1 ) + mY[ aSegment ];
+}
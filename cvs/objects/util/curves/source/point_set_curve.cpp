@@ -43,6 +43,7 @@
 #include "util/curves/include/point_set.h"
 #include "util/curves/include/explicit_point_set.h" // I dont like this. 
 #include "util/curves/include/data_point.h"
+#include "util/curves/include/piecewise_linear_function.h"
 #include "util/base/include/xml_helper.h"
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
@@ -127,64 +128,26 @@ PointSet* PointSetCurve::getPointSet() {
     return pointSet;
 }
 
-//! Get the Y value corresponding to a given X value.
-//
-// \todo This is a terrible way to do interpolation.  We should
-//         replace this with something more orthodox.
+/*! \brief Get the Y value corresponding to a given X value.
+* \details Values between points are interpolated linearly and values beyond
+*          the ends of the curve are extrapolated from the last two points. The
+*          points are kept sorted by the PointSet so that this is a binary
+*          search rather than several scans of the points.
+* \param xValue The x value.
+* \return The y value, or -DBL_MAX if the curve has no points.
+*/
 double PointSetCurve::getY( const double xValue ) const {
-    double retValue;
-
-    // First check if the point exists.
-    if( pointSet->containsX( xValue ) ){
-        retValue = pointSet->getY( xValue );
-    } else {
-        // Need to interpolate.
-        double x1 = pointSet->getNearestXBelow( xValue );
-        double x2 = pointSet->getNearestXAbove( xValue );
-
-        // First check if both points are invalid. This means are curve has no points.
-        if( x1 == -DBL_MAX && x2 == DBL_MAX ){
-            retValue = -DBL_MAX;
-        }
-        else {
-            // Check if the point below is invalid.
-            if( x1 == -DBL_MAX ){
-                // Get the next value above x2
-
-                // TODO: This formula isn't very good.  It amounts to
-                // an extrapolation using the slope of the last
-                // segment.  This is potentially problematic because
-                // sometimes we get some really large values in here
-                // from the solver.  Returning a wild extrapolation
-                // isn't the best idea in those cases.  Maybe we
-                // should clamp outputs to the endpoints instead.
-                x1 = pointSet->getNearestXAbove( x2 );
-
-                // Check if that is valid
-                if( x1 == -DBL_MAX ){
-                    // There is only one valid point.  Since we can't
-                    // compute a slope, just return the one value we
-                    // have.
-                    return pointSet->getY( x2 );
-                }
-            }
-
-            // Check if the point above is invalid
-            if( x2 == DBL_MAX ){
-                // Get the next value below x1
-                // see notes above.
-                x2 = pointSet->getNearestXBelow( x1 );
+    return pointSet->getPiecewiseLinearFunction().getY( xValue );
+}
 
-                // Check if that is valid.
-                if( x2 == -DBL_MAX ){
-                    // There is only one valid point.
-                    return pointSet->getY( x1 );
-                }
-            }
-            retValue = linearInterpolateY( xValue, x1, pointSet->getY( x1 ), x2, pointSet->getY( x2 ) );
-        }
-    }
-    return retValue;
+/*! \brief Get the Y values corresponding to a number of X values.
+* \details This is equivalent to calling getY for each x value but is faster,
+*          particularly when the x values are in increasing order.
+* \param aXValues The x values.
+* \param aYValues The y values, resized to the number of x values.
+*/
+void PointSetCurve::getY( const vector<double>& aXValues, vector<double>& aYValues ) const {
+    pointSet->getPiecewiseLinearFunction().getY( aXValues, aYValues );
 }
 
 //! Get the X value corresponding to a given Y value.
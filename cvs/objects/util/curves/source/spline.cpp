@@ -68,15 +68,17 @@ void Spline::fit_natural(const std::vector<double> &ax, const std::vector<double
     //! temporary work space for fit_internal
     std::vector<double> u(n);
 
-    x = ax;
-    y = ay;
-    ypp.resize(n);
+    boost::shared_ptr<Table> t(new Table);
+    t->x = ax;
+    t->y = ay;
+    t->ypp.resize(n);
 
     // the following initializations distinguish a natural spline from
     // the other sort
-    ypp[0] = u[0] = ypp[n-1] = 0.0;
+    t->ypp[0] = u[0] = t->ypp[n-1] = 0.0;
     
-    fit_internal(u);
+    fit_internal(*t, u);
+    mTable = t;
 }
 
 /*!
@@ -93,18 +95,22 @@ void Spline::fit_boundary(const std::vector<double> &ax, const std::vector<doubl
     //! temporary work space for fit_internal
     std::vector<double> u(n);
 
-    x = ax;
-    y = ay;
-    ypp.resize(n);
+    boost::shared_ptr<Table> t(new Table);
+    t->x = ax;
+    t->y = ay;
+    t->ypp.resize(n);
+    const std::vector<double> &x = t->x;
+    const std::vector<double> &y = t->y;
 
     // this part is what makes a boundary spline different from a natural spline
-    ypp[0] = -0.5;
+    t->ypp[0] = -0.5;
     u[0]   = (3.0/(x[1]-x[0])) * ((y[1]-y[0])/(x[1]-x[0]) - yp0);
 
-    ypp[n-1] = 0.5;
+    t->ypp[n-1] = 0.5;
     u[n-1]   = (3.0/(x[n-1]-x[n-2])) * (ypn - (y[n-1]-y[n-2])/(x[n-1]-x[n-2]));
 
-    fit_internal(u);
+    fit_internal(*t, u);
+    mTable = t;
 }
 
 
@@ -112,8 +118,11 @@ void Spline::fit_boundary(const std::vector<double> &ax, const std::vector<doubl
  * \brief Solve for the second derivative values for the spline
  * \details See Numerical Recipes section 3.3
  */
-void Spline::fit_internal(std::vector<double> &u)
+void Spline::fit_internal(Table &t, std::vector<double> &u)
 {
+    const std::vector<double> &x = t.x;
+    const std::vector<double> &y = t.y;
+    std::vector<double> &ypp = t.ypp;
     int n = x.size();
     //tridiagonal decomposition.  We do this inline because it is
     //relatively simple
@@ -139,6 +148,27 @@ void Spline::fit_internal(std::vector<double> &u)
 
 }
 
+/*!
+ * \brief Evaluate the spline in the interval [x[ilo], x[ilo+1]]
+ */
+double Spline::eval_interval(int ilo, double ax) const
+{
+    const std::vector<double> &x = mTable->x;
+    const std::vector<double> &y = mTable->y;
+    const std::vector<double> &ypp = mTable->ypp;
+    int ihi = ilo+1;
+
+    double dx = x[ihi]-x[ilo];
+    if(dx <= 0.0)
+        log_and_abort("x values must be strictly ascending.");
+    double dxi = 1.0/dx;
+
+    double a = (x[ihi]-ax)*dxi;
+    double b = (ax-x[ilo])*dxi;
+
+    return a*y[ilo]+b*y[ihi] + // this is the linear interpolation term
+        ((a*a*a-a)*ypp[ilo] + (b*b*b-b)*ypp[ihi])*dx*dx/6.0; // second derivative correction
+}
 
 /*!
  * \brief Evaluate a spline interpolation at an input x value 
@@ -149,6 +179,7 @@ void Spline::fit_internal(std::vector<double> &u)
  */
 double Spline::interpolate(double ax) const
 {
+    const std::vector<double> &x = mTable->x;
     int n = x.size();
     if(ax < x[0] || ax > x[n-1])
         log_and_abort("x-value out of range!");
@@ -166,18 +197,56 @@ double Spline::interpolate(double ax) const
             ilo = i;
     }
 
-    double dx = x[ihi]-x[ilo];
-    if(dx <= 0.0)
-        log_and_abort("x values must be strictly ascending.");
-    double dxi = 1.0/dx;
+    return eval_interval(ilo, ax);
+}
 
-    double a = (x[ihi]-ax)*dxi;
-    double b = (ax-x[ilo])*dxi;
+/*!
+ * \brief Evaluate a spline interpolation at an input x value starting
+ *        the search for its interval from a hint
+ * \details Gives the same result as interpolate(ax).  Callers which
+ *          evaluate the spline repeatedly at nearby points, for
+ *          instance once per period or per solver iteration, may keep
+ *          the hint so that the interval is usually found without any
+ *          search.  Since the hint is held by the caller the spline
+ *          may still be shared between threads.
+ * \param[in] ax: x-value at which to interpolate
+ * \param[in,out] ailo: on input the interval to start the search
+ *          from, any value is allowed; on output the interval
+ *          containing ax.
+ */
+double Spline::interpolate(double ax, int &ailo) const
+{
+    const std::vector<double> &x = mTable->x;
+    int n = x.size();
+    if(ax < x[0] || ax > x[n-1])
+        log_and_abort("x-value out of range!");
 
-    double val = a*y[ilo]+b*y[ihi] + // this is the linear interpolation term
-        ((a*a*a-a)*ypp[ilo] + (b*b*b-b)*ypp[ihi])*dx*dx/6.0; // second derivative correction
+    // the same interval is chosen as by the bisection search:
+    // the last ilo with x[ilo] <= ax, but no further than n-2.
+    if(ailo < 0 || ailo > n-2 || x[ailo] > ax)
+        ailo = 0;
+    while(ailo < n-2 && x[ailo+1] <= ax)
+        ++ailo;
+
+    return eval_interval(ailo, ax);
+}
 
-    return val;
+/*!
+ * \brief compute interpolated values for a number of inputs
+ * \details Equivalent to calling interpolate() for each input, but
+ *          the search for the bracketing interval starts from the
+ *          interval of the previous input, so a sorted table of
+ *          inputs is evaluated without a bisection search for each.
+ * \param[in] ax: x-values at which to interpolate
+ * \param[out] ay: interpolated y-values.  Will be resized to match ax.
+ */
+void Spline::interpolate(const std::vector<double> &ax, std::vector<double> &ay) const
+{
+    ay.resize(ax.size());
+    int ilo = 0;
+    for(size_t k=0; k<ax.size(); ++k) {
+        ay[k] = interpolate(ax[k], ilo);
+    }
 }
 
 /*!
@@ -187,7 +256,7 @@ double Spline::interpolate(double ax) const
 double Spline::xmin(void) const
 {
     if(isValid())
-        return x[0];
+        return mTable->x[0];
     else
         return 0.0;
 }
@@ -200,7 +269,7 @@ double Spline::xmin(void) const
 double Spline::xmax(void) const
 {
     if(isValid())
-        return x[x.size()-1];
+        return mTable->x[mTable->x.size()-1];
     else
         return 0.0;
 }
@@ -59,6 +59,7 @@
 #include "util/base/include/model_time.h"
 #include "util/base/include/configuration.h"
 #include "util/base/include/util.h"
+#include "util/base/include/csv_output_buffer.h"
 
 #if( DUPLICATE_CHECKING )
 #include "util/base/include/util.h"
@@ -89,17 +90,21 @@ const char *DBout = "DBout"; // name of the table for outputs compatible with da
 *
 * Names of categories, subcategories, and variables are written
 * as strings in the argument.  Values are also passed as arguments.
-*
+* The record is appended to the CSVOutputBuffer current for the calling
+* thread, if there is one, so that it is written along with other records
+* in a single large write.
 */
 
-void fileoutput3( string var1name,string var2name,string var3name,
-              string var4name,string var5name,string uname,vector<double> dout) {
-    outFile <<var1name<<","<<var2name<<","<<var3name<<","
-            <<var4name<<","<<var5name<<","<<uname<<",";
-    for (int i=0;i< static_cast<int>( dout.size() );i++) {
-        outFile << dout[i]<<",";
+void fileoutput3( const string& var1name,const string& var2name,const string& var3name,
+              const string& var4name,const string& var5name,const string& uname,const vector<double>& dout) {
+    CSVOutputBuffer* buffer = CSVOutputBuffer::getCurrent();
+    if( buffer ) {
+        buffer->appendRow( var1name, var2name, var3name, var4name, var5name, uname, dout );
+    }
+    else {
+        CSVOutputBuffer record( outFile );
+        record.appendRow( var1name, var2name, var3name, var4name, var5name, uname, dout );
     }
-    outFile << endl;
 }
 
 /*! Output single records MiniCAM style to the database. 
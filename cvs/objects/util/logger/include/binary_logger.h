@@ -0,0 +1,121 @@
+#ifndef _BINARY_LOGGER_H_
+#define _BINARY_LOGGER_H_
+#if defined(_MSC_VER)
+#pragma once
+#endif
+
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+* \file binary_logger.h
+* \ingroup Objects
+* \brief The BinaryLogger class header file.
+*/
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <boost/unordered_map.hpp>
+#include "util/logger/include/logger.h"
+
+/*! 
+* \ingroup Objects
+* \brief A Logger which writes messages to a compact binary file.
+* \details Diagnostic logs mostly repeat the same text with different numbers
+*          in it.  This logger splits each message into a pattern, the text
+*          with every number replaced by a placeholder, and the numbers.  Each
+*          distinct pattern is written once, so that the region, market and
+*          other names in it are only written the first time, and a message
+*          is then a record of the id of its pattern, the warning level, the
+*          time since the log was opened and the numbers in binary.  A number
+*          is only split out if it can be printed exactly as it appeared in
+*          the text, otherwise it is left in the pattern, so the text of the
+*          log is always recovered exactly by convertToText which is run with
+*          the --binary-log-to-text command line option.
+*
+*          The file starts with the magic string GCAMBLOG, a version and the
+*          header message and is followed by records, each starting with a
+*          record type:
+*          - PATTERN: the pattern id and the pattern text.
+*          - MESSAGE: the warning level, milliseconds since the log was opened,
+*            the pattern id, the count of numbers and for each number the
+*            precision it is printed with and its value.
+*          Values are written in the byte order of the machine running the
+*          model.
+*
+* \warning Since BinaryLoggers can only be created by the LoggerFactory, public functions not in the Logger interface will be unusable.
+*/
+
+class BinaryLogger: public Logger {
+    friend class LoggerFactory;
+public:
+    void open( const char[] = 0 );
+    void close();
+    void logCompleteMessage( const ILogger::WarningLevel aLevel, const std::string& aMessage );
+    std::ofstream& getLogFile() { return mLogFile; }
+
+    static bool convertToText( const std::string& aFileName, std::ostream& aOut );
+private:
+    //! The types of records in the file.
+    enum RecordType {
+        PATTERN = 1,
+        MESSAGE = 2
+    };
+
+    //! The filestream to which data is written.
+    std::ofstream mLogFile;
+
+    //! The time at which the log was opened.
+    std::chrono::steady_clock::time_point mOpenTime;
+
+    //! The id of each pattern which has been written.
+    boost::unordered_map<std::string, unsigned int> mPatternIds;
+
+    //! Scratch space for the pattern of a message.
+    std::string mPattern;
+
+    //! Scratch space for the numbers of a message.
+    std::vector<double> mNumbers;
+
+    //! Scratch space for the precision of the numbers of a message.
+    std::vector<unsigned char> mPrecisions;
+
+    BinaryLogger( const std::string& aLoggerName ="" );
+    void splitMessage( const std::string& aMessage );
+    void writeString( const std::string& aString );
+};
+
+#endif // _BINARY_LOGGER_H_
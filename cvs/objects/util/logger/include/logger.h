@@ -53,7 +53,10 @@
 #include "util/logger/include/ilogger.h"
 
 #if GCAM_PARALLEL_ENABLED
+#include <thread>
 #include <tbb/spin_mutex.h>
+#include <tbb/concurrent_queue.h>
+#include <tbb/enumerable_thread_specific.h>
 #endif
 
 // Forward definition of the Logger class.
@@ -66,6 +69,7 @@ class Tabs;
 * 
 * This is a very simple class which contains a pointer to its parent Logger.
 * When the streambuf receives a character it passes it to its parent stream for processing.
+* Strings written to the stream are passed on whole rather than a character at a time.
 *
 * \author Josh Lurz
 * \warning Overriding the iostream class is somewhat difficult so this class may be somewhat esoteric.
@@ -78,6 +82,7 @@ class PassToParentStreamBuf: std::streambuf {
 public:
     PassToParentStreamBuf();
     int overflow( int ch );
+    std::streamsize xsputn( const char* aData, std::streamsize aLength );
     int underflow( int ch );
     void setParent( Logger* parentIn );
     void toDebugXML( std::ostream& out ) const;
@@ -97,6 +102,15 @@ class LoggerFactory;
 *          set the level of log messages they wish to print. Loggers are
 *          singletons and can only be instantiated by the LoggerFactory class.
 *
+*          While the current level would not be printed the stream is put in a
+*          failed state so that values written to it are not even formatted.
+*          In parallel builds the stream state is shared by all threads so it is
+*          left alone and instead each thread has its own current level and
+*          collects its own partial line, so that lines written concurrently are
+*          neither interleaved nor written at another thread's level.  In parallel builds a logger with
+*          asyncWrite set hands complete lines to a writer thread rather than
+*          writing them while holding the logger's lock.
+*
 * \author Josh Lurz
 * \date $Date: 2007/01/11 23:52:34 $
 * \version $Revision: 1.5.2.3 $
@@ -112,6 +126,7 @@ public:
     virtual ~Logger(); //!< Virtual destructor.
     virtual void open( const char[] = 0 ) = 0; //!< Pure virtual function called to begin logging.
     int receiveCharFromUnderStream( int ch ); //!< Pure virtual function called to complete the log and clean up.
+    void receiveFromUnderStream( const char* aData, std::streamsize aLength );
     virtual void close() = 0;
     ILogger::WarningLevel setLevel( const ILogger::WarningLevel newLevel );
     bool wouldPrint(ILogger::WarningLevel aLevel) const;
@@ -126,6 +141,9 @@ protected:
 	//! File name of the file it uses.
     std::string mFileName;
 
+	//! File name as configured, before any rank or worker suffix was added.
+    std::string mBaseFileName;
+
 	//! Header message to print at the beginning of the log.
     std::string mHeaderMessage;
 
@@ -135,29 +153,68 @@ protected:
 	//! Defines the minimum level of warnings to print to the console.
 	ILogger::WarningLevel mMinToScreenWarningLevel;
 
-	//! Defines the current warning level.
-    ILogger::WarningLevel mCurrentWarningLevel;
-
 	//! Defines whether to print the warning level.
     bool mPrintLogWarningLevel;
+
+	//! Whether complete lines should be written by a separate thread.
+    bool mAsyncWrite;
     Logger( const std::string& aFileName = "" );
     
 	//! Log a message with the given warning level.
-    virtual void logCompleteMessage( const std::string& aMessage ) = 0;
-    void printToScreenIfConfigured( const std::string& aMessage );
+    virtual void logCompleteMessage( const ILogger::WarningLevel aLevel, const std::string& aMessage ) = 0;
+
+	//! The file stream the log is written to.
+    virtual std::ofstream& getLogFile() = 0;
+    void printToScreenIfConfigured( const ILogger::WarningLevel aLevel, const std::string& aMessage );
     static void parseHeader( std::string& aHeader );
     static const std::string& convertLevelToString( ILogger::WarningLevel aLevel );
 private:
-	 //! Buffer which contains characters waiting to be printed.
-    std::stringstream mBuf;
 #if GCAM_PARALLEL_ENABLED
-    tbb::spin_mutex mMutex;  //<! mutex protecting mBuf
+	 //! A complete line waiting for the writer thread.
+    struct QueuedMessage {
+        ILogger::WarningLevel mLevel;
+        std::string mMessage;
+    };
+
+	 //! The warning level and partial line of a thread writing to the logger.
+    struct ThreadState {
+        ThreadState(): mLevel( ILogger::DEBUG ) {}
+
+        //! The current warning level of the thread.
+        ILogger::WarningLevel mLevel;
+
+        //! Characters waiting to be printed.
+        std::string mBuffer;
+    };
+
+	 //! The state of each thread so that threads can not change each other's level.
+    tbb::enumerable_thread_specific<ThreadState> mThreadStates;
+
+    tbb::spin_mutex mMutex;  //<! mutex protecting the output of complete lines
+
+	 //! The complete lines waiting to be written, a null message signals the end.
+    tbb::concurrent_bounded_queue<QueuedMessage*> mQueue;
+
+	 //! The thread which writes the queued lines if mAsyncWrite is set.
+    std::thread mWriterThread;
+#else
+	//! Defines the current warning level.
+    ILogger::WarningLevel mCurrentWarningLevel;
+
+	 //! Buffer which contains characters waiting to be printed.
+    std::string mBuf;
 #endif
 
 	 //! Underlying ofstream
     PassToParentStreamBuf mUnderStream;
 
     void XMLParse( const xercesc::DOMNode* node );
+    void updateStreamState();
+    void completeLine( const ILogger::WarningLevel aLevel, std::string& aBuffer );
+    void startAsyncWriter();
+    void stopAsyncWriter();
+    void runAsyncWriter();
+    void reopen();
     static const std::string getTimeString();
     static const std::string getDateString();
 };
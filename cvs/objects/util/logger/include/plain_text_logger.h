@@ -66,7 +66,8 @@ class PlainTextLogger: public Logger {
     public:
     void open( const char[] = 0 );
     void close();
-    void logCompleteMessage( const std::string& aMessage );
+    void logCompleteMessage( const ILogger::WarningLevel aLevel, const std::string& aMessage );
+    std::ofstream& getLogFile() { return mLogFile; }
 private:
     std::ofstream mLogFile; //!< The filestream to which data is written.
     PlainTextLogger( const std::string& aLoggerName ="" );
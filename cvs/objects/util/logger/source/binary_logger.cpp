@@ -0,0 +1,319 @@
+/*
+* LEGAL NOTICE
+* This computer software was prepared by Battelle Memorial Institute,
+* hereinafter the Contractor, under Contract No. DE-AC05-76RL0 1830
+* with the Department of Energy (DOE). NEITHER THE GOVERNMENT NOR THE
+* CONTRACTOR MAKES ANY WARRANTY, EXPRESS OR IMPLIED, OR ASSUMES ANY
+* LIABILITY FOR THE USE OF THIS SOFTWARE. This notice including this
+* sentence must appear on any copies of this computer software.
+* 
+* EXPORT CONTROL
+* User agrees that the Software will not be shipped, transferred or
+* exported into any country or used in any manner prohibited by the
+* United States Export Administration Act or any other applicable
+* export laws, restrictions or regulations (collectively the "Export Laws").
+* Export of the Software may require some form of license or other
+* authority from the U.S. Government, and failure to obtain such
+* export control license may result in criminal liability under
+* U.S. laws. In addition, if the Software is identified as export controlled
+* items under the Export Laws, User represents and warrants that User
+* is not a citizen, or otherwise located within, an embargoed nation
+* (including without limitation Iran, Syria, Sudan, Cuba, and North Korea)
+*     and that User is not otherwise prohibited
+* under the Export Laws from receiving the Software.
+* 
+* Copyright 2011 Battelle Memorial Institute.  All Rights Reserved.
+* Distributed as open-source under the terms of the Educational Community 
+* License version 2.0 (ECL 2.0). http://www.opensource.org/licenses/ecl2.php
+* 
+* For further details, see: http://www.globalchange.umd.edu/models/gcam/
+*
+*/
+
+
+
+/*! 
+* \file binary_logger.cpp
+* \ingroup Objects
+* \brief BinaryLogger class source file.
+*/
+
+#include "util/base/include/definitions.h"
+#include <iostream>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+#include "util/logger/include/binary_logger.h"
+
+using namespace std;
+
+namespace {
+    //! The magic string at the start of a binary log.
+    const char BINARY_LOG_MAGIC[] = "GCAMBLOG";
+
+    //! The version of the binary log format.
+    const unsigned int BINARY_LOG_VERSION = 1;
+
+    //! The character which stands for a number in a pattern.
+    const char NUMBER_PLACEHOLDER = '\x01';
+
+    //! Write a value in the byte order of the machine.
+    template<class T>
+    void writeValue( ostream& aOut, const T aValue ) {
+        aOut.write( reinterpret_cast<const char*>( &aValue ), sizeof( T ) );
+    }
+
+    //! Read a value written by writeValue.
+    template<class T>
+    bool readValue( istream& aIn, T& aValue ) {
+        return static_cast<bool>( aIn.read( reinterpret_cast<char*>( &aValue ), sizeof( T ) ) );
+    }
+
+    //! Read a string written by BinaryLogger::writeString.
+    bool readString( istream& aIn, string& aString ) {
+        unsigned int length;
+        if( !readValue( aIn, length ) ) {
+            return false;
+        }
+        aString.resize( length );
+        return length == 0 || static_cast<bool>( aIn.read( &aString[ 0 ], length ) );
+    }
+
+    //! Format a number as printf %g does with the given precision.
+    int formatNumber( char* aBuffer, const size_t aSize, const int aPrecision, const double aValue ) {
+        return snprintf( aBuffer, aSize, "%.*g", aPrecision, aValue );
+    }
+
+    //! Whether the character may be part of a name, to avoid splitting numbers out of names.
+    bool isNameChar( const char aChar ) {
+        return isalnum( static_cast<unsigned char>( aChar ) ) || aChar == '_';
+    }
+}
+
+//! Constructor
+BinaryLogger::BinaryLogger( const string& aLoggerName ):Logger( aLoggerName ){
+}
+
+//! Tells the logger to begin logging.
+void BinaryLogger::open( const char[] ){
+    if( mFileName.empty() ) { // set a default value
+        cout << "Using default log file name." << endl;
+        mFileName = "log.bin";
+    }
+
+    mLogFile.open( mFileName.c_str(), ios::out | ios::binary );
+    mOpenTime = chrono::steady_clock::now();
+    // A new file must declare its patterns again.
+    mPatternIds.clear();
+
+    // Write the file header including the header message.
+    if( !mHeaderMessage.empty() ){
+        parseHeader( mHeaderMessage );
+    }
+    mLogFile.write( BINARY_LOG_MAGIC, sizeof( BINARY_LOG_MAGIC ) - 1 );
+    writeValue( mLogFile, BINARY_LOG_VERSION );
+    writeValue( mLogFile, static_cast<unsigned char>( mPrintLogWarningLevel ) );
+    writeString( mHeaderMessage );
+}
+
+//! Tells the logger to finish logging.
+void BinaryLogger::close(){
+    mLogFile.close();
+}
+
+//! Logs a single message.
+void BinaryLogger::logCompleteMessage( const ILogger::WarningLevel aLevel, const string& aMessage ){
+    // Decide whether to print the message
+    if ( aLevel < mMinLogWarningLevel ){
+        return;
+    }
+
+    splitMessage( aMessage );
+
+    // Write the pattern the first time it is seen.
+    boost::unordered_map<string, unsigned int>::const_iterator patternIt = mPatternIds.find( mPattern );
+    unsigned int patternId;
+    if( patternIt == mPatternIds.end() ) {
+        patternId = static_cast<unsigned int>( mPatternIds.size() );
+        mPatternIds[ mPattern ] = patternId;
+        writeValue( mLogFile, static_cast<unsigned char>( PATTERN ) );
+        writeValue( mLogFile, patternId );
+        writeString( mPattern );
+    }
+    else {
+        patternId = patternIt->second;
+    }
+
+    const double elapsed = chrono::duration<double, milli>( chrono::steady_clock::now() - mOpenTime ).count();
+    writeValue( mLogFile, static_cast<unsigned char>( MESSAGE ) );
+    writeValue( mLogFile, static_cast<unsigned char>( aLevel ) );
+    writeValue( mLogFile, static_cast<unsigned int>( elapsed ) );
+    writeValue( mLogFile, patternId );
+    writeValue( mLogFile, static_cast<unsigned int>( mNumbers.size() ) );
+    for( size_t i = 0; i < mNumbers.size(); ++i ) {
+        writeValue( mLogFile, mPrecisions[ i ] );
+        writeValue( mLogFile, mNumbers[ i ] );
+    }
+}
+
+/*!
+ * \brief Split a message into its pattern and numbers.
+ * \details A number is split out if it does not follow a name character and
+ *          printing it with %g at the precision of its significant digits
+ *          gives back the same text, which is the case for numbers written to
+ *          a stream with the default formatting.  Messages which already
+ *          contain the placeholder are kept whole.
+ * \param aMessage The message to split.
+ */
+void BinaryLogger::splitMessage( const string& aMessage ) {
+    mPattern.clear();
+    mNumbers.clear();
+    mPrecisions.clear();
+    if( aMessage.find( NUMBER_PLACEHOLDER ) != string::npos ) {
+        mPattern = aMessage;
+        return;
+    }
+
+    const char* text = aMessage.c_str();
+    const size_t length = aMessage.size();
+    char buffer[ 32 ];
+    for( size_t i = 0; i < length; ) {
+        const char curr = text[ i ];
+        const bool startsNumber = isdigit( static_cast<unsigned char>( curr ) )
+            || ( ( curr == '-' || curr == '.' ) && i + 1 < length
+                 && ( isdigit( static_cast<unsigned char>( text[ i + 1 ] ) ) || text[ i + 1 ] == '.' ) );
+        if( !startsNumber || ( i > 0 && isNameChar( text[ i - 1 ] ) ) ) {
+            mPattern += curr;
+            ++i;
+            continue;
+        }
+
+        char* end;
+        const double value = strtod( text + i, &end );
+        size_t tokenLength = end - ( text + i );
+        if( tokenLength == 0 ) {
+            mPattern += curr;
+            ++i;
+            continue;
+        }
+
+        // Count the significant digits of the mantissa.
+        int precision = 0;
+        bool leading = true;
+        for( size_t j = i; j < i + tokenLength && text[ j ] != 'e' && text[ j ] != 'E'; ++j ) {
+            if( isdigit( static_cast<unsigned char>( text[ j ] ) ) ) {
+                leading = leading && text[ j ] == '0';
+                if( !leading ) {
+                    ++precision;
+                }
+            }
+        }
+        precision = max( precision, 1 );
+
+        const bool endsNumber = i + tokenLength == length || !isNameChar( text[ i + tokenLength ] );
+        if( endsNumber && precision <= 17
+            && formatNumber( buffer, sizeof( buffer ), precision, value ) == static_cast<int>( tokenLength )
+            && aMessage.compare( i, tokenLength, buffer ) == 0 )
+        {
+            mPattern += NUMBER_PLACEHOLDER;
+            mNumbers.push_back( value );
+            mPrecisions.push_back( static_cast<unsigned char>( precision ) );
+        }
+        else {
+            mPattern.append( text + i, tokenLength );
+        }
+        i += tokenLength;
+    }
+}
+
+/*!
+ * \brief Write a string to the log as its length followed by its characters.
+ * \param aString The string to write.
+ */
+void BinaryLogger::writeString( const string& aString ) {
+    writeValue( mLogFile, static_cast<unsigned int>( aString.size() ) );
+    mLogFile.write( aString.data(), aString.size() );
+}
+
+/*!
+ * \brief Convert a binary log to the text the PlainTextLogger would have written.
+ * \param aFileName The binary log file.
+ * \param aOut The stream to write the text to.
+ * \return Whether the whole log could be read.
+ */
+bool BinaryLogger::convertToText( const string& aFileName, ostream& aOut ) {
+    ifstream in( aFileName.c_str(), ios::in | ios::binary );
+    char magic[ sizeof( BINARY_LOG_MAGIC ) - 1 ];
+    unsigned int version;
+    unsigned char printLevel;
+    string headerMessage;
+    if( !in.read( magic, sizeof( magic ) ) || string( magic, sizeof( magic ) ) != BINARY_LOG_MAGIC
+        || !readValue( in, version ) || version != BINARY_LOG_VERSION
+        || !readValue( in, printLevel ) || !readString( in, headerMessage ) )
+    {
+        cerr << aFileName << " is not a binary log." << endl;
+        return false;
+    }
+    if( !headerMessage.empty() ) {
+        aOut << headerMessage << endl << endl;
+    }
+
+    vector<string> patterns;
+    string pattern;
+    char buffer[ 32 ];
+    unsigned char recordType;
+    while( readValue( in, recordType ) ) {
+        if( recordType == PATTERN ) {
+            unsigned int patternId;
+            if( !readValue( in, patternId ) || !readString( in, pattern ) ) {
+                break;
+            }
+            if( patternId >= patterns.size() ) {
+                patterns.resize( patternId + 1 );
+            }
+            patterns[ patternId ] = pattern;
+        }
+        else if( recordType == MESSAGE ) {
+            unsigned char level;
+            unsigned int elapsed, patternId, numNumbers;
+            if( !readValue( in, level ) || !readValue( in, elapsed ) || !readValue( in, patternId )
+                || !readValue( in, numNumbers ) || patternId >= patterns.size() )
+            {
+                break;
+            }
+            if( printLevel || level >= ILogger::ERROR ) {
+                aOut << convertLevelToString( static_cast<ILogger::WarningLevel>( level ) ) << ":";
+            }
+            const string& currPattern = patterns[ patternId ];
+            unsigned int numberIndex = 0;
+            for( size_t i = 0; i < currPattern.size(); ++i ) {
+                if( currPattern[ i ] == NUMBER_PLACEHOLDER && numberIndex < numNumbers ) {
+                    unsigned char precision;
+                    double value;
+                    if( !readValue( in, precision ) || !readValue( in, value ) ) {
+                        break;
+                    }
+                    formatNumber( buffer, sizeof( buffer ), precision, value );
+                    aOut << buffer;
+                    ++numberIndex;
+                }
+                else {
+                    aOut << currPattern[ i ];
+                }
+            }
+            aOut << endl;
+            if( numberIndex != numNumbers ) {
+                break;
+            }
+        }
+        else {
+            break;
+        }
+    }
+    if( !in.eof() ) {
+        cerr << "Could not read all of " << aFileName << "." << endl;
+        return false;
+    }
+    return true;
+}
@@ -46,14 +46,21 @@
 #include <sstream>
 #include <cassert>
 #include <ctime>
+#include <algorithm>
 #include <xercesc/dom/DOMNode.hpp>
 #include <xercesc/dom/DOMNodeList.hpp>
 #include "util/logger/include/logger.h"
 #include "util/base/include/xml_helper.h"
+#include "util/base/include/gcam_mpi.h"
 
 using namespace std;
 using namespace xercesc;
 
+#if GCAM_PARALLEL_ENABLED
+//! The most complete lines which may wait for a writer thread before writes block.
+static const size_t MAX_QUEUED_MESSAGES = 4096;
+#endif
+
 //! Default Constructor
 PassToParentStreamBuf::PassToParentStreamBuf():
 mParent( 0 ){
@@ -66,6 +73,14 @@ int PassToParentStreamBuf::overflow( int aChar ){
 	return mParent->receiveCharFromUnderStream( aChar );
 }
 
+//! Overriding xsputn function which passes a block of characters to its parent at once.
+streamsize PassToParentStreamBuf::xsputn( const char* aData, streamsize aLength ){
+	/*! \pre Make sure the parent is not null. */
+	assert( mParent );
+	mParent->receiveFromUnderStream( aData, aLength );
+	return aLength;
+}
+
 //! Overriding underflow function which should not be reached because this is a write-only stream.
 int PassToParentStreamBuf::underflow( int aChar ){
 	/*! \pre This function should never be called. */
@@ -84,11 +99,14 @@ void PassToParentStreamBuf::setParent( Logger* aParent ) {
 Logger::Logger( const string& aFileName ):
 ILogger( &mUnderStream ),
 // Initialize all variables which are not set by Configuration values.
-mCurrentWarningLevel( ILogger::DEBUG ),
 mFileName( aFileName ),
 mMinLogWarningLevel( ILogger::DEBUG ),
 mMinToScreenWarningLevel( ILogger::SEVERE ),
-mPrintLogWarningLevel( false ){
+mPrintLogWarningLevel( false ),
+mAsyncWrite( false ){
+#if !GCAM_PARALLEL_ENABLED
+    mCurrentWarningLevel = ILogger::DEBUG;
+#endif
     // Set the understream's parent to this Logger.
 	mUnderStream.setParent( this );
 }
@@ -97,15 +115,38 @@ mPrintLogWarningLevel( false ){
 Logger::~Logger() {
 }
 
-//! Set the current warning level.
+//! Set the current warning level of the calling thread.
 ILogger::WarningLevel Logger::setLevel( const ILogger::WarningLevel aLevel ){
-    // Haven't bothered to protect this with a mutex, since doing so
-    // doesn't actually solve the race condition.
-    ILogger::WarningLevel oldLevel = mCurrentWarningLevel;
-    mCurrentWarningLevel = aLevel;
+#if GCAM_PARALLEL_ENABLED
+    ILogger::WarningLevel& currLevel = mThreadStates.local().mLevel;
+#else
+    ILogger::WarningLevel& currLevel = mCurrentWarningLevel;
+#endif
+    ILogger::WarningLevel oldLevel = currLevel;
+    currLevel = aLevel;
+    updateStreamState();
     return oldLevel;
 }
 
+/*! \brief Put the stream in a failed state if the current level would not be
+ *         printed.
+ *  \details Output operators do nothing on a failed stream, so messages at a
+ *           level which is filtered out cost no more than the calls to the
+ *           operators.  In parallel builds the stream state would be changed
+ *           under threads at other levels, so it is always left good and the
+ *           characters are filtered as they are received instead.
+ */
+void Logger::updateStreamState() {
+#if !GCAM_PARALLEL_ENABLED
+    if( wouldPrint( mCurrentWarningLevel ) ) {
+        clear();
+    }
+    else {
+        setstate( ios_base::badbit );
+    }
+#endif
+}
+
 /*! \brief Test whether the logger will produce output at a specified logging level
  *  \details This function allows us to skip preparing expensive
  *           logging output if we know it won't even be printed.
@@ -117,38 +158,126 @@ bool Logger::wouldPrint(ILogger::WarningLevel aLevel) const
 
 //! Receive a single character from the underlying stream and buffer it, printing the buffer it is a newline.
 int Logger::receiveCharFromUnderStream( int ch ) {
-    // Only receive the character or print to the screen if it needed.
-    if( mCurrentWarningLevel >= mMinLogWarningLevel || mCurrentWarningLevel >= mMinToScreenWarningLevel ){
-        // only really need to lock the mutex if we're going to do something.
+    if( ch != char_traits<char>::eof() ) {
+        const char currChar = static_cast<char>( ch );
+        receiveFromUnderStream( &currChar, 1 );
+    }
+    return ch;
+}
+
+/*! \brief Receive characters from the underlying stream and buffer them,
+ *         printing each complete line.
+ *  \param aData The characters to receive.
+ *  \param aLength The number of characters.
+ */
+void Logger::receiveFromUnderStream( const char* aData, streamsize aLength ) {
 #if GCAM_PARALLEL_ENABLED
-        tbb::spin_mutex::scoped_lock lck( mMutex );
+    ThreadState& state = mThreadStates.local();
+    const ILogger::WarningLevel level = state.mLevel;
+    string& buffer = state.mBuffer;
+#else
+    const ILogger::WarningLevel level = mCurrentWarningLevel;
+    string& buffer = mBuf;
 #endif
-        if( ch == '\n' ){
-            string tempString( mBuf.str() );
-            logCompleteMessage( tempString );
-            printToScreenIfConfigured( tempString );
-
-            // reset the stringstream buffer
-            mBuf.clear();       // Clear error flags, if any.
-            mBuf.str(std::string()); // clear out the data in the buffer.
-       }
-        else {
-            // The functions that perform the output will add the
-            // newline, so we only want to insert non-newline
-            // characters.
-            mBuf << ( char )ch;
+    // Only receive the characters or print to the screen if it needed.
+    if( !wouldPrint( level ) ){
+        return;
+    }
+    const char* end = aData + aLength;
+    while( aData != end ) {
+        // The functions that perform the output will add the newline, so we
+        // only want to insert non-newline characters.
+        const char* newline = find( aData, end, '\n' );
+        buffer.append( aData, newline );
+        if( newline == end ) {
+            break;
         }
+        completeLine( level, buffer );
+        aData = newline + 1;
     }
-    return ch;
+}
+
+/*! \brief Print a complete line, or queue it for the writer thread, and clear
+ *         the buffer which held it.
+ *  \param aLevel The current level of the current thread.
+ *  \param aBuffer The buffer of the current thread.
+ */
+void Logger::completeLine( const ILogger::WarningLevel aLevel, string& aBuffer ) {
+#if GCAM_PARALLEL_ENABLED
+    if( mWriterThread.joinable() ) {
+        QueuedMessage* message = new QueuedMessage();
+        message->mLevel = aLevel;
+        message->mMessage.swap( aBuffer );
+        mQueue.push( message );
+        return;
+    }
+    // only really need to lock the mutex if we're going to do something.
+    tbb::spin_mutex::scoped_lock lck( mMutex );
+#endif
+    logCompleteMessage( aLevel, aBuffer );
+    printToScreenIfConfigured( aLevel, aBuffer );
+    aBuffer.clear();
+}
+
+/*! \brief Start the thread which writes complete lines if asyncWrite was set.
+ *  \details Asynchronous writing is only available in parallel builds.
+ */
+void Logger::startAsyncWriter() {
+#if GCAM_PARALLEL_ENABLED
+    if( mAsyncWrite && !mWriterThread.joinable() ) {
+        mQueue.set_capacity( MAX_QUEUED_MESSAGES );
+        mWriterThread = thread( &Logger::runAsyncWriter, this );
+    }
+#endif
+}
+
+/*! \brief Write any queued lines and wait for the writer thread to finish.
+ *  \details This must be called before the logger is closed.
+ */
+void Logger::stopAsyncWriter() {
+#if GCAM_PARALLEL_ENABLED
+    if( mWriterThread.joinable() ) {
+        mQueue.push( 0 );
+        mWriterThread.join();
+    }
+#endif
+}
+
+/*! \brief Switch the log to the file name for this process given by
+ *         GcamMPI::getRankFileName.
+ *  \details This is used by a forked batch worker.  The file inherited from
+ *           the parent process is closed without writing anything further to
+ *           it, so any closing output of the log type is not written, and a
+ *           new log is opened.  The writer thread must not be running.
+ */
+void Logger::reopen() {
+    if( mBaseFileName.empty() ) {
+        mBaseFileName = mFileName;
+    }
+    getLogFile().close();
+    mFileName = GcamMPI::getRankFileName( mBaseFileName );
+    open();
+}
+
+//! The body of the writer thread.
+void Logger::runAsyncWriter() {
+#if GCAM_PARALLEL_ENABLED
+    QueuedMessage* message;
+    for( mQueue.pop( message ); message; mQueue.pop( message ) ) {
+        logCompleteMessage( message->mLevel, message->mMessage );
+        printToScreenIfConfigured( message->mLevel, message->mMessage );
+        delete message;
+    }
+#endif
 }
 
 //! Print the message to the screen if the Logger is configured to.
-void Logger::printToScreenIfConfigured( const string& aMessage ){
+void Logger::printToScreenIfConfigured( const ILogger::WarningLevel aLevel, const string& aMessage ){
 	// Decide whether to print the message
-	if ( mCurrentWarningLevel >= mMinToScreenWarningLevel ) {
+	if ( aLevel >= mMinToScreenWarningLevel ) {
 		// Print the warning level
-		if ( mPrintLogWarningLevel || mCurrentWarningLevel >= ILogger::ERROR ) {
-            cout << convertLevelToString( mCurrentWarningLevel ) << ":";
+		if ( mPrintLogWarningLevel || aLevel >= ILogger::ERROR ) {
+            cout << convertLevelToString( aLevel ) << ":";
 		}
 		cout << aMessage << endl;
 	}
@@ -169,7 +298,8 @@ void Logger::XMLParse( const DOMNode* aNode ){
 		string nodeName = XMLHelper<string>::safeTranscode( curr->getNodeName() );
 		
 		if ( nodeName == "FileName" ){
-			mFileName = XMLHelper<string>::getValue( curr );
+			mBaseFileName = XMLHelper<string>::getValue( curr );
+			mFileName = GcamMPI::getRankFileName( mBaseFileName );
 		}
 		else if ( nodeName == "printLogWarningLevel" ) {
 			mPrintLogWarningLevel = XMLHelper<bool>::getValue( curr );
@@ -184,7 +314,11 @@ void Logger::XMLParse( const DOMNode* aNode ){
 		else if ( nodeName == "headerMessage" ) {
 			mHeaderMessage = XMLHelper<string>::getValue( curr );
 		}
+		else if ( nodeName == "asyncWrite" ) {
+			mAsyncWrite = XMLHelper<bool>::getValue( curr );
+		}
 	}
+	updateStreamState();
 }
 
 void Logger::toDebugXML( ostream& out, Tabs* tabs ) const {
@@ -194,6 +328,7 @@ void Logger::toDebugXML( ostream& out, Tabs* tabs ) const {
 	XMLWriteElement( mMinLogWarningLevel, "minLogWarningLevel", out, tabs );
 	XMLWriteElement( mMinToScreenWarningLevel, "minToScreenWarningLevel", out, tabs );
 	XMLWriteElement( mPrintLogWarningLevel, "printLogWarningLevel", out, tabs );
+	XMLWriteElement( mAsyncWrite, "asyncWrite", out, tabs );
 	XMLWriteClosingTag( "Logger", out, tabs );
 }
 
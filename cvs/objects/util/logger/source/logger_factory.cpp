@@ -53,6 +53,7 @@
 // Logger subclass headers.
 #include "util/logger/include/plain_text_logger.h"
 #include "util/logger/include/xml_logger.h"
+#include "util/logger/include/binary_logger.h"
 
 using namespace std;
 using namespace xercesc;
@@ -84,6 +85,9 @@ void LoggerFactory::XMLParse( const DOMNode* aRoot ){
 			else if( loggerType == "XMLLogger" ){
 				newLogger = new XMLLogger();
 			}
+			else if( loggerType == "BinaryLogger" ){
+				newLogger = new BinaryLogger();
+			}
 			else {
                 cerr << "Unknown Logger Type: " << loggerType << endl;
                 return;
@@ -91,6 +95,7 @@ void LoggerFactory::XMLParse( const DOMNode* aRoot ){
 			
 			newLogger->XMLParse( curr );
 			newLogger->open();
+			newLogger->startAsyncWriter();
 			mLoggers[ newLogger->mName ] = newLogger;
 		}
 	}
@@ -120,11 +125,44 @@ Logger& LoggerFactory::getLogger( const string& aLoggerName ) {
 //! Cleans up the logger.
 void LoggerFactory::cleanUp() {
 	for( map<string,Logger*>::iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); logIter++ ){
+		logIter->second->stopAsyncWriter();
 		logIter->second->close();
 		delete logIter->second;
 	}
 }
 
+/*! \brief Prepare the loggers for the process to be forked.
+ *  \details Stops any writer threads, which would not exist in the child,
+ *           and flushes every log so that buffered output is not written
+ *           twice.  Each side of the fork must then call resumeAfterFork or
+ *           reopenLogs.
+ */
+void LoggerFactory::prepareForFork() {
+	for( map<string,Logger*>::iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+		logIter->second->stopAsyncWriter();
+		logIter->second->getLogFile().flush();
+	}
+}
+
+//! Restart the writer threads stopped by prepareForFork and keep the same log files.
+void LoggerFactory::resumeAfterFork() {
+	for( map<string,Logger*>::iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+		logIter->second->startAsyncWriter();
+	}
+}
+
+/*! \brief Move every log to the file name for this process and restart the
+ *         writer threads stopped by prepareForFork.
+ *  \details Used by a forked child which must not share log files with its
+ *           parent. The new file names are given by GcamMPI::getRankFileName.
+ */
+void LoggerFactory::reopenLogs() {
+	for( map<string,Logger*>::iterator logIter = mLoggers.begin(); logIter != mLoggers.end(); ++logIter ){
+		logIter->second->reopen();
+		logIter->second->startAsyncWriter();
+	}
+}
+
 /*! \brief Writes out the LoggerFactory to an XML file. 
 *
 * \param aOut Output stream to write to.
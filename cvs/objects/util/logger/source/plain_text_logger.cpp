@@ -74,12 +74,12 @@ void PlainTextLogger::close(){
 }
 
 //! Logs a single message.
-void PlainTextLogger::logCompleteMessage( const string& aMessage ){
+void PlainTextLogger::logCompleteMessage( const ILogger::WarningLevel aLevel, const string& aMessage ){
     // Decide whether to print the message
-    if ( mCurrentWarningLevel >= mMinLogWarningLevel ){
+    if ( aLevel >= mMinLogWarningLevel ){
         // Print the warning level
-        if ( mPrintLogWarningLevel || mCurrentWarningLevel >= ILogger::ERROR ) {
-            mLogFile << convertLevelToString( mCurrentWarningLevel ) << ":";
+        if ( mPrintLogWarningLevel || aLevel >= ILogger::ERROR ) {
+            mLogFile << convertLevelToString( aLevel ) << ":";
         }
         mLogFile << aMessage << endl;
     }